@@ -1,4 +1,5 @@
 #include "AudioClip.h"
+#include <vector>
 
 AudioClip::AudioClip()
     : id(juce::Uuid().toString())
@@ -16,32 +17,127 @@ double AudioClip::getEndBeat() const
 
 double AudioClip::getDurationInBeats(double bpm) const
 {
-    if (bpm <= 0) return 0;
+    const double framesPerBeat = getSourceFramesPerBeat(bpm);
+    if (framesPerBeat <= 0) return 0;
+
+    return static_cast<double>(getTrimmedDurationInSamples()) / framesPerBeat;
+}
 
-    double durationSeconds = getTrimmedDurationInSamples() / fileSampleRate / playbackRate;
-    double beatsPerSecond = bpm / 60.0;
-    return durationSeconds * beatsPerSecond;
+double AudioClip::getSourceFramesPerBeat(double bpm) const
+{
+    if (warpEnabled)
+        return fileSampleRate * 60.0 / sourceBpm;
+
+    if (bpm <= 0) return 0;
+    return fileSampleRate * 60.0 / bpm * playbackRate;
 }
 
 //==============================================================================
 void AudioClip::setAudioBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate)
 {
-    audioBuffer = buffer;
+    setSharedBuffer(std::make_shared<const juce::AudioBuffer<float>>(buffer), sampleRate);
+}
+
+void AudioClip::setAudioBuffer(juce::AudioBuffer<float>&& buffer, double sampleRate)
+{
+    setSharedBuffer(std::make_shared<const juce::AudioBuffer<float>>(std::move(buffer)), sampleRate);
+}
+
+void AudioClip::setSharedBuffer(SamplePool::BufferPtr buffer, double sampleRate)
+{
+    audioBuffer = std::move(buffer);
+    compactAudio.reset();
+    stream.reset();
     fileSampleRate = sampleRate;
 
     // Reset trim to full clip
     trimStart = 0;
-    trimEnd = buffer.getNumSamples();
+    trimEnd = getDurationInSamples();
+    ++editVersion;
 }
 
-void AudioClip::setAudioBuffer(juce::AudioBuffer<float>&& buffer, double sampleRate)
+void AudioClip::setCompactAudio(SamplePool::CompactPtr compact, double sampleRate)
 {
-    audioBuffer = std::move(buffer);
+    audioBuffer.reset();
+    compactAudio = std::move(compact);
+    stream.reset();
     fileSampleRate = sampleRate;
 
-    // Reset trim to full clip
     trimStart = 0;
-    trimEnd = audioBuffer.getNumSamples();
+    trimEnd = getDurationInSamples();
+    ++editVersion;
+}
+
+void AudioClip::setStream(std::shared_ptr<AudioFileStream> newStream)
+{
+    audioBuffer.reset();
+    compactAudio.reset();
+    stream = std::move(newStream);
+    fileSampleRate = stream != nullptr ? stream->getSampleRate() : 44100.0;
+
+    trimStart = 0;
+    trimEnd = getDurationInSamples();
+    if (stream != nullptr)
+        stream->setCue(AudioFileStream::Cue::ClipStart, trimStart);
+    ++editVersion;
+}
+
+void AudioClip::setPlaceholder(juce::int64 lengthInSamples, double sampleRate)
+{
+    audioBuffer.reset();
+    compactAudio.reset();
+    stream.reset();
+    fileSampleRate = sampleRate;
+
+    trimStart = 0;
+    trimEnd = std::max((juce::int64)0, lengthInSamples);
+    ++editVersion;
+}
+
+void AudioClip::takeAudioFrom(const AudioClip& other)
+{
+    if (other.isStreamed())
+        setStream(other.getStream());
+    else if (other.isCompact())
+        setCompactAudio(other.getCompactAudio(), other.getSampleRate());
+    else
+        setSharedBuffer(other.getSharedBuffer(), other.getSampleRate());
+
+    filePath = other.filePath;
+}
+
+std::unique_ptr<AudioClip> AudioClip::createIndependentCopy(juce::AudioFormatManager& formatManager) const
+{
+    auto copy = std::make_unique<AudioClip>();
+
+    copy->id = id;
+    copy->name = name;
+    copy->startBeat = startBeat;
+    copy->audioBuffer = audioBuffer;
+    copy->compactAudio = compactAudio;
+    copy->fileSampleRate = fileSampleRate;
+    copy->gain = gain;
+    copy->fadeInSamples = fadeInSamples;
+    copy->fadeOutSamples = fadeOutSamples;
+    copy->trimStart = trimStart;
+    copy->trimEnd = trimEnd;
+    copy->playbackRate = playbackRate;
+    copy->warpEnabled = warpEnabled;
+    copy->sourceBpm = sourceBpm;
+    copy->pitchSemitones = pitchSemitones;
+    copy->filePath = filePath;
+
+    if (stream != nullptr)
+    {
+        // Sharing is the fallback: it plays, but two readers take turns at one position
+        copy->stream = AudioFileStream::open(stream->getFile(), formatManager);
+        if (copy->stream == nullptr)
+            copy->stream = stream;
+
+        copy->stream->setCue(AudioFileStream::Cue::ClipStart, trimStart);
+    }
+
+    return copy;
 }
 
 double AudioClip::getDurationInSeconds() const
@@ -53,41 +149,72 @@ double AudioClip::getDurationInSeconds() const
 //==============================================================================
 float AudioClip::getSample(int channel, juce::int64 sampleIndex) const
 {
-    if (channel < 0 || channel >= audioBuffer.getNumChannels())
+    if (stream != nullptr)
+    {
+        if (channel < 0 || channel >= stream->getNumChannels())
+            return 0.0f;
+
+        // Only the requested channel is wanted, but read() fills from the first
+        std::vector<float> frame(static_cast<size_t>(channel + 1));
+        std::vector<float*> channels;
+        for (auto& sample : frame)
+            channels.push_back(&sample);
+
+        stream->readBlocking(channels.data(), channel + 1, sampleIndex, 1);
+        return frame.back();
+    }
+
+    if (compactAudio != nullptr)
+    {
+        float sample = 0.0f;
+        compactAudio->readChannel(channel, &sample, sampleIndex, 1);
+        return sample;
+    }
+
+    const auto& buffer = getAudioBuffer();
+
+    if (channel < 0 || channel >= buffer.getNumChannels())
         return 0.0f;
 
-    if (sampleIndex < 0 || sampleIndex >= audioBuffer.getNumSamples())
+    if (sampleIndex < 0 || sampleIndex >= buffer.getNumSamples())
         return 0.0f;
 
-    return audioBuffer.getSample(channel, static_cast<int>(sampleIndex));
+    return buffer.getSample(channel, static_cast<int>(sampleIndex));
 }
 
 //==============================================================================
 void AudioClip::setGain(float newGain)
 {
     gain = juce::jlimit(0.0f, 4.0f, newGain);
+    ++editVersion;
 }
 
 //==============================================================================
 void AudioClip::setFadeInSamples(juce::int64 samples)
 {
     fadeInSamples = std::max((juce::int64)0, samples);
+    ++editVersion;
 }
 
 void AudioClip::setFadeOutSamples(juce::int64 samples)
 {
     fadeOutSamples = std::max((juce::int64)0, samples);
+    ++editVersion;
 }
 
 //==============================================================================
 void AudioClip::setTrimStartSample(juce::int64 sample)
 {
     trimStart = juce::jlimit((juce::int64)0, trimEnd - 1, sample);
+    if (stream != nullptr)
+        stream->setCue(AudioFileStream::Cue::ClipStart, trimStart);
+    ++editVersion;
 }
 
 void AudioClip::setTrimEndSample(juce::int64 sample)
 {
-    trimEnd = juce::jlimit(trimStart + 1, (juce::int64)audioBuffer.getNumSamples(), sample);
+    trimEnd = juce::jlimit(trimStart + 1, getDurationInSamples(), sample);
+    ++editVersion;
 }
 
 juce::int64 AudioClip::getTrimmedDurationInSamples() const
@@ -99,6 +226,26 @@ juce::int64 AudioClip::getTrimmedDurationInSamples() const
 void AudioClip::setPlaybackRate(double rate)
 {
     playbackRate = juce::jlimit(0.25, 4.0, rate);
+    ++editVersion;
+}
+
+//==============================================================================
+void AudioClip::setWarpEnabled(bool enabled)
+{
+    warpEnabled = enabled;
+    ++editVersion;
+}
+
+void AudioClip::setSourceBpm(double bpm)
+{
+    sourceBpm = juce::jlimit(20.0, 999.0, bpm);
+    ++editVersion;
+}
+
+void AudioClip::setPitchSemitones(double semitones)
+{
+    pitchSemitones = juce::jlimit(-24.0, 24.0, semitones);
+    ++editVersion;
 }
 
 //==============================================================================
@@ -117,6 +264,9 @@ juce::var AudioClip::toVar() const
     obj->setProperty("trimEnd", trimEnd);
     obj->setProperty("playbackRate", playbackRate);
     obj->setProperty("sampleRate", fileSampleRate);
+    obj->setProperty("warp", warpEnabled);
+    obj->setProperty("sourceBpm", sourceBpm);
+    obj->setProperty("pitchSemitones", pitchSemitones);
 
     return juce::var(obj);
 }
@@ -144,16 +294,16 @@ std::unique_ptr<AudioClip> AudioClip::fromVar(const juce::var& var)
         clip->gain = static_cast<float>(var["gain"]);
 
     if (var.hasProperty("fadeInSamples"))
-        clip->fadeInSamples = static_cast<juce::int64>((int)var["fadeInSamples"]);
+        clip->fadeInSamples = static_cast<juce::int64>(var["fadeInSamples"]);
 
     if (var.hasProperty("fadeOutSamples"))
-        clip->fadeOutSamples = static_cast<juce::int64>((int)var["fadeOutSamples"]);
+        clip->fadeOutSamples = static_cast<juce::int64>(var["fadeOutSamples"]);
 
     if (var.hasProperty("trimStart"))
-        clip->trimStart = static_cast<juce::int64>((int)var["trimStart"]);
+        clip->trimStart = static_cast<juce::int64>(var["trimStart"]);
 
     if (var.hasProperty("trimEnd"))
-        clip->trimEnd = static_cast<juce::int64>((int)var["trimEnd"]);
+        clip->trimEnd = static_cast<juce::int64>(var["trimEnd"]);
 
     if (var.hasProperty("playbackRate"))
         clip->playbackRate = var["playbackRate"];
@@ -161,5 +311,14 @@ std::unique_ptr<AudioClip> AudioClip::fromVar(const juce::var& var)
     if (var.hasProperty("sampleRate"))
         clip->fileSampleRate = var["sampleRate"];
 
+    if (var.hasProperty("warp"))
+        clip->warpEnabled = var["warp"];
+
+    if (var.hasProperty("sourceBpm"))
+        clip->sourceBpm = juce::jlimit(20.0, 999.0, static_cast<double>(var["sourceBpm"]));
+
+    if (var.hasProperty("pitchSemitones"))
+        clip->pitchSemitones = juce::jlimit(-24.0, 24.0, static_cast<double>(var["pitchSemitones"]));
+
     return clip;
 }
@@ -2,17 +2,22 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
+#include "SamplePool.h"
+#include "AudioFileStream.h"
 #include <memory>
 
 /**
  * AudioClip - Represents an audio region on the timeline
  *
  * Features:
- * - Stores audio buffer with sample rate
+ * - Stores audio buffer with sample rate (shared and immutable, see SamplePool),
+ *   a compact 16/24-bit or lossless copy of one (see CompactAudio), or streams
+ *   long files from disk (see AudioFileStream)
  * - Non-destructive trim (start/end points)
  * - Gain control
  * - Fade in/out
  * - Playback rate (time stretch)
+ * - Warping: follows the project tempo at its own pitch (see ClipWarpCache)
  * - Position on timeline (beats)
  */
 class AudioClip
@@ -30,7 +35,7 @@ public:
 
     //==========================================================================
     // Timeline position
-    void setStartBeat(double beat) { startBeat = beat; }
+    void setStartBeat(double beat) { startBeat = beat; ++editVersion; }
     double getStartBeat() const { return startBeat; }
 
     double getEndBeat() const;
@@ -41,11 +46,52 @@ public:
     void setAudioBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate);
     void setAudioBuffer(juce::AudioBuffer<float>&& buffer, double sampleRate);
 
-    const juce::AudioBuffer<float>& getAudioBuffer() const { return audioBuffer; }
-    bool hasAudio() const { return audioBuffer.getNumSamples() > 0; }
-
-    int getNumChannels() const { return audioBuffer.getNumChannels(); }
-    juce::int64 getDurationInSamples() const { return audioBuffer.getNumSamples(); }
+    /** Share an existing (typically pooled) buffer instead of copying it */
+    void setSharedBuffer(SamplePool::BufferPtr buffer, double sampleRate);
+    const SamplePool::BufferPtr& getSharedBuffer() const { return audioBuffer; }
+
+    const juce::AudioBuffer<float>& getAudioBuffer() const
+    {
+        return audioBuffer != nullptr ? *audioBuffer : SamplePool::getEmptyBuffer();
+    }
+    bool hasAudio() const { return getDurationInSamples() > 0; }
+
+    /** Hold the audio compactly instead of as floats (replaces any buffer or stream) */
+    void setCompactAudio(SamplePool::CompactPtr compact, double sampleRate);
+    const SamplePool::CompactPtr& getCompactAudio() const { return compactAudio; }
+    bool isCompact() const { return compactAudio != nullptr; }
+
+    /** Play from disk instead of a buffer (replaces any buffer) */
+    void setStream(std::shared_ptr<AudioFileStream> newStream);
+    const std::shared_ptr<AudioFileStream>& getStream() const { return stream; }
+    bool isStreamed() const { return stream != nullptr; }
+
+    /** Stand in for audio still loading: spans lengthInSamples but plays nothing */
+    void setPlaceholder(juce::int64 lengthInSamples, double sampleRate);
+    bool isPlaceholder() const { return !hasAudio() && trimEnd > trimStart; }
+
+    /** Share other's audio (buffer or stream), keeping this clip's place on the timeline */
+    void takeAudioFrom(const AudioClip& other);
+
+    /**
+     * Same clip (id included) that can play alongside this one: buffers and
+     * compact audio are shared, a streamed file is opened again since a
+     * stream has a single read position
+     */
+    std::unique_ptr<AudioClip> createIndependentCopy(juce::AudioFormatManager& formatManager) const;
+
+    int getNumChannels() const
+    {
+        if (stream != nullptr) return stream->getNumChannels();
+        if (compactAudio != nullptr) return compactAudio->getNumChannels();
+        return getAudioBuffer().getNumChannels();
+    }
+    juce::int64 getDurationInSamples() const
+    {
+        if (stream != nullptr) return stream->getLengthInSamples();
+        if (compactAudio != nullptr) return compactAudio->getLengthInFrames();
+        return getAudioBuffer().getNumSamples();
+    }
     double getDurationInSeconds() const;
     double getSampleRate() const { return fileSampleRate; }
 
@@ -81,11 +127,32 @@ public:
     void setPlaybackRate(double rate);
     double getPlaybackRate() const { return playbackRate; }
 
+    //==========================================================================
+    // Warping - a warped clip keeps its length in beats whatever the tempo,
+    // stretched to fit without changing pitch (playback rate is ignored)
+    void setWarpEnabled(bool enabled);
+    bool isWarpEnabled() const { return warpEnabled; }
+
+    /** Tempo the audio was recorded at */
+    void setSourceBpm(double bpm);
+    double getSourceBpm() const { return sourceBpm; }
+
+    /** Transposition of a warped clip */
+    void setPitchSemitones(double semitones);
+    double getPitchSemitones() const { return pitchSemitones; }
+
+    /** Source frames played per beat at bpm (warped clips ignore bpm) */
+    double getSourceFramesPerBeat(double bpm) const;
+
     //==========================================================================
     // File reference (for reload/save)
     void setFilePath(const juce::String& path) { filePath = path; }
     juce::String getFilePath() const { return filePath; }
 
+    //==========================================================================
+    // Changes whenever something that affects playback is set
+    juce::uint32 getEditVersion() const { return editVersion; }
+
     //==========================================================================
     // Serialization
     juce::var toVar() const;
@@ -101,8 +168,10 @@ private:
     // Position on timeline
     double startBeat = 0.0;
 
-    // Audio data
-    juce::AudioBuffer<float> audioBuffer;
+    // Audio data (may be shared with other clips and sampler zones)
+    SamplePool::BufferPtr audioBuffer;
+    SamplePool::CompactPtr compactAudio;        // Or instead, held compactly
+    std::shared_ptr<AudioFileStream> stream;    // Or streamed
     double fileSampleRate = 44100.0;
 
     // Gain (linear, 0.0 - 4.0 for up to +12dB)
@@ -119,8 +188,15 @@ private:
     // Playback rate (0.25 - 4.0)
     double playbackRate = 1.0;
 
+    // Warping
+    bool warpEnabled = false;
+    double sourceBpm = 120.0;       // 20 - 999
+    double pitchSemitones = 0.0;    // -24 - 24
+
     // Original file path
     juce::String filePath;
 
+    juce::uint32 editVersion = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioClip)
 };
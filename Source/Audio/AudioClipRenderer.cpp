@@ -0,0 +1,502 @@
+#include "AudioClipRenderer.h"
+#include <algorithm>
+#include <cmath>
+
+void AudioClipRenderer::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    warpCache = &getClipWarpCache();
+    scratch.setSize(2, juce::jmax(1, maximumBlockSize));
+    window.setSize(2, WINDOW_SIZE);
+
+    stretchInput.setSize(2, WINDOW_SIZE);
+    stretchOutput.setSize(2, juce::jmax(1, maximumBlockSize));
+    for (auto& stretcher : stretchers)
+    {
+        stretcher.processor.prepare(sampleRate, 2, WINDOW_SIZE);
+        stretcher.clip = nullptr;
+    }
+}
+
+void AudioClipRenderer::render(const std::vector<std::unique_ptr<AudioClip>>& clips, juce::AudioBuffer<float>& buffer,
+                               int numSamples, double positionInBeats, double bpm, Resampler::Quality quality)
+{
+    if (bpm <= 0 || sampleRate <= 0)
+        return;
+
+    ++blockCount;
+    updateIndex(clips, bpm);
+    if (spans.empty())
+        return;
+
+    const double beatsPerSample = (bpm / 60.0) / sampleRate;
+    const int maxBlock = scratch.getNumSamples();
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int n = juce::jmin(maxBlock, numSamples - done);
+        renderBlock(buffer, done, n, positionInBeats + done * beatsPerSample, bpm, quality);
+        done += n;
+    }
+}
+
+void AudioClipRenderer::updateIndex(const std::vector<std::unique_ptr<AudioClip>>& clips, double bpm)
+{
+    const juce::uint32 tempoVersion = tempoTrack != nullptr ? tempoTrack->getEditVersion() : 0;
+    bool changed = bpm != indexedBpm || tempoVersion != indexedTempoVersion || clips.size() != indexedClips.size();
+    for (size_t i = 0; i < clips.size() && !changed; ++i)
+        changed = indexedClips[i].first != clips[i].get() || indexedClips[i].second != clips[i]->getEditVersion();
+
+    if (!changed)
+        return;
+
+    indexedBpm = bpm;
+    indexedTempoVersion = tempoVersion;
+    indexedClips.clear();
+    spans.clear();
+
+    for (const auto& clip : clips)
+    {
+        indexedClips.emplace_back(clip.get(), clip->getEditVersion());
+
+        if (clip->hasAudio())
+        {
+            Span span;
+            span.clip = clip.get();
+            span.startBeat = clip->getStartBeat();
+            span.endBeat = span.startBeat + clip->getDurationInBeats(bpm);
+
+            // Warped clips ask for their render ahead of being played
+            if (clip->isWarpEnabled())
+            {
+                if (tempoTrack != nullptr)
+                {
+                    span.curveValid = ClipWarpCache::TempoCurve::fromTempoTrack(*tempoTrack, span.startBeat,
+                                                                                span.endBeat - span.startBeat, span.curve);
+                }
+                else
+                {
+                    span.curve = ClipWarpCache::TempoCurve::constant(bpm);
+                    span.curveValid = true;
+                }
+
+                if (span.curveValid && warpCache != nullptr && !blockingReads)
+                    warpCache->request(ClipWarpCache::Source::fromClip(*clip, span.curve));
+            }
+
+            spans.push_back(span);
+        }
+    }
+
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.startBeat < b.startBeat; });
+
+    double reach = 0.0;
+    for (auto& span : spans)
+    {
+        reach = juce::jmax(reach, span.endBeat);
+        span.reachBeat = reach;
+    }
+}
+
+void AudioClipRenderer::renderBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                    double positionInBeats, double bpm, Resampler::Quality quality)
+{
+    const double samplesPerBeat = sampleRate * 60.0 / bpm;
+    const double blockEndBeat = positionInBeats + numSamples / samplesPerBeat;
+
+    // Clips starting before the block ends, from the first one that may still
+    // be sounding at its start
+    const auto end = std::lower_bound(spans.begin(), spans.end(), blockEndBeat,
+                                      [](const Span& span, double beat) { return span.startBeat < beat; });
+    auto it = std::upper_bound(spans.begin(), end, positionInBeats,
+                               [](double beat, const Span& span) { return beat < span.reachBeat; });
+
+    for (; it != end; ++it)
+    {
+        if (it->endBeat <= positionInBeats)
+            continue;
+
+        const double clipStartOffset = (it->startBeat - positionInBeats) * samplesPerBeat;
+        if (it->clip->isWarpEnabled())
+            renderWarpedClip(*it, buffer, startSample, numSamples, clipStartOffset, bpm, quality);
+        else
+            renderClip(*it->clip, buffer, startSample, numSamples, clipStartOffset, quality);
+    }
+}
+
+void AudioClipRenderer::renderClip(const AudioClip& clip, juce::AudioBuffer<float>& buffer, int startSample,
+                                   int numSamples, double clipStartOffset, Resampler::Quality quality)
+{
+    Playback playback;
+    playback.length = clip.getDurationInSamples();
+    playback.trimStart = clip.getTrimStartSample();
+    playback.trimEnd = juce::jmin(clip.getTrimEndSample(), playback.length);
+    if (playback.trimEnd <= playback.trimStart)
+        return;
+
+    setSource(playback, clip);
+
+    playback.fadeIn = clip.getFadeInSamples();
+    playback.fadeOut = clip.getFadeOutSamples();
+    playback.gain = clip.getGain();
+
+    // Source frames per output sample
+    playback.increment = (clip.getSampleRate() / sampleRate) * clip.getPlaybackRate();
+
+    // First output sample inside the clip, and the source position it plays
+    int first = 0;
+    double position = 0.0;
+
+    if (playback.increment == 1.0)
+    {
+        // Output sample k plays source frame round(k - clipStartOffset), so
+        // consecutive blocks agree on the alignment
+        const auto frameAtZero = static_cast<juce::int64>(std::floor(0.5 - clipStartOffset));
+        first = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, -frameAtZero));
+        position = static_cast<double>(playback.trimStart + frameAtZero + first);
+    }
+    else
+    {
+        first = juce::jlimit(0, numSamples, static_cast<int>(std::ceil(clipStartOffset)));
+        position = playback.trimStart + (first - clipStartOffset) * playback.increment;
+    }
+
+    play(playback, buffer, startSample, first, numSamples, position, quality);
+}
+
+void AudioClipRenderer::renderWarpedClip(const Span& span, juce::AudioBuffer<float>& buffer, int startSample,
+                                         int numSamples, double clipStartOffset, double bpm,
+                                         Resampler::Quality quality)
+{
+    const auto& clip = *span.clip;
+
+    Playback playback;
+    playback.length = clip.getDurationInSamples();
+    playback.trimStart = clip.getTrimStartSample();
+    playback.trimEnd = juce::jmin(clip.getTrimEndSample(), playback.length);
+    if (playback.trimEnd <= playback.trimStart)
+        return;
+
+    setSource(playback, clip);
+
+    playback.fadeIn = clip.getFadeInSamples();
+    playback.fadeOut = clip.getFadeOutSamples();
+    playback.gain = clip.getGain();
+
+    // The beat fixes the source position; bpm only how fast it moves this block
+    const double samplesPerBeat = sampleRate * 60.0 / bpm;
+    const double framesPerBeat = clip.getSourceFramesPerBeat(bpm);
+    playback.increment = framesPerBeat / samplesPerBeat;
+
+    const int first = juce::jlimit(0, numSamples, static_cast<int>(std::ceil(clipStartOffset)));
+    if (first >= numSamples)
+        return;
+
+    const double beat = (first - clipStartOffset) / samplesPerBeat;     // From the clip's start
+    const double position = playback.trimStart + beat * framesPerBeat;
+
+    if (span.curveValid && warpCache != nullptr)
+    {
+        auto& cache = *warpCache;
+        const auto warpSource = ClipWarpCache::Source::fromClip(clip, span.curve);
+
+        // Released at the end of the block; the cache only frees renders on its own thread
+        const auto warped = blockingReads ? cache.findOrRender(warpSource) : cache.find(warpSource);
+
+        if (warped != nullptr)
+        {
+            const auto& audio = warped->getAudio();
+            const double scale = audio.getNumSamples() / static_cast<double>(playback.trimEnd - playback.trimStart);
+
+            Playback rendered;
+            rendered.channels = audio.getArrayOfReadPointers();
+            rendered.numChannels = audio.getNumChannels();
+            rendered.length = audio.getNumSamples();
+            rendered.trimEnd = rendered.length;
+            rendered.fadeIn = static_cast<juce::int64>(std::llround(static_cast<double>(playback.fadeIn) * scale));
+            rendered.fadeOut = static_cast<juce::int64>(std::llround(static_cast<double>(playback.fadeOut) * scale));
+            rendered.gain = playback.gain;
+            rendered.increment = (warped->getSampleRate() / sampleRate) * bpm / span.curve.getTempoAt(beat);
+
+            play(rendered, buffer, startSample, first, numSamples, warped->getFrameAt(beat), quality);
+            return;
+        }
+
+        if (!blockingReads)
+            cache.request(warpSource);
+    }
+
+    const int count = static_cast<int>(juce::jmin<double>(numSamples - first,
+                                                          std::ceil((playback.trimEnd - position) / playback.increment)));
+    if (count <= 0)
+        return;
+
+    if (!stretch(clip, playback, buffer, startSample + first, count, position))
+        play(playback, buffer, startSample, first, numSamples, position, quality);
+}
+
+void AudioClipRenderer::setSource(Playback& playback, const AudioClip& clip) const
+{
+    if (auto* stream = clip.getStream().get())
+    {
+        playback.stream = stream;
+        playback.numChannels = juce::jmin(window.getNumChannels(), stream->getNumChannels());
+    }
+    else if (auto* compact = clip.getCompactAudio().get())
+    {
+        playback.compact = compact;
+        playback.numChannels = juce::jmin(window.getNumChannels(), compact->getNumChannels());
+    }
+    else
+    {
+        const auto& source = clip.getAudioBuffer();
+        playback.channels = source.getArrayOfReadPointers();
+        playback.numChannels = source.getNumChannels();
+    }
+}
+
+void AudioClipRenderer::play(const Playback& playback, juce::AudioBuffer<float>& buffer, int startSample, int first,
+                             int numSamples, double position, Resampler::Quality quality)
+{
+    const double increment = playback.increment;
+    const bool unity = increment == 1.0;
+
+    const int count = static_cast<int>(juce::jmin<double>(numSamples - first,
+                                                          std::ceil((playback.trimEnd - position) / increment)));
+    if (count <= 0)
+        return;
+
+    const float* ramp = makeRamp(playback, position, count);
+
+    if (playback.stream != nullptr || playback.compact != nullptr)
+    {
+        // Streamed and compact clips are read into the window a piece at a
+        // time, with the taps the interpolator needs either side
+        const int numTaps = unity ? 0 : Resampler::getNumTaps(quality, increment);
+        const int tapsBefore = unity ? 0 : Resampler::getTapsBefore(quality, increment);
+        const int windowSize = window.getNumSamples();
+        const int maxPiece = unity ? windowSize
+                                   : juce::jmax(1, static_cast<int>((windowSize - numTaps - 2) / increment));
+        const int windowChannels = playback.numChannels;
+
+        for (int done = 0; done < count;)
+        {
+            const int piece = juce::jmin(count - done, maxPiece);
+            const double piecePosition = position + done * increment;
+            const auto windowStart = static_cast<juce::int64>(std::floor(piecePosition)) - tapsBefore;
+            const int span = unity ? piece
+                                   : juce::jmin(windowSize, static_cast<int>(std::floor(piecePosition + (piece - 1) * increment)
+                                                                             - std::floor(piecePosition)) + numTaps + 1);
+
+            auto* const* channels = window.getArrayOfWritePointers();
+            if (playback.compact != nullptr)
+                playback.compact->read(channels, windowChannels, windowStart, span);
+            else if (blockingReads)
+                playback.stream->readBlocking(channels, windowChannels, windowStart, span);
+            else
+                playback.stream->read(channels, windowChannels, windowStart, span);
+
+            addRun(window.getArrayOfReadPointers(), windowChannels, span, piecePosition - windowStart, increment,
+                   quality, buffer, startSample + first + done, piece, playback.gain,
+                   ramp != nullptr ? ramp + done : nullptr);
+            done += piece;
+        }
+    }
+    else
+    {
+        addRun(playback.channels, playback.numChannels, playback.length, position, increment,
+               quality, buffer, startSample + first, count, playback.gain, ramp);
+    }
+}
+
+const float* AudioClipRenderer::makeRamp(const Playback& playback, double position, int count)
+{
+    const float gain = playback.gain;
+    const juce::int64 fadeIn = playback.fadeIn;
+    const juce::int64 fadeOut = playback.fadeOut;
+    const juce::int64 trimmedLength = playback.trimEnd - playback.trimStart;
+
+    auto frameAt = [&](int i) { return static_cast<juce::int64>(position + i * playback.increment) - playback.trimStart; };
+    const bool fadingIn = fadeIn > 0 && frameAt(0) < fadeIn;
+    const bool fadingOut = fadeOut > 0 && trimmedLength - frameAt(count - 1) < fadeOut;
+
+    if (!fadingIn && !fadingOut)
+        return nullptr;
+
+    float* ramp = scratch.getWritePointer(1);
+    juce::FloatVectorOperations::fill(ramp, gain, count);
+
+    if (fadingIn)
+    {
+        const float scale = 1.0f / static_cast<float>(fadeIn);
+        for (int i = 0; i < count; ++i)
+        {
+            const auto frame = frameAt(i);
+            if (frame >= fadeIn)
+                break;
+            ramp[i] *= static_cast<float>(frame) * scale;
+        }
+    }
+
+    if (fadingOut)
+    {
+        const float scale = 1.0f / static_cast<float>(fadeOut);
+        for (int i = count - 1; i >= 0; --i)
+        {
+            const auto remaining = trimmedLength - frameAt(i);
+            if (remaining >= fadeOut)
+                break;
+            ramp[i] *= static_cast<float>(remaining) * scale;
+        }
+    }
+
+    return ramp;
+}
+
+bool AudioClipRenderer::stretch(const AudioClip& clip, const Playback& playback, juce::AudioBuffer<float>& buffer,
+                                int startSample, int count, double position)
+{
+    // The clip's own stretcher, or one that has been idle for a block
+    Stretcher* stretcher = nullptr;
+    for (auto& candidate : stretchers)
+        if (candidate.clip == &clip)
+            stretcher = &candidate;
+
+    bool restart = stretcher == nullptr;
+    if (stretcher == nullptr)
+    {
+        for (auto& candidate : stretchers)
+            if ((candidate.clip == nullptr || candidate.lastUsedBlock + 1 < blockCount)
+                && (stretcher == nullptr || candidate.lastUsedBlock < stretcher->lastUsedBlock))
+                stretcher = &candidate;
+    }
+
+    if (stretcher == nullptr || !stretcher->processor.isReady() || count > stretchOutput.getNumSamples())
+        return false;
+
+    auto& processor = stretcher->processor;
+
+    // Fed source frames as if they were at the output rate, so the pitch
+    // makes up for the difference
+    const double pitch = clip.getPitchSemitones() + 12.0 * std::log2(clip.getSampleRate() / sampleRate);
+
+    restart = restart || std::abs(stretcher->nextSourceFrame - position) > 2.0 || stretcher->pitchSemitones != pitch;
+    int discard = 0;
+
+    processor.setTimeRatio(1.0 / playback.increment);
+
+    if (restart)
+    {
+        processor.setPitchSemitones(pitch);
+        processor.reset();
+
+        // Latency compensation: prime with the audio before position, and drop
+        // the output the stretcher holds back, so output starts at position
+        stretcher->clip = &clip;
+        stretcher->pitchSemitones = pitch;
+        stretcher->feedFrame = std::floor(position) - processor.getStartPad();
+        discard = processor.getStartDelay();
+    }
+
+    auto* const* input = stretchInput.getArrayOfWritePointers();
+    auto* const* output = stretchOutput.getArrayOfWritePointers();
+    const int maxInput = stretchInput.getNumSamples();
+
+    // Look ahead in the source until the block is covered
+    for (int pass = 0; pass < 64 && processor.getNumAvailable() < count + discard; ++pass)
+    {
+        const int required = processor.getSamplesRequired();
+        const int n = juce::jlimit(1, maxInput, required > 0 ? required : 256);
+        const auto from = static_cast<juce::int64>(stretcher->feedFrame);
+
+        // Only the trimmed audio, mono on both channels
+        stretchInput.clear(0, n);
+        const auto start = juce::jmax(from, playback.trimStart);
+        const auto end = juce::jmin(from + n, playback.trimEnd);
+        if (end > start)
+        {
+            const int offset = static_cast<int>(start - from);
+            const int frames = static_cast<int>(end - start);
+            const int channels = juce::jmin(2, playback.numChannels);
+
+            if (playback.stream != nullptr || playback.compact != nullptr)
+            {
+                float* dest[2] = { input[0] + offset, input[1] + offset };
+                if (playback.compact != nullptr)
+                    playback.compact->read(dest, channels, start, frames);
+                else
+                    playback.stream->read(dest, channels, start, frames);
+            }
+            else
+            {
+                for (int ch = 0; ch < channels; ++ch)
+                    juce::FloatVectorOperations::copy(input[ch] + offset, playback.channels[ch] + start, frames);
+            }
+
+            if (channels == 1)
+                juce::FloatVectorOperations::copy(input[1] + offset, input[0] + offset, frames);
+        }
+
+        processor.feed(input, n);
+        stretcher->feedFrame += n;
+    }
+
+    while (discard > 0 && processor.getNumAvailable() > 0)
+        discard -= processor.retrieve(output, juce::jmin(discard, stretchOutput.getNumSamples()));
+
+    const int retrieved = processor.retrieve(output, count);
+    if (retrieved < count)
+        stretchOutput.clear(retrieved, count - retrieved);
+
+    const float* ramp = makeRamp(playback, position, count);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        float* dest = buffer.getWritePointer(ch, startSample);
+        const float* stretched = stretchOutput.getReadPointer(juce::jmin(ch, 1));
+        if (ramp != nullptr)
+            juce::FloatVectorOperations::addWithMultiply(dest, stretched, ramp, count);
+        else
+            juce::FloatVectorOperations::addWithMultiply(dest, stretched, playback.gain, count);
+    }
+
+    stretcher->nextSourceFrame = position + count * playback.increment;
+    stretcher->lastUsedBlock = blockCount;
+    return true;
+}
+
+void AudioClipRenderer::addRun(const float* const* source, int numSourceChannels, juce::int64 sourceLength,
+                               double position, double increment, Resampler::Quality quality,
+                               juce::AudioBuffer<float>& buffer, int startSample, int count,
+                               float gain, const float* ramp)
+{
+    // Mono clips play on every channel; a channel is interpolated only once
+    float* interpolated = scratch.getWritePointer(0);
+    int interpolatedChannel = -1;
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const int clipChannel = juce::jmin(ch, numSourceChannels - 1);
+        const float* input = nullptr;
+
+        if (increment == 1.0)
+        {
+            input = source[clipChannel] + static_cast<juce::int64>(position);
+        }
+        else
+        {
+            if (clipChannel != interpolatedChannel)
+            {
+                Resampler::process(quality, source[clipChannel], sourceLength,
+                                   position, increment, interpolated, count);
+                interpolatedChannel = clipChannel;
+            }
+            input = interpolated;
+        }
+
+        float* dest = buffer.getWritePointer(ch, startSample);
+        if (ramp != nullptr)
+            juce::FloatVectorOperations::addWithMultiply(dest, input, ramp, count);
+        else
+            juce::FloatVectorOperations::addWithMultiply(dest, input, gain, count);
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "AudioClip.h"
+#include "ClipWarpCache.h"
+#include "Resampler.h"
+#include "TempoTrack.h"
+#include "TimeStretchProcessor.h"
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * AudioClipRenderer - Plays a track's audio clips a block at a time
+ *
+ * Keeps the clips sorted by start, with each clip's end at the current tempo,
+ * so a block only looks at the clips it overlaps. The index is rebuilt when
+ * the tempo, the clip list or any clip's edit version changes.
+ *
+ * Each overlapping clip is worked out once per block - which output samples
+ * it covers, where in the source they start, and whether a fade touches
+ * them - and rendered as a run:
+ * - At unity rate (same sample rate, playback rate 1) source samples are
+ *   added straight in with the gain, lined up to the nearest output sample
+ * - Otherwise the run goes through Resampler::process() into scratch first
+ * - Fades become a gain ramp for the run, only where they are in reach
+ *
+ * Mono clips are read once and added to every output channel.
+ *
+ * Streamed clips (AudioClip::getStream()) are read from their stream into a
+ * window of WINDOW_SIZE frames, in as many pieces as the run needs, and the
+ * window is rendered like a buffer. They play their first two channels.
+ * Compact clips (AudioClip::getCompactAudio()) are decoded into the same
+ * window, so only the frames being played are ever floats.
+ *
+ * Warped clips (AudioClip::isWarpEnabled()) play their render from the
+ * ClipWarpCache, which is asked for whenever the index is rebuilt so it is
+ * usually made before playback gets there. Its position comes from the beat,
+ * through the render's own beat-to-frame map, so tempo ramps cost nothing
+ * here. Until the render exists the clip is stretched in real time by one of
+ * MAX_STRETCHERS stretchers, primed from ahead of the clip so its output lines
+ * up with the beat instead of lagging by the stretcher's latency; a clip
+ * that finds none free plays varispeed. Offline (blocking reads) the render
+ * is made on the spot.
+ */
+class AudioClipRenderer
+{
+public:
+    static constexpr int WINDOW_SIZE = 4096;
+    static constexpr int MAX_STRETCHERS = 2;
+
+    /**
+     * Scratch for blocks up to maximumBlockSize; longer blocks are split.
+     * Also looks up the ClipWarpCache (message thread), so render() never
+     * has to create it.
+     */
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    /** Add the clips sounding in [positionInBeats, + numSamples) to buffer */
+    void render(const std::vector<std::unique_ptr<AudioClip>>& clips, juce::AudioBuffer<float>& buffer,
+                int numSamples, double positionInBeats, double bpm, Resampler::Quality quality);
+
+    /** Wait for streamed audio instead of playing silence where it is not loaded yet (offline) */
+    void setBlockingReads(bool shouldBlock) { blockingReads = shouldBlock; }
+
+    /** Tempo map warped clips follow; without one they follow each block's bpm */
+    void setTempoTrack(const TempoTrack* track) { tempoTrack = track; }
+
+private:
+    struct Span
+    {
+        const AudioClip* clip = nullptr;
+        double startBeat = 0.0;
+        double endBeat = 0.0;
+        double reachBeat = 0.0;         // Latest end of this and every earlier span
+        bool curveValid = false;        // Warped clips: the tempo over the clip
+        ClipWarpCache::TempoCurve curve;
+    };
+
+    // What a run plays from, in the frames of that audio
+    struct Playback
+    {
+        const float* const* channels = nullptr;     // A buffer,
+        const CompactAudio* compact = nullptr;      // compact audio, or
+        AudioFileStream* stream = nullptr;          // a stream
+        int numChannels = 0;
+        juce::int64 length = 0;
+        juce::int64 trimStart = 0;
+        juce::int64 trimEnd = 0;
+        juce::int64 fadeIn = 0;
+        juce::int64 fadeOut = 0;
+        float gain = 1.0f;
+        double increment = 1.0;                     // Frames per output sample
+    };
+
+    // Real-time stretcher for a warped clip whose render isn't ready
+    struct Stretcher
+    {
+        TimeStretchProcessor processor;
+        const AudioClip* clip = nullptr;
+        double nextSourceFrame = 0.0;   // Source frame the next output sample plays
+        double feedFrame = 0.0;         // Next source frame to feed
+        double pitchSemitones = 0.0;
+        juce::uint32 lastUsedBlock = 0;
+    };
+
+    double sampleRate = 44100.0;
+    juce::AudioBuffer<float> scratch;   // Channel 0: interpolated audio, 1: gain ramp
+    juce::AudioBuffer<float> window;    // Source frames of a streamed or compact clip
+    bool blockingReads = false;
+    const TempoTrack* tempoTrack = nullptr;
+    ClipWarpCache* warpCache = nullptr;  // Set by prepare(); unprepared renderers play warped clips varispeed
+
+    std::array<Stretcher, MAX_STRETCHERS> stretchers;
+    juce::AudioBuffer<float> stretchInput, stretchOutput;
+    juce::uint32 blockCount = 0;
+
+    // Sorted by start; rebuilt when indexedClips no longer matches the clips
+    std::vector<Span> spans;
+    std::vector<std::pair<const AudioClip*, juce::uint32>> indexedClips;   // Clip and its edit version
+    double indexedBpm = 0.0;
+    juce::uint32 indexedTempoVersion = 0;
+
+    void updateIndex(const std::vector<std::unique_ptr<AudioClip>>& clips, double bpm);
+    void renderBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                     double positionInBeats, double bpm, Resampler::Quality quality);
+    void renderClip(const AudioClip& clip, juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                    double clipStartOffset, Resampler::Quality quality);
+    void renderWarpedClip(const Span& span, juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                          double clipStartOffset, double bpm, Resampler::Quality quality);
+    void setSource(Playback& playback, const AudioClip& clip) const;
+    // Plays from position (in the playback's frames) into output samples [first, numSamples)
+    void play(const Playback& playback, juce::AudioBuffer<float>& buffer, int startSample, int first,
+              int numSamples, double position, Resampler::Quality quality);
+    // Stretches count samples of a warped clip in real time; false if no stretcher is free
+    bool stretch(const AudioClip& clip, const Playback& playback, juce::AudioBuffer<float>& buffer,
+                 int startSample, int count, double position);
+    // Gain for count samples from position, or nullptr if no fade reaches them
+    const float* makeRamp(const Playback& playback, double position, int count);
+    // Adds count samples from source (position in source frames) at startSample
+    void addRun(const float* const* source, int numSourceChannels, juce::int64 sourceLength,
+                double position, double increment, Resampler::Quality quality,
+                juce::AudioBuffer<float>& buffer, int startSample, int count, float gain, const float* ramp);
+
+    JUCE_LEAK_DETECTOR(AudioClipRenderer)
+};
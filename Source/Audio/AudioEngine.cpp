@@ -1,9 +1,20 @@
 #include "AudioEngine.h"
+#include "AudioFileLoader.h"
+#include "WaveformPeakStore.h"
 #include "../Utils/PerformanceProfiler.h"
 #include "../Utils/SIMDUtils.h"
+#include <set>
 
 AudioEngine::AudioEngine()
 {
+    // Leave a core for the audio thread's own share and the UI
+    numMixerThreads = juce::jlimit(0, 4, juce::SystemStats::getNumCpus() - 1);
+    prerenderer.setNumThreads(juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 2));
+    rebuildRoutingLocked();
+
+    // Start the warp renderer here rather than from the first warped clip played
+    getClipWarpCache();
+
     // Initialize effect chain with default effects
     effectChain.addEffect(std::make_unique<ChorusEffect>());
     effectChain.addEffect(std::make_unique<DelayEffect>());
@@ -51,6 +62,7 @@ void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double newSampleRat
     spec.numChannels = 2;
 
     masterChain.prepare(spec);
+    metronomeBuffer.setSize(2, samplesPerBlock);
 
     // Configure high-pass filter (30Hz to remove subsonic rumble)
     auto& hpFilter = masterChain.get<0>();
@@ -70,10 +82,28 @@ void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double newSampleRat
 
     // Prepare all tracks
     juce::ScopedLock sl(trackLock);
+    const TrackPrerenderer::ScopedPause pause(prerenderer);
+    prerenderer.prepare(sampleRate);
+
     for (auto& track : tracks)
     {
-        track->prepareToPlay(sampleRate, samplesPerBlock);
+        track->prepareToPlay(sampleRate, getTrackBlockSize());
     }
+
+    for (auto& bus : returnBuses)
+    {
+        if (bus)
+            bus->prepareToPlay(sampleRate, samplesPerBlock);
+    }
+
+    for (auto& group : groupBuses)
+    {
+        if (group)
+            group->prepareToPlay(sampleRate, samplesPerBlock);
+    }
+
+    // Buffers are sized for the block size, so recompile
+    rebuildRoutingLocked();
 }
 
 void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
@@ -90,25 +120,41 @@ void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferTo
     // Clear the buffer first
     bufferToFill.clearActiveBufferRegion();
 
-    auto* buffer = bufferToFill.buffer;
     auto numSamples = bufferToFill.numSamples;
 
+    // A device with more inputs than outputs hands over a channel per input;
+    // everything here is stereo, so only the outputs are processed
+    juce::AudioBuffer<float> output(bufferToFill.buffer->getArrayOfWritePointers(),
+                                    juce::jmin(2, bufferToFill.buffer->getNumChannels()),
+                                    bufferToFill.startSample, numSamples);
+    auto* buffer = &output;
+
     // Test tone for initial testing
     if (testToneEnabled.load())
     {
         processTestTone(*buffer);
     }
 
-    // Calculate beat range for this block (used for clip scheduling)
-    const double bpm = currentBpm.load();
-    const double beatsPerSample = (bpm / 60.0) / sampleRate;
+    // Calculate beat range for this block (used for clip scheduling), at
+    // the tempo advancePosition() will move through it with
     const double blockStartBeat = positionInBeats.load();
+    const double bpm = tempoTrack.getTempoAtBeat(blockStartBeat);
+    currentBpm.store(bpm);
+    const double beatsPerSample = (bpm / 60.0) / sampleRate;
     const double blockEndBeat = blockStartBeat + (numSamples * beatsPerSample);
 
-    // Schedule MIDI from clips to each track's synth when playing
-    if (playing.load())
     {
-        scheduleClipMidiToTracks(blockStartBeat, blockEndBeat, numSamples);
+        juce::ScopedLock sl(trackLock);
+
+        // Hand tracks to the prerenderer or take them back before anything
+        // is scheduled on them
+        updatePrerenderingLocked(blockStartBeat, bpm);
+
+        // Schedule MIDI from clips to each live track's synth when playing
+        if (playing.load())
+        {
+            scheduleClipMidiToTracks(blockStartBeat, blockEndBeat, numSamples);
+        }
     }
 
     // Process keyboard input through the selected track's synth
@@ -119,48 +165,104 @@ void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferTo
             // Route keyboard MIDI to selected track's synth
             juce::ScopedLock trackLk(trackLock);
             int trackIdx = keyboardTrackIndex.load();
-            if (trackIdx >= 0 && trackIdx < static_cast<int>(tracks.size()) && tracks[trackIdx]->getSynth())
-            {
-                tracks[trackIdx]->getSynth()->processBlock(*buffer, midiBuffer);
-            }
-            else if (!tracks.empty() && tracks[0]->getSynth())
+            const bool selectedHasSynth = trackIdx >= 0 && trackIdx < static_cast<int>(tracks.size())
+                                       && tracks[static_cast<size_t>(trackIdx)]->getSynth();
+            if (!selectedHasSynth)
             {
-                // Fallback to first track
-                tracks[0]->getSynth()->processBlock(*buffer, midiBuffer);
+                // Fallback to first track, then to the global synth
+                trackIdx = (!tracks.empty() && tracks[0]->getSynth()) ? 0 : -1;
             }
-            else
+
+            // A track the workers still own (the selection just moved) is
+            // taken back next block; its notes wait until then
+            if (!prerenderer.isRenderingAhead(trackIdx))
             {
-                // Fallback to global synth
-                analogSynth.processBlock(*buffer, midiBuffer);
+                if (trackIdx >= 0)
+                    tracks[static_cast<size_t>(trackIdx)]->getSynth()->processBlock(*buffer, midiBuffer);
+                else
+                    analogSynth.processBlock(*buffer, midiBuffer); // Fallback to global synth
+
+                midiBuffer.clear();
             }
-            midiBuffer.clear();
         }
     }
 
-    // Process all tracks - each track renders its synth to a temp buffer and mixes in
+    // Metronome clicks, mixed in after the master inserts
+    metronomeBuffer.setSize(2, numSamples, false, false, true);
+    juce::AudioBuffer<float> clicks(metronomeBuffer.getArrayOfWritePointers(), 2, numSamples);
+    clicks.clear();
+
+    // Process all tracks and groups through the compiled routing graph
     {
         PROFILE_SCOPE("AudioEngine::ProcessTracks");
         juce::ScopedLock sl(trackLock);
 
-        // Create a temp buffer for each track
-        juce::AudioBuffer<float> trackBuffer(buffer->getNumChannels(), numSamples);
-
-        for (auto& track : tracks)
+        // Return bus inputs that track sends are summed into. Worker 0 (the
+        // audio thread) writes them directly; mixer workers get their own
+        // copies so parallel tracks never write the same buffer.
+        for (size_t w = 0; w < workerSendTargets.size(); ++w)
         {
-            if (!track || track->isMuted()) continue;
+            for (size_t i = 0; i < returnBuses.size(); ++i)
+            {
+                if (!returnBuses[i])
+                {
+                    workerSendTargets[w][i] = nullptr;
+                    continue;
+                }
 
-            // Clear track buffer
-            trackBuffer.clear();
+                if (w == 0)
+                {
+                    returnBuses[i]->beginBlock(numSamples);
+                    workerSendTargets[w][i] = &returnBuses[i]->getInputBuffer();
+                }
+                else
+                {
+                    auto& sendBuffer = workerSendBuffers[w][i];
+                    sendBuffer.setSize(2, numSamples, false, false, true);
+                    sendBuffer.clear();
+                    workerSendTargets[w][i] = &sendBuffer;
+                }
+            }
+        }
 
-            // Track renders its synth into trackBuffer
-            track->processBlock(trackBuffer, numSamples, positionInBeats.load(), currentBpm.load());
+        blockPositionInBeats = positionInBeats.load();
+        blockBpm = currentBpm.load();
 
-            // Mix track into main buffer
-            for (int ch = 0; ch < buffer->getNumChannels(); ++ch)
+        collectMonitoredInputsLocked();
+        mixerGraph.process(*buffer, numSamples, *this);
+
+        // Fold the workers' sends into the bus inputs
+        for (size_t w = 1; w < workerSendTargets.size(); ++w)
+        {
+            for (size_t i = 0; i < returnBuses.size(); ++i)
+            {
+                if (!returnBuses[i])
+                    continue;
+
+                auto& input = returnBuses[i]->getInputBuffer();
+                for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                    input.addFrom(ch, 0, workerSendBuffers[w][i], ch, 0, numSamples);
+            }
+        }
+
+        // Each shared send effect runs once over everything sent to it
+        {
+            PROFILE_SCOPE("AudioEngine::ReturnBuses");
+            for (auto& bus : returnBuses)
             {
-                buffer->addFrom(ch, 0, trackBuffer, ch, 0, numSamples);
+                if (bus)
+                    bus->processBlock(*buffer, numSamples);
             }
         }
+
+        // Process metronome (must be before advancing position for accurate
+        // timing). It is delayed like the mix so clicks land on the beats
+        // being heard; trackLock guards the delay's length.
+        if (playing.load() || inCountIn.load())
+        {
+            processMetronome(clicks, blockStartBeat, blockEndBeat);
+        }
+        metronomeDelay.process(clicks, numSamples);
     }
 
     // Process through effect chain
@@ -169,15 +271,17 @@ void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferTo
         effectChain.processBlock(*buffer);
     }
 
-    // Process metronome (must be before advancing position for accurate timing)
-    if (playing.load() || inCountIn.load())
-    {
-        processMetronome(*buffer, blockStartBeat, blockEndBeat);
-    }
+    // Monitored inputs join here, so they don't wait out the mix's compensation
+    addInputMonitoring(*buffer, numSamples);
+
+    for (int ch = 0; ch < juce::jmin(buffer->getNumChannels(), clicks.getNumChannels()); ++ch)
+        buffer->addFrom(ch, 0, clicks, ch, 0, numSamples);
 
-    // Advance transport position when playing (but not during count-in)
+    // Advance transport position when playing (but not during count-in),
+    // recording the inputs from the position they arrived at
     if (playing.load() && !inCountIn.load())
     {
+        inputRecorder.write(numSamples, blockStartBeat);
         advancePosition(numSamples);
     }
 
@@ -212,10 +316,24 @@ void AudioEngine::releaseResources()
     effectChain.releaseResources();
 
     juce::ScopedLock sl(trackLock);
+    const TrackPrerenderer::ScopedPause pause(prerenderer);
+
     for (auto& track : tracks)
     {
         track->releaseResources();
     }
+
+    for (auto& bus : returnBuses)
+    {
+        if (bus)
+            bus->releaseResources();
+    }
+
+    for (auto& group : groupBuses)
+    {
+        if (group)
+            group->releaseResources();
+    }
 }
 
 //==============================================================================
@@ -302,6 +420,8 @@ void AudioEngine::synthAllNotesOff()
 
 void AudioEngine::play()
 {
+    beginAudioRecording();
+    cueLoopStart();
     playing.store(true);
 }
 
@@ -324,7 +444,9 @@ void AudioEngine::stop()
     analogSynth.allNotesOff();
 
     // Clear pending note-offs
-    trackPendingNoteOffs.clear();
+    clipScheduler.clear();
+
+    finishAudioRecording();
 }
 
 void AudioEngine::setPlaying(bool shouldPlay)
@@ -353,11 +475,273 @@ TimeSignatureEvent AudioEngine::getCurrentTimeSignature() const
     return timeSignatureTrack.getTimeSignatureAtBar(bars);
 }
 
+AudioEngine::AudioMemoryUsage AudioEngine::getAudioMemoryUsage() const
+{
+    AudioMemoryUsage usage;
+    std::set<const void*> counted;
+
+    for (const auto& track : tracks)
+    {
+        for (const auto& clip : track->getAudioClips())
+        {
+            if (const auto& stream = clip->getStream())
+            {
+                if (counted.insert(stream.get()).second)
+                    ++usage.numStreamedSources;
+            }
+            else if (const auto& compact = clip->getCompactAudio())
+            {
+                if (counted.insert(compact.get()).second)
+                {
+                    ++usage.numSources;
+                    ++usage.numCompactSources;
+                    usage.clipBytes += compact->getBytes();
+                    usage.floatBytes += compact->getFloatBytes();
+                }
+            }
+            else if (const auto& buffer = clip->getSharedBuffer())
+            {
+                if (counted.insert(buffer.get()).second)
+                {
+                    const auto bytes = static_cast<juce::int64>(buffer->getNumChannels()) * buffer->getNumSamples()
+                                     * static_cast<juce::int64>(sizeof(float));
+                    ++usage.numSources;
+                    usage.clipBytes += bytes;
+                    usage.floatBytes += bytes;
+                }
+            }
+        }
+    }
+
+    usage.warpRenderBytes = getClipWarpCache().getBytes();
+    return usage;
+}
+
 double AudioEngine::getPositionInSeconds() const
 {
     return positionInSamples.load() / sampleRate;
 }
 
+void AudioEngine::setNonRealtime(bool isNonRealtime)
+{
+    nonRealtime.store(isNonRealtime);
+
+    juce::ScopedLock sl(trackLock);
+    for (auto& track : tracks)
+        track->setNonRealtime(isNonRealtime);
+}
+
+juce::StringArray AudioEngine::copyProjectFrom(const AudioEngine& other)
+{
+    // Projects are only edited on the message thread, so other is read
+    // without its trackLock and keeps playing undisturbed
+    juce::AudioPluginFormatManager pluginFormats;
+    pluginFormats.addDefaultFormats();
+    juce::StringArray missingPlugins;
+
+    while (getNumTracks() > 0)
+        removeTrack(getNumTracks() - 1);
+
+    // Master and tempo first: tracks are prepared against them as they're added
+    tempoTrack.fromVar(other.tempoTrack.toVar());
+    timeSignatureTrack.fromVar(other.timeSignatureTrack.toVar());
+    currentBpm.store(other.currentBpm.load());
+    masterVolumeLevel.store(other.masterVolumeLevel.load());
+    effectChain.copyStateFrom(other.effectChain);
+
+    std::array<std::unique_ptr<ReturnBus>, MAX_RETURN_BUSES> newReturnBuses;
+    for (size_t i = 0; i < newReturnBuses.size(); ++i)
+    {
+        if (const auto& source = other.returnBuses[i])
+        {
+            auto bus = std::make_unique<ReturnBus>(source->getName());
+            bus->setReturnLevel(source->getReturnLevel());
+            bus->setMuted(source->isMuted());
+            bus->getEffectChain().copyStateFrom(source->getEffectChain());
+            bus->prepareToPlay(sampleRate, samplesPerBlock);
+            newReturnBuses[i] = std::move(bus);
+        }
+    }
+
+    std::array<std::unique_ptr<GroupBus>, MAX_GROUP_BUSES> newGroupBuses;
+    for (size_t i = 0; i < newGroupBuses.size(); ++i)
+    {
+        if (const auto& source = other.groupBuses[i])
+        {
+            auto group = std::make_unique<GroupBus>(source->getName());
+            group->setVolume(source->getVolume());
+            group->setPan(source->getPan());
+            group->setMuted(source->isMuted());
+            group->setOutputGroup(source->getOutputGroup());
+            group->getEffectChain().copyStateFrom(source->getEffectChain());
+            group->prepareToPlay(sampleRate, samplesPerBlock);
+            newGroupBuses[i] = std::move(group);
+        }
+    }
+
+    {
+        juce::ScopedLock sl(trackLock);
+        std::swap(returnBuses, newReturnBuses);
+        std::swap(groupBuses, newGroupBuses);
+        rebuildRoutingLocked();
+    }
+
+    for (const auto& source : other.tracks)
+    {
+        // Prepared first, so what's copied in is set up once, at this engine's rate
+        auto track = std::make_unique<Track>(source->getName());
+        track->prepareToPlay(sampleRate, getTrackBlockSize());
+        track->copyStateFrom(*source, pluginFormats, missingPlugins);
+        addTrack(std::move(track));
+    }
+
+    // The replaced buses go here, outside the lock
+    return missingPlugins;
+}
+
+bool AudioEngine::isLoading() const
+{
+    juce::ScopedLock sl(trackLock);
+
+    if (effectChain.isLoading())
+        return true;
+
+    for (const auto& track : tracks)
+    {
+        if (track->isLoading())
+            return true;
+    }
+
+    for (const auto& bus : returnBuses)
+    {
+        if (bus && bus->getEffectChain().isLoading())
+            return true;
+    }
+
+    for (const auto& group : groupBuses)
+    {
+        if (group && group->getEffectChain().isLoading())
+            return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+// Audio recording
+//==============================================================================
+
+void AudioEngine::beginAudioRecording()
+{
+    if (inputRecorder.isRecording())
+        return;
+
+    std::vector<AudioInputRecorder::Input> inputs;
+    {
+        juce::ScopedLock sl(trackLock);
+        for (const auto& track : tracks)
+        {
+            if (track->isArmed() && track->hasAudioInput())
+                inputs.push_back({ track->getId(), track->getName(),
+                                   track->getFirstInputChannel(), track->getNumInputChannels() });
+        }
+    }
+
+    if (!inputs.empty())
+        inputRecorder.beginTakes(inputs, sampleRate);
+}
+
+void AudioEngine::finishAudioRecording()
+{
+    auto takes = inputRecorder.endTakes();
+    if (takes.empty())
+        return;
+
+    // The player heard the tracks latencySamples after they were rendered,
+    // and what they played reached the recorder the device's latency later
+    const double lateBySeconds = (inputRecorder.getDeviceLatencySamples() + latencySamples.load()) / sampleRate;
+
+    // Files are opened before taking the lock the audio thread waits on
+    std::vector<std::pair<juce::Uuid, std::unique_ptr<AudioClip>>> clips;
+    for (const auto& take : takes)
+    {
+        auto stream = AudioFileStream::open(take.file, getAudioFileLoader().getFormatManager());
+        if (stream == nullptr)
+            continue;
+
+        if (take.peaks != nullptr)
+            getWaveformPeakStore().update(stream, take.peaks);
+
+        auto clip = std::make_unique<AudioClip>();
+        clip->setName(take.file.getFileNameWithoutExtension());
+        clip->setFilePath(take.file.getFullPathName());
+        clip->setStream(stream);
+
+        const double startSeconds = tempoTrack.beatsToSeconds(take.firstBeat) - lateBySeconds;
+        if (startSeconds < 0.0)
+            clip->setTrimStartSample(juce::roundToInt(-startSeconds * stream->getSampleRate()));
+        else
+            clip->setStartBeat(tempoTrack.secondsToBeats(startSeconds));
+
+        clips.emplace_back(take.trackId, std::move(clip));
+    }
+
+    // A take whose track was deleted while recording stays on disk
+    juce::ScopedLock sl(trackLock);
+    for (auto& [trackId, clip] : clips)
+    {
+        for (auto& track : tracks)
+        {
+            if (track->getId() == trackId)
+            {
+                track->addAudioClip(std::move(clip));
+                break;
+            }
+        }
+    }
+}
+
+void AudioEngine::collectMonitoredInputsLocked()
+{
+    // Called with trackLock held; never grows past the reserved capacity
+    monitoredInputs.clear();
+
+    for (const auto& track : tracks)
+    {
+        if (!track->isArmed() || !track->isInputMonitoring() || !track->hasAudioInput() || track->isMuted())
+            continue;
+
+        // Panned like the track's own output
+        const float volume = track->getVolume();
+        const float pan = track->getPan();
+
+        MonitoredInput input;
+        input.firstChannel = track->getFirstInputChannel();
+        input.numChannels = track->getNumInputChannels();
+        input.leftGain = volume * std::cos((pan + 1.0f) * juce::MathConstants<float>::halfPi * 0.5f);
+        input.rightGain = volume * std::sin((pan + 1.0f) * juce::MathConstants<float>::halfPi * 0.5f);
+        monitoredInputs.push_back(input);
+    }
+}
+
+void AudioEngine::addInputMonitoring(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    numSamples = juce::jmin(numSamples, inputRecorder.getNumCapturedSamples());
+    if (numSamples <= 0 || inputRecorder.getNumInputChannels() == 0)
+        return;
+
+    for (const auto& input : monitoredInputs)
+    {
+        const float* left = inputRecorder.getInputChannel(input.firstChannel);
+        const float* right = input.numChannels > 1 ? inputRecorder.getInputChannel(input.firstChannel + 1) : left;
+
+        if (left != nullptr)
+            buffer.addFrom(0, 0, left, numSamples, input.leftGain);
+        if (right != nullptr && buffer.getNumChannels() > 1)
+            buffer.addFrom(1, 0, right, numSamples, input.rightGain);
+    }
+}
+
 //==============================================================================
 // Track management
 //==============================================================================
@@ -366,8 +750,11 @@ void AudioEngine::addTrack(std::unique_ptr<Track> track)
 {
     juce::ScopedLock sl(trackLock);
 
-    track->prepareToPlay(sampleRate, samplesPerBlock);
+    track->prepareToPlay(sampleRate, getTrackBlockSize());
+    track->setNonRealtime(nonRealtime.load());
+    track->setTempoTrack(&tempoTrack);
     tracks.push_back(std::move(track));
+    rebuildRoutingLocked();
 }
 
 void AudioEngine::removeTrack(int index)
@@ -376,7 +763,386 @@ void AudioEngine::removeTrack(int index)
 
     if (index >= 0 && index < static_cast<int>(tracks.size()))
     {
+        // Workers must be off the track before it goes
+        const TrackPrerenderer::ScopedPause pause(prerenderer);
+        clipScheduler.forgetTrack(tracks[static_cast<size_t>(index)].get());
         tracks.erase(tracks.begin() + index);
+        rebuildRoutingLocked();
+    }
+}
+
+//==============================================================================
+// Return buses
+//==============================================================================
+
+int AudioEngine::addReturnBus(const juce::String& name)
+{
+    auto bus = std::make_unique<ReturnBus>(name);
+    bus->prepareToPlay(sampleRate, samplesPerBlock);
+
+    juce::ScopedLock sl(trackLock);
+
+    for (int i = 0; i < MAX_RETURN_BUSES; ++i)
+    {
+        if (!returnBuses[static_cast<size_t>(i)])
+        {
+            returnBuses[static_cast<size_t>(i)] = std::move(bus);
+            rebuildRoutingLocked();
+            return i;
+        }
+    }
+    return -1; // No free slot
+}
+
+void AudioEngine::removeReturnBus(int slot)
+{
+    std::unique_ptr<ReturnBus> removed;
+
+    {
+        juce::ScopedLock sl(trackLock);
+        if (slot >= 0 && slot < MAX_RETURN_BUSES)
+        {
+            removed = std::move(returnBuses[static_cast<size_t>(slot)]);
+            rebuildRoutingLocked();
+        }
+    }
+
+    // Destroyed outside the lock so the audio thread isn't held up;
+    // sends to this slot are ignored until a new bus takes it
+}
+
+ReturnBus* AudioEngine::getReturnBus(int slot)
+{
+    juce::ScopedLock sl(trackLock);
+
+    if (slot >= 0 && slot < MAX_RETURN_BUSES)
+        return returnBuses[static_cast<size_t>(slot)].get();
+    return nullptr;
+}
+
+int AudioEngine::getNumReturnBuses() const
+{
+    juce::ScopedLock sl(trackLock);
+
+    int count = 0;
+    for (const auto& bus : returnBuses)
+    {
+        if (bus)
+            ++count;
+    }
+    return count;
+}
+
+//==============================================================================
+// Group buses and routing
+//==============================================================================
+
+int AudioEngine::addGroupBus(const juce::String& name)
+{
+    auto group = std::make_unique<GroupBus>(name);
+    group->prepareToPlay(sampleRate, samplesPerBlock);
+
+    juce::ScopedLock sl(trackLock);
+
+    for (int i = 0; i < MAX_GROUP_BUSES; ++i)
+    {
+        if (!groupBuses[static_cast<size_t>(i)])
+        {
+            groupBuses[static_cast<size_t>(i)] = std::move(group);
+            rebuildRoutingLocked();
+            return i;
+        }
+    }
+    return -1; // No free slot
+}
+
+void AudioEngine::removeGroupBus(int slot)
+{
+    std::unique_ptr<GroupBus> removed;
+
+    {
+        juce::ScopedLock sl(trackLock);
+        if (slot < 0 || slot >= MAX_GROUP_BUSES || !groupBuses[static_cast<size_t>(slot)])
+            return;
+
+        removed = std::move(groupBuses[static_cast<size_t>(slot)]);
+
+        // Anything that fed the group now goes straight to the master
+        for (auto& track : tracks)
+        {
+            if (track->getOutputGroup() == slot)
+                track->setOutputGroup(-1);
+        }
+        for (auto& group : groupBuses)
+        {
+            if (group && group->getOutputGroup() == slot)
+                group->setOutputGroup(-1);
+        }
+
+        rebuildRoutingLocked();
+    }
+
+    // Destroyed outside the lock, like return buses
+}
+
+GroupBus* AudioEngine::getGroupBus(int slot)
+{
+    juce::ScopedLock sl(trackLock);
+
+    if (slot >= 0 && slot < MAX_GROUP_BUSES)
+        return groupBuses[static_cast<size_t>(slot)].get();
+    return nullptr;
+}
+
+int AudioEngine::getNumGroupBuses() const
+{
+    juce::ScopedLock sl(trackLock);
+
+    int count = 0;
+    for (const auto& group : groupBuses)
+    {
+        if (group)
+            ++count;
+    }
+    return count;
+}
+
+bool AudioEngine::setTrackOutput(int trackIndex, int groupSlot)
+{
+    juce::ScopedLock sl(trackLock);
+
+    if (trackIndex < 0 || trackIndex >= static_cast<int>(tracks.size()))
+        return false;
+
+    if (groupSlot >= 0 && (groupSlot >= MAX_GROUP_BUSES || !groupBuses[static_cast<size_t>(groupSlot)]))
+        return false;
+
+    tracks[static_cast<size_t>(trackIndex)]->setOutputGroup(juce::jmax(-1, groupSlot));
+    rebuildRoutingLocked();
+    return true;
+}
+
+bool AudioEngine::setGroupOutput(int groupSlot, int destinationSlot)
+{
+    juce::ScopedLock sl(trackLock);
+
+    if (groupSlot < 0 || groupSlot >= MAX_GROUP_BUSES || !groupBuses[static_cast<size_t>(groupSlot)])
+        return false;
+
+    if (destinationSlot >= 0)
+    {
+        if (destinationSlot >= MAX_GROUP_BUSES || !groupBuses[static_cast<size_t>(destinationSlot)])
+            return false;
+
+        // Refuse loops: follow the destination's chain and make sure it
+        // never comes back to this group
+        int slot = destinationSlot;
+        for (int hops = 0; slot >= 0 && hops <= MAX_GROUP_BUSES; ++hops)
+        {
+            if (slot == groupSlot)
+                return false;
+
+            auto& next = groupBuses[static_cast<size_t>(slot)];
+            slot = next ? next->getOutputGroup() : -1;
+        }
+    }
+
+    groupBuses[static_cast<size_t>(groupSlot)]->setOutputGroup(juce::jmax(-1, destinationSlot));
+    rebuildRoutingLocked();
+    return true;
+}
+
+void AudioEngine::updateRouting()
+{
+    juce::ScopedLock sl(trackLock);
+    rebuildRoutingLocked();
+}
+
+void AudioEngine::setNumMixerThreads(int numThreads)
+{
+    juce::ScopedLock sl(trackLock);
+    numMixerThreads = juce::jlimit(0, 16, numThreads);
+    rebuildRoutingLocked();
+}
+
+void AudioEngine::rebuildRoutingLocked()
+{
+    // Called with trackLock held. Nodes are the tracks in order (so a node
+    // index is also the track index sidechains refer to), then live groups.
+    const TrackPrerenderer::ScopedPause pause(prerenderer);
+    const int numTracks = static_cast<int>(tracks.size());
+
+    std::array<int, MAX_GROUP_BUSES> groupNodes;
+    groupNodes.fill(MixerGraph::MASTER);
+    routingGroups.clear();
+
+    for (int slot = 0; slot < MAX_GROUP_BUSES; ++slot)
+    {
+        if (auto* group = groupBuses[static_cast<size_t>(slot)].get())
+        {
+            groupNodes[static_cast<size_t>(slot)] = numTracks + static_cast<int>(routingGroups.size());
+            routingGroups.push_back(group);
+        }
+    }
+
+    auto nodeForGroup = [&groupNodes](int slot)
+    {
+        return (slot >= 0 && slot < MAX_GROUP_BUSES) ? groupNodes[static_cast<size_t>(slot)]
+                                                     : MixerGraph::MASTER;
+    };
+
+    // Delay compensation. Tracks line themselves up with the slowest track
+    // before their sends, so everything reaching a return bus is aligned;
+    // the graph takes it from there for groups and the master.
+    compiledLatencies = collectLatenciesLocked();
+    const int numGroups = static_cast<int>(routingGroups.size());
+
+    int trackLatency = 0;
+    for (int t = 0; t < numTracks; ++t)
+        trackLatency = juce::jmax(trackLatency, compiledLatencies[static_cast<size_t>(t)]);
+
+    for (int t = 0; t < numTracks; ++t)
+        tracks[static_cast<size_t>(t)]->setLatencyCompensation(trackLatency - compiledLatencies[static_cast<size_t>(t)]);
+
+    // Returns reach the master outside the graph, so its paths must be at
+    // least as late as the slowest return
+    int returnLatency = 0;
+    for (int r = 0; r < MAX_RETURN_BUSES; ++r)
+    {
+        if (returnBuses[static_cast<size_t>(r)])
+            returnLatency = juce::jmax(returnLatency, trackLatency
+                                       + compiledLatencies[static_cast<size_t>(numTracks + numGroups + r)]);
+    }
+
+    std::vector<MixerGraph::NodeInfo> nodes;
+    nodes.reserve(static_cast<size_t>(numTracks) + routingGroups.size());
+
+    for (auto& track : tracks)
+        nodes.push_back({ nodeForGroup(track->getOutputGroup()), track->getEffectChain().getSidechainSources(),
+                          trackLatency });
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        auto* group = routingGroups[static_cast<size_t>(g)];
+        nodes.push_back({ nodeForGroup(group->getOutputGroup()), group->getEffectChain().getSidechainSources(),
+                          compiledLatencies[static_cast<size_t>(numTracks + g)] });
+    }
+
+    // Keyed tracks wait on their sources' blocks, so they stay at the playhead
+    keyedTracks.assign(static_cast<size_t>(numTracks), 0);
+    for (int t = 0; t < numTracks; ++t)
+        keyedTracks[static_cast<size_t>(t)] = nodes[static_cast<size_t>(t)].keySources.empty() ? 0 : 1;
+
+    monitoredInputs.reserve(tracks.size());
+
+    std::vector<Track*> trackPointers;
+    trackPointers.reserve(tracks.size());
+    for (auto& track : tracks)
+        trackPointers.push_back(track.get());
+    prerenderer.setTracks(trackPointers);
+
+    // Sidechain sources are track indices; a key from a removed track is
+    // dropped by compile() as out of range
+    mixerGraph.setNumWorkers(numMixerThreads);
+    mixerGraph.compile(nodes, 2, juce::jmax(1, samplesPerBlock), returnLatency);
+
+    const int mixLatency = mixerGraph.getLatencySamples();
+    for (int r = 0; r < MAX_RETURN_BUSES; ++r)
+    {
+        if (auto* bus = returnBuses[static_cast<size_t>(r)].get())
+            bus->setLatencyCompensation(mixLatency - trackLatency
+                                        - compiledLatencies[static_cast<size_t>(numTracks + numGroups + r)]);
+    }
+
+    // The master insert chain delays everything after the mix equally; the
+    // metronome is added after it, so it is held back by the whole amount
+    const int totalLatency = mixLatency + compiledLatencies.back();
+    metronomeDelay.setDelay(totalLatency);
+    latencySamples.store(totalLatency);
+
+    const size_t numWorkerSlots = static_cast<size_t>(mixerGraph.getNumWorkers()) + 1;
+    workerSendTargets.assign(numWorkerSlots, Track::SendTargets{});
+    workerSendBuffers.resize(numWorkerSlots);
+
+    for (size_t w = 1; w < numWorkerSlots; ++w)
+    {
+        for (auto& sendBuffer : workerSendBuffers[w])
+            sendBuffer.setSize(2, juce::jmax(1, samplesPerBlock));
+    }
+}
+
+std::vector<int> AudioEngine::collectLatenciesLocked() const
+{
+    // Tracks, live groups in routing order, every return slot, then the
+    // master inserts
+    std::vector<int> latencies;
+    latencies.reserve(tracks.size() + routingGroups.size() + MAX_RETURN_BUSES + 1);
+
+    for (const auto& track : tracks)
+        latencies.push_back(track->getLatencySamples());
+
+    for (const auto* group : routingGroups)
+        latencies.push_back(group->getLatencySamples());
+
+    for (const auto& bus : returnBuses)
+        latencies.push_back(bus ? bus->getLatencySamples() : 0);
+
+    latencies.push_back(effectChain.getLatencySamples());
+    return latencies;
+}
+
+void AudioEngine::updateLatencyCompensation()
+{
+    juce::ScopedLock sl(trackLock);
+
+    if (collectLatenciesLocked() != compiledLatencies)
+        rebuildRoutingLocked();
+}
+
+double AudioEngine::getAudiblePositionInBeats() const
+{
+    const double position = positionInBeats.load();
+    if (!playing.load() || sampleRate <= 0.0)
+        return position;
+
+    // What is coming out of the speakers left the tracks this long ago
+    const double latencyBeats = latencySamples.load() * (currentBpm.load() / 60.0) / sampleRate;
+    return juce::jmax(0.0, position - latencyBeats);
+}
+
+void AudioEngine::provideSidechain(int node, int sourceNode, const juce::AudioBuffer<float>& key)
+{
+    const int numTracks = static_cast<int>(tracks.size());
+
+    if (node < numTracks)
+        tracks[static_cast<size_t>(node)]->getEffectChain().provideSidechainInput(sourceNode, key);
+    else if (node - numTracks < static_cast<int>(routingGroups.size()))
+        routingGroups[static_cast<size_t>(node - numTracks)]->getEffectChain().provideSidechainInput(sourceNode, key);
+}
+
+void AudioEngine::processNode(int node, juce::AudioBuffer<float>& buffer, int numSamples, int workerIndex)
+{
+    const int numTracks = static_cast<int>(tracks.size());
+
+    if (node < numTracks)
+    {
+        auto& track = *tracks[static_cast<size_t>(node)];
+        auto* sendTargets = &workerSendTargets[static_cast<size_t>(workerIndex)];
+
+        // A muted track returns early and leaves its buffer silent
+        if (prerenderer.isRenderingAhead(node))
+        {
+            prerenderer.read(node, buffer, numSamples);
+            track.mixBlock(buffer, numSamples, blockPositionInBeats, sendTargets);
+        }
+        else
+        {
+            track.processBlock(buffer, numSamples, blockPositionInBeats, blockBpm, sendTargets);
+        }
+    }
+    else if (node - numTracks < static_cast<int>(routingGroups.size()))
+    {
+        routingGroups[static_cast<size_t>(node - numTracks)]->processBlock(buffer, numSamples);
     }
 }
 
@@ -396,9 +1162,13 @@ void AudioEngine::setPositionInBeats(double beats)
     positionInBeats.store(std::max(0.0, beats));
     // Use TempoTrack for accurate beat-to-seconds conversion
     positionInSamples.store(tempoTrack.beatsToSeconds(beats) * sampleRate);
+    currentBpm.store(tempoTrack.getTempoAtBeat(positionInBeats.load()));
 
-    // Clear pending note-offs when seeking
-    trackPendingNoteOffs.clear();
+    // Clear pending note-offs when seeking (rendered-ahead tracks notice the
+    // jump themselves)
+    clipScheduler.clear();
+
+    cueStreamedClips(AudioFileStream::Cue::Seek, beats);
 
     // Send all notes off to prevent stuck notes
     synthAllNotesOff();
@@ -499,100 +1269,107 @@ void AudioEngine::setLoopRange(double startBeat, double endBeat)
     {
         loopStartBeat.store(startBeat);
         loopEndBeat.store(endBeat);
+        cueLoopStart();
     }
 }
 
+void AudioEngine::setLoopEnabled(bool enabled)
+{
+    loopEnabled.store(enabled);
+    cueLoopStart();
+}
+
+void AudioEngine::cueLoopStart()
+{
+    cueStreamedClips(AudioFileStream::Cue::Loop, loopEnabled.load() ? loopStartBeat.load() : -1.0);
+}
+
+void AudioEngine::cueStreamedClips(AudioFileStream::Cue cue, double beat)
+{
+    const double bpm = tempoTrack.getTempoAtBeat(std::max(0.0, beat));
+
+    juce::ScopedLock sl(trackLock);
+    for (auto& track : tracks)
+        track->cueAudioClips(cue, beat, bpm);
+}
+
 //==============================================================================
 // Clip MIDI Scheduling
 //==============================================================================
 
 void AudioEngine::scheduleClipMidiToTracks(double blockStartBeat, double blockEndBeat, int numSamples)
 {
-    juce::ScopedLock sl(trackLock);
-
-    // Calculate beats-to-samples conversion for this block
-    const double beatsInBlock = blockEndBeat - blockStartBeat;
-    const double samplesPerBeat = (beatsInBlock > 0.0) ? numSamples / beatsInBlock : 0.0;
+    // Called with trackLock held
+    clipScheduler.processNoteOffs(blockStartBeat, blockEndBeat, numSamples);
 
-    // Helper to convert beat position to sample offset within this block
-    auto beatToSampleOffset = [&](double beat) -> int {
-        double beatsFromBlockStart = beat - blockStartBeat;
-        int sampleOffset = static_cast<int>(beatsFromBlockStart * samplesPerBeat);
-        return juce::jlimit(0, numSamples - 1, sampleOffset);
-    };
-
-    // Process pending note-offs first
-    auto it = trackPendingNoteOffs.begin();
-    while (it != trackPendingNoteOffs.end())
+    for (size_t t = 0; t < tracks.size(); ++t)
     {
-        if (it->endBeat <= blockEndBeat && it->track)
-        {
-            int sampleOffset = beatToSampleOffset(it->endBeat);
-            it->track->synthNoteOff(it->midiNote, sampleOffset);
-            it = trackPendingNoteOffs.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
+        auto& track = *tracks[t];
+        if (track.isMuted() || prerenderer.isRenderingAhead(static_cast<int>(t)))
+            continue;
+
+        clipScheduler.scheduleTrack(track, blockStartBeat, blockEndBeat, numSamples);
     }
+}
 
-    // Process each track's clips
-    for (auto& track : tracks)
-    {
-        if (track->isMuted()) continue;
+//==============================================================================
+// Anticipative rendering
+//==============================================================================
 
-        // Convert beats to bars for the clip query (using TimeSignatureTrack for variable meters)
-        double startBar = timeSignatureTrack.beatsToBar(blockStartBeat);
-        double endBar = timeSignatureTrack.beatsToBar(blockEndBeat);
+void AudioEngine::updatePrerenderingLocked(double blockStartBeat, double bpm)
+{
+    // Ahead-of-time rendering only pays while the transport runs, and an
+    // offline render has all the time it needs
+    const bool transportRunning = playing.load() && !inCountIn.load();
+    const bool enabled = transportRunning && anticipativeRendering.load() && !nonRealtime.load();
 
-        std::vector<MidiClip*> activeClips;
-        track->getClipsInRange(startBar, endBar, activeClips);
+    // The keyboard plays the selected track, or the first if that has no synth
+    int keyboardTrack = keyboardTrackIndex.load();
+    if (keyboardTrack < 0 || keyboardTrack >= static_cast<int>(tracks.size())
+        || tracks[static_cast<size_t>(keyboardTrack)]->getSynth() == nullptr)
+        keyboardTrack = 0;
 
-        // Process each clip for this track
-        for (auto* clip : activeClips)
-        {
-            // Convert block range to clip-relative beats
-            double clipStartBeat = clip->getStartBeat();
-            double localStartBeat = blockStartBeat - clipStartBeat;
-            double localEndBeat = blockEndBeat - clipStartBeat;
+    prerenderer.beginBlock(loopEnabled.load(), loopStartBeat.load(), loopEndBeat.load());
 
-            // Get notes that start within this block
-            std::vector<const Note*> notes;
-            clip->getNotesInRange(localStartBeat, localEndBeat, notes);
+    for (int t = 0; t < static_cast<int>(tracks.size()); ++t)
+    {
+        auto& track = *tracks[static_cast<size_t>(t)];
+        const bool keyed = static_cast<size_t>(t) < keyedTracks.size() && keyedTracks[static_cast<size_t>(t)] != 0;
+        const bool renderAhead = enabled && !track.isMuted() && !track.isArmed() && t != keyboardTrack && !keyed;
 
-            for (const auto* note : notes)
-            {
-                double noteAbsoluteStartBeat = clipStartBeat + note->startBeat;
-                double noteAbsoluteEndBeat = noteAbsoluteStartBeat + note->durationBeats;
+        const bool wasAhead = prerenderer.isRenderingAhead(t);
+        prerenderer.syncTrack(t, renderAhead, blockStartBeat, bpm);
 
-                // Calculate sample offset for note-on
-                int noteOnOffset = beatToSampleOffset(noteAbsoluteStartBeat);
+        // What the stream did, which may lag what was asked by a block or two
+        const bool isAhead = prerenderer.isRenderingAhead(t);
 
-                // Send note-on to this track's synth with correct timing
-                track->synthNoteOn(note->midiNote, note->velocity, noteOnOffset);
+        if (isAhead && !wasAhead)
+        {
+            // The stream has released the voices; their note-offs go too
+            clipScheduler.forgetTrack(&track);
+        }
+        else if (wasAhead && !isAhead && transportRunning)
+        {
+            // Back at the playhead mid-song: pick up the notes already sounding
+            clipScheduler.chaseNotes(track, blockStartBeat);
+        }
+    }
+}
 
-                // Check if note-off is within this block
-                if (noteAbsoluteEndBeat <= blockEndBeat)
-                {
-                    // Calculate sample offset for note-off
-                    int noteOffOffset = beatToSampleOffset(noteAbsoluteEndBeat);
+void AudioEngine::setNumPrerenderThreads(int numThreads)
+{
+    prerenderer.setNumThreads(numThreads);
+}
 
-                    // Ensure note-off comes after note-on (minimum 1 sample duration)
-                    if (noteOffOffset <= noteOnOffset)
-                        noteOffOffset = juce::jmin(noteOnOffset + 1, numSamples - 1);
+bool AudioEngine::isTrackRenderedAhead(int trackIndex) const
+{
+    return prerenderer.isRenderingAhead(trackIndex);
+}
 
-                    // Note ends within this block
-                    track->synthNoteOff(note->midiNote, noteOffOffset);
-                }
-                else
-                {
-                    // Note extends beyond this block - add to pending
-                    trackPendingNoteOffs.push_back({ track.get(), note->midiNote, noteAbsoluteEndBeat });
-                }
-            }
-        }
-    }
+void AudioEngine::invalidateAnticipativeRender(int trackIndex)
+{
+    juce::ScopedLock sl(trackLock);
+    prerenderer.invalidate(trackIndex);
 }
 
 //==============================================================================
@@ -626,6 +1403,7 @@ void AudioEngine::playWithCountIn()
         countInBeatsRemaining.store(bars * beatsPerBar);
         inCountIn.store(true);
         lastMetronomeBeat = -1.0;
+        beginAudioRecording();
 
         // Start playback - metronome will play during count-in
         playing.store(true);
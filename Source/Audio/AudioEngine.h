@@ -10,6 +10,12 @@
 #include "Effects/ReverbEffect.h"
 #include "Effects/DelayEffect.h"
 #include "Effects/ChorusEffect.h"
+#include "ReturnBus.h"
+#include "GroupBus.h"
+#include "MixerGraph.h"
+#include "ClipMidiScheduler.h"
+#include "AudioInputRecorder.h"
+#include "TrackPrerenderer.h"
 #include "TempoTrack.h"
 #include "TimeSignatureTrack.h"
 #include "MarkerTrack.h"
@@ -23,10 +29,14 @@
  * - Manages all audio processing
  * - Owns and processes all tracks
  * - Handles transport (play/stop/position)
+ * - Routes tracks through group buses and sidechains via a compiled MixerGraph
+ * - Renders tracks nobody is playing live ahead of the playhead (TrackPrerenderer)
+ * - Records armed tracks' audio inputs to disk (AudioInputRecorder)
  * - Provides master output chain (EQ, compression, limiting)
  * - Thread-safe communication with UI via lock-free queues
  */
-class AudioEngine : public juce::AudioSource
+class AudioEngine : public juce::AudioSource,
+                    private MixerGraph::NodeProcessor
 {
 public:
     AudioEngine();
@@ -51,6 +61,24 @@ public:
     double getPositionInBeats() const { return positionInBeats.load(); }
     double getPositionInSeconds() const;
 
+    // The position being heard: getPositionInBeats() less the mix latency
+    // while playing (for the playhead and position display)
+    double getAudiblePositionInBeats() const;
+
+    // Offline rendering (export) - tracks switch to high-quality resampling
+    void setNonRealtime(bool isNonRealtime);
+    bool isNonRealtime() const { return nonRealtime.load(); }
+
+    // Make this engine a copy of other's project to render it elsewhere (see
+    // OfflineRenderer): tracks, buses and routing, master inserts and volume,
+    // tempo and time signature maps. Clip audio is shared, not copied.
+    // Message thread, while this engine isn't playing.
+    // Returns the plugins that couldn't be recreated.
+    juce::StringArray copyProjectFrom(const AudioEngine& other);
+
+    // True while an instrument or insert is still loading in the background
+    bool isLoading() const;
+
     //==========================================================================
     // Track management (called from message thread)
     void addTrack(std::unique_ptr<Track> track);
@@ -84,6 +112,83 @@ public:
     // Effects chain
     EffectChain& getEffectChain() { return effectChain; }
 
+    //==========================================================================
+    // Return buses (shared send effects, one slot per Track send)
+    static constexpr int MAX_RETURN_BUSES = Track::MAX_SENDS;
+
+    // Add a bus in the next free slot (returns slot index, or -1 if full)
+    int addReturnBus(const juce::String& name);
+    void removeReturnBus(int slot);
+    ReturnBus* getReturnBus(int slot);
+    int getNumReturnBuses() const;
+
+    //==========================================================================
+    // Group buses and routing (message thread)
+    static constexpr int MAX_GROUP_BUSES = 16;
+
+    // Add a group in the next free slot (returns slot index, or -1 if full)
+    int addGroupBus(const juce::String& name);
+    void removeGroupBus(int slot);
+    GroupBus* getGroupBus(int slot);
+    int getNumGroupBuses() const;
+
+    // Route a track / group into a group slot, or -1 for the master.
+    // Returns false (and leaves routing unchanged) if it would create a loop.
+    bool setTrackOutput(int trackIndex, int groupSlot);
+    bool setGroupOutput(int groupSlot, int destinationSlot);
+
+    /** Recompile the mixer schedule - call after changing a sidechain source */
+    void updateRouting();
+
+    // Worker threads that process independent tracks in parallel (0 = off)
+    void setNumMixerThreads(int numThreads);
+    int getNumMixerThreads() const { return numMixerThreads; }
+
+    const MixerGraph& getMixerGraph() const { return mixerGraph; }
+
+    //==========================================================================
+    // Delay compensation
+
+    /** Recompile if a track, bus or master insert latency changed (message thread) */
+    void updateLatencyCompensation();
+
+    /** Samples from the tracks to the output, compensation included */
+    int getLatencySamples() const { return latencySamples.load(); }
+
+    //==========================================================================
+    // Anticipative rendering
+
+    // While playing, tracks that aren't armed, muted, keyed by a sidechain or
+    // taking keyboard input are rendered ahead of the playhead on worker
+    // threads. Off for offline rendering.
+    void setAnticipativeRendering(bool enabled) { anticipativeRendering.store(enabled); }
+    bool isAnticipativeRendering() const { return anticipativeRendering.load(); }
+
+    void setNumPrerenderThreads(int numThreads);
+    int getNumPrerenderThreads() const { return prerenderer.getNumThreads(); }
+
+    /** True if the track played from what was rendered ahead in the last block */
+    bool isTrackRenderedAhead(int trackIndex) const;
+
+    /** Blocks a rendered-ahead track went silent in because its worker was busy */
+    int getPrerenderUnderrunCount() const { return prerenderer.getUnderrunCount(); }
+
+    /**
+     * Re-render a track (-1 for all) from the playhead, for changes tracks
+     * can't detect themselves, such as a plugin's parameters
+     */
+    void invalidateAnticipativeRender(int trackIndex = -1);
+
+    //==========================================================================
+    // Audio recording
+
+    // Add to the device manager before the player running this engine. Armed
+    // tracks with an audio input record from play() (after any count-in) to
+    // stop(), which puts each take on its track as a streamed clip, placed
+    // earlier by the device and mix latency so it lines up with what the
+    // player heard. Monitored inputs are mixed in after the master inserts.
+    AudioInputRecorder& getInputRecorder() { return inputRecorder; }
+
     //==========================================================================
     // Metronome
     void setMetronomeEnabled(bool enabled);
@@ -104,9 +209,9 @@ public:
 
     //==========================================================================
     // Loop
-    void setLoopEnabled(bool enabled) { loopEnabled.store(enabled); }
+    void setLoopEnabled(bool enabled);
     bool isLoopEnabled() const { return loopEnabled.load(); }
-    void toggleLoop() { loopEnabled.store(!loopEnabled.load()); }
+    void toggleLoop() { setLoopEnabled(!loopEnabled.load()); }
 
     void setLoopRange(double startBeat, double endBeat);
     double getLoopStartBeat() const { return loopStartBeat.load(); }
@@ -117,6 +222,21 @@ public:
     float getMasterLevelL() const { return masterLevelL.load(); }
     float getMasterLevelR() const { return masterLevelR.load(); }
 
+    //==========================================================================
+    // Memory use (message thread)
+
+    struct AudioMemoryUsage
+    {
+        juce::int64 clipBytes = 0;          // RAM held by the clips' audio, each shared source once
+        juce::int64 floatBytes = 0;         // What the same audio would take as floats
+        juce::int64 warpRenderBytes = 0;    // Stretched renders of warped clips (shared by every project)
+        int numSources = 0;
+        int numCompactSources = 0;
+        int numStreamedSources = 0;         // Played from disk, so not counted above
+    };
+
+    AudioMemoryUsage getAudioMemoryUsage() const;
+
     //==========================================================================
     // Arrangement tracks
     TempoTrack& getTempoTrack() { return tempoTrack; }
@@ -144,6 +264,7 @@ private:
     std::atomic<double> currentBpm{120.0};
     std::atomic<double> positionInBeats{0.0};
     std::atomic<double> positionInSamples{0.0};
+    std::atomic<bool> nonRealtime{false};
 
     // Loop state
     std::atomic<bool> loopEnabled{false};
@@ -187,9 +308,60 @@ private:
     std::map<int, PendingNote> pendingRecordingNotes;  // midiNote -> PendingNote
     juce::CriticalSection recordingLock;
 
+    // Audio recording (takes begin and end on the message thread)
+    AudioInputRecorder inputRecorder;
+    void beginAudioRecording();
+    void finishAudioRecording();
+
+    // Inputs to monitor this block, gathered while trackLock is already held
+    // for the tracks (room for every track is reserved by rebuildRoutingLocked())
+    struct MonitoredInput
+    {
+        int firstChannel = 0;
+        int numChannels = 1;
+        float leftGain = 1.0f;
+        float rightGain = 1.0f;
+    };
+    std::vector<MonitoredInput> monitoredInputs;
+    void collectMonitoredInputsLocked();
+    void addInputMonitoring(juce::AudioBuffer<float>& buffer, int numSamples);
+
     // Effects chain (processes synth output before master chain)
     EffectChain effectChain;
 
+    // Return buses (guarded by trackLock)
+    std::array<std::unique_ptr<ReturnBus>, MAX_RETURN_BUSES> returnBuses;
+
+    // Group buses and the compiled routing (guarded by trackLock)
+    std::array<std::unique_ptr<GroupBus>, MAX_GROUP_BUSES> groupBuses;
+    MixerGraph mixerGraph;
+    std::vector<GroupBus*> routingGroups;   // Graph node (after the tracks) -> group
+    int numMixerThreads = 0;
+
+    // Send inputs for mixer workers; worker 0 writes the return buses directly
+    std::vector<std::array<juce::AudioBuffer<float>, MAX_RETURN_BUSES>> workerSendBuffers;
+    std::vector<Track::SendTargets> workerSendTargets;
+
+    // Block context for processNode()
+    double blockPositionInBeats = 0.0;
+    double blockBpm = 120.0;
+
+    // Delay compensation (guarded by trackLock)
+    std::vector<int> compiledLatencies;     // As returned by collectLatenciesLocked()
+    CompensationDelay metronomeDelay;
+    juce::AudioBuffer<float> metronomeBuffer;
+    std::atomic<int> latencySamples{0};
+
+    void rebuildRoutingLocked();
+    std::vector<int> collectLatenciesLocked() const;
+
+    // Tracks are prepared for the prerenderer's chunks as well as the device's blocks
+    int getTrackBlockSize() const { return juce::jmax(samplesPerBlock, TrackPrerenderer::CHUNK_SIZE); }
+
+    // MixerGraph::NodeProcessor
+    void provideSidechain(int node, int sourceNode, const juce::AudioBuffer<float>& key) override;
+    void processNode(int node, juce::AudioBuffer<float>& buffer, int numSamples, int workerIndex) override;
+
     // Arrangement tracks
     TempoTrack tempoTrack;
     TimeSignatureTrack timeSignatureTrack;
@@ -210,17 +382,19 @@ private:
     void updateMeters(const juce::AudioBuffer<float>& buffer);
     void advancePosition(int numSamples);
 
-    // Clip playback scheduling (per-track)
+    // Clip playback scheduling for the tracks processed at the playhead
     void scheduleClipMidiToTracks(double blockStartBeat, double blockEndBeat, int numSamples);
+    ClipMidiScheduler clipScheduler { timeSignatureTrack };
 
-    // Pending note-offs per track
-    struct TrackPendingNoteOff
-    {
-        Track* track;
-        int midiNote;
-        double endBeat;
-    };
-    std::vector<TrackPendingNoteOff> trackPendingNoteOffs;
+    // Anticipative rendering (streams follow the track order; guarded by trackLock)
+    void updatePrerenderingLocked(double blockStartBeat, double bpm);
+
+    // Streamed audio clips: load ahead from where playback will jump to
+    void cueStreamedClips(AudioFileStream::Cue cue, double beat);
+    void cueLoopStart();
+    TrackPrerenderer prerenderer { tempoTrack, timeSignatureTrack };
+    std::vector<char> keyedTracks;          // Tracks with sidechain keys, played at the playhead
+    std::atomic<bool> anticipativeRendering{true};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
 };
@@ -1,12 +1,55 @@
 #include "AudioFileLoader.h"
 #include <juce_dsp/juce_dsp.h>
+#include <limits>
+#include <vector>
 
+//==============================================================================
+// Converter - sample rate conversion threads shared by every loader
+//==============================================================================
+
+class AudioFileLoader::Converter
+{
+public:
+    /** Jobs started together and waited for together */
+    struct Batch
+    {
+        std::atomic<int> remaining{0};
+        juce::WaitableEvent done;
+    };
+
+    void start(const std::shared_ptr<Batch>& batch, std::function<void()> job)
+    {
+        batch->remaining.fetch_add(1);
+        pool.addJob([batch, job = std::move(job)]
+        {
+            job();
+            if (batch->remaining.fetch_sub(1) == 1)
+                batch->done.signal();
+        });
+    }
+
+    static void wait(Batch& batch)
+    {
+        while (batch.remaining.load() > 0)
+            batch.done.wait(100);
+    }
+
+    int getNumThreads() const { return pool.getNumThreads(); }
+
+private:
+    juce::ThreadPool pool { juce::ThreadPoolOptions{}.withThreadName("Audio Sample Rate Converter")
+                                                     .withNumberOfThreads(juce::jlimit(1, 8, juce::SystemStats::getNumCpus() - 1)) };
+};
+
+//==============================================================================
 AudioFileLoader::AudioFileLoader()
 {
     // Register all basic audio formats
     formatManager.registerBasicFormats();
 }
 
+AudioFileLoader::~AudioFileLoader() = default;
+
 std::unique_ptr<AudioClip> AudioFileLoader::loadFile(const juce::File& file, double targetSampleRate)
 {
     auto clip = std::make_unique<AudioClip>();
@@ -17,41 +60,96 @@ std::unique_ptr<AudioClip> AudioFileLoader::loadFile(const juce::File& file, dou
     return clip;
 }
 
-bool AudioFileLoader::loadIntoClip(const juce::File& file, AudioClip& clip, double targetSampleRate)
+bool AudioFileLoader::loadIntoClip(const juce::File& file, AudioClip& clip, double targetSampleRate,
+                                   const ProgressCallback& progress)
 {
     if (!file.existsAsFile())
         return false;
 
-    // Create a reader for the file
-    std::unique_ptr<juce::AudioFormatReader> reader(
-        formatManager.createReaderFor(file));
-
-    if (reader == nullptr)
+    // Only the header is read here
+    std::unique_ptr<juce::AudioFormatReader> header(formatManager.createReaderFor(file));
+    if (header == nullptr || header->sampleRate <= 0)
         return false;
 
-    // Read the audio data
-    juce::AudioBuffer<float> buffer(static_cast<int>(reader->numChannels),
-                                     static_cast<int>(reader->lengthInSamples));
+    if (shouldStream(*header))
+    {
+        auto stream = AudioFileStream::open(file, formatManager);
+        if (stream == nullptr)
+            return false;
+
+        clip.setStream(std::move(stream));
+        clip.setFilePath(file.getFullPathName());
+        clip.setName(file.getFileNameWithoutExtension());
+        return true;
+    }
 
-    reader->read(&buffer, 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
+    // Compressed and converted files are kept decoded on disk, so the next session skips decoding
+    const bool converting = targetSampleRate > 0 && std::abs(targetSampleRate - header->sampleRate) > 0.1;
+    const bool persist = converting || !isUncompressed(*header);
+    header.reset();
 
-    double sourceSampleRate = reader->sampleRate;
+    auto decoder = [this, &file, targetSampleRate, &progress](juce::AudioBuffer<float>& dest, double& decodedRate)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->sampleRate <= 0)
+            return false;
 
-    // Resample if needed
-    if (targetSampleRate > 0 && std::abs(targetSampleRate - sourceSampleRate) > 0.1)
+        if (targetSampleRate > 0 && std::abs(targetSampleRate - reader->sampleRate) > 0.1)
+        {
+            decodedRate = targetSampleRate;
+            return decodeResampled(*reader, dest, targetSampleRate, progress);
+        }
+
+        decodedRate = reader->sampleRate;
+        return decode(*reader, dest, progress);
+    };
+
+    // Decoded data is shared through the pool - re-importing a file is free
+    double sampleRate = 0.0;
+    const auto storage = clipStorage.load();
+    if (storage != ClipStorage::Float)
     {
-        resample(buffer, sourceSampleRate, targetSampleRate);
-        sourceSampleRate = targetSampleRate;
+        const auto format = storage == ClipStorage::Packed ? CompactAudio::Format::Packed
+                                                           : CompactAudio::Format::Lossless;
+
+        if (auto compact = getSamplePool().getOrLoadCompact(file, targetSampleRate, format, decoder, sampleRate, persist))
+        {
+            clip.setCompactAudio(std::move(compact), sampleRate);
+            clip.setFilePath(file.getFullPathName());
+            clip.setName(file.getFileNameWithoutExtension());
+            return true;
+        }
     }
 
+    auto buffer = getSamplePool().getOrLoad(file, targetSampleRate, decoder, sampleRate, persist);
+    if (buffer == nullptr)
+        return false;
+
     // Set the clip data
-    clip.setAudioBuffer(std::move(buffer), sourceSampleRate);
+    clip.setSharedBuffer(std::move(buffer), sampleRate);
     clip.setFilePath(file.getFullPathName());
     clip.setName(file.getFileNameWithoutExtension());
 
     return true;
 }
 
+bool AudioFileLoader::shouldStream(const juce::AudioFormatReader& reader) const
+{
+    // Buffers are int-indexed, so anything longer has to stream
+    if (reader.lengthInSamples > std::numeric_limits<int>::max())
+        return true;
+
+    const auto decodedBytes = reader.lengthInSamples * static_cast<juce::int64>(reader.numChannels)
+                            * static_cast<juce::int64>(sizeof(float));
+    return decodedBytes > streamingThresholdBytes;
+}
+
+bool AudioFileLoader::isUncompressed(const juce::AudioFormatReader& reader)
+{
+    const auto& format = reader.getFormatName();
+    return format.startsWithIgnoreCase("WAV") || format.startsWithIgnoreCase("AIFF");
+}
+
 juce::String AudioFileLoader::getSupportedFormatsWildcard() const
 {
     // Build wildcard from registered formats
@@ -90,39 +188,139 @@ bool AudioFileLoader::isFormatSupported(const juce::String& extension) const
     return false;
 }
 
-void AudioFileLoader::resample(juce::AudioBuffer<float>& buffer, double sourceSampleRate,
-                                double targetSampleRate)
+//==============================================================================
+// Decoding
+
+bool AudioFileLoader::decode(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& dest,
+                             const ProgressCallback& progress)
+{
+    const int length = static_cast<int>(reader.lengthInSamples);
+    dest.setSize(static_cast<int>(reader.numChannels), length);
+
+    for (int done = 0; done < length;)
+    {
+        const int n = juce::jmin(DECODE_CHUNK_SIZE, length - done);
+        reader.read(&dest, done, n, done, true, true);
+        done += n;
+
+        if (progress != nullptr && !progress(static_cast<double>(done) / length))
+            return false;
+    }
+
+    return true;
+}
+
+bool AudioFileLoader::decodeResampled(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& dest,
+                                      double targetSampleRate, const ProgressCallback& progress)
 {
-    if (sourceSampleRate <= 0 || targetSampleRate <= 0)
-        return;
+    constexpr int chunkSize = DECODE_CHUNK_SIZE;
+    constexpr int margin = Resampler::MAX_TAPS;     // Reach of the widest kernel, either side
 
-    double ratio = targetSampleRate / sourceSampleRate;
-    int newLength = static_cast<int>(buffer.getNumSamples() * ratio);
+    const auto quality = resampleQuality.load();
+    const auto sourceLength = reader.lengthInSamples;
+    const double increment = reader.sampleRate / targetSampleRate;
 
-    juce::AudioBuffer<float> resampled(buffer.getNumChannels(), newLength);
+    const auto outputLength = static_cast<juce::int64>(std::floor(static_cast<double>(sourceLength)
+                                                                  * targetSampleRate / reader.sampleRate));
+    if (outputLength <= 0 || outputLength > std::numeric_limits<int>::max())
+        return false;
 
-    // Use Lagrange interpolation for resampling
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    const int numChannels = static_cast<int>(reader.numChannels);
+    dest.setSize(numChannels, static_cast<int>(outputLength));
+    float* const* output = dest.getArrayOfWritePointers();
+
+    // Chunk k holds source frames [k * chunkSize - margin, (k + 1) * chunkSize + margin),
+    // silent outside the file. The workers convert one while the next decodes into the other.
+    juce::AudioBuffer<float> staging[2];
+    for (auto& buffer : staging)
+        buffer.setSize(numChannels, chunkSize + 2 * margin);
+
+    const auto numChunks = (sourceLength + chunkSize - 1) / chunkSize;
+
+    auto readChunk = [&](juce::int64 chunk)
     {
-        const float* srcData = buffer.getReadPointer(channel);
-        float* dstData = resampled.getWritePointer(channel);
+        auto& buffer = staging[chunk % 2];
+        buffer.clear();
 
-        for (int i = 0; i < newLength; ++i)
+        // The overlap is copied from the previous chunk, so the reader only moves forwards
+        juce::int64 readFrom = 0;
+        int writeAt = margin;
+        if (chunk > 0)
         {
-            double srcPosition = i / ratio;
-            int srcIndex = static_cast<int>(srcPosition);
-            float frac = static_cast<float>(srcPosition - srcIndex);
+            const auto& previous = staging[(chunk - 1) % 2];
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFrom(ch, 0, previous, ch, chunkSize, 2 * margin);
 
-            // Linear interpolation
-            float sample1 = (srcIndex < buffer.getNumSamples()) ? srcData[srcIndex] : 0.0f;
-            float sample2 = (srcIndex + 1 < buffer.getNumSamples()) ? srcData[srcIndex + 1] : sample1;
+            readFrom = chunk * chunkSize + margin;
+            writeAt = 2 * margin;
+        }
 
-            dstData[i] = sample1 + frac * (sample2 - sample1);
+        const auto readTo = juce::jmin(sourceLength, (chunk + 1) * chunkSize + margin);
+        if (readTo > readFrom)
+            reader.read(&buffer, writeAt, static_cast<int>(readTo - readFrom), readFrom, true, true);
+    };
+
+    // First output frame whose source position falls in the chunk
+    auto firstOutput = [&](juce::int64 chunk)
+    {
+        if (chunk >= numChunks)
+            return outputLength;
+
+        const double position = std::ceil(static_cast<double>(chunk * chunkSize) / increment);
+        return juce::jmin(outputLength, static_cast<juce::int64>(position));
+    };
+
+    auto convert = [&](juce::int64 chunk, int channel, juce::int64 start, juce::int64 end)
+    {
+        const auto& buffer = staging[chunk % 2];
+        const auto base = static_cast<double>(chunk * chunkSize - margin);
+        Resampler::process(quality, buffer.getReadPointer(channel), buffer.getNumSamples(),
+                           static_cast<double>(start) * increment - base, increment,
+                           output[channel] + start, static_cast<int>(end - start));
+    };
+
+    // Each chunk's channels are split into spans so mono files use every thread too
+    const int numJobs = numResampleJobs.load() > 0 ? numResampleJobs.load() : converter->getNumThreads();
+    const int spansPerChannel = juce::jmax(1, (numJobs + numChannels - 1) / numChannels);
+    auto batch = std::make_shared<Converter::Batch>();
+
+    readChunk(0);
+
+    for (juce::int64 chunk = 0; chunk < numChunks; ++chunk)
+    {
+        const auto start = firstOutput(chunk);
+        const auto end = firstOutput(chunk + 1);
+
+        if (numJobs <= 1)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                convert(chunk, ch, start, end);
+        }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int span = 0; span < spansPerChannel; ++span)
+                {
+                    const auto spanStart = start + (end - start) * span / spansPerChannel;
+                    const auto spanEnd = start + (end - start) * (span + 1) / spansPerChannel;
+                    if (spanEnd > spanStart)
+                        converter->start(batch, [&convert, chunk, ch, spanStart, spanEnd]
+                                                { convert(chunk, ch, spanStart, spanEnd); });
+                }
+            }
         }
+
+        if (chunk + 1 < numChunks)
+            readChunk(chunk + 1);
+
+        Converter::wait(*batch);
+
+        if (progress != nullptr && !progress(static_cast<double>(chunk + 1) / static_cast<double>(numChunks)))
+            return false;
     }
 
-    // Replace the buffer with resampled version
-    buffer = std::move(resampled);
+    return true;
 }
 
 //==============================================================================
@@ -3,6 +3,10 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 #include "AudioClip.h"
+#include "Resampler.h"
+#include "SamplePool.h"
+#include <atomic>
+#include <functional>
 #include <memory>
 
 /**
@@ -11,14 +15,34 @@
  * Supports: WAV, AIFF, FLAC, MP3, OGG
  * Features:
  * - Automatic format detection
- * - Sample rate conversion (if needed)
+ * - Sample rate conversion (if needed) through the Resampler's polyphase
+ *   sinc, a chunk at a time while the file decodes, with each chunk's
+ *   channels and spans shared out between converter threads
  * - Mono/stereo support
+ * - Decoded data is shared via the global SamplePool; compressed or converted
+ *   files are also kept there on disk, so reopening a project doesn't decode
+ * - Clips can hold their audio compactly (setClipStorage()), as 16/24-bit or
+ *   lossless CompactAudio instead of floats
+ * - Safe to use from several threads at once (see AudioImportService)
+ * - Long files stream from disk instead (AudioFileStream), so they open at
+ *   once and stay out of RAM; they play at their own rate, resampled on the
+ *   fly, whatever targetSampleRate asks for
  */
 class AudioFileLoader
 {
 public:
+    /** Files that would decode to more than this stream by default */
+    static constexpr juce::int64 DEFAULT_STREAMING_THRESHOLD_BYTES = 128 * 1024 * 1024;
+    static constexpr int DECODE_CHUNK_SIZE = 1 << 16;     // Frames between progress reports
+
+    /** How loaded clips hold their audio in RAM */
+    enum class ClipStorage { Float, Packed, Lossless };
+
+    /** Told how far a decode has got (0 to 1); returning false abandons it */
+    using ProgressCallback = std::function<bool(double progress)>;
+
     AudioFileLoader();
-    ~AudioFileLoader() = default;
+    ~AudioFileLoader();
 
     //==========================================================================
     // File Loading
@@ -36,9 +60,26 @@ public:
      * @param file The file to load
      * @param clip The clip to load into
      * @param targetSampleRate The target sample rate for resampling (0 = keep original)
+     * @param progress Called between decoded chunks, from the loading thread
      * @return True if successful
      */
-    bool loadIntoClip(const juce::File& file, AudioClip& clip, double targetSampleRate = 0.0);
+    bool loadIntoClip(const juce::File& file, AudioClip& clip, double targetSampleRate = 0.0,
+                      const ProgressCallback& progress = nullptr);
+
+    /** Decoded size above which files stream from disk (0 streams everything) */
+    void setStreamingThreshold(juce::int64 decodedBytes) { streamingThresholdBytes = decodedBytes; }
+    juce::int64 getStreamingThreshold() const { return streamingThresholdBytes; }
+
+    /** Float by default; compact clips fall back to floats for audio that can't be held compactly */
+    void setClipStorage(ClipStorage storage) { clipStorage.store(storage); }
+    ClipStorage getClipStorage() const { return clipStorage.load(); }
+
+    /** Interpolation used when converting to targetSampleRate (Sinc by default) */
+    void setResampleQuality(Resampler::Quality quality) { resampleQuality.store(quality); }
+    Resampler::Quality getResampleQuality() const { return resampleQuality.load(); }
+
+    /** Jobs each decoded chunk is converted in (0 = one per converter thread, 1 = loading thread only) */
+    void setNumResampleJobs(int numJobs) { numResampleJobs.store(juce::jmax(0, numJobs)); }
 
     //==========================================================================
     // Supported Formats
@@ -59,13 +100,30 @@ public:
     juce::AudioFormatManager& getFormatManager() { return formatManager; }
 
 private:
+    class Converter;
+
     juce::AudioFormatManager formatManager;
+    juce::int64 streamingThresholdBytes = DEFAULT_STREAMING_THRESHOLD_BYTES;
+    std::atomic<Resampler::Quality> resampleQuality{Resampler::Quality::Sinc};
+    std::atomic<int> numResampleJobs{0};
+    std::atomic<ClipStorage> clipStorage{ClipStorage::Float};
+    juce::SharedResourcePointer<Converter> converter;
+
+    bool shouldStream(const juce::AudioFormatReader& reader) const;
+
+    /** Plain PCM reads about as fast as the disk cache would, so isn't worth caching */
+    static bool isUncompressed(const juce::AudioFormatReader& reader);
+
+    /** Decode the whole file into dest at the reader's own rate */
+    static bool decode(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& dest,
+                       const ProgressCallback& progress);
 
     /**
-     * Resample audio buffer to target sample rate
+     * Decode and convert to targetSampleRate in one pass. Only two chunks of
+     * source are held at a time, so the whole file never sits in RAM at both rates.
      */
-    void resample(juce::AudioBuffer<float>& buffer, double sourceSampleRate,
-                  double targetSampleRate);
+    bool decodeResampled(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& dest,
+                         double targetSampleRate, const ProgressCallback& progress);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioFileLoader)
 };
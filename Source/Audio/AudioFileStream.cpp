@@ -0,0 +1,414 @@
+#include "AudioFileStream.h"
+#include <algorithm>
+
+//==============================================================================
+// Background threads, shared by every stream
+//==============================================================================
+
+class AudioFileStream::Threads
+{
+public:
+    Threads()
+    {
+        const int numThreads = juce::jlimit(1, 2, juce::SystemStats::getNumCpus() / 4);
+        for (int i = 0; i < numThreads; ++i)
+        {
+            auto thread = std::make_unique<juce::TimeSliceThread>("Audio Clip Streamer " + juce::String(i + 1));
+            thread->startThread(juce::Thread::Priority::high);
+            threads.push_back(std::move(thread));
+        }
+    }
+
+    ~Threads()
+    {
+        for (auto& thread : threads)
+            thread->stopThread(2000);
+    }
+
+    void add(AudioFileStream* stream)
+    {
+        const juce::ScopedLock sl(lock);
+        auto* thread = threads[nextThread++ % threads.size()].get();
+        assignments.emplace_back(stream, thread);
+        thread->addTimeSliceClient(stream);
+    }
+
+    void remove(AudioFileStream* stream)
+    {
+        const juce::ScopedLock sl(lock);
+        for (auto it = assignments.begin(); it != assignments.end(); ++it)
+        {
+            if (it->first == stream)
+            {
+                // Waits for a time slice in progress
+                it->second->removeTimeSliceClient(stream);
+                assignments.erase(it);
+                return;
+            }
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<juce::TimeSliceThread>> threads;
+    std::vector<std::pair<AudioFileStream*, juce::TimeSliceThread*>> assignments;
+    juce::CriticalSection lock;
+    size_t nextThread = 0;
+};
+
+//==============================================================================
+// AudioFileStream Implementation
+//==============================================================================
+
+std::shared_ptr<AudioFileStream> AudioFileStream::open(const juce::File& file, juce::AudioFormatManager& formatManager)
+{
+    if (!file.existsAsFile())
+        return nullptr;
+
+    // WAV and AIFF can be mapped; other formats return no mapped reader
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped;
+    if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+    {
+        mapped.reset(format->createMemoryMappedReader(file));
+        if (mapped != nullptr && !mapped->mapEntireFile())
+            mapped.reset();
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (mapped == nullptr)
+    {
+        reader.reset(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+            return nullptr;
+    }
+
+    std::shared_ptr<AudioFileStream> stream(new AudioFileStream(file, std::move(reader), std::move(mapped)));
+    if (stream->lengthInSamples <= 0 || stream->numChannels <= 0)
+        return nullptr;
+
+    stream->threads->add(stream.get());
+    return stream;
+}
+
+AudioFileStream::AudioFileStream(const juce::File& sourceFile, std::unique_ptr<juce::AudioFormatReader> decodeReader,
+                                 std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped)
+    : file(sourceFile), mappedReader(std::move(mapped)), reader(std::move(decodeReader))
+{
+    const juce::AudioFormatReader* source = mappedReader != nullptr
+        ? static_cast<const juce::AudioFormatReader*>(mappedReader.get())
+        : reader.get();
+
+    numChannels = static_cast<int>(source->numChannels);
+    lengthInSamples = source->lengthInSamples;
+    sampleRate = source->sampleRate;
+
+    touchedCues.fill(-1);
+    for (auto& cue : cues)
+        cue.store(-1);
+
+    if (mappedReader == nullptr && lengthInSamples > 0)
+    {
+        numBlocks = static_cast<int>((lengthInSamples + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        blocks = std::make_unique<std::atomic<Block*>[]>(static_cast<size_t>(numBlocks));
+        for (int i = 0; i < numBlocks; ++i)
+            blocks[static_cast<size_t>(i)].store(nullptr);
+    }
+}
+
+AudioFileStream::~AudioFileStream()
+{
+    threads->remove(this);
+}
+
+//==============================================================================
+// Audio thread
+
+bool AudioFileStream::read(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames)
+{
+    readPosition.store(startFrame, std::memory_order_relaxed);
+    lastReadTime.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+
+    if (readResident(dest, numDestChannels, startFrame, numFrames))
+        return true;
+
+    underruns.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool AudioFileStream::readResident(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames)
+{
+    numDestChannels = juce::jmin(numDestChannels, numChannels);
+
+    // Silence outside the file
+    const auto from = static_cast<int>(juce::jlimit<juce::int64>(0, numFrames, -startFrame));
+    const auto to = static_cast<int>(juce::jlimit<juce::int64>(from, numFrames, lengthInSamples - startFrame));
+
+    for (int ch = 0; ch < numDestChannels; ++ch)
+    {
+        juce::FloatVectorOperations::clear(dest[ch], from);
+        juce::FloatVectorOperations::clear(dest[ch] + to, numFrames - to);
+    }
+
+    if (to <= from)
+        return true;
+
+    if (mappedReader != nullptr)
+    {
+        std::array<float*, 8> offsetDest {};
+        numDestChannels = juce::jmin(numDestChannels, static_cast<int>(offsetDest.size()));
+        for (int ch = 0; ch < numDestChannels; ++ch)
+            offsetDest[static_cast<size_t>(ch)] = dest[ch] + from;
+
+        return mappedReader->read(offsetDest.data(), numDestChannels, startFrame + from, to - from);
+    }
+
+    // Announce the read before looking at any slot (see retireBlockLocked)
+    activeReaders.fetch_add(1);
+
+    bool complete = true;
+    for (int i = from; i < to;)
+    {
+        const auto frame = startFrame + i;
+        const auto index = static_cast<size_t>(frame / BLOCK_SIZE);
+        const auto offset = static_cast<int>(frame % BLOCK_SIZE);
+        const int n = juce::jmin(to - i, BLOCK_SIZE - offset);
+
+        // Sequentially consistent, paired with retireBlockLocked()
+        if (const auto* block = blocks[index].load())
+        {
+            for (int ch = 0; ch < numDestChannels; ++ch)
+                juce::FloatVectorOperations::copy(dest[ch] + i, block->getReadPointer(ch, offset), n);
+        }
+        else
+        {
+            for (int ch = 0; ch < numDestChannels; ++ch)
+                juce::FloatVectorOperations::clear(dest[ch] + i, n);
+            complete = false;
+        }
+
+        i += n;
+    }
+
+    activeReaders.fetch_sub(1);
+    return complete;
+}
+
+//==============================================================================
+// Any thread
+
+void AudioFileStream::setCue(Cue cue, juce::int64 frame)
+{
+    cues[static_cast<size_t>(cue)].store(frame < 0 ? -1 : juce::jmin(frame, lengthInSamples - 1),
+                                         std::memory_order_relaxed);
+}
+
+bool AudioFileStream::isResident(juce::int64 startFrame, int numFrames) const
+{
+    if (mappedReader != nullptr)
+        return true;
+
+    const auto first = juce::jmax<juce::int64>(0, startFrame);
+    const auto last = juce::jmin(lengthInSamples, startFrame + numFrames) - 1;
+
+    for (auto frame = first; frame <= last; frame = (frame / BLOCK_SIZE + 1) * BLOCK_SIZE)
+        if (blocks[static_cast<size_t>(frame / BLOCK_SIZE)].load(std::memory_order_acquire) == nullptr)
+            return false;
+
+    return true;
+}
+
+//==============================================================================
+// Non-realtime threads
+
+bool AudioFileStream::readBlocking(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames)
+{
+    readPosition.store(startFrame, std::memory_order_relaxed);
+    lastReadTime.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+
+    if (mappedReader == nullptr)
+    {
+        // Decode under the lock, so the background thread cannot retire the
+        // blocks again before they are read
+        const juce::ScopedLock sl(decodeLock);
+
+        const auto first = juce::jmax<juce::int64>(0, startFrame) / BLOCK_SIZE;
+        const auto last = (juce::jmin(lengthInSamples, startFrame + numFrames) - 1) / BLOCK_SIZE;
+
+        for (auto index = first; index <= last; ++index)
+            if (!decodeBlockLocked(static_cast<int>(index)))
+                return false;
+
+        return readResident(dest, numDestChannels, startFrame, numFrames);
+    }
+
+    return readResident(dest, numDestChannels, startFrame, numFrames);
+}
+
+int AudioFileStream::getNumResidentBlocks() const
+{
+    int count = 0;
+    for (int i = 0; i < numBlocks; ++i)
+        if (blocks[static_cast<size_t>(i)].load(std::memory_order_relaxed) != nullptr)
+            ++count;
+    return count;
+}
+
+//==============================================================================
+// Background thread
+
+int AudioFileStream::useTimeSlice()
+{
+    return mappedReader != nullptr ? serviceMapped() : serviceBlocks();
+}
+
+int AudioFileStream::serviceMapped()
+{
+    const auto aheadFrames = static_cast<juce::int64>(READ_AHEAD_SECONDS * sampleRate);
+    const auto position = readPosition.load(std::memory_order_relaxed);
+
+    // Pages ahead of the reader, carrying on from where the last slice stopped
+    if (position >= 0)
+    {
+        auto from = position;
+        if (touchedUpTo > from && touchedUpTo <= position + aheadFrames)
+            from = touchedUpTo;
+
+        touchRange(from, position + aheadFrames);
+        touchedUpTo = position + aheadFrames;
+    }
+
+    for (size_t i = 0; i < cues.size(); ++i)
+    {
+        const auto cue = cues[i].load(std::memory_order_relaxed);
+        if (cue >= 0 && cue != touchedCues[i])
+            touchRange(cue, cue + BLOCK_SIZE);
+        touchedCues[i] = cue;
+    }
+
+    return 10;
+}
+
+void AudioFileStream::touchRange(juce::int64 start, juce::int64 end)
+{
+    start = juce::jmax<juce::int64>(0, start);
+    end = juce::jmin(end, lengthInSamples);
+
+    // One sample per page is enough to fault it in
+    const int bytesPerFrame = juce::jmax(1, static_cast<int>(mappedReader->bitsPerSample / 8) * numChannels);
+    const juce::int64 stride = juce::jmax(1, 4096 / bytesPerFrame);
+
+    for (auto frame = start; frame < end; frame += stride)
+        mappedReader->touchSample(frame);
+}
+
+int AudioFileStream::serviceBlocks()
+{
+    const juce::ScopedLock sl(decodeLock);
+
+    // Block ranges to keep: ahead of the reader (unless it went quiet) and after each cue
+    std::array<std::pair<juce::int64, juce::int64>, static_cast<size_t>(Cue::NumCues) + 1> wanted {};
+    size_t numWanted = 0;
+
+    const auto position = readPosition.load(std::memory_order_relaxed);
+    const auto sinceRead = juce::Time::getMillisecondCounter() - lastReadTime.load(std::memory_order_relaxed);
+    if (position >= 0 && sinceRead < IDLE_MS)
+    {
+        const auto aheadFrames = static_cast<juce::int64>(READ_AHEAD_SECONDS * sampleRate);
+        wanted[numWanted++] = { position / BLOCK_SIZE, (position + aheadFrames) / BLOCK_SIZE };
+    }
+
+    for (const auto& cue : cues)
+    {
+        const auto frame = cue.load(std::memory_order_relaxed);
+        if (frame >= 0)
+            wanted[numWanted++] = { frame / BLOCK_SIZE, (frame + BLOCK_SIZE) / BLOCK_SIZE };
+    }
+
+    auto isWanted = [&](juce::int64 index)
+    {
+        for (size_t i = 0; i < numWanted; ++i)
+            if (index >= wanted[i].first && index <= wanted[i].second)
+                return true;
+        return false;
+    };
+
+    for (size_t i = resident.size(); i-- > 0;)
+        if (!isWanted(resident[i].first))
+            retireBlockLocked(resident[i].first);
+
+    reclaimRetiredLocked();
+
+    // Decode one missing block per slice, nearest the reader first
+    for (size_t i = 0; i < numWanted; ++i)
+    {
+        const auto last = juce::jmin<juce::int64>(wanted[i].second, numBlocks - 1);
+        for (auto index = wanted[i].first; index <= last; ++index)
+        {
+            if (blocks[static_cast<size_t>(index)].load(std::memory_order_relaxed) == nullptr)
+                return decodeBlockLocked(static_cast<int>(index)) ? 0 : 50;
+        }
+    }
+
+    return 10;
+}
+
+bool AudioFileStream::decodeBlockLocked(int index)
+{
+    if (index < 0 || index >= numBlocks)
+        return true;
+
+    if (blocks[static_cast<size_t>(index)].load(std::memory_order_relaxed) != nullptr)
+        return true;
+
+    std::unique_ptr<Block> block;
+    if (!spare.empty())
+    {
+        block = std::move(spare.back());
+        spare.pop_back();
+    }
+    else
+    {
+        block = std::make_unique<Block>(numChannels, BLOCK_SIZE);
+    }
+
+    const auto start = static_cast<juce::int64>(index) * BLOCK_SIZE;
+    const int length = static_cast<int>(juce::jmin<juce::int64>(BLOCK_SIZE, lengthInSamples - start));
+
+    block->clear();
+    if (!reader->read(block.get(), 0, length, start, true, true))
+    {
+        spare.push_back(std::move(block));
+        return false;
+    }
+
+    blocks[static_cast<size_t>(index)].store(block.get(), std::memory_order_release);
+    resident.emplace_back(index, std::move(block));
+    return true;
+}
+
+void AudioFileStream::retireBlockLocked(int index)
+{
+    for (auto it = resident.begin(); it != resident.end(); ++it)
+    {
+        if (it->first == index)
+        {
+            // A reader that has not announced itself yet will see the empty slot
+            blocks[static_cast<size_t>(index)].store(nullptr);
+            retired.push_back(std::move(it->second));
+            resident.erase(it);
+            return;
+        }
+    }
+}
+
+void AudioFileStream::reclaimRetiredLocked()
+{
+    if (retired.empty() || activeReaders.load() != 0)
+        return;
+
+    // A few spare blocks cover the next seek; the rest go back to the system
+    for (auto& block : retired)
+        if (spare.size() < 4)
+            spare.push_back(std::move(block));
+
+    retired.clear();
+}
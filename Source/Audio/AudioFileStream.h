@@ -0,0 +1,144 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * AudioFileStream - Streaming backing store for long audio clips
+ *
+ * Lets an AudioClip play a file from disk instead of holding it decoded in
+ * RAM (see AudioFileLoader for when that happens). Two modes:
+ * - WAV/AIFF are memory-mapped. read() converts straight out of the mapping,
+ *   and the background thread touches the pages ahead of the read position
+ *   so the audio thread does not take the page faults.
+ * - Everything else is decoded in BLOCK_SIZE blocks into a table of atomic
+ *   block pointers. The background thread keeps the blocks around the read
+ *   position and the cue points resident and retires the rest; a retired
+ *   block is only reused once no read() is in progress.
+ *
+ * Cue points (clip start, last seek, loop start) are positions playback may
+ * jump to; the frames after them are kept ready so a seek does not start
+ * with a gap.
+ *
+ * read() is lock-free and never allocates. Frames that are not resident yet
+ * read as silence and count as an underrun; offline rendering uses
+ * readBlocking(), which decodes what is missing on the calling thread.
+ */
+class AudioFileStream : public juce::TimeSliceClient
+{
+public:
+    static constexpr int BLOCK_SIZE = 1 << 15;          // Frames per decoded block
+    static constexpr double READ_AHEAD_SECONDS = 2.0;
+    static constexpr juce::uint32 IDLE_MS = 1000;       // Read window is dropped after this long unread
+
+    enum class Cue
+    {
+        ClipStart = 0,
+        Seek,
+        Loop,
+        NumCues
+    };
+
+    /** Open file for streaming, memory-mapped if its format allows; nullptr on failure */
+    static std::shared_ptr<AudioFileStream> open(const juce::File& file, juce::AudioFormatManager& formatManager);
+
+    ~AudioFileStream() override;
+
+    const juce::File& getFile() const { return file; }
+    int getNumChannels() const { return numChannels; }
+    juce::int64 getLengthInSamples() const { return lengthInSamples; }
+    double getSampleRate() const { return sampleRate; }
+    bool isMemoryMapped() const { return mappedReader != nullptr; }
+
+    //==========================================================================
+    // Audio thread
+
+    /**
+     * Read numFrames from startFrame into the first numDestChannels of dest
+     * (overwrites). Frames outside the file read as silence.
+     * @return False if part of the range was not resident (it reads as silence)
+     */
+    bool read(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames);
+
+    //==========================================================================
+    // Any thread
+
+    /** Keep the frames from frame on ready (-1 clears the cue) */
+    void setCue(Cue cue, juce::int64 frame);
+
+    /** True if read() would return the range without an underrun */
+    bool isResident(juce::int64 startFrame, int numFrames) const;
+
+    int getUnderrunCount() const { return underruns.load(); }
+    void resetUnderrunCount() { underruns.store(0); }
+
+    //==========================================================================
+    // Non-realtime threads
+
+    /** read(), decoding whatever is missing first */
+    bool readBlocking(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames);
+
+    /** Decoded blocks held in RAM (none when memory-mapped) */
+    int getNumResidentBlocks() const;
+
+    //==========================================================================
+    // TimeSliceClient
+    int useTimeSlice() override;
+
+private:
+    class Threads;
+    using Block = juce::AudioBuffer<float>;
+
+    AudioFileStream(const juce::File& file, std::unique_ptr<juce::AudioFormatReader> reader,
+                    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader);
+
+    const juce::File file;
+    int numChannels = 0;
+    juce::int64 lengthInSamples = 0;
+    double sampleRate = 44100.0;
+
+    // Memory-mapped mode
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader;
+    juce::int64 touchedUpTo = -1;                               // Background thread only
+    std::array<juce::int64, static_cast<size_t>(Cue::NumCues)> touchedCues;
+
+    // Block mode: slots are published by the decoder, read by read()
+    std::unique_ptr<std::atomic<Block*>[]> blocks;
+    int numBlocks = 0;
+    std::atomic<int> activeReaders{0};
+
+    // Decoder state (under decodeLock)
+    juce::CriticalSection decodeLock;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    std::vector<std::pair<int, std::unique_ptr<Block>>> resident;  // Published blocks by index
+    std::vector<std::unique_ptr<Block>> retired;                // Unpublished, may still be read
+    std::vector<std::unique_ptr<Block>> spare;                  // Ready for reuse
+
+    // Published by readers
+    std::atomic<juce::int64> readPosition{-1};
+    std::atomic<juce::uint32> lastReadTime{0};
+    std::array<std::atomic<juce::int64>, static_cast<size_t>(Cue::NumCues)> cues;
+
+    std::atomic<int> underruns{0};
+
+    juce::SharedResourcePointer<Threads> threads;
+
+    bool readResident(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames);
+
+    // With decodeLock held
+    bool decodeBlockLocked(int index);
+    void retireBlockLocked(int index);
+    void reclaimRetiredLocked();
+
+    int serviceMapped();
+    int serviceBlocks();
+    void touchRange(juce::int64 start, juce::int64 end);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioFileStream)
+};
@@ -0,0 +1,212 @@
+#include "AudioImportService.h"
+#include "../Utils/PerformanceProfiler.h"
+
+AudioImportService::AudioImportService(AudioFileLoader& fileLoader, int numThreads)
+    : loader(fileLoader),
+      pool(juce::ThreadPoolOptions{}
+               .withThreadName("Audio Import")
+               .withNumberOfThreads(numThreads > 0 ? numThreads
+                                                   : juce::jlimit(1, 8, juce::SystemStats::getNumCpus() - 1)))
+{
+}
+
+AudioImportService::~AudioImportService()
+{
+    cancelAll();
+    pool.removeAllJobs(true, 10000);
+    cancelPendingUpdate();
+}
+
+//==============================================================================
+// Importing
+
+std::unique_ptr<AudioClip> AudioImportService::import(const juce::File& file, double targetSampleRate)
+{
+    // Only the header is read here, to size the placeholder
+    juce::int64 length = 0;
+    double sampleRate = 0.0;
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(loader.getFormatManager().createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0)
+            return nullptr;
+
+        length = reader->lengthInSamples;
+        sampleRate = reader->sampleRate;
+    }
+
+    auto placeholder = std::make_unique<AudioClip>();
+    placeholder->setName(file.getFileNameWithoutExtension());
+    placeholder->setFilePath(file.getFullPathName());
+    placeholder->setPlaceholder(length, sampleRate);
+
+    auto job = std::make_shared<Job>();
+    job->clipId = placeholder->getId();
+    job->file = file;
+    job->targetSampleRate = targetSampleRate;
+
+    {
+        const juce::ScopedLock sl(lock);
+        if (numPending++ == 0)
+        {
+            batchStartMs = juce::Time::getMillisecondCounterHiRes();
+            batchFrames = 0;
+        }
+        jobs[job->clipId] = job;
+    }
+
+    pool.addJob([this, job] { run(*job); });
+    return placeholder;
+}
+
+void AudioImportService::cancel(const juce::String& clipId)
+{
+    const juce::ScopedLock sl(lock);
+    auto it = jobs.find(clipId);
+    if (it != jobs.end())
+        it->second->cancelled.store(true);
+}
+
+void AudioImportService::cancelAll()
+{
+    const juce::ScopedLock sl(lock);
+    for (auto& [id, job] : jobs)
+        job->cancelled.store(true);
+}
+
+//==============================================================================
+// Progress
+
+float AudioImportService::getProgress(const juce::String& clipId) const
+{
+    const juce::ScopedLock sl(lock);
+    auto it = jobs.find(clipId);
+    return it != jobs.end() ? it->second->progress.load() : -1.0f;
+}
+
+int AudioImportService::getNumPending() const
+{
+    const juce::ScopedLock sl(lock);
+    return numPending;
+}
+
+bool AudioImportService::waitForAll(int timeoutMs)
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+
+    while (getNumPending() > 0)
+    {
+        const auto now = juce::Time::getMillisecondCounter();
+        if (now >= deadline)
+            return false;
+
+        jobDone.wait(static_cast<int>(deadline - now));
+    }
+
+    return true;
+}
+
+//==============================================================================
+// Workers
+
+void AudioImportService::run(Job& job)
+{
+    if (!job.cancelled.load())
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        auto clip = std::make_unique<AudioClip>();
+        const bool loaded = loader.loadIntoClip(job.file, *clip, job.targetSampleRate,
+            [&job](double progress)
+            {
+                job.progress.store(static_cast<float>(progress));
+                return !job.cancelled.load();
+            });
+
+        if (loaded && !job.cancelled.load())
+        {
+            const double elapsedUs = juce::Time::highResolutionTicksToSeconds(
+                juce::Time::getHighResolutionTicks() - startTicks) * 1000000.0;
+            PerformanceProfiler::getInstance().recordTime("AudioImport::DecodeFile", elapsedUs);
+
+            job.clip = std::move(clip);
+        }
+    }
+
+    job.progress.store(1.0f);
+    job.finished.store(true);
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        // Streamed clips were not decoded, so they don't count towards throughput
+        if (job.clip != nullptr && !job.clip->isStreamed())
+            batchFrames += job.clip->getDurationInSamples();
+
+        if (--numPending == 0 && batchFrames > 0)
+        {
+            const double seconds = (juce::Time::getMillisecondCounterHiRes() - batchStartMs) / 1000.0;
+            PerformanceProfiler::getInstance().recordThroughput("AudioImport::DecodedFrames",
+                                                                static_cast<double>(batchFrames), seconds);
+        }
+    }
+
+    jobDone.signal();
+    triggerAsyncUpdate();
+}
+
+//==============================================================================
+// Delivery
+
+void AudioImportService::handleAsyncUpdate()
+{
+    deliverFinished();
+}
+
+void AudioImportService::deliverFinished()
+{
+    std::vector<std::shared_ptr<Job>> finished;
+    {
+        const juce::ScopedLock sl(lock);
+        for (auto it = jobs.begin(); it != jobs.end();)
+        {
+            if (it->second->finished.load())
+            {
+                finished.push_back(it->second);
+                it = jobs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    for (auto& job : finished)
+    {
+        Result result;
+        result.clipId = job->clipId;
+        result.file = job->file;
+        result.cancelled = job->cancelled.load();
+        if (!result.cancelled)
+            result.clip = std::move(job->clip);
+
+        if (onImportFinished)
+            onImportFinished(result);
+    }
+}
+
+//==============================================================================
+// Global instance
+
+static std::unique_ptr<AudioImportService> globalAudioImportService;
+static juce::SpinLock globalImportServiceLock;
+
+AudioImportService& getAudioImportService()
+{
+    juce::SpinLock::ScopedLockType lock(globalImportServiceLock);
+
+    if (globalAudioImportService == nullptr)
+        globalAudioImportService = std::make_unique<AudioImportService>(getAudioFileLoader());
+
+    return *globalAudioImportService;
+}
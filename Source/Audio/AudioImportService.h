@@ -0,0 +1,114 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include "AudioClip.h"
+#include "AudioFileLoader.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+
+/**
+ * AudioImportService - Decodes imported audio files on a worker pool
+ *
+ * import() returns at once with a placeholder clip sized from the file's
+ * header (AudioClip::setPlaceholder()) for the caller to put on a track. The
+ * file is decoded by one of the workers through AudioFileLoader, so decoded
+ * data is pooled and long files stream, and many files decode at the same
+ * time. Imports are known by their placeholder's clip id.
+ *
+ * Finished imports are handed to onImportFinished on the message thread;
+ * the caller moves the audio into the placeholder (Track::fillAudioClip()).
+ * Cancelled and failed imports are delivered too, without a clip.
+ *
+ * Per-file decode time and the decode throughput of each batch (frames per
+ * second of wall time, from the first queued file to the last one done) are
+ * recorded in the PerformanceProfiler.
+ */
+class AudioImportService : private juce::AsyncUpdater
+{
+public:
+    struct Result
+    {
+        juce::String clipId;                // The placeholder's id
+        juce::File file;
+        std::unique_ptr<AudioClip> clip;    // nullptr if the import failed or was cancelled
+        bool cancelled = false;
+    };
+
+    /** numThreads 0 uses one per core, leaving one for the UI and audio */
+    explicit AudioImportService(AudioFileLoader& loader, int numThreads = 0);
+    ~AudioImportService() override;
+
+    /** Called on the message thread as imports finish */
+    std::function<void(Result&)> onImportFinished;
+
+    //==========================================================================
+    // Importing (message thread)
+
+    /**
+     * Queue file for decoding
+     * @return The placeholder clip, or nullptr if the file cannot be read
+     */
+    std::unique_ptr<AudioClip> import(const juce::File& file, double targetSampleRate = 0.0);
+
+    /** Stop an import; a running decode stops at its next chunk */
+    void cancel(const juce::String& clipId);
+    void cancelAll();
+
+    //==========================================================================
+    // Progress (any thread)
+
+    /** 0 to 1 while importing, -1 once delivered or if unknown */
+    float getProgress(const juce::String& clipId) const;
+    bool isImporting(const juce::String& clipId) const { return getProgress(clipId) >= 0.0f; }
+
+    /** Imports queued or decoding */
+    int getNumPending() const;
+
+    int getNumThreads() const { return pool.getNumThreads(); }
+
+    //==========================================================================
+
+    /** Wait until nothing is queued or decoding; false on timeout */
+    bool waitForAll(int timeoutMs);
+
+    /** Hand finished imports to onImportFinished (runs by itself on the message thread) */
+    void deliverFinished();
+
+private:
+    struct Job
+    {
+        juce::String clipId;
+        juce::File file;
+        double targetSampleRate = 0.0;
+
+        std::atomic<float> progress{0.0f};
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};
+        std::unique_ptr<AudioClip> clip;    // Written by the worker before finished is set
+    };
+
+    AudioFileLoader& loader;
+    juce::ThreadPool pool;
+
+    mutable juce::CriticalSection lock;
+    std::map<juce::String, std::shared_ptr<Job>> jobs;     // Until delivered
+    int numPending = 0;
+    juce::WaitableEvent jobDone;
+
+    // Current batch, for the throughput figure
+    double batchStartMs = 0.0;
+    juce::int64 batchFrames = 0;
+
+    void run(Job& job);
+    void handleAsyncUpdate() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioImportService)
+};
+
+/**
+ * Global AudioImportService for shared use
+ */
+AudioImportService& getAudioImportService();
@@ -0,0 +1,274 @@
+#include "AudioInputRecorder.h"
+
+//==============================================================================
+// One take: its file's threaded writer, and the peaks of what reached it
+//==============================================================================
+
+class AudioInputRecorder::Writer : private juce::AudioFormatWriter::ThreadedWriter::IncomingDataReceiver
+{
+public:
+    Writer(const Input& input, const juce::File& file, juce::AudioFormatWriter* formatWriter,
+           juce::TimeSliceThread& thread, int fifoSize)
+        : input(input), file(file), peaks(input.numChannels), silence(input.numChannels, SILENCE_FRAMES),
+          threaded(std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(formatWriter, thread, fifoSize))
+    {
+        silence.clear();
+        threaded->setDataReceiver(this);
+    }
+
+    ~Writer() override
+    {
+        close();
+    }
+
+    // Audio thread: false if the FIFO had no room
+    bool write(const float* const* channels, int numSamples, double positionInBeats)
+    {
+        if (numFrames == 0 && droppedFrames == 0)
+            firstBeat = positionInBeats;
+
+        // Blocks that were dropped go in as silence first, so the file keeps
+        // the take's timeline and what follows lands where it was played
+        while (droppedFrames > 0)
+        {
+            const int n = static_cast<int>(juce::jmin<juce::int64>(droppedFrames, SILENCE_FRAMES));
+            if (!threaded->write(silence.getArrayOfReadPointers(), n))
+                break;
+
+            droppedFrames -= n;
+            numFrames += n;
+        }
+
+        if (droppedFrames == 0 && threaded->write(channels, numSamples))
+        {
+            numFrames += numSamples;
+            return true;
+        }
+
+        droppedFrames += numSamples;
+        return false;
+    }
+
+    // Message thread, once the audio thread has let go: returns after the FIFO is on disk
+    void close()
+    {
+        threaded.reset();
+    }
+
+    Take makeTake() const
+    {
+        return { input.trackId, file, firstBeat, numFrames, peaks.getSnapshot() };
+    }
+
+    const Input input;
+    const juce::File file;
+
+private:
+    static constexpr int SILENCE_FRAMES = 4096;
+
+    WaveformPeaks::Builder peaks;           // Writer thread until closed
+    juce::AudioBuffer<float> silence;
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> threaded;
+    double firstBeat = 0.0;                 // Audio thread until closed
+    juce::int64 numFrames = 0;              // In the FIFO or on disk
+    juce::int64 droppedFrames = 0;          // Still to be written as silence
+
+    void reset(int, double, juce::int64) override {}
+
+    void addBlock(juce::int64, const juce::AudioBuffer<float>& data, int startOffset, int numSamples) override
+    {
+        const float* channels[MAX_TAKE_CHANNELS] = {};
+        for (int ch = 0; ch < input.numChannels; ++ch)
+            channels[ch] = data.getReadPointer(ch, startOffset);
+
+        peaks.append(channels, numSamples);
+    }
+};
+
+//==============================================================================
+AudioInputRecorder::AudioInputRecorder()
+    : directory(juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                    .getChildFile("ProgFlow")
+                    .getChildFile("Recordings"))
+{
+    captured.setSize(1, 1);
+    captured.clear();
+    writerThread.startThread(juce::Thread::Priority::high);
+}
+
+AudioInputRecorder::~AudioInputRecorder()
+{
+    endTakes();
+    writerThread.stopThread(2000);
+}
+
+void AudioInputRecorder::setRecordingDirectory(const juce::File& newDirectory)
+{
+    directory = newDirectory;
+}
+
+juce::File AudioInputRecorder::getRecordingDirectory() const
+{
+    return directory;
+}
+
+//==============================================================================
+bool AudioInputRecorder::beginTakes(const std::vector<Input>& inputs, double sampleRate)
+{
+    // Takes still recording would be closed below and never handed over
+    jassert(!isRecording());
+
+    if (!directory.createDirectory())
+        return false;
+
+    const int fifoSize = juce::roundToInt(FIFO_SECONDS * sampleRate);
+    const auto timestamp = juce::Time::getCurrentTime().formatted("%Y-%m-%d %H%M%S");
+
+    std::vector<std::unique_ptr<Writer>> opened;
+    bool allOpened = true;
+    juce::WavAudioFormat wavFormat;
+
+    for (const auto& input : inputs)
+    {
+        const int numChannels = juce::jlimit(1, MAX_TAKE_CHANNELS, input.numChannels);
+        const auto file = directory.getNonexistentChildFile(
+            juce::File::createLegalFileName(input.name + " " + timestamp), ".wav", false);
+
+        std::unique_ptr<juce::OutputStream> stream = file.createOutputStream();
+        juce::AudioFormatWriter* formatWriter = nullptr;
+
+        if (stream != nullptr)
+            formatWriter = wavFormat.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                                     BITS_PER_SAMPLE, {}, 0);
+
+        if (formatWriter == nullptr)
+        {
+            stream.reset();
+            file.deleteFile();
+            allOpened = false;
+            continue;
+        }
+
+        stream.release();   // The writer owns it now
+
+        auto take = input;
+        take.numChannels = numChannels;
+        opened.push_back(std::make_unique<Writer>(take, file, formatWriter, writerThread, fifoSize));
+    }
+
+    droppedBlocks.store(0);
+
+    {
+        const juce::SpinLock::ScopedLockType sl(writerLock);
+        std::swap(writers, opened);
+    }
+
+    return allOpened;
+}
+
+std::vector<AudioInputRecorder::Take> AudioInputRecorder::endTakes()
+{
+    std::vector<std::unique_ptr<Writer>> finished;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(writerLock);
+        std::swap(writers, finished);
+    }
+
+    std::vector<Take> takes;
+    for (auto& writer : finished)
+    {
+        writer->close();
+        auto take = writer->makeTake();
+
+        if (take.numFrames > 0)
+            takes.push_back(std::move(take));
+        else
+            writer->file.deleteFile();
+    }
+
+    return takes;
+}
+
+bool AudioInputRecorder::isRecording() const
+{
+    const juce::SpinLock::ScopedLockType sl(writerLock);
+    return !writers.empty();
+}
+
+//==============================================================================
+const float* AudioInputRecorder::getInputChannel(int channel) const
+{
+    if (channel < 0 || channel >= numInputChannels)
+        return nullptr;
+
+    return captured.getReadPointer(channel);
+}
+
+void AudioInputRecorder::write(int numSamples, double positionInBeats)
+{
+    numSamples = juce::jmin(numSamples, numCapturedSamples);
+    if (numSamples <= 0)
+        return;
+
+    const juce::SpinLock::ScopedLockType sl(writerLock);
+
+    for (auto& writer : writers)
+    {
+        const float* channels[MAX_TAKE_CHANNELS] = {};
+        for (int ch = 0; ch < writer->input.numChannels; ++ch)
+        {
+            const int input = writer->input.firstChannel + ch;
+            channels[ch] = captured.getReadPointer(input >= 0 && input < numInputChannels ? input : numInputChannels);
+        }
+
+        if (!writer->write(channels, numSamples, positionInBeats))
+            droppedBlocks.fetch_add(1);
+    }
+}
+
+//==============================================================================
+void AudioInputRecorder::audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannelsIn,
+                                                          float* const* outputChannelData, int numOutputChannels,
+                                                          int numSamples, const juce::AudioIODeviceCallbackContext&)
+{
+    // The device manager adds later callbacks' output to ours
+    for (int ch = 0; ch < numOutputChannels; ++ch)
+    {
+        if (outputChannelData[ch] != nullptr)
+            juce::FloatVectorOperations::clear(outputChannelData[ch], numSamples);
+    }
+
+    // A device that delivers more than it said it would loses the excess
+    jassert(numSamples <= captured.getNumSamples());
+    numCapturedSamples = juce::jmin(numSamples, captured.getNumSamples());
+
+    for (int ch = 0; ch < numInputChannels; ++ch)
+    {
+        if (ch < numInputChannelsIn && inputChannelData[ch] != nullptr)
+            captured.copyFrom(ch, 0, inputChannelData[ch], numCapturedSamples);
+        else
+            captured.clear(ch, 0, numCapturedSamples);
+    }
+}
+
+void AudioInputRecorder::audioDeviceAboutToStart(juce::AudioIODevice* device)
+{
+    // Room for the largest block the device can be set to, so a change of
+    // buffer size doesn't need a reallocation on the audio thread
+    int maxBlockSize = device->getCurrentBufferSizeSamples();
+    for (const int size : device->getAvailableBufferSizes())
+        maxBlockSize = juce::jmax(maxBlockSize, size);
+
+    numInputChannels = device->getActiveInputChannels().countNumberOfSetBits();
+    numCapturedSamples = 0;
+    captured.setSize(numInputChannels + 1, juce::jmax(1, maxBlockSize));
+    captured.clear();
+
+    deviceLatencySamples.store(device->getInputLatencyInSamples() + device->getOutputLatencyInSamples());
+}
+
+void AudioInputRecorder::audioDeviceStopped()
+{
+    numCapturedSamples = 0;
+}
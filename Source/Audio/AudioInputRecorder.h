@@ -0,0 +1,129 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include "WaveformPeaks.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * AudioInputRecorder - Records device inputs to WAV files for armed tracks
+ *
+ * Added to the AudioDeviceManager ahead of the AudioSourcePlayer that plays
+ * the AudioEngine, so in each device callback it sees the inputs first. It
+ * copies them aside (it outputs silence); the engine's block, later in the
+ * same callback, then write()s them into the takes being recorded and mixes
+ * monitored inputs from getInputChannel().
+ *
+ * A take is one track's inputs going to one file. beginTakes() opens the files
+ * and their writers before the transport starts, and endTakes() closes them
+ * after it stops, so the audio thread only ever copies:
+ * - Each take has an AudioFormatWriter::ThreadedWriter, whose FIFO (an
+ *   AbstractFifo over a buffer of FIFO_SECONDS) is the lock-free
+ *   single-producer, single-consumer queue between the audio thread and disk
+ * - One background thread drains every take's FIFO, and builds its
+ *   WaveformPeaks as it goes, so the finished clip draws without a rescan
+ * - A block that doesn't fit in a FIFO is counted (getDroppedBlockCount()),
+ *   never waited for, and goes to disk as silence once there's room, so the
+ *   rest of the take stays in time
+ *
+ * Inputs the device doesn't have record silence.
+ */
+class AudioInputRecorder : public juce::AudioIODeviceCallback
+{
+public:
+    static constexpr double FIFO_SECONDS = 4.0;     // Input a take holds while the disk catches up
+    static constexpr int MAX_TAKE_CHANNELS = 2;
+    static constexpr int BITS_PER_SAMPLE = 24;
+
+    /** A track to record and the device inputs it takes */
+    struct Input
+    {
+        juce::Uuid trackId;
+        juce::String name;              // Starts the file name
+        int firstChannel = 0;
+        int numChannels = 1;            // Up to MAX_TAKE_CHANNELS
+    };
+
+    /** A finished take */
+    struct Take
+    {
+        juce::Uuid trackId;
+        juce::File file;
+        double firstBeat = 0.0;         // Transport position its first frame was captured at
+        juce::int64 numFrames = 0;
+        std::shared_ptr<const WaveformPeaks> peaks;
+    };
+
+    AudioInputRecorder();
+    ~AudioInputRecorder() override;
+
+    /** Folder takes are written to (created when a take begins) */
+    void setRecordingDirectory(const juce::File& directory);
+    juce::File getRecordingDirectory() const;
+
+    //==========================================================================
+    // Message thread
+
+    /**
+     * Open a file and writer for each input; they record from the next write()
+     * @return False if any file couldn't be opened (the others still record)
+     */
+    bool beginTakes(const std::vector<Input>& inputs, double sampleRate);
+
+    /**
+     * Stop recording, wait for the takes to reach disk and hand them over.
+     * Takes that never got a frame are deleted instead.
+     */
+    std::vector<Take> endTakes();
+
+    bool isRecording() const;
+
+    /** The device's input plus output latency, as reported when it started */
+    int getDeviceLatencySamples() const { return deviceLatencySamples.load(); }
+
+    /** Blocks that didn't fit in a take's FIFO since beginTakes() */
+    int getDroppedBlockCount() const { return droppedBlocks.load(); }
+
+    //==========================================================================
+    // Audio thread, from the engine's block in the same device callback
+
+    int getNumInputChannels() const { return numInputChannels; }
+    int getNumCapturedSamples() const { return numCapturedSamples; }
+
+    /** An input captured in this callback, or nullptr if the device doesn't have it */
+    const float* getInputChannel(int channel) const;
+
+    /** Add numSamples of this callback's input to every take (positionInBeats: the block's start) */
+    void write(int numSamples, double positionInBeats);
+
+    //==========================================================================
+    // AudioIODeviceCallback
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannelsIn,
+                                          float* const* outputChannelData, int numOutputChannels,
+                                          int numSamples, const juce::AudioIODeviceCallbackContext& context) override;
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+private:
+    class Writer;
+
+    juce::TimeSliceThread writerThread { "Audio Recorder" };
+    juce::File directory;
+
+    // Inputs of the current callback; the last channel is kept silent
+    juce::AudioBuffer<float> captured;
+    int numInputChannels = 0;
+    int numCapturedSamples = 0;
+    std::atomic<int> deviceLatencySamples{0};
+
+    // Swapped by the message thread while the audio thread is out of write()
+    juce::SpinLock writerLock;
+    std::vector<std::unique_ptr<Writer>> writers;
+    std::atomic<int> droppedBlocks{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioInputRecorder)
+};
@@ -21,6 +21,7 @@ void AutomationLane::removePoint(int index)
     if (index >= 0 && index < static_cast<int>(points.size()))
     {
         points.erase(points.begin() + index);
+        ++editVersion;
     }
 }
 
@@ -39,6 +40,7 @@ void AutomationLane::setPointCurve(int index, CurveType curve)
     if (index >= 0 && index < static_cast<int>(points.size()))
     {
         points[index].curve = curve;
+        ++editVersion;
     }
 }
 
@@ -94,6 +96,7 @@ void AutomationLane::sortPoints()
         [](const AutomationPoint& a, const AutomationPoint& b) {
             return a.timeInBeats < b.timeInBeats;
         });
+    ++editVersion;
 }
 
 juce::var AutomationLane::toVar() const
@@ -52,6 +52,9 @@ public:
     // Find point at time (within tolerance)
     int getPointIndexAt(double timeInBeats, double tolerance = 0.1) const;
 
+    // Changes whenever a point is added, removed or changed
+    juce::uint32 getEditVersion() const { return editVersion; }
+
     // Serialization
     juce::var toVar() const;
     static std::unique_ptr<AutomationLane> fromVar(const juce::var& v);
@@ -59,6 +62,7 @@ public:
 private:
     juce::String parameterId;
     std::vector<AutomationPoint> points;
+    juce::uint32 editVersion = 0;
 
     void sortPoints();
 
@@ -0,0 +1,104 @@
+#include "ClipMidiScheduler.h"
+#include <algorithm>
+
+namespace
+{
+    // Beat position to a sample offset within the block
+    int beatToSampleOffset(double beat, double blockStartBeat, double blockEndBeat, int numSamples)
+    {
+        const double beatsInBlock = blockEndBeat - blockStartBeat;
+        const double samplesPerBeat = (beatsInBlock > 0.0) ? numSamples / beatsInBlock : 0.0;
+        const int sampleOffset = static_cast<int>((beat - blockStartBeat) * samplesPerBeat);
+        return juce::jlimit(0, numSamples - 1, sampleOffset);
+    }
+}
+
+ClipMidiScheduler::ClipMidiScheduler(const TimeSignatureTrack& timeSignatureTrack)
+    : timeSignatures(timeSignatureTrack)
+{
+}
+
+void ClipMidiScheduler::processNoteOffs(double blockStartBeat, double blockEndBeat, int numSamples)
+{
+    auto it = pendingNoteOffs.begin();
+    while (it != pendingNoteOffs.end())
+    {
+        if (it->endBeat <= blockEndBeat && it->track)
+        {
+            it->track->synthNoteOff(it->midiNote, beatToSampleOffset(it->endBeat, blockStartBeat, blockEndBeat, numSamples));
+            it = pendingNoteOffs.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void ClipMidiScheduler::scheduleTrack(Track& track, double blockStartBeat, double blockEndBeat, int numSamples)
+{
+    // Convert beats to bars for the clip query (using TimeSignatureTrack for variable meters)
+    const double startBar = timeSignatures.beatsToBar(blockStartBeat);
+    const double endBar = timeSignatures.beatsToBar(blockEndBeat);
+
+    track.getClipsInRange(startBar, endBar, activeClips);
+
+    for (auto* clip : activeClips)
+    {
+        // Get notes that start within this block (clip-relative beats)
+        const double clipStartBeat = clip->getStartBeat();
+        clip->getNotesInRange(blockStartBeat - clipStartBeat, blockEndBeat - clipStartBeat, notes);
+
+        for (const auto* note : notes)
+        {
+            const double noteStartBeat = clipStartBeat + note->startBeat;
+            const double noteEndBeat = noteStartBeat + note->durationBeats;
+
+            const int noteOnOffset = beatToSampleOffset(noteStartBeat, blockStartBeat, blockEndBeat, numSamples);
+            track.synthNoteOn(note->midiNote, note->velocity, noteOnOffset);
+
+            if (noteEndBeat <= blockEndBeat)
+            {
+                // Note ends within this block, at least a sample after it starts
+                int noteOffOffset = beatToSampleOffset(noteEndBeat, blockStartBeat, blockEndBeat, numSamples);
+                if (noteOffOffset <= noteOnOffset)
+                    noteOffOffset = juce::jmin(noteOnOffset + 1, numSamples - 1);
+
+                track.synthNoteOff(note->midiNote, noteOffOffset);
+            }
+            else
+            {
+                pendingNoteOffs.push_back({ &track, note->midiNote, noteEndBeat });
+            }
+        }
+    }
+}
+
+void ClipMidiScheduler::chaseNotes(Track& track, double beat)
+{
+    const double bar = timeSignatures.beatsToBar(beat);
+    track.getClipsInRange(bar, bar, activeClips);
+
+    for (auto* clip : activeClips)
+    {
+        const double clipStartBeat = clip->getStartBeat();
+        clip->getActiveNotesAt(beat - clipStartBeat, notes);
+
+        for (const auto* note : notes)
+        {
+            // Notes starting right on the beat are scheduleTrack()'s
+            if (clipStartBeat + note->startBeat >= beat)
+                continue;
+
+            track.synthNoteOn(note->midiNote, note->velocity, 0);
+            pendingNoteOffs.push_back({ &track, note->midiNote, clipStartBeat + note->startBeat + note->durationBeats });
+        }
+    }
+}
+
+void ClipMidiScheduler::forgetTrack(const Track* track)
+{
+    pendingNoteOffs.erase(std::remove_if(pendingNoteOffs.begin(), pendingNoteOffs.end(),
+                                         [track](const PendingNoteOff& n) { return n.track == track; }),
+                          pendingNoteOffs.end());
+}
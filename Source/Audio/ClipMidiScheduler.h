@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Track.h"
+#include "TimeSignatureTrack.h"
+#include <vector>
+
+/**
+ * ClipMidiScheduler - Plays the notes of tracks' MIDI clips, block by block
+ *
+ * Note-ons are queued on the track's synth at their sample offset into the
+ * block. Notes that outlast their block wait in a pending list until the
+ * block their note-off falls in.
+ *
+ * AudioEngine keeps one for the tracks it processes at the playhead;
+ * TrackPrerenderer keeps one per track it renders ahead. Not thread-safe:
+ * each instance belongs to whoever is rendering its tracks.
+ */
+class ClipMidiScheduler
+{
+public:
+    explicit ClipMidiScheduler(const TimeSignatureTrack& timeSignatures);
+
+    /** Send the pending note-offs that fall before blockEndBeat */
+    void processNoteOffs(double blockStartBeat, double blockEndBeat, int numSamples);
+
+    /** Queue the notes starting in [blockStartBeat, blockEndBeat) */
+    void scheduleTrack(Track& track, double blockStartBeat, double blockEndBeat, int numSamples);
+
+    /** Restart the notes sounding across beat (started before it) at the start of the next block */
+    void chaseNotes(Track& track, double beat);
+
+    /** Drop pending note-offs without sending them */
+    void forgetTrack(const Track* track);
+    void clear() { pendingNoteOffs.clear(); }
+
+private:
+    struct PendingNoteOff
+    {
+        Track* track;
+        int midiNote;
+        double endBeat;
+    };
+
+    const TimeSignatureTrack& timeSignatures;
+    std::vector<PendingNoteOff> pendingNoteOffs;
+
+    // Reused between blocks
+    std::vector<MidiClip*> activeClips;
+    std::vector<const Note*> notes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipMidiScheduler)
+};
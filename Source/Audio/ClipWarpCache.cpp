@@ -0,0 +1,581 @@
+#include "ClipWarpCache.h"
+#include "TimeStretchProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//==============================================================================
+// TempoCurve
+//==============================================================================
+
+ClipWarpCache::TempoCurve ClipWarpCache::TempoCurve::constant(double bpm)
+{
+    TempoCurve curve;
+    curve.points[0] = { 0.0, bpm, false };
+    curve.numPoints = 1;
+    return curve;
+}
+
+bool ClipWarpCache::TempoCurve::fromTempoTrack(const TempoTrack& tempoTrack, double startBeat, double lengthInBeats,
+                                               TempoCurve& curve)
+{
+    const auto& events = tempoTrack.getEvents();
+    const double endBeat = startBeat + lengthInBeats;
+
+    // Whether the event in force at beat ramps towards the next one
+    auto rampsAt = [&events](double beat)
+    {
+        bool ramp = false;
+        for (size_t i = 0; i < events.size() && events[i].beatPosition <= beat; ++i)
+            ramp = events[i].rampType == TempoRampType::Linear && i + 1 < events.size();
+        return ramp;
+    };
+
+    curve.numPoints = 0;
+    curve.points[0] = { 0.0, tempoTrack.getTempoAtBeat(startBeat), rampsAt(startBeat) };
+    curve.numPoints = 1;
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const auto& event = events[i];
+        if (event.beatPosition <= startBeat || event.beatPosition >= endBeat)
+            continue;
+
+        if (curve.numPoints == MAX_POINTS)
+            return false;
+
+        const bool ramp = event.rampType == TempoRampType::Linear && i + 1 < events.size();
+        curve.points[static_cast<size_t>(curve.numPoints++)] = { event.beatPosition - startBeat, event.bpm, ramp };
+    }
+
+    // A ramp still running at the end stops at the tempo it reaches there
+    if (curve.points[static_cast<size_t>(curve.numPoints - 1)].ramp)
+    {
+        if (curve.numPoints == MAX_POINTS)
+            return false;
+
+        curve.points[static_cast<size_t>(curve.numPoints++)] = { lengthInBeats, tempoTrack.getTempoAtBeat(endBeat), false };
+    }
+
+    return true;
+}
+
+double ClipWarpCache::TempoCurve::getTempoAt(double beat) const
+{
+    int index = 0;
+    while (index + 1 < numPoints && points[static_cast<size_t>(index + 1)].beat <= beat)
+        ++index;
+
+    const auto& point = points[static_cast<size_t>(index)];
+    if (!point.ramp || index + 1 >= numPoints)
+        return point.bpm;
+
+    const auto& next = points[static_cast<size_t>(index + 1)];
+    const double t = juce::jlimit(0.0, 1.0, (beat - point.beat) / (next.beat - point.beat));
+    return point.bpm + t * (next.bpm - point.bpm);
+}
+
+bool ClipWarpCache::TempoCurve::operator==(const TempoCurve& other) const
+{
+    return numPoints == other.numPoints
+        && std::equal(points.begin(), points.begin() + numPoints, other.points.begin());
+}
+
+//==============================================================================
+// Source and Render
+//==============================================================================
+
+ClipWarpCache::Source ClipWarpCache::Source::fromClip(const AudioClip& clip, const TempoCurve& curve)
+{
+    Source source;
+    source.stream = clip.getStream();
+    source.compact = clip.getCompactAudio();
+    if (source.stream == nullptr && source.compact == nullptr)
+        source.buffer = clip.getSharedBuffer();
+
+    source.sampleRate = clip.getSampleRate();
+    source.trimStart = clip.getTrimStartSample();
+    source.trimEnd = juce::jmin(clip.getTrimEndSample(), clip.getDurationInSamples());
+    source.sourceBpm = clip.getSourceBpm();
+    source.pitchSemitones = clip.getPitchSemitones();
+    source.curve = curve;
+    return source;
+}
+
+double ClipWarpCache::Source::getLengthInBeats() const
+{
+    return static_cast<double>(trimEnd - trimStart) / (sampleRate * 60.0 / sourceBpm);
+}
+
+double ClipWarpCache::Render::getFrameAt(double beat) const
+{
+    const int numSteps = static_cast<int>(framesAtSteps.size()) - 1;
+    if (numSteps < 1)
+        return 0.0;
+
+    // Past either end the nearest step's rate carries on
+    const double step = beat * STEPS_PER_BEAT;
+    const int index = juce::jlimit(0, numSteps - 1, static_cast<int>(std::floor(step)));
+    const double from = framesAtSteps[static_cast<size_t>(index)];
+    const double to = framesAtSteps[static_cast<size_t>(index + 1)];
+    return from + (step - index) * (to - from);
+}
+
+juce::int64 ClipWarpCache::Render::getBytes() const
+{
+    return static_cast<juce::int64>(audio.getNumChannels()) * audio.getNumSamples() * static_cast<juce::int64>(sizeof(float))
+         + static_cast<juce::int64>(framesAtSteps.size() * sizeof(double));
+}
+
+bool ClipWarpCache::Render::matches(const Source& source) const
+{
+    return trimStart == source.trimStart && trimEnd == source.trimEnd
+        && sourceBpm == source.sourceBpm && pitchSemitones == source.pitchSemitones
+        && curve == source.curve;
+}
+
+//==============================================================================
+// ClipWarpCache
+//==============================================================================
+
+ClipWarpCache::ClipWarpCache()
+{
+    thread.addTimeSliceClient(this);
+    thread.startThread(juce::Thread::Priority::background);
+}
+
+ClipWarpCache::~ClipWarpCache()
+{
+    thread.removeTimeSliceClient(this);
+    thread.stopThread(5000);
+}
+
+ClipWarpCache::SourceKey ClipWarpCache::getKey(const Source& source)
+{
+    if (source.stream != nullptr)
+        return source.stream;
+    if (source.compact != nullptr)
+        return source.compact;
+    return source.buffer;
+}
+
+//==============================================================================
+// Audio thread
+
+ClipWarpCache::RenderPtr ClipWarpCache::find(const Source& source) const
+{
+    const juce::SpinLock::ScopedTryLockType tryLock(lock);
+    if (!tryLock.isLocked())
+        return nullptr;
+
+    auto it = renders.find(getKey(source));
+    if (it == renders.end())
+        return nullptr;
+
+    for (const auto& candidate : it->second)
+    {
+        if (candidate->matches(source))
+        {
+            candidate->lastUsed.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+            return candidate;
+        }
+    }
+
+    return nullptr;
+}
+
+void ClipWarpCache::request(const Source& source)
+{
+    if (!source.isValid())
+        return;
+
+    // Renders that would not fit the budget are never made; such clips stay on
+    // the real-time stretcher
+    double slowest = source.curve.points[0].bpm;
+    for (int i = 1; i < source.curve.numPoints; ++i)
+        slowest = juce::jmin(slowest, source.curve.points[static_cast<size_t>(i)].bpm);
+
+    const double estimatedFrames = source.getLengthInBeats() * 60.0 / juce::jmax(1.0, slowest) * source.sampleRate;
+    if (estimatedFrames * 2.0 * sizeof(float) > static_cast<double>(budget.load()) / 2.0)
+        return;
+
+    const juce::SpinLock::ScopedTryLockType tryLock(lock);
+    if (!tryLock.isLocked())
+        return;
+
+    const auto key = getKey(source);
+    auto sameAs = [&key, &source](const Source& other)
+    {
+        const auto otherKey = getKey(other);
+        return !key.owner_before(otherKey) && !otherKey.owner_before(key)
+            && other.trimStart == source.trimStart && other.trimEnd == source.trimEnd
+            && other.sourceBpm == source.sourceBpm && other.pitchSemitones == source.pitchSemitones
+            && other.curve == source.curve;
+    };
+
+    if (inFlight.isValid() && sameAs(inFlight))
+        return;
+
+    Source* emptySlot = nullptr;
+    for (auto& slot : pending)
+    {
+        if (!slot.isValid())
+        {
+            if (emptySlot == nullptr)
+                emptySlot = &slot;
+        }
+        else if (sameAs(slot))
+        {
+            return;
+        }
+    }
+
+    auto it = renders.find(key);
+    if (it != renders.end())
+        for (const auto& existing : it->second)
+            if (existing->matches(source))
+                return;
+
+    // Empty slots hold no pointers, so assigning releases nothing here
+    if (emptySlot != nullptr)
+        *emptySlot = source;
+}
+
+//==============================================================================
+// Background and offline
+
+int ClipWarpCache::useTimeSlice()
+{
+    std::vector<RenderPtr> toFree;
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+
+        // Renders of audio nobody holds any more
+        for (auto it = renders.begin(); it != renders.end();)
+        {
+            if (it->first.expired())
+            {
+                retired.insert(retired.end(), it->second.begin(), it->second.end());
+                it = renders.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Only freed here once the audio thread has let go of them
+        for (auto it = retired.begin(); it != retired.end();)
+        {
+            if (it->use_count() == 1)
+            {
+                toFree.push_back(std::move(*it));
+                it = retired.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (auto& slot : pending)
+        {
+            if (slot.isValid())
+            {
+                inFlight = std::move(slot);
+                slot = {};
+                break;
+            }
+        }
+    }
+
+    toFree.clear();
+
+    if (!inFlight.isValid())
+    {
+        renderDone.signal();
+        return 20;
+    }
+
+    // A source may have been rendered offline since it was queued
+    auto rendered = find(inFlight);
+    if (rendered == nullptr)
+        rendered = render(inFlight);
+
+    Source finished;    // Let go of the source outside the lock
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        if (rendered != nullptr)
+            addLocked(inFlight, rendered);
+        finished = std::move(inFlight);
+        inFlight = {};
+    }
+
+    enforceBudget();
+    renderDone.signal();
+    return 0;
+}
+
+ClipWarpCache::RenderPtr ClipWarpCache::findOrRender(const Source& source)
+{
+    if (!source.isValid())
+        return nullptr;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        auto it = renders.find(getKey(source));
+        if (it != renders.end())
+        {
+            for (const auto& candidate : it->second)
+            {
+                if (candidate->matches(source))
+                {
+                    candidate->lastUsed.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+                    return candidate;
+                }
+            }
+        }
+    }
+
+    auto rendered = render(source);
+    if (rendered != nullptr)
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        addLocked(source, rendered);
+    }
+
+    enforceBudget();
+    return rendered;
+}
+
+bool ClipWarpCache::waitForRenders(int timeoutMs)
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+
+    for (;;)
+    {
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            const bool queued = std::any_of(pending.begin(), pending.end(),
+                                            [](const Source& slot) { return slot.isValid(); });
+            if (!queued && !inFlight.isValid())
+                return true;
+        }
+
+        const auto now = juce::Time::getMillisecondCounter();
+        if (now >= deadline)
+            return false;
+
+        renderDone.wait(static_cast<int>(juce::jmin<juce::uint32>(deadline - now, 50)));
+    }
+}
+
+int ClipWarpCache::getNumRenders() const
+{
+    const juce::SpinLock::ScopedLockType sl(lock);
+    int count = 0;
+    for (const auto& [key, list] : renders)
+        count += static_cast<int>(list.size());
+    return count;
+}
+
+juce::int64 ClipWarpCache::getBytes() const
+{
+    const juce::SpinLock::ScopedLockType sl(lock);
+    juce::int64 bytes = 0;
+    for (const auto& [key, list] : renders)
+        for (const auto& entry : list)
+            bytes += entry->getBytes();
+    return bytes;
+}
+
+void ClipWarpCache::setBudget(juce::int64 bytes)
+{
+    budget.store(juce::jmax<juce::int64>(0, bytes));
+    enforceBudget();
+}
+
+void ClipWarpCache::clear()
+{
+    const juce::SpinLock::ScopedLockType sl(lock);
+    for (auto& [key, list] : renders)
+        retired.insert(retired.end(), list.begin(), list.end());
+    renders.clear();
+}
+
+void ClipWarpCache::addLocked(const Source& source, RenderPtr newRender)
+{
+    auto& list = renders[std::weak_ptr<const void>(getKey(source))];
+
+    // Made twice (offline while queued); the first one stays
+    for (const auto& existing : list)
+        if (existing->matches(source))
+            return;
+
+    // Room for it, dropping the render of this source played longest ago
+    if (static_cast<int>(list.size()) >= MAX_RENDERS_PER_SOURCE)
+    {
+        auto oldest = std::min_element(list.begin(), list.end(), [](const RenderPtr& a, const RenderPtr& b)
+        {
+            return a->lastUsed.load(std::memory_order_relaxed) < b->lastUsed.load(std::memory_order_relaxed);
+        });
+        retired.push_back(std::move(*oldest));
+        list.erase(oldest);
+    }
+
+    newRender->lastUsed.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+    list.push_back(std::move(newRender));
+}
+
+void ClipWarpCache::enforceBudget()
+{
+    const juce::SpinLock::ScopedLockType sl(lock);
+
+    juce::int64 bytes = 0;
+    for (const auto& [key, list] : renders)
+        for (const auto& entry : list)
+            bytes += entry->getBytes();
+
+    while (bytes > budget.load())
+    {
+        std::vector<RenderPtr>* oldestList = nullptr;
+        std::vector<RenderPtr>::iterator oldest;
+
+        for (auto& [key, list] : renders)
+        {
+            for (auto it = list.begin(); it != list.end(); ++it)
+            {
+                if (oldestList == nullptr
+                    || (*it)->lastUsed.load(std::memory_order_relaxed) < (*oldest)->lastUsed.load(std::memory_order_relaxed))
+                {
+                    oldestList = &list;
+                    oldest = it;
+                }
+            }
+        }
+
+        if (oldestList == nullptr)
+            break;
+
+        bytes -= (*oldest)->getBytes();
+        retired.push_back(std::move(*oldest));
+        oldestList->erase(oldest);
+    }
+}
+
+//==============================================================================
+// Rendering
+
+ClipWarpCache::RenderPtr ClipWarpCache::render(const Source& source)
+{
+    const juce::int64 length = source.trimEnd - source.trimStart;
+    if (!source.isValid() || length > std::numeric_limits<int>::max())
+        return nullptr;
+
+    const int numChannels = juce::jmin(2, source.stream != nullptr  ? source.stream->getNumChannels()
+                                        : source.compact != nullptr ? source.compact->getNumChannels()
+                                                                    : source.buffer->getNumChannels());
+    if (numChannels <= 0)
+        return nullptr;
+
+    // The trimmed audio
+    juce::AudioBuffer<float> input(numChannels, static_cast<int>(length));
+    if (source.stream != nullptr)
+    {
+        // A block at a time, so the whole file is never resident at once
+        for (int done = 0; done < static_cast<int>(length);)
+        {
+            const int piece = juce::jmin(AudioFileStream::BLOCK_SIZE, static_cast<int>(length) - done);
+            float* channels[2] = { input.getWritePointer(0, done), input.getWritePointer(numChannels - 1, done) };
+            source.stream->readBlocking(channels, numChannels, source.trimStart + done, piece);
+            done += piece;
+        }
+    }
+    else if (source.compact != nullptr)
+    {
+        source.compact->read(input.getArrayOfWritePointers(), numChannels, source.trimStart, static_cast<int>(length));
+    }
+    else
+    {
+        input.clear();
+        const auto available = juce::jmin(length, source.buffer->getNumSamples() - source.trimStart);
+        for (int ch = 0; ch < numChannels && available > 0; ++ch)
+            input.copyFrom(ch, 0, *source.buffer, ch, static_cast<int>(source.trimStart), static_cast<int>(available));
+    }
+
+    // Where each step of the clip lands in the render, following the tempo
+    auto result = std::make_shared<Render>();
+    result->sampleRate = source.sampleRate;
+    result->trimStart = source.trimStart;
+    result->trimEnd = source.trimEnd;
+    result->sourceBpm = source.sourceBpm;
+    result->pitchSemitones = source.pitchSemitones;
+    result->curve = source.curve;
+
+    const double lengthInBeats = source.getLengthInBeats();
+    const int numSteps = juce::jmax(1, static_cast<int>(std::ceil(lengthInBeats * STEPS_PER_BEAT)));
+    auto& frames = result->framesAtSteps;
+    frames.resize(static_cast<size_t>(numSteps + 1));
+    frames[0] = 0.0;
+
+    for (int k = 0; k < numSteps; ++k)
+    {
+        const double from = static_cast<double>(k) / STEPS_PER_BEAT;
+        const double to = juce::jmin(lengthInBeats, static_cast<double>(k + 1) / STEPS_PER_BEAT);
+        const double bpm = source.curve.getTempoAt(0.5 * (from + to));
+        frames[static_cast<size_t>(k + 1)] = frames[static_cast<size_t>(k)] + (to - from) * 60.0 / bpm * source.sampleRate;
+    }
+
+    const auto outputLength = static_cast<int>(std::llround(frames.back()));
+    if (outputLength <= 0)
+        return nullptr;
+
+    TimeStretchProcessor stretcher;
+    stretcher.prepare(source.sampleRate, numChannels, 4096, TimeStretchProcessor::Mode::Offline);
+    stretcher.setTimeRatio(static_cast<double>(outputLength) / static_cast<double>(length));
+    stretcher.setPitchSemitones(source.pitchSemitones);
+
+    // Through a ramp the ratio changes as it goes
+    if (!source.curve.isConstant())
+    {
+        const double framesPerBeat = source.sampleRate * 60.0 / source.sourceBpm;
+        std::map<size_t, size_t> keyFrames;
+        size_t lastInput = 0, lastOutput = 0;
+
+        for (int k = KEY_FRAME_STEPS; k < numSteps; k += KEY_FRAME_STEPS)
+        {
+            const auto in = static_cast<size_t>(std::llround(static_cast<double>(k) / STEPS_PER_BEAT * framesPerBeat));
+            const auto out = static_cast<size_t>(std::llround(frames[static_cast<size_t>(k)]));
+            if (in > lastInput && out > lastOutput && in < static_cast<size_t>(length))
+            {
+                keyFrames[in] = out;
+                lastInput = in;
+                lastOutput = out;
+            }
+        }
+
+        stretcher.setKeyFrameMap(std::move(keyFrames));
+    }
+
+    stretcher.processOffline(input, result->audio);
+
+    // Exactly as long as the map says, so beats land where they should
+    result->audio.setSize(numChannels, outputLength, true, true, false);
+    return result;
+}
+
+//==============================================================================
+// Global instance
+
+static std::unique_ptr<ClipWarpCache> globalClipWarpCache;
+static juce::SpinLock globalClipWarpCacheLock;
+
+ClipWarpCache& getClipWarpCache()
+{
+    juce::SpinLock::ScopedLockType lock(globalClipWarpCacheLock);
+
+    if (globalClipWarpCache == nullptr)
+        globalClipWarpCache = std::make_unique<ClipWarpCache>();
+
+    return *globalClipWarpCache;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "AudioClip.h"
+#include "AudioFileStream.h"
+#include "SamplePool.h"
+#include "TempoTrack.h"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * ClipWarpCache - Time-stretched renders of warped audio clips
+ *
+ * A warped clip (AudioClip::isWarpEnabled()) keeps its length in beats, so at
+ * any tempo other than its source tempo it has to be stretched. Rather than
+ * stretch every clip on the audio thread each block, the clip's trimmed audio
+ * is rendered once through RubberBand offline, following the tempo over the
+ * clip (a constant ratio, or a ramp pinned with key frames), and the render is
+ * played back like an ordinary buffer.
+ *
+ * Renders are kept per source (buffer, compact audio or stream) and matched on everything
+ * that went into them: trim, pitch, source tempo and the tempo curve relative
+ * to the clip's start. Clips at the same tempo share renders wherever they sit
+ * on the timeline; moving a clip into a ramp or changing the tempo asks for a
+ * new one.
+ *
+ * The audio thread looks renders up and queues requests without allocating or
+ * blocking (a busy lock counts as a miss, a full queue drops the request until
+ * the next block asks again); it plays through AudioClipRenderer's real-time
+ * stretcher until the render arrives. Renders are made on a background thread
+ * and evicted least recently used beyond a memory budget, never while in use.
+ * Offline rendering uses findOrRender(), which renders on the calling thread.
+ */
+class ClipWarpCache : public juce::TimeSliceClient
+{
+public:
+    static constexpr int STEPS_PER_BEAT = 16;               // Resolution of the beat-to-frame map
+    static constexpr int KEY_FRAME_STEPS = 4;               // Steps between RubberBand key frames in a ramp
+    static constexpr int MAX_RENDERS_PER_SOURCE = 8;
+    static constexpr juce::int64 DEFAULT_BUDGET_BYTES = juce::int64(1) << 30;
+
+    /**
+     * Tempo over a clip, relative to its start. Built on the audio thread, so
+     * it holds a fixed number of points.
+     */
+    struct TempoCurve
+    {
+        static constexpr int MAX_POINTS = 16;
+
+        struct Point
+        {
+            double beat = 0.0;          // From the clip's start
+            double bpm = 120.0;
+            bool ramp = false;          // Linear to the next point
+
+            bool operator==(const Point& other) const
+            {
+                return beat == other.beat && bpm == other.bpm && ramp == other.ramp;
+            }
+        };
+
+        std::array<Point, MAX_POINTS> points {};
+        int numPoints = 0;
+
+        static TempoCurve constant(double bpm);
+
+        /** tempoTrack over [startBeat, startBeat + lengthInBeats); false if it changes too often to hold */
+        static bool fromTempoTrack(const TempoTrack& tempoTrack, double startBeat, double lengthInBeats,
+                                   TempoCurve& curve);
+
+        double getTempoAt(double beat) const;
+        bool isConstant() const { return numPoints == 1; }
+
+        bool operator==(const TempoCurve& other) const;
+    };
+
+    /** What a render is made from; copied from a clip on the audio thread */
+    struct Source
+    {
+        SamplePool::BufferPtr buffer;               // One of these
+        SamplePool::CompactPtr compact;
+        std::shared_ptr<AudioFileStream> stream;
+
+        double sampleRate = 44100.0;
+        juce::int64 trimStart = 0;
+        juce::int64 trimEnd = 0;
+        double sourceBpm = 120.0;
+        double pitchSemitones = 0.0;
+        TempoCurve curve;
+
+        static Source fromClip(const AudioClip& clip, const TempoCurve& curve);
+
+        bool isValid() const
+        {
+            return (buffer != nullptr || compact != nullptr || stream != nullptr) && trimEnd > trimStart;
+        }
+        double getLengthInBeats() const;
+    };
+
+    /** One stretched clip */
+    class Render
+    {
+    public:
+        const juce::AudioBuffer<float>& getAudio() const { return audio; }
+        double getSampleRate() const { return sampleRate; }
+
+        /** Frame of the render playing beat (from the clip's start) */
+        double getFrameAt(double beat) const;
+
+        juce::int64 getBytes() const;
+
+    private:
+        friend class ClipWarpCache;
+
+        juce::AudioBuffer<float> audio;             // At the source's sample rate
+        double sampleRate = 44100.0;
+        std::vector<double> framesAtSteps;          // Render frame at each 1/STEPS_PER_BEAT beat
+
+        // What it was made from
+        juce::int64 trimStart = 0;
+        juce::int64 trimEnd = 0;
+        double sourceBpm = 120.0;
+        double pitchSemitones = 0.0;
+        TempoCurve curve;
+
+        mutable std::atomic<juce::uint32> lastUsed { 0 };
+
+        bool matches(const Source& source) const;
+    };
+
+    using RenderPtr = std::shared_ptr<const Render>;
+
+    ClipWarpCache();
+    ~ClipWarpCache() override;
+
+    //==========================================================================
+    // Audio thread
+
+    /** The render for source, or nullptr if there is none yet (or the cache is busy) */
+    RenderPtr find(const Source& source) const;
+
+    /** Queue source for rendering in the background, unless it already is */
+    void request(const Source& source);
+
+    //==========================================================================
+    // Non-realtime threads
+
+    /** find(), rendering on the calling thread if needed (offline rendering) */
+    RenderPtr findOrRender(const Source& source);
+
+    /** Wait until no requests are queued or rendering; false on timeout */
+    bool waitForRenders(int timeoutMs);
+
+    int getNumRenders() const;
+    juce::int64 getBytes() const;
+
+    void setBudget(juce::int64 bytes);
+    juce::int64 getBudget() const { return budget.load(); }
+
+    void clear();
+
+    //==========================================================================
+    // TimeSliceClient
+    int useTimeSlice() override;
+
+private:
+    using SourceKey = std::shared_ptr<const void>;
+
+    static SourceKey getKey(const Source& source);
+    static RenderPtr render(const Source& source);
+
+    // Under lock, which the audio thread only ever tries
+    mutable juce::SpinLock lock;
+    std::map<std::weak_ptr<const void>, std::vector<RenderPtr>, std::owner_less<>> renders;
+    std::array<Source, 64> pending;     // Empty slots have no audio
+    Source inFlight;                    // Being rendered by the background thread
+    juce::WaitableEvent renderDone;
+
+    std::vector<RenderPtr> retired;     // Evicted, freed once nothing plays them (background only)
+    std::atomic<juce::int64> budget { DEFAULT_BUDGET_BYTES };
+
+    juce::TimeSliceThread thread { "Audio Clip Warper" };
+
+    void addLocked(const Source& source, RenderPtr newRender);
+    void enforceBudget();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipWarpCache)
+};
+
+/**
+ * Global ClipWarpCache for shared use. Created on first call, which starts its
+ * thread, so call it from the message thread: AudioEngine creates it up front
+ * and AudioClipRenderer keeps a pointer from prepare() for the audio thread.
+ */
+ClipWarpCache& getClipWarpCache();
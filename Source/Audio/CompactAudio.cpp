@@ -0,0 +1,339 @@
+#include "CompactAudio.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Zero bytes after the last block, so the decoder can always load 64 bits at once
+    constexpr size_t TAIL_PADDING = 8;
+    constexpr int MAX_ORDER = 2;
+
+    std::uint32_t zigzag(int value)
+    {
+        return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+    }
+
+    int getBitWidth(std::uint32_t value)
+    {
+        int bits = 0;
+        while (bits < 32 && (value >> bits) != 0)
+            ++bits;
+        return bits;
+    }
+}
+
+//==============================================================================
+// Encoding
+
+std::shared_ptr<const CompactAudio> CompactAudio::fromBuffer(const juce::AudioBuffer<float>& buffer, Format format)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int length = buffer.getNumSamples();
+    if (numChannels <= 0 || length <= 0)
+        return nullptr;
+
+    float peak = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* samples = buffer.getReadPointer(ch);
+        for (int i = 0; i < length; ++i)
+        {
+            if (!std::isfinite(samples[i]))
+                return nullptr;
+            peak = juce::jmax(peak, std::abs(samples[i]));
+        }
+    }
+
+    // Full scale is the next power of two up, so scaling stays exact
+    float scale = 1.0f;
+    while (scale < peak)
+        scale *= 2.0f;
+
+    bool is16Bit = true;
+    const float to16Bit = 32768.0f / scale;
+    for (int ch = 0; ch < numChannels && is16Bit; ++ch)
+    {
+        const float* samples = buffer.getReadPointer(ch);
+        for (int i = 0; i < length; ++i)
+        {
+            const float value = samples[i] * to16Bit;
+            if (value != std::nearbyint(value) || value < -32768.0f || value > 32767.0f)
+            {
+                is16Bit = false;
+                break;
+            }
+        }
+    }
+
+    auto result = std::make_shared<CompactAudio>();
+    result->format = format;
+    result->bitDepth = is16Bit ? 16 : 24;
+    result->numChannels = numChannels;
+    result->lengthInFrames = length;
+
+    const int fullScale = 1 << (result->bitDepth - 1);
+    result->multiplier = scale / static_cast<float>(fullScale);
+
+    const float toInt = static_cast<float>(fullScale) / scale;
+    auto quantise = [&](int channel, int start, int count, int* dest)
+    {
+        const float* samples = buffer.getReadPointer(channel, start);
+        for (int i = 0; i < count; ++i)
+            dest[i] = juce::jlimit(-fullScale, fullScale - 1, static_cast<int>(std::lrint(samples[i] * toInt)));
+    };
+
+    int block[BLOCK_FRAMES];
+
+    if (format == Format::Packed)
+    {
+        const int bytesPerSample = result->getBytesPerSample();
+        auto& data = result->data;
+        data.resize(static_cast<size_t>(numChannels) * static_cast<size_t>(length) * static_cast<size_t>(bytesPerSample));
+
+        auto* out = data.data();
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int start = 0; start < length; start += BLOCK_FRAMES)
+            {
+                const int count = juce::jmin(BLOCK_FRAMES, length - start);
+                quantise(ch, start, count, block);
+
+                for (int i = 0; i < count; ++i)
+                {
+                    const auto value = static_cast<std::uint32_t>(block[i]);
+                    for (int byte = 0; byte < bytesPerSample; ++byte)
+                        *out++ = static_cast<std::uint8_t>(value >> (8 * byte));
+                }
+            }
+        }
+    }
+    else
+    {
+        const int numBlocks = (length + BLOCK_FRAMES - 1) / BLOCK_FRAMES;
+        result->blockOffsets.reserve(static_cast<size_t>(numBlocks * numChannels + 1));
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const int start = b * BLOCK_FRAMES;
+            const int count = juce::jmin(BLOCK_FRAMES, length - start);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                quantise(ch, start, count, block);
+                result->blockOffsets.push_back(result->data.size());
+                encodeBlock(block, count, result->data);
+            }
+        }
+
+        result->blockOffsets.push_back(result->data.size());
+        result->data.insert(result->data.end(), TAIL_PADDING, 0);
+        result->data.shrink_to_fit();
+    }
+
+    return result;
+}
+
+void CompactAudio::encodeBlock(const int* samples, int count, std::vector<std::uint8_t>& out)
+{
+    // Fixed predictors (the sample itself, its difference from the last, or
+    // from the line through the last two); whichever leaves the narrowest residuals
+    std::uint32_t widest[MAX_ORDER + 1] = {};
+    for (int i = 0; i < count; ++i)
+    {
+        widest[0] |= zigzag(samples[i]);
+        if (i >= 1)
+            widest[1] |= zigzag(samples[i] - samples[i - 1]);
+        if (i >= 2)
+            widest[2] |= zigzag(samples[i] - 2 * samples[i - 1] + samples[i - 2]);
+    }
+
+    int order = 0;
+    for (int candidate = 1; candidate <= juce::jmin(MAX_ORDER, count); ++candidate)
+        if (getBitWidth(widest[candidate]) < getBitWidth(widest[order]))
+            order = candidate;
+
+    const int bits = getBitWidth(widest[order]);
+    out.push_back(static_cast<std::uint8_t>(order));
+    out.push_back(static_cast<std::uint8_t>(bits));
+
+    // Warm-up samples as they are
+    for (int i = 0; i < order; ++i)
+        for (int byte = 0; byte < 4; ++byte)
+            out.push_back(static_cast<std::uint8_t>(static_cast<std::uint32_t>(samples[i]) >> (8 * byte)));
+
+    if (bits == 0)
+        return;
+
+    // Residuals, least significant bit first
+    std::uint64_t pending = 0;
+    int pendingBits = 0;
+    for (int i = order; i < count; ++i)
+    {
+        int residual = samples[i];
+        if (order == 1)
+            residual -= samples[i - 1];
+        else if (order == 2)
+            residual -= 2 * samples[i - 1] - samples[i - 2];
+
+        pending |= static_cast<std::uint64_t>(zigzag(residual)) << pendingBits;
+        pendingBits += bits;
+
+        while (pendingBits >= 8)
+        {
+            out.push_back(static_cast<std::uint8_t>(pending));
+            pending >>= 8;
+            pendingBits -= 8;
+        }
+    }
+
+    if (pendingBits > 0)
+        out.push_back(static_cast<std::uint8_t>(pending));
+}
+
+//==============================================================================
+// Decoding
+
+void CompactAudio::read(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames) const
+{
+    for (int ch = 0; ch < numDestChannels; ++ch)
+        readChannel(ch, dest[ch], startFrame, numFrames);
+}
+
+void CompactAudio::readChannel(int channel, float* dest, juce::int64 startFrame, int numFrames) const
+{
+    if (numFrames <= 0)
+        return;
+
+    if (channel < 0 || channel >= numChannels)
+    {
+        juce::FloatVectorOperations::clear(dest, numFrames);
+        return;
+    }
+
+    int done = 0;
+    if (startFrame < 0)
+    {
+        done = static_cast<int>(juce::jmin<juce::int64>(numFrames, -startFrame));
+        juce::FloatVectorOperations::clear(dest, done);
+    }
+
+    const auto end = juce::jmin(startFrame + numFrames, lengthInFrames);
+    int samples[BLOCK_FRAMES];
+
+    while (startFrame + done < end)
+    {
+        const auto frame = startFrame + done;
+        int n = 0;
+
+        if (format == Format::Packed)
+        {
+            n = static_cast<int>(juce::jmin<juce::int64>(BLOCK_FRAMES, end - frame));
+            decodePacked(channel, frame, n, samples);
+            juce::FloatVectorOperations::convertFixedToFloat(dest + done, samples, multiplier, n);
+        }
+        else
+        {
+            // Blocks only decode whole, from their start
+            const auto block = frame / BLOCK_FRAMES;
+            const int offset = static_cast<int>(frame - block * BLOCK_FRAMES);
+            n = static_cast<int>(juce::jmin<juce::int64>(BLOCK_FRAMES - offset, end - frame));
+            decodeBlock(channel, block, samples);
+            juce::FloatVectorOperations::convertFixedToFloat(dest + done, samples + offset, multiplier, n);
+        }
+
+        done += n;
+    }
+
+    if (done < numFrames)
+        juce::FloatVectorOperations::clear(dest + done, numFrames - done);
+}
+
+void CompactAudio::decodePacked(int channel, juce::int64 frame, int count, int* dest) const
+{
+    const auto* in = data.data()
+                   + (static_cast<size_t>(channel) * static_cast<size_t>(lengthInFrames) + static_cast<size_t>(frame))
+                         * static_cast<size_t>(getBytesPerSample());
+
+    // Loaded into the top of an int and shifted back down to sign-extend
+    if (bitDepth == 16)
+    {
+        for (int i = 0; i < count; ++i)
+            dest[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(in[2 * i]) << 16
+                                              | static_cast<std::uint32_t>(in[2 * i + 1]) << 24) >> 16;
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+            dest[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(in[3 * i]) << 8
+                                              | static_cast<std::uint32_t>(in[3 * i + 1]) << 16
+                                              | static_cast<std::uint32_t>(in[3 * i + 2]) << 24) >> 8;
+    }
+}
+
+void CompactAudio::decodeBlock(int channel, juce::int64 block, int* dest) const
+{
+    const int count = static_cast<int>(juce::jmin<juce::int64>(BLOCK_FRAMES, lengthInFrames - block * BLOCK_FRAMES));
+    const auto* in = data.data() + blockOffsets[static_cast<size_t>(block * numChannels + channel)];
+
+    const int order = in[0];
+    const int bits = in[1];
+    in += 2;
+
+    for (int i = 0; i < order; ++i)
+        dest[i] = static_cast<int>(juce::ByteOrder::littleEndianInt(in + 4 * i));
+    in += 4 * order;
+
+    // Residuals
+    if (bits == 0)
+    {
+        std::fill(dest + order, dest + count, 0);
+    }
+    else
+    {
+        const std::uint64_t mask = (std::uint64_t(1) << bits) - 1;
+        for (int i = order; i < count; ++i)
+        {
+            const auto bit = static_cast<size_t>(i - order) * static_cast<size_t>(bits);
+
+            std::uint64_t word;
+            std::memcpy(&word, in + (bit >> 3), sizeof(word));
+            word = juce::ByteOrder::swapIfBigEndian(word);
+
+            const auto value = static_cast<std::uint32_t>((word >> (bit & 7)) & mask);
+            dest[i] = static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+        }
+    }
+
+    // Undo the prediction
+    if (order == 1)
+    {
+        for (int i = 1; i < count; ++i)
+            dest[i] += dest[i - 1];
+    }
+    else if (order == 2)
+    {
+        for (int i = 2; i < count; ++i)
+            dest[i] += 2 * dest[i - 1] - dest[i - 2];
+    }
+}
+
+//==============================================================================
+
+juce::AudioBuffer<float> CompactAudio::toBuffer() const
+{
+    juce::AudioBuffer<float> buffer(numChannels, static_cast<int>(lengthInFrames));
+    for (int ch = 0; ch < numChannels; ++ch)
+        readChannel(ch, buffer.getWritePointer(ch), 0, buffer.getNumSamples());
+    return buffer;
+}
+
+juce::int64 CompactAudio::getBytes() const
+{
+    return static_cast<juce::int64>(sizeof(*this) + data.capacity() + blockOffsets.capacity() * sizeof(size_t));
+}
+
+juce::int64 CompactAudio::getFloatBytes() const
+{
+    return static_cast<juce::int64>(numChannels) * lengthInFrames * static_cast<juce::int64>(sizeof(float));
+}
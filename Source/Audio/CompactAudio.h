@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * CompactAudio - Clip audio held as integers instead of 32-bit floats
+ *
+ * Formats:
+ * - Packed: 16 or 24-bit little-endian samples, a half or three quarters of
+ *   the float size
+ * - Lossless: the same samples, predicted from the ones before and bit-packed
+ *   in blocks of BLOCK_FRAMES that decode independently (typically a third
+ *   to a half of the float size)
+ *
+ * The bit depth is the audio's own: 16 when every sample is exactly a 16-bit
+ * value (a 16-bit file at its own rate), otherwise 24, whose rounding sits
+ * some 140 dB down. Audio that peaks above full scale is stored relative to
+ * the next power of two up, so it is never clipped.
+ *
+ * Immutable once made; shared between clips like a pooled buffer (see
+ * SamplePool::getOrLoadCompact()). read() is safe on the audio thread: it
+ * converts a block at a time through a stack buffer, with the int-to-float
+ * step vectorised by FloatVectorOperations.
+ */
+class CompactAudio
+{
+public:
+    enum class Format { Packed, Lossless };
+
+    static constexpr int BLOCK_FRAMES = 1024;
+
+    /** nullptr if buffer is empty or holds non-finite samples */
+    static std::shared_ptr<const CompactAudio> fromBuffer(const juce::AudioBuffer<float>& buffer, Format format);
+
+    Format getFormat() const { return format; }
+    int getBitDepth() const { return bitDepth; }
+    int getNumChannels() const { return numChannels; }
+    juce::int64 getLengthInFrames() const { return lengthInFrames; }
+
+    //==========================================================================
+    // Any thread (no allocation or locking)
+
+    /**
+     * Decode numFrames from startFrame into the first numDestChannels of dest
+     * (overwrites). Frames outside the audio, and channels it doesn't have,
+     * read as silence.
+     */
+    void read(float* const* dest, int numDestChannels, juce::int64 startFrame, int numFrames) const;
+    void readChannel(int channel, float* dest, juce::int64 startFrame, int numFrames) const;
+
+    //==========================================================================
+
+    /** The whole of the audio as floats */
+    juce::AudioBuffer<float> toBuffer() const;
+
+    /** Heap use, and what the same audio takes as floats */
+    juce::int64 getBytes() const;
+    juce::int64 getFloatBytes() const;
+
+private:
+    Format format = Format::Packed;
+    int bitDepth = 24;
+    int numChannels = 0;
+    juce::int64 lengthInFrames = 0;
+    float multiplier = 1.0f;            // Float value of one integer step
+
+    // Packed: each channel's samples in turn. Lossless: the blocks, each
+    // channel's in turn, with blockOffsets[block * numChannels + channel]
+    // where it starts (and a final entry for the end)
+    std::vector<std::uint8_t> data;
+    std::vector<size_t> blockOffsets;
+
+    int getBytesPerSample() const { return bitDepth / 8; }
+
+    // Decode count integer samples of a channel from frame (within one block for Lossless)
+    void decodePacked(int channel, juce::int64 frame, int count, int* dest) const;
+    void decodeBlock(int channel, juce::int64 block, int* dest) const;
+
+    static void encodeBlock(const int* samples, int count, std::vector<std::uint8_t>& out);
+};
@@ -0,0 +1,126 @@
+#include "CompensationDelay.h"
+
+void CompensationDelay::setDelay(int samples, int numChannels)
+{
+    samples = juce::jmax(0, samples);
+    numChannels = juce::jmax(1, numChannels);
+
+    // Lines that have never delayed anything stay unallocated and cost nothing
+    if (samples == delay && (samples == 0 || numChannels <= storage.getNumChannels()))
+        return;
+
+    const bool passing = sounding || isHoldingAudio();
+    // Room for the fade back in as well, once the history has filled
+    grow(juce::jmax(samples, fadeRemaining > 0 ? fadeFrom : 0) + FADE_LENGTH + 1, numChannels);
+
+    if (passing)
+    {
+        fadeFrom = delay;
+        fadeRemaining = FADE_LENGTH;
+    }
+    else
+    {
+        // Only silence inside, which is as good as any history
+        storage.clear();
+        history = storage.getNumSamples();
+        fadeRemaining = 0;
+    }
+
+    delay = samples;
+}
+
+void CompensationDelay::reset()
+{
+    storage.clear();
+    history = storage.getNumSamples();
+    fadeRemaining = 0;
+    heldSamples = 0;
+    sounding = false;
+}
+
+void CompensationDelay::grow(int minimumLength, int numChannels)
+{
+    const int length = juce::nextPowerOfTwo(juce::jmax(minimumLength, 2));
+    const int oldLength = storage.getNumSamples();
+
+    if (length <= oldLength && numChannels <= storage.getNumChannels())
+        return;
+
+    const int newLength = juce::jmax(length, oldLength);
+    juce::AudioBuffer<float> grown(juce::jmax(numChannels, storage.getNumChannels()), newLength);
+    grown.clear();
+
+    // Oldest sample first, so the write position ends up at oldLength
+    for (int ch = 0; ch < storage.getNumChannels(); ++ch)
+    {
+        const auto* source = storage.getReadPointer(ch);
+        auto* dest = grown.getWritePointer(ch);
+        for (int i = 0; i < oldLength; ++i)
+            dest[i] = source[(writePosition + i) & mask];
+    }
+
+    storage = std::move(grown);
+    mask = newLength - 1;
+    writePosition = oldLength & mask;
+    history = juce::jmin(history, oldLength);
+}
+
+void CompensationDelay::process(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    numSamples = juce::jmin(numSamples, buffer.getNumSamples());
+    const int numChannels = juce::jmin(buffer.getNumChannels(), storage.getNumChannels());
+
+    sounding = false;
+    for (int ch = 0; ch < buffer.getNumChannels() && !sounding; ++ch)
+        sounding = buffer.getMagnitude(ch, 0, numSamples) > 0.0f;
+
+    if (storage.getNumSamples() == 0)
+        return;
+
+    // Reading from before the start of the history fades in as it catches up
+    const bool catchingUp = history <= mask && history < delay + FADE_LENGTH;
+    int position = writePosition;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* data = buffer.getWritePointer(ch);
+        auto* line = storage.getWritePointer(ch);
+        position = writePosition;
+        int fade = fadeRemaining;
+        int valid = history;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            line[position] = data[i];
+            float out = line[(position - delay) & mask];
+
+            if (catchingUp)
+            {
+                if (++valid <= mask)
+                    out *= juce::jlimit(0.0f, 1.0f, static_cast<float>(valid - delay) / static_cast<float>(FADE_LENGTH));
+            }
+
+            if (fade > 0)
+            {
+                const float oldWeight = static_cast<float>(fade) / static_cast<float>(FADE_LENGTH);
+                out += oldWeight * (line[(position - fadeFrom) & mask] - out);
+                --fade;
+            }
+
+            data[i] = out;
+            position = (position + 1) & mask;
+        }
+    }
+
+    writePosition = position;
+    fadeRemaining = juce::jmax(0, fadeRemaining - numSamples);
+    history = juce::jmin(history + numSamples, mask + 1);
+
+    const int longest = juce::jmax(delay, fadeRemaining > 0 ? fadeFrom : 0);
+    heldSamples = sounding ? longest : juce::jmax(0, juce::jmin(heldSamples, longest) - numSamples);
+}
+
+bool CompensationDelay::isHoldingAudio() const
+{
+    return heldSamples > 0;
+}
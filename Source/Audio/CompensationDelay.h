@@ -0,0 +1,57 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * CompensationDelay - Whole-sample delay line for plugin delay compensation
+ *
+ * Holds back the paths through the mix that have less latency than the
+ * slowest one, so everything meets the master (or a group) sample-aligned.
+ *
+ * Changing the delay while audio is passing through crossfades from the old
+ * read position to the new one over FADE_LENGTH samples instead of jumping.
+ * When the new position is further back than anything stored, the audio
+ * fades out, leaves a gap, and fades back in as the line catches up. If
+ * nothing but silence is in the line, the change takes effect at once.
+ */
+class CompensationDelay
+{
+public:
+    static constexpr int FADE_LENGTH = 512;
+
+    //==========================================================================
+    // Setup (not while processing)
+
+    /** Set the delay in samples; storage grows to fit and keeps its contents */
+    void setDelay(int samples, int numChannels = 2);
+    int getDelay() const { return delay; }
+
+    /** Forget everything in the line */
+    void reset();
+
+    //==========================================================================
+    // Processing (audio thread)
+
+    /** Delay the first numSamples of buffer in place */
+    void process(juce::AudioBuffer<float>& buffer, int numSamples);
+
+    /** True while audio written earlier hasn't come back out yet */
+    bool isHoldingAudio() const;
+
+private:
+    juce::AudioBuffer<float> storage;   // Power-of-two ring per channel
+    int mask = 0;
+    int writePosition = 0;
+
+    int delay = 0;
+    int fadeFrom = 0;                   // Delay being faded out
+    int fadeRemaining = 0;
+
+    int heldSamples = 0;                // Until the last sound written comes out
+    bool sounding = false;              // Last block had sound in it
+    int history = 0;                    // Valid samples behind the write position
+
+    void grow(int minimumLength, int numChannels);
+
+    JUCE_LEAK_DETECTOR(CompensationDelay)
+};
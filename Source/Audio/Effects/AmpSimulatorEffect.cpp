@@ -25,22 +25,7 @@ void AmpSimulatorEffect::prepareToPlay(double newSampleRate, int newSamplesPerBl
     outputGain.prepare(spec);
     lowCut.prepare(spec);
 
-    // Initialize filters with default coefficients
-    auto lowShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, 250.0f, 0.707f, 1.0f);
-    toneStackLowL.coefficients = lowShelfCoeffs;
-    toneStackLowR.coefficients = lowShelfCoeffs;
-
-    auto midPeakCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 800.0f, 1.0f, 1.0f);
-    toneStackMidL.coefficients = midPeakCoeffs;
-    toneStackMidR.coefficients = midPeakCoeffs;
-
-    auto highShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 3000.0f, 0.707f, 1.0f);
-    toneStackHighL.coefficients = highShelfCoeffs;
-    toneStackHighR.coefficients = highShelfCoeffs;
-
-    auto presenceCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 5000.0f, 0.707f, 1.0f);
-    presenceL.coefficients = presenceCoeffs;
-    presenceR.coefficients = presenceCoeffs;
+    toneStack.prepare(2);
 
     lowCut.setType(juce::dsp::StateVariableTPTFilterType::highpass);
     lowCut.setCutoffFrequency(80.0f);
@@ -55,6 +40,7 @@ void AmpSimulatorEffect::prepareToPlay(double newSampleRate, int newSamplesPerBl
     ampModel = static_cast<int>(getParameter("model"));
 
     applyAmpModel(ampModel);
+    updateToneStack();
 }
 
 void AmpSimulatorEffect::releaseResources()
@@ -71,14 +57,7 @@ void AmpSimulatorEffect::reset()
     inputGain.reset();
     outputGain.reset();
     lowCut.reset();
-    toneStackLowL.reset();
-    toneStackLowR.reset();
-    toneStackMidL.reset();
-    toneStackMidR.reset();
-    toneStackHighL.reset();
-    toneStackHighR.reset();
-    presenceL.reset();
-    presenceR.reset();
+    toneStack.reset();
 }
 
 float AmpSimulatorEffect::waveshape(float input, float amount)
@@ -118,25 +97,8 @@ void AmpSimulatorEffect::processEffect(juce::AudioBuffer<float>& buffer)
         }
     }
 
-    // Apply tone stack
-    auto* leftChannel = buffer.getWritePointer(0);
-    auto* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
-
-    for (int i = 0; i < numSamples; ++i)
-    {
-        leftChannel[i] = toneStackLowL.processSample(leftChannel[i]);
-        leftChannel[i] = toneStackMidL.processSample(leftChannel[i]);
-        leftChannel[i] = toneStackHighL.processSample(leftChannel[i]);
-        leftChannel[i] = presenceL.processSample(leftChannel[i]);
-
-        if (rightChannel != nullptr)
-        {
-            rightChannel[i] = toneStackLowR.processSample(rightChannel[i]);
-            rightChannel[i] = toneStackMidR.processSample(rightChannel[i]);
-            rightChannel[i] = toneStackHighR.processSample(rightChannel[i]);
-            rightChannel[i] = presenceR.processSample(rightChannel[i]);
-        }
-    }
+    // Apply tone stack, both channels at once
+    toneStack.process(buffer, numSamples);
 
     // Apply output gain
     float masterGain = (master / 10.0f) * 1.5f;
@@ -167,6 +129,20 @@ void AmpSimulatorEffect::applyAmpModel(int model)
     }
 }
 
+void AmpSimulatorEffect::updateToneStack()
+{
+    // Knobs are 0-10 with 5 flat
+    const float bassGainDb = (bass - 5.0f) * 3.0f;
+    const float midGainDb = (mid - 5.0f) * 3.0f;
+    const float trebleGainDb = (treble - 5.0f) * 3.0f;
+    const float presenceGainDb = (presenceAmount - 5.0f) * 2.0f;
+
+    toneStack.setStage(0, BiquadCascade::Coefficients::lowShelf(sampleRate, 250.0f, 0.707f, bassGainDb));
+    toneStack.setStage(1, BiquadCascade::Coefficients::peak(sampleRate, 800.0f, 1.0f, midGainDb));
+    toneStack.setStage(2, BiquadCascade::Coefficients::highShelf(sampleRate, 3000.0f, 0.707f, trebleGainDb));
+    toneStack.setStage(3, BiquadCascade::Coefficients::highShelf(sampleRate, 5000.0f, 0.707f, presenceGainDb));
+}
+
 void AmpSimulatorEffect::onParameterChanged(const juce::String& name, float value)
 {
     if (name == "drive")
@@ -177,38 +153,22 @@ void AmpSimulatorEffect::onParameterChanged(const juce::String& name, float valu
     else if (name == "bass")
     {
         bass = value;
-        float bassGainDb = (value - 5.0f) * 3.0f;
-        float bassGain = std::pow(10.0f, bassGainDb / 20.0f);
-        auto coeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, 250.0f, 0.707f, bassGain);
-        toneStackLowL.coefficients = coeffs;
-        toneStackLowR.coefficients = coeffs;
+        updateToneStack();
     }
     else if (name == "mid")
     {
         mid = value;
-        float midGainDb = (value - 5.0f) * 3.0f;
-        float midGain = std::pow(10.0f, midGainDb / 20.0f);
-        auto coeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 800.0f, 1.0f, midGain);
-        toneStackMidL.coefficients = coeffs;
-        toneStackMidR.coefficients = coeffs;
+        updateToneStack();
     }
     else if (name == "treble")
     {
         treble = value;
-        float trebleGainDb = (value - 5.0f) * 3.0f;
-        float trebleGain = std::pow(10.0f, trebleGainDb / 20.0f);
-        auto coeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 3000.0f, 0.707f, trebleGain);
-        toneStackHighL.coefficients = coeffs;
-        toneStackHighR.coefficients = coeffs;
+        updateToneStack();
     }
     else if (name == "presence")
     {
         presenceAmount = value;
-        float presenceGainDb = (value - 5.0f) * 2.0f;
-        float presenceGain = std::pow(10.0f, presenceGainDb / 20.0f);
-        auto coeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 5000.0f, 0.707f, presenceGain);
-        presenceL.coefficients = coeffs;
-        presenceR.coefficients = coeffs;
+        updateToneStack();
     }
     else if (name == "master")
         master = value;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "EffectBase.h"
+#include "BiquadCascade.h"
 
 /**
  * AmpSimulatorEffect - Guitar/Bass amplifier simulation
@@ -35,6 +36,7 @@ protected:
 
 private:
     void applyAmpModel(int model);
+    void updateToneStack();
     float waveshape(float input, float amount);
 
     // Input gain (preamp/drive)
@@ -43,13 +45,8 @@ private:
     // Low cut filter
     juce::dsp::StateVariableTPTFilter<float> lowCut;
 
-    // Tone stack (3-band EQ)
-    juce::dsp::IIR::Filter<float> toneStackLowL, toneStackLowR;
-    juce::dsp::IIR::Filter<float> toneStackMidL, toneStackMidR;
-    juce::dsp::IIR::Filter<float> toneStackHighL, toneStackHighR;
-
-    // Presence
-    juce::dsp::IIR::Filter<float> presenceL, presenceR;
+    // Tone stack (bass shelf, mid peak, treble shelf) and presence shelf
+    BiquadCascade toneStack;
 
     // Output gain
     juce::dsp::Gain<float> outputGain;
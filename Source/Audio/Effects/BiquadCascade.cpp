@@ -0,0 +1,318 @@
+#include "BiquadCascade.h"
+
+namespace
+{
+    float clampFrequency(double sampleRate, float frequency)
+    {
+        return juce::jlimit(1.0f, static_cast<float>(sampleRate * 0.49), frequency);
+    }
+}
+
+//==============================================================================
+// Coefficients
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::fromJuce(const juce::dsp::IIR::Coefficients<float>& coefficients)
+{
+    const auto& raw = coefficients.coefficients;
+    Coefficients c;
+
+    if (raw.size() == 5)
+    {
+        c.b0 = raw[0];
+        c.b1 = raw[1];
+        c.b2 = raw[2];
+        c.a1 = raw[3];
+        c.a2 = raw[4];
+    }
+    else if (raw.size() == 3) // First order
+    {
+        c.b0 = raw[0];
+        c.b1 = raw[1];
+        c.a1 = raw[2];
+    }
+
+    return c;
+}
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::peak(double sampleRate, float frequency, float q, float gainDb)
+{
+    if (gainDb == 0.0f)
+        return identity();
+
+    return fromJuce(*juce::dsp::IIR::Coefficients<float>::makePeakFilter(
+        sampleRate, clampFrequency(sampleRate, frequency), q, juce::Decibels::decibelsToGain(gainDb)));
+}
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::lowShelf(double sampleRate, float frequency, float q, float gainDb)
+{
+    if (gainDb == 0.0f)
+        return identity();
+
+    return fromJuce(*juce::dsp::IIR::Coefficients<float>::makeLowShelf(
+        sampleRate, clampFrequency(sampleRate, frequency), q, juce::Decibels::decibelsToGain(gainDb)));
+}
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::highShelf(double sampleRate, float frequency, float q, float gainDb)
+{
+    if (gainDb == 0.0f)
+        return identity();
+
+    return fromJuce(*juce::dsp::IIR::Coefficients<float>::makeHighShelf(
+        sampleRate, clampFrequency(sampleRate, frequency), q, juce::Decibels::decibelsToGain(gainDb)));
+}
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::lowPass(double sampleRate, float frequency, float q)
+{
+    return fromJuce(*juce::dsp::IIR::Coefficients<float>::makeLowPass(
+        sampleRate, clampFrequency(sampleRate, frequency), q));
+}
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::highPass(double sampleRate, float frequency, float q)
+{
+    return fromJuce(*juce::dsp::IIR::Coefficients<float>::makeHighPass(
+        sampleRate, clampFrequency(sampleRate, frequency), q));
+}
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::notch(double sampleRate, float frequency, float q)
+{
+    return fromJuce(*juce::dsp::IIR::Coefficients<float>::makeNotch(
+        sampleRate, clampFrequency(sampleRate, frequency), q));
+}
+
+BiquadCascade::Coefficients BiquadCascade::Coefficients::bandPass(double sampleRate, float frequency, float q)
+{
+    return fromJuce(*juce::dsp::IIR::Coefficients<float>::makeBandPass(
+        sampleRate, clampFrequency(sampleRate, frequency), q));
+}
+
+//==============================================================================
+BiquadCascade::BiquadCascade()
+{
+    for (int stage = 0; stage < MAX_STAGES; ++stage)
+        for (int k = 0; k < NUM_COEFFICIENTS; ++k)
+            for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+                pendingTargets.values[stage][k][ch] = k == 0 ? 1.0f : 0.0f;
+
+    activeTargets = pendingTargets;
+}
+
+void BiquadCascade::prepare(int numChannels)
+{
+    numChannelsPrepared = juce::jlimit(1, MAX_CHANNELS, numChannels);
+    numGroups = (numChannelsPrepared + LANES - 1) / LANES;
+    stages.assign(static_cast<size_t>(numGroups * MAX_STAGES), Stage{});
+
+    // Start from the current targets without a ramp
+    rampRemaining = 0;
+    targetsChanged.store(true);
+    snapRequested.store(true);
+}
+
+void BiquadCascade::reset()
+{
+    for (auto& stage : stages)
+    {
+        stage.s1 = Lanes::expand(0.0f);
+        stage.s2 = Lanes::expand(0.0f);
+    }
+}
+
+void BiquadCascade::setStage(int stage, const Coefficients& coefficients, int channel)
+{
+    jassert(stage >= 0 && stage < MAX_STAGES);
+    jassert(channel < MAX_CHANNELS);
+    if (stage < 0 || stage >= MAX_STAGES || channel >= MAX_CHANNELS)
+        return;
+
+    const float values[NUM_COEFFICIENTS] = { coefficients.b0, coefficients.b1, coefficients.b2,
+                                             coefficients.a1, coefficients.a2 };
+
+    const juce::SpinLock::ScopedLockType lock(targetLock);
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        if (channel < 0 || ch == channel)
+            for (int k = 0; k < NUM_COEFFICIENTS; ++k)
+                pendingTargets.values[stage][k][ch] = values[k];
+
+    targetsChanged.store(true);
+}
+
+//==============================================================================
+void BiquadCascade::adoptTargets()
+{
+    if (!targetsChanged.load() && !snapRequested.load())
+        return;
+
+    const juce::SpinLock::ScopedTryLockType lock(targetLock);
+    if (!lock.isLocked())
+        return; // Try again next block
+
+    const bool snap = snapRequested.exchange(false);
+    targetsChanged.store(false);
+    activeTargets = pendingTargets;
+
+    const int rampSamples = snap ? 0 : rampLength.load();
+
+    for (int stage = 0; stage < MAX_STAGES; ++stage)
+    {
+        targetActive[stage] = false;
+        for (int ch = 0; ch < numChannelsPrepared && !targetActive[stage]; ++ch)
+            for (int k = 0; k < NUM_COEFFICIENTS; ++k)
+                if (activeTargets.values[stage][k][ch] != (k == 0 ? 1.0f : 0.0f))
+                    targetActive[stage] = true;
+
+        // A stage fading out to identity keeps running until the ramp ends
+        stageActive[stage] = targetActive[stage] || (rampSamples > 0 && stageActive[stage]);
+    }
+
+    loadTargets(rampSamples);
+    rampRemaining = rampSamples;
+
+    if (rampSamples == 0)
+        finishRamp();
+}
+
+void BiquadCascade::loadTargets(int rampSamples)
+{
+    const auto rampScale = Lanes::expand(rampSamples > 0 ? 1.0f / static_cast<float>(rampSamples) : 0.0f);
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        for (int stage = 0; stage < MAX_STAGES; ++stage)
+        {
+            auto& s = stages[static_cast<size_t>(group * MAX_STAGES + stage)];
+
+            for (int k = 0; k < NUM_COEFFICIENTS; ++k)
+            {
+                // Lanes past the last channel hold identity
+                alignas(64) float lanes[LANES];
+                for (int lane = 0; lane < LANES; ++lane)
+                {
+                    const int ch = group * LANES + lane;
+                    lanes[lane] = ch < numChannelsPrepared ? activeTargets.values[stage][k][ch]
+                                                           : (k == 0 ? 1.0f : 0.0f);
+                }
+
+                const auto target = Lanes::fromRawArray(lanes);
+                if (rampSamples > 0)
+                {
+                    s.increments[k] = (target - s.coefficients[k]) * rampScale;
+                }
+                else
+                {
+                    s.coefficients[k] = target;
+                    s.increments[k] = Lanes::expand(0.0f);
+                }
+            }
+        }
+    }
+}
+
+void BiquadCascade::finishRamp()
+{
+    // Land exactly on the targets, and stop running stages that reached identity
+    loadTargets(0);
+
+    numActiveStages = 0;
+    for (int stage = 0; stage < MAX_STAGES; ++stage)
+    {
+        if (stageActive[stage] && !targetActive[stage])
+        {
+            for (int group = 0; group < numGroups; ++group)
+            {
+                auto& s = stages[static_cast<size_t>(group * MAX_STAGES + stage)];
+                s.s1 = Lanes::expand(0.0f);
+                s.s2 = Lanes::expand(0.0f);
+            }
+        }
+
+        stageActive[stage] = targetActive[stage];
+        if (stageActive[stage])
+            numActiveStages = stage + 1;
+    }
+}
+
+//==============================================================================
+void BiquadCascade::process(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+            juce::jmin(numSamples, buffer.getNumSamples()));
+}
+
+void BiquadCascade::process(float* const* channels, int numChannels, int numSamples)
+{
+    if (numGroups == 0 || numSamples <= 0)
+        return;
+
+    juce::ScopedNoDenormals noDenormals;
+
+    adoptTargets();
+
+    // While ramping, stages fading out still count
+    if (rampRemaining > 0)
+    {
+        numActiveStages = 0;
+        for (int stage = 0; stage < MAX_STAGES; ++stage)
+            if (stageActive[stage])
+                numActiveStages = stage + 1;
+    }
+
+    if (numActiveStages == 0)
+        return;
+
+    const int channelsToProcess = juce::jmin(numChannels, numChannelsPrepared);
+    int start = 0;
+
+    if (rampRemaining > 0)
+    {
+        const int rampSamples = juce::jmin(rampRemaining, numSamples);
+        for (int first = 0; first < channelsToProcess; first += LANES)
+            processGroup<true>(channels, first, juce::jmin(LANES, channelsToProcess - first), 0, rampSamples);
+
+        rampRemaining -= rampSamples;
+        start = rampSamples;
+
+        if (rampRemaining == 0)
+            finishRamp();
+    }
+
+    if (start < numSamples && numActiveStages > 0)
+        for (int first = 0; first < channelsToProcess; first += LANES)
+            processGroup<false>(channels, first, juce::jmin(LANES, channelsToProcess - first),
+                                start, numSamples - start);
+}
+
+template <bool Ramping>
+void BiquadCascade::processGroup(float* const* channels, int firstChannel, int numChannels,
+                                 int startSample, int numSamples)
+{
+    Stage* group = stages.data() + (firstChannel / LANES) * MAX_STAGES;
+    alignas(64) float frame[LANES] = {};
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        for (int lane = 0; lane < numChannels; ++lane)
+            frame[lane] = channels[firstChannel + lane][i];
+
+        auto x = Lanes::fromRawArray(frame);
+
+        for (int stage = 0; stage < numActiveStages; ++stage)
+        {
+            if (!stageActive[stage])
+                continue;
+
+            auto& s = group[stage];
+            const auto y = s.coefficients[0] * x + s.s1;
+            s.s1 = s.coefficients[1] * x - s.coefficients[3] * y + s.s2;
+            s.s2 = s.coefficients[2] * x - s.coefficients[4] * y;
+            x = y;
+
+            if constexpr (Ramping)
+                for (int k = 0; k < NUM_COEFFICIENTS; ++k)
+                    s.coefficients[k] = s.coefficients[k] + s.increments[k];
+        }
+
+        x.copyToRawArray(frame);
+        for (int lane = 0; lane < numChannels; ++lane)
+            channels[firstChannel + lane][i] = frame[lane];
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * BiquadCascade - Series of biquads run with channels as SIMD lanes
+ *
+ * Each sample, the channels are loaded into one register (stereo uses two
+ * lanes, up to a register's width of channels share it) and every stage runs
+ * once on the whole register in transposed direct form II:
+ *
+ *     y  = b0 x + s1
+ *     s1 = b1 x - a1 y + s2
+ *     s2 = b2 x - a2 y
+ *
+ * so an N-band EQ costs N vector updates per sample rather than N filters per
+ * channel. Coefficients can differ per channel (e.g. mid/side).
+ *
+ * New coefficients are set from the message thread and picked up at the start
+ * of the next block, then interpolated linearly over the ramp length so
+ * sweeping a band doesn't click. Stages left at identity are skipped.
+ */
+class BiquadCascade
+{
+public:
+    static constexpr int MAX_STAGES = 16;
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr int DEFAULT_RAMP_SAMPLES = 64;
+
+    /** Normalised biquad coefficients (a0 = 1) */
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+
+        bool isIdentity() const { return b0 == 1.0f && b1 == 0.0f && b2 == 0.0f && a1 == 0.0f && a2 == 0.0f; }
+
+        static Coefficients identity() { return {}; }
+        static Coefficients fromJuce(const juce::dsp::IIR::Coefficients<float>& coefficients);
+
+        // Designs (RBJ cookbook, via juce::dsp::IIR) - message thread, they allocate
+        static Coefficients peak(double sampleRate, float frequency, float q, float gainDb);
+        static Coefficients lowShelf(double sampleRate, float frequency, float q, float gainDb);
+        static Coefficients highShelf(double sampleRate, float frequency, float q, float gainDb);
+        static Coefficients lowPass(double sampleRate, float frequency, float q);
+        static Coefficients highPass(double sampleRate, float frequency, float q);
+        static Coefficients notch(double sampleRate, float frequency, float q);
+        static Coefficients bandPass(double sampleRate, float frequency, float q);
+    };
+
+    BiquadCascade();
+
+    //==========================================================================
+    void prepare(int numChannels);
+    void reset();
+
+    /** Samples over which coefficient changes are interpolated (0 = jump) */
+    void setRampLength(int samples) { rampLength.store(juce::jmax(0, samples)); }
+
+    //==========================================================================
+    // Coefficients (message thread)
+
+    /** Set a stage for every channel, or just one when channel >= 0 */
+    void setStage(int stage, const Coefficients& coefficients, int channel = -1);
+
+    /** Jump to the latest coefficients on the next block instead of ramping */
+    void snapToTargets() { snapRequested.store(true); }
+
+    //==========================================================================
+    // Processing (audio thread)
+
+    void process(juce::AudioBuffer<float>& buffer, int numSamples);
+    void process(float* const* channels, int numChannels, int numSamples);
+
+private:
+   #if JUCE_USE_SIMD
+    using Lanes = juce::dsp::SIMDRegister<float>;
+   #else
+    /** Single-lane stand-in with the SIMDRegister operations used here */
+    struct Lanes
+    {
+        static constexpr size_t SIMDNumElements = 1;
+        float value = 0.0f;
+
+        static Lanes expand(float v) noexcept { return { v }; }
+        static Lanes fromRawArray(const float* a) noexcept { return { *a }; }
+        void copyToRawArray(float* a) const noexcept { *a = value; }
+        Lanes operator+(Lanes other) const noexcept { return { value + other.value }; }
+        Lanes operator-(Lanes other) const noexcept { return { value - other.value }; }
+        Lanes operator*(Lanes other) const noexcept { return { value * other.value }; }
+    };
+   #endif
+
+    static constexpr int LANES = static_cast<int>(Lanes::SIMDNumElements);
+    static constexpr int NUM_COEFFICIENTS = 5;
+
+    struct Stage
+    {
+        Lanes coefficients[NUM_COEFFICIENTS];   // b0 b1 b2 a1 a2
+        Lanes increments[NUM_COEFFICIENTS];
+        Lanes s1, s2;
+    };
+
+    // Per channel target coefficients, written by the message thread
+    struct Targets
+    {
+        float values[MAX_STAGES][NUM_COEFFICIENTS][MAX_CHANNELS];
+    };
+
+    void adoptTargets();
+    void loadTargets(int rampSamples);
+    void finishRamp();
+
+    template <bool Ramping>
+    void processGroup(float* const* channels, int firstChannel, int numChannels,
+                      int startSample, int numSamples);
+
+    int numChannelsPrepared = 0;
+    int numGroups = 0;
+    std::vector<Stage> stages;              // [group][stage]
+    int numActiveStages = 0;                // Highest processed stage + 1
+    bool stageActive[MAX_STAGES] = {};      // Processed this block
+    bool targetActive[MAX_STAGES] = {};     // Non-identity once ramped
+    int rampRemaining = 0;
+
+    juce::SpinLock targetLock;
+    Targets pendingTargets;                 // Guarded by targetLock
+    Targets activeTargets;                  // Audio thread
+    std::atomic<bool> targetsChanged{false};
+    std::atomic<bool> snapRequested{true};
+    std::atomic<int> rampLength{DEFAULT_RAMP_SAMPLES};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BiquadCascade)
+};
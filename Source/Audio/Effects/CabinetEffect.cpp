@@ -3,6 +3,7 @@
 
 CabinetEffect::CabinetEffect()
 {
+    addParameter("mode", "Mode", 0.0f, 0.0f, 1.0f, "", 1.0f);
     addParameter("cabinet", "Cabinet", 2.0f, 0.0f, 5.0f, "", 1.0f);
     addParameter("lowCut", "Low Cut", 70.0f, 30.0f, 200.0f, "Hz");
     addParameter("highCut", "High Cut", 5500.0f, 2000.0f, 12000.0f, "Hz");
@@ -24,6 +25,7 @@ void CabinetEffect::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 
     lowCutFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
     highCutFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+    characterFilters.prepare(2);
 
     // Get initial parameters
     cabinetModel = static_cast<int>(getParameter("cabinet"));
@@ -34,6 +36,10 @@ void CabinetEffect::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 
     applyCabinetModel(cabinetModel);
     updateFilters();
+
+    // IR kernels are built for one rate
+    if (irFile != juce::File() && sampleRate != irSampleRate)
+        loadImpulseResponse(irFile);
 }
 
 void CabinetEffect::releaseResources()
@@ -48,12 +54,36 @@ void CabinetEffect::reset()
     EffectBase::reset();
     lowCutFilter.reset();
     highCutFilter.reset();
-    lowMidL.reset();
-    lowMidR.reset();
-    highMidL.reset();
-    highMidR.reset();
-    resonanceL.reset();
-    resonanceR.reset();
+    characterFilters.reset();
+    convolution.reset();
+}
+
+//==============================================================================
+// Impulse response
+
+void CabinetEffect::copyStateFrom(const EffectBase& other)
+{
+    EffectBase::copyStateFrom(other);
+
+    const auto& source = static_cast<const CabinetEffect&>(other);
+    if (source.irFile == juce::File())
+        clearImpulseResponse();
+    else if (source.irFile != irFile)
+        loadImpulseResponse(source.irFile);
+}
+
+void CabinetEffect::loadImpulseResponse(const juce::File& file)
+{
+    irFile = file;
+    irSampleRate = sampleRate;
+    convolution.loadImpulseResponse(file, sampleRate);
+}
+
+void CabinetEffect::clearImpulseResponse()
+{
+    irFile = juce::File();
+    irSampleRate = 0.0;
+    convolution.clearImpulseResponse();
 }
 
 void CabinetEffect::updateFilters()
@@ -61,23 +91,9 @@ void CabinetEffect::updateFilters()
     lowCutFilter.setCutoffFrequency(lowCutFreq);
     highCutFilter.setCutoffFrequency(highCutFreq);
 
-    // Low-mid bump
-    float lowMidGainLinear = std::pow(10.0f, lowMidGain / 20.0f);
-    auto lowMidCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, lowMidFreq, 0.8f, lowMidGainLinear);
-    lowMidL.coefficients = lowMidCoeffs;
-    lowMidR.coefficients = lowMidCoeffs;
-
-    // High-mid cut/boost
-    float highMidGainLinear = std::pow(10.0f, highMidGain / 20.0f);
-    auto highMidCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, highMidFreq, 1.0f, highMidGainLinear);
-    highMidL.coefficients = highMidCoeffs;
-    highMidR.coefficients = highMidCoeffs;
-
-    // Speaker resonance
-    float resonanceGainLinear = std::pow(10.0f, resonanceDb / 20.0f);
-    auto resonanceCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, resonanceFreq, 3.0f, resonanceGainLinear);
-    resonanceL.coefficients = resonanceCoeffs;
-    resonanceR.coefficients = resonanceCoeffs;
+    characterFilters.setStage(0, BiquadCascade::Coefficients::peak(sampleRate, lowMidFreq, 0.8f, lowMidGain));
+    characterFilters.setStage(1, BiquadCascade::Coefficients::peak(sampleRate, highMidFreq, 1.0f, highMidGain));
+    characterFilters.setStage(2, BiquadCascade::Coefficients::peak(sampleRate, resonanceFreq, 3.0f, resonanceDb));
 }
 
 void CabinetEffect::applyCabinetModel(int model)
@@ -157,37 +173,34 @@ void CabinetEffect::applyCabinetModel(int model)
 void CabinetEffect::processEffect(juce::AudioBuffer<float>& buffer)
 {
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
 
-    // Apply low cut and high cut
     juce::dsp::AudioBlock<float> block(buffer);
     juce::dsp::ProcessContextReplacing<float> context(block);
 
+    // The IR already carries the cabinet's colour - just trim the extremes
+    if (useImpulseResponse.load() && convolution.hasImpulseResponse())
+    {
+        convolution.process(buffer, numSamples);
+        lowCutFilter.process(context);
+        highCutFilter.process(context);
+        return;
+    }
+
+    // Apply low cut and high cut
     lowCutFilter.process(context);
     highCutFilter.process(context);
 
-    // Apply EQ filters per sample
-    auto* leftChannel = buffer.getWritePointer(0);
-    auto* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
-
-    for (int i = 0; i < numSamples; ++i)
-    {
-        leftChannel[i] = lowMidL.processSample(leftChannel[i]);
-        leftChannel[i] = highMidL.processSample(leftChannel[i]);
-        leftChannel[i] = resonanceL.processSample(leftChannel[i]);
-
-        if (rightChannel != nullptr)
-        {
-            rightChannel[i] = lowMidR.processSample(rightChannel[i]);
-            rightChannel[i] = highMidR.processSample(rightChannel[i]);
-            rightChannel[i] = resonanceR.processSample(rightChannel[i]);
-        }
-    }
+    // Cabinet character EQ, both channels at once
+    characterFilters.process(buffer, numSamples);
 }
 
 void CabinetEffect::onParameterChanged(const juce::String& name, float value)
 {
-    if (name == "cabinet")
+    if (name == "mode")
+    {
+        useImpulseResponse.store(static_cast<int>(value) == 1);
+    }
+    else if (name == "cabinet")
     {
         cabinetModel = static_cast<int>(value);
         applyCabinetModel(cabinetModel);
@@ -1,11 +1,19 @@
 #pragma once
 
 #include "EffectBase.h"
+#include "BiquadCascade.h"
+#include "ConvolutionEngine.h"
 
 /**
- * CabinetEffect - Speaker cabinet simulation using EQ
+ * CabinetEffect - Speaker cabinet simulation using EQ or a loaded impulse response
+ *
+ * In IR mode the signal is convolved with the loaded cabinet IR (loaded in
+ * the background, shared between instances using the same file) and only
+ * the low/high cut filters are applied on top. Without an IR it falls back
+ * to the EQ model.
  *
  * Parameters:
+ * - mode: 0=Model (EQ), 1=Impulse Response
  * - cabinet: Cabinet model (0=1x12, 1=2x12, 2=4x12 Closed, 3=4x12 Open, 4=1x15 Bass, 5=8x10 Bass)
  * - lowCut: Low cut frequency in Hz (30-200)
  * - highCut: High cut frequency in Hz (2000-12000)
@@ -26,6 +34,17 @@ public:
 
     std::vector<EffectPreset> getPresets() const override;
 
+    void copyStateFrom(const EffectBase& other) override;
+    bool isLoading() const override { return isImpulseResponseLoading(); }
+
+    //==========================================================================
+    // Impulse response (message thread)
+    void loadImpulseResponse(const juce::File& file);
+    void clearImpulseResponse();
+    const juce::File& getImpulseResponseFile() const { return irFile; }
+    bool isImpulseResponseLoaded() const { return convolution.hasImpulseResponse(); }
+    bool isImpulseResponseLoading() const { return convolution.isLoading(); }
+
 protected:
     void processEffect(juce::AudioBuffer<float>& buffer) override;
     void onParameterChanged(const juce::String& name, float value) override;
@@ -38,10 +57,14 @@ private:
     juce::dsp::StateVariableTPTFilter<float> lowCutFilter;
     juce::dsp::StateVariableTPTFilter<float> highCutFilter;
 
-    // EQ for cabinet character
-    juce::dsp::IIR::Filter<float> lowMidL, lowMidR;
-    juce::dsp::IIR::Filter<float> highMidL, highMidR;
-    juce::dsp::IIR::Filter<float> resonanceL, resonanceR;
+    // EQ for cabinet character: low-mid bump, high-mid, speaker resonance
+    BiquadCascade characterFilters;
+
+    // Impulse response mode
+    ConvolutionEngine convolution;
+    juce::File irFile;
+    double irSampleRate = 0.0;      // Rate the current IR was loaded for
+    std::atomic<bool> useImpulseResponse{false};
 
     // Parameters
     int cabinetModel = 2;
@@ -56,6 +56,12 @@ void ChorusEffect::onParameterChanged(const juce::String& name, float value)
         chorus.setFeedback(value);
 }
 
+int ChorusEffect::getTailSamples() const
+{
+    // Longest modulated delay (juce::dsp::Chorus sweeps up to 20 ms past the centre)
+    return static_cast<int>((getParameter("centreDelay") + 20.0f) * 0.001f * static_cast<float>(sampleRate));
+}
+
 std::vector<EffectPreset> ChorusEffect::getPresets() const
 {
     std::vector<EffectPreset> presets;
@@ -24,6 +24,8 @@ public:
 
     std::vector<EffectPreset> getPresets() const override;
 
+    int getTailSamples() const override;
+
 protected:
     void processEffect(juce::AudioBuffer<float>& buffer) override;
     void onParameterChanged(const juce::String& name, float value) override;
@@ -0,0 +1,891 @@
+#include "ConvolutionEngine.h"
+#include "../Resampler.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <thread>
+
+namespace
+{
+    // Partition sizes in the order they appear in the IR. Each stage starts
+    // at an offset of at least its block size (audio thread) or twice its
+    // block size (worker threads), which is what makes it latency-free.
+    constexpr int STAGE_SIZES[] = { 64, 256, 1024, 4096, 16384 };
+    constexpr int NUM_STAGE_SIZES = 5;
+    constexpr int MIN_WORKER_BLOCK = 1024;
+    constexpr int MAX_QUEUED_JOBS = 1024;
+
+    int ceilDiv(int a, int b) { return (a + b - 1) / b; }
+
+    // Copy count samples starting at a (possibly negative) stream position
+    void readRing(const std::vector<float>& ring, juce::int64 start, int count, float* dest)
+    {
+        const int size = static_cast<int>(ring.size());
+        const int first = static_cast<int>(start & static_cast<juce::int64>(size - 1));
+        const int firstPart = std::min(count, size - first);
+
+        std::memcpy(dest, ring.data() + first, sizeof(float) * static_cast<size_t>(firstPart));
+        if (count > firstPart)
+            std::memcpy(dest + firstPart, ring.data(), sizeof(float) * static_cast<size_t>(count - firstPart));
+    }
+
+    void writeRing(std::vector<float>& ring, juce::int64 start, int count, const float* src)
+    {
+        const int size = static_cast<int>(ring.size());
+        const int first = static_cast<int>(start & static_cast<juce::int64>(size - 1));
+        const int firstPart = std::min(count, size - first);
+
+        std::memcpy(ring.data() + first, src, sizeof(float) * static_cast<size_t>(firstPart));
+        if (count > firstPart)
+            std::memcpy(ring.data(), src + firstPart, sizeof(float) * static_cast<size_t>(count - firstPart));
+    }
+
+    void addToRing(std::vector<float>& ring, juce::int64 start, int count, const float* src)
+    {
+        const int size = static_cast<int>(ring.size());
+        const int first = static_cast<int>(start & static_cast<juce::int64>(size - 1));
+        const int firstPart = std::min(count, size - first);
+
+        juce::FloatVectorOperations::add(ring.data() + first, src, firstPart);
+        if (count > firstPart)
+            juce::FloatVectorOperations::add(ring.data(), src + firstPart, count - firstPart);
+    }
+
+    // acc += x * h over interleaved complex bins
+    void multiplyAccumulate(float* acc, const float* x, const float* h, int numBins)
+    {
+        for (int k = 0; k < numBins; ++k)
+        {
+            const float xr = x[2 * k], xi = x[2 * k + 1];
+            const float hr = h[2 * k], hi = h[2 * k + 1];
+            acc[2 * k]     += xr * hr - xi * hi;
+            acc[2 * k + 1] += xr * hi + xi * hr;
+        }
+    }
+
+    // Resample, trim, cap and optionally normalise an IR for processing at sampleRate
+    void prepareImpulseResponse(juce::AudioBuffer<float>& ir, double irSampleRate,
+                                double sampleRate, bool normalise)
+    {
+        const int numChannels = std::min(ir.getNumChannels(), ConvolutionEngine::MAX_CHANNELS);
+
+        if (irSampleRate > 0.0 && sampleRate > 0.0 && std::abs(irSampleRate - sampleRate) > 1.0e-6)
+        {
+            const double increment = irSampleRate / sampleRate;
+            const int newLength = static_cast<int>(std::ceil(ir.getNumSamples() / increment));
+
+            juce::AudioBuffer<float> resampled(numChannels, newLength);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                Resampler::process(Resampler::Quality::Sinc, ir.getReadPointer(ch), ir.getNumSamples(),
+                                   0.0, increment, resampled.getWritePointer(ch), newLength);
+            }
+            ir = std::move(resampled);
+        }
+
+        // Drop the inaudible end (around -100 dB) so it isn't convolved
+        int length = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* data = ir.getReadPointer(ch);
+            for (int i = ir.getNumSamples(); --i >= length;)
+            {
+                if (std::abs(data[i]) > 1.0e-5f)
+                {
+                    length = i + 1;
+                    break;
+                }
+            }
+        }
+
+        length = std::min(length, static_cast<int>(ConvolutionEngine::MAX_IR_SECONDS * sampleRate));
+        ir.setSize(numChannels, length, true, false, false);
+
+        if (normalise && length > 0)
+        {
+            // Unity gain for white noise on the loudest channel
+            double maxEnergy = 0.0;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                double energy = 0.0;
+                const auto* data = ir.getReadPointer(ch);
+                for (int i = 0; i < length; ++i)
+                    energy += static_cast<double>(data[i]) * data[i];
+                maxEnergy = std::max(maxEnergy, energy);
+            }
+
+            if (maxEnergy > 0.0)
+                ir.applyGain(static_cast<float>(1.0 / std::sqrt(maxEnergy)));
+        }
+    }
+}
+
+//==============================================================================
+// Kernel - partitioned IR spectra, shared read-only between instances
+//==============================================================================
+
+class ConvolutionEngine::Kernel
+{
+public:
+    struct Stage
+    {
+        int blockSize = 0;
+        int offset = 0;             // First IR tap this stage covers
+        int numPartitions = 0;
+        bool onWorker = false;
+        std::unique_ptr<juce::dsp::FFT> fft;        // 2 * blockSize points
+        std::vector<std::vector<float>> spectra;    // [channel] numPartitions spectra back to back
+
+        int getSpectrumSize() const { return 2 * blockSize + 2; }  // blockSize + 1 complex bins
+    };
+
+    int length = 0;
+    int numChannels = 0;
+    std::vector<std::vector<float>> direct;     // [channel] first DIRECT_TAPS taps, reversed
+    std::vector<Stage> stages;
+};
+
+ConvolutionEngine::KernelPtr ConvolutionEngine::createKernel(const juce::AudioBuffer<float>& ir)
+{
+    const int length = ir.getNumSamples();
+    const int numChannels = std::min(ir.getNumChannels(), MAX_CHANNELS);
+
+    if (length <= 0 || numChannels <= 0)
+        return nullptr;
+
+    auto kernel = std::make_shared<Kernel>();
+    kernel->length = length;
+    kernel->numChannels = numChannels;
+
+    kernel->direct.assign(static_cast<size_t>(numChannels), std::vector<float>(DIRECT_TAPS, 0.0f));
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int k = 0; k < std::min(length, DIRECT_TAPS); ++k)
+            kernel->direct[static_cast<size_t>(ch)][static_cast<size_t>(DIRECT_TAPS - 1 - k)] = ir.getSample(ch, k);
+    }
+
+    int offset = DIRECT_TAPS;
+    for (int s = 0; offset < length; ++s)
+    {
+        const int sizeIndex = std::min(s, NUM_STAGE_SIZES - 1);
+        const int blockSize = STAGE_SIZES[sizeIndex];
+
+        // Cover the IR up to where the next size may start, or to its end
+        int numPartitions = ceilDiv(length - offset, blockSize);
+        if (sizeIndex < NUM_STAGE_SIZES - 1)
+        {
+            const int nextSize = STAGE_SIZES[sizeIndex + 1];
+            const int nextOffset = nextSize * (nextSize >= MIN_WORKER_BLOCK ? 2 : 1);
+            if (length > nextOffset)
+                numPartitions = (nextOffset - offset) / blockSize;
+        }
+
+        Kernel::Stage stage;
+        stage.blockSize = blockSize;
+        stage.offset = offset;
+        stage.numPartitions = numPartitions;
+        stage.onWorker = blockSize >= MIN_WORKER_BLOCK;
+        stage.fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(2 * blockSize)));
+
+        std::vector<float> work(static_cast<size_t>(4 * blockSize), 0.0f);
+
+        // Fold whatever scaling this FFT backend's round trip has into the spectra
+        work[0] = 1.0f;
+        stage.fft->performRealOnlyForwardTransform(work.data(), true);
+        stage.fft->performRealOnlyInverseTransform(work.data());
+        const float scale = std::abs(work[0]) > 1.0e-9f ? 1.0f / work[0] : 1.0f;
+
+        const int spectrumSize = stage.getSpectrumSize();
+        stage.spectra.assign(static_cast<size_t>(numChannels),
+                             std::vector<float>(static_cast<size_t>(numPartitions * spectrumSize), 0.0f));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int p = 0; p < numPartitions; ++p)
+            {
+                std::fill(work.begin(), work.end(), 0.0f);
+
+                const int start = offset + p * blockSize;
+                const int count = std::min(blockSize, length - start);
+                if (count > 0)
+                    std::memcpy(work.data(), ir.getReadPointer(ch, start), sizeof(float) * static_cast<size_t>(count));
+
+                stage.fft->performRealOnlyForwardTransform(work.data(), true);
+
+                auto* dest = stage.spectra[static_cast<size_t>(ch)].data() + p * spectrumSize;
+                juce::FloatVectorOperations::multiply(dest, work.data(), scale, spectrumSize);
+            }
+        }
+
+        offset += numPartitions * blockSize;
+        kernel->stages.push_back(std::move(stage));
+    }
+
+    return kernel;
+}
+
+//==============================================================================
+// Instance - one engine's running state for a kernel
+//==============================================================================
+
+class ConvolutionEngine::Instance
+{
+public:
+    /** A worker-stage block handed to the pool */
+    struct Job
+    {
+        enum State { Idle, Queued, Running, Done };
+
+        std::atomic<int> state{Idle};
+        Instance* owner = nullptr;
+        int stageIndex = 0;
+        int numChannels = 0;
+        juce::int64 resultStart = 0;
+    };
+
+    Instance(KernelPtr kernelToUse, Shared& sharedToUse);
+    ~Instance();
+
+    int getLength() const { return kernel != nullptr ? kernel->length : 0; }
+
+    void process(juce::AudioBuffer<float>& buffer, int numSamples);
+    void reset();
+
+    /** Worker thread entry - computes the queued block and marks it done */
+    void runJob(Job& job);
+
+private:
+    struct StageState
+    {
+        std::vector<std::vector<float>> history;    // [channel] numPartitions input spectra
+        int historyPosition = 0;
+        std::vector<float> work;                    // FFT scratch (4 * blockSize)
+        std::vector<float> accumulator;             // One spectrum
+        std::vector<std::vector<float>> window;     // [channel] last 2 * blockSize inputs
+        std::vector<std::vector<float>> result;     // [channel] blockSize outputs
+        std::unique_ptr<Job> job;                   // Worker stages only
+    };
+
+    KernelPtr kernel;
+    Shared& shared;
+
+    std::vector<StageState> stages;
+    std::vector<std::vector<float>> inputRing;      // [channel]
+    std::vector<std::vector<float>> outputRing;     // [channel] tail waiting to be played
+    std::vector<float> directInput;
+    std::vector<float> directOutput;
+    juce::int64 position = 0;
+
+    void computeStage(int stageIndex, int numChannels);
+    void fireStage(int stageIndex, int numChannels);
+    void finishJob(int stageIndex);
+};
+
+//==============================================================================
+// Shared - worker pool, IR loader thread and kernel cache
+//==============================================================================
+
+class ConvolutionEngine::Shared
+{
+public:
+    Shared()
+    {
+        queue.reserve(MAX_QUEUED_JOBS);
+
+        const int numWorkers = juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1);
+        for (int i = 0; i < numWorkers; ++i)
+            workers.push_back(std::make_unique<Worker>(*this, i + 1));
+    }
+
+    ~Shared()
+    {
+        // Loads may still be building instances that refer to us
+        loader.removeAllJobs(true, 10000);
+
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+        wake.signal();
+        workers.clear();
+    }
+
+    //==========================================================================
+    // Worker jobs
+
+    /** Queue a job (audio thread). If the queue is full it is computed when due. */
+    void enqueue(Instance::Job* job)
+    {
+        {
+            const juce::SpinLock::ScopedLockType sl(queueLock);
+            if (static_cast<int>(queue.size()) >= MAX_QUEUED_JOBS)
+                return;
+            queue.push_back(job);
+        }
+        wake.signal();
+    }
+
+    /** Drop a job from the queue and wait if a worker is running it */
+    void cancel(Instance::Job* job)
+    {
+        {
+            const juce::SpinLock::ScopedLockType sl(queueLock);
+            queue.erase(std::remove(queue.begin(), queue.end(), job), queue.end());
+        }
+
+        while (job->state.load(std::memory_order_acquire) == Instance::Job::Running)
+            std::this_thread::yield();
+    }
+
+    //==========================================================================
+    // Kernel cache
+
+    KernelPtr findKernel(const juce::String& key)
+    {
+        const juce::ScopedLock sl(cacheLock);
+        auto it = kernels.find(key);
+        return it != kernels.end() ? it->second.lock() : nullptr;
+    }
+
+    /** Add a kernel, or return the one someone else added for the key meanwhile */
+    KernelPtr addKernel(const juce::String& key, KernelPtr kernel)
+    {
+        const juce::ScopedLock sl(cacheLock);
+
+        for (auto it = kernels.begin(); it != kernels.end();)
+            it = it->second.expired() ? kernels.erase(it) : std::next(it);
+
+        auto& entry = kernels[key];
+        if (auto existing = entry.lock())
+            return existing;
+
+        entry = kernel;
+        return kernel;
+    }
+
+    int getNumKernels() const
+    {
+        const juce::ScopedLock sl(cacheLock);
+        int count = 0;
+        for (const auto& [key, kernel] : kernels)
+        {
+            if (!kernel.expired())
+                ++count;
+        }
+        return count;
+    }
+
+    juce::ThreadPool loader { juce::ThreadPoolOptions{}.withThreadName("Convolution IR Loader")
+                                                       .withNumberOfThreads(1) };
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(Shared& sharedToUse, int index)
+            : juce::Thread("Convolution Worker " + juce::String(index)), owner(sharedToUse)
+        {
+            // Realtime scheduling needs privileges we may not have
+            if (!startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(7)))
+                startThread(juce::Thread::Priority::high);
+        }
+
+        ~Worker() override { stopThread(2000); }
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                if (auto* job = owner.popJob())
+                    job->owner->runJob(*job);
+                else
+                    owner.wake.wait(100);
+            }
+        }
+
+    private:
+        Shared& owner;
+    };
+
+    Instance::Job* popJob()
+    {
+        Instance::Job* claimed = nullptr;
+        bool moreWaiting = false;
+
+        {
+            // Claiming under the lock means cancel() can't miss a job that
+            // has been taken off the queue but isn't Running yet
+            const juce::SpinLock::ScopedLockType sl(queueLock);
+            while (!queue.empty() && claimed == nullptr)
+            {
+                auto* job = queue.front();
+                queue.erase(queue.begin());
+
+                int expected = Instance::Job::Queued;
+                if (job->state.compare_exchange_strong(expected, Instance::Job::Running,
+                                                       std::memory_order_acq_rel))
+                    claimed = job;
+            }
+            moreWaiting = !queue.empty();
+        }
+
+        // Pass the wake-up on so other workers pick up the rest
+        if (moreWaiting)
+            wake.signal();
+
+        return claimed;
+    }
+
+    juce::SpinLock queueLock;
+    std::vector<Instance::Job*> queue;
+    juce::WaitableEvent wake;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    juce::CriticalSection cacheLock;
+    std::map<juce::String, std::weak_ptr<const Kernel>> kernels;
+};
+
+//==============================================================================
+// Instance implementation
+//==============================================================================
+
+ConvolutionEngine::Instance::Instance(KernelPtr kernelToUse, Shared& sharedToUse)
+    : kernel(std::move(kernelToUse)), shared(sharedToUse)
+{
+    if (kernel == nullptr)
+        return;
+
+    const int firstBlock = STAGE_SIZES[0];
+    int largestBlock = firstBlock;
+    int furthestReach = DIRECT_TAPS;
+
+    stages.resize(kernel->stages.size());
+    for (size_t s = 0; s < stages.size(); ++s)
+    {
+        const auto& stage = kernel->stages[s];
+        auto& state = stages[s];
+        const int spectrumSize = stage.getSpectrumSize();
+
+        state.history.assign(MAX_CHANNELS, std::vector<float>(static_cast<size_t>(stage.numPartitions * spectrumSize), 0.0f));
+        state.work.assign(static_cast<size_t>(4 * stage.blockSize), 0.0f);
+        state.accumulator.assign(static_cast<size_t>(spectrumSize), 0.0f);
+        state.window.assign(MAX_CHANNELS, std::vector<float>(static_cast<size_t>(2 * stage.blockSize), 0.0f));
+        state.result.assign(MAX_CHANNELS, std::vector<float>(static_cast<size_t>(stage.blockSize), 0.0f));
+
+        if (stage.onWorker)
+        {
+            state.job = std::make_unique<Job>();
+            state.job->owner = this;
+            state.job->stageIndex = static_cast<int>(s);
+        }
+
+        largestBlock = std::max(largestBlock, stage.blockSize);
+        furthestReach = std::max(furthestReach, stage.offset + stage.blockSize);
+    }
+
+    const int inputSize = juce::nextPowerOfTwo(std::max(2 * largestBlock, DIRECT_TAPS + firstBlock));
+    const int outputSize = juce::nextPowerOfTwo(furthestReach + firstBlock);
+
+    inputRing.assign(MAX_CHANNELS, std::vector<float>(static_cast<size_t>(inputSize), 0.0f));
+    outputRing.assign(MAX_CHANNELS, std::vector<float>(static_cast<size_t>(outputSize), 0.0f));
+    directInput.assign(static_cast<size_t>(DIRECT_TAPS - 1 + firstBlock), 0.0f);
+    directOutput.assign(static_cast<size_t>(firstBlock), 0.0f);
+}
+
+ConvolutionEngine::Instance::~Instance()
+{
+    for (auto& state : stages)
+    {
+        if (state.job)
+            shared.cancel(state.job.get());
+    }
+}
+
+void ConvolutionEngine::Instance::process(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    const int numChannels = std::min(buffer.getNumChannels(), MAX_CHANNELS);
+    if (kernel == nullptr || numChannels == 0)
+        return;
+
+    // Work in chunks that end on 64-sample boundaries, where stages fire
+    const int firstBlock = STAGE_SIZES[0];
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const int chunk = std::min(numSamples - done, firstBlock - static_cast<int>(position % firstBlock));
+
+        // Collect worker blocks whose output starts in this chunk
+        for (size_t s = 0; s < stages.size(); ++s)
+        {
+            auto* job = stages[s].job.get();
+            if (job != nullptr && job->state.load(std::memory_order_acquire) != Job::Idle
+                && job->resultStart < position + chunk)
+                finishJob(static_cast<int>(s));
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* io = buffer.getWritePointer(ch, done);
+            auto& input = inputRing[static_cast<size_t>(ch)];
+            auto& output = outputRing[static_cast<size_t>(ch)];
+
+            writeRing(input, position, chunk, io);
+
+            // Direct FIR over the first taps
+            readRing(input, position - (DIRECT_TAPS - 1), DIRECT_TAPS - 1 + chunk, directInput.data());
+
+            const auto& taps = kernel->direct[static_cast<size_t>(std::min(ch, kernel->numChannels - 1))];
+            juce::FloatVectorOperations::clear(directOutput.data(), chunk);
+            for (int k = 0; k < DIRECT_TAPS; ++k)
+            {
+                if (taps[static_cast<size_t>(k)] != 0.0f)
+                    juce::FloatVectorOperations::addWithMultiply(directOutput.data(), directInput.data() + k,
+                                                                 taps[static_cast<size_t>(k)], chunk);
+            }
+
+            // Plus whatever the partitioned stages have accumulated for now
+            const int size = static_cast<int>(output.size());
+            const int first = static_cast<int>(position & static_cast<juce::int64>(size - 1));
+            const int firstPart = std::min(chunk, size - first);
+
+            juce::FloatVectorOperations::add(io, directOutput.data(), output.data() + first, firstPart);
+            juce::FloatVectorOperations::clear(output.data() + first, firstPart);
+            if (chunk > firstPart)
+            {
+                juce::FloatVectorOperations::add(io + firstPart, directOutput.data() + firstPart,
+                                                 output.data(), chunk - firstPart);
+                juce::FloatVectorOperations::clear(output.data(), chunk - firstPart);
+            }
+        }
+
+        position += chunk;
+        done += chunk;
+
+        for (size_t s = 0; s < stages.size(); ++s)
+        {
+            if (position % kernel->stages[s].blockSize == 0)
+                fireStage(static_cast<int>(s), numChannels);
+        }
+    }
+}
+
+void ConvolutionEngine::Instance::fireStage(int stageIndex, int numChannels)
+{
+    const auto& stage = kernel->stages[static_cast<size_t>(stageIndex)];
+    auto& state = stages[static_cast<size_t>(stageIndex)];
+    const int blockSize = stage.blockSize;
+
+    // A worker block still outstanding is due no later than now
+    if (state.job && state.job->state.load(std::memory_order_acquire) != Job::Idle)
+        finishJob(stageIndex);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        readRing(inputRing[static_cast<size_t>(ch)], position - 2 * blockSize, 2 * blockSize,
+                 state.window[static_cast<size_t>(ch)].data());
+
+    // Output lands offset samples after the block's first input
+    const juce::int64 resultStart = position - blockSize + stage.offset;
+
+    if (state.job)
+    {
+        state.job->numChannels = numChannels;
+        state.job->resultStart = resultStart;
+        state.job->state.store(Job::Queued, std::memory_order_release);
+        shared.enqueue(state.job.get());
+        return;
+    }
+
+    computeStage(stageIndex, numChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        addToRing(outputRing[static_cast<size_t>(ch)], resultStart, blockSize, state.result[static_cast<size_t>(ch)].data());
+}
+
+void ConvolutionEngine::Instance::finishJob(int stageIndex)
+{
+    auto& state = stages[static_cast<size_t>(stageIndex)];
+    auto& job = *state.job;
+
+    // Compute it here if no worker has started it; otherwise wait for it
+    int expected = Job::Queued;
+    if (job.state.compare_exchange_strong(expected, Job::Running, std::memory_order_acq_rel))
+    {
+        computeStage(stageIndex, job.numChannels);
+        job.state.store(Job::Done, std::memory_order_release);
+    }
+    else
+    {
+        while (job.state.load(std::memory_order_acquire) != Job::Done)
+            std::this_thread::yield();
+    }
+
+    const int blockSize = kernel->stages[static_cast<size_t>(stageIndex)].blockSize;
+    for (int ch = 0; ch < job.numChannels; ++ch)
+        addToRing(outputRing[static_cast<size_t>(ch)], job.resultStart, blockSize, state.result[static_cast<size_t>(ch)].data());
+
+    job.state.store(Job::Idle, std::memory_order_release);
+}
+
+void ConvolutionEngine::Instance::runJob(Job& job)
+{
+    computeStage(job.stageIndex, job.numChannels);
+    job.state.store(Job::Done, std::memory_order_release);
+}
+
+void ConvolutionEngine::Instance::computeStage(int stageIndex, int numChannels)
+{
+    // Uniformly partitioned overlap-save over this stage's slice of the IR
+    const auto& stage = kernel->stages[static_cast<size_t>(stageIndex)];
+    auto& state = stages[static_cast<size_t>(stageIndex)];
+
+    const int blockSize = stage.blockSize;
+    const int spectrumSize = stage.getSpectrumSize();
+    const int numPartitions = stage.numPartitions;
+    auto* work = state.work.data();
+    auto* accumulator = state.accumulator.data();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        juce::FloatVectorOperations::copy(work, state.window[static_cast<size_t>(ch)].data(), 2 * blockSize);
+        juce::FloatVectorOperations::clear(work + 2 * blockSize, 2 * blockSize);
+        stage.fft->performRealOnlyForwardTransform(work, true);
+
+        auto& history = state.history[static_cast<size_t>(ch)];
+        juce::FloatVectorOperations::copy(history.data() + state.historyPosition * spectrumSize, work, spectrumSize);
+
+        const auto& spectra = stage.spectra[static_cast<size_t>(std::min(ch, kernel->numChannels - 1))];
+        juce::FloatVectorOperations::clear(accumulator, spectrumSize);
+
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            const int slot = (state.historyPosition - p + numPartitions) % numPartitions;
+            multiplyAccumulate(accumulator, history.data() + slot * spectrumSize,
+                               spectra.data() + p * spectrumSize, blockSize + 1);
+        }
+
+        juce::FloatVectorOperations::copy(work, accumulator, spectrumSize);
+        juce::FloatVectorOperations::clear(work + spectrumSize, 4 * blockSize - spectrumSize);
+        stage.fft->performRealOnlyInverseTransform(work);
+
+        // Second half is the valid linear convolution
+        juce::FloatVectorOperations::copy(state.result[static_cast<size_t>(ch)].data(), work + blockSize, blockSize);
+    }
+
+    state.historyPosition = (state.historyPosition + 1) % numPartitions;
+}
+
+void ConvolutionEngine::Instance::reset()
+{
+    for (size_t s = 0; s < stages.size(); ++s)
+    {
+        if (stages[s].job && stages[s].job->state.load(std::memory_order_acquire) != Job::Idle)
+            finishJob(static_cast<int>(s));
+
+        stages[s].historyPosition = 0;
+        for (auto& history : stages[s].history)
+            std::fill(history.begin(), history.end(), 0.0f);
+    }
+
+    for (auto& ring : inputRing)
+        std::fill(ring.begin(), ring.end(), 0.0f);
+    for (auto& ring : outputRing)
+        std::fill(ring.begin(), ring.end(), 0.0f);
+
+    position = 0;
+}
+
+//==============================================================================
+// ConvolutionEngine
+//==============================================================================
+
+struct ConvolutionEngine::LoadState
+{
+    juce::CriticalSection lock;
+    ConvolutionEngine* owner = nullptr;     // Cleared when the engine goes away
+    std::atomic<int> latestRequest{0};
+    std::atomic<int> completedRequest{0};
+};
+
+ConvolutionEngine::ConvolutionEngine()
+    : loadState(std::make_shared<LoadState>())
+{
+    loadState->owner = this;
+}
+
+ConvolutionEngine::~ConvolutionEngine()
+{
+    {
+        const juce::ScopedLock sl(loadState->lock);
+        loadState->owner = nullptr;
+    }
+
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+    delete current;
+    current = nullptr;
+}
+
+//==============================================================================
+// Loading
+
+void ConvolutionEngine::loadImpulseResponse(const juce::File& file, double sampleRate, bool normalise)
+{
+    const auto key = file.getFullPathName() + ":" + juce::String(file.getLastModificationTime().toMilliseconds());
+
+    loadImpulseResponse([file](juce::AudioBuffer<float>& ir, double& irSampleRate)
+                        {
+                            return readImpulseResponse(file, ir, irSampleRate);
+                        },
+                        sampleRate, normalise, key);
+}
+
+void ConvolutionEngine::loadImpulseResponse(Source source, double sampleRate, bool normalise,
+                                            const juce::String& cacheKey)
+{
+    const int request = ++loadState->latestRequest;
+    auto state = loadState;
+    auto* sharedObject = &shared.get();
+
+    const auto key = cacheKey.isEmpty() ? juce::String()
+                                        : cacheKey + "@" + juce::String(sampleRate) + (normalise ? ":n" : ":r");
+
+    shared->loader.addJob([state, request, sharedObject, source = std::move(source), sampleRate, normalise, key]
+    {
+        // Superseded before it started
+        if (state->latestRequest.load() != request)
+            return;
+
+        KernelPtr kernel = key.isNotEmpty() ? sharedObject->findKernel(key) : nullptr;
+
+        if (kernel == nullptr)
+        {
+            juce::AudioBuffer<float> ir;
+            double irSampleRate = sampleRate;
+
+            if (source && source(ir, irSampleRate))
+            {
+                prepareImpulseResponse(ir, irSampleRate, sampleRate, normalise);
+                kernel = createKernel(ir);
+
+                if (kernel != nullptr && key.isNotEmpty())
+                    kernel = sharedObject->addKernel(key, kernel);
+            }
+        }
+
+        std::unique_ptr<Instance> instance;
+        if (kernel != nullptr)
+            instance = std::make_unique<Instance>(kernel, *sharedObject);
+
+        const juce::ScopedLock sl(state->lock);
+
+        // A failed load keeps the previous IR
+        if (state->owner != nullptr && instance != nullptr && state->latestRequest.load() == request)
+            state->owner->publish(instance.release());
+
+        state->completedRequest.store(request);
+    });
+}
+
+void ConvolutionEngine::clearImpulseResponse()
+{
+    setKernel(nullptr);
+}
+
+void ConvolutionEngine::setKernel(KernelPtr kernel)
+{
+    auto instance = std::make_unique<Instance>(std::move(kernel), shared.get());
+
+    const juce::ScopedLock sl(loadState->lock);
+
+    // Supersede any load still in flight
+    const int request = ++loadState->latestRequest;
+    publish(instance.release());
+    loadState->completedRequest.store(request);
+}
+
+bool ConvolutionEngine::isLoading() const
+{
+    return loadState->latestRequest.load() != loadState->completedRequest.load();
+}
+
+bool ConvolutionEngine::readImpulseResponse(const juce::File& file, juce::AudioBuffer<float>& ir, double& irSampleRate)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->sampleRate <= 0.0)
+        return false;
+
+    const auto length = std::min(reader->lengthInSamples,
+                                 static_cast<juce::int64>(MAX_IR_SECONDS * reader->sampleRate));
+    if (length <= 0)
+        return false;
+
+    const int numChannels = std::min(static_cast<int>(reader->numChannels), MAX_CHANNELS);
+    ir.setSize(numChannels, static_cast<int>(length));
+    reader->read(&ir, 0, static_cast<int>(length), 0, true, numChannels > 1);
+
+    irSampleRate = reader->sampleRate;
+    return true;
+}
+
+int ConvolutionEngine::getNumCachedKernels()
+{
+    juce::SharedResourcePointer<Shared> sharedObject;
+    return sharedObject->getNumKernels();
+}
+
+//==============================================================================
+// Handoff
+
+void ConvolutionEngine::publish(Instance* instance)
+{
+    // Called with the load lock held, never on the audio thread
+    releaseRetired();
+
+    publishedLength.store(instance != nullptr ? instance->getLength() : 0);
+    delete pending.exchange(instance, std::memory_order_acq_rel);
+}
+
+void ConvolutionEngine::releaseRetired()
+{
+    // Waits for any worker still computing one of its blocks
+    delete retired.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void ConvolutionEngine::adoptPending()
+{
+    if (pending.load(std::memory_order_acquire) == nullptr
+        || retired.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    if (auto* next = pending.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        retired.store(current, std::memory_order_release);
+        current = next;
+    }
+}
+
+//==============================================================================
+// Processing
+
+void ConvolutionEngine::process(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    adoptPending();
+
+    if (current == nullptr)
+        return;
+
+    if (resetRequested.exchange(false))
+        current->reset();
+
+    current->process(buffer, numSamples);
+}
+
+void ConvolutionEngine::reset()
+{
+    // Done by the audio thread at the start of its next block
+    resetRequested.store(true);
+}
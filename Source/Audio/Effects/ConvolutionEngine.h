@@ -0,0 +1,113 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * ConvolutionEngine - Zero-latency partitioned FFT convolution
+ *
+ * The impulse response is split non-uniformly: the first DIRECT_TAPS taps are
+ * applied as a plain FIR, then come partitions of 64, 256, 1024, 4096 and
+ * 16384 samples. Each block size starts late enough in the IR that its FFT
+ * result isn't due until after its input block is complete, so nothing is
+ * delayed. The FIR and the 64/256 stages run on the audio thread. Larger
+ * stages are handed to a shared pool of worker threads and always have at
+ * least one of their own block lengths to finish; if a worker falls behind,
+ * the audio thread computes the block itself when it is due.
+ *
+ * Kernels (the partitioned IR spectra) are immutable and shared between
+ * engines that load the same source at the same rate, so many tracks using
+ * one cabinet IR keep a single copy. IRs are decoded, resampled and
+ * partitioned on a background thread; the audio thread swaps to the new one
+ * at the start of a block.
+ */
+class ConvolutionEngine
+{
+public:
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int DIRECT_TAPS = 64;
+    static constexpr double MAX_IR_SECONDS = 20.0;
+
+    class Kernel;
+    using KernelPtr = std::shared_ptr<const Kernel>;
+
+    /** Produces an IR on the loader thread (returns false on failure) */
+    using Source = std::function<bool(juce::AudioBuffer<float>& ir, double& irSampleRate)>;
+
+    ConvolutionEngine();
+    ~ConvolutionEngine();
+
+    //==========================================================================
+    // Loading (message thread) - the work happens on the loader thread
+
+    /** Load an IR file (WAV, AIFF, FLAC...) resampled to sampleRate */
+    void loadImpulseResponse(const juce::File& file, double sampleRate, bool normalise = true);
+
+    /**
+     * Load an IR from a custom source. Sources with the same non-empty
+     * cacheKey at the same rate share one kernel.
+     */
+    void loadImpulseResponse(Source source, double sampleRate, bool normalise = true,
+                             const juce::String& cacheKey = {});
+
+    /** Stop convolving (the next block passes audio through) */
+    void clearImpulseResponse();
+
+    /** True while a requested IR hasn't been published yet */
+    bool isLoading() const;
+
+    /** Length in samples of the most recently published IR (0 = none) */
+    int getImpulseResponseLength() const { return publishedLength.load(); }
+    bool hasImpulseResponse() const { return getImpulseResponseLength() > 0; }
+
+    //==========================================================================
+    // Kernels
+
+    /** Partition an IR that is already at the processing rate */
+    static KernelPtr createKernel(const juce::AudioBuffer<float>& ir);
+
+    /** Decode an IR file into ir (all channels, file rate) */
+    static bool readImpulseResponse(const juce::File& file, juce::AudioBuffer<float>& ir, double& irSampleRate);
+
+    /** Kernels currently shared through the cache (for tests / diagnostics) */
+    static int getNumCachedKernels();
+
+    /** Publish a ready-made kernel (any thread but the audio thread) */
+    void setKernel(KernelPtr kernel);
+
+    //==========================================================================
+    // Processing (audio thread)
+
+    /** Convolve the first numSamples of up to MAX_CHANNELS channels in place */
+    void process(juce::AudioBuffer<float>& buffer, int numSamples);
+
+    /** Clear the tail and input history */
+    void reset();
+
+private:
+    class Instance;
+    class Shared;
+    struct LoadState;
+
+    juce::SharedResourcePointer<Shared> shared;
+    std::shared_ptr<LoadState> loadState;
+
+    // Handoff: loader publishes to pending, the audio thread adopts it if it
+    // can hand its old instance back through retired
+    Instance* current = nullptr;            // Audio thread only
+    std::atomic<Instance*> pending{nullptr};
+    std::atomic<Instance*> retired{nullptr};
+    std::atomic<bool> resetRequested{false};
+
+    std::atomic<int> publishedLength{0};
+
+    void publish(Instance* instance);
+    void releaseRetired();
+    void adoptPending();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionEngine)
+};
@@ -0,0 +1,226 @@
+#include "ConvolutionReverbEffect.h"
+#include <cmath>
+
+namespace
+{
+    // Stereo noise tail, decaying to -60 dB after decaySeconds and ending at -72 dB
+    juce::AudioBuffer<float> generateImpulseResponse(double sampleRate, float decaySeconds, float damping)
+    {
+        const int length = static_cast<int>(std::ceil(decaySeconds * 1.2 * sampleRate));
+        juce::AudioBuffer<float> ir(2, length);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            // Fixed seeds so every instance (and the cache) gets the same IR
+            juce::Random random(0x5eed + ch);
+            auto* data = ir.getWritePointer(ch);
+            float lowpassed = 0.0f;
+
+            for (int i = 0; i < length; ++i)
+            {
+                const float t = static_cast<float>(i / sampleRate);
+                const float envelope = std::exp(-6.9078f * t / decaySeconds);
+
+                // Highs die away faster - the one-pole closes over the decay
+                const float closing = damping * std::min(1.0f, t / decaySeconds);
+                const float coefficient = 1.0f - 0.97f * closing;
+
+                lowpassed += coefficient * ((random.nextFloat() * 2.0f - 1.0f) - lowpassed);
+                data[i] = lowpassed * envelope;
+            }
+        }
+
+        return ir;
+    }
+}
+
+ConvolutionReverbEffect::ConvolutionReverbEffect()
+{
+    addParameter("decay", "Decay", 2.0f, 0.2f, 10.0f, "s");
+    addParameter("damping", "Damping", 0.5f, 0.0f, 1.0f);
+    addParameter("predelay", "Pre-delay", 10.0f, 0.0f, 200.0f, "ms");
+    addParameter("width", "Width", 1.0f, 0.0f, 1.0f);
+}
+
+void ConvolutionReverbEffect::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
+{
+    EffectBase::prepareToPlay(newSampleRate, newSamplesPerBlock);
+
+    prepared = true;
+    if (sampleRate != irSampleRate)
+        requestImpulseResponse();
+}
+
+void ConvolutionReverbEffect::releaseResources()
+{
+    EffectBase::releaseResources();
+    convolution.reset();
+}
+
+void ConvolutionReverbEffect::reset()
+{
+    EffectBase::reset();
+    convolution.reset();
+}
+
+void ConvolutionReverbEffect::copyStateFrom(const EffectBase& other)
+{
+    EffectBase::copyStateFrom(other);
+
+    const auto& source = static_cast<const ConvolutionReverbEffect&>(other);
+    if (source.irFile != irFile)
+        loadImpulseResponse(source.irFile);
+}
+
+//==============================================================================
+// Impulse response
+
+void ConvolutionReverbEffect::loadImpulseResponse(const juce::File& file)
+{
+    irFile = file;
+    requestImpulseResponse();
+}
+
+void ConvolutionReverbEffect::useBuiltInImpulseResponse()
+{
+    irFile = juce::File();
+    requestImpulseResponse();
+}
+
+void ConvolutionReverbEffect::requestImpulseResponse()
+{
+    // Kernels are built for the prepared rate
+    if (!prepared)
+        return;
+
+    irSampleRate = sampleRate;
+
+    const auto file = irFile;
+    const float decay = getParameter("decay");
+    const float damping = getParameter("damping");
+    const float predelayMs = getParameter("predelay");
+
+    juce::String key = file == juce::File()
+        ? "builtin:" + juce::String(decay) + ":" + juce::String(damping)
+        : file.getFullPathName() + ":" + juce::String(file.getLastModificationTime().toMilliseconds());
+    key << ":" << predelayMs;
+
+    const double rate = sampleRate;
+
+    // Runs on the loader thread
+    convolution.loadImpulseResponse([file, decay, damping, predelayMs, rate](juce::AudioBuffer<float>& ir, double& irRate)
+    {
+        if (file == juce::File())
+        {
+            ir = generateImpulseResponse(rate, decay, damping);
+            irRate = rate;
+        }
+        else if (!ConvolutionEngine::readImpulseResponse(file, ir, irRate))
+        {
+            return false;
+        }
+
+        const int predelay = static_cast<int>(predelayMs * 0.001 * irRate);
+        if (predelay > 0)
+        {
+            juce::AudioBuffer<float> delayed(ir.getNumChannels(), ir.getNumSamples() + predelay);
+            delayed.clear(0, predelay);
+            for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+                delayed.copyFrom(ch, predelay, ir, ch, 0, ir.getNumSamples());
+            ir = std::move(delayed);
+        }
+        return true;
+    },
+    rate, true, key);
+}
+
+//==============================================================================
+// Processing
+
+void ConvolutionReverbEffect::processEffect(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    // The wet signal is the reverb alone - nothing until an IR is ready
+    if (!convolution.hasImpulseResponse())
+    {
+        buffer.clear();
+        return;
+    }
+
+    convolution.process(buffer, numSamples);
+
+    const float w = width.load();
+    if (buffer.getNumChannels() >= 2 && w < 1.0f)
+    {
+        auto* left = buffer.getWritePointer(0);
+        auto* right = buffer.getWritePointer(1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float mid = 0.5f * (left[i] + right[i]);
+            const float side = 0.5f * (left[i] - right[i]) * w;
+            left[i] = mid + side;
+            right[i] = mid - side;
+        }
+    }
+}
+
+void ConvolutionReverbEffect::onParameterChanged(const juce::String& name, float value)
+{
+    if (name == "width")
+    {
+        width.store(value);
+    }
+    else if (name == "predelay" || (irFile == juce::File() && (name == "decay" || name == "damping")))
+    {
+        // Rapid changes supersede each other on the loader thread
+        requestImpulseResponse();
+    }
+}
+
+int ConvolutionReverbEffect::getTailSamples() const
+{
+    // The IR already includes the pre-delay
+    return convolution.getImpulseResponseLength();
+}
+
+std::vector<EffectPreset> ConvolutionReverbEffect::getPresets() const
+{
+    std::vector<EffectPreset> presets;
+
+    {
+        EffectPreset p;
+        p.name = "Small Room";
+        p.values["decay"] = 0.6f;
+        p.values["damping"] = 0.7f;
+        p.values["predelay"] = 5.0f;
+        p.values["width"] = 0.8f;
+        p.values["wet"] = 0.3f;
+        presets.push_back(p);
+    }
+
+    {
+        EffectPreset p;
+        p.name = "Large Hall";
+        p.values["decay"] = 3.5f;
+        p.values["damping"] = 0.4f;
+        p.values["predelay"] = 25.0f;
+        p.values["width"] = 1.0f;
+        p.values["wet"] = 0.35f;
+        presets.push_back(p);
+    }
+
+    {
+        EffectPreset p;
+        p.name = "Cathedral";
+        p.values["decay"] = 8.0f;
+        p.values["damping"] = 0.3f;
+        p.values["predelay"] = 40.0f;
+        p.values["width"] = 1.0f;
+        p.values["wet"] = 0.4f;
+        presets.push_back(p);
+    }
+
+    return presets;
+}
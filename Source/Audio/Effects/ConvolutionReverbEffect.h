@@ -0,0 +1,63 @@
+#pragma once
+
+#include "EffectBase.h"
+#include "ConvolutionEngine.h"
+#include <atomic>
+
+/**
+ * ConvolutionReverbEffect - Reverb by convolution with a room impulse response
+ *
+ * Uses a loaded IR file, or a built-in IR (decorrelated stereo noise with an
+ * exponential decay whose highs die away faster as damping goes up). IRs are
+ * prepared in the background; instances with the same settings share one
+ * kernel.
+ *
+ * Parameters:
+ * - decay: Built-in IR decay time to -60 dB in seconds (0.2-10)
+ * - damping: Built-in IR high frequency damping (0-1)
+ * - predelay: Silence before the IR in ms (0-200, also applies to files)
+ * - width: Stereo width of the reverb (0-1)
+ */
+class ConvolutionReverbEffect : public EffectBase
+{
+public:
+    ConvolutionReverbEffect();
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    void reset() override;
+
+    juce::String getName() const override { return "Convolution Reverb"; }
+    juce::String getCategory() const override { return "Space"; }
+
+    std::vector<EffectPreset> getPresets() const override;
+
+    int getTailSamples() const override;
+
+    void copyStateFrom(const EffectBase& other) override;
+    bool isLoading() const override { return isImpulseResponseLoading(); }
+
+    //==========================================================================
+    // Impulse response (message thread)
+    void loadImpulseResponse(const juce::File& file);
+    void useBuiltInImpulseResponse();
+    const juce::File& getImpulseResponseFile() const { return irFile; }
+    bool isImpulseResponseLoading() const { return convolution.isLoading(); }
+    int getImpulseResponseLength() const { return convolution.getImpulseResponseLength(); }
+
+protected:
+    void processEffect(juce::AudioBuffer<float>& buffer) override;
+    void onParameterChanged(const juce::String& name, float value) override;
+
+private:
+    ConvolutionEngine convolution;
+    juce::File irFile;              // Empty = built-in IR
+    bool prepared = false;
+    double irSampleRate = 0.0;      // Rate the current IR was requested for
+
+    std::atomic<float> width{1.0f};
+
+    void requestImpulseResponse();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionReverbEffect)
+};
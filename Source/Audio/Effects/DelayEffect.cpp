@@ -107,6 +107,13 @@ void DelayEffect::onParameterChanged(const juce::String& name, float value)
         pingPong = value > 0.5f;
 }
 
+int DelayEffect::getTailSamples() const
+{
+    // Every repeat until the feedback has taken it below the silence threshold
+    const float repeats = feedback > 0.0f ? std::ceil(std::log(SILENCE_THRESHOLD) / std::log(feedback)) : 0.0f;
+    return static_cast<int>(getParameter("delayTime") * 0.001f * (repeats + 1.0f) * static_cast<float>(sampleRate));
+}
+
 std::vector<EffectPreset> DelayEffect::getPresets() const
 {
     std::vector<EffectPreset> presets;
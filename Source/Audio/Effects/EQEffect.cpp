@@ -14,31 +14,25 @@ EQEffect::EQEffect()
     // High band
     addParameter("highFreq", "High Freq", 8000.0f, 2000.0f, 16000.0f, "Hz");
     addParameter("highGain", "High Gain", 0.0f, -12.0f, 12.0f, "dB");
+
+    // 0 = minimum phase, 1 = linear phase
+    addParameter("phase", "Phase", 0.0f, 0.0f, 1.0f, "", 1.0f);
 }
 
 void EQEffect::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 {
     EffectBase::prepareToPlay(newSampleRate, newSamplesPerBlock);
 
-    lowShelfL.reset();
-    lowShelfR.reset();
-    midPeakL.reset();
-    midPeakR.reset();
-    highShelfL.reset();
-    highShelfR.reset();
-
+    filters.prepare(2);
+    linearPhase.prepare(sampleRate, 2);
     updateFilters();
 }
 
 void EQEffect::reset()
 {
     EffectBase::reset();
-    lowShelfL.reset();
-    lowShelfR.reset();
-    midPeakL.reset();
-    midPeakR.reset();
-    highShelfL.reset();
-    highShelfR.reset();
+    filters.reset();
+    linearPhase.reset();
 }
 
 void EQEffect::updateFilters()
@@ -53,51 +47,42 @@ void EQEffect::updateFilters()
     float highFreq = getParameter("highFreq");
     float highGain = getParameter("highGain");
 
-    // Low shelf
-    auto lowCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-        sampleRate, lowFreq, 0.707f, juce::Decibels::decibelsToGain(lowGain));
-    lowShelfL.coefficients = lowCoeffs;
-    lowShelfR.coefficients = lowCoeffs;
-
-    // Mid peak
-    auto midCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate, midFreq, midQ, juce::Decibels::decibelsToGain(midGain));
-    midPeakL.coefficients = midCoeffs;
-    midPeakR.coefficients = midCoeffs;
-
-    // High shelf
-    auto highCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        sampleRate, highFreq, 0.707f, juce::Decibels::decibelsToGain(highGain));
-    highShelfL.coefficients = highCoeffs;
-    highShelfR.coefficients = highCoeffs;
+    const auto low = BiquadCascade::Coefficients::lowShelf(sampleRate, lowFreq, 0.707f, lowGain);
+    const auto mid = BiquadCascade::Coefficients::peak(sampleRate, midFreq, midQ, midGain);
+    const auto high = BiquadCascade::Coefficients::highShelf(sampleRate, highFreq, 0.707f, highGain);
+
+    filters.setStage(0, low);
+    filters.setStage(1, mid);
+    filters.setStage(2, high);
+
+    // No point designing kernels nobody hears
+    linearPhaseMode.store(getParameter("phase") >= 0.5f);
+    if (linearPhaseMode.load())
+        linearPhase.setBands({ low, mid, high });
 }
 
-void EQEffect::processEffect(juce::AudioBuffer<float>& buffer)
+int EQEffect::getLatencySamples() const
 {
-    const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+    return getParameter("phase") >= 0.5f ? linearPhase.getLatencySamples() : 0;
+}
 
-    if (numChannels >= 1)
+void EQEffect::processEffect(juce::AudioBuffer<float>& buffer)
+{
+    const bool linear = linearPhaseMode.load();
+    if (linear != processingLinearPhase)
     {
-        float* dataL = buffer.getWritePointer(0);
-        for (int i = 0; i < numSamples; ++i)
-        {
-            dataL[i] = lowShelfL.processSample(dataL[i]);
-            dataL[i] = midPeakL.processSample(dataL[i]);
-            dataL[i] = highShelfL.processSample(dataL[i]);
-        }
+        // The path being switched to still holds state from when it last ran
+        if (linear)
+            linearPhase.reset();
+        else
+            filters.reset();
+        processingLinearPhase = linear;
     }
 
-    if (numChannels >= 2)
-    {
-        float* dataR = buffer.getWritePointer(1);
-        for (int i = 0; i < numSamples; ++i)
-        {
-            dataR[i] = lowShelfR.processSample(dataR[i]);
-            dataR[i] = midPeakR.processSample(dataR[i]);
-            dataR[i] = highShelfR.processSample(dataR[i]);
-        }
-    }
+    if (linear)
+        linearPhase.process(buffer, buffer.getNumSamples());
+    else
+        filters.process(buffer, buffer.getNumSamples());
 }
 
 void EQEffect::onParameterChanged(const juce::String& name, float value)
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "EffectBase.h"
+#include "BiquadCascade.h"
+#include "LinearPhaseEQ.h"
+#include <atomic>
 
 /**
  * EQEffect - 3-band parametric EQ
@@ -10,7 +13,10 @@
  * - Mid peak (200-8000 Hz, Q adjustable)
  * - High shelf (2000-16000 Hz)
  *
- * Each band has gain in dB (-12 to +12)
+ * Each band has gain in dB (-12 to +12). The bands run as one stereo
+ * BiquadCascade, so both channels share each filter update. With phase set
+ * to linear, the same curves run through a LinearPhaseEQ instead (no phase
+ * shift, reported latency).
  */
 class EQEffect : public EffectBase
 {
@@ -25,15 +31,21 @@ public:
 
     std::vector<EffectPreset> getPresets() const override;
 
+    int getLatencySamples() const override;
+
+    /** True while a linear phase redesign hasn't reached the audio thread yet */
+    bool isUpdatingLinearPhase() const { return linearPhase.isDesigning(); }
+
 protected:
     void processEffect(juce::AudioBuffer<float>& buffer) override;
     void onParameterChanged(const juce::String& name, float value) override;
 
 private:
-    // Three filter bands per channel
-    juce::dsp::IIR::Filter<float> lowShelfL, lowShelfR;
-    juce::dsp::IIR::Filter<float> midPeakL, midPeakR;
-    juce::dsp::IIR::Filter<float> highShelfL, highShelfR;
+    // Low shelf, mid peak, high shelf
+    BiquadCascade filters;
+    LinearPhaseEQ linearPhase;
+    std::atomic<bool> linearPhaseMode{false};
+    bool processingLinearPhase = false;     // Audio thread
 
     void updateFilters();
 
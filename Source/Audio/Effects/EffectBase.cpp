@@ -20,6 +20,31 @@ void EffectBase::processBlock(juce::AudioBuffer<float>& buffer)
     if (bypassed)
         return; // Bypassed - leave buffer unchanged
 
+    const int numSamples = buffer.getNumSamples();
+    const bool inputSilent = isSilent(buffer, numSamples);
+
+    // Asleep: silence in, silence out
+    if (inputSilent && sleeping)
+        return;
+
+    sleeping = false;
+    processWetDry(buffer);
+
+    if (inputSilent)
+    {
+        // Sleep once the tail is over and nothing is coming out any more
+        silentSamples += numSamples;
+        sleeping = silentSamples > static_cast<juce::int64>(getTailSamples()) + getLatencySamples()
+                && isSilent(buffer, numSamples);
+    }
+    else
+    {
+        silentSamples = 0;
+    }
+}
+
+void EffectBase::processWetDry(juce::AudioBuffer<float>& buffer)
+{
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
 
@@ -58,6 +83,18 @@ void EffectBase::processBlock(juce::AudioBuffer<float>& buffer)
     }
 }
 
+bool EffectBase::isSilent(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    numSamples = juce::jmin(numSamples, buffer.getNumSamples());
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (buffer.getMagnitude(ch, 0, numSamples) >= SILENCE_THRESHOLD)
+            return false;
+    }
+    return true;
+}
+
 void EffectBase::releaseResources()
 {
     dryBuffer.setSize(0, 0);
@@ -66,6 +103,8 @@ void EffectBase::releaseResources()
 void EffectBase::reset()
 {
     dryBuffer.clear();
+    sleeping = false;
+    silentSamples = 0;
 }
 
 //==============================================================================
@@ -75,11 +114,13 @@ void EffectBase::setWetDry(float wet)
 {
     wetAmount = juce::jlimit(0.0f, 1.0f, wet);
     parameters["wet"].value = wetAmount;
+    ++editVersion;
 }
 
 void EffectBase::setBypass(bool shouldBypass)
 {
     bypassed = shouldBypass;
+    ++editVersion;
 }
 
 //==============================================================================
@@ -119,6 +160,7 @@ void EffectBase::setParameter(const juce::String& name, float value)
         wetAmount = value;
     }
 
+    ++editVersion;
     onParameterChanged(name, value);
 }
 
@@ -145,6 +187,19 @@ std::vector<juce::String> EffectBase::getParameterNames() const
     return names;
 }
 
+//==============================================================================
+// Copying
+
+void EffectBase::copyStateFrom(const EffectBase& other)
+{
+    jassert(other.getName() == getName());
+
+    for (const auto& [id, param] : other.parameters)
+        setParameter(id, param.value);
+
+    setBypass(other.bypassed);
+}
+
 //==============================================================================
 // Presets
 
@@ -2,6 +2,7 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -85,6 +86,9 @@ public:
     const EffectParameter* getParameterInfo(const juce::String& name) const;
     std::vector<juce::String> getParameterNames() const;
 
+    // Bumped by every parameter, wet/dry or bypass change
+    juce::uint32 getEditVersion() const { return editVersion.load(); }
+
     //==========================================================================
     // Presets
     virtual std::vector<EffectPreset> getPresets() const { return {}; }
@@ -96,6 +100,51 @@ public:
     virtual juce::String getName() const = 0;
     virtual juce::String getCategory() const { return "Effect"; }
 
+    //==========================================================================
+    // Copying (message thread)
+
+    // Take on other's settings - parameters, wet/dry and bypass, plus whatever
+    // else a subclass keeps outside its parameters. other is the same effect.
+    virtual void copyStateFrom(const EffectBase& other);
+
+    // True while the effect is still building something in the background
+    // (an impulse response, a filter kernel) that its output depends on
+    virtual bool isLoading() const { return false; }
+
+    //==========================================================================
+    // Silence
+    //
+    // Once the input has been silent for longer than the tail (plus latency)
+    // and the output has died away, processBlock() skips the effect until
+    // non-silent input arrives - it wakes on the very block that carries it.
+
+    // Samples of output the effect can still produce after its input goes
+    // silent (reverb decay, delay repeats, modulation delay lines)
+    virtual int getTailSamples() const { return 0; }
+
+    // True while asleep (audio thread)
+    bool isSleeping() const { return sleeping; }
+
+    // Peak of every channel below SILENCE_THRESHOLD (around -120 dBFS)
+    static constexpr float SILENCE_THRESHOLD = 1.0e-6f;
+    static bool isSilent(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    //==========================================================================
+    // Latency
+
+    // Samples by which the wet signal lags the input (for delay compensation).
+    // The dry path isn't delayed, so mixing wet and dry on such effects combs.
+    virtual int getLatencySamples() const { return 0; }
+
+    //==========================================================================
+    // Sidechain (for effects keyed by another track)
+
+    // Track index whose output keys this effect, or -1 for none
+    virtual int getSidechainSource() const { return -1; }
+
+    // Key signal for the next processBlock() (audio thread)
+    virtual void setSidechainInput(const juce::AudioBuffer<float>& /*buffer*/) {}
+
 protected:
     // Parameters storage
     std::map<juce::String, EffectParameter> parameters;
@@ -120,8 +169,16 @@ private:
     float wetAmount = 1.0f;
     bool bypassed = false;
 
+    std::atomic<juce::uint32> editVersion{0};
+
     // Dry buffer for wet/dry mixing
     juce::AudioBuffer<float> dryBuffer;
 
+    // Silence tracking (audio thread)
+    bool sleeping = false;
+    juce::int64 silentSamples = 0;
+
+    void processWetDry(juce::AudioBuffer<float>& buffer);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectBase)
 };
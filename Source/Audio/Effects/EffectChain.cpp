@@ -1,7 +1,21 @@
 #include "EffectChain.h"
+#include "EffectFactory.h"
+#include "../RenderVersion.h"
 
 EffectChain::EffectChain()
 {
+    releaseThread->addTimeSliceClient(this);
+}
+
+EffectChain::~EffectChain()
+{
+    // Waits for an in-progress release pass to finish
+    releaseThread->removeTimeSliceClient(this);
+
+    // Audio has stopped by now, so everything can go on this thread
+    releaseRetiredTopologies();
+    delete pending.exchange(nullptr);
+    delete current;
 }
 
 void EffectChain::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
@@ -18,10 +32,13 @@ void EffectChain::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 
 void EffectChain::processBlock(juce::AudioBuffer<float>& buffer)
 {
-    if (globalBypass)
+    // Topology changes only take effect on block boundaries
+    adoptPendingTopology();
+
+    if (globalBypass.load() || current == nullptr)
         return;
 
-    for (auto& slot : slots)
+    for (auto& slot : current->slots)
     {
         if (slot.effect && !slot.bypassed)
         {
@@ -39,6 +56,59 @@ void EffectChain::releaseResources()
     }
 }
 
+//==============================================================================
+// Topology publishing
+
+void EffectChain::publish()
+{
+    auto* topology = new Topology();
+    topology->slots = slots;
+    ++editVersion;
+
+    // A snapshot the audio thread never picked up can go straight away; any
+    // effect it shares with the live topology is kept alive by that one
+    delete pending.exchange(topology, std::memory_order_acq_rel);
+}
+
+void EffectChain::adoptPendingTopology()
+{
+    if (pending.load(std::memory_order_acquire) == nullptr)
+        return;
+
+    // Need room to hand the old topology back - otherwise keep it for now
+    if (current != nullptr && retiredFifo.getFreeSpace() == 0)
+        return;
+
+    auto* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr)
+        return;
+
+    if (current != nullptr)
+        retiredFifo.write(1).forEach([this](int index) { retired[(size_t)index] = current; });
+
+    current = next;
+}
+
+void EffectChain::releaseRetiredTopologies()
+{
+    const int numReady = retiredFifo.getNumReady();
+    if (numReady == 0)
+        return;
+
+    // Destroying a topology drops the last reference to any effect removed with it
+    retiredFifo.read(numReady).forEach([this](int index)
+    {
+        delete retired[(size_t)index];
+        retired[(size_t)index] = nullptr;
+    });
+}
+
+int EffectChain::useTimeSlice()
+{
+    releaseRetiredTopologies();
+    return 50;
+}
+
 //==============================================================================
 // Effect management
 
@@ -51,6 +121,7 @@ int EffectChain::addEffect(std::unique_ptr<EffectBase> effect)
             effect->prepareToPlay(sampleRate, samplesPerBlock);
             slots[i].effect = std::move(effect);
             slots[i].bypassed = false;
+            publish();
             return i;
         }
     }
@@ -62,7 +133,7 @@ void EffectChain::insertEffect(int slot, std::unique_ptr<EffectBase> effect)
     if (slot < 0 || slot >= MAX_EFFECTS)
         return;
 
-    // Shift effects down
+    // Shift effects down (one falling off the end is released)
     for (int i = MAX_EFFECTS - 1; i > slot; --i)
     {
         slots[i] = std::move(slots[i - 1]);
@@ -71,15 +142,13 @@ void EffectChain::insertEffect(int slot, std::unique_ptr<EffectBase> effect)
     effect->prepareToPlay(sampleRate, samplesPerBlock);
     slots[slot].effect = std::move(effect);
     slots[slot].bypassed = false;
+    publish();
 }
 
-std::unique_ptr<EffectBase> EffectChain::removeEffect(int slot)
+bool EffectChain::removeEffect(int slot)
 {
     if (slot < 0 || slot >= MAX_EFFECTS || !slots[slot].effect)
-        return nullptr;
-
-    auto effect = std::move(slots[slot].effect);
-    slots[slot].bypassed = false;
+        return false;
 
     // Shift effects up
     for (int i = slot; i < MAX_EFFECTS - 1; ++i)
@@ -89,19 +158,22 @@ std::unique_ptr<EffectBase> EffectChain::removeEffect(int slot)
     slots[MAX_EFFECTS - 1].effect = nullptr;
     slots[MAX_EFFECTS - 1].bypassed = false;
 
-    return effect;
+    publish();
+    return true;
 }
 
-std::unique_ptr<EffectBase> EffectChain::replaceEffect(int slot, std::unique_ptr<EffectBase> effect)
+bool EffectChain::replaceEffect(int slot, std::unique_ptr<EffectBase> effect)
 {
-    if (slot < 0 || slot >= MAX_EFFECTS)
-        return effect;
+    if (slot < 0 || slot >= MAX_EFFECTS || effect == nullptr)
+        return false;
+
+    const bool hadEffect = slots[slot].effect != nullptr;
 
-    auto oldEffect = std::move(slots[slot].effect);
     effect->prepareToPlay(sampleRate, samplesPerBlock);
     slots[slot].effect = std::move(effect);
+    publish();
 
-    return oldEffect;
+    return hadEffect;
 }
 
 void EffectChain::swapEffects(int slot1, int slot2)
@@ -110,6 +182,7 @@ void EffectChain::swapEffects(int slot1, int slot2)
         return;
 
     std::swap(slots[slot1], slots[slot2]);
+    publish();
 }
 
 void EffectChain::moveEffect(int fromSlot, int toSlot)
@@ -119,9 +192,7 @@ void EffectChain::moveEffect(int fromSlot, int toSlot)
         fromSlot == toSlot)
         return;
 
-    auto effect = std::move(slots[fromSlot].effect);
-    bool bypassed = slots[fromSlot].bypassed;
-    slots[fromSlot].bypassed = false;
+    auto moving = std::move(slots[fromSlot]);
 
     // Remove from old position
     if (fromSlot < toSlot)
@@ -135,8 +206,8 @@ void EffectChain::moveEffect(int fromSlot, int toSlot)
             slots[i] = std::move(slots[i - 1]);
     }
 
-    slots[toSlot].effect = std::move(effect);
-    slots[toSlot].bypassed = bypassed;
+    slots[toSlot] = std::move(moving);
+    publish();
 }
 
 void EffectChain::clearAll()
@@ -146,6 +217,36 @@ void EffectChain::clearAll()
         slot.effect = nullptr;
         slot.bypassed = false;
     }
+    publish();
+}
+
+void EffectChain::copyStateFrom(const EffectChain& other)
+{
+    for (int i = 0; i < MAX_EFFECTS; ++i)
+    {
+        std::unique_ptr<EffectBase> copy;
+        if (const auto& source = other.slots[i].effect)
+            copy = EffectFactory::createCopy(*source);
+
+        if (copy != nullptr)
+            copy->prepareToPlay(sampleRate, samplesPerBlock);
+
+        slots[i].effect = std::move(copy);
+        slots[i].bypassed = other.slots[i].bypassed;
+    }
+
+    setBypass(other.isBypassed());
+    publish();
+}
+
+bool EffectChain::isLoading() const
+{
+    for (const auto& slot : slots)
+    {
+        if (slot.effect && slot.effect->isLoading())
+            return true;
+    }
+    return false;
 }
 
 //==============================================================================
@@ -187,13 +288,98 @@ int EffectChain::getNumActiveSlots() const
     return 0;
 }
 
+//==============================================================================
+// Sidechain routing
+
+std::vector<int> EffectChain::getSidechainSources() const
+{
+    std::vector<int> sources;
+    for (const auto& slot : slots)
+    {
+        if (slot.effect && slot.effect->getSidechainSource() >= 0)
+            sources.push_back(slot.effect->getSidechainSource());
+    }
+    return sources;
+}
+
+void EffectChain::provideSidechainInput(int sourceTrack, const juce::AudioBuffer<float>& key)
+{
+    // Same topology the following processBlock() will use
+    adoptPendingTopology();
+
+    if (current == nullptr)
+        return;
+
+    for (auto& slot : current->slots)
+    {
+        if (slot.effect && slot.effect->getSidechainSource() == sourceTrack)
+            slot.effect->setSidechainInput(key);
+    }
+}
+
+//==============================================================================
+// Silence
+
+bool EffectChain::isAsleep()
+{
+    // Same topology the following processBlock() will use
+    adoptPendingTopology();
+
+    if (globalBypass.load() || current == nullptr)
+        return true;
+
+    for (const auto& slot : current->slots)
+    {
+        if (slot.effect && !slot.bypassed && !slot.effect->isBypassed() && !slot.effect->isSleeping())
+            return false;
+    }
+    return true;
+}
+
+//==============================================================================
+// Edit tracking
+
+juce::uint64 EffectChain::getRenderVersion()
+{
+    adoptPendingTopology();
+
+    RenderVersion version;
+    version.add(editVersion.load());
+    if (current != nullptr)
+    {
+        for (const auto& slot : current->slots)
+            version.add(slot.effect.get(), slot.effect ? slot.effect->getEditVersion() : 0);
+    }
+    return version.get();
+}
+
+//==============================================================================
+// Latency
+
+int EffectChain::getLatencySamples() const
+{
+    if (globalBypass.load())
+        return 0;
+
+    int latency = 0;
+    for (const auto& slot : slots)
+    {
+        if (slot.effect && !slot.bypassed && !slot.effect->isBypassed())
+            latency += slot.effect->getLatencySamples();
+    }
+    return latency;
+}
+
 //==============================================================================
 // Per-slot bypass
 
 void EffectChain::setSlotBypass(int slot, bool bypass)
 {
-    if (slot >= 0 && slot < MAX_EFFECTS)
+    if (slot >= 0 && slot < MAX_EFFECTS && slots[slot].bypassed != bypass)
+    {
         slots[slot].bypassed = bypass;
+        publish();
+    }
 }
 
 bool EffectChain::isSlotBypassed(int slot) const
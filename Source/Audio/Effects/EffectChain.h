@@ -1,6 +1,8 @@
 #pragma once
 
 #include "EffectBase.h"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -15,14 +17,23 @@
  * - Per-slot bypass
  * - Reorder effects
  * - Add/remove effects dynamically
+ *
+ * Threading:
+ * Edits happen on the message thread against an editing copy of the slots.
+ * Each edit publishes an immutable Topology snapshot, which the audio thread
+ * swaps in at the start of its next block - it never sees a half-shuffled
+ * chain. Effects are prepared before they are published, and snapshots the
+ * audio thread has finished with are handed back through a lock-free FIFO
+ * and destroyed on a background thread, together with any removed effects
+ * they were keeping alive.
  */
-class EffectChain
+class EffectChain : private juce::TimeSliceClient
 {
 public:
     static constexpr int MAX_EFFECTS = 8;
 
     EffectChain();
-    ~EffectChain() = default;
+    ~EffectChain() override;
 
     //==========================================================================
     // Audio processing
@@ -31,7 +42,7 @@ public:
     void releaseResources();
 
     //==========================================================================
-    // Effect management
+    // Effect management (message thread)
 
     // Add effect to next available slot (returns slot index, or -1 if full)
     int addEffect(std::unique_ptr<EffectBase> effect);
@@ -39,11 +50,12 @@ public:
     // Insert effect at specific slot (shifts existing effects)
     void insertEffect(int slot, std::unique_ptr<EffectBase> effect);
 
-    // Remove effect from slot
-    std::unique_ptr<EffectBase> removeEffect(int slot);
+    // Remove effect from slot (returns false if the slot was empty).
+    // The effect is destroyed on the release thread once the audio thread is done with it.
+    bool removeEffect(int slot);
 
-    // Replace effect at slot
-    std::unique_ptr<EffectBase> replaceEffect(int slot, std::unique_ptr<EffectBase> effect);
+    // Replace effect at slot; the old effect is released like removeEffect()
+    bool replaceEffect(int slot, std::unique_ptr<EffectBase> effect);
 
     // Swap two effects
     void swapEffects(int slot1, int slot2);
@@ -54,6 +66,13 @@ public:
     // Clear all effects
     void clearAll();
 
+    // Replace every slot with a copy of other's effect there (see
+    // EffectFactory::createCopy), with the same slot and chain bypasses
+    void copyStateFrom(const EffectChain& other);
+
+    // True while any effect is still loading (see EffectBase::isLoading)
+    bool isLoading() const;
+
     //==========================================================================
     // Effect access
     EffectBase* getEffect(int slot);
@@ -66,23 +85,86 @@ public:
     void setSlotBypass(int slot, bool bypass);
     bool isSlotBypassed(int slot) const;
 
+    //==========================================================================
+    // Sidechain routing
+
+    // Track indices keying effects in this chain (message thread)
+    std::vector<int> getSidechainSources() const;
+
+    // Hand a source track's output to every effect keyed by it (audio thread,
+    // before processBlock)
+    void provideSidechainInput(int sourceTrack, const juce::AudioBuffer<float>& key);
+
+    //==========================================================================
+    // Silence
+
+    // True when every active effect is asleep, so silent input would come
+    // out silent without running anything (audio thread)
+    bool isAsleep();
+
+    //==========================================================================
+    // Latency
+
+    // Total latency of the effects that aren't bypassed (message thread)
+    int getLatencySamples() const;
+
+    //==========================================================================
+    // Edit tracking
+
+    // Changes whenever the slots or any effect's parameters change. Called
+    // by whoever processes the chain, as it adopts a pending topology.
+    juce::uint64 getRenderVersion();
+
     //==========================================================================
     // Global bypass (bypasses entire chain)
-    void setBypass(bool bypass) { globalBypass = bypass; }
-    bool isBypassed() const { return globalBypass; }
+    void setBypass(bool bypass) { globalBypass.store(bypass); ++editVersion; }
+    bool isBypassed() const { return globalBypass.load(); }
 
 private:
     struct EffectSlot
     {
-        std::unique_ptr<EffectBase> effect;
+        std::shared_ptr<EffectBase> effect;
         bool bypassed = false;
     };
 
+    // Immutable once published
+    struct Topology
+    {
+        std::array<EffectSlot, MAX_EFFECTS> slots;
+    };
+
+    // Shared background thread that destroys retired topologies
+    class ReleaseThread : public juce::TimeSliceThread
+    {
+    public:
+        ReleaseThread() : juce::TimeSliceThread("Effect Release") { startThread(); }
+        ~ReleaseThread() override { stopThread(2000); }
+    };
+
+    static constexpr int RETIRED_CAPACITY = 32;
+
+    // Editing copy (message thread)
     std::array<EffectSlot, MAX_EFFECTS> slots;
-    bool globalBypass = false;
+    std::atomic<bool> globalBypass{false};
+    std::atomic<juce::uint32> editVersion{0};
+
+    // Published state
+    Topology* current = nullptr;                     // Audio thread only
+    std::atomic<Topology*> pending{nullptr};
+    juce::AbstractFifo retiredFifo{RETIRED_CAPACITY};
+    std::array<Topology*, RETIRED_CAPACITY> retired{};
+
+    juce::SharedResourcePointer<ReleaseThread> releaseThread;
 
     double sampleRate = 44100.0;
     int samplesPerBlock = 512;
 
+    void publish();
+    void adoptPendingTopology();
+    void releaseRetiredTopologies();
+
+    // TimeSliceClient
+    int useTimeSlice() override;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectChain)
 };
@@ -0,0 +1,52 @@
+#include "EffectFactory.h"
+#include "ReverbEffect.h"
+#include "DelayEffect.h"
+#include "ConvolutionReverbEffect.h"
+#include "ChorusEffect.h"
+#include "PhaserEffect.h"
+#include "FlangerEffect.h"
+#include "TremoloEffect.h"
+#include "DistortionEffect.h"
+#include "BitcrusherEffect.h"
+#include "CompressorEffect.h"
+#include "SidechainCompressorEffect.h"
+#include "LimiterEffect.h"
+#include "GateEffect.h"
+#include "EQEffect.h"
+#include "ParametricEQEffect.h"
+#include "FilterEffect.h"
+#include "AmpSimulatorEffect.h"
+#include "CabinetEffect.h"
+
+std::unique_ptr<EffectBase> EffectFactory::createEffect(const juce::String& name)
+{
+    if (name == "Reverb") return std::make_unique<ReverbEffect>();
+    if (name == "Delay") return std::make_unique<DelayEffect>();
+    if (name == "Convolution Reverb") return std::make_unique<ConvolutionReverbEffect>();
+    if (name == "Chorus") return std::make_unique<ChorusEffect>();
+    if (name == "Phaser") return std::make_unique<PhaserEffect>();
+    if (name == "Flanger") return std::make_unique<FlangerEffect>();
+    if (name == "Tremolo") return std::make_unique<TremoloEffect>();
+    if (name == "Distortion") return std::make_unique<DistortionEffect>();
+    if (name == "Bitcrusher") return std::make_unique<BitcrusherEffect>();
+    if (name == "Compressor") return std::make_unique<CompressorEffect>();
+    if (name == "Sidechain Compressor") return std::make_unique<SidechainCompressorEffect>();
+    if (name == "Limiter") return std::make_unique<LimiterEffect>();
+    if (name == "Gate") return std::make_unique<GateEffect>();
+    if (name == "EQ") return std::make_unique<EQEffect>();
+    if (name == "Parametric EQ") return std::make_unique<ParametricEQEffect>();
+    if (name == "Filter") return std::make_unique<FilterEffect>();
+    if (name == "Amp Simulator" || name == "Amp Sim") return std::make_unique<AmpSimulatorEffect>();
+    if (name == "Cabinet") return std::make_unique<CabinetEffect>();
+
+    return nullptr;
+}
+
+std::unique_ptr<EffectBase> EffectFactory::createCopy(const EffectBase& source)
+{
+    auto effect = createEffect(source.getName());
+    if (effect)
+        effect->copyStateFrom(source);
+
+    return effect;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "EffectBase.h"
+#include <memory>
+
+/**
+ * EffectFactory - Creates effect instances by name
+ *
+ * Names are the ones the effect menu shows (and getName() returns).
+ *
+ * Usage:
+ *   auto effect = EffectFactory::createEffect("Reverb");
+ */
+class EffectFactory
+{
+public:
+    /**
+     * Create a new effect with default settings, or nullptr for an unknown name
+     */
+    static std::unique_ptr<EffectBase> createEffect(const juce::String& name);
+
+    /**
+     * Create a new effect of the same kind as source, with its settings
+     * (see EffectBase::copyStateFrom). Unprepared, like createEffect().
+     */
+    static std::unique_ptr<EffectBase> createCopy(const EffectBase& source);
+
+private:
+    EffectFactory() = delete;  // Static-only class
+};
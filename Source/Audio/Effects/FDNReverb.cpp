@@ -0,0 +1,407 @@
+#include "FDNReverb.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Longest line at room size 1 (ms) plus headroom for modulation
+    constexpr float MAX_LINE_MS = 130.0f;
+
+    // Modulation depth (ms) and how often the LFOs are advanced (samples)
+    constexpr float MODULATION_MS = 0.3f;
+    constexpr int MODULATION_INTERVAL = 32;
+
+    // Fastest a line length may change (samples per sample) when the room
+    // size moves - a glide of at most ~0.3 semitones instead of a jump
+    constexpr float MAX_GLIDE = 0.02f;
+
+    // Spread of each input diffusion stage (ms)
+    constexpr float DIFFUSER_MS[FDNReverb::NUM_DIFFUSERS] = { 7.0f, 17.0f };
+
+    /** In-place orthonormal Hadamard transform of N lanes */
+    template <int N>
+    inline void hadamard(float* x)
+    {
+        for (int h = 1; h < N; h *= 2)
+            for (int i = 0; i < N; i += 2 * h)
+                for (int j = i; j < i + h; ++j)
+                {
+                    const float a = x[j];
+                    const float b = x[j + h];
+                    x[j] = a + b;
+                    x[j + h] = a - b;
+                }
+
+        const float scale = 1.0f / std::sqrt(static_cast<float>(N));
+        for (int i = 0; i < N; ++i)
+            x[i] *= scale;
+    }
+}
+
+FDNReverb::FDNReverb()
+{
+    // Input and output patterns are rows of a Hadamard matrix, so the two
+    // channels excite and hear orthogonal mixes of the lines
+    for (int i = 0; i < MAX_LINES; ++i)
+    {
+        const float sign = (i & 2) != 0 ? -1.0f : 1.0f;
+        inputGainLeft[i] = (i & 1) == 0 ? sign : 0.0f;
+        inputGainRight[i] = (i & 1) != 0 ? sign : 0.0f;
+        tapLeft[i] = (i & 4) != 0 ? -1.0f : 1.0f;
+        tapRight[i] = (i & 1) != 0 ? -tapLeft[i] : tapLeft[i];
+    }
+}
+
+//==============================================================================
+void FDNReverb::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    const int maxLineSamples = static_cast<int>(std::ceil(MAX_LINE_MS * 0.001 * sampleRate)) + 4;
+    const int ringLength = juce::nextPowerOfTwo(maxLineSamples);
+    ring.assign(static_cast<size_t>(ringLength) * MAX_LINES, 0.0f);
+    ringMask = ringLength - 1;
+
+    const int predelayLength = juce::nextPowerOfTwo(
+        static_cast<int>(std::ceil(MAX_PREDELAY_MS * 0.001 * sampleRate)) + 1);
+    for (auto& channel : predelayRing)
+        channel.assign(static_cast<size_t>(predelayLength), 0.0f);
+    predelayMask = predelayLength - 1;
+
+    const int diffuserLength = juce::nextPowerOfTwo(
+        static_cast<int>(std::ceil(DIFFUSER_MS[NUM_DIFFUSERS - 1] * 0.001 * sampleRate)) + 2);
+    for (auto& stage : diffuserRing)
+        stage.assign(static_cast<size_t>(diffuserLength) * MAX_LINES, 0.0f);
+    diffuserMask = diffuserLength - 1;
+
+    // Slow, unrelated LFO rates and spread phases per line
+    for (int i = 0; i < MAX_LINES; ++i)
+    {
+        const double rate = 0.13 + 0.71 * static_cast<double>(i) / (MAX_LINES - 1);
+        lfoIncrement[i] = juce::MathConstants<double>::twoPi * rate / sampleRate;
+        lfoPhase[i] = std::fmod(i * 0.618034, 1.0) * juce::MathConstants<double>::twoPi;
+    }
+
+    // Force the next block to rebuild everything
+    appliedVersion = 0;
+    activeQuality = -1;
+    reset();
+}
+
+void FDNReverb::reset()
+{
+    std::fill(ring.begin(), ring.end(), 0.0f);
+    for (auto& channel : predelayRing)
+        std::fill(channel.begin(), channel.end(), 0.0f);
+    for (auto& stage : diffuserRing)
+        std::fill(stage.begin(), stage.end(), 0.0f);
+
+    writePosition = 0;
+    predelayWrite = 0;
+    diffuserWrite = 0;
+    samplesUntilModulation = 0;
+
+    for (int i = 0; i < MAX_LINES; ++i)
+    {
+        dampState[i] = 0.0f;
+        currentDelay[i] = baseDelay[i];
+        delayStep[i] = 0.0f;
+    }
+}
+
+//==============================================================================
+void FDNReverb::setParameters(const Parameters& newParameters)
+{
+    roomSize.store(juce::jlimit(0.0f, 1.0f, newParameters.roomSize));
+    damping.store(juce::jlimit(0.0f, 1.0f, newParameters.damping));
+    width.store(juce::jlimit(0.0f, 1.0f, newParameters.width));
+    predelayMs.store(juce::jlimit(0.0f, MAX_PREDELAY_MS, newParameters.predelayMs));
+    parameterVersion.fetch_add(1);
+}
+
+FDNReverb::Parameters FDNReverb::getParameters() const
+{
+    Parameters p;
+    p.roomSize = roomSize.load();
+    p.damping = damping.load();
+    p.width = width.load();
+    p.predelayMs = predelayMs.load();
+    return p;
+}
+
+void FDNReverb::setQuality(Quality newQuality)
+{
+    quality.store(static_cast<int>(newQuality));
+}
+
+float FDNReverb::getDecaySeconds(float roomSize)
+{
+    // 0.3 (small room) ~ 0.9 s, 0.95 (cathedral) ~ 7.4 s
+    return 0.2f + 8.0f * roomSize * roomSize;
+}
+
+//==============================================================================
+void FDNReverb::applyParameters()
+{
+    const int newQuality = quality.load();
+    const int numLines = getNumLines(static_cast<Quality>(newQuality));
+    const float room = roomSize.load();
+
+    // Line lengths spread exponentially between the shortest and longest,
+    // with a small irregular offset so no two ratios are simple
+    const float shortestMs = 10.0f + 20.0f * room;
+    const float longestMs = 35.0f + 85.0f * room;
+    const float decaySamples = getDecaySeconds(room) * static_cast<float>(sampleRate);
+
+    float meanDelay = 0.0f;
+    for (int i = 0; i < numLines; ++i)
+    {
+        const float position = static_cast<float>(i) / static_cast<float>(numLines - 1);
+        const float jitter = 1.0f + 0.04f * std::sin(static_cast<float>(i) * 2.37f);
+        const float ms = shortestMs * std::pow(longestMs / shortestMs, position) * jitter;
+
+        baseDelay[i] = juce::jmin(ms * 0.001f * static_cast<float>(sampleRate),
+                                  static_cast<float>(ringMask - 2));
+        feedbackGain[i] = std::pow(10.0f, -3.0f * baseDelay[i] / decaySamples);
+        meanDelay += baseDelay[i] / static_cast<float>(numLines);
+    }
+
+    // Tail energy grows as 1 / (1 - g^2) and with the number of lines tapped;
+    // scale it back so every room size and quality sits at a similar level
+    const float meanGain = std::pow(10.0f, -3.0f * meanDelay / decaySamples);
+    outputScale = std::sqrt((1.0f - meanGain * meanGain) * 2.0f / static_cast<float>(numLines));
+
+    // One-pole lowpass in every loop, 20 kHz down to 1 kHz
+    const float cutoff = 1000.0f + 19000.0f * (1.0f - damping.load()) * (1.0f - damping.load());
+    dampCoefficient = juce::jmin(1.0f, 1.0f - std::exp(-juce::MathConstants<float>::twoPi * cutoff
+                                                        / static_cast<float>(sampleRate)));
+
+    const float w = width.load();
+    wet1 = 0.5f * (1.0f + w);
+    wet2 = 0.5f * (1.0f - w);
+
+    predelaySamples = juce::jlimit(0, predelayMask,
+                                   juce::roundToInt(predelayMs.load() * 0.001f * static_cast<float>(sampleRate)));
+
+    modulationDepth = static_cast<Quality>(newQuality) == Quality::Eco
+                          ? 0.0f
+                          : MODULATION_MS * 0.001f * static_cast<float>(sampleRate);
+
+    // A different line count changes what every line means - start clean.
+    // Otherwise lines glide to their new lengths
+    if (newQuality != activeQuality)
+    {
+        // Each diffusion stage spreads its lines evenly (with a wobble) over its span
+        for (int stage = 0; stage < NUM_DIFFUSERS; ++stage)
+        {
+            const float spanSamples = DIFFUSER_MS[stage] * 0.001f * static_cast<float>(sampleRate);
+            for (int i = 0; i < numLines; ++i)
+            {
+                const float slot = static_cast<float>(i) + 0.5f + 0.35f * std::sin(static_cast<float>(i * 3 + stage) * 1.71f);
+                diffuserDelay[stage][i] = juce::jlimit(1, diffuserMask,
+                                                       juce::roundToInt(spanSamples * slot / static_cast<float>(numLines)));
+            }
+        }
+
+        std::fill(ring.begin(), ring.end(), 0.0f);
+        for (auto& diffuser : diffuserRing)
+            std::fill(diffuser.begin(), diffuser.end(), 0.0f);
+        for (int i = 0; i < MAX_LINES; ++i)
+        {
+            dampState[i] = 0.0f;
+            currentDelay[i] = baseDelay[i];
+            delayStep[i] = 0.0f;
+        }
+        activeQuality = newQuality;
+    }
+}
+
+void FDNReverb::updateModulation(int numLines, int numSamples)
+{
+    for (int i = 0; i < numLines; ++i)
+    {
+        lfoPhase[i] += lfoIncrement[i] * numSamples;
+        if (lfoPhase[i] >= juce::MathConstants<double>::twoPi)
+            lfoPhase[i] -= juce::MathConstants<double>::twoPi;
+
+        const float target = baseDelay[i] + modulationDepth * static_cast<float>(std::sin(lfoPhase[i]));
+        delayStep[i] = juce::jlimit(-MAX_GLIDE, MAX_GLIDE,
+                                    (target - currentDelay[i]) / static_cast<float>(numSamples));
+    }
+}
+
+//==============================================================================
+void FDNReverb::process(float* left, float* right, int numSamples)
+{
+    if (ring.empty() || left == nullptr)
+        return;
+
+    juce::ScopedNoDenormals noDenormals;
+
+    const int version = parameterVersion.load();
+    if (version != appliedVersion || quality.load() != activeQuality)
+    {
+        appliedVersion = version;
+        applyParameters();
+    }
+
+    const bool sixteenLines = static_cast<Quality>(activeQuality) == Quality::High;
+    const int numLines = sixteenLines ? 16 : 8;
+
+    int offset = 0;
+    while (offset < numSamples)
+    {
+        if (samplesUntilModulation == 0)
+        {
+            updateModulation(numLines, MODULATION_INTERVAL);
+            samplesUntilModulation = MODULATION_INTERVAL;
+        }
+
+        const int chunk = juce::jmin(numSamples - offset, samplesUntilModulation);
+        float* chunkRight = right != nullptr ? right + offset : nullptr;
+
+        if (sixteenLines)
+            processLines<16>(left + offset, chunkRight, chunk);
+        else
+            processLines<8>(left + offset, chunkRight, chunk);
+
+        offset += chunk;
+        samplesUntilModulation -= chunk;
+    }
+}
+
+template <int NumLines>
+void FDNReverb::processLines(float* left, float* right, int numSamples)
+{
+    static_assert(NumLines <= MAX_LINES, "Too many lines");
+
+    constexpr float householder = -2.0f / static_cast<float>(NumLines);
+    const float ringLength = static_cast<float>(ringMask + 1);
+
+    alignas(32) float delayed[MAX_LINES];
+    alignas(32) float frame[MAX_LINES];
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        // Pre-delay
+        predelayRing[0][static_cast<size_t>(predelayWrite)] = left[n];
+        predelayRing[1][static_cast<size_t>(predelayWrite)] = right != nullptr ? right[n] : left[n];
+        const auto predelayRead = static_cast<size_t>((predelayWrite - predelaySamples) & predelayMask);
+        const float inLeft = predelayRing[0][predelayRead];
+        const float inRight = predelayRing[1][predelayRead];
+        predelayWrite = (predelayWrite + 1) & predelayMask;
+
+        // Spread the input over the lines, then diffuse it
+        alignas(32) float diffused[MAX_LINES];
+        for (int i = 0; i < NumLines; ++i)
+            diffused[i] = inLeft * inputGainLeft[i] + inRight * inputGainRight[i];
+
+        for (int stage = 0; stage < NUM_DIFFUSERS; ++stage)
+        {
+            float* stageRing = diffuserRing[stage].data();
+            std::memcpy(stageRing + static_cast<size_t>(diffuserWrite) * MAX_LINES, diffused,
+                        sizeof(float) * static_cast<size_t>(NumLines));
+
+            for (int i = 0; i < NumLines; ++i)
+            {
+                const auto slot = static_cast<size_t>((diffuserWrite - diffuserDelay[stage][i]) & diffuserMask);
+                const float sample = stageRing[slot * MAX_LINES + static_cast<size_t>(i)];
+                diffused[i] = ((i + stage) & 1) != 0 ? -sample : sample;
+            }
+
+            hadamard<NumLines>(diffused);
+        }
+        diffuserWrite = (diffuserWrite + 1) & diffuserMask;
+
+        // Gather every line's (fractional, modulated) output
+        for (int i = 0; i < NumLines; ++i)
+        {
+            float readPosition = static_cast<float>(writePosition) - currentDelay[i];
+            if (readPosition < 0.0f)
+                readPosition += ringLength;
+
+            const int index = static_cast<int>(readPosition);
+            const float fraction = readPosition - static_cast<float>(index);
+            const float older = ring[static_cast<size_t>(index & ringMask) * MAX_LINES + static_cast<size_t>(i)];
+            const float newer = ring[static_cast<size_t>((index + 1) & ringMask) * MAX_LINES + static_cast<size_t>(i)];
+            delayed[i] = older + fraction * (newer - older);
+        }
+
+        // Taps, damping, decay, Householder feedback and input, across all lines at once
+        float outLeft = 0.0f, outRight = 0.0f;
+
+       #if JUCE_USE_SIMD
+        using Vector = juce::dsp::SIMDRegister<float>;
+        constexpr int lanes = static_cast<int>(Vector::SIMDNumElements);
+        static_assert(NumLines % lanes == 0, "Line count must fill whole registers");
+
+        const auto dampVector = Vector::expand(dampCoefficient);
+        auto leftSum = Vector::expand(0.0f);
+        auto rightSum = Vector::expand(0.0f);
+        auto frameSum = Vector::expand(0.0f);
+
+        for (int i = 0; i < NumLines; i += lanes)
+        {
+            const auto d = Vector::fromRawArray(delayed + i);
+            leftSum = leftSum + d * Vector::fromRawArray(tapLeft + i);
+            rightSum = rightSum + d * Vector::fromRawArray(tapRight + i);
+
+            auto state = Vector::fromRawArray(dampState + i);
+            state = state + dampVector * (d - state);
+            state.copyToRawArray(dampState + i);
+
+            const auto decayed = state * Vector::fromRawArray(feedbackGain + i);
+            decayed.copyToRawArray(frame + i);
+            frameSum = frameSum + decayed;
+
+            const auto delay = Vector::fromRawArray(currentDelay + i) + Vector::fromRawArray(delayStep + i);
+            delay.copyToRawArray(currentDelay + i);
+        }
+
+        const auto mixVector = Vector::expand(frameSum.sum() * householder);
+
+        for (int i = 0; i < NumLines; i += lanes)
+        {
+            const auto mixed = Vector::fromRawArray(frame + i) + mixVector + Vector::fromRawArray(diffused + i);
+            mixed.copyToRawArray(frame + i);
+        }
+
+        outLeft = leftSum.sum();
+        outRight = rightSum.sum();
+       #else
+        float frameSum = 0.0f;
+        for (int i = 0; i < NumLines; ++i)
+        {
+            outLeft += delayed[i] * tapLeft[i];
+            outRight += delayed[i] * tapRight[i];
+
+            dampState[i] += dampCoefficient * (delayed[i] - dampState[i]);
+            frame[i] = dampState[i] * feedbackGain[i];
+            frameSum += frame[i];
+
+            currentDelay[i] += delayStep[i];
+        }
+
+        const float mix = frameSum * householder;
+        for (int i = 0; i < NumLines; ++i)
+            frame[i] += mix + diffused[i];
+       #endif
+
+        std::memcpy(ring.data() + static_cast<size_t>(writePosition) * MAX_LINES, frame,
+                    sizeof(float) * static_cast<size_t>(NumLines));
+        writePosition = (writePosition + 1) & ringMask;
+
+        outLeft *= outputScale;
+        outRight *= outputScale;
+
+        if (right != nullptr)
+        {
+            left[n] = wet1 * outLeft + wet2 * outRight;
+            right[n] = wet1 * outRight + wet2 * outLeft;
+        }
+        else
+        {
+            left[n] = 0.5f * (outLeft + outRight);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * FDNReverb - Feedback delay network reverb laid out for SIMD
+ *
+ * 8 or 16 delay lines share one interleaved ring buffer (one frame of all
+ * lines per sample), so damping, decay, the Householder feedback matrix
+ * (x - 2/N * sum(x)) and the output taps each run as a few vector operations
+ * per sample instead of one scalar filter per line. Line lengths are spread
+ * exponentially with the room size and slowly modulated, which breaks up
+ * the metallic ringing of a static network.
+ *
+ * Before entering the loop the input passes through short diffusion stages
+ * (per-line delays, polarity flips and a Hadamard mix), so the echo density
+ * is already high on the first pass instead of building up over several.
+ *
+ * Quality:
+ * - Eco:      8 lines, no modulation
+ * - Standard: 8 lines, modulated
+ * - High:     16 lines, modulated
+ *
+ * Parameters may be set from any thread; the audio thread picks them up at
+ * the start of its next block, and line lengths glide to new room sizes.
+ */
+class FDNReverb
+{
+public:
+    enum class Quality
+    {
+        Eco = 0,
+        Standard,
+        High
+    };
+
+    struct Parameters
+    {
+        float roomSize = 0.5f;      // 0-1, sets line lengths and decay time
+        float damping = 0.5f;       // 0-1, high frequency loss per pass
+        float width = 1.0f;         // 0-1, stereo width of the tail
+        float predelayMs = 0.0f;    // 0-100
+    };
+
+    static constexpr int MAX_LINES = 16;
+    static constexpr int NUM_DIFFUSERS = 2;
+    static constexpr float MAX_PREDELAY_MS = 100.0f;
+
+    FDNReverb();
+
+    //==========================================================================
+    void prepare(double sampleRate);
+    void reset();
+
+    void setParameters(const Parameters& newParameters);
+    Parameters getParameters() const;
+
+    void setQuality(Quality newQuality);
+    Quality getQuality() const { return static_cast<Quality>(quality.load()); }
+    static int getNumLines(Quality quality) { return quality == Quality::High ? 16 : 8; }
+
+    /** Decay time to -60 dB for a room size */
+    static float getDecaySeconds(float roomSize);
+
+    //==========================================================================
+    /** Replace the signal with the reverb tail. right may be nullptr (mono). */
+    void process(float* left, float* right, int numSamples);
+
+private:
+    template <int NumLines>
+    void processLines(float* left, float* right, int numSamples);
+
+    void applyParameters();
+    void updateModulation(int numLines, int numSamples);
+
+    double sampleRate = 44100.0;
+
+    // Parameters (any thread) and what the audio thread last applied
+    std::atomic<float> roomSize{0.5f};
+    std::atomic<float> damping{0.5f};
+    std::atomic<float> width{1.0f};
+    std::atomic<float> predelayMs{0.0f};
+    std::atomic<int> quality{static_cast<int>(Quality::Standard)};
+    std::atomic<int> parameterVersion{1};
+    int appliedVersion = 0;
+    int activeQuality = -1;
+
+    // Lines: frame-interleaved ring, MAX_LINES floats per sample
+    std::vector<float> ring;
+    int ringMask = 0;
+    int writePosition = 0;
+
+    // Input diffusion: one interleaved ring per stage, integer delays
+    std::vector<float> diffuserRing[NUM_DIFFUSERS];
+    int diffuserMask = 0;
+    int diffuserWrite = 0;
+    int diffuserDelay[NUM_DIFFUSERS][MAX_LINES] = {};
+
+    // Pre-delay
+    std::vector<float> predelayRing[2];
+    int predelayMask = 0;
+    int predelayWrite = 0;
+    int predelaySamples = 0;
+
+    // Per-line state, one vector lane per line
+    alignas(32) float baseDelay[MAX_LINES] = {};
+    alignas(32) float currentDelay[MAX_LINES] = {};
+    alignas(32) float delayStep[MAX_LINES] = {};
+    alignas(32) float feedbackGain[MAX_LINES] = {};
+    alignas(32) float dampState[MAX_LINES] = {};
+    alignas(32) float inputGainLeft[MAX_LINES] = {};
+    alignas(32) float inputGainRight[MAX_LINES] = {};
+    alignas(32) float tapLeft[MAX_LINES] = {};
+    alignas(32) float tapRight[MAX_LINES] = {};
+
+    double lfoPhase[MAX_LINES] = {};
+    double lfoIncrement[MAX_LINES] = {};
+    float modulationDepth = 0.0f;
+    int samplesUntilModulation = 0;
+
+    float dampCoefficient = 1.0f;
+    float wet1 = 1.0f;
+    float wet2 = 0.0f;
+    float outputScale = 1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FDNReverb)
+};
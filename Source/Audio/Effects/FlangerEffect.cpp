@@ -106,6 +106,12 @@ void FlangerEffect::onParameterChanged(const juce::String& name, float value)
         feedbackAmount = value;
 }
 
+int FlangerEffect::getTailSamples() const
+{
+    // Centre delay plus the widest sweep
+    return static_cast<int>((centerDelayMs + 4.0f) * 0.001f * static_cast<float>(sampleRate));
+}
+
 std::vector<EffectPreset> FlangerEffect::getPresets() const
 {
     std::vector<EffectPreset> presets;
@@ -0,0 +1,405 @@
+#include "LinearPhaseEQ.h"
+#include <cmath>
+#include <complex>
+#include <cstring>
+
+namespace
+{
+    constexpr int SPECTRUM_SIZE = 2 * (LinearPhaseEQ::BLOCK_SIZE + 1);  // Interleaved bins 0..BLOCK_SIZE
+    constexpr int FFT_ORDER = 9;                                        // 2 * BLOCK_SIZE points
+
+    static_assert((1 << FFT_ORDER) == 2 * LinearPhaseEQ::BLOCK_SIZE);
+
+    // acc += x * h over interleaved complex bins
+    void multiplyAccumulate(float* acc, const float* x, const float* h, int numBins)
+    {
+        for (int k = 0; k < numBins; ++k)
+        {
+            const float xr = x[2 * k], xi = x[2 * k + 1];
+            const float hr = h[2 * k], hi = h[2 * k + 1];
+            acc[2 * k]     += xr * hr - xi * hi;
+            acc[2 * k + 1] += xr * hi + xi * hr;
+        }
+    }
+
+    // Whatever the FFT backend's round trip scales by, as a factor to undo it
+    float roundTripCorrection(const juce::dsp::FFT& fft)
+    {
+        std::vector<float> impulse(static_cast<size_t>(2 * fft.getSize()), 0.0f);
+        impulse[0] = 1.0f;
+        fft.performRealOnlyForwardTransform(impulse.data(), true);
+        fft.performRealOnlyInverseTransform(impulse.data());
+        return std::abs(impulse[0]) > 1.0e-9f ? 1.0f / impulse[0] : 1.0f;
+    }
+
+    double magnitudeAt(const BiquadCascade::Coefficients& c, std::complex<double> z1)
+    {
+        const auto z2 = z1 * z1;
+        const auto numerator = static_cast<double>(c.b0) + static_cast<double>(c.b1) * z1 + static_cast<double>(c.b2) * z2;
+        const auto denominator = 1.0 + static_cast<double>(c.a1) * z1 + static_cast<double>(c.a2) * z2;
+        return std::abs(numerator / denominator);
+    }
+}
+
+//==============================================================================
+// Kernel - partition spectra of one design, read-only once published
+//==============================================================================
+
+struct LinearPhaseEQ::Kernel
+{
+    std::vector<float> spectra;     // numPartitions spectra back to back
+};
+
+std::unique_ptr<LinearPhaseEQ::Kernel> LinearPhaseEQ::partitionKernel(const std::vector<float>& taps)
+{
+    juce::dsp::FFT partitionFFT(FFT_ORDER);
+    const float scale = roundTripCorrection(partitionFFT);
+
+    const int length = static_cast<int>(taps.size());
+    const int partitions = length / BLOCK_SIZE;
+
+    auto kernel = std::make_unique<Kernel>();
+    kernel->spectra.assign(static_cast<size_t>(partitions * SPECTRUM_SIZE), 0.0f);
+
+    std::vector<float> buffer(static_cast<size_t>(4 * BLOCK_SIZE));
+    for (int p = 0; p < partitions; ++p)
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        std::memcpy(buffer.data(), taps.data() + p * BLOCK_SIZE, sizeof(float) * BLOCK_SIZE);
+        partitionFFT.performRealOnlyForwardTransform(buffer.data(), true);
+        juce::FloatVectorOperations::multiply(kernel->spectra.data() + p * SPECTRUM_SIZE,
+                                              buffer.data(), scale, SPECTRUM_SIZE);
+    }
+
+    return kernel;
+}
+
+//==============================================================================
+// Designer - one background thread shared by every instance
+//==============================================================================
+
+class LinearPhaseEQ::Designer
+{
+public:
+    juce::ThreadPool pool { juce::ThreadPoolOptions{}.withThreadName("Linear Phase EQ Designer")
+                                                     .withNumberOfThreads(1) };
+};
+
+struct LinearPhaseEQ::DesignState
+{
+    juce::CriticalSection lock;
+    LinearPhaseEQ* owner = nullptr;         // Cleared when the EQ goes away
+    std::vector<BiquadCascade::Coefficients> bands;
+    std::atomic<int> latestRequest{0};
+    std::atomic<int> completedRequest{0};
+};
+
+//==============================================================================
+LinearPhaseEQ::LinearPhaseEQ()
+    : designState(std::make_shared<DesignState>()),
+      fft(std::make_unique<juce::dsp::FFT>(FFT_ORDER))
+{
+    designState->owner = this;
+}
+
+LinearPhaseEQ::~LinearPhaseEQ()
+{
+    {
+        const juce::ScopedLock sl(designState->lock);
+        designState->owner = nullptr;
+    }
+
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+    delete previous;
+    delete current;
+}
+
+int LinearPhaseEQ::kernelLengthFor(double sampleRate)
+{
+    // Keep the frequency resolution (and the latency in ms) roughly constant
+    int length = BASE_KERNEL_LENGTH;
+    while (length < MAX_KERNEL_LENGTH && sampleRate > 48000.0 * (length / BASE_KERNEL_LENGTH) + 1.0)
+        length *= 2;
+    return length;
+}
+
+//==============================================================================
+// Setup
+
+void LinearPhaseEQ::prepare(double sampleRate, int numChannels)
+{
+    kernelLength = kernelLengthFor(sampleRate);
+    numPartitions = kernelLength / BLOCK_SIZE;
+    numChannelsPrepared = juce::jlimit(1, MAX_CHANNELS, numChannels);
+
+    channels.assign(static_cast<size_t>(numChannelsPrepared), Channel{});
+    for (auto& channel : channels)
+    {
+        channel.window.assign(2 * BLOCK_SIZE, 0.0f);
+        channel.output.assign(BLOCK_SIZE, 0.0f);
+        channel.spectra.assign(static_cast<size_t>(numPartitions * SPECTRUM_SIZE), 0.0f);
+    }
+
+    work.assign(4 * BLOCK_SIZE, 0.0f);
+    fadeWork.assign(4 * BLOCK_SIZE, 0.0f);
+    fifoPosition = 0;
+    spectrumIndex = 0;
+    resetRequested.store(false);
+
+    std::vector<BiquadCascade::Coefficients> bands;
+    {
+        // Drop designs for the old length, including one still in flight
+        const juce::ScopedLock sl(designState->lock);
+        const int request = ++designState->latestRequest;
+        designState->completedRequest.store(request);
+        bands = designState->bands;
+
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+    }
+
+    delete previous;
+    previous = nullptr;
+
+    // Flat until the first design arrives: a unit tap at the centre
+    std::vector<float> delay(static_cast<size_t>(kernelLength), 0.0f);
+    delay[static_cast<size_t>(kernelLength / 2)] = 1.0f;
+    delete current;
+    current = partitionKernel(delay).release();
+
+    if (!bands.empty())
+        setBands(std::move(bands));
+}
+
+void LinearPhaseEQ::reset()
+{
+    resetRequested.store(true);
+}
+
+//==============================================================================
+// Design
+
+void LinearPhaseEQ::setBands(std::vector<BiquadCascade::Coefficients> bands)
+{
+    auto state = designState;
+    const int length = kernelLength;
+    int request = 0;
+
+    {
+        const juce::ScopedLock sl(state->lock);
+        state->bands = bands;
+        request = ++state->latestRequest;
+    }
+
+    designer->pool.addJob([state, request, length, bands = std::move(bands)]
+    {
+        // Superseded before it started (e.g. the band is still being dragged)
+        if (state->latestRequest.load() != request)
+            return;
+
+        auto kernel = partitionKernel(designKernel(bands, length));
+
+        const juce::ScopedLock sl(state->lock);
+        if (state->owner != nullptr && state->latestRequest.load() == request
+            && state->owner->getKernelLength() == length)
+        {
+            state->owner->publish(kernel.release());
+        }
+
+        state->completedRequest.store(request);
+    });
+}
+
+bool LinearPhaseEQ::isDesigning() const
+{
+    return designState->latestRequest.load() != designState->completedRequest.load();
+}
+
+std::vector<float> LinearPhaseEQ::designKernel(const std::vector<BiquadCascade::Coefficients>& bands, int length)
+{
+    jassert(juce::isPowerOfTwo(length) && length >= 2 * BLOCK_SIZE);
+
+    juce::dsp::FFT designFFT(juce::roundToInt(std::log2(length)));
+    std::vector<float> spectrum(static_cast<size_t>(2 * length), 0.0f);
+
+    // The inverse of a flat spectrum should come out as a unit impulse
+    for (int k = 0; k <= length / 2; ++k)
+        spectrum[static_cast<size_t>(2 * k)] = 1.0f;
+    designFFT.performRealOnlyInverseTransform(spectrum.data());
+    const float scale = std::abs(spectrum[0]) > 1.0e-9f ? 1.0f / spectrum[0] : 1.0f;
+
+    // Combined magnitude on the FFT grid, with zero phase
+    std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+    for (int k = 0; k <= length / 2; ++k)
+    {
+        const double w = juce::MathConstants<double>::twoPi * k / length;
+        const auto z1 = std::polar(1.0, -w);
+
+        double magnitude = 1.0;
+        for (const auto& band : bands)
+        {
+            if (!band.isIdentity())
+                magnitude *= magnitudeAt(band, z1);
+        }
+
+        spectrum[static_cast<size_t>(2 * k)] = static_cast<float>(magnitude);
+    }
+
+    designFFT.performRealOnlyInverseTransform(spectrum.data());
+
+    // The zero-phase impulse wraps around 0; centre it and window the ends
+    // (periodic Blackman, so the taps are exactly symmetric about the centre)
+    std::vector<float> taps(static_cast<size_t>(length));
+    const int centre = length / 2;
+    for (int n = 0; n < length; ++n)
+    {
+        const double phase = juce::MathConstants<double>::twoPi * n / length;
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        const int source = (n - centre) & (length - 1);
+        taps[static_cast<size_t>(n)] = static_cast<float>(spectrum[static_cast<size_t>(source)] * scale * window);
+    }
+
+    return taps;
+}
+
+//==============================================================================
+// Handoff
+
+void LinearPhaseEQ::publish(Kernel* kernel)
+{
+    // Called with the design lock held, never on the audio thread
+    delete retired.exchange(nullptr, std::memory_order_acq_rel);
+    delete pending.exchange(kernel, std::memory_order_acq_rel);
+}
+
+void LinearPhaseEQ::adoptPending()
+{
+    // One crossfade at a time, and only once the last faded-out kernel is back
+    if (previous != nullptr
+        || pending.load(std::memory_order_acquire) == nullptr
+        || retired.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    if (auto* next = pending.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        previous = current;
+        current = next;
+    }
+}
+
+//==============================================================================
+// Processing
+
+void LinearPhaseEQ::clearState()
+{
+    for (auto& channel : channels)
+    {
+        std::fill(channel.window.begin(), channel.window.end(), 0.0f);
+        std::fill(channel.output.begin(), channel.output.end(), 0.0f);
+        std::fill(channel.spectra.begin(), channel.spectra.end(), 0.0f);
+    }
+
+    fifoPosition = 0;
+    spectrumIndex = 0;
+}
+
+void LinearPhaseEQ::process(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    const int channelsToProcess = juce::jmin(buffer.getNumChannels(), numChannelsPrepared);
+    numSamples = juce::jmin(numSamples, buffer.getNumSamples());
+
+    if (current == nullptr || channelsToProcess == 0 || numSamples <= 0)
+        return;
+
+    juce::ScopedNoDenormals noDenormals;
+
+    if (resetRequested.exchange(false))
+        clearState();
+
+    int done = 0;
+    while (done < numSamples)
+    {
+        const int count = juce::jmin(BLOCK_SIZE - fifoPosition, numSamples - done);
+
+        for (int ch = 0; ch < channelsToProcess; ++ch)
+        {
+            auto& channel = channels[static_cast<size_t>(ch)];
+            auto* io = buffer.getWritePointer(ch, done);
+
+            std::memcpy(channel.window.data() + BLOCK_SIZE + fifoPosition, io, sizeof(float) * static_cast<size_t>(count));
+            std::memcpy(io, channel.output.data() + fifoPosition, sizeof(float) * static_cast<size_t>(count));
+        }
+
+        fifoPosition += count;
+        done += count;
+
+        if (fifoPosition == BLOCK_SIZE)
+        {
+            processFifoBlock();
+            fifoPosition = 0;
+        }
+    }
+}
+
+void LinearPhaseEQ::processFifoBlock()
+{
+    adoptPending();
+
+    for (auto& channel : channels)
+    {
+        // Spectrum of the last two input blocks into the delay line
+        std::fill(work.begin(), work.end(), 0.0f);
+        std::memcpy(work.data(), channel.window.data(), sizeof(float) * 2 * BLOCK_SIZE);
+        fft->performRealOnlyForwardTransform(work.data(), true);
+        std::memcpy(channel.spectra.data() + spectrumIndex * SPECTRUM_SIZE, work.data(), sizeof(float) * SPECTRUM_SIZE);
+
+        convolve(*current, channel, work.data());
+
+        if (previous != nullptr)
+        {
+            // Same history through the old kernel, faded out over the block
+            convolve(*previous, channel, fadeWork.data());
+
+            const float step = 1.0f / static_cast<float>(BLOCK_SIZE);
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                const float fade = static_cast<float>(i + 1) * step;
+                channel.output[static_cast<size_t>(i)] = fadeWork[static_cast<size_t>(i)]
+                                                       + fade * (work[static_cast<size_t>(i)] - fadeWork[static_cast<size_t>(i)]);
+            }
+        }
+        else
+        {
+            std::memcpy(channel.output.data(), work.data(), sizeof(float) * BLOCK_SIZE);
+        }
+
+        std::memcpy(channel.window.data(), channel.window.data() + BLOCK_SIZE, sizeof(float) * BLOCK_SIZE);
+    }
+
+    spectrumIndex = (spectrumIndex + 1) % numPartitions;
+
+    if (previous != nullptr)
+    {
+        retired.store(previous, std::memory_order_release);
+        previous = nullptr;
+    }
+}
+
+void LinearPhaseEQ::convolve(const Kernel& kernel, const Channel& channel, float* scratch)
+{
+    // Partition p pairs with the input spectrum from p blocks ago
+    std::fill(scratch, scratch + 4 * BLOCK_SIZE, 0.0f);
+
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        const int slot = (spectrumIndex - p + numPartitions) % numPartitions;
+        multiplyAccumulate(scratch, channel.spectra.data() + slot * SPECTRUM_SIZE,
+                           kernel.spectra.data() + p * SPECTRUM_SIZE, BLOCK_SIZE + 1);
+    }
+
+    fft->performRealOnlyInverseTransform(scratch);
+
+    // Overlap-save: the second half is the valid linear convolution
+    std::memmove(scratch, scratch + BLOCK_SIZE, sizeof(float) * BLOCK_SIZE);
+}
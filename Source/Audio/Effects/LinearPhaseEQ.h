@@ -0,0 +1,115 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * LinearPhaseEQ - FIR equaliser with the magnitude response of a biquad set
+ *
+ * The bands are given as biquad coefficients (the same ones the minimum phase
+ * BiquadCascade runs). A background thread evaluates their combined magnitude
+ * on an FFT grid, turns it into a zero-phase impulse, centres and windows it,
+ * so the kernel is symmetric: every frequency is delayed by exactly half the
+ * kernel length and the phase is left alone.
+ *
+ * Kernels are applied with uniformly partitioned overlap-save convolution in
+ * BLOCK_SIZE partitions. Input spectra are kept in a frequency-domain delay
+ * line that doesn't depend on the kernel, so when a new design is adopted the
+ * old and new kernels are both run on the same history for one block and the
+ * outputs crossfaded. Moving a band only ever costs the audio thread that one
+ * extra block of multiply-adds; the design itself never runs there.
+ *
+ * Latency is BLOCK_SIZE (the FIFO) plus half the kernel length, and is
+ * constant for a given sample rate.
+ */
+class LinearPhaseEQ
+{
+public:
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int BLOCK_SIZE = 256;
+    static constexpr int BASE_KERNEL_LENGTH = 8192;  // Up to 48 kHz, doubled per octave above
+    static constexpr int MAX_KERNEL_LENGTH = 32768;
+
+    LinearPhaseEQ();
+    ~LinearPhaseEQ();
+
+    //==========================================================================
+    // Setup (message thread, not while processing)
+
+    /** Allocate for a rate and start from a flat (pure delay) kernel */
+    void prepare(double sampleRate, int numChannels);
+
+    /** Clear the input history and FIFOs (done at the start of the next block) */
+    void reset();
+
+    int getKernelLength() const { return kernelLength; }
+    int getLatencySamples() const { return BLOCK_SIZE + kernelLength / 2; }
+
+    /** Kernel length used at a sample rate */
+    static int kernelLengthFor(double sampleRate);
+
+    //==========================================================================
+    // Response (message thread) - designed on a background thread
+
+    /** Request a kernel for these bands; newer requests supersede older ones */
+    void setBands(std::vector<BiquadCascade::Coefficients> bands);
+
+    /** True while a requested kernel hasn't been published yet */
+    bool isDesigning() const;
+
+    /** Linear phase FIR taps matching the bands' magnitude (any thread but the audio thread) */
+    static std::vector<float> designKernel(const std::vector<BiquadCascade::Coefficients>& bands, int length);
+
+    //==========================================================================
+    // Processing (audio thread)
+
+    void process(juce::AudioBuffer<float>& buffer, int numSamples);
+
+private:
+    struct Kernel;
+    struct DesignState;
+    class Designer;
+
+    struct Channel
+    {
+        std::vector<float> window;      // Previous and current input block
+        std::vector<float> output;      // Block being played out
+        std::vector<float> spectra;     // Frequency-domain delay line
+    };
+
+    static std::unique_ptr<Kernel> partitionKernel(const std::vector<float>& taps);
+
+    void publish(Kernel* kernel);
+    void adoptPending();
+    void clearState();
+    void processFifoBlock();
+    void convolve(const Kernel& kernel, const Channel& channel, float* scratch);
+
+    juce::SharedResourcePointer<Designer> designer;
+    std::shared_ptr<DesignState> designState;
+
+    int kernelLength = BASE_KERNEL_LENGTH;
+    int numPartitions = 0;
+    int numChannelsPrepared = 0;
+    std::unique_ptr<juce::dsp::FFT> fft;    // 2 * BLOCK_SIZE points
+
+    // Audio thread
+    std::vector<Channel> channels;
+    std::vector<float> work, fadeWork;
+    int fifoPosition = 0;
+    int spectrumIndex = 0;
+
+    // Handoff: designs go to pending; the audio thread adopts one when it can
+    // hand the kernel it faded out back through retired
+    Kernel* current = nullptr;              // Audio thread only
+    Kernel* previous = nullptr;             // Audio thread only, set while crossfading
+    std::atomic<Kernel*> pending{nullptr};
+    std::atomic<Kernel*> retired{nullptr};
+    std::atomic<bool> resetRequested{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseEQ)
+};
@@ -0,0 +1,214 @@
+#include "ParametricEQEffect.h"
+
+namespace
+{
+    struct BandDefaults
+    {
+        ParametricEQEffect::BandType type;
+        float frequency;
+        float q;
+        bool on;
+    };
+
+    // Cuts at the edges (off), shelves inside them, bells across the middle
+    constexpr BandDefaults bandDefaults[ParametricEQEffect::NUM_BANDS] = {
+        { ParametricEQEffect::BandType::LowCut,    30.0f,    0.707f, false },
+        { ParametricEQEffect::BandType::LowShelf,  100.0f,   0.707f, true },
+        { ParametricEQEffect::BandType::Bell,      250.0f,   1.0f,   true },
+        { ParametricEQEffect::BandType::Bell,      600.0f,   1.0f,   true },
+        { ParametricEQEffect::BandType::Bell,      1500.0f,  1.0f,   true },
+        { ParametricEQEffect::BandType::Bell,      3500.0f,  1.0f,   true },
+        { ParametricEQEffect::BandType::HighShelf, 8000.0f,  0.707f, true },
+        { ParametricEQEffect::BandType::HighCut,   18000.0f, 0.707f, false }
+    };
+}
+
+ParametricEQEffect::ParametricEQEffect()
+{
+    for (int band = 1; band <= NUM_BANDS; ++band)
+    {
+        const auto& defaults = bandDefaults[band - 1];
+        const juce::String label = "Band " + juce::String(band) + " ";
+
+        addParameter(bandParameter(band, "On"), label + "On", defaults.on ? 1.0f : 0.0f, 0.0f, 1.0f, "", 1.0f);
+        addParameter(bandParameter(band, "Type"), label + "Type", static_cast<float>(defaults.type), 0.0f, 5.0f, "", 1.0f);
+        addParameter(bandParameter(band, "Freq"), label + "Freq", defaults.frequency, 20.0f, 20000.0f, "Hz");
+        addParameter(bandParameter(band, "Gain"), label + "Gain", 0.0f, -18.0f, 18.0f, "dB");
+        addParameter(bandParameter(band, "Q"), label + "Q", defaults.q, 0.1f, 18.0f);
+    }
+
+    addParameter("output", "Output", 0.0f, -18.0f, 18.0f, "dB");
+    addParameter("phase", "Phase", 0.0f, 0.0f, 1.0f, "", 1.0f);
+}
+
+void ParametricEQEffect::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
+{
+    EffectBase::prepareToPlay(newSampleRate, newSamplesPerBlock);
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
+    spec.numChannels = 2;
+
+    outputGain.prepare(spec);
+    outputGain.setRampDurationSeconds(0.02);
+    outputGain.setGainDecibels(getParameter("output"));
+
+    filters.prepare(2);
+    linearPhase.prepare(sampleRate, 2);
+    for (int band = 1; band <= NUM_BANDS; ++band)
+        updateBand(band);
+    updateLinearPhase();
+}
+
+void ParametricEQEffect::reset()
+{
+    EffectBase::reset();
+    filters.reset();
+    linearPhase.reset();
+    outputGain.reset();
+}
+
+void ParametricEQEffect::updateBand(int band)
+{
+    BiquadCascade::Coefficients coefficients;
+
+    if (getParameter(bandParameter(band, "On")) >= 0.5f)
+    {
+        const auto type = static_cast<BandType>(juce::roundToInt(getParameter(bandParameter(band, "Type"))));
+        const float frequency = getParameter(bandParameter(band, "Freq"));
+        const float gainDb = getParameter(bandParameter(band, "Gain"));
+        const float q = getParameter(bandParameter(band, "Q"));
+
+        switch (type)
+        {
+            case BandType::Bell:      coefficients = BiquadCascade::Coefficients::peak(sampleRate, frequency, q, gainDb); break;
+            case BandType::LowShelf:  coefficients = BiquadCascade::Coefficients::lowShelf(sampleRate, frequency, q, gainDb); break;
+            case BandType::HighShelf: coefficients = BiquadCascade::Coefficients::highShelf(sampleRate, frequency, q, gainDb); break;
+            case BandType::LowCut:    coefficients = BiquadCascade::Coefficients::highPass(sampleRate, frequency, q); break;
+            case BandType::HighCut:   coefficients = BiquadCascade::Coefficients::lowPass(sampleRate, frequency, q); break;
+            case BandType::Notch:     coefficients = BiquadCascade::Coefficients::notch(sampleRate, frequency, q); break;
+        }
+    }
+
+    bandCoefficients[static_cast<size_t>(band - 1)] = coefficients;
+    filters.setStage(band - 1, coefficients);
+}
+
+void ParametricEQEffect::updateLinearPhase()
+{
+    linearPhaseMode.store(getParameter("phase") >= 0.5f);
+
+    // Only redesign kernels while they are being heard
+    if (linearPhaseMode.load())
+        linearPhase.setBands({ bandCoefficients.begin(), bandCoefficients.end() });
+}
+
+int ParametricEQEffect::getLatencySamples() const
+{
+    return getParameter("phase") >= 0.5f ? linearPhase.getLatencySamples() : 0;
+}
+
+void ParametricEQEffect::processEffect(juce::AudioBuffer<float>& buffer)
+{
+    const bool linear = linearPhaseMode.load();
+    if (linear != processingLinearPhase)
+    {
+        // Don't replay whatever the other path was holding from before
+        if (linear)
+            linearPhase.reset();
+        else
+            filters.reset();
+        processingLinearPhase = linear;
+    }
+
+    if (linear)
+        linearPhase.process(buffer, buffer.getNumSamples());
+    else
+        filters.process(buffer, buffer.getNumSamples());
+
+    juce::dsp::AudioBlock<float> block(buffer);
+    juce::dsp::ProcessContextReplacing<float> context(block);
+    outputGain.setGainDecibels(getParameter("output"));
+    outputGain.process(context);
+}
+
+void ParametricEQEffect::onParameterChanged(const juce::String& name, float value)
+{
+    juce::ignoreUnused(value);
+
+    // "band<N><Field>"
+    if (name.startsWith("band"))
+    {
+        const int band = name.substring(4, 5).getIntValue();
+        if (band >= 1 && band <= NUM_BANDS)
+        {
+            updateBand(band);
+            updateLinearPhase();
+        }
+    }
+    else if (name == "phase")
+    {
+        updateLinearPhase();
+    }
+}
+
+std::vector<EffectPreset> ParametricEQEffect::getPresets() const
+{
+    std::vector<EffectPreset> presets;
+
+    {
+        EffectPreset p;
+        p.name = "Flat";
+        for (int band = 1; band <= NUM_BANDS; ++band)
+            p.values[bandParameter(band, "Gain")] = 0.0f;
+        p.values[bandParameter(1, "On")] = 0.0f;
+        p.values[bandParameter(8, "On")] = 0.0f;
+        p.values["output"] = 0.0f;
+        presets.push_back(p);
+    }
+
+    {
+        EffectPreset p;
+        p.name = "Vocal Clarity";
+        p.values[bandParameter(1, "On")] = 1.0f;
+        p.values[bandParameter(1, "Freq")] = 90.0f;
+        p.values[bandParameter(3, "Freq")] = 300.0f;
+        p.values[bandParameter(3, "Gain")] = -3.0f;
+        p.values[bandParameter(6, "Freq")] = 3000.0f;
+        p.values[bandParameter(6, "Gain")] = 3.0f;
+        p.values[bandParameter(7, "Freq")] = 10000.0f;
+        p.values[bandParameter(7, "Gain")] = 2.0f;
+        presets.push_back(p);
+    }
+
+    {
+        EffectPreset p;
+        p.name = "Tight Kick";
+        p.values[bandParameter(1, "On")] = 1.0f;
+        p.values[bandParameter(1, "Freq")] = 35.0f;
+        p.values[bandParameter(2, "Freq")] = 60.0f;
+        p.values[bandParameter(2, "Gain")] = 4.0f;
+        p.values[bandParameter(4, "Freq")] = 400.0f;
+        p.values[bandParameter(4, "Gain")] = -5.0f;
+        p.values[bandParameter(4, "Q")] = 1.5f;
+        p.values[bandParameter(6, "Freq")] = 4000.0f;
+        p.values[bandParameter(6, "Gain")] = 3.0f;
+        presets.push_back(p);
+    }
+
+    {
+        EffectPreset p;
+        p.name = "Mix Bus Air";
+        p.values[bandParameter(1, "On")] = 1.0f;
+        p.values[bandParameter(1, "Freq")] = 25.0f;
+        p.values[bandParameter(4, "Freq")] = 500.0f;
+        p.values[bandParameter(4, "Gain")] = -1.0f;
+        p.values[bandParameter(4, "Q")] = 0.7f;
+        p.values[bandParameter(7, "Freq")] = 12000.0f;
+        p.values[bandParameter(7, "Gain")] = 2.5f;
+        presets.push_back(p);
+    }
+
+    return presets;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "EffectBase.h"
+#include "BiquadCascade.h"
+#include "LinearPhaseEQ.h"
+#include <array>
+#include <atomic>
+
+/**
+ * ParametricEQEffect - 8-band parametric EQ
+ *
+ * Every band is one stage of a stereo BiquadCascade, so all eight bands run as
+ * a single pass over the buffer with both channels in SIMD lanes. Bands that
+ * are off or at 0 dB cost nothing, and parameter moves are ramped.
+ *
+ * In linear phase mode the same band curves are applied by a LinearPhaseEQ
+ * instead: no phase shift, at the cost of the latency it reports.
+ *
+ * Parameters (per band N = 1-8):
+ * - bandNOn: Band enabled (0/1)
+ * - bandNType: 0=bell, 1=low shelf, 2=high shelf, 3=low cut, 4=high cut, 5=notch
+ * - bandNFreq: Frequency in Hz (20-20000)
+ * - bandNGain: Gain in dB (-18 to +18, bell and shelves)
+ * - bandNQ: Q (0.1-18)
+ * - output: Output gain in dB (-18 to +18)
+ * - phase: 0=minimum phase (zero latency), 1=linear phase
+ */
+class ParametricEQEffect : public EffectBase
+{
+public:
+    static constexpr int NUM_BANDS = 8;
+
+    enum class BandType
+    {
+        Bell = 0,
+        LowShelf,
+        HighShelf,
+        LowCut,
+        HighCut,
+        Notch
+    };
+
+    ParametricEQEffect();
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void reset() override;
+
+    juce::String getName() const override { return "Parametric EQ"; }
+    juce::String getCategory() const override { return "Filter"; }
+
+    std::vector<EffectPreset> getPresets() const override;
+
+    int getLatencySamples() const override;
+
+    /** True while a linear phase redesign hasn't reached the audio thread yet */
+    bool isUpdatingLinearPhase() const { return linearPhase.isDesigning(); }
+    bool isLoading() const override { return isUpdatingLinearPhase(); }
+
+    /** Parameter id for a band (1-based, matching the UI) */
+    static juce::String bandParameter(int band, const char* suffix) { return "band" + juce::String(band) + suffix; }
+
+protected:
+    void processEffect(juce::AudioBuffer<float>& buffer) override;
+    void onParameterChanged(const juce::String& name, float value) override;
+
+private:
+    void updateBand(int band);
+    void updateLinearPhase();
+
+    BiquadCascade filters;
+    LinearPhaseEQ linearPhase;
+    std::array<BiquadCascade::Coefficients, NUM_BANDS> bandCoefficients;
+    std::atomic<bool> linearPhaseMode{false};
+    bool processingLinearPhase = false;     // Audio thread
+    juce::dsp::Gain<float> outputGain;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParametricEQEffect)
+};
@@ -6,6 +6,7 @@ ReverbEffect::ReverbEffect()
     addParameter("damping", "Damping", 0.5f, 0.0f, 1.0f);
     addParameter("width", "Width", 1.0f, 0.0f, 1.0f);
     addParameter("predelay", "Pre-delay", 0.0f, 0.0f, 100.0f, "ms");
+    addParameter("quality", "Quality", 1.0f, 0.0f, 2.0f, "", 1.0f);
 
     updateReverbParams();
 }
@@ -14,13 +15,7 @@ void ReverbEffect::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 {
     EffectBase::prepareToPlay(newSampleRate, newSamplesPerBlock);
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = 2;
-
-    reverb.prepare(spec);
-    reverb.setParameters(reverbParams);
+    reverb.prepare(sampleRate);
 }
 
 void ReverbEffect::releaseResources()
@@ -37,9 +32,12 @@ void ReverbEffect::reset()
 
 void ReverbEffect::processEffect(juce::AudioBuffer<float>& buffer)
 {
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    reverb.process(context);
+    if (buffer.getNumChannels() == 0)
+        return;
+
+    reverb.process(buffer.getWritePointer(0),
+                   buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr,
+                   buffer.getNumSamples());
 }
 
 void ReverbEffect::onParameterChanged(const juce::String& name, float value)
@@ -49,14 +47,23 @@ void ReverbEffect::onParameterChanged(const juce::String& name, float value)
 
 void ReverbEffect::updateReverbParams()
 {
-    reverbParams.roomSize = getParameter("roomSize");
-    reverbParams.damping = getParameter("damping");
-    reverbParams.width = getParameter("width");
-    reverbParams.wetLevel = 1.0f; // We handle wet/dry in base class
-    reverbParams.dryLevel = 0.0f;
-    reverbParams.freezeMode = 0.0f;
-
-    reverb.setParameters(reverbParams);
+    // Wet/dry is handled in the base class
+    FDNReverb::Parameters params;
+    params.roomSize = getParameter("roomSize");
+    params.damping = getParameter("damping");
+    params.width = getParameter("width");
+    params.predelayMs = getParameter("predelay");
+
+    reverb.setParameters(params);
+    reverb.setQuality(static_cast<FDNReverb::Quality>(juce::jlimit(0, 2, juce::roundToInt(getParameter("quality")))));
+}
+
+int ReverbEffect::getTailSamples() const
+{
+    // Two RT60s take the tail from 0 dB to around -120 dB
+    const float seconds = getParameter("predelay") * 0.001f
+                        + 2.0f * FDNReverb::getDecaySeconds(getParameter("roomSize"));
+    return static_cast<int>(seconds * static_cast<float>(sampleRate));
 }
 
 std::vector<EffectPreset> ReverbEffect::getPresets() const
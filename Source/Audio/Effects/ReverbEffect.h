@@ -1,14 +1,17 @@
 #pragma once
 
 #include "EffectBase.h"
+#include "FDNReverb.h"
 
 /**
- * ReverbEffect - Algorithmic reverb using JUCE's built-in reverb
+ * ReverbEffect - Algorithmic reverb built on a vectorised feedback delay network
  *
  * Parameters:
  * - roomSize: Room size (0-1)
  * - damping: High frequency damping (0-1)
  * - width: Stereo width (0-1)
+ * - predelay: Pre-delay (0-100 ms)
+ * - quality: 0 = Eco (8 lines), 1 = Standard (8 modulated), 2 = High (16 modulated)
  * - wet: Wet/dry mix (0-1)
  */
 class ReverbEffect : public EffectBase
@@ -25,13 +28,14 @@ public:
 
     std::vector<EffectPreset> getPresets() const override;
 
+    int getTailSamples() const override;
+
 protected:
     void processEffect(juce::AudioBuffer<float>& buffer) override;
     void onParameterChanged(const juce::String& name, float value) override;
 
 private:
-    juce::dsp::Reverb reverb;
-    juce::dsp::Reverb::Parameters reverbParams;
+    FDNReverb reverb;
 
     void updateReverbParams();
 
@@ -68,6 +68,12 @@ float SidechainCompressorEffect::computeGain(float inputDb) const
     return -gainReductionDb;  // Negative because it's reduction
 }
 
+void SidechainCompressorEffect::copyStateFrom(const EffectBase& other)
+{
+    EffectBase::copyStateFrom(other);
+    setSidechainSource(other.getSidechainSource());
+}
+
 void SidechainCompressorEffect::setSidechainSource(int trackIndex)
 {
     sidechainSourceTrack = trackIndex;
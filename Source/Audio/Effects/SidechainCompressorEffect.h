@@ -29,6 +29,8 @@ public:
 
     std::vector<EffectPreset> getPresets() const override;
 
+    void copyStateFrom(const EffectBase& other) override;
+
     //==========================================================================
     // Sidechain routing
 
@@ -37,14 +39,14 @@ public:
      * -1 means no source (compressor acts like normal compressor)
      */
     void setSidechainSource(int trackIndex);
-    int getSidechainSource() const { return sidechainSourceTrack; }
+    int getSidechainSource() const override { return sidechainSourceTrack; }
 
     /**
      * Provide sidechain audio for the current processing block.
      * Must be called before processBlock() if sidechainSource >= 0.
      * @param buffer The sidechain audio buffer (key signal)
      */
-    void setSidechainInput(const juce::AudioBuffer<float>& buffer);
+    void setSidechainInput(const juce::AudioBuffer<float>& buffer) override;
 
     /**
      * Check if sidechain input has been provided for this block
@@ -0,0 +1,51 @@
+#include "GroupBus.h"
+
+GroupBus::GroupBus(const juce::String& busName)
+    : name(busName)
+{
+}
+
+void GroupBus::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    effectChain.prepareToPlay(sampleRate, samplesPerBlock);
+}
+
+void GroupBus::releaseResources()
+{
+    effectChain.releaseResources();
+}
+
+void GroupBus::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (muted.load())
+    {
+        buffer.clear(0, numSamples);
+        meterLevel.store(0.0f);
+        return;
+    }
+
+    juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+    effectChain.processBlock(block);
+
+    // Same equal-power pan law as Track
+    const float vol = volume.load();
+    const float p = pan.load();
+
+    if (block.getNumChannels() >= 2)
+    {
+        block.applyGain(0, 0, numSamples, vol * std::cos((p + 1.0f) * juce::MathConstants<float>::halfPi * 0.5f));
+        block.applyGain(1, 0, numSamples, vol * std::sin((p + 1.0f) * juce::MathConstants<float>::halfPi * 0.5f));
+    }
+    else if (block.getNumChannels() == 1)
+    {
+        block.applyGain(vol);
+    }
+
+    float rms = 0.0f;
+    for (int ch = 0; ch < block.getNumChannels(); ++ch)
+        rms += block.getRMSLevel(ch, 0, numSamples);
+    rms /= static_cast<float>(juce::jmax(1, block.getNumChannels()));
+
+    const float smoothing = 0.8f;
+    meterLevel.store(meterLevel.load() * smoothing + rms * (1.0f - smoothing));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Effects/EffectChain.h"
+#include <atomic>
+
+/**
+ * GroupBus - Submix that tracks (or other groups) can be routed into
+ *
+ * The mixer graph sums everything routed to the group into one buffer; the
+ * group then runs its EffectChain and fader over the sum and passes it on to
+ * its own destination (another group or the master).
+ */
+class GroupBus
+{
+public:
+    explicit GroupBus(const juce::String& name = "Group");
+    ~GroupBus() = default;
+
+    //==========================================================================
+    // Audio processing
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    void releaseResources();
+
+    /** Process the summed input in place (audio thread) */
+    void processBlock(juce::AudioBuffer<float>& buffer, int numSamples);
+
+    //==========================================================================
+    // Properties
+    const juce::String& getName() const { return name; }
+    void setName(const juce::String& newName) { name = newName; }
+
+    void setVolume(float newVolume) { volume.store(juce::jlimit(0.0f, 2.0f, newVolume)); }
+    float getVolume() const { return volume.load(); }
+
+    void setPan(float newPan) { pan.store(juce::jlimit(-1.0f, 1.0f, newPan)); }
+    float getPan() const { return pan.load(); }
+
+    void setMuted(bool shouldBeMuted) { muted.store(shouldBeMuted); }
+    bool isMuted() const { return muted.load(); }
+
+    // Destination group slot, or -1 for the master (set via AudioEngine)
+    int getOutputGroup() const { return outputGroup.load(); }
+    void setOutputGroup(int groupSlot) { outputGroup.store(groupSlot); }
+
+    float getMeterLevel() const { return meterLevel.load(); }
+
+    EffectChain& getEffectChain() { return effectChain; }
+
+    /** Samples the group's inserts delay it by (the mixer graph compensates) */
+    int getLatencySamples() const { return effectChain.getLatencySamples(); }
+
+private:
+    juce::String name;
+    EffectChain effectChain;
+
+    std::atomic<float> volume{1.0f};
+    std::atomic<float> pan{0.0f};
+    std::atomic<bool> muted{false};
+    std::atomic<int> outputGroup{-1};
+    std::atomic<float> meterLevel{0.0f};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GroupBus)
+};
@@ -34,6 +34,7 @@ void MidiClip::removeNote(const juce::Uuid& noteId)
             [&noteId](const Note& n) { return n.id == noteId; }),
         notes.end()
     );
+    ++editVersion;
 }
 
 void MidiClip::updateNote(const juce::Uuid& noteId, const Note& newNote)
@@ -55,6 +56,8 @@ void MidiClip::updateNote(const juce::Uuid& noteId, const Note& newNote)
 
 Note* MidiClip::findNote(const juce::Uuid& noteId)
 {
+    ++editVersion;
+
     for (auto& note : notes)
     {
         if (note.id == noteId)
@@ -76,6 +79,7 @@ const Note* MidiClip::findNote(const juce::Uuid& noteId) const
 void MidiClip::clear()
 {
     notes.clear();
+    ++editVersion;
 }
 
 //==============================================================================
@@ -180,6 +184,8 @@ void MidiClip::quantizeNotes(const std::vector<juce::Uuid>& noteIds, double snap
 
 void MidiClip::transposeNotes(int semitones)
 {
+    ++editVersion;
+
     for (auto& note : notes)
     {
         note.midiNote = juce::jlimit(0, 127, note.midiNote + semitones);
@@ -188,6 +194,8 @@ void MidiClip::transposeNotes(int semitones)
 
 void MidiClip::transposeNotes(const std::vector<juce::Uuid>& noteIds, int semitones)
 {
+    ++editVersion;
+
     for (auto& note : notes)
     {
         for (const auto& id : noteIds)
@@ -351,4 +359,5 @@ std::unique_ptr<MidiClip> MidiClip::fromVar(const juce::var& data)
 void MidiClip::sortNotes()
 {
     std::stable_sort(notes.begin(), notes.end());
+    ++editVersion;
 }
@@ -102,10 +102,10 @@ public:
     //==========================================================================
     // Position & Duration (in bars, project-relative)
     double getStartBar() const { return startBar; }
-    void setStartBar(double bar) { startBar = bar; }
+    void setStartBar(double bar) { startBar = bar; ++editVersion; }
 
     double getDurationBars() const { return durationBars; }
-    void setDurationBars(double bars) { durationBars = std::max(0.25, bars); }
+    void setDurationBars(double bars) { durationBars = std::max(0.25, bars); ++editVersion; }
 
     double getEndBar() const { return startBar + durationBars; }
 
@@ -124,7 +124,7 @@ public:
     const Note* findNote(const juce::Uuid& noteId) const;
 
     const std::vector<Note>& getNotes() const { return notes; }
-    std::vector<Note>& getNotes() { return notes; }
+    std::vector<Note>& getNotes() { ++editVersion; return notes; }
 
     // Clear all notes
     void clear();
@@ -132,6 +132,10 @@ public:
     // Get note count
     size_t getNumNotes() const { return notes.size(); }
 
+    // Changes whenever the notes or the clip's position may have changed.
+    // Handing out a mutable note (findNote, getNotes) counts as an edit.
+    juce::uint32 getEditVersion() const { return editVersion; }
+
     //==========================================================================
     // Playback Query
     // Get notes that should start within a beat range (relative to clip start)
@@ -185,6 +189,7 @@ private:
     double durationBars = 4.0;        // Default 4 bars
 
     std::vector<Note> notes;
+    juce::uint32 editVersion = 0;
 
     // Keep notes sorted by startBeat for efficient range queries
     void sortNotes();
@@ -0,0 +1,450 @@
+#include "MixerGraph.h"
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+//==============================================================================
+// Worker thread - runs its share of each level it is woken for
+//==============================================================================
+
+class MixerGraph::Worker : public juce::Thread
+{
+public:
+    Worker(MixerGraph& graphToUse, int index)
+        : juce::Thread("Mixer Worker " + juce::String(index)),
+          graph(graphToUse), workerIndex(index)
+    {
+        // Realtime scheduling needs privileges we may not have
+        if (!startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(8)))
+            startThread(juce::Thread::Priority::highest);
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wake.signal();
+        stopThread(2000);
+    }
+
+    void start() { wake.signal(); }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            if (!wake.wait(100))
+                continue;
+
+            if (threadShouldExit())
+                break;
+
+            graph.workerRun(workerIndex);
+        }
+    }
+
+private:
+    MixerGraph& graph;
+    const int workerIndex;
+    juce::WaitableEvent wake;
+};
+
+//==============================================================================
+
+MixerGraph::MixerGraph() = default;
+
+MixerGraph::~MixerGraph()
+{
+    workers.clear();
+}
+
+int MixerGraph::getNodeLevel(int node) const
+{
+    if (node < 0 || node >= static_cast<int>(nodeLevels.size()))
+        return -1;
+    return nodeLevels[static_cast<size_t>(node)];
+}
+
+//==============================================================================
+// Compilation
+//==============================================================================
+
+int MixerGraph::getNodeCompensation(int node) const
+{
+    if (node < 0 || node >= static_cast<int>(compensation.size()))
+        return 0;
+    return compensation[static_cast<size_t>(node)].getDelay();
+}
+
+bool MixerGraph::compile(const std::vector<NodeInfo>& description, int newNumChannels, int maxBlockSize,
+                         int minimumLatency)
+{
+    const int numNodes = static_cast<int>(description.size());
+    auto nodes = description;
+    bool intact = true;
+
+    auto isNode = [numNodes](int n) { return n >= 0 && n < numNodes; };
+
+    // Drop edges that point nowhere or at the node itself
+    for (int n = 0; n < numNodes; ++n)
+    {
+        auto& node = nodes[static_cast<size_t>(n)];
+        if (node.destination != MASTER && (!isNode(node.destination) || node.destination == n))
+            node.destination = MASTER;
+
+        auto& keys = node.keySources;
+        keys.erase(std::remove_if(keys.begin(), keys.end(),
+                                  [&](int k) { return !isNode(k) || k == n; }),
+                   keys.end());
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+    //==========================================================================
+    // Levels by longest path (Kahn's algorithm). Anything left over is on a
+    // cycle: first its keys are dropped, then its destination goes to master.
+    std::vector<int> level(static_cast<size_t>(numNodes), 0);
+
+    auto computeLevels = [&]() -> std::vector<int>
+    {
+        std::vector<std::vector<int>> successors(static_cast<size_t>(numNodes));
+        std::vector<int> inDegree(static_cast<size_t>(numNodes), 0);
+
+        for (int n = 0; n < numNodes; ++n)
+        {
+            const auto& node = nodes[static_cast<size_t>(n)];
+            if (node.destination != MASTER)
+            {
+                successors[static_cast<size_t>(n)].push_back(node.destination);
+                ++inDegree[static_cast<size_t>(node.destination)];
+            }
+            for (int key : node.keySources)
+            {
+                successors[static_cast<size_t>(key)].push_back(n);
+                ++inDegree[static_cast<size_t>(n)];
+            }
+        }
+
+        std::vector<int> ready;
+        for (int n = 0; n < numNodes; ++n)
+        {
+            level[static_cast<size_t>(n)] = 0;
+            if (inDegree[static_cast<size_t>(n)] == 0)
+                ready.push_back(n);
+        }
+
+        while (!ready.empty())
+        {
+            const int n = ready.back();
+            ready.pop_back();
+
+            for (int next : successors[static_cast<size_t>(n)])
+            {
+                level[static_cast<size_t>(next)] = std::max(level[static_cast<size_t>(next)],
+                                                            level[static_cast<size_t>(n)] + 1);
+                if (--inDegree[static_cast<size_t>(next)] == 0)
+                    ready.push_back(next);
+            }
+        }
+
+        std::vector<int> unresolved;
+        for (int n = 0; n < numNodes; ++n)
+            if (inDegree[static_cast<size_t>(n)] > 0)
+                unresolved.push_back(n);
+        return unresolved;
+    };
+
+    auto unresolved = computeLevels();
+    if (!unresolved.empty())
+    {
+        intact = false;
+        for (int n : unresolved)
+            nodes[static_cast<size_t>(n)].keySources.clear();
+        unresolved = computeLevels();
+    }
+    if (!unresolved.empty())
+    {
+        for (int n : unresolved)
+            nodes[static_cast<size_t>(n)].destination = MASTER;
+        unresolved = computeLevels();
+    }
+    jassert(unresolved.empty());
+
+    const int numLevels = numNodes > 0 ? *std::max_element(level.begin(), level.end()) + 1 : 0;
+
+    //==========================================================================
+    // Liveness: a node's buffer is written from the first level one of its
+    // inputs merges into it (or its own level), and read until its own merge
+    // or the last node it keys, whichever is later.
+    std::vector<int> liveStart(level), liveEnd(level);
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+        const auto& node = nodes[static_cast<size_t>(n)];
+        if (node.destination != MASTER)
+        {
+            auto& start = liveStart[static_cast<size_t>(node.destination)];
+            start = std::min(start, level[static_cast<size_t>(n)]);
+        }
+        for (int key : node.keySources)
+        {
+            auto& end = liveEnd[static_cast<size_t>(key)];
+            end = std::max(end, level[static_cast<size_t>(n)]);
+        }
+    }
+
+    // Nodes nobody reads after their own level (no inputs, not a key) are
+    // rendered in a per-worker scratch buffer and merged straight away
+    auto isTransient = [&](int n)
+    {
+        return liveStart[static_cast<size_t>(n)] == level[static_cast<size_t>(n)]
+            && liveEnd[static_cast<size_t>(n)] == level[static_cast<size_t>(n)];
+    };
+
+    // Greedy interval colouring of the rest - reuse the slot freed earliest
+    std::vector<int> order;
+    for (int n = 0; n < numNodes; ++n)
+        if (!isTransient(n))
+            order.push_back(n);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+    {
+        return liveStart[static_cast<size_t>(a)] < liveStart[static_cast<size_t>(b)];
+    });
+
+    std::vector<int> bufferOf(static_cast<size_t>(numNodes), -1);
+    std::vector<int> slotFreeAfter;   // Last level each slot is busy for
+
+    for (int n : order)
+    {
+        int chosen = -1;
+        for (int slot = 0; slot < static_cast<int>(slotFreeAfter.size()); ++slot)
+        {
+            if (slotFreeAfter[static_cast<size_t>(slot)] < liveStart[static_cast<size_t>(n)]
+                && (chosen < 0 || slotFreeAfter[static_cast<size_t>(slot)] < slotFreeAfter[static_cast<size_t>(chosen)]))
+                chosen = slot;
+        }
+
+        if (chosen < 0)
+        {
+            chosen = static_cast<int>(slotFreeAfter.size());
+            slotFreeAfter.push_back(0);
+        }
+
+        slotFreeAfter[static_cast<size_t>(chosen)] = liveEnd[static_cast<size_t>(n)];
+        bufferOf[static_cast<size_t>(n)] = chosen;
+    }
+
+    //==========================================================================
+    // Delay compensation. In level order every input is final before its
+    // destination is looked at: a node's output is late by the latest of its
+    // inputs plus its own latency, and each input is delayed up to the latest.
+    std::vector<int> byLevel(static_cast<size_t>(numNodes));
+    std::iota(byLevel.begin(), byLevel.end(), 0);
+    std::stable_sort(byLevel.begin(), byLevel.end(), [&](int a, int b)
+    {
+        return level[static_cast<size_t>(a)] < level[static_cast<size_t>(b)];
+    });
+
+    std::vector<int> inputLatency(static_cast<size_t>(numNodes), 0);
+    std::vector<int> outputArrival(static_cast<size_t>(numNodes), 0);
+    int masterArrival = std::max(0, minimumLatency);
+
+    for (int n : byLevel)
+    {
+        const auto& node = nodes[static_cast<size_t>(n)];
+        outputArrival[static_cast<size_t>(n)] = inputLatency[static_cast<size_t>(n)] + std::max(0, node.latency);
+
+        if (node.destination != MASTER)
+        {
+            auto& arrival = inputLatency[static_cast<size_t>(node.destination)];
+            arrival = std::max(arrival, outputArrival[static_cast<size_t>(n)]);
+        }
+        else
+        {
+            masterArrival = std::max(masterArrival, outputArrival[static_cast<size_t>(n)]);
+        }
+    }
+
+    numChannels = std::max(1, newNumChannels);
+    compensation.resize(static_cast<size_t>(numNodes));
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+        const auto& node = nodes[static_cast<size_t>(n)];
+        const int meet = node.destination != MASTER ? inputLatency[static_cast<size_t>(node.destination)]
+                                                    : masterArrival;
+        compensation[static_cast<size_t>(n)].setDelay(meet - outputArrival[static_cast<size_t>(n)], numChannels);
+    }
+
+    outputLatency = masterArrival;
+
+    //==========================================================================
+    // Schedule
+    levels.assign(static_cast<size_t>(numLevels), {});
+
+    for (int n = 0; n < numNodes; ++n)
+    {
+        const auto& node = nodes[static_cast<size_t>(n)];
+
+        Step step;
+        step.node = n;
+        step.buffer = bufferOf[static_cast<size_t>(n)];
+        step.destinationBuffer = node.destination != MASTER
+                               ? bufferOf[static_cast<size_t>(node.destination)] : -1;
+        for (int key : node.keySources)
+            step.keys.emplace_back(key, bufferOf[static_cast<size_t>(key)]);
+
+        if (step.buffer >= 0)
+            levels[static_cast<size_t>(liveStart[static_cast<size_t>(n)])].buffersToClear.push_back(step.buffer);
+        levels[static_cast<size_t>(level[static_cast<size_t>(n)])].steps.push_back(std::move(step));
+    }
+
+    nodeLevels = level;
+    blockSize = std::max(1, maxBlockSize);
+
+    buffers.resize(slotFreeAfter.size());
+    for (auto& buffer : buffers)
+        buffer.setSize(numChannels, blockSize, false, true);
+
+    slotLocks = std::make_unique<juce::SpinLock[]>(buffers.size());
+    allocateScratchBuffers();
+
+    return intact;
+}
+
+void MixerGraph::allocateScratchBuffers()
+{
+    scratchBuffers.resize(workers.size() + 1);
+    for (auto& buffer : scratchBuffers)
+        buffer.setSize(numChannels, blockSize, false, true);
+}
+
+//==============================================================================
+// Parallel execution
+//==============================================================================
+
+void MixerGraph::setNumWorkers(int numWorkers)
+{
+    numWorkers = juce::jlimit(0, 16, numWorkers);
+
+    while (static_cast<int>(workers.size()) > numWorkers)
+        workers.pop_back();
+
+    while (static_cast<int>(workers.size()) < numWorkers)
+        workers.push_back(std::make_unique<Worker>(*this, static_cast<int>(workers.size()) + 1));
+
+    allocateScratchBuffers();
+}
+
+void MixerGraph::workerRun(int workerIndex)
+{
+    // Announce ourselves before looking, so the audio thread either sees us
+    // or we see the level closed
+    workersInside.fetch_add(1);
+
+    if (levelOpen.load())
+        runSteps(*activeLevel, workerIndex, *activeProcessor, activeNumSamples);
+
+    workersInside.fetch_sub(1);
+}
+
+//==============================================================================
+// Processing
+//==============================================================================
+
+void MixerGraph::process(juce::AudioBuffer<float>& output, int numSamples, NodeProcessor& processor)
+{
+    if (levels.empty())
+        return;
+
+    activeOutput = &output;
+
+    // Grow if the host hands us more than it announced
+    for (auto* pool : { &buffers, &scratchBuffers })
+    {
+        for (auto& buffer : *pool)
+        {
+            if (buffer.getNumSamples() < numSamples)
+                buffer.setSize(numChannels, numSamples, false, false, true);
+        }
+    }
+
+    for (const auto& level : levels)
+    {
+        for (int slot : level.buffersToClear)
+            buffers[static_cast<size_t>(slot)].clear(0, numSamples);
+
+        const int numSteps = static_cast<int>(level.steps.size());
+        const int numHelpers = std::min(getNumWorkers(), numSteps - 1);
+
+        if (numHelpers > 0)
+        {
+            activeLevel = &level;
+            activeProcessor = &processor;
+            activeNumSamples = numSamples;
+            nextStep.store(0);
+            levelOpen.store(true);
+
+            for (int w = 0; w < numHelpers; ++w)
+                workers[static_cast<size_t>(w)]->start();
+
+            // Steps are claimed one at a time, so a worker that is slow to
+            // wake (or never gets the CPU) leaves its share to the audio thread
+            runSteps(level, 0, processor, numSamples);
+
+            // Only steps a worker has already started are waited for
+            levelOpen.store(false);
+            while (workersInside.load() > 0)
+                std::this_thread::yield();
+
+            activeLevel = nullptr;
+            activeProcessor = nullptr;
+        }
+        else
+        {
+            for (const auto& step : level.steps)
+                runStep(step, 0, processor, numSamples);
+        }
+    }
+
+    activeOutput = nullptr;
+}
+
+void MixerGraph::runSteps(const Level& level, int workerIndex, NodeProcessor& processor, int numSamples)
+{
+    const int numSteps = static_cast<int>(level.steps.size());
+
+    for (int i = nextStep.fetch_add(1); i < numSteps; i = nextStep.fetch_add(1))
+        runStep(level.steps[static_cast<size_t>(i)], workerIndex, processor, numSamples);
+}
+
+void MixerGraph::runStep(const Step& step, int workerIndex, NodeProcessor& processor, int numSamples)
+{
+    // Slots are sized for the largest block; hand out views of just this one
+    // (referring to existing channels doesn't allocate)
+    auto view = [numSamples](juce::AudioBuffer<float>& source)
+    {
+        return juce::AudioBuffer<float>(source.getArrayOfWritePointers(), source.getNumChannels(), numSamples);
+    };
+
+    for (const auto& [sourceNode, sourceBuffer] : step.keys)
+        processor.provideSidechain(step.node, sourceNode, view(buffers[static_cast<size_t>(sourceBuffer)]));
+
+    auto& slot = step.buffer >= 0 ? buffers[static_cast<size_t>(step.buffer)]
+                                   : scratchBuffers[static_cast<size_t>(workerIndex)];
+    if (step.buffer < 0)
+        slot.clear(0, numSamples);
+
+    auto buffer = view(slot);
+    processor.processNode(step.node, buffer, numSamples, workerIndex);
+    compensation[static_cast<size_t>(step.node)].process(buffer, numSamples);
+
+    // Merge into the destination straight away; nodes of the same level may
+    // share a destination, so each one has its own lock
+    auto& dest = step.destinationBuffer >= 0 ? buffers[static_cast<size_t>(step.destinationBuffer)] : *activeOutput;
+    auto& destLock = step.destinationBuffer >= 0 ? slotLocks[static_cast<size_t>(step.destinationBuffer)] : outputLock;
+    const int channels = std::min(buffer.getNumChannels(), dest.getNumChannels());
+
+    const juce::SpinLock::ScopedLockType sl(destLock);
+    for (int ch = 0; ch < channels; ++ch)
+        dest.addFrom(ch, 0, buffer, ch, 0, numSamples);
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "CompensationDelay.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * MixerGraph - Compiled schedule for the mixer's routing
+ *
+ * Nodes are tracks and group buses. Each node has one destination (a group
+ * node, or the master output) and may be keyed by other nodes' outputs
+ * (sidechain edges). compile() turns that description into:
+ *
+ * - Levels: every node runs after all of its inputs and keys. Nodes in the
+ *   same level are independent and can run in parallel.
+ * - Buffer slots: a node's buffer is live from the first write into it
+ *   until its last reader has run. Nodes nobody reads later (a plain track
+ *   routed to a group or master) just use their worker's scratch buffer and
+ *   are summed into the destination immediately. Group and key buffers get
+ *   slots handed out greedily over their live intervals, so a large mix needs
+ *   only as many buffers as are live at once, not one per track.
+ * - Delay compensation: from each node's reported latency, the time its
+ *   output reaches its destination. Every input of a group, and of the
+ *   master, is held back to match the latest one, so parallel paths stay
+ *   sample-aligned however much lookahead is on them.
+ *
+ * process() then runs the schedule for a block, calling back into a
+ * NodeProcessor for the actual work. It is executed on the audio thread,
+ * with a small pool of worker threads joining in for wide levels. Steps are
+ * claimed rather than dealt out, and the audio thread runs whatever no
+ * worker has started, so it only ever waits for steps already under way.
+ *
+ * compile() and process() must not overlap - AudioEngine serialises them
+ * with its track lock.
+ */
+class MixerGraph
+{
+public:
+    static constexpr int MASTER = -1;
+
+    /** How one node is wired */
+    struct NodeInfo
+    {
+        int destination = MASTER;       // Node this one is summed into
+        std::vector<int> keySources;    // Nodes whose output keys this one
+        int latency = 0;                // Samples the node's own processing delays its output
+    };
+
+    /** Does the per-node work for process() */
+    class NodeProcessor
+    {
+    public:
+        virtual ~NodeProcessor() = default;
+
+        /** Hand a key source's output to node before it is processed */
+        virtual void provideSidechain(int node, int sourceNode, const juce::AudioBuffer<float>& key) = 0;
+
+        /**
+         * Process node in place. buffer is numSamples long and already holds
+         * the sum of everything routed into it (silence for tracks). workerIndex is 0 on the audio
+         * thread and 1..getNumWorkers() on the worker threads.
+         */
+        virtual void processNode(int node, juce::AudioBuffer<float>& buffer, int numSamples, int workerIndex) = 0;
+    };
+
+    MixerGraph();
+    ~MixerGraph();
+
+    //==========================================================================
+    // Compilation (message thread)
+
+    /**
+     * Build the schedule. Routing or sidechain cycles are broken (keys are
+     * dropped first, then destinations fall back to master) and reported by
+     * returning false.
+     *
+     * Paths to the master are delayed to at least minimumLatency, for audio
+     * that reaches the master outside the graph with latency of its own.
+     */
+    bool compile(const std::vector<NodeInfo>& nodes, int numChannels, int maxBlockSize,
+                 int minimumLatency = 0);
+
+    int getNumNodes() const { return static_cast<int>(nodeLevels.size()); }
+    int getNumLevels() const { return static_cast<int>(levels.size()); }
+    int getNumBuffers() const { return static_cast<int>(buffers.size() + scratchBuffers.size()); }
+    int getNodeLevel(int node) const;
+
+    /** Delay added after a node so it meets the other inputs of its destination */
+    int getNodeCompensation(int node) const;
+
+    /** Latency of everything arriving at the master, compensation included */
+    int getLatencySamples() const { return outputLatency; }
+
+    //==========================================================================
+    // Parallel execution
+
+    /** Worker threads used for levels with more than one node (0 = serial) */
+    void setNumWorkers(int numWorkers);
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+
+    //==========================================================================
+    // Processing (audio thread)
+
+    /** Run every node and add whatever is routed to master into output */
+    void process(juce::AudioBuffer<float>& output, int numSamples, NodeProcessor& processor);
+
+private:
+    struct Step
+    {
+        int node = 0;
+        int buffer = -1;                // -1 = the worker's scratch buffer
+        int destinationBuffer = -1;     // -1 = master output
+        std::vector<std::pair<int, int>> keys;  // (source node, source buffer)
+    };
+
+    struct Level
+    {
+        std::vector<Step> steps;
+        std::vector<int> buffersToClear;    // Slots whose interval starts here
+    };
+
+    class Worker;
+
+    std::vector<Level> levels;
+    std::vector<int> nodeLevels;
+    std::vector<juce::AudioBuffer<float>> buffers;          // Live-interval slots
+    std::vector<juce::AudioBuffer<float>> scratchBuffers;   // One per worker (+ audio thread)
+    std::unique_ptr<juce::SpinLock[]> slotLocks;
+    juce::SpinLock outputLock;
+    int numChannels = 2;
+    int blockSize = 512;
+
+    // Per node, kept across compiles so a latency change fades instead of
+    // dropping what is in the line
+    std::vector<CompensationDelay> compensation;
+    int outputLatency = 0;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Shared with workers while a level runs
+    juce::AudioBuffer<float>* activeOutput = nullptr;
+    const Level* activeLevel = nullptr;
+    NodeProcessor* activeProcessor = nullptr;
+    int activeNumSamples = 0;
+    std::atomic<int> nextStep{0};           // Next step of the level to claim
+    std::atomic<bool> levelOpen{false};     // Workers may claim steps
+    std::atomic<int> workersInside{0};      // Workers that may be claiming or running one
+
+    void runSteps(const Level& level, int workerIndex, NodeProcessor& processor, int numSamples);
+    void runStep(const Step& step, int workerIndex, NodeProcessor& processor, int numSamples);
+    void workerRun(int workerIndex);
+    void allocateScratchBuffers();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerGraph)
+};
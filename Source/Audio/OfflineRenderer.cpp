@@ -0,0 +1,142 @@
+#include "OfflineRenderer.h"
+#include <cmath>
+
+namespace
+{
+    // Positions this close to a boundary are on it (far below a frame)
+    constexpr double BEAT_TOLERANCE = 1.0e-9;
+}
+
+OfflineRenderer::OfflineRenderer(const AudioEngine& project, double rate, int size)
+    : sampleRate(rate), blockSize(juce::jmax(1, size))
+{
+    // Prepared before the copy, so everything copied in is prepared at the render rate
+    engine.prepareToPlay(blockSize, sampleRate);
+    engine.setNonRealtime(true);
+    engine.setAnticipativeRendering(false);
+
+    // Nothing else is waiting on this engine, so every core can mix
+    engine.setNumMixerThreads(juce::SystemStats::getNumCpus() - 1);
+
+    missingPlugins = engine.copyProjectFrom(project);
+}
+
+double OfflineRenderer::getFramesToNextBoundary(double beat, double endBeat) const
+{
+    const auto& tempoTrack = engine.getTempoTrack();
+
+    double boundary = endBeat;
+    for (const auto& event : tempoTrack.getEvents())
+    {
+        if (event.beatPosition > beat + BEAT_TOLERANCE)
+        {
+            boundary = juce::jmin(boundary, event.beatPosition);
+            break;
+        }
+    }
+
+    // The engine moves through a block at the tempo it starts on
+    const double beatsPerFrame = tempoTrack.getTempoAtBeat(beat) / 60.0 / sampleRate;
+    return (boundary - beat) / beatsPerFrame;
+}
+
+bool OfflineRenderer::render(juce::AudioBuffer<float>& output, double startBeat, double endBeat,
+                             const std::function<bool()>& shouldCancel,
+                             const std::function<void(float)>& onProgress)
+{
+    auto isCancelled = [&shouldCancel] { return shouldCancel != nullptr && shouldCancel(); };
+
+    startBeat = juce::jmax(0.0, startBeat);
+    output.setSize(2, 0);
+
+    if (endBeat <= startBeat)
+        return true;
+
+    // Sound fonts, impulse responses and linear phase kernels finish in the background
+    for (int waited = 0; engine.isLoading() && waited < LOAD_TIMEOUT_MS; waited += 10)
+    {
+        if (isCancelled())
+            return false;
+
+        juce::Thread::sleep(10);
+    }
+
+    const int latency = engine.getLatencySamples();
+    const int expectedFrames = static_cast<int>(std::ceil(
+        engine.getTempoTrack().getBeatRangeDuration(startBeat, endBeat) * sampleRate));
+
+    output.setSize(2, juce::jmax(1, expectedFrames));
+    output.clear();
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    int numWritten = 0;
+    int toDiscard = latency;        // Rendered before startBeat reached the output
+    int tailLeft = latency;         // Still to render once the transport is at endBeat
+    bool reachedEnd = false;
+    juce::int64 numRendered = 0;
+    float reported = 0.0f;
+
+    engine.setPositionInBeats(startBeat);
+    engine.play();
+
+    while (!reachedEnd || tailLeft > 0)
+    {
+        if (isCancelled())
+        {
+            engine.stop();
+            output.setSize(2, 0);
+            return false;
+        }
+
+        int numSamples = juce::jmin(blockSize, tailLeft);
+        if (!reachedEnd)
+        {
+            const double frames = getFramesToNextBoundary(engine.getPositionInBeats(), endBeat);
+            numSamples = static_cast<int>(juce::jlimit(1.0, static_cast<double>(blockSize),
+                                                       std::ceil(frames - 1.0e-6)));
+        }
+
+        engine.getNextAudioBlock(juce::AudioSourceChannelInfo(&block, 0, numSamples));
+        numRendered += numSamples;
+
+        const int discard = juce::jmin(toDiscard, numSamples);
+        const int keep = numSamples - discard;
+        toDiscard -= discard;
+
+        if (keep > 0)
+        {
+            // Each block ends on time, but rounding up to whole frames can overrun the estimate
+            if (numWritten + keep > output.getNumSamples())
+                output.setSize(2, numWritten + juce::jmax(keep, blockSize), true, true);
+
+            for (int ch = 0; ch < 2; ++ch)
+                output.copyFrom(ch, numWritten, block, ch, discard, keep);
+
+            numWritten += keep;
+        }
+
+        if (reachedEnd)
+            tailLeft -= numSamples;
+        else
+            reachedEnd = engine.getPositionInBeats() >= endBeat - BEAT_TOLERANCE;
+
+        if (onProgress != nullptr)
+        {
+            const float progress = juce::jmin(1.0f, static_cast<float>(numRendered)
+                                                    / static_cast<float>(juce::jmax(1, expectedFrames + latency)));
+            if (progress >= reported + 0.01f)
+            {
+                reported = progress;
+                onProgress(progress);
+            }
+        }
+    }
+
+    engine.stop();
+    output.setSize(2, numWritten, true);
+
+    if (onProgress != nullptr && reported < 1.0f)
+        onProgress(1.0f);
+
+    return true;
+}
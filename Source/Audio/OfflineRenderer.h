@@ -0,0 +1,59 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "AudioEngine.h"
+#include <functional>
+
+/**
+ * OfflineRenderer - Renders a project faster than real time, away from playback
+ *
+ * Built on the message thread from the live engine: it takes a copy of the
+ * project (see AudioEngine::copyProjectFrom) into an engine of its own,
+ * prepared at the rate and block size asked for, and renders that from
+ * whichever thread calls render(). The live engine isn't touched - its
+ * transport, position and device carry on as they were.
+ *
+ * The copy renders non-realtime (blocking disk reads, finished warp renders,
+ * high-quality resampling) with a mixer worker for every other core, and
+ * follows the tempo map: blocks end on tempo changes, so each plays at the
+ * tempo it starts on.
+ */
+class OfflineRenderer
+{
+public:
+    // Longest render() waits for sound fonts and impulse responses to load
+    static constexpr int LOAD_TIMEOUT_MS = 30000;
+
+    /** Copy project and prepare the copy (message thread) */
+    OfflineRenderer(const AudioEngine& project, double sampleRate, int blockSize);
+
+    /** Plugins that couldn't be recreated; the copy renders without them */
+    const juce::StringArray& getMissingPlugins() const { return missingPlugins; }
+
+    double getSampleRate() const { return sampleRate; }
+
+    /**
+     * Render startBeat to endBeat as it is heard: delay compensation is
+     * taken out, so the first frame is startBeat.
+     * @param output Resized to the frames rendered, stereo
+     * @param shouldCancel Polled between blocks
+     * @param onProgress 0-1, at most once a percent (on the rendering thread)
+     * @return False if cancelled
+     */
+    bool render(juce::AudioBuffer<float>& output, double startBeat, double endBeat,
+                const std::function<bool()>& shouldCancel = nullptr,
+                const std::function<void(float)>& onProgress = nullptr);
+
+private:
+    const double sampleRate;
+    const int blockSize;
+
+    AudioEngine engine;
+    juce::StringArray missingPlugins;
+
+    // Frames from beat to the next tempo change or endBeat, whichever is first
+    double getFramesToNextBoundary(double beat, double endBeat) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * RenderVersion - Order-sensitive hash of the edit counters a render depends on
+ *
+ * Adding the counters up lets two edits cancel out: removing a clip bumps the
+ * owner's counter but takes the clip's own count out of the sum. Hashing each
+ * object together with its counter, in order, changes whenever anything is
+ * edited, added, removed or reordered.
+ */
+class RenderVersion
+{
+public:
+    void add(juce::uint64 value)
+    {
+        // splitmix64's finaliser, so neighbouring counters land far apart
+        value += 0x9e3779b97f4a7c15ull;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        value ^= value >> 31;
+
+        hash = (hash ^ value) * 0x100000001b3ull;
+    }
+
+    void add(const void* object, juce::uint64 counter)
+    {
+        add(static_cast<juce::uint64>(reinterpret_cast<juce::pointer_sized_uint>(object)));
+        add(counter);
+    }
+
+    juce::uint64 get() const { return hash; }
+
+private:
+    juce::uint64 hash = 0xcbf29ce484222325ull;
+};
@@ -0,0 +1,311 @@
+#include "Resampler.h"
+#include <array>
+#include <cmath>
+
+std::atomic<Resampler::Quality> Resampler::realtimeQuality{Resampler::Quality::Hermite};
+std::atomic<Resampler::Quality> Resampler::offlineQuality{Resampler::Quality::Sinc};
+
+namespace
+{
+    constexpr int SINC_HALF = Resampler::SINC_TAPS / 2;
+    constexpr int SINC_BEFORE = SINC_HALF - 1;
+    constexpr int NUM_SINC_TABLES = 9;   // Cutoff 1, 2^-1/4, ... 2^-2 (quarter octaves)
+    constexpr double SINC_TABLE_MAX_INCREMENT = 4.0;
+    constexpr double KAISER_BETA = 8.0;
+
+    // Zeroth-order modified Bessel function (for the Kaiser window)
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        const double halfX = x * 0.5;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+            if (term < sum * 1.0e-12)
+                break;
+        }
+        return sum;
+    }
+
+    /**
+     * Precomputed polyphase tables: [cutoff][phase][tap]
+     * One extra phase so the phase after the last can be interpolated towards.
+     */
+    struct SincTables
+    {
+        alignas(16) float coeffs[NUM_SINC_TABLES][Resampler::SINC_PHASES + 1][Resampler::SINC_TAPS];
+
+        SincTables()
+        {
+            const double i0Beta = besselI0(KAISER_BETA);
+
+            for (int table = 0; table < NUM_SINC_TABLES; ++table)
+            {
+                const double cutoff = std::pow(2.0, -table / 4.0);
+
+                for (int phase = 0; phase <= Resampler::SINC_PHASES; ++phase)
+                {
+                    const double frac = static_cast<double>(phase) / Resampler::SINC_PHASES;
+                    double sum = 0.0;
+                    double h[Resampler::SINC_TAPS];
+
+                    for (int tap = 0; tap < Resampler::SINC_TAPS; ++tap)
+                    {
+                        const double x = (tap - SINC_BEFORE) - frac;
+                        const double y = cutoff * x;
+                        const double sinc = std::abs(y) < 1.0e-9 ? 1.0
+                            : std::sin(juce::MathConstants<double>::pi * y) / (juce::MathConstants<double>::pi * y);
+
+                        const double r = x / SINC_HALF;
+                        const double window = std::abs(r) >= 1.0 ? 0.0
+                            : besselI0(KAISER_BETA * std::sqrt(1.0 - r * r)) / i0Beta;
+
+                        h[tap] = sinc * window;
+                        sum += h[tap];
+                    }
+
+                    // Unity DC gain for every phase
+                    for (int tap = 0; tap < Resampler::SINC_TAPS; ++tap)
+                        coeffs[table][phase][tap] = static_cast<float>(sum != 0.0 ? h[tap] / sum : 0.0);
+                }
+            }
+        }
+    };
+
+    // Built while the program starts, so no thread (least of all the audio
+    // thread) pays for it on its first sinc read
+    const SincTables sincTables;
+
+    inline float dot16(const float* a, const float* b)
+    {
+        // Four independent accumulators - compiles to packed SIMD multiply-adds
+        float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+        for (int i = 0; i < Resampler::SINC_TAPS; i += 4)
+        {
+            acc0 += a[i] * b[i];
+            acc1 += a[i + 1] * b[i + 1];
+            acc2 += a[i + 2] * b[i + 2];
+            acc3 += a[i + 3] * b[i + 3];
+        }
+        return (acc0 + acc1) + (acc2 + acc3);
+    }
+
+    inline float hermite(const float* w, float frac)
+    {
+        // w[0..3] = x[-1], x[0], x[1], x[2]
+        const float c0 = w[1];
+        const float c1 = 0.5f * (w[2] - w[0]);
+        const float c2 = w[0] - 2.5f * w[1] + 2.0f * w[2] - 0.5f * w[3];
+        const float c3 = 0.5f * (w[3] - w[0]) + 1.5f * (w[1] - w[2]);
+        return ((c3 * frac + c2) * frac + c1) * frac + c0;
+    }
+}
+
+//==============================================================================
+// Kernel geometry
+
+int Resampler::getNumTaps(Quality quality, double increment)
+{
+    switch (quality)
+    {
+        case Quality::Linear:  return 2;
+        case Quality::Hermite: return 4;
+        case Quality::Sinc:    return SINC_TAPS * getSincStretch(increment);
+    }
+    return 2;
+}
+
+int Resampler::getTapsBefore(Quality quality, double increment)
+{
+    switch (quality)
+    {
+        case Quality::Linear:  return 0;
+        case Quality::Hermite: return 1;
+        case Quality::Sinc:    return SINC_HALF * getSincStretch(increment) - 1;
+    }
+    return 0;
+}
+
+int Resampler::getSincStretch(double increment)
+{
+    if (increment <= SINC_TABLE_MAX_INCREMENT * 1.0001)
+        return 1;
+
+    return static_cast<int>(std::ceil(juce::jmin(increment, static_cast<double>(MAX_SINC_INCREMENT))));
+}
+
+int Resampler::getSincTableIndex(double increment)
+{
+    // Smallest quarter-octave cutoff step that keeps the output alias-free
+    double threshold = 1.0;
+    for (int table = 0; table < NUM_SINC_TABLES - 1; ++table)
+    {
+        if (increment <= threshold * 1.0001)
+            return table;
+        threshold *= 1.189207115002721; // 2^(1/4)
+    }
+    return NUM_SINC_TABLES - 1;
+}
+
+//==============================================================================
+// Single sample
+
+float Resampler::interpolateSinc(const float* window, float frac, int tableIndex)
+{
+    const auto& table = sincTables.coeffs[tableIndex];
+
+    const float phasePos = frac * static_cast<float>(SINC_PHASES);
+    const int phase = juce::jlimit(0, SINC_PHASES - 1, static_cast<int>(phasePos));
+    const float phaseFrac = phasePos - static_cast<float>(phase);
+
+    const float y0 = dot16(window, table[phase]);
+    const float y1 = dot16(window, table[phase + 1]);
+    return y0 + phaseFrac * (y1 - y0);
+}
+
+float Resampler::interpolateStretchedSinc(const float* window, float frac, double increment, int stretch)
+{
+    // The 1:1 kernel widened by increment, read off its table: the cutoff
+    // falls to 1/increment and it keeps all of its zero crossings, which a
+    // 16-tap kernel can't at these cutoffs
+    const auto& table = sincTables.coeffs[0];
+    const double scale = 1.0 / juce::jmin(increment, static_cast<double>(MAX_SINC_INCREMENT));
+    const int numTaps = SINC_TAPS * stretch;
+    const int tapsBefore = SINC_HALF * stretch - 1;
+
+    float sum = 0.0f, weights = 0.0f;
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        // Where this tap falls among the 1:1 kernel's (x = tap - SINC_BEFORE - frac there)
+        const double position = ((tap - tapsBefore) - frac) * scale + SINC_BEFORE;
+        const int prototypeTap = static_cast<int>(std::ceil(position));
+        if (prototypeTap < 0 || prototypeTap >= SINC_TAPS)
+            continue;
+
+        const double phasePos = (prototypeTap - position) * SINC_PHASES;
+        const int phase = juce::jlimit(0, SINC_PHASES - 1, static_cast<int>(phasePos));
+        const float h0 = table[phase][prototypeTap];
+        const float h = h0 + static_cast<float>(phasePos - phase) * (table[phase + 1][prototypeTap] - h0);
+
+        sum += h * window[tap];
+        weights += h;
+    }
+
+    // Unity DC gain, as the tables have
+    return weights != 0.0f ? sum / weights : 0.0f;
+}
+
+float Resampler::interpolate(Quality quality, const float* window, float frac, double increment)
+{
+    switch (quality)
+    {
+        case Quality::Linear:  return window[0] + frac * (window[1] - window[0]);
+        case Quality::Hermite: return hermite(window, frac);
+        case Quality::Sinc:
+        {
+            const int stretch = getSincStretch(increment);
+            return stretch > 1 ? interpolateStretchedSinc(window, frac, increment, stretch)
+                               : interpolateSinc(window, frac, getSincTableIndex(increment));
+        }
+    }
+    return 0.0f;
+}
+
+float Resampler::interpolateAt(Quality quality, const float* src, juce::int64 srcLength,
+                               double position, double increment)
+{
+    const double floorPos = std::floor(position);
+    const auto index = static_cast<juce::int64>(floorPos);
+    const float frac = static_cast<float>(position - floorPos);
+
+    const int numTaps = getNumTaps(quality, increment);
+    const auto first = index - getTapsBefore(quality, increment);
+
+    // Fast path - whole window inside the buffer
+    if (first >= 0 && first + numTaps <= srcLength)
+        return interpolate(quality, src + first, frac, increment);
+
+    float window[MAX_TAPS];
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        const auto i = first + tap;
+        window[tap] = (i >= 0 && i < srcLength) ? src[i] : 0.0f;
+    }
+    return interpolate(quality, window, frac, increment);
+}
+
+//==============================================================================
+// Block
+
+template <Resampler::Quality quality>
+double Resampler::processImpl(const float* src, juce::int64 srcLength,
+                              double position, double increment, float* dest, int numSamples)
+{
+    const int numTaps = getNumTaps(quality, increment);
+    const int tapsBefore = getTapsBefore(quality, increment);
+
+    const int tableIndex = quality == Quality::Sinc ? getSincTableIndex(increment) : 0;
+    const int stretch = quality == Quality::Sinc ? getSincStretch(increment) : 1;
+    float window[MAX_TAPS];
+
+    auto kernel = [tableIndex, stretch, increment](const float* w, float frac)
+    {
+        if constexpr (quality == Quality::Linear)
+            return w[0] + frac * (w[1] - w[0]);
+        else if constexpr (quality == Quality::Hermite)
+            return hermite(w, frac);
+        else if (stretch > 1)
+            return interpolateStretchedSinc(w, frac, increment, stretch);
+        else
+            return interpolateSinc(w, frac, tableIndex);
+    };
+
+    // Last integer position whose window still fits inside the buffer
+    const double lastInside = static_cast<double>(srcLength - numTaps + tapsBefore);
+
+    for (int i = 0; i < numSamples;)
+    {
+        const double floorPos = std::floor(position);
+        const auto first = static_cast<juce::int64>(floorPos) - tapsBefore;
+
+        if (first >= 0 && first + numTaps <= srcLength && increment > 0.0)
+        {
+            // A run that stays inside the buffer: no edge checks per sample. It
+            // stops a step short of the edge, so rounding can't carry it over.
+            const double stepsInside = std::ceil((lastInside + 1.0 - position) / increment) - 1.0;
+            const int run = static_cast<int>(juce::jlimit<double>(1.0, numSamples - i, stepsInside));
+            for (int end = i + run; i < end; ++i)
+            {
+                const double runFloor = std::floor(position);
+                dest[i] = kernel(src + static_cast<juce::int64>(runFloor) - tapsBefore,
+                                 static_cast<float>(position - runFloor));
+                position += increment;
+            }
+            continue;
+        }
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            const auto s = first + tap;
+            window[tap] = (s >= 0 && s < srcLength) ? src[s] : 0.0f;
+        }
+
+        dest[i++] = kernel(window, static_cast<float>(position - floorPos));
+        position += increment;
+    }
+
+    return position;
+}
+
+double Resampler::process(Quality quality, const float* src, juce::int64 srcLength,
+                          double position, double increment, float* dest, int numSamples)
+{
+    switch (quality)
+    {
+        case Quality::Linear:  return processImpl<Quality::Linear>(src, srcLength, position, increment, dest, numSamples);
+        case Quality::Hermite: return processImpl<Quality::Hermite>(src, srcLength, position, increment, dest, numSamples);
+        case Quality::Sinc:    return processImpl<Quality::Sinc>(src, srcLength, position, increment, dest, numSamples);
+    }
+    return position;
+}
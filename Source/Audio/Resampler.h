@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+/**
+ * Resampler - Shared interpolation kernel for repitching sample data
+ *
+ * Used by SamplerVoice and Track audio clip playback. Three quality tiers:
+ * - Linear:  2 taps, cheapest, audible aliasing on transposed material
+ * - Hermite: 4-point, 3rd-order Hermite (Catmull-Rom) - default for real-time
+ * - Sinc:    16-tap Kaiser-windowed sinc from precomputed polyphase tables,
+ *            with the cutoff lowered in quarter-octave steps when reading
+ *            up to 4x faster than 1:1 - default for offline export. Faster
+ *            reads (samples pitched up more than two octaves, 176.4/192 kHz
+ *            files into a 44.1 kHz session) stretch the 1:1 kernel to a
+ *            cutoff of 1/increment over 16 taps per unit of increment, up to
+ *            MAX_SINC_INCREMENT; the window grows with it (getNumTaps()).
+ *
+ * Positions are in source frames. Frames outside [0, srcLength) read as silence.
+ * All tiers have a fixed per-sample cost for a given increment (no branches
+ * on signal content).
+ */
+class Resampler
+{
+public:
+    enum class Quality
+    {
+        Linear = 0,
+        Hermite,
+        Sinc
+    };
+
+    static constexpr int SINC_TAPS = 16;
+    static constexpr int SINC_PHASES = 256;
+    static constexpr int MAX_SINC_INCREMENT = 16;   // Faster reads alias above the stretched cutoff
+    static constexpr int MAX_TAPS = SINC_TAPS * MAX_SINC_INCREMENT;
+
+    //==========================================================================
+    // Kernel geometry: the window covers [index - tapsBefore, index - tapsBefore + numTaps)
+    static int getNumTaps(Quality quality, double increment = 1.0);
+    static int getTapsBefore(Quality quality, double increment = 1.0);
+
+    //==========================================================================
+    // Single sample
+
+    /**
+     * Interpolate from a gathered tap window
+     * @param window    numTaps frames; window[getTapsBefore()] is the frame at the integer position
+     * @param frac      Fractional position in [0, 1)
+     * @param increment Source frames advanced per output sample (selects sinc cutoff)
+     */
+    static float interpolate(Quality quality, const float* window, float frac, double increment = 1.0);
+
+    /** Interpolate directly from a buffer, handling edges */
+    static float interpolateAt(Quality quality, const float* src, juce::int64 srcLength,
+                               double position, double increment = 1.0);
+
+    //==========================================================================
+    // Block
+
+    /**
+     * Render numSamples outputs into dest (overwrites), starting at position and
+     * advancing by increment each sample.
+     * @return The source position after the block
+     */
+    static double process(Quality quality, const float* src, juce::int64 srcLength,
+                          double position, double increment, float* dest, int numSamples);
+
+    //==========================================================================
+    // Quality tiers (process-wide)
+    static void setRealtimeQuality(Quality quality) { realtimeQuality.store(quality); }
+    static Quality getRealtimeQuality() { return realtimeQuality.load(); }
+
+    static void setOfflineQuality(Quality quality) { offlineQuality.store(quality); }
+    static Quality getOfflineQuality() { return offlineQuality.load(); }
+
+    static Quality getQuality(bool nonRealtime) { return nonRealtime ? getOfflineQuality() : getRealtimeQuality(); }
+
+    static juce::StringArray getQualityNames() { return { "Linear", "Hermite", "Sinc" }; }
+
+private:
+    static std::atomic<Quality> realtimeQuality;
+    static std::atomic<Quality> offlineQuality;
+
+    static float interpolateSinc(const float* window, float frac, int tableIndex);
+    static float interpolateStretchedSinc(const float* window, float frac, double increment, int stretch);
+    static int getSincTableIndex(double increment);
+    static int getSincStretch(double increment);    // 1 while the tables cover it
+
+    template <Quality quality>
+    static double processImpl(const float* src, juce::int64 srcLength,
+                              double position, double increment, float* dest, int numSamples);
+
+    Resampler() = delete;
+};
@@ -0,0 +1,43 @@
+#include "ReturnBus.h"
+
+ReturnBus::ReturnBus(const juce::String& busName)
+    : name(busName)
+{
+    inputBuffer.setSize(2, 512);
+}
+
+void ReturnBus::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    inputBuffer.setSize(2, samplesPerBlock);
+    inputBuffer.clear();
+    effectChain.prepareToPlay(sampleRate, samplesPerBlock);
+}
+
+void ReturnBus::releaseResources()
+{
+    effectChain.releaseResources();
+}
+
+void ReturnBus::beginBlock(int numSamples)
+{
+    // Hosts may deliver a larger block than announced - grow without shrinking
+    inputBuffer.setSize(2, numSamples, false, false, true);
+    inputBuffer.clear();
+}
+
+void ReturnBus::processBlock(juce::AudioBuffer<float>& output, int numSamples)
+{
+    // Keep the effects running even when muted so tails don't resume stale
+    juce::AudioBuffer<float> block(inputBuffer.getArrayOfWritePointers(), 2, numSamples);
+    effectChain.processBlock(block);
+    latencyCompensation.process(block, numSamples);
+
+    if (muted.load())
+        return;
+
+    const float level = returnLevel.load();
+    const int numChannels = juce::jmin(output.getNumChannels(), block.getNumChannels());
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        output.addFrom(ch, 0, block, ch, 0, numSamples, level);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Effects/EffectChain.h"
+#include "CompensationDelay.h"
+#include <atomic>
+
+/**
+ * ReturnBus - Shared effect bus fed by track sends
+ *
+ * Tracks add a pre- or post-fader copy of their signal into the bus input
+ * each block; the bus runs its EffectChain once over the sum and mixes the
+ * result into the master. One reverb or delay on a return serves every track
+ * that sends to it, instead of each track carrying its own instance.
+ *
+ * Effects on a return should normally be 100% wet.
+ */
+class ReturnBus
+{
+public:
+    explicit ReturnBus(const juce::String& name = "Return");
+    ~ReturnBus() = default;
+
+    //==========================================================================
+    // Audio processing (audio thread, except prepare/release)
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    void releaseResources();
+
+    /** Clear the send input for a block of numSamples */
+    void beginBlock(int numSamples);
+
+    /** Buffer tracks add their sends into (valid after beginBlock) */
+    juce::AudioBuffer<float>& getInputBuffer() { return inputBuffer; }
+
+    /** Run the effects over the summed sends and add the result to output */
+    void processBlock(juce::AudioBuffer<float>& output, int numSamples);
+
+    //==========================================================================
+    // Properties
+    const juce::String& getName() const { return name; }
+    void setName(const juce::String& newName) { name = newName; }
+
+    void setReturnLevel(float level) { returnLevel.store(juce::jlimit(0.0f, 2.0f, level)); }
+    float getReturnLevel() const { return returnLevel.load(); }
+
+    void setMuted(bool shouldBeMuted) { muted.store(shouldBeMuted); }
+    bool isMuted() const { return muted.load(); }
+
+    EffectChain& getEffectChain() { return effectChain; }
+
+    //==========================================================================
+    // Delay compensation (message thread)
+    int getLatencySamples() const { return effectChain.getLatencySamples(); }
+
+    // Delay after the effects that lines the return up with the rest of the
+    // mix at the master (set by AudioEngine while it isn't processing)
+    void setLatencyCompensation(int samples) { latencyCompensation.setDelay(samples); }
+    int getLatencyCompensation() const { return latencyCompensation.getDelay(); }
+
+private:
+    juce::String name;
+    EffectChain effectChain;
+    CompensationDelay latencyCompensation;
+    juce::AudioBuffer<float> inputBuffer;
+
+    std::atomic<float> returnLevel{1.0f};
+    std::atomic<bool> muted{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReturnBus)
+};
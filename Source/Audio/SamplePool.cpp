@@ -0,0 +1,826 @@
+#include "SamplePool.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    constexpr int CACHE_MAGIC = 0x43534650; // "PFSC"
+    constexpr int CACHE_VERSION = 3;
+    constexpr int CACHE_HEADER_BYTES = 64;  // Keeps the mapped floats aligned
+    constexpr int PEAKS_CHUNK_SIZE = 1 << 16;
+    constexpr const char* PATH_INDEX_FILE = "paths.pfindex";
+
+    juce::int64 getBufferBytes(const juce::AudioBuffer<float>& buffer)
+    {
+        return static_cast<juce::int64>(buffer.getNumChannels())
+             * buffer.getNumSamples() * (juce::int64)sizeof(float);
+    }
+
+    /** A cache file's floats, referred to in place */
+    struct MappedCacheFile
+    {
+        explicit MappedCacheFile(const juce::File& file) : map(file, juce::MemoryMappedFile::readOnly) {}
+
+        juce::MemoryMappedFile map;
+        juce::AudioBuffer<float> buffer;
+    };
+
+    std::shared_ptr<const WaveformPeaks> buildPeaks(const CompactAudio& compact)
+    {
+        // A chunk decoded at a time rather than the whole file
+        WaveformPeaks::Builder builder(compact.getNumChannels());
+        juce::AudioBuffer<float> chunk(compact.getNumChannels(), PEAKS_CHUNK_SIZE);
+
+        for (juce::int64 done = 0; done < compact.getLengthInFrames();)
+        {
+            const int n = static_cast<int>(juce::jmin<juce::int64>(PEAKS_CHUNK_SIZE, compact.getLengthInFrames() - done));
+            compact.read(chunk.getArrayOfWritePointers(), chunk.getNumChannels(), done, n);
+            builder.append(chunk.getArrayOfReadPointers(), n);
+            done += n;
+        }
+
+        return builder.getSnapshot();
+    }
+}
+
+SamplePool::SamplePool()
+    : cacheDirectory(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                         .getChildFile("ProgFlow")
+                         .getChildFile("SampleCache"))
+{
+}
+
+const juce::AudioBuffer<float>& SamplePool::getEmptyBuffer()
+{
+    static const juce::AudioBuffer<float> empty;
+    return empty;
+}
+
+//==============================================================================
+// Acquisition
+
+SamplePool::BufferPtr SamplePool::getOrLoad(const juce::File& file, double targetSampleRate,
+                                            const Decoder& decoder, double& sampleRateOut, bool persist)
+{
+    if (!file.existsAsFile())
+        return nullptr;
+
+    const auto key = getContentKey(file, targetSampleRate);
+    if (key.isEmpty())
+        return nullptr;
+
+    const auto cacheFile = getDiskCacheDirectory().getChildFile(key + ".pfcache");
+
+    {
+        const juce::ScopedLock sl(lock);
+        if (auto buffer = acquireLocked(key, sampleRateOut))
+            return buffer;
+    }
+
+    // Left on disk by an earlier session, from this file or any copy of it
+    double cachedRate = 0.0;
+    if (auto cached = mapCacheFile(cacheFile, cachedRate))
+    {
+        cacheFile.setLastAccessTime(juce::Time::getCurrentTime());
+
+        const juce::ScopedLock sl(lock);
+        if (auto buffer = acquireLocked(key, sampleRateOut))
+            return buffer;
+
+        ++stats.diskCacheHits;
+        return addLocked(key, std::move(cached), cachedRate, sampleRateOut);
+    }
+
+    // Decode outside the lock so loads of different files don't serialise
+    auto decoded = std::make_shared<juce::AudioBuffer<float>>();
+    double decodedRate = 0.0;
+    if (!decoder(*decoded, decodedRate) || decoded->getNumSamples() == 0)
+        return nullptr;
+
+    BufferPtr buffer;
+    {
+        const juce::ScopedLock sl(lock);
+
+        // Another thread may have loaded the same content in the meantime
+        if (auto existing = acquireLocked(key, sampleRateOut))
+            return existing;
+
+        ++stats.decodes;
+        buffer = addLocked(key, std::move(decoded), decodedRate, sampleRateOut);
+    }
+
+    // A cache file that couldn't be mapped is truncated or from an older
+    // format; eviction would otherwise take it for a good copy
+    cacheFile.deleteFile();
+
+    if (persist && writeCacheFile(cacheFile, *buffer, decodedRate))
+        enforceDiskBudget();
+
+    return buffer;
+}
+
+SamplePool::CompactPtr SamplePool::getOrLoadCompact(const juce::File& file, double targetSampleRate,
+                                                    CompactAudio::Format format, const Decoder& decoder,
+                                                    double& sampleRateOut, bool persist)
+{
+    if (!file.existsAsFile())
+        return nullptr;
+
+    const auto key = getContentKey(file, targetSampleRate);
+    if (key.isEmpty())
+        return nullptr;
+
+    const auto compactKey = key + (format == CompactAudio::Format::Packed ? "_packed" : "_lossless");
+
+    {
+        const juce::ScopedLock sl(lock);
+        if (auto it = compactEntries.find(compactKey); it != compactEntries.end())
+        {
+            if (auto compact = it->second.compact.lock())
+            {
+                ++stats.hits;
+                sampleRateOut = it->second.sampleRate;
+                return compact;
+            }
+        }
+    }
+
+    double sampleRate = 0.0;
+    auto buffer = getOrLoad(file, targetSampleRate, decoder, sampleRate, persist);
+    if (buffer == nullptr)
+        return nullptr;
+
+    auto compact = CompactAudio::fromBuffer(*buffer, format);
+    if (compact == nullptr)
+        return nullptr;
+
+    const juce::ScopedLock sl(lock);
+
+    auto& entry = compactEntries[compactKey];
+    if (auto existing = entry.compact.lock())
+    {
+        // Another thread made one in the meantime
+        compact = existing;
+    }
+    else
+    {
+        entry.compact = compact;
+        entry.contentKey = key;
+        entry.sampleRate = sampleRate;
+    }
+
+    buffer.reset();
+    releaseLocked(key);
+
+    sampleRateOut = entry.sampleRate;
+    return compact;
+}
+
+SamplePool::BufferPtr SamplePool::addLocked(const juce::String& key, BufferPtr buffer, double sampleRate,
+                                            double& sampleRateOut)
+{
+    auto& entry = entries[key];
+    entry.buffer = buffer;
+    entry.sampleRate = sampleRate;
+    entry.bytes = getBufferBytes(*buffer);
+    entry.lastUsed = ++useClock;
+    entry.cacheFile = cacheDirectory.getChildFile(key + ".pfcache");
+
+    residentBytes += entry.bytes;
+    enforceBudgetLocked(budgetBytes);
+
+    sampleRateOut = sampleRate;
+    return buffer;
+}
+
+SamplePool::BufferPtr SamplePool::acquireLocked(const juce::String& key, double& sampleRateOut)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return nullptr;
+
+    auto& entry = it->second;
+
+    if (entry.buffer == nullptr)
+    {
+        double cachedRate = 0.0;
+        auto restored = mapCacheFile(entry.cacheFile, cachedRate);
+        if (restored == nullptr)
+        {
+            // Cache file lost or corrupt - fall back to decoding the original
+            entries.erase(it);
+            return nullptr;
+        }
+
+        entry.buffer = restored;
+        entry.sampleRate = cachedRate;
+        entry.bytes = getBufferBytes(*restored);
+        residentBytes += entry.bytes;
+        ++stats.diskCacheHits;
+    }
+    else
+    {
+        ++stats.hits;
+    }
+
+    entry.lastUsed = ++useClock;
+    sampleRateOut = entry.sampleRate;
+
+    // Hold a reference while enforcing so this entry can't be the victim
+    auto buffer = entry.buffer;
+    enforceBudgetLocked(budgetBytes);
+    return buffer;
+}
+
+void SamplePool::setPinned(const BufferPtr& buffer, bool shouldBePinned)
+{
+    if (buffer == nullptr)
+        return;
+
+    const juce::ScopedLock sl(lock);
+
+    for (auto& [key, entry] : entries)
+    {
+        if (entry.buffer == buffer)
+        {
+            entry.pinned = shouldBePinned;
+            break;
+        }
+    }
+
+    if (!shouldBePinned)
+        enforceBudgetLocked(budgetBytes);
+}
+
+SamplePool::PeaksPtr SamplePool::getPeaks(const BufferPtr& buffer)
+{
+    if (buffer == nullptr)
+        return nullptr;
+
+    juce::String key;
+    {
+        const juce::ScopedLock sl(lock);
+        for (const auto& [entryKey, entry] : entries)
+        {
+            if (entry.buffer == buffer)
+            {
+                if (entry.peaks != nullptr)
+                    return entry.peaks;
+
+                key = entryKey;
+                break;
+            }
+        }
+    }
+
+    if (key.isEmpty())
+        return WaveformPeaks::build(*buffer);
+
+    // Scanning the audio is what reopening has to avoid, so peaks are kept on disk too
+    auto peaks = readPeaksFile(getDiskCacheDirectory().getChildFile(key + ".pfpeaks"),
+                               buffer->getNumChannels(), buffer->getNumSamples());
+    if (peaks == nullptr)
+    {
+        peaks = WaveformPeaks::build(*buffer);
+        writePeaksFile(getDiskCacheDirectory().getChildFile(key + ".pfpeaks"), *peaks);
+    }
+
+    const juce::ScopedLock sl(lock);
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return peaks;
+
+    if (it->second.peaks == nullptr)
+        it->second.peaks = peaks;
+    return it->second.peaks;
+}
+
+SamplePool::PeaksPtr SamplePool::getPeaks(const CompactPtr& compact)
+{
+    if (compact == nullptr)
+        return nullptr;
+
+    juce::String key, contentKey;
+    {
+        const juce::ScopedLock sl(lock);
+        for (const auto& [entryKey, entry] : compactEntries)
+        {
+            if (entry.compact.lock() == compact)
+            {
+                if (entry.peaks != nullptr)
+                    return entry.peaks;
+
+                key = entryKey;
+                contentKey = entry.contentKey;
+                break;
+            }
+        }
+    }
+
+    if (key.isEmpty())
+        return buildPeaks(*compact);
+
+    // The same file as the floats' peaks; the difference is far below a pixel
+    const auto peaksFile = getDiskCacheDirectory().getChildFile(contentKey + ".pfpeaks");
+    auto peaks = readPeaksFile(peaksFile, compact->getNumChannels(), compact->getLengthInFrames());
+    if (peaks == nullptr)
+    {
+        peaks = buildPeaks(*compact);
+        writePeaksFile(peaksFile, *peaks);
+    }
+
+    const juce::ScopedLock sl(lock);
+    auto it = compactEntries.find(key);
+    if (it == compactEntries.end())
+        return peaks;
+
+    if (it->second.peaks == nullptr)
+        it->second.peaks = peaks;
+    return it->second.peaks;
+}
+
+SamplePool::PeaksPtr SamplePool::getFilePeaks(const juce::File& file, const std::function<PeaksPtr()>& build)
+{
+    // Same key as the file decoded at its own rate, whose peaks would be identical
+    const auto key = getContentKey(file, 0.0);
+    if (key.isEmpty())
+        return build();
+
+    const auto peaksFile = getDiskCacheDirectory().getChildFile(key + ".pfpeaks");
+    if (juce::FileInputStream in(peaksFile); in.openedOk())
+    {
+        if (auto peaks = WaveformPeaks::readFrom(in))
+            return peaks;
+    }
+
+    auto peaks = build();
+    if (peaks != nullptr)
+        writePeaksFile(peaksFile, *peaks);
+    return peaks;
+}
+
+//==============================================================================
+// Keys
+
+juce::String SamplePool::getContentKey(const juce::File& file, double targetSampleRate)
+{
+    const auto rateSuffix = "_" + juce::String(juce::roundToInt(targetSampleRate));
+    const auto pathKey = file.getFullPathName() + "|" + juce::String(file.getSize())
+                       + "|" + juce::String(file.getLastModificationTime().toMilliseconds());
+
+    {
+        const juce::ScopedLock sl(lock);
+        loadPathIndexLocked();
+
+        auto it = pathIndex.find(pathKey);
+        if (it != pathIndex.end())
+            return it->second + rateSuffix;
+    }
+
+    const auto fingerprint = computeFingerprint(file);
+    if (fingerprint.isEmpty())
+        return {};
+
+    const juce::ScopedLock sl(lock);
+    ++stats.fingerprints;
+    pathIndex[pathKey] = fingerprint;
+    appendPathIndexLocked(pathKey, fingerprint);
+    return fingerprint + rateSuffix;
+}
+
+juce::String SamplePool::computeFingerprint(const juce::File& file)
+{
+    juce::FileInputStream in(file);
+    if (!in.openedOk())
+        return {};
+
+    // The whole file: stems bounced from one session can share their length,
+    // header, and seconds of silence at either end. pathIndex means a file is
+    // only read through once, until its size or modification time changes
+    return juce::MD5(in).toHexString();
+}
+
+void SamplePool::loadPathIndexLocked()
+{
+    if (pathIndexLoaded)
+        return;
+
+    pathIndexLoaded = true;
+
+    const auto indexFile = cacheDirectory.getChildFile(PATH_INDEX_FILE);
+    juce::StringArray lines;
+    indexFile.readLines(lines);
+    lines.removeEmptyStrings();
+
+    // One line per key, appended as files are hashed: "path|size|mtime<tab>hash".
+    // Only the latest key of each path is kept - the others are stale
+    std::map<juce::String, std::pair<juce::String, juce::String>> latestByPath;
+    for (const auto& line : lines)
+    {
+        const auto tab = line.lastIndexOfChar('\t');
+        if (tab <= 0)
+            continue;
+
+        const auto pathKey = line.substring(0, tab);
+        const auto fingerprint = line.substring(tab + 1).trim();
+        const auto path = pathKey.upToLastOccurrenceOf("|", false, false).upToLastOccurrenceOf("|", false, false);
+        latestByPath[path] = { pathKey, fingerprint };
+    }
+
+    for (const auto& [path, key] : latestByPath)
+        pathIndex[key.first] = key.second;
+
+    // Files that keep changing would otherwise grow the index for ever
+    if (static_cast<int>(latestByPath.size()) < lines.size())
+    {
+        juce::String text;
+        for (const auto& [path, key] : latestByPath)
+            text << key.first << "\t" << key.second << "\n";
+        indexFile.replaceWithText(text);
+    }
+}
+
+void SamplePool::appendPathIndexLocked(const juce::String& pathKey, const juce::String& fingerprint)
+{
+    if (!cacheDirectory.createDirectory())
+        return;
+
+    // FileOutputStream appends to an existing file
+    juce::FileOutputStream out(cacheDirectory.getChildFile(PATH_INDEX_FILE));
+    if (out.openedOk())
+        out << pathKey << "\t" << fingerprint << "\n";
+}
+
+//==============================================================================
+// Memory budget
+
+void SamplePool::setMemoryBudget(juce::int64 bytes)
+{
+    const juce::ScopedLock sl(lock);
+    budgetBytes = std::max((juce::int64)0, bytes);
+    enforceBudgetLocked(budgetBytes);
+}
+
+juce::int64 SamplePool::getMemoryBudget() const
+{
+    const juce::ScopedLock sl(lock);
+    return budgetBytes;
+}
+
+juce::int64 SamplePool::getResidentBytes() const
+{
+    const juce::ScopedLock sl(lock);
+    return residentBytes;
+}
+
+juce::int64 SamplePool::getCompactBytes() const
+{
+    const juce::ScopedLock sl(lock);
+
+    juce::int64 bytes = 0;
+    for (const auto& [key, entry] : compactEntries)
+        if (auto compact = entry.compact.lock())
+            bytes += compact->getBytes();
+    return bytes;
+}
+
+int SamplePool::getNumEntries() const
+{
+    const juce::ScopedLock sl(lock);
+    return static_cast<int>(entries.size());
+}
+
+int SamplePool::getNumResidentEntries() const
+{
+    const juce::ScopedLock sl(lock);
+
+    int count = 0;
+    for (const auto& [key, entry] : entries)
+        if (entry.buffer != nullptr)
+            ++count;
+    return count;
+}
+
+void SamplePool::trim()
+{
+    const juce::ScopedLock sl(lock);
+    enforceBudgetLocked(0);
+}
+
+void SamplePool::enforceBudgetLocked(juce::int64 budget)
+{
+    while (residentBytes > budget)
+    {
+        // Least recently used entry that nobody outside the pool holds
+        const juce::String* victim = nullptr;
+        juce::uint64 oldest = std::numeric_limits<juce::uint64>::max();
+
+        for (const auto& [key, entry] : entries)
+        {
+            if (entry.buffer != nullptr && !entry.pinned
+                && entry.buffer.use_count() == 1 && entry.lastUsed < oldest)
+            {
+                victim = &key;
+                oldest = entry.lastUsed;
+            }
+        }
+
+        if (victim == nullptr)
+            break; // Everything resident is pinned or in use
+
+        const auto key = *victim;
+        evictLocked(key);
+    }
+}
+
+bool SamplePool::evictLocked(const juce::String& key)
+{
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second.buffer == nullptr)
+        return false;
+
+    auto& entry = it->second;
+    residentBytes -= entry.bytes;
+    ++stats.evictions;
+
+    // Content-keyed, so an existing cache file is already correct
+    if (entry.cacheFile.existsAsFile()
+        || writeCacheFile(entry.cacheFile, *entry.buffer, entry.sampleRate))
+    {
+        entry.buffer.reset();
+    }
+    else
+    {
+        // Can't spill (disk full, read-only) - forget it and decode again next time
+        entries.erase(it);
+    }
+
+    return true;
+}
+
+void SamplePool::releaseLocked(const juce::String& key)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return;
+
+    auto& entry = it->second;
+    if (entry.buffer == nullptr || entry.pinned || entry.buffer.use_count() > 1)
+        return;
+
+    // Not spilled: it is only wanted again if something other than a clip
+    // asks for it, and then the disk cache or the original file has it
+    residentBytes -= entry.bytes;
+    entry.buffer.reset();
+}
+
+//==============================================================================
+// Disk cache
+
+void SamplePool::setDiskCacheDirectory(const juce::File& directory)
+{
+    const juce::ScopedLock sl(lock);
+
+    // Make sure nothing that only lives in the old directory is lost
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->second.buffer == nullptr)
+            it = entries.erase(it);
+        else
+        {
+            it->second.cacheFile = directory.getChildFile(it->first + ".pfcache");
+            ++it;
+        }
+    }
+
+    cacheDirectory = directory;
+
+    // The new directory's index is read the next time a file is keyed
+    pathIndex.clear();
+    pathIndexLoaded = false;
+}
+
+juce::File SamplePool::getDiskCacheDirectory() const
+{
+    const juce::ScopedLock sl(lock);
+    return cacheDirectory;
+}
+
+void SamplePool::clearDiskCache()
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->second.buffer == nullptr)
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+
+    for (const auto& file : cacheDirectory.findChildFiles(juce::File::findFiles, false, "*.pfcache;*.pfpeaks"))
+        file.deleteFile();
+
+    cacheDirectory.getChildFile(PATH_INDEX_FILE).deleteFile();
+}
+
+void SamplePool::setDiskCacheBudget(juce::int64 bytes)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        diskBudgetBytes = std::max((juce::int64)0, bytes);
+    }
+    enforceDiskBudget();
+}
+
+juce::int64 SamplePool::getDiskCacheBudget() const
+{
+    const juce::ScopedLock sl(lock);
+    return diskBudgetBytes;
+}
+
+juce::int64 SamplePool::getDiskCacheBytes() const
+{
+    juce::int64 bytes = 0;
+    for (const auto& file : getDiskCacheDirectory().findChildFiles(juce::File::findFiles, false, "*.pfcache;*.pfpeaks"))
+        bytes += file.getSize();
+    return bytes;
+}
+
+void SamplePool::enforceDiskBudget()
+{
+    const auto budget = getDiskCacheBudget();
+
+    auto files = getDiskCacheDirectory().findChildFiles(juce::File::findFiles, false, "*.pfcache");
+
+    juce::int64 total = 0;
+    for (const auto& file : files)
+        total += file.getSize();
+
+    if (total <= budget)
+        return;
+
+    // Least recently used first - hits stamp the access time themselves
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+              { return a.getLastAccessTime() < b.getLastAccessTime(); });
+
+    for (const auto& file : files)
+    {
+        if (total <= budget)
+            break;
+
+        // Entries evicted to this file notice it's gone and decode again
+        total -= file.getSize();
+        file.deleteFile();
+        file.withFileExtension("pfpeaks").deleteFile();
+    }
+}
+
+bool SamplePool::writeCacheFile(const juce::File& file, const juce::AudioBuffer<float>& buffer,
+                                double sampleRate)
+{
+    if (!file.getParentDirectory().createDirectory())
+        return false;
+
+    // Write beside the target and swap in, so a crash never leaves a truncated cache
+    juce::TemporaryFile temp(file);
+
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return false;
+
+        out.writeInt(CACHE_MAGIC);
+        out.writeInt(CACHE_VERSION);
+        out.writeInt(buffer.getNumChannels());
+        out.writeInt64(buffer.getNumSamples());
+        out.writeDouble(sampleRate);
+        out.writeRepeatedByte(0, static_cast<size_t>(CACHE_HEADER_BYTES - out.getPosition()));
+
+        const auto channelBytes = static_cast<size_t>(buffer.getNumSamples()) * sizeof(float);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            if (!out.write(buffer.getReadPointer(ch), channelBytes))
+                return false;
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+SamplePool::BufferPtr SamplePool::mapCacheFile(const juce::File& file, double& sampleRate)
+{
+    int numChannels = 0;
+    juce::int64 numSamples = 0;
+    {
+        juce::FileInputStream in(file);
+        if (!in.openedOk())
+            return nullptr;
+
+        if (in.readInt() != CACHE_MAGIC || in.readInt() != CACHE_VERSION)
+            return nullptr;
+
+        numChannels = in.readInt();
+        numSamples = in.readInt64();
+        sampleRate = in.readDouble();
+
+        if (numChannels <= 0 || numSamples <= 0 || numSamples > std::numeric_limits<int>::max()
+            || sampleRate <= 0.0
+            || in.getTotalLength() != CACHE_HEADER_BYTES + numChannels * numSamples * (juce::int64)sizeof(float))
+            return nullptr;
+    }
+
+    // Nothing is read here; pages come in as the audio is used
+    auto mapped = std::make_shared<MappedCacheFile>(file);
+    if (mapped->map.getData() == nullptr)
+        return nullptr;
+
+    auto* data = reinterpret_cast<float*>(static_cast<char*>(mapped->map.getData()) + CACHE_HEADER_BYTES);
+
+    std::vector<float*> channels(static_cast<size_t>(numChannels));
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[static_cast<size_t>(ch)] = data + ch * numSamples;
+
+    mapped->buffer.setDataToReferTo(channels.data(), numChannels, static_cast<int>(numSamples));
+
+    // Shares ownership with the mapping, which stays open as long as the buffer is used
+    return BufferPtr(mapped, &mapped->buffer);
+}
+
+SamplePool::PeaksPtr SamplePool::readPeaksFile(const juce::File& file, int numChannels, juce::int64 lengthInFrames)
+{
+    juce::FileInputStream in(file);
+    if (!in.openedOk())
+        return nullptr;
+
+    auto peaks = WaveformPeaks::readFrom(in);
+    if (peaks == nullptr || peaks->getNumChannels() != numChannels || peaks->getLengthInFrames() != lengthInFrames)
+        return nullptr;
+
+    return peaks;
+}
+
+bool SamplePool::writePeaksFile(const juce::File& file, const WaveformPeaks& peaks)
+{
+    if (!file.getParentDirectory().createDirectory())
+        return false;
+
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk() || !peaks.writeTo(out))
+            return false;
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+// Statistics
+
+SamplePool::Stats SamplePool::getStats() const
+{
+    const juce::ScopedLock sl(lock);
+    return stats;
+}
+
+void SamplePool::resetStats()
+{
+    const juce::ScopedLock sl(lock);
+    stats = {};
+}
+
+void SamplePool::clear()
+{
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    compactEntries.clear();
+    pathIndex.clear();
+    pathIndexLoaded = false;
+    residentBytes = 0;
+}
+
+//==============================================================================
+// Global singleton
+
+static std::unique_ptr<SamplePool> globalSamplePool;
+static juce::SpinLock globalPoolLock;
+
+SamplePool& getSamplePool()
+{
+    juce::SpinLock::ScopedLockType lock(globalPoolLock);
+
+    if (globalSamplePool == nullptr)
+        globalSamplePool = std::make_unique<SamplePool>();
+
+    return *globalSamplePool;
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "CompactAudio.h"
+#include "WaveformPeaks.h"
+#include <functional>
+#include <map>
+#include <memory>
+
+/**
+ * SamplePool - Process-wide store of decoded audio shared by clips and sampler zones
+ *
+ * Buffers are immutable once pooled and handed out as shared_ptr<const ...>,
+ * so importing the same file twice (or duplicating a clip) costs no extra RAM.
+ *
+ * Entries are keyed by a content fingerprint (MD5 of the whole file) and the
+ * target sample rate; a path/size/mtime index avoids re-hashing files that
+ * have already been seen. The index is kept in the cache directory, so a later
+ * session only stats the files it opens and hashes those that are new or whose
+ * size or modification time has changed.
+ *
+ * Memory budget:
+ * - When resident data exceeds the budget, least-recently-used entries that are
+ *   neither pinned nor referenced outside the pool are spilled to a decoded
+ *   on-disk cache and dropped from RAM
+ * - Data still referenced by a clip or zone is never evicted (the audio thread
+ *   may be reading it), so the budget is a target, not a hard limit
+ * - Re-acquiring an evicted entry reloads the raw floats from the disk cache
+ *   instead of decoding and resampling the original file again
+ *
+ * Persistence:
+ * - Entries loaded with persist set are written to the disk cache as soon as
+ *   they are decoded, so later sessions find them there and skip decoding
+ * - Cache files are named by the content key, so an edited file gets new ones
+ *   and copies of a file (whatever their modification times) share them
+ * - Cache files are memory-mapped rather than read, so a cached file opens in
+ *   the time it takes to map it and pages in as it is played or drawn
+ * - The disk cache has its own budget; the least recently used files go first
+ * - Waveform peaks are cached beside the decoded data (getPeaks())
+ *
+ * Compact copies:
+ * - getOrLoadCompact() hands out the audio as CompactAudio (16/24-bit or
+ *   lossless), shared the same way, and lets go of the decoded floats as soon
+ *   as nothing else holds them - from the disk cache, or decoded again, if
+ *   they are asked for later
+ *
+ * Thread-safe. Not for use on the audio thread (may block on file I/O).
+ */
+class SamplePool
+{
+public:
+    using BufferPtr = std::shared_ptr<const juce::AudioBuffer<float>>;
+
+    /** Decodes the file into dest, setting the sample rate of the decoded data */
+    using Decoder = std::function<bool(juce::AudioBuffer<float>& dest, double& sampleRate)>;
+
+    SamplePool();
+    ~SamplePool() = default;
+
+    //==========================================================================
+    // Acquisition
+
+    /**
+     * Return the pooled buffer for file at targetSampleRate, decoding it on a miss
+     * @param targetSampleRate Rate the decoder produces (0 = file's native rate)
+     * @param decoder          Only called when neither RAM nor disk cache has the data
+     * @param sampleRateOut    Receives the sample rate of the returned buffer
+     * @param persist          Keep the decoded data on disk for later sessions
+     *                         (worth it when decoding is slower than reading floats)
+     * @return The shared buffer, or nullptr if the file could not be read
+     */
+    BufferPtr getOrLoad(const juce::File& file, double targetSampleRate,
+                        const Decoder& decoder, double& sampleRateOut, bool persist = false);
+
+    using CompactPtr = std::shared_ptr<const CompactAudio>;
+
+    /**
+     * getOrLoad(), converted to CompactAudio in format
+     * @return The shared compact copy, or nullptr if the file could not be read
+     *         or its audio can't be held compactly (see CompactAudio::fromBuffer())
+     */
+    CompactPtr getOrLoadCompact(const juce::File& file, double targetSampleRate, CompactAudio::Format format,
+                                const Decoder& decoder, double& sampleRateOut, bool persist = false);
+
+    /**
+     * Waveform peaks of a buffer handed out by the pool, built on first use and
+     * cached with the entry (and on disk). Buffers from elsewhere get peaks
+     * that are built but not cached.
+     */
+    using PeaksPtr = std::shared_ptr<const WaveformPeaks>;
+    PeaksPtr getPeaks(const BufferPtr& buffer);
+
+    /** getPeaks() for compact audio handed out by the pool */
+    PeaksPtr getPeaks(const CompactPtr& compact);
+
+    /**
+     * Peaks of a file at its own rate that is not decoded into the pool (a
+     * streamed file), from the disk cache or else from build, which is cached
+     */
+    PeaksPtr getFilePeaks(const juce::File& file, const std::function<PeaksPtr()>& build);
+
+    /** Pinned entries are never evicted (e.g. samples that must stay instant) */
+    void setPinned(const BufferPtr& buffer, bool shouldBePinned);
+
+    /** Shared empty buffer, for owners that have no data yet */
+    static const juce::AudioBuffer<float>& getEmptyBuffer();
+
+    //==========================================================================
+    // Memory budget
+    void setMemoryBudget(juce::int64 bytes);
+    juce::int64 getMemoryBudget() const;
+
+    juce::int64 getResidentBytes() const;
+
+    /** RAM held by compact copies that are still in use (not part of the budget) */
+    juce::int64 getCompactBytes() const;
+    int getNumEntries() const;
+    int getNumResidentEntries() const;
+
+    /** Drop unreferenced entries from RAM now (spilling them to the disk cache) */
+    void trim();
+
+    //==========================================================================
+    // Disk cache
+    void setDiskCacheDirectory(const juce::File& directory);
+    juce::File getDiskCacheDirectory() const;
+    void clearDiskCache();
+
+    /** Size the disk cache is kept under; checked whenever a file is persisted */
+    void setDiskCacheBudget(juce::int64 bytes);
+    juce::int64 getDiskCacheBudget() const;
+    juce::int64 getDiskCacheBytes() const;
+
+    //==========================================================================
+    // Statistics
+    struct Stats
+    {
+        int hits = 0;           // Served from RAM
+        int diskCacheHits = 0;  // Reloaded from the decoded disk cache (this session's or an earlier one's)
+        int decodes = 0;        // Decoded from the original file
+        int evictions = 0;      // Spilled out of RAM
+        int fingerprints = 0;   // Files read through to key them (new, or changed since they were indexed)
+    };
+
+    Stats getStats() const;
+    void resetStats();
+
+    /** Forget every entry (buffers still referenced elsewhere stay alive) */
+    void clear();
+
+    static constexpr juce::int64 DEFAULT_BUDGET_BYTES = (juce::int64)2048 * 1024 * 1024;
+    static constexpr juce::int64 DEFAULT_DISK_BUDGET_BYTES = (juce::int64)8192 * 1024 * 1024;
+
+private:
+    struct Entry
+    {
+        BufferPtr buffer;           // nullptr while evicted to disk
+        double sampleRate = 0.0;
+        juce::int64 bytes = 0;
+        juce::uint64 lastUsed = 0;
+        bool pinned = false;
+        juce::File cacheFile;
+        PeaksPtr peaks;                     // Kept while the data is evicted
+    };
+
+    mutable juce::CriticalSection lock;
+    std::map<juce::String, Entry> entries;          // content key -> entry
+    std::map<juce::String, juce::String> pathIndex; // path/size/mtime -> content key
+    bool pathIndexLoaded = false;                   // From the cache directory's index file
+
+    struct CompactEntry
+    {
+        std::weak_ptr<const CompactAudio> compact;  // Owned by the clips using it
+        juce::String contentKey;                    // Of the floats it was made from
+        double sampleRate = 0.0;
+        PeaksPtr peaks;
+    };
+
+    std::map<juce::String, CompactEntry> compactEntries;   // content key + format -> compact copy
+
+    juce::int64 budgetBytes = DEFAULT_BUDGET_BYTES;
+    juce::int64 diskBudgetBytes = DEFAULT_DISK_BUDGET_BYTES;
+    juce::int64 residentBytes = 0;
+    juce::uint64 useClock = 0;
+    juce::File cacheDirectory;
+    Stats stats;
+
+    juce::String getContentKey(const juce::File& file, double targetSampleRate);
+    static juce::String computeFingerprint(const juce::File& file);
+    void loadPathIndexLocked();
+    void appendPathIndexLocked(const juce::String& pathKey, const juce::String& fingerprint);
+
+    BufferPtr acquireLocked(const juce::String& key, double& sampleRateOut);
+    BufferPtr addLocked(const juce::String& key, BufferPtr buffer, double sampleRate, double& sampleRateOut);
+    void enforceBudgetLocked(juce::int64 budget);
+    bool evictLocked(const juce::String& key);
+    void releaseLocked(const juce::String& key);
+    void enforceDiskBudget();
+
+    static bool writeCacheFile(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate);
+    static BufferPtr mapCacheFile(const juce::File& file, double& sampleRate);
+    static PeaksPtr readPeaksFile(const juce::File& file, int numChannels, juce::int64 lengthInFrames);
+    static bool writePeaksFile(const juce::File& file, const WaveformPeaks& peaks);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplePool)
+};
+
+/**
+ * Global SamplePool singleton for shared use
+ */
+SamplePool& getSamplePool();
@@ -623,6 +623,16 @@ void AnalogSynth::killAllNotes()
     activeNotes.clear();
 }
 
+bool AnalogSynth::isSilent() const
+{
+    for (const auto& voice : voices)
+    {
+        if (voice->isActive())
+            return false;
+    }
+    return true;
+}
+
 //==============================================================================
 // Parameter updates
 
@@ -158,6 +158,7 @@ public:
     void noteOff(int midiNote, int sampleOffset = 0) override;
     void allNotesOff() override;
     void killAllNotes() override;
+    bool isSilent() const override;
 
     //==========================================================================
     // Presets
@@ -13,6 +13,17 @@ DrumSynth::DrumSynth()
     // Initialize pads with default 808 kit
     initializePads();
     configure808Kit();
+    renderAllOneShots();
+}
+
+DrumSynth::~DrumSynth()
+{
+    for (auto& slot : oneShots)
+    {
+        delete slot.current;
+        delete slot.pending.exchange(nullptr);
+        delete slot.retired.exchange(nullptr);
+    }
 }
 
 void DrumSynth::initializePads()
@@ -66,99 +77,125 @@ void DrumSynth::initializePads()
 void DrumSynth::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 {
     SynthBase::prepareToPlay(newSampleRate, newSamplesPerBlock);
+
+    const bool rateChanged = newSampleRate != sampleRateLocal;
     sampleRateLocal = newSampleRate;
+    chokeFadeSamples = juce::jmax(1, juce::roundToInt(newSampleRate * CHOKE_FADE_SECONDS));
+
+    if (rateChanged)
+        renderAllOneShots();
 }
 
 void DrumSynth::processBlock(juce::AudioBuffer<float>& buffer,
                               juce::MidiBuffer& midiMessages)
 {
-    // Process MIDI
-    processMidiMessages(midiMessages);
-
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
     const float masterVolume = getParameter("volume");
 
-    float* leftChannel = buffer.getWritePointer(0);
-    float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+    buffer.clear();
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Idle pads can pick up re-rendered sounds straight away
+    for (int p = 0; p < NUM_PADS; ++p)
     {
-        float leftSum = 0.0f;
-        float rightSum = 0.0f;
+        if (!pads[p].playing && pads[p].chokeFadeRemaining == 0)
+            adoptPendingOneShot(p);
+    }
 
-        // Process each pad
-        for (int p = 0; p < NUM_PADS; ++p)
+    // Render between MIDI events so hits start on their exact sample
+    int position = 0;
+
+    for (const auto metadata : midiMessages)
+    {
+        const int eventPosition = juce::jlimit(0, numSamples, metadata.samplePosition);
+        if (eventPosition > position)
         {
-            auto& pad = pads[p];
+            renderPads(buffer, position, eventPosition - position, masterVolume);
+            position = eventPosition;
+        }
 
-            if (!pad.playing && pad.envelope <= 0.0001f)
-                continue;
+        const auto msg = metadata.getMessage();
 
-            // Generate sound based on type
-            float output = 0.0f;
-            float velocity = pad.velocity;  // Use stored velocity from noteOn
+        if (msg.isNoteOn())
+            noteOn(msg.getNoteNumber(), msg.getFloatVelocity(), eventPosition);
+        else if (msg.isNoteOff())
+            noteOff(msg.getNoteNumber(), eventPosition);
+        else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+            allNotesOff();
+    }
 
-            switch (pad.soundType)
-            {
-                case DrumPad::SoundType::Kick:
-                    output = synthesizeKick(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Snare:
-                    output = synthesizeSnare(pad, velocity);
-                    break;
-                case DrumPad::SoundType::ClosedHiHat:
-                    output = synthesizeHiHat(pad, velocity, false);
-                    break;
-                case DrumPad::SoundType::OpenHiHat:
-                    output = synthesizeHiHat(pad, velocity, true);
-                    break;
-                case DrumPad::SoundType::Tom:
-                    output = synthesizeTom(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Clap:
-                    output = synthesizeClap(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Rim:
-                    output = synthesizeRim(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Cymbal:
-                    output = synthesizeCymbal(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Cowbell:
-                    output = synthesizeCowbell(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Clave:
-                    output = synthesizeClave(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Shaker:
-                    output = synthesizeShaker(pad, velocity);
-                    break;
-                case DrumPad::SoundType::Conga:
-                    output = synthesizeConga(pad, velocity);
-                    break;
-            }
+    if (position < numSamples)
+        renderPads(buffer, position, numSamples - position, masterVolume);
+}
 
-            // Apply level and pan
-            output *= pad.level;
+void DrumSynth::renderPads(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                           float masterVolume)
+{
+    float* leftChannel = buffer.getWritePointer(0, startSample);
+    float* rightChannel = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1, startSample) : nullptr;
 
-            float leftGain = pad.pan < 0 ? 1.0f : 1.0f - pad.pan;
-            float rightGain = pad.pan > 0 ? 1.0f : 1.0f + pad.pan;
+    for (int p = 0; p < NUM_PADS; ++p)
+    {
+        auto& pad = pads[p];
 
-            leftSum += output * leftGain;
-            rightSum += output * rightGain;
+        if (!pad.playing && pad.chokeFadeRemaining == 0)
+            continue;
+
+        auto* shot = oneShots[p].current;
+        if (shot == nullptr || *shot == nullptr)
+        {
+            pad.playing = false;
+            pad.envelope = 0.0f;
+            pad.chokeFadeRemaining = 0;
+            continue;
+        }
 
-            // Check if pad has finished
-            if (pad.envelope <= 0.0001f)
+        const auto& samples = (*shot)->samples;
+        const int remaining = static_cast<int>(samples.size()) - pad.playPosition;
+        int count = juce::jmin(numSamples, remaining);
+        if (pad.chokeFadeRemaining > 0)
+            count = juce::jmin(count, pad.chokeFadeRemaining);
+
+        if (count > 0)
+        {
+            // Every model is linear in velocity, so a hit is just a scaled copy
+            const float gain = pad.velocity * pad.level * masterVolume;
+            const float leftGain = gain * (pad.pan < 0 ? 1.0f : 1.0f - pad.pan);
+            const float rightGain = gain * (pad.pan > 0 ? 1.0f : 1.0f + pad.pan);
+            const float* source = samples.data() + pad.playPosition;
+
+            if (pad.chokeFadeRemaining > 0)
             {
-                pad.playing = false;
+                // Choked - ramp out over a few ms instead of clicking
+                const float fadeStep = 1.0f / static_cast<float>(chokeFadeSamples);
+                float fade = static_cast<float>(pad.chokeFadeRemaining) * fadeStep;
+
+                for (int i = 0; i < count; ++i)
+                {
+                    leftChannel[i] += source[i] * leftGain * fade;
+                    if (rightChannel)
+                        rightChannel[i] += source[i] * rightGain * fade;
+                    fade -= fadeStep;
+                }
+
+                pad.chokeFadeRemaining -= count;
             }
+            else
+            {
+                juce::FloatVectorOperations::addWithMultiply(leftChannel, source, leftGain, count);
+                if (rightChannel)
+                    juce::FloatVectorOperations::addWithMultiply(rightChannel, source, rightGain, count);
+            }
+
+            pad.playPosition += count;
         }
 
-        // Write to output
-        leftChannel[sample] = leftSum * masterVolume;
-        if (rightChannel)
-            rightChannel[sample] = rightSum * masterVolume;
+        // Check if pad has finished
+        if (pad.playPosition >= static_cast<int>(samples.size()))
+        {
+            pad.playing = false;
+            pad.envelope = 0.0f;
+            pad.chokeFadeRemaining = 0;
+        }
     }
 }
 
@@ -184,13 +221,15 @@ void DrumSynth::noteOn(int midiNote, float velocity, int /*sampleOffset*/)
         chokePadsInGroup(pad.chokeGroup, padIndex);
     }
 
+    // A retrigger is a good moment to pick up a re-rendered sound
+    adoptPendingOneShot(padIndex);
+
     // Trigger the pad
     pad.playing = true;
-    pad.phase = 0.0f;
-    pad.envelope = 1.0f;          // Envelope starts at full, decays to 0
+    pad.playPosition = 0;
+    pad.chokeFadeRemaining = 0;
+    pad.envelope = 1.0f;          // Marks the pad as sounding until the one-shot ends
     pad.velocity = velocity;       // Store velocity for amplitude scaling
-    pad.noisePhase = 0.0f;
-    pad.clickEnv = 1.0f;
 }
 
 void DrumSynth::noteOff(int midiNote, int /*sampleOffset*/)
@@ -205,10 +244,21 @@ void DrumSynth::allNotesOff()
     {
         pad.playing = false;
         pad.envelope = 0.0f;
+        pad.chokeFadeRemaining = 0;
     }
     activeNotes.clear();
 }
 
+bool DrumSynth::isSilent() const
+{
+    for (const auto& pad : pads)
+    {
+        if (pad.playing || pad.chokeFadeRemaining > 0)
+            return false;
+    }
+    return true;
+}
+
 //==============================================================================
 juce::String DrumSynth::getPadName(int padIndex) const
 {
@@ -223,6 +273,7 @@ void DrumSynth::setPadParameter(int padIndex, const juce::String& paramName, flo
         return;
 
     auto& pad = pads[padIndex];
+    const float oldPitch = pad.pitch, oldDecay = pad.decay, oldTone = pad.tone;
 
     if (paramName == "pitch")
         pad.pitch = juce::jlimit(0.5f, 2.0f, value);
@@ -234,6 +285,10 @@ void DrumSynth::setPadParameter(int padIndex, const juce::String& paramName, flo
         pad.level = juce::jlimit(0.0f, 1.0f, value);
     else if (paramName == "pan")
         pad.pan = juce::jlimit(-1.0f, 1.0f, value);
+
+    // Level and pan are applied at playback; the rest changes the waveform
+    if (pad.pitch != oldPitch || pad.decay != oldDecay || pad.tone != oldTone)
+        renderPadOneShot(padIndex);
 }
 
 float DrumSynth::getPadParameter(int padIndex, const juce::String& paramName) const
@@ -288,6 +343,35 @@ void DrumSynth::loadKit(const juce::String& kitName)
         configureLoFiKit();
     else if (kitName == "Trap")
         configureTrapKit();
+
+    renderAllOneShots();
+}
+
+void DrumSynth::copyStateFrom(const SynthBase& other)
+{
+    // The kit parameter loads the source's kit; pads edited since are copied over it
+    SynthBase::copyStateFrom(other);
+
+    const auto& source = static_cast<const DrumSynth&>(other);
+    currentKit = source.currentKit;
+
+    for (int i = 0; i < NUM_PADS; ++i)
+    {
+        auto& pad = pads[i];
+        const auto& from = source.pads[i];
+
+        pad.name = from.name;
+        pad.midiNote = from.midiNote;
+        pad.chokeGroup = from.chokeGroup;
+        pad.pitch = from.pitch;
+        pad.decay = from.decay;
+        pad.tone = from.tone;
+        pad.level = from.level;
+        pad.pan = from.pan;
+        pad.soundType = from.soundType;
+    }
+
+    renderAllOneShots();
 }
 
 juce::StringArray DrumSynth::getAvailableKits() const
@@ -765,12 +849,144 @@ void DrumSynth::chokePadsInGroup(int chokeGroup, int exceptPad)
     {
         if (i != exceptPad && pads[i].chokeGroup == chokeGroup)
         {
+            // Fade out whatever is still sounding; isNoteActive() is false from here
+            if (pads[i].playing)
+                pads[i].chokeFadeRemaining = chokeFadeSamples;
+
             pads[i].playing = false;
             pads[i].envelope = 0.0f;
         }
     }
 }
 
+//==============================================================================
+// One-shot cache
+//==============================================================================
+
+DrumOneShotCache::Ref DrumOneShotCache::getOrRender(const Key& key, const std::function<Ref()>& render)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (auto cached = entries[key].lock())
+        return cached;
+
+    // Rendering under the lock keeps two synths from building the same hit twice
+    auto rendered = render();
+    entries[key] = rendered;
+
+    // Drop entries nobody plays any more
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->second.expired())
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+
+    return rendered;
+}
+
+int DrumOneShotCache::getNumCached() const
+{
+    const juce::ScopedLock sl(lock);
+
+    int count = 0;
+    for (const auto& [key, entry] : entries)
+        if (!entry.expired())
+            ++count;
+    return count;
+}
+
+float DrumSynth::synthesizeSample(DrumPad& pad)
+{
+    switch (pad.soundType)
+    {
+        case DrumPad::SoundType::Kick:        return synthesizeKick(pad, 1.0f);
+        case DrumPad::SoundType::Snare:       return synthesizeSnare(pad, 1.0f);
+        case DrumPad::SoundType::ClosedHiHat: return synthesizeHiHat(pad, 1.0f, false);
+        case DrumPad::SoundType::OpenHiHat:   return synthesizeHiHat(pad, 1.0f, true);
+        case DrumPad::SoundType::Tom:         return synthesizeTom(pad, 1.0f);
+        case DrumPad::SoundType::Clap:        return synthesizeClap(pad, 1.0f);
+        case DrumPad::SoundType::Rim:         return synthesizeRim(pad, 1.0f);
+        case DrumPad::SoundType::Cymbal:      return synthesizeCymbal(pad, 1.0f);
+        case DrumPad::SoundType::Cowbell:     return synthesizeCowbell(pad, 1.0f);
+        case DrumPad::SoundType::Clave:       return synthesizeClave(pad, 1.0f);
+        case DrumPad::SoundType::Shaker:      return synthesizeShaker(pad, 1.0f);
+        case DrumPad::SoundType::Conga:       return synthesizeConga(pad, 1.0f);
+    }
+
+    return 0.0f;
+}
+
+DrumOneShotCache::Ref DrumSynth::synthesizeOneShot(const DrumPad& source)
+{
+    // Run the model on a scratch copy from a fresh trigger until it decays
+    DrumPad pad = source;
+    pad.playing = true;
+    pad.phase = 0.0f;
+    pad.envelope = 1.0f;
+    pad.noisePhase = 0.0f;
+    pad.clickEnv = 1.0f;
+
+    auto shot = std::make_shared<DrumOneShot>();
+    const auto maxSamples = static_cast<size_t>(sampleRateLocal * MAX_ONESHOT_SECONDS);
+    shot->samples.reserve(maxSamples);
+
+    while (shot->samples.size() < maxSamples)
+    {
+        shot->samples.push_back(synthesizeSample(pad));
+
+        if (pad.envelope <= 0.0001f)
+            break;
+    }
+
+    shot->samples.shrink_to_fit();
+    return shot;
+}
+
+void DrumSynth::renderPadOneShot(int padIndex)
+{
+    const auto& pad = pads[padIndex];
+    const DrumOneShotCache::Key key { static_cast<int>(pad.soundType), pad.pitch, pad.decay,
+                                      pad.tone, sampleRateLocal };
+
+    auto shot = oneShotCache->getOrRender(key, [this, &pad] { return synthesizeOneShot(pad); });
+
+    releaseRetiredOneShot(padIndex);
+    delete oneShots[padIndex].pending.exchange(new DrumOneShotCache::Ref(std::move(shot)),
+                                               std::memory_order_acq_rel);
+}
+
+void DrumSynth::renderAllOneShots()
+{
+    for (int i = 0; i < NUM_PADS; ++i)
+        renderPadOneShot(i);
+}
+
+void DrumSynth::releaseRetiredOneShot(int padIndex)
+{
+    delete oneShots[padIndex].retired.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void DrumSynth::adoptPendingOneShot(int padIndex)
+{
+    auto& slot = oneShots[padIndex];
+
+    // The old buffer needs somewhere to go - if the last one hasn't been
+    // collected yet, keep playing the current sound until it has
+    if (slot.current != nullptr && slot.retired.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    auto* next = slot.pending.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr)
+        return;
+
+    if (slot.current != nullptr)
+        slot.retired.store(slot.current, std::memory_order_release);
+
+    slot.current = next;
+}
+
 //==============================================================================
 // Kit configurations
 //==============================================================================
@@ -4,6 +4,12 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 #include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
 
 /**
  * DrumPad - A single drum sound synthesizer
@@ -48,6 +54,46 @@ struct DrumPad
     float velocity = 1.0f;    // Stored velocity from noteOn
     float noisePhase = 0.0f;
     float clickEnv = 0.0f;
+
+    // Cached one-shot playback
+    int playPosition = 0;           // Read position in the pre-rendered hit
+    int chokeFadeRemaining = 0;     // Samples left of a choke fade-out
+};
+
+/**
+ * DrumOneShot - A pad hit rendered once at full velocity, unity level and centre pan
+ *
+ * Every synthesis model is linear in velocity, so playback only has to scale
+ * and pan the cached waveform.
+ */
+struct DrumOneShot
+{
+    std::vector<float> samples;
+};
+
+/**
+ * DrumOneShotCache - Process-wide store of rendered pad hits
+ *
+ * Shared between DrumSynth instances via juce::SharedResourcePointer, so many
+ * tracks using the same kit render each sound once. Entries are held weakly
+ * and disappear when no pad uses them any more.
+ */
+class DrumOneShotCache
+{
+public:
+    using Ref = std::shared_ptr<const DrumOneShot>;
+
+    // Everything that changes the rendered waveform
+    using Key = std::tuple<int, float, float, float, double>; // type, pitch, decay, tone, sample rate
+
+    Ref getOrRender(const Key& key, const std::function<Ref()>& render);
+    int getNumCached() const;
+
+private:
+    mutable juce::CriticalSection lock;
+    std::map<Key, std::weak_ptr<const DrumOneShot>> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DrumOneShotCache)
 };
 
 /**
@@ -57,14 +103,19 @@ struct DrumPad
  * - 16 drum pads with different sounds
  * - Multiple kits (808, 909, Acoustic, Lo-Fi, Trap)
  * - Per-pad parameters (pitch, decay, tone, level, pan)
- * - Hi-hat choke groups
+ * - Hi-hat choke groups (with a short fade instead of a hard cut)
  * - All synthesis-based, no samples required
+ *
+ * Each pad's hit is synthesised once into a DrumOneShot when its pitch,
+ * decay, tone, kit or the sample rate changes (on the calling thread, never
+ * the audio thread). The audio thread only mixes scaled copies of those
+ * buffers, sample-accurately at each MIDI event.
  */
 class DrumSynth : public SynthBase
 {
 public:
     DrumSynth();
-    ~DrumSynth() override = default;
+    ~DrumSynth() override;
 
     //==========================================================================
     // SynthBase overrides
@@ -76,9 +127,13 @@ public:
     void noteOn(int midiNote, float velocity, int sampleOffset = 0) override;
     void noteOff(int midiNote, int sampleOffset = 0) override;
     void allNotesOff() override;
+    bool isSilent() const override;
 
     std::vector<SynthPreset> getPresets() const override;
 
+    // Kit and per-pad edits
+    void copyStateFrom(const SynthBase& other) override;
+
     //==========================================================================
     // Drum-specific methods
 
@@ -150,6 +205,10 @@ public:
     static constexpr int CLAVE_NOTE = 75;
     static constexpr int SHAKER_NOTE = 70;
 
+    // Longest hit kept in a one-shot (longer tails are cut)
+    static constexpr double MAX_ONESHOT_SECONDS = 4.0;
+    static constexpr double CHOKE_FADE_SECONDS = 0.003;
+
 protected:
     void onParameterChanged(const juce::String& name, float value) override;
     void onParameterEnumChanged(const juce::String& name, int index) override;
@@ -165,6 +224,37 @@ private:
 
     // Audio processing
     double sampleRateLocal = 44100.0;
+    int chokeFadeSamples = 132;
+
+    //==========================================================================
+    // One-shot cache
+    //
+    // Rendered hits reach the audio thread the same way SoundFontPlayer hands
+    // over TSF instances: a new buffer is published in pending, the audio thread
+    // swaps it in when the pad is idle or retriggered and parks the old one in
+    // retired, and it is deleted later off the audio thread.
+    struct PadOneShot
+    {
+        DrumOneShotCache::Ref* current = nullptr;   // Audio thread only
+        std::atomic<DrumOneShotCache::Ref*> pending{nullptr};
+        std::atomic<DrumOneShotCache::Ref*> retired{nullptr};
+    };
+
+    juce::SharedResourcePointer<DrumOneShotCache> oneShotCache;
+    std::array<PadOneShot, NUM_PADS> oneShots;
+
+    // Re-render one pad / every pad (message thread)
+    void renderPadOneShot(int padIndex);
+    void renderAllOneShots();
+    DrumOneShotCache::Ref synthesizeOneShot(const DrumPad& source);
+    void releaseRetiredOneShot(int padIndex);
+
+    // Audio thread
+    void adoptPendingOneShot(int padIndex);
+    void renderPads(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float masterVolume);
+
+    // One sample of the pad's synthesis model at full velocity
+    float synthesizeSample(DrumPad& pad);
 
     // Synthesis helpers
     float synthesizeKick(DrumPad& pad, float velocity);
@@ -489,6 +489,16 @@ void FMSynth::killAllNotes()
     activeNotes.clear();
 }
 
+bool FMSynth::isSilent() const
+{
+    for (const auto& voice : voices)
+    {
+        if (voice->isActive())
+            return false;
+    }
+    return true;
+}
+
 //==============================================================================
 // Parameter updates
 
@@ -569,6 +569,20 @@ void ProSynth::killAllNotes()
     activeNotes.clear();
 }
 
+bool ProSynth::isSilent() const
+{
+    // The built-in chorus keeps sounding briefly after the last voice
+    if (effectTailRemaining > 0)
+        return false;
+
+    for (const auto& voice : voices)
+    {
+        if (voice->isActive())
+            return false;
+    }
+    return true;
+}
+
 //==============================================================================
 // Process block
 
@@ -589,14 +603,22 @@ void ProSynth::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&
     }
 
     // Process voices
+    bool anyVoiceActive = false;
     for (auto& voice : voices)
     {
         if (voice->isActive())
         {
             voice->renderNextBlock(buffer, 0, numSamples);
+            anyVoiceActive = true;
         }
     }
 
+    // Let the effects ring out before reporting silence
+    if (anyVoiceActive)
+        effectTailRemaining = static_cast<int>(EFFECT_TAIL_SECONDS * sampleRate);
+    else
+        effectTailRemaining = juce::jmax(0, effectTailRemaining - numSamples);
+
     // Apply master volume
     float masterVol = getParameter("master_volume");
     buffer.applyGain(masterVol);
@@ -200,6 +200,7 @@ public:
     void noteOff(int midiNote, int sampleOffset = 0) override;
     void allNotesOff() override;
     void killAllNotes() override;
+    bool isSilent() const override;
 
     //==========================================================================
     // Presets
@@ -234,6 +235,10 @@ private:
     float delayFeedback = 0.3f;
     float delayMix = 0.0f;
 
+    // Samples the effects may still sound after the last voice ends
+    static constexpr double EFFECT_TAIL_SECONDS = 0.1;
+    int effectTailRemaining = 0;
+
     // Macro controls
     std::array<float, 4> macros = {0.0f, 0.0f, 0.0f, 0.0f};
 
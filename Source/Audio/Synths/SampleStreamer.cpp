@@ -0,0 +1,233 @@
+#include "SampleStreamer.h"
+#include "Sampler.h"
+
+//==============================================================================
+// SampleStream Implementation
+//==============================================================================
+
+SampleStream::SampleStream()
+    : ring(static_cast<size_t>(RING_SIZE), 0.0f)
+{
+}
+
+juce::int64 SampleStream::virtualToSource(juce::int64 virtualFrame, bool looping,
+                                          juce::int64 loopStart, juce::int64 loopEnd)
+{
+    if (!looping || loopEnd <= loopStart || virtualFrame < loopEnd)
+        return virtualFrame;
+
+    return loopStart + (virtualFrame - loopStart) % (loopEnd - loopStart);
+}
+
+//==============================================================================
+// Audio thread
+
+void SampleStream::start(const SampleZone* zone, juce::int64 virtualStart,
+                         bool looping, juce::int64 loopStart, juce::int64 loopEnd)
+{
+    readPosition.store(virtualStart, std::memory_order_relaxed);
+    requestedZone.store(zone, std::memory_order_relaxed);
+    requestedStart.store(virtualStart, std::memory_order_relaxed);
+    requestedLooping.store(looping, std::memory_order_relaxed);
+    requestedLoopStart.store(loopStart, std::memory_order_relaxed);
+    requestedLoopEnd.store(loopEnd, std::memory_order_relaxed);
+
+    // Publish - the writer picks everything up once it sees the new generation
+    requestGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void SampleStream::stop()
+{
+    requestedZone.store(nullptr, std::memory_order_relaxed);
+    requestGeneration.fetch_add(1, std::memory_order_release);
+}
+
+bool SampleStream::readFrame(juce::int64 virtualFrame, float& out) const
+{
+    // Ignore anything the writer produced for a previous request
+    if (servicedGeneration.load(std::memory_order_acquire)
+        != requestGeneration.load(std::memory_order_relaxed))
+        return false;
+
+    const auto end = writtenEnd.load(std::memory_order_acquire);
+    const auto begin = std::max(writtenStart.load(std::memory_order_relaxed), end - RING_SIZE);
+
+    if (virtualFrame < begin || virtualFrame >= end)
+        return false;
+
+    out = ring[static_cast<size_t>(virtualFrame & RING_MASK)];
+    return true;
+}
+
+//==============================================================================
+// Message thread
+
+void SampleStream::detach()
+{
+    stop();
+
+    // Wait for an in-flight time slice, then drop all zone references
+    const juce::ScopedLock sl(writerLock);
+    writerZone = nullptr;
+    reader.reset();
+    readerZone = nullptr;
+}
+
+//==============================================================================
+// Writer thread
+
+int SampleStream::useTimeSlice()
+{
+    const juce::ScopedLock sl(writerLock);
+
+    const auto generation = requestGeneration.load(std::memory_order_acquire);
+    if (generation != writerGeneration)
+    {
+        writerGeneration = generation;
+        writerZone = requestedZone.load(std::memory_order_relaxed);
+        writePosition = requestedStart.load(std::memory_order_relaxed);
+        writerLooping = requestedLooping.load(std::memory_order_relaxed);
+        writerLoopStart = requestedLoopStart.load(std::memory_order_relaxed);
+        writerLoopEnd = requestedLoopEnd.load(std::memory_order_relaxed);
+
+        writtenStart.store(writePosition, std::memory_order_relaxed);
+        writtenEnd.store(writePosition, std::memory_order_relaxed);
+        servicedGeneration.store(generation, std::memory_order_release);
+    }
+
+    if (writerZone == nullptr)
+        return 20; // Idle
+
+    if (!openReaderFor(writerZone))
+        return 50;
+
+    // Never overwrite frames the voice may still interpolate from
+    const auto consumed = std::max(readPosition.load(std::memory_order_acquire),
+                                   writtenStart.load(std::memory_order_relaxed));
+    const auto space = RING_SIZE - (writePosition - consumed);
+
+    if (space < CHUNK_SIZE)
+        return 2; // Ring is full, check again shortly
+
+    if (!fillChunk(CHUNK_SIZE))
+        return 50;
+
+    // Keep going immediately while there is room for another chunk
+    return (space - CHUNK_SIZE) >= CHUNK_SIZE ? 0 : 2;
+}
+
+bool SampleStream::openReaderFor(const SampleZone* zone)
+{
+    if (reader != nullptr && readerZone == zone)
+        return true;
+
+    reader.reset();
+    readerZone = nullptr;
+
+    if (formatManager == nullptr || !zone->sourceFile.existsAsFile())
+        return false;
+
+    reader.reset(formatManager->createReaderFor(zone->sourceFile));
+    if (reader == nullptr)
+        return false;
+
+    readBuffer.setSize(static_cast<int>(reader->numChannels), CHUNK_SIZE, false, false, true);
+    readerZone = zone;
+    return true;
+}
+
+bool SampleStream::fillChunk(juce::int64 numFrames)
+{
+    const auto totalLength = reader->lengthInSamples;
+    const int numChannels = readBuffer.getNumChannels();
+    const float channelScale = numChannels > 0 ? 1.0f / static_cast<float>(numChannels) : 0.0f;
+
+    juce::int64 done = 0;
+    while (done < numFrames)
+    {
+        const auto virtualFrame = writePosition + done;
+        const auto sourceFrame = virtualToSource(virtualFrame, writerLooping, writerLoopStart, writerLoopEnd);
+
+        // Contiguous source run: up to the loop end (if we will wrap) or end of file
+        const auto runEnd = (writerLooping && writerLoopEnd > writerLoopStart && sourceFrame < writerLoopEnd)
+                                ? std::min(writerLoopEnd, totalLength)
+                                : totalLength;
+        const auto run = std::min(numFrames - done, runEnd - sourceFrame);
+
+        if (run <= 0)
+        {
+            // Past the end of a one-shot sample - pad with silence
+            for (auto i = done; i < numFrames; ++i)
+                ring[static_cast<size_t>((writePosition + i) & RING_MASK)] = 0.0f;
+            break;
+        }
+
+        if (!reader->read(&readBuffer, 0, static_cast<int>(run), sourceFrame, true, true))
+            return false;
+
+        // Mono-sum into the ring (voices play a mono mix of all channels)
+        for (int i = 0; i < static_cast<int>(run); ++i)
+        {
+            float sum = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+                sum += readBuffer.getSample(ch, i);
+
+            ring[static_cast<size_t>((virtualFrame + i) & RING_MASK)] = sum * channelScale;
+        }
+
+        done += run;
+    }
+
+    writePosition += numFrames;
+    writtenEnd.store(writePosition, std::memory_order_release);
+    return true;
+}
+
+//==============================================================================
+// SampleStreamer Implementation
+//==============================================================================
+
+SampleStreamer::SampleStreamer()
+{
+    formatManager.registerBasicFormats();
+
+    const int numThreads = juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 2);
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto thread = std::make_unique<juce::TimeSliceThread>("Sampler Disk Streamer " + juce::String(i + 1));
+        thread->startThread(juce::Thread::Priority::high);
+        threads.push_back(std::move(thread));
+    }
+}
+
+SampleStreamer::~SampleStreamer()
+{
+    for (auto& thread : threads)
+        thread->stopThread(2000);
+}
+
+void SampleStreamer::addStream(SampleStream* stream)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* thread = threads[nextThread++ % threads.size()].get();
+    stream->formatManager = &formatManager;
+    thread->addTimeSliceClient(stream);
+    assignments.emplace_back(stream, thread);
+}
+
+void SampleStreamer::removeStream(SampleStream* stream)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = assignments.begin(); it != assignments.end(); ++it)
+    {
+        if (it->first == stream)
+        {
+            // Blocks until any in-flight time slice for this stream has finished
+            it->second->removeTimeSliceClient(stream);
+            assignments.erase(it);
+            break;
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct SampleZone;
+
+/**
+ * SampleStream - Per-voice disk read-ahead buffer for a streamed SampleZone
+ *
+ * The audio thread only touches atomics and the ring buffer:
+ * - start()/stop() publish a new request (no locks, no allocation)
+ * - readFrame() returns a mono frame if the writer has already delivered it
+ *
+ * A background TimeSliceThread (owned by SampleStreamer) fills the ring ahead
+ * of the voice's read position. Frames are addressed by "virtual" frame index,
+ * i.e. the monotonic playback position before loop wrapping, so the writer can
+ * follow loops without any coordination from the voice.
+ */
+class SampleStream : public juce::TimeSliceClient
+{
+public:
+    static constexpr int RING_SIZE = 1 << 16;   // Frames of read-ahead (~1.4s @ 48k)
+    static constexpr int CHUNK_SIZE = 4096;     // Frames read from disk per time slice
+
+    SampleStream();
+    ~SampleStream() override = default;
+
+    //==========================================================================
+    // Audio thread
+
+    /** Begin streaming zone from virtualStart (loop points are captured here) */
+    void start(const SampleZone* zone, juce::int64 virtualStart,
+               bool looping, juce::int64 loopStart, juce::int64 loopEnd);
+
+    /** Stop streaming - the writer goes idle on its next slice */
+    void stop();
+
+    /** Read a mono frame. Returns false if the writer has not caught up (underrun). */
+    bool readFrame(juce::int64 virtualFrame, float& out) const;
+
+    /** Tell the writer which frames are no longer needed */
+    void setReadPosition(juce::int64 virtualFrame) { readPosition.store(virtualFrame, std::memory_order_release); }
+
+    /** Record an underrun (called by the voice, at most once per block) */
+    void reportUnderrun() { underruns.fetch_add(1, std::memory_order_relaxed); }
+
+    //==========================================================================
+    // Message thread
+
+    /** Stop and wait for the writer to release any reference to the current zone */
+    void detach();
+
+    int getUnderrunCount() const { return underruns.load(); }
+    void resetUnderrunCount() { underruns.store(0); }
+
+    //==========================================================================
+    // Shared mapping between voice and writer
+    static juce::int64 virtualToSource(juce::int64 virtualFrame, bool looping,
+                                       juce::int64 loopStart, juce::int64 loopEnd);
+
+    //==========================================================================
+    // TimeSliceClient
+    int useTimeSlice() override;
+
+private:
+    friend class SampleStreamer;
+
+    // Ring buffer of mono frames (indexed by virtualFrame & RING_MASK)
+    static constexpr juce::int64 RING_MASK = RING_SIZE - 1;
+    std::vector<float> ring;
+
+    // Request published by the audio thread
+    std::atomic<const SampleZone*> requestedZone{nullptr};
+    std::atomic<juce::int64> requestedStart{0};
+    std::atomic<bool> requestedLooping{false};
+    std::atomic<juce::int64> requestedLoopStart{0};
+    std::atomic<juce::int64> requestedLoopEnd{0};
+    std::atomic<juce::uint32> requestGeneration{0};
+
+    // Writer progress (published with release semantics)
+    std::atomic<juce::uint32> servicedGeneration{0};
+    std::atomic<juce::int64> writtenStart{0};
+    std::atomic<juce::int64> writtenEnd{0};
+    std::atomic<juce::int64> readPosition{0};
+
+    std::atomic<int> underruns{0};
+
+    // Writer-only state
+    juce::CriticalSection writerLock;
+    juce::uint32 writerGeneration = 0;
+    const SampleZone* writerZone = nullptr;
+    juce::int64 writePosition = 0;
+    bool writerLooping = false;
+    juce::int64 writerLoopStart = 0;
+    juce::int64 writerLoopEnd = 0;
+
+    juce::AudioFormatManager* formatManager = nullptr;  // Owned by SampleStreamer
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    const SampleZone* readerZone = nullptr;
+    juce::AudioBuffer<float> readBuffer;
+
+    bool openReaderFor(const SampleZone* zone);
+    bool fillChunk(juce::int64 numFrames);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStream)
+};
+
+//==============================================================================
+
+/**
+ * SampleStreamer - Process-wide pool of disk read-ahead threads
+ *
+ * Shared between all Sampler instances via juce::SharedResourcePointer.
+ * Streams are distributed round-robin over a small number of
+ * TimeSliceThreads so that slow disks do not starve each other.
+ */
+class SampleStreamer
+{
+public:
+    SampleStreamer();
+    ~SampleStreamer();
+
+    void addStream(SampleStream* stream);
+    void removeStream(SampleStream* stream);
+
+    /** Format manager used to open streamed files on the writer threads */
+    juce::AudioFormatManager& getFormatManager() { return formatManager; }
+
+    int getNumThreads() const { return static_cast<int>(threads.size()); }
+
+private:
+    juce::AudioFormatManager formatManager;
+    std::vector<std::unique_ptr<juce::TimeSliceThread>> threads;
+    std::vector<std::pair<SampleStream*, juce::TimeSliceThread*>> assignments;
+    juce::CriticalSection lock;
+    size_t nextThread = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStreamer)
+};
@@ -1,5 +1,6 @@
 #include "Sampler.h"
 #include <cmath>
+#include <set>
 
 //==============================================================================
 // SamplerVoice Implementation
@@ -36,20 +37,34 @@ void SamplerVoice::reset()
     playbackRate = 1.0;
     filter.reset();
     filterEnvelope.reset();
+    stopStream();
+}
+
+void SamplerVoice::killNote()
+{
+    SynthVoice::killNote();
+    stopStream();
 }
 
 void SamplerVoice::onNoteStart()
 {
     // Reset sample position to start position
-    if (currentZone && currentZone->sampleData.getNumSamples() > 0)
+    if (currentZone && currentZone->getLength() > 0)
     {
-        samplePosition = startPosition * currentZone->sampleData.getNumSamples();
+        samplePosition = startPosition * static_cast<double>(currentZone->getLength());
     }
     else
     {
         samplePosition = 0.0;
     }
 
+    virtualPosition = samplePosition;
+
+    if (currentZone && currentZone->streamed)
+        startStream();
+    else
+        stopStream();
+
     // Calculate playback rate for pitch shifting
     playbackRate = calculatePlaybackRate(currentNote);
 
@@ -82,12 +97,105 @@ double SamplerVoice::calculatePlaybackRate(int targetNote)
     return rate;
 }
 
+//==============================================================================
+// Disk streaming
+
+void SamplerVoice::startStream()
+{
+    const auto length = currentZone->getLength();
+    const auto preload = static_cast<juce::int64>(currentZone->getPreloadLength());
+
+    streamLooping = looping;
+    streamLoopStart = juce::jlimit((juce::int64)0, length, currentZone->loopStart);
+    streamLoopEnd = currentZone->loopEnd >= 0 ? juce::jlimit(streamLoopStart, length, currentZone->loopEnd)
+                                              : length;
+    underrunInBlock = false;
+
+    // A loop that lies entirely inside the preloaded head never touches the disk
+    if (streamLooping && streamLoopEnd <= preload)
+    {
+        stopStream();
+        return;
+    }
+
+    // Frames before the end of the preload are served from RAM
+    const auto firstFrame = static_cast<juce::int64>(virtualPosition);
+    stream.start(currentZone, std::max(firstFrame, preload),
+                 streamLooping, streamLoopStart, streamLoopEnd);
+    streamActive = true;
+}
+
+void SamplerVoice::stopStream()
+{
+    if (streamActive)
+    {
+        stream.stop();
+        streamActive = false;
+    }
+}
+
+bool SamplerVoice::readStreamedFrame(juce::int64 virtualFrame, float& out) const
+{
+    const auto sourceFrame = SampleStream::virtualToSource(virtualFrame, streamLooping,
+                                                           streamLoopStart, streamLoopEnd);
+
+    if (sourceFrame >= currentZone->getLength())
+    {
+        out = 0.0f;
+        return true;
+    }
+
+    // Preloaded head - always resident
+    const auto& head = currentZone->getData();
+    if (sourceFrame < head.getNumSamples())
+    {
+        const int numChannels = head.getNumChannels();
+        float sum = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+            sum += head.getSample(ch, static_cast<int>(sourceFrame));
+
+        out = numChannels > 0 ? sum / static_cast<float>(numChannels) : 0.0f;
+        return true;
+    }
+
+    return streamActive && stream.readFrame(virtualFrame, out);
+}
+
+float SamplerVoice::getStreamedSample(double virtualPos)
+{
+    const auto index0 = static_cast<juce::int64>(virtualPos);
+    const float fraction = static_cast<float>(virtualPos - static_cast<double>(index0));
+
+    // Gather the kernel window frame by frame (frames may come from RAM or the ring)
+    const int numTaps = Resampler::getNumTaps(resamplingQuality, playbackRate);
+    const auto first = index0 - Resampler::getTapsBefore(resamplingQuality, playbackRate);
+
+    float window[Resampler::MAX_TAPS];
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        const auto frame = first + tap;
+        if (frame < 0)
+        {
+            window[tap] = 0.0f;
+        }
+        else if (!readStreamedFrame(frame, window[tap]))
+        {
+            underrunInBlock = true;
+            return 0.0f;
+        }
+    }
+
+    return Resampler::interpolate(resamplingQuality, window, fraction, playbackRate);
+}
+
+//==============================================================================
+
 float SamplerVoice::getInterpolatedSample(double position)
 {
-    if (!currentZone || currentZone->sampleData.getNumSamples() == 0)
+    if (!currentZone || currentZone->getPreloadLength() == 0)
         return 0.0f;
 
-    const auto& buffer = currentZone->sampleData;
+    const auto& buffer = currentZone->getData();
     int numSamples = buffer.getNumSamples();
     int numChannels = buffer.getNumChannels();
 
@@ -97,23 +205,12 @@ float SamplerVoice::getInterpolatedSample(double position)
     if (position >= numSamples)
         return 0.0f;
 
-    // Use linear interpolation for simplicity and quality
-    int index0 = static_cast<int>(position);
-    int index1 = index0 + 1;
-    float fraction = static_cast<float>(position - index0);
-
-    // Clamp indices
-    index0 = juce::jlimit(0, numSamples - 1, index0);
-    index1 = juce::jlimit(0, numSamples - 1, index1);
-
-    // Mix all channels (mono sum)
+    // Mix all channels (mono sum) through the shared interpolation kernel
     float output = 0.0f;
     for (int ch = 0; ch < numChannels; ++ch)
     {
-        const float* channelData = buffer.getReadPointer(ch);
-        float sample0 = channelData[index0];
-        float sample1 = channelData[index1];
-        output += sample0 + fraction * (sample1 - sample0);
+        output += Resampler::interpolateAt(resamplingQuality, buffer.getReadPointer(ch),
+                                           numSamples, position, playbackRate);
     }
 
     // Average channels
@@ -126,15 +223,17 @@ float SamplerVoice::getInterpolatedSample(double position)
 void SamplerVoice::renderNextBlock(juce::AudioBuffer<float>& buffer,
                                    int startSample, int numSamples)
 {
-    if (!isActive() || !currentZone || currentZone->sampleData.getNumSamples() == 0)
+    if (!isActive() || !currentZone || currentZone->getLength() == 0)
         return;
 
     auto* outputL = buffer.getWritePointer(0, startSample);
     auto* outputR = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1, startSample) : nullptr;
 
-    int sampleLength = currentZone->sampleData.getNumSamples();
-    int loopStart = currentZone->loopStart;
-    int loopEnd = currentZone->loopEnd >= 0 ? currentZone->loopEnd : sampleLength;
+    const bool streamed = currentZone->streamed;
+    const double sampleLength = static_cast<double>(currentZone->getLength());
+    const auto loopStart = static_cast<double>(currentZone->loopStart);
+    const auto loopEnd = currentZone->loopEnd >= 0 ? static_cast<double>(currentZone->loopEnd) : sampleLength;
+    underrunInBlock = false;
 
     for (int i = 0; i < numSamples; ++i)
     {
@@ -149,19 +248,24 @@ void SamplerVoice::renderNextBlock(juce::AudioBuffer<float>& buffer,
         {
             state = VoiceState::Idle;
             currentNote = -1;
+            stopStream();
             break;
         }
 
         // Check if playback finished (for non-looping samples)
-        if (!looping && samplePosition >= sampleLength)
+        const bool finished = streamed ? (!streamLooping && virtualPosition >= sampleLength)
+                                       : (!looping && samplePosition >= sampleLength);
+        if (finished)
         {
             state = VoiceState::Idle;
             currentNote = -1;
+            stopStream();
             break;
         }
 
         // Read interpolated sample
-        float sample = getInterpolatedSample(samplePosition);
+        float sample = streamed ? getStreamedSample(virtualPosition)
+                                : getInterpolatedSample(samplePosition);
 
         // Apply zone volume
         if (currentZone->volumeDb != 0.0f)
@@ -187,6 +291,7 @@ void SamplerVoice::renderNextBlock(juce::AudioBuffer<float>& buffer,
 
         // Advance sample position
         samplePosition += playbackRate;
+        virtualPosition += playbackRate;
 
         // Handle looping
         if (looping && samplePosition >= loopEnd)
@@ -197,6 +302,15 @@ void SamplerVoice::renderNextBlock(juce::AudioBuffer<float>& buffer,
         // Update voice age
         incrementAge(1);
     }
+
+    if (streamActive)
+    {
+        // Let the writer reuse everything behind the interpolation window
+        stream.setReadPosition(static_cast<juce::int64>(virtualPosition) - Resampler::MAX_TAPS);
+
+        if (underrunInBlock)
+            stream.reportUnderrun();
+    }
 }
 
 //==============================================================================
@@ -267,12 +381,17 @@ Sampler::Sampler()
     for (auto& voice : voices)
     {
         voice = std::make_unique<SamplerVoice>();
+        streamer->addStream(&voice->getStream());
     }
 }
 
 Sampler::~Sampler()
 {
     killAllNotes();
+
+    for (auto& voice : voices)
+        streamer->removeStream(&voice->getStream());
+
     clearAllSamples();
 }
 
@@ -337,11 +456,13 @@ void Sampler::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& m
 
     // Process all active voices
     int numSamples = buffer.getNumSamples();
+    const auto quality = Resampler::getQuality(isNonRealtime());
 
     for (auto& voice : voices)
     {
         if (voice->isActive())
         {
+            voice->setResamplingQuality(quality);
             voice->renderNextBlock(buffer, 0, numSamples);
         }
     }
@@ -455,6 +576,16 @@ void Sampler::killAllNotes()
     activeNotes.clear();
 }
 
+bool Sampler::isSilent() const
+{
+    for (const auto& voice : voices)
+    {
+        if (voice->isActive())
+            return false;
+    }
+    return true;
+}
+
 //==============================================================================
 // Sample management
 
@@ -468,10 +599,44 @@ bool Sampler::loadSample(const juce::File& file, int rootNote, int lowNote, int
     if (!reader)
         return false;
 
-    // Load into buffer
-    juce::AudioBuffer<float> sampleBuffer(static_cast<int>(reader->numChannels),
-                                         static_cast<int>(reader->lengthInSamples));
-    reader->read(&sampleBuffer, 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
+    // When streaming, only the head is decoded - the rest is read from disk on demand
+    const auto preloadFrames = static_cast<juce::int64>(preloadMs * 0.001 * reader->sampleRate);
+    const bool streamed = diskStreamingEnabled && reader->lengthInSamples > preloadFrames;
+    const auto totalLength = reader->lengthInSamples;
+    double sampleRate = reader->sampleRate;
+
+    SamplePool::BufferPtr sampleBuffer;
+
+    if (streamed)
+    {
+        // Preload heads are per-zone and small, so they bypass the pool
+        auto head = std::make_shared<juce::AudioBuffer<float>>(static_cast<int>(reader->numChannels),
+                                                               static_cast<int>(preloadFrames));
+        reader->read(head.get(), 0, static_cast<int>(preloadFrames), 0, true, true);
+        sampleBuffer = std::move(head);
+    }
+    else
+    {
+        // Fully resident samples are shared with clips and other zones via the pool
+        reader.reset();
+        sampleBuffer = getSamplePool().getOrLoad(file, 0.0,
+            [this, &file](juce::AudioBuffer<float>& dest, double& decodedRate)
+            {
+                std::unique_ptr<juce::AudioFormatReader> fileReader(formatManager.createReaderFor(file));
+                if (!fileReader)
+                    return false;
+
+                dest.setSize(static_cast<int>(fileReader->numChannels),
+                             static_cast<int>(fileReader->lengthInSamples));
+                fileReader->read(&dest, 0, static_cast<int>(fileReader->lengthInSamples), 0, true, true);
+                decodedRate = fileReader->sampleRate;
+                return true;
+            },
+            sampleRate);
+
+        if (sampleBuffer == nullptr)
+            return false;
+    }
 
     // Generate unique ID from filename and root note
     juce::String zoneId = file.getFileNameWithoutExtension() + "_" + juce::String(rootNote);
@@ -481,30 +646,73 @@ bool Sampler::loadSample(const juce::File& file, int rootNote, int lowNote, int
     if (lowNote < 0) lowNote = rootNote;
     if (highNote < 0) highNote = rootNote;
 
-    return loadSample(zoneId, zoneName, sampleBuffer, reader->sampleRate,
-                     rootNote, lowNote, highNote);
+    if (!loadSample(zoneId, zoneName, std::move(sampleBuffer), sampleRate,
+                    rootNote, lowNote, highNote))
+        return false;
+
+    auto& zone = *zones.back();
+    zone.sourceFile = file;
+
+    if (streamed)
+    {
+        zone.streamed = true;
+        zone.totalLength = totalLength;
+        zone.loopEnd = totalLength;
+    }
+
+    return true;
 }
 
 bool Sampler::loadSample(const juce::String& zoneId, const juce::String& name,
                         const juce::AudioBuffer<float>& samples, double sr,
                         int rootNote, int lowNote, int highNote)
 {
+    return loadSample(zoneId, name, std::make_shared<const juce::AudioBuffer<float>>(samples), sr,
+                      rootNote, lowNote, highNote);
+}
+
+bool Sampler::loadSample(const juce::String& zoneId, const juce::String& name,
+                        SamplePool::BufferPtr samples, double sr,
+                        int rootNote, int lowNote, int highNote)
+{
+    if (samples == nullptr)
+        return false;
+
     // Create new zone
     auto zone = std::make_unique<SampleZone>(zoneId, name, rootNote);
-    zone->sampleData = samples;
+    zone->loopEnd = samples->getNumSamples();
+    zone->sampleData = std::move(samples);
     zone->sampleRate = sr;
     zone->lowNote = lowNote >= 0 ? lowNote : rootNote;
     zone->highNote = highNote >= 0 ? highNote : rootNote;
     zone->loopStart = 0;
-    zone->loopEnd = samples.getNumSamples();
 
     zones.push_back(std::move(zone));
 
     return true;
 }
 
+void Sampler::releaseVoicesForZone(const SampleZone* zone)
+{
+    for (auto& voice : voices)
+    {
+        if (zone == nullptr || voice->getSample() == zone)
+        {
+            voice->killNote();
+            voice->setSample(nullptr);
+            voice->getStream().detach();
+        }
+    }
+}
+
 void Sampler::removeSample(const juce::String& zoneId)
 {
+    for (const auto& zone : zones)
+    {
+        if (zone->id == zoneId)
+            releaseVoicesForZone(zone.get());
+    }
+
     zones.erase(std::remove_if(zones.begin(), zones.end(),
         [&zoneId](const std::unique_ptr<SampleZone>& zone)
         {
@@ -515,9 +723,54 @@ void Sampler::removeSample(const juce::String& zoneId)
 void Sampler::clearAllSamples()
 {
     allNotesOff();
+    releaseVoicesForZone(nullptr);
     zones.clear();
 }
 
+void Sampler::copyStateFrom(const SynthBase& other)
+{
+    SynthBase::copyStateFrom(other);
+
+    const auto& source = static_cast<const Sampler&>(other);
+
+    clearAllSamples();
+    for (const auto& zone : source.zones)
+        zones.push_back(std::make_unique<SampleZone>(*zone));
+
+    diskStreamingEnabled = source.diskStreamingEnabled;
+    preloadMs = source.preloadMs;
+}
+
+int Sampler::getStreamUnderrunCount() const
+{
+    int total = 0;
+    for (const auto& voice : voices)
+        total += voice->getStream().getUnderrunCount();
+    return total;
+}
+
+void Sampler::resetStreamUnderrunCount()
+{
+    for (auto& voice : voices)
+        voice->getStream().resetUnderrunCount();
+}
+
+juce::int64 Sampler::getResidentSampleBytes() const
+{
+    juce::int64 bytes = 0;
+    std::set<const juce::AudioBuffer<float>*> counted;
+
+    for (const auto& zone : zones)
+    {
+        if (zone->sampleData == nullptr || !counted.insert(zone->sampleData.get()).second)
+            continue;
+
+        bytes += static_cast<juce::int64>(zone->sampleData->getNumChannels())
+               * zone->sampleData->getNumSamples() * (juce::int64)sizeof(float);
+    }
+    return bytes;
+}
+
 std::vector<SampleZone*> Sampler::getZones()
 {
     std::vector<SampleZone*> result;
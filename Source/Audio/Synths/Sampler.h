@@ -2,6 +2,9 @@
 
 #include "SynthBase.h"
 #include "SynthVoice.h"
+#include "SampleStreamer.h"
+#include "../Resampler.h"
+#include "../SamplePool.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_dsp/juce_dsp.h>
@@ -13,7 +16,7 @@ struct SampleZone
 {
     juce::String id;
     juce::String name;
-    juce::AudioBuffer<float> sampleData;
+    SamplePool::BufferPtr sampleData;   // Shared with the pool and other zones
     double sampleRate = 44100.0;
 
     int rootNote = 60;  // C4
@@ -23,8 +26,21 @@ struct SampleZone
     float volumeDb = 0.0f;
 
     bool loopEnabled = false;
-    int loopStart = 0;
-    int loopEnd = -1; // -1 = end of sample
+    juce::int64 loopStart = 0;      // 64-bit: streamed zones can run past 2^31 frames
+    juce::int64 loopEnd = -1;       // -1 = end of sample
+
+    // Disk streaming - when enabled, sampleData only holds the preloaded head
+    bool streamed = false;
+    juce::File sourceFile;
+    juce::int64 totalLength = 0;
+
+    const juce::AudioBuffer<float>& getData() const
+    {
+        return sampleData != nullptr ? *sampleData : SamplePool::getEmptyBuffer();
+    }
+
+    juce::int64 getLength() const { return streamed ? totalLength : getData().getNumSamples(); }
+    int getPreloadLength() const { return getData().getNumSamples(); }
 
     SampleZone() = default;
     SampleZone(const juce::String& zoneId, const juce::String& zoneName, int root)
@@ -45,12 +61,17 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void reset() override;
+    void killNote() override;
     void renderNextBlock(juce::AudioBuffer<float>& buffer,
                         int startSample, int numSamples) override;
 
     //==========================================================================
     // Sample assignment
     void setSample(const SampleZone* zone);
+    const SampleZone* getSample() const { return currentZone; }
+
+    // Disk read-ahead for streamed zones (registered with SampleStreamer by Sampler)
+    SampleStream& getStream() { return stream; }
 
     //==========================================================================
     // Playback settings
@@ -58,6 +79,7 @@ public:
     void setStartPosition(float normalizedPosition); // 0.0 to 1.0
     void setTranspose(int semitones);
     void setFineTune(float cents);
+    void setResamplingQuality(Resampler::Quality quality) { resamplingQuality = quality; }
 
     //==========================================================================
     // Filter settings
@@ -84,6 +106,9 @@ private:
     int transpose = 0;
     float fineTune = 0.0f; // In cents
 
+    // Interpolation kernel used when repitching
+    Resampler::Quality resamplingQuality = Resampler::Quality::Hermite;
+
     // Filter - using StateVariableTPT
     juce::dsp::StateVariableTPTFilter<float> filter;
     float filterCutoff = 20000.0f; // Default open filter
@@ -100,6 +125,20 @@ private:
     // Helper to read interpolated sample
     float getInterpolatedSample(double position);
 
+    // Streamed zones: positions are "virtual" (monotonic, before loop wrapping)
+    SampleStream stream;
+    bool streamActive = false;
+    bool streamLooping = false;
+    juce::int64 streamLoopStart = 0;
+    juce::int64 streamLoopEnd = 0;
+    double virtualPosition = 0.0;
+    bool underrunInBlock = false;
+
+    void startStream();
+    void stopStream();
+    bool readStreamedFrame(juce::int64 virtualFrame, float& out) const;
+    float getStreamedSample(double virtualPos);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplerVoice)
 };
 
@@ -111,12 +150,13 @@ private:
  * Features:
  * - Load audio files (WAV, AIFF, FLAC, MP3, OGG)
  * - Multi-zone mapping (assign samples to note ranges)
- * - Pitch shifting with interpolation
+ * - Pitch shifting with selectable interpolation quality (see Resampler)
  * - Loop modes (one-shot, forward loop)
  * - ADSR envelope
  * - Filter with envelope
  * - Sample start position
  * - Transpose and fine tune
+ * - Optional disk streaming for large multisampled libraries
  */
 class Sampler : public SynthBase
 {
@@ -137,6 +177,7 @@ public:
     void noteOff(int midiNote, int sampleOffset = 0) override;
     void allNotesOff() override;
     void killAllNotes() override;
+    bool isSilent() const override;
 
     //==========================================================================
     // Sample management
@@ -144,12 +185,34 @@ public:
     bool loadSample(const juce::String& zoneId, const juce::String& name,
                    const juce::AudioBuffer<float>& samples, double sr,
                    int rootNote, int lowNote = -1, int highNote = -1);
+    bool loadSample(const juce::String& zoneId, const juce::String& name,
+                   SamplePool::BufferPtr samples, double sr,
+                   int rootNote, int lowNote = -1, int highNote = -1);
     void removeSample(const juce::String& zoneId);
     void clearAllSamples();
 
     std::vector<SampleZone*> getZones();
     const SampleZone* findZoneForNote(int midiNote) const;
 
+    // Zones are copied sharing their sample data
+    void copyStateFrom(const SynthBase& other) override;
+
+    //==========================================================================
+    // Disk streaming (applies to samples loaded from file after enabling)
+    void setDiskStreamingEnabled(bool enabled) { diskStreamingEnabled = enabled; }
+    bool isDiskStreamingEnabled() const { return diskStreamingEnabled; }
+
+    void setPreloadMilliseconds(double ms) { preloadMs = juce::jlimit(20.0, 5000.0, ms); }
+    double getPreloadMilliseconds() const { return preloadMs; }
+
+    // Read-ahead underruns across all voices since the last reset
+    int getStreamUnderrunCount() const;
+    void resetStreamUnderrunCount();
+
+    // Bytes of decoded sample data held in RAM (preload heads for streamed zones;
+    // buffers shared between zones are counted once)
+    juce::int64 getResidentSampleBytes() const;
+
     //==========================================================================
     // Audio format manager
     juce::AudioFormatManager& getFormatManager() { return formatManager; }
@@ -174,6 +237,14 @@ private:
     // Sample zones
     std::vector<std::unique_ptr<SampleZone>> zones;
 
+    // Disk streaming
+    juce::SharedResourcePointer<SampleStreamer> streamer;
+    bool diskStreamingEnabled = false;
+    double preloadMs = 250.0;
+
+    // Stop voices and streams that still reference a zone about to be deleted
+    void releaseVoicesForZone(const SampleZone* zone);
+
     // Initialize all parameters
     void initializeParameters();
 
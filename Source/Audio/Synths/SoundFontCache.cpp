@@ -0,0 +1,235 @@
+#include "External/tsf.h"
+
+#include "SoundFontCache.h"
+#include <algorithm>
+#include <limits>
+
+SoundFontCache::SoundFontCache() = default;
+
+SoundFontCache::~SoundFontCache()
+{
+    // Let an in-flight parse finish; queued ones are dropped
+    loaderPool.removeAllJobs(true, 10000);
+
+    const juce::ScopedLock sl(lock);
+
+    // Instances should all be gone (players hold the cache alive), but
+    // tsf_close on the master only drops one reference if any remain
+    jassert(instanceBanks.empty());
+
+    for (auto& [key, bank] : banks)
+        tsf_close(bank.master);
+
+    banks.clear();
+}
+
+juce::String SoundFontCache::getKey(const juce::String& path)
+{
+    return juce::File(path).getFullPathName();
+}
+
+tsf* SoundFontCache::parseBank(const juce::String& path)
+{
+    juce::File file(path);
+    if (!file.existsAsFile())
+        return nullptr;
+
+    // Parse straight from the mapped file - TSF decodes samples into its own
+    // float buffer, so the raw bytes never need a heap copy
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+
+    if (mapped.getData() != nullptr && mapped.getSize() > 0
+        && mapped.getSize() <= static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        return tsf_load_memory(mapped.getData(), static_cast<int>(mapped.getSize()));
+    }
+
+    return tsf_load_filename(file.getFullPathName().toRawUTF8());
+}
+
+bool SoundFontCache::addParsedBank(const juce::String& key, tsf* parsed)
+{
+    // Called with the lock held
+    if (parsed == nullptr)
+        return banks.find(key) != banks.end();
+
+    auto it = banks.find(key);
+    if (it != banks.end())
+    {
+        // Someone else parsed it in the meantime - keep theirs
+        tsf_close(parsed);
+        return true;
+    }
+
+    banks[key].master = parsed;
+    return true;
+}
+
+//==============================================================================
+// Loading
+
+bool SoundFontCache::loadBank(const juce::String& path)
+{
+    const auto key = getKey(path);
+
+    {
+        const juce::ScopedLock sl(lock);
+        if (banks.find(key) != banks.end())
+            return true;
+    }
+
+    auto* parsed = parseBank(key);
+
+    const juce::ScopedLock sl(lock);
+    return addParsedBank(key, parsed);
+}
+
+void SoundFontCache::loadBankAsync(const juce::String& path, Client* client)
+{
+    const auto key = getKey(path);
+
+    juce::ScopedLock sl(lock);
+
+    if (banks.find(key) != banks.end())
+    {
+        const juce::ScopedUnlock unlocked(lock);
+        if (client != nullptr)
+            client->soundFontBankReady(key, true);
+        return;
+    }
+
+    auto pending = pendingRequests.find(key);
+    if (pending != pendingRequests.end())
+    {
+        // Already being parsed - just wait for that job
+        if (client != nullptr)
+            pending->second.push_back(client);
+        return;
+    }
+
+    auto& clients = pendingRequests[key];
+    if (client != nullptr)
+        clients.push_back(client);
+
+    loaderPool.addJob([this, key]
+    {
+        auto* parsed = parseBank(key);
+
+        // Clients can't be cancelled between being taken off the list and being told
+        const juce::ScopedLock callbacks(callbackLock);
+
+        bool loaded = false;
+        std::vector<Client*> waiting;
+        {
+            const juce::ScopedLock jobLock(lock);
+            loaded = addParsedBank(key, parsed);
+
+            auto requests = pendingRequests.find(key);
+            if (requests == pendingRequests.end())
+                return;
+
+            waiting = std::move(requests->second);
+            pendingRequests.erase(requests);
+        }
+
+        for (auto* waitingClient : waiting)
+            waitingClient->soundFontBankReady(key, loaded);
+    });
+}
+
+void SoundFontCache::cancelRequests(Client* client)
+{
+    // Waits for a callback in progress, which holds callbackLock but not lock
+    const juce::ScopedLock callbacks(callbackLock);
+    const juce::ScopedLock sl(lock);
+
+    for (auto& [key, clients] : pendingRequests)
+        clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+}
+
+bool SoundFontCache::isBankLoaded(const juce::String& path) const
+{
+    const juce::ScopedLock sl(lock);
+    return banks.find(getKey(path)) != banks.end();
+}
+
+bool SoundFontCache::isBankLoading(const juce::String& path) const
+{
+    const juce::ScopedLock sl(lock);
+    return pendingRequests.find(getKey(path)) != pendingRequests.end();
+}
+
+int SoundFontCache::getNumBanks() const
+{
+    const juce::ScopedLock sl(lock);
+    return static_cast<int>(banks.size());
+}
+
+//==============================================================================
+// Instances
+
+tsf* SoundFontCache::createInstance(const juce::String& path)
+{
+    const auto key = getKey(path);
+
+    // tsf_copy and tsf_close share a plain reference count, so both stay under the lock
+    const juce::ScopedLock sl(lock);
+
+    auto it = banks.find(key);
+    if (it == banks.end())
+        return nullptr;
+
+    auto* instance = tsf_copy(it->second.master);
+    if (instance == nullptr)
+        return nullptr;
+
+    ++it->second.numInstances;
+    instanceBanks[instance] = key;
+    return instance;
+}
+
+void SoundFontCache::releaseInstance(tsf* instance)
+{
+    if (instance == nullptr)
+        return;
+
+    const juce::ScopedLock sl(lock);
+
+    auto owner = instanceBanks.find(instance);
+    if (owner != instanceBanks.end())
+    {
+        auto bank = banks.find(owner->second);
+        if (bank != banks.end())
+            --bank->second.numInstances;
+
+        instanceBanks.erase(owner);
+    }
+
+    tsf_close(instance);
+}
+
+int SoundFontCache::getNumInstances(const juce::String& path) const
+{
+    const juce::ScopedLock sl(lock);
+
+    auto it = banks.find(getKey(path));
+    return it != banks.end() ? it->second.numInstances : 0;
+}
+
+void SoundFontCache::purgeUnused()
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = banks.begin(); it != banks.end();)
+    {
+        if (it->second.numInstances == 0)
+        {
+            tsf_close(it->second.master);
+            it = banks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
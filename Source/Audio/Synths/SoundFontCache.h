@@ -0,0 +1,93 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <map>
+#include <vector>
+
+// Forward declaration for TinySoundFont handle
+struct tsf;
+
+/**
+ * SoundFontCache - Process-wide store of parsed SoundFont banks
+ *
+ * Shared between all SoundFontPlayer instances via juce::SharedResourcePointer.
+ * Each .sf2 is parsed once (from a memory-mapped view of the file, so the raw
+ * bytes are never copied onto the heap); players then get lightweight
+ * tsf_copy() instances that share the bank's presets and decoded sample data
+ * and only own their voice and channel state.
+ *
+ * Banks can be parsed on a background thread so creating tracks never blocks
+ * the UI. Requests for a bank that is already being parsed join that job.
+ */
+class SoundFontCache
+{
+public:
+    /** Notified when an asynchronously requested bank has finished parsing */
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        /**
+         * Called on the loader thread, or immediately on the calling thread if
+         * the bank was already cached. The cache lock is not held, so the
+         * client may call back into the cache (e.g. createInstance()).
+         */
+        virtual void soundFontBankReady(const juce::String& path, bool loaded) = 0;
+    };
+
+    SoundFontCache();
+    ~SoundFontCache();
+
+    //==========================================================================
+    // Loading
+
+    /** Parse the bank now (or reuse the cached one). Blocks the caller. */
+    bool loadBank(const juce::String& path);
+
+    /** Parse the bank on the loader thread and notify client when done */
+    void loadBankAsync(const juce::String& path, Client* client);
+
+    /** Forget any outstanding requests from client (waits for an in-flight callback) */
+    void cancelRequests(Client* client);
+
+    bool isBankLoaded(const juce::String& path) const;
+    bool isBankLoading(const juce::String& path) const;
+    int getNumBanks() const;
+
+    //==========================================================================
+    // Instances
+
+    /** New playback instance of a cached bank, or nullptr if it isn't loaded */
+    tsf* createInstance(const juce::String& path);
+
+    /** Close an instance (cached or not). Banks stay cached until purgeUnused(). */
+    void releaseInstance(tsf* instance);
+
+    int getNumInstances(const juce::String& path) const;
+
+    /** Close banks that have no live instances */
+    void purgeUnused();
+
+private:
+    struct Bank
+    {
+        tsf* master = nullptr;  // Never rendered - only used as the tsf_copy source
+        int numInstances = 0;
+    };
+
+    mutable juce::CriticalSection lock;
+    juce::CriticalSection callbackLock;     // Held around callbacks so cancelRequests() can wait for them; taken before lock
+    std::map<juce::String, Bank> banks;
+    std::map<juce::String, std::vector<Client*>> pendingRequests;
+    std::map<tsf*, juce::String> instanceBanks;
+
+    juce::ThreadPool loaderPool { juce::ThreadPoolOptions{}.withThreadName("SoundFont Loader")
+                                                           .withNumberOfThreads(1) };
+
+    static juce::String getKey(const juce::String& path);
+    static tsf* parseBank(const juce::String& path);
+    bool addParsedBank(const juce::String& key, tsf* parsed);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SoundFontCache)
+};
@@ -70,43 +70,65 @@ SoundFontPlayer::SoundFontPlayer()
     addParameter("attackOverride", "Attack Override", 0.0f, 0.0f, 1.0f);
     addParameter("releaseOverride", "Release Override", 0.0f, 0.0f, 1.0f);
 
-    // Try to load bundled SoundFont
+    for (auto& program : channelPrograms)
+        program.store(0);
+
+    // Try to load bundled SoundFont (in the background - never blocks track creation)
     loadBundledSoundFont();
 }
 
 SoundFontPlayer::~SoundFontPlayer()
 {
-    if (soundFont != nullptr)
-    {
-        tsf_close(soundFont);
-        soundFont = nullptr;
-    }
+    // Waits for an in-flight soundFontBankReady() callback
+    cache->cancelRequests(this);
+
+    cache->releaseInstance(pendingSoundFont.exchange(nullptr));
+    releaseRetiredSoundFont();
+    cache->releaseInstance(soundFont);
+    soundFont = nullptr;
 }
 
 //==============================================================================
 void SoundFontPlayer::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 {
     SynthBase::prepareToPlay(newSampleRate, newSamplesPerBlock);
+    outputSampleRate.store(newSampleRate);
 
     // Resize render buffer for stereo interleaved output
     renderBuffer.resize(static_cast<size_t>(newSamplesPerBlock * 2));
 
+    adoptPendingSoundFont();
+    releaseRetiredSoundFont();
+
     // Configure TSF output
     if (soundFont != nullptr)
     {
         // Use -10dB gain reduction to prevent clipping (SoundFont samples can be hot)
         tsf_set_output(soundFont, TSF_STEREO_INTERLEAVED, static_cast<int>(newSampleRate), -10.0f);
-
-        // Limit max voices to prevent CPU spikes and voice stealing artifacts
-        tsf_set_max_voices(soundFont, 64);
     }
 }
 
 void SoundFontPlayer::processBlock(juce::AudioBuffer<float>& buffer,
                                    juce::MidiBuffer& midiMessages)
 {
+    // Pick up a newly loaded SoundFont before handling this block's MIDI
+    adoptPendingSoundFont();
+
+    const bool useChannels = multitimbral.load();
+    if (useChannels != renderingMultitimbral)
+    {
+        // Notes started in one mode can't be released by the other
+        if (soundFont != nullptr)
+            tsf_note_off_all(soundFont);
+        activeNotes.clear();
+        renderingMultitimbral = useChannels;
+    }
+
     // Process MIDI messages
-    processMidiMessages(midiMessages);
+    if (renderingMultitimbral)
+        processMultitimbralMidi(midiMessages);
+    else
+        processMidiMessages(midiMessages);
 
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
@@ -218,75 +240,202 @@ void SoundFontPlayer::allNotesOff()
     activeNotes.clear();
 }
 
+bool SoundFontPlayer::isSilent() const
+{
+    return soundFont == nullptr || tsf_active_voice_count(soundFont) == 0;
+}
+
 //==============================================================================
 bool SoundFontPlayer::loadSoundFont(const juce::String& path)
 {
-    // Close existing SoundFont
-    if (soundFont != nullptr)
-    {
-        tsf_close(soundFont);
-        soundFont = nullptr;
-    }
+    // Parsed once per process - later loads of the same file only copy voice state
+    if (!cache->loadBank(path))
+        return false;
 
-    // Load new SoundFont
-    soundFont = tsf_load_filename(path.toRawUTF8());
-
-    if (soundFont != nullptr)
-    {
-        currentSoundFontPath = path;
+    return installInstance(cache->createInstance(path), juce::File(path).getFullPathName());
+}
 
-        // Configure output if already prepared
-        if (sampleRate > 0)
-        {
-            tsf_set_output(soundFont, TSF_STEREO_INTERLEAVED, static_cast<int>(sampleRate), -10.0f);
-            tsf_set_max_voices(soundFont, 64);
-        }
+void SoundFontPlayer::loadSoundFontAsync(const juce::String& path)
+{
+    loading.store(true);
+    cache->loadBankAsync(path, this);
+}
 
-        return true;
-    }
+void SoundFontPlayer::soundFontBankReady(const juce::String& path, bool loaded)
+{
+    // On the loader thread, or right away if cached
+    if (loaded)
+        installInstance(cache->createInstance(path), path);
 
-    return false;
+    loading.store(false);
 }
 
 bool SoundFontPlayer::loadSoundFontFromMemory(const void* data, size_t size)
 {
-    // Close existing SoundFont
-    if (soundFont != nullptr)
+    // Private, uncached bank
+    return installInstance(tsf_load_memory(data, static_cast<int>(size)), "(memory)");
+}
+
+bool SoundFontPlayer::installInstance(tsf* instance, const juce::String& path)
+{
+    if (instance == nullptr)
+        return false;
+
+    // Everything that may allocate happens here, off the audio thread
+    configureInstance(instance);
+
+    // Free the slot the audio thread parks the outgoing instance in, then publish
+    releaseRetiredSoundFont();
+    cache->releaseInstance(pendingSoundFont.exchange(instance));
+
+    const juce::ScopedLock sl(pathLock);
+    currentSoundFontPath = path;
+    return true;
+}
+
+void SoundFontPlayer::configureInstance(tsf* instance) const
+{
+    const double rate = outputSampleRate.load();
+    const int outputRate = rate > 0 ? static_cast<int>(rate) : 44100;
+    tsf_set_output(instance, TSF_STEREO_INTERLEAVED, outputRate, -10.0f);
+
+    // Limit max voices to prevent CPU spikes and voice stealing artifacts
+    // (also pre-allocates them, so note-ons never allocate)
+    tsf_set_max_voices(instance, MAX_VOICES);
+
+    // Create every channel up front - tsf allocates channels on first use
+    for (int channel = NUM_MIDI_CHANNELS - 1; channel >= 0; --channel)
     {
-        tsf_close(soundFont);
-        soundFont = nullptr;
+        tsf_channel_set_presetnumber(instance, channel, channelPrograms[static_cast<size_t>(channel)].load(),
+                                     channel == DRUM_CHANNEL ? 1 : 0);
     }
+}
+
+void SoundFontPlayer::adoptPendingSoundFont()
+{
+    if (pendingSoundFont.load(std::memory_order_acquire) == nullptr)
+        return;
 
-    // Load from memory
-    soundFont = tsf_load_memory(data, static_cast<int>(size));
+    // The previous instance must be parked before it can be replaced
+    if (soundFont != nullptr && retiredSoundFont.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    auto* next = pendingSoundFont.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr)
+        return;
 
     if (soundFont != nullptr)
-    {
-        currentSoundFontPath = "(memory)";
+        retiredSoundFont.store(soundFont, std::memory_order_release);
 
-        // Configure output if already prepared
-        if (sampleRate > 0)
-        {
-            tsf_set_output(soundFont, TSF_STEREO_INTERLEAVED, static_cast<int>(sampleRate), -10.0f);
-            tsf_set_max_voices(soundFont, 64);
-        }
+    soundFont = next;
 
-        return true;
-    }
+    // Output rate may have changed between configuring and adopting
+    if (sampleRate > 0)
+        tsf_set_output(soundFont, TSF_STEREO_INTERLEAVED, static_cast<int>(sampleRate), -10.0f);
+}
 
-    return false;
+void SoundFontPlayer::releaseRetiredSoundFont()
+{
+    cache->releaseInstance(retiredSoundFont.exchange(nullptr, std::memory_order_acq_rel));
 }
 
 bool SoundFontPlayer::isSoundFontLoaded() const
 {
-    return soundFont != nullptr;
+    return soundFont != nullptr || pendingSoundFont.load() != nullptr;
 }
 
 juce::String SoundFontPlayer::getCurrentSoundFontPath() const
 {
+    const juce::ScopedLock sl(pathLock);
     return currentSoundFontPath;
 }
 
+//==============================================================================
+// Multitimbral mode
+
+void SoundFontPlayer::setChannelProgram(int midiChannel, int program)
+{
+    if (midiChannel < 1 || midiChannel > NUM_MIDI_CHANNELS)
+        return;
+
+    channelPrograms[static_cast<size_t>(midiChannel - 1)].store(juce::jlimit(0, 127, program));
+    channelProgramsChanged.store(true);
+}
+
+int SoundFontPlayer::getChannelProgram(int midiChannel) const
+{
+    if (midiChannel < 1 || midiChannel > NUM_MIDI_CHANNELS)
+        return 0;
+
+    return channelPrograms[static_cast<size_t>(midiChannel - 1)].load();
+}
+
+void SoundFontPlayer::applyChannelPrograms()
+{
+    if (soundFont == nullptr || !channelProgramsChanged.exchange(false))
+        return;
+
+    for (int channel = 0; channel < NUM_MIDI_CHANNELS; ++channel)
+    {
+        tsf_channel_set_presetnumber(soundFont, channel, channelPrograms[static_cast<size_t>(channel)].load(),
+                                     channel == DRUM_CHANNEL ? 1 : 0);
+    }
+}
+
+void SoundFontPlayer::processMultitimbralMidi(juce::MidiBuffer& midiMessages)
+{
+    applyChannelPrograms();
+
+    for (const auto metadata : midiMessages)
+    {
+        const auto msg = metadata.getMessage();
+        const int channel = msg.getChannel() - 1;
+
+        if (channel < 0 || channel >= NUM_MIDI_CHANNELS)
+            continue;
+
+        // Remembered even before a SoundFont is ready, so it starts with the right programs
+        if (msg.isProgramChange())
+        {
+            const int program = msg.getProgramChangeNumber();
+            channelPrograms[static_cast<size_t>(channel)].store(program);
+
+            if (soundFont != nullptr)
+                tsf_channel_set_presetnumber(soundFont, channel, program, channel == DRUM_CHANNEL ? 1 : 0);
+            continue;
+        }
+
+        if (soundFont == nullptr)
+            continue;
+
+        if (msg.isNoteOn())
+        {
+            tsf_channel_note_on(soundFont, channel, msg.getNoteNumber(), msg.getFloatVelocity());
+        }
+        else if (msg.isNoteOff())
+        {
+            tsf_channel_note_off(soundFont, channel, msg.getNoteNumber());
+        }
+        else if (msg.isPitchWheel())
+        {
+            tsf_channel_set_pitchwheel(soundFont, channel, msg.getPitchWheelValue());
+        }
+        else if (msg.isAllSoundOff())
+        {
+            tsf_channel_sounds_off_all(soundFont, channel);
+        }
+        else if (msg.isAllNotesOff())
+        {
+            tsf_channel_note_off_all(soundFont, channel);
+        }
+        else if (msg.isController())
+        {
+            // Volume, pan, expression, sustain, bank select, RPNs...
+            tsf_channel_midi_control(soundFont, channel, msg.getControllerNumber(), msg.getControllerValue());
+        }
+    }
+}
+
 //==============================================================================
 juce::String SoundFontPlayer::getInstrumentName(int programNumber)
 {
@@ -323,6 +472,28 @@ juce::String SoundFontPlayer::getInstrumentCategory(int programNumber)
     return juce::String(categories[category]);
 }
 
+//==============================================================================
+void SoundFontPlayer::copyStateFrom(const SynthBase& other)
+{
+    SynthBase::copyStateFrom(other);
+
+    const auto& source = static_cast<const SoundFontPlayer&>(other);
+
+    // A bank still loading in the source arrives here too, through our own
+    // bundled load; anything else replaces that load
+    const auto path = source.getCurrentSoundFontPath();
+    if (path.isNotEmpty() && path != getCurrentSoundFontPath())
+    {
+        cache->cancelRequests(this);
+        loading.store(false);
+        loadSoundFont(path);
+    }
+
+    setMultitimbral(source.isMultitimbral());
+    for (int channel = 1; channel <= NUM_MIDI_CHANNELS; ++channel)
+        setChannelProgram(channel, source.getChannelProgram(channel));
+}
+
 //==============================================================================
 std::vector<SynthPreset> SoundFontPlayer::getPresets() const
 {
@@ -393,11 +564,9 @@ void SoundFontPlayer::loadBundledSoundFont()
         juce::File sf2File(path);
         if (sf2File.existsAsFile())
         {
-            if (loadSoundFont(path))
-            {
-                DBG("Loaded bundled SoundFont: " + path);
-                return;
-            }
+            // Every player shares one parsed copy; only the first triggers a parse
+            loadSoundFontAsync(path);
+            return;
         }
     }
 
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "SynthBase.h"
+#include "SoundFontCache.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
 
 // Forward declaration for TinySoundFont handle
 struct tsf;
@@ -13,6 +16,14 @@ struct tsf;
  * Uses TinySoundFont for SF2 parsing and rendering.
  * Provides access to 128 General MIDI instruments.
  *
+ * Banks are parsed once per process by SoundFontCache; each player renders
+ * from its own tsf_copy() instance. The bundled bank is loaded in the
+ * background, and new instances are handed to the audio thread lock-free.
+ *
+ * In multitimbral mode one player serves all 16 MIDI channels: notes,
+ * program changes, controllers and pitch bend are routed per channel and
+ * channel 10 plays the GM drum kit.
+ *
  * Parameters:
  *   - instrument: 0-127 (GM program number)
  *   - bank: 0-128 (0 = melodic, 128 = percussion)
@@ -23,7 +34,8 @@ struct tsf;
  *   - attackOverride: 0-1 (envelope attack override)
  *   - releaseOverride: 0-1 (envelope release override)
  */
-class SoundFontPlayer : public SynthBase
+class SoundFontPlayer : public SynthBase,
+                        private SoundFontCache::Client
 {
 public:
     SoundFontPlayer();
@@ -39,19 +51,30 @@ public:
     void noteOn(int midiNote, float velocity, int sampleOffset = 0) override;
     void noteOff(int midiNote, int sampleOffset = 0) override;
     void allNotesOff() override;
+    bool isSilent() const override;
 
     std::vector<SynthPreset> getPresets() const override;
 
+    // The bank is loaded synchronously (it is usually cached already)
+    void copyStateFrom(const SynthBase& other) override;
+    bool isLoading() const override { return isSoundFontLoading(); }
+
     //==========================================================================
     // SoundFont specific methods
 
     /**
-     * Load a SoundFont file
+     * Load a SoundFont file (parsed once and shared via SoundFontCache)
      * @param path Path to the .sf2 file
      * @return true if loaded successfully
      */
     bool loadSoundFont(const juce::String& path);
 
+    /**
+     * Load a SoundFont file on the cache's loader thread. Returns immediately;
+     * isSoundFontLoading() is true until the bank is ready.
+     */
+    void loadSoundFontAsync(const juce::String& path);
+
     /**
      * Load SoundFont from memory
      * @param data Pointer to SF2 data
@@ -65,6 +88,11 @@ public:
      */
     bool isSoundFontLoaded() const;
 
+    /**
+     * Check if an asynchronous load is still in progress
+     */
+    bool isSoundFontLoading() const { return loading.load(); }
+
     /**
      * Get path to currently loaded SoundFont
      */
@@ -88,14 +116,56 @@ public:
      */
     static juce::String getInstrumentCategory(int programNumber);
 
+    //==========================================================================
+    // Multitimbral mode
+
+    /**
+     * When enabled, incoming MIDI is played on its own channel (1-16) with
+     * per-channel programs, instead of every note using the instrument parameter
+     */
+    void setMultitimbral(bool enabled) { multitimbral.store(enabled); }
+    bool isMultitimbral() const { return multitimbral.load(); }
+
+    /**
+     * Set the program of a MIDI channel (1-16) for multitimbral mode.
+     * Applied on the audio thread at the start of the next block.
+     */
+    void setChannelProgram(int midiChannel, int program);
+    int getChannelProgram(int midiChannel) const;
+
+    static constexpr int NUM_MIDI_CHANNELS = 16;
+    static constexpr int DRUM_CHANNEL = 9;  // MIDI channel 10, zero-based
+
 protected:
     void onParameterChanged(const juce::String& name, float value) override;
 
 private:
-    // TinySoundFont instance
+    // Shared bank cache (must outlive every instance below)
+    juce::SharedResourcePointer<SoundFontCache> cache;
+
+    // TinySoundFont instance used by the audio thread
     tsf* soundFont = nullptr;
+
+    // Hand-over between loader and audio thread: a new instance is published in
+    // pendingSoundFont, the audio thread swaps it in and parks the old one in
+    // retiredSoundFont, which is closed later off the audio thread
+    std::atomic<tsf*> pendingSoundFont{nullptr};
+    std::atomic<tsf*> retiredSoundFont{nullptr};
+    std::atomic<bool> loading{false};
+
+    // sampleRate for the loader thread, which configures instances while
+    // prepareToPlay() may be changing it; adoption sets the rate again
+    std::atomic<double> outputSampleRate{0.0};
+
+    juce::CriticalSection pathLock;
     juce::String currentSoundFontPath;
 
+    // Multitimbral state
+    std::atomic<bool> multitimbral{false};
+    bool renderingMultitimbral = false;
+    std::array<std::atomic<int>, NUM_MIDI_CHANNELS> channelPrograms;
+    std::atomic<bool> channelProgramsChanged{false};
+
     // Rendering buffer (interleaved stereo)
     std::vector<float> renderBuffer;
 
@@ -116,6 +186,23 @@ private:
     // Load bundled SoundFont
     void loadBundledSoundFont();
 
+    // SoundFontCache::Client
+    void soundFontBankReady(const juce::String& path, bool loaded) override;
+
+    // Configure a fresh instance off the audio thread and publish it
+    bool installInstance(tsf* instance, const juce::String& path);
+    void configureInstance(tsf* instance) const;
+
+    // Audio thread: swap in a published instance
+    void adoptPendingSoundFont();
+
+    // Close an instance the audio thread has swapped out
+    void releaseRetiredSoundFont();
+
+    // Multitimbral MIDI routing (audio thread)
+    void processMultitimbralMidi(juce::MidiBuffer& midiMessages);
+    void applyChannelPrograms();
+
     // Apply parameter changes to TSF
     void updateTSFSettings();
 
@@ -102,6 +102,7 @@ void SynthBase::setParameter(const juce::String& name, float value)
         param.value = value;
     }
 
+    ++editVersion;
     onParameterChanged(name, value);
 }
 
@@ -120,6 +121,7 @@ void SynthBase::setParameterEnum(const juce::String& name, int index)
         param.value = static_cast<float>(index);
     }
 
+    ++editVersion;
     onParameterEnumChanged(name, index);
 }
 
@@ -146,7 +148,10 @@ void SynthBase::setParameterEnum(const juce::String& name, const juce::String& o
 
     // Callback after lock released
     if (foundIndex >= 0)
+    {
+        ++editVersion;
         onParameterEnumChanged(name, foundIndex);
+    }
 }
 
 float SynthBase::getParameter(const juce::String& name) const
@@ -183,6 +188,23 @@ std::vector<juce::String> SynthBase::getParameterNames() const
     return names;
 }
 
+void SynthBase::copyStateFrom(const SynthBase& other)
+{
+    std::map<juce::String, SynthParameter> source;
+    {
+        juce::ScopedLock lock(other.parameterLock);
+        source = other.parameters;
+    }
+
+    for (const auto& [name, param] : source)
+    {
+        if (param.isEnum())
+            setParameterEnum(name, param.enumIndex);
+        else
+            setParameter(name, param.value);
+    }
+}
+
 //==============================================================================
 // Presets
 
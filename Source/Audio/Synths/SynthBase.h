@@ -3,6 +3,7 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
+#include <atomic>
 #include <map>
 #include <set>
 
@@ -96,6 +97,9 @@ public:
     const SynthParameter* getParameterInfo(const juce::String& name) const;
     std::vector<juce::String> getParameterNames() const;
 
+    // Bumped by every parameter change, presets included
+    juce::uint32 getEditVersion() const { return editVersion.load(); }
+
     //==========================================================================
     // Presets
     virtual std::vector<SynthPreset> getPresets() const { return {}; }
@@ -110,11 +114,26 @@ public:
     // Serialization support
     std::map<juce::String, float> getParameters() const;
 
+    //==========================================================================
+    // Copying (message thread)
+
+    // Take on other's sound: its parameters, plus whatever a subclass keeps
+    // outside them (samples, kits, banks). other is the same kind of synth.
+    virtual void copyStateFrom(const SynthBase& other);
+
+    // True while something the sound depends on is loading in the background
+    virtual bool isLoading() const { return false; }
+
     //==========================================================================
     // State
     const std::set<int>& getActiveNotes() const { return activeNotes; }
     bool hasActiveNotes() const { return !activeNotes.empty(); }
 
+    // True when nothing is sounding (no voices, tails included), so
+    // processBlock() would only output silence until the next MIDI event.
+    // Tracks skip the synth while this holds (audio thread).
+    virtual bool isSilent() const { return false; }
+
     double getSampleRate() const { return sampleRate; }
     int getBlockSize() const { return samplesPerBlock; }
 
@@ -123,6 +142,11 @@ public:
     virtual void setBpm(double newBpm) { currentBpm = newBpm; }
     double getBpm() const { return currentBpm; }
 
+    //==========================================================================
+    // Offline rendering (export) - synths may trade CPU for quality
+    void setNonRealtime(bool isNonRealtime) { nonRealtime.store(isNonRealtime); }
+    bool isNonRealtime() const { return nonRealtime.load(); }
+
 protected:
     // Parameter storage - use CriticalSection for thread safety
     std::map<juce::String, SynthParameter> parameters;
@@ -138,6 +162,11 @@ protected:
     // Tempo sync
     double currentBpm = 120.0;
 
+    // True while rendering offline
+    std::atomic<bool> nonRealtime{false};
+
+    std::atomic<juce::uint32> editVersion{0};
+
     // Current preset
     int currentPresetIndex = -1;
 
@@ -50,12 +50,14 @@ void TempoTrack::addEvent(const TempoEvent& event)
         if (std::abs(e.beatPosition - event.beatPosition) < 0.001)
         {
             e = event;
+            ++editVersion;
             return;
         }
     }
 
     events.push_back(event);
     sortEvents();
+    ++editVersion;
 }
 
 void TempoTrack::removeEventAt(double beatPosition)
@@ -71,6 +73,7 @@ void TempoTrack::removeEventAt(double beatPosition)
             }),
         events.end()
     );
+    ++editVersion;
 }
 
 void TempoTrack::clearEvents()
@@ -83,6 +86,7 @@ void TempoTrack::clearEvents()
     initial.bpm = initialBpm;
     initial.rampType = TempoRampType::Instant;
     events.push_back(initial);
+    ++editVersion;
 }
 
 double TempoTrack::getTempoAtBeat(double beatPosition) const
@@ -138,6 +142,7 @@ void TempoTrack::setInitialTempo(double bpm)
     {
         events[0].bpm = bpm;
     }
+    ++editVersion;
 }
 
 double TempoTrack::beatsToSeconds(double beats) const
@@ -266,6 +271,7 @@ void TempoTrack::fromVar(const juce::var& var)
     }
 
     sortEvents();
+    ++editVersion;
 }
 
 void TempoTrack::sortEvents()
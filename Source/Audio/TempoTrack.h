@@ -107,6 +107,10 @@ public:
      */
     double getBeatRangeDuration(double startBeat, double endBeat) const;
 
+    //==========================================================================
+    // Changes whenever an event is added, removed or changed
+    juce::uint32 getEditVersion() const { return editVersion; }
+
     //==========================================================================
     // Serialization
 
@@ -115,6 +119,7 @@ public:
 
 private:
     std::vector<TempoEvent> events;
+    juce::uint32 editVersion = 0;
 
     // Sort events by beat position
     void sortEvents();
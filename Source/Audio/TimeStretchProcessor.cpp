@@ -6,11 +6,12 @@ TimeStretchProcessor::TimeStretchProcessor() = default;
 
 TimeStretchProcessor::~TimeStretchProcessor() = default;
 
-void TimeStretchProcessor::prepare(double newSampleRate, int channels, int blockSize)
+void TimeStretchProcessor::prepare(double newSampleRate, int channels, int blockSize, Mode newMode)
 {
     sampleRate = newSampleRate;
     numChannels = channels;
     maxBlockSize = blockSize;
+    mode = newMode;
 
     createStretcher();
 }
@@ -30,7 +31,8 @@ void TimeStretchProcessor::createStretcher()
 
     // Configure options for real-time or offline processing
     RubberBandStretcher::Options options =
-        RubberBandStretcher::OptionProcessRealTime |
+        (mode == Mode::RealTime ? RubberBandStretcher::OptionProcessRealTime
+                                : RubberBandStretcher::OptionProcessOffline) |
         RubberBandStretcher::OptionStretchElastic |
         RubberBandStretcher::OptionTransientsCrisp |
         RubberBandStretcher::OptionDetectorCompound |
@@ -96,6 +98,11 @@ void TimeStretchProcessor::setFormantPreservation(bool preserve)
     }
 }
 
+void TimeStretchProcessor::setKeyFrameMap(std::map<size_t, size_t> inputToOutputFrames)
+{
+    keyFrames = std::move(inputToOutputFrames);
+}
+
 int TimeStretchProcessor::process(const juce::AudioBuffer<float>& inputBuffer,
                                    juce::AudioBuffer<float>& outputBuffer)
 {
@@ -169,6 +176,10 @@ void TimeStretchProcessor::processOffline(const juce::AudioBuffer<float>& input,
 
     stretcher->study(inputPtrs.data(), static_cast<size_t>(inputSamples), true);
 
+    // Key frames apply to the pass after the study
+    if (!keyFrames.empty())
+        stretcher->setKeyFrameMap(keyFrames);
+
     // Process in chunks
     const int chunkSize = 4096;
     int inputPos = 0;
@@ -217,6 +228,40 @@ void TimeStretchProcessor::processOffline(const juce::AudioBuffer<float>& input,
     output.setSize(channels, outputPos, true, true, true);
 }
 
+int TimeStretchProcessor::getSamplesRequired() const
+{
+    return stretcher ? static_cast<int>(stretcher->getSamplesRequired()) : 0;
+}
+
+void TimeStretchProcessor::feed(const float* const* input, int numSamples)
+{
+    if (stretcher && numSamples > 0)
+        stretcher->process(input, static_cast<size_t>(numSamples), false);
+}
+
+int TimeStretchProcessor::getNumAvailable() const
+{
+    return stretcher ? juce::jmax(0, stretcher->available()) : 0;
+}
+
+int TimeStretchProcessor::retrieve(float* const* output, int numSamples)
+{
+    if (!stretcher || numSamples <= 0)
+        return 0;
+
+    return static_cast<int>(stretcher->retrieve(output, static_cast<size_t>(numSamples)));
+}
+
+int TimeStretchProcessor::getStartPad() const
+{
+    return stretcher ? static_cast<int>(stretcher->getPreferredStartPad()) : 0;
+}
+
+int TimeStretchProcessor::getStartDelay() const
+{
+    return stretcher ? static_cast<int>(stretcher->getStartDelay()) : 0;
+}
+
 int TimeStretchProcessor::getLatency() const
 {
     if (stretcher)
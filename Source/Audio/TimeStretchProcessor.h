@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <map>
 #include <memory>
 
 // Forward declaration - RubberBand will be included in .cpp
@@ -12,7 +13,8 @@ namespace RubberBand {
  * TimeStretchProcessor - High-quality time-stretching using RubberBand
  *
  * Allows changing tempo without affecting pitch, or pitch without affecting tempo.
- * Used for audio clips to match project tempo.
+ * Used for audio clips to match project tempo: offline for the renders in the
+ * ClipWarpCache, in real time while a render is still being made.
  */
 class TimeStretchProcessor
 {
@@ -24,6 +26,12 @@ public:
     TimeStretchProcessor(const TimeStretchProcessor&) = delete;
     TimeStretchProcessor& operator=(const TimeStretchProcessor&) = delete;
 
+    enum class Mode
+    {
+        RealTime,   // Fed a block at a time; ratio and pitch may change while running
+        Offline     // processOffline() only; studies the whole input first
+    };
+
     //==========================================================================
     // Configuration
 
@@ -32,8 +40,9 @@ public:
      * @param sampleRate Audio sample rate
      * @param numChannels Number of audio channels (1 or 2)
      * @param maxBlockSize Maximum samples per process call
+     * @param mode Real-time or offline stretching
      */
-    void prepare(double sampleRate, int numChannels, int maxBlockSize);
+    void prepare(double sampleRate, int numChannels, int maxBlockSize, Mode mode = Mode::RealTime);
 
     /**
      * Reset processor state (call when seeking or changing parameters)
@@ -63,6 +72,12 @@ public:
     void setFormantPreservation(bool preserve);
     bool getFormantPreservation() const { return formantPreservation; }
 
+    /**
+     * Pin input frames to output frames for the next processOffline(), so the
+     * ratio can vary through the input (a tempo ramp). Offline mode only.
+     */
+    void setKeyFrameMap(std::map<size_t, size_t> inputToOutputFrames);
+
     //==========================================================================
     // Processing
 
@@ -75,6 +90,23 @@ public:
     int process(const juce::AudioBuffer<float>& inputBuffer,
                 juce::AudioBuffer<float>& outputBuffer);
 
+    /**
+     * Allocation-free real-time processing, for the audio thread: feed() what
+     * getSamplesRequired() asks for until getNumAvailable() covers the block,
+     * then retrieve() it
+     */
+    int getSamplesRequired() const;
+    void feed(const float* const* input, int numSamples);
+    int getNumAvailable() const;
+    int retrieve(float* const* output, int numSamples);
+
+    /**
+     * Input frames to feed ahead of the first one wanted, and output samples
+     * to discard after them, so output lines up with the input (real-time)
+     */
+    int getStartPad() const;
+    int getStartDelay() const;
+
     /**
      * Process entire audio buffer offline (for pre-rendering)
      * @param input Source audio buffer
@@ -117,10 +149,12 @@ private:
     double sampleRate = 44100.0;
     int numChannels = 2;
     int maxBlockSize = 512;
+    Mode mode = Mode::RealTime;
 
     double timeRatio = 1.0;
     double pitchSemitones = 0.0;
     bool formantPreservation = false;
+    std::map<size_t, size_t> keyFrames;
 
     bool needsReset = false;
 };
@@ -1,4 +1,7 @@
 #include "Track.h"
+#include "AudioFileLoader.h"
+#include "RenderVersion.h"
+#include "Resampler.h"
 #include <algorithm>
 
 Track::Track(const juce::String& trackName)
@@ -23,6 +26,7 @@ MidiClip* Track::addClip(double startBar, double durationBars)
     MidiClip* ptr = clip.get();
     clips.push_back(std::move(clip));
     sortClips();
+    ++editVersion;
 
     return ptr;
 }
@@ -36,6 +40,7 @@ MidiClip* Track::addClip(std::unique_ptr<MidiClip> clip)
     MidiClip* ptr = clip.get();
     clips.push_back(std::move(clip));
     sortClips();
+    ++editVersion;
 
     return ptr;
 }
@@ -51,6 +56,7 @@ void Track::removeClip(const juce::Uuid& clipId)
             }),
         clips.end()
     );
+    ++editVersion;
 }
 
 MidiClip* Track::getClip(const juce::Uuid& clipId)
@@ -170,6 +176,7 @@ MidiClip* Track::getOrCreateClipForRecording(double barPosition,
     MidiClip* ptr = newClip.get();
     clips.push_back(std::move(newClip));
     sortClips();
+    ++editVersion;
 
     return ptr;
 }
@@ -223,6 +230,7 @@ AudioClip* Track::addAudioClip(double startBeat)
     AudioClip* ptr = clip.get();
     audioClips.push_back(std::move(clip));
     sortAudioClips();
+    ++editVersion;
 
     return ptr;
 }
@@ -236,6 +244,7 @@ AudioClip* Track::addAudioClip(std::unique_ptr<AudioClip> clip)
     AudioClip* ptr = clip.get();
     audioClips.push_back(std::move(clip));
     sortAudioClips();
+    ++editVersion;
 
     return ptr;
 }
@@ -251,6 +260,7 @@ void Track::removeAudioClip(const juce::String& clipId)
             }),
         audioClips.end()
     );
+    ++editVersion;
 }
 
 AudioClip* Track::getAudioClip(const juce::String& clipId)
@@ -313,6 +323,43 @@ void Track::getAudioClipsInRange(double startBeat, double endBeat, double bpm,
     }
 }
 
+bool Track::fillAudioClip(const juce::String& clipId, const AudioClip& loaded)
+{
+    juce::ScopedLock lock(audioClipLock);
+
+    for (auto& clip : audioClips)
+    {
+        if (clip->getId() == clipId)
+        {
+            clip->takeAudioFrom(loaded);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Track::cueAudioClips(AudioFileStream::Cue cue, double beat, double bpm)
+{
+    juce::ScopedLock lock(audioClipLock);
+
+    for (auto& clip : audioClips)
+    {
+        auto* stream = clip->getStream().get();
+        if (stream == nullptr)
+            continue;
+
+        const double clipStart = clip->getStartBeat();
+        if (beat < clipStart || beat >= clipStart + clip->getDurationInBeats(bpm))
+        {
+            stream->setCue(cue, -1);
+            continue;
+        }
+
+        const double sourceFramesPerBeat = clip->getSourceFramesPerBeat(bpm);
+        stream->setCue(cue, clip->getTrimStartSample() + static_cast<juce::int64>((beat - clipStart) * sourceFramesPerBeat));
+    }
+}
+
 void Track::sortAudioClips()
 {
     std::stable_sort(audioClips.begin(), audioClips.end(),
@@ -340,10 +387,16 @@ void Track::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
         if (effect)
             effect->prepareToPlay(sampleRate, samplesPerBlock);
     }
+
+    effectChain.prepareToPlay(sampleRate, samplesPerBlock);
+
+    juce::ScopedLock lock(audioClipLock);
+    audioClipRenderer.prepare(sampleRate, samplesPerBlock);
 }
 
 void Track::processBlock(juce::AudioBuffer<float>& buffer, int numSamples,
-                         double positionInBeats, double bpm)
+                         double positionInBeats, double bpm,
+                         const SendTargets* sendTargets)
 {
     // Skip if muted
     if (muted.load())
@@ -352,10 +405,17 @@ void Track::processBlock(juce::AudioBuffer<float>& buffer, int numSamples,
         return;
     }
 
-    // Apply automation if in a reading mode
+    const bool sounding = renderInserts(buffer, numSamples, positionInBeats, bpm);
+    mix(buffer, numSamples, positionInBeats, sendTargets, sounding);
+}
+
+bool Track::renderInserts(juce::AudioBuffer<float>& buffer, int numSamples,
+                          double positionInBeats, double bpm)
+{
+    // Apply automation if in a reading mode (volume and pan follow in mix())
     if (automationMode != AutomationMode::Off)
     {
-        applyAutomation(positionInBeats);
+        applyInstrumentAutomation(positionInBeats);
     }
 
     // Process audio clips first (they contribute audio directly)
@@ -372,29 +432,279 @@ void Track::processBlock(juce::AudioBuffer<float>& buffer, int numSamples,
         // Use plugin instrument
         pluginInstrument->processBlock(buffer, synthMidiBuffer);
     }
-    else if (synth)
+    else if (synth && (!synthMidiBuffer.isEmpty() || !synth->isSilent()))
     {
         // Update BPM for tempo-synced features (LFOs, etc.)
         synth->setBpm(bpm);
-        // Use built-in synth
+        // Use built-in synth (skipped while nothing sounds and no MIDI is waiting)
         synth->processBlock(buffer, synthMidiBuffer);
     }
 
     synthMidiBuffer.clear();
 
-    // Process plugin effects chain
+    // Process plugin effects chain (plugins can't be relied on to report
+    // their tails, so they always run)
+    bool hasPluginEffects = false;
     juce::MidiBuffer emptyMidi;  // Effects don't need MIDI
     for (auto& effect : pluginEffects)
     {
         if (effect)
         {
             effect->processBlock(buffer, emptyMidi);
+            hasPluginEffects = true;
         }
     }
 
+    // Silent and every insert asleep: the rest would only scale, send and
+    // meter silence
+    if (!hasPluginEffects && EffectBase::isSilent(buffer, numSamples) && effectChain.isAsleep()
+        && !latencyCompensation.isHoldingAudio())
+    {
+        return false;
+    }
+
+    // Built-in inserts
+    effectChain.processBlock(buffer);
+    latencyCompensation.process(buffer, numSamples);
+    return true;
+}
+
+void Track::mixBlock(juce::AudioBuffer<float>& buffer, int numSamples,
+                     double positionInBeats, const SendTargets* sendTargets)
+{
+    mix(buffer, numSamples, positionInBeats, sendTargets, !EffectBase::isSilent(buffer, numSamples));
+}
+
+void Track::mix(juce::AudioBuffer<float>& buffer, int numSamples, double positionInBeats,
+                const SendTargets* sendTargets, bool sounding)
+{
+    if (automationMode != AutomationMode::Off)
+    {
+        applyMixAutomation(positionInBeats);
+    }
+
+    if (!sounding)
+    {
+        meterLevel.store(0.0f);
+        return;
+    }
+
+    if (sendTargets != nullptr)
+        processSends(buffer, numSamples, *sendTargets, true);
+
     // Apply gain and pan
     applyGainAndPan(buffer);
     updateMeter(buffer);
+
+    if (sendTargets != nullptr)
+        processSends(buffer, numSamples, *sendTargets, false);
+}
+
+juce::uint64 Track::getRenderVersion()
+{
+    RenderVersion version;
+    version.add(editVersion.load());
+    version.add(effectChain.getRenderVersion());
+
+    {
+        juce::ScopedLock lock(synthLock);
+        if (synth)
+            version.add(synth.get(), synth->getEditVersion() - automationEdits);
+    }
+
+    {
+        juce::ScopedLock lock(clipLock);
+        version.add(clips.size());
+        for (const auto& clip : clips)
+            version.add(clip.get(), clip->getEditVersion());
+    }
+
+    {
+        juce::ScopedLock lock(audioClipLock);
+        version.add(audioClips.size());
+        for (const auto& clip : audioClips)
+            version.add(clip.get(), clip->getEditVersion());
+    }
+
+    version.add(automationLanes.size());
+    for (const auto& lane : automationLanes)
+        version.add(lane.get(), lane->getEditVersion());
+
+    return version.get();
+}
+
+int Track::getLatencySamples() const
+{
+    int latency = effectChain.getLatencySamples();
+
+    juce::ScopedLock lock(synthLock);
+    for (const auto& effect : pluginEffects)
+    {
+        if (effect)
+            latency += effect->getLatencySamples();
+    }
+    return latency;
+}
+
+void Track::processSends(const juce::AudioBuffer<float>& buffer, int numSamples,
+                         const SendTargets& sendTargets, bool preFader)
+{
+    for (int bus = 0; bus < MAX_SENDS; ++bus)
+    {
+        auto* target = sendTargets[static_cast<size_t>(bus)];
+        const auto& send = sends[static_cast<size_t>(bus)];
+
+        if (target == nullptr || send.preFader.load() != preFader)
+            continue;
+
+        const float level = send.level.load();
+        if (level <= 0.0f)
+            continue;
+
+        const int numChannels = juce::jmin(buffer.getNumChannels(), target->getNumChannels());
+        const int count = juce::jmin(numSamples, target->getNumSamples());
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            target->addFrom(ch, 0, buffer, ch, 0, count, level);
+    }
+}
+
+void Track::setSendLevel(int bus, float level)
+{
+    if (bus >= 0 && bus < MAX_SENDS)
+        sends[static_cast<size_t>(bus)].level.store(juce::jlimit(0.0f, 1.0f, level));
+}
+
+float Track::getSendLevel(int bus) const
+{
+    if (bus < 0 || bus >= MAX_SENDS)
+        return 0.0f;
+    return sends[static_cast<size_t>(bus)].level.load();
+}
+
+void Track::setSendPreFader(int bus, bool preFader)
+{
+    if (bus >= 0 && bus < MAX_SENDS)
+        sends[static_cast<size_t>(bus)].preFader.store(preFader);
+}
+
+bool Track::isSendPreFader(int bus) const
+{
+    if (bus < 0 || bus >= MAX_SENDS)
+        return false;
+    return sends[static_cast<size_t>(bus)].preFader.load();
+}
+
+void Track::setNonRealtime(bool isNonRealtime)
+{
+    nonRealtime.store(isNonRealtime);
+
+    juce::ScopedLock lock(synthLock);
+    if (synth)
+        synth->setNonRealtime(isNonRealtime);
+}
+
+void Track::setTempoTrack(const TempoTrack* tempoTrack)
+{
+    juce::ScopedLock lock(audioClipLock);
+    audioClipRenderer.setTempoTrack(tempoTrack);
+}
+
+void Track::copyStateFrom(const Track& other, juce::AudioPluginFormatManager& pluginFormats,
+                          juce::StringArray& missingPlugins)
+{
+    // other is only read, and edits to it happen on this thread too, so its
+    // locks aren't taken - the audio thread playing it never waits for us
+    id = other.id;
+    name = other.name;
+    colour = other.colour;
+
+    setVolume(other.getVolume());
+    setPan(other.getPan());
+    setMuted(other.isMuted());
+    setSoloed(other.isSoloed());
+    setOutputGroup(other.getOutputGroup());
+
+    for (int bus = 0; bus < MAX_SENDS; ++bus)
+    {
+        setSendLevel(bus, other.getSendLevel(bus));
+        setSendPreFader(bus, other.isSendPreFader(bus));
+    }
+
+    // Instrument and inserts
+    setSynthType(other.synthType);
+    if (synth != nullptr && other.synth != nullptr)
+        synth->copyStateFrom(*other.synth);
+
+    auto copyPlugin = [&](juce::AudioPluginInstance& plugin,
+                          const juce::PluginDescription& description) -> std::unique_ptr<juce::AudioPluginInstance>
+    {
+        juce::String error;
+        auto copy = pluginFormats.createPluginInstance(description, sampleRate, samplesPerBlock, error);
+        if (copy == nullptr)
+        {
+            missingPlugins.add(description.name);
+            return nullptr;
+        }
+
+        juce::MemoryBlock state;
+        plugin.getStateInformation(state);
+        copy->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        return copy;
+    };
+
+    clearPluginInstrument();
+    if (other.pluginInstrument != nullptr && other.pluginInstrumentDesc != nullptr)
+    {
+        setPluginInstrument(copyPlugin(*other.pluginInstrument, *other.pluginInstrumentDesc));
+        usePluginInstrument = pluginInstrument != nullptr && other.usePluginInstrument;
+    }
+
+    for (int slot = 0; slot < MAX_PLUGIN_EFFECTS; ++slot)
+    {
+        const auto& plugin = other.pluginEffects[static_cast<size_t>(slot)];
+        const auto& description = other.pluginEffectDescs[static_cast<size_t>(slot)];
+
+        if (plugin != nullptr && description != nullptr)
+            setPluginEffect(slot, copyPlugin(*plugin, *description));
+        else
+            clearPluginEffect(slot);
+    }
+
+    effectChain.copyStateFrom(other.effectChain);
+
+    // Clips and automation
+    {
+        juce::ScopedLock lock(clipLock);
+        clips.clear();
+        for (const auto& clip : other.clips)
+        {
+            if (auto copy = MidiClip::fromVar(clip->toVar()))
+                clips.push_back(std::move(copy));
+        }
+    }
+
+    {
+        juce::ScopedLock lock(audioClipLock);
+        audioClips.clear();
+        for (const auto& clip : other.audioClips)
+            audioClips.push_back(clip->createIndependentCopy(getAudioFileLoader().getFormatManager()));
+    }
+
+    automationLanes.clear();
+    for (const auto& lane : other.automationLanes)
+    {
+        if (auto copy = AutomationLane::fromVar(lane->toVar()))
+            automationLanes.push_back(std::move(copy));
+    }
+    automationMode = other.automationMode;
+
+    ++editVersion;
+}
+
+bool Track::isLoading() const
+{
+    return (synth != nullptr && synth->isLoading()) || effectChain.isLoading();
 }
 
 void Track::releaseResources()
@@ -410,6 +720,8 @@ void Track::releaseResources()
         if (effect)
             effect->releaseResources();
     }
+
+    effectChain.releaseResources();
 }
 
 //==============================================================================
@@ -429,9 +741,12 @@ void Track::setSynthType(SynthType type)
     if (sampleRate > 0 && samplesPerBlock > 0)
         newSynth->prepareToPlay(sampleRate, samplesPerBlock);
 
+    newSynth->setNonRealtime(nonRealtime.load());
+
     // Swap
     synth = std::move(newSynth);
     synthType = type;
+    ++editVersion;
 }
 
 void Track::synthNoteOn(int midiNote, float velocity, int sampleOffset)
@@ -529,6 +844,7 @@ void Track::setPluginInstrument(std::unique_ptr<juce::AudioPluginInstance> plugi
         pluginInstrumentDesc.reset();
         usePluginInstrument = false;
     }
+    ++editVersion;
 }
 
 void Track::clearPluginInstrument()
@@ -542,6 +858,7 @@ void Track::clearPluginInstrument()
     }
     pluginInstrumentDesc.reset();
     usePluginInstrument = false;
+    ++editVersion;
 }
 
 const juce::PluginDescription* Track::getPluginInstrumentDescription() const
@@ -597,6 +914,7 @@ void Track::setPluginEffect(int slot, std::unique_ptr<juce::AudioPluginInstance>
     {
         pluginEffectDescs[static_cast<size_t>(slot)].reset();
     }
+    ++editVersion;
 }
 
 void Track::clearPluginEffect(int slot)
@@ -612,6 +930,7 @@ void Track::clearPluginEffect(int slot)
         pluginEffects[static_cast<size_t>(slot)].reset();
     }
     pluginEffectDescs[static_cast<size_t>(slot)].reset();
+    ++editVersion;
 }
 
 int Track::getNumPluginEffects() const
@@ -665,6 +984,7 @@ AutomationLane* Track::getOrCreateAutomationLane(const juce::String& parameterId
     auto lane = std::make_unique<AutomationLane>(parameterId);
     AutomationLane* ptr = lane.get();
     automationLanes.push_back(std::move(lane));
+    ++editVersion;
     return ptr;
 }
 
@@ -677,6 +997,7 @@ void Track::removeAutomationLane(const juce::String& parameterId)
             }),
         automationLanes.end()
     );
+    ++editVersion;
 }
 
 std::vector<juce::String> Track::getAutomatableParameters() const
@@ -699,27 +1020,44 @@ std::vector<juce::String> Track::getAutomatableParameters() const
     return params;
 }
 
-void Track::applyAutomation(double positionInBeats)
+void Track::applyMixAutomation(double positionInBeats)
 {
     for (const auto& lane : automationLanes)
     {
         if (lane->getNumPoints() == 0)
             continue;
 
-        float normalizedValue = lane->getValueAtTime(positionInBeats);
         const auto& paramId = lane->getParameterId();
 
         if (paramId == "volume")
         {
             // Normalized 0-1 maps to actual 0-2
-            setVolume(normalizedValue * 2.0f);
+            setVolume(lane->getValueAtTime(positionInBeats) * 2.0f);
         }
         else if (paramId == "pan")
         {
             // Normalized 0-1 maps to actual -1 to 1
-            setPan(normalizedValue * 2.0f - 1.0f);
+            setPan(lane->getValueAtTime(positionInBeats) * 2.0f - 1.0f);
         }
-        else if (paramId.startsWith("synth.") && synth != nullptr)
+    }
+}
+
+void Track::applyInstrumentAutomation(double positionInBeats)
+{
+    if (synth == nullptr)
+        return;
+
+    // Automation isn't an edit: keep it out of getRenderVersion()
+    const auto versionBefore = synth->getEditVersion();
+
+    for (const auto& lane : automationLanes)
+    {
+        if (lane->getNumPoints() == 0)
+            continue;
+
+        const auto& paramId = lane->getParameterId();
+
+        if (paramId.startsWith("synth."))
         {
             // Forward to synth parameter system
             auto synthParamId = paramId.substring(6);  // Remove "synth." prefix
@@ -727,12 +1065,15 @@ void Track::applyAutomation(double positionInBeats)
             if (paramInfo != nullptr)
             {
                 // Convert normalized to actual range
+                float normalizedValue = lane->getValueAtTime(positionInBeats);
                 float actualValue = paramInfo->minValue +
                     normalizedValue * (paramInfo->maxValue - paramInfo->minValue);
                 synth->setParameter(synthParamId, actualValue);
             }
         }
     }
+
+    automationEdits += synth->getEditVersion() - versionBefore;
 }
 
 //==============================================================================
@@ -741,116 +1082,8 @@ void Track::applyAutomation(double positionInBeats)
 void Track::processAudioClips(juce::AudioBuffer<float>& buffer, int numSamples,
                                double positionInBeats, double bpm)
 {
-    if (bpm <= 0 || sampleRate <= 0)
-        return;
-
     juce::ScopedLock lock(audioClipLock);
-
-    // Calculate time values
-    double beatsPerSecond = bpm / 60.0;
-    double secondsPerBeat = 60.0 / bpm;
-    double blockDurationInBeats = (numSamples / sampleRate) * beatsPerSecond;
-    double blockEndBeat = positionInBeats + blockDurationInBeats;
-
-    // Find clips that overlap with this block
-    for (auto& clip : audioClips)
-    {
-        if (!clip->hasAudio())
-            continue;
-
-        double clipStartBeat = clip->getStartBeat();
-        double clipDurationBeats = clip->getDurationInBeats(bpm);
-        double clipEndBeat = clipStartBeat + clipDurationBeats;
-
-        // Check if clip overlaps with the current block
-        if (clipEndBeat <= positionInBeats || clipStartBeat >= blockEndBeat)
-            continue;
-
-        // Calculate clip's sample rate ratio for resampling
-        double clipSampleRate = clip->getSampleRate();
-        double playbackRate = clip->getPlaybackRate();
-        double sampleRateRatio = (clipSampleRate / sampleRate) * playbackRate;
-
-        // Calculate the position within the clip at the start of this block
-        double beatOffsetInClip = positionInBeats - clipStartBeat;
-        double secondsIntoClip = beatOffsetInClip * secondsPerBeat;
-
-        // If we're before the clip start, adjust
-        int sampleOffset = 0;
-        if (beatOffsetInClip < 0)
-        {
-            // Block starts before clip - calculate how many samples to skip
-            sampleOffset = static_cast<int>((-beatOffsetInClip * secondsPerBeat) * sampleRate);
-            secondsIntoClip = 0;
-        }
-
-        // Get trim points
-        juce::int64 trimStart = clip->getTrimStartSample();
-        juce::int64 trimEnd = clip->getTrimEndSample();
-        juce::int64 trimmedDuration = trimEnd - trimStart;
-
-        // Calculate starting sample position in clip (accounting for playback rate)
-        double clipSamplePos = trimStart + (secondsIntoClip * clipSampleRate / playbackRate);
-
-        // Get clip gain and fade info
-        float clipGain = clip->getGain();
-        juce::int64 fadeInSamples = clip->getFadeInSamples();
-        juce::int64 fadeOutSamples = clip->getFadeOutSamples();
-
-        const auto& audioBuffer = clip->getAudioBuffer();
-        int clipChannels = audioBuffer.getNumChannels();
-        int bufferChannels = buffer.getNumChannels();
-
-        // Process each sample in the block
-        for (int i = sampleOffset; i < numSamples; ++i)
-        {
-            // Calculate current position in clip samples
-            double currentClipSample = clipSamplePos + (i - sampleOffset) * sampleRateRatio;
-
-            // Check if we're past the trimmed end
-            if (currentClipSample >= trimEnd)
-                break;
-
-            // Skip if before trim start (shouldn't happen, but be safe)
-            if (currentClipSample < trimStart)
-                continue;
-
-            // Calculate sample position relative to trim start (for fades)
-            juce::int64 sampleInTrimmedClip = static_cast<juce::int64>(currentClipSample) - trimStart;
-
-            // Calculate fade envelope
-            float fadeGain = 1.0f;
-
-            // Fade in
-            if (fadeInSamples > 0 && sampleInTrimmedClip < fadeInSamples)
-            {
-                fadeGain = static_cast<float>(sampleInTrimmedClip) / static_cast<float>(fadeInSamples);
-            }
-
-            // Fade out
-            juce::int64 samplesFromEnd = trimmedDuration - sampleInTrimmedClip;
-            if (fadeOutSamples > 0 && samplesFromEnd < fadeOutSamples)
-            {
-                fadeGain *= static_cast<float>(samplesFromEnd) / static_cast<float>(fadeOutSamples);
-            }
-
-            // Linear interpolation for resampling
-            int sampleIndex = static_cast<int>(currentClipSample);
-            float frac = static_cast<float>(currentClipSample - sampleIndex);
-
-            // Get interpolated sample for each channel
-            for (int ch = 0; ch < bufferChannels; ++ch)
-            {
-                // Map buffer channel to clip channel (mono clips play on both channels)
-                int clipCh = (clipChannels == 1) ? 0 : std::min(ch, clipChannels - 1);
-
-                float sample1 = clip->getSample(clipCh, sampleIndex);
-                float sample2 = clip->getSample(clipCh, sampleIndex + 1);
-                float interpolatedSample = sample1 + frac * (sample2 - sample1);
-
-                // Apply gain and fade, add to buffer
-                buffer.addSample(ch, i, interpolatedSample * clipGain * fadeGain);
-            }
-        }
-    }
+    const bool offline = nonRealtime.load();
+    audioClipRenderer.setBlockingReads(offline);
+    audioClipRenderer.render(audioClips, buffer, numSamples, positionInBeats, bpm, Resampler::getQuality(offline));
 }
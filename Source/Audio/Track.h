@@ -6,8 +6,11 @@
 #include <juce_graphics/juce_graphics.h>
 #include "MidiClip.h"
 #include "AudioClip.h"
+#include "AudioClipRenderer.h"
 #include "AutomationLane.h"
 #include "Synths/SynthFactory.h"
+#include "Effects/EffectChain.h"
+#include "CompensationDelay.h"
 #include <array>
 #include <memory>
 #include <vector>
@@ -33,10 +36,15 @@ enum class AutomationMode
  * - Volume, pan, mute, solo controls
  * - Clips with MIDI/audio data
  * - Automation lanes
+ * - Optionally, device inputs it records while armed
  */
 class Track
 {
 public:
+    // Return buses a track can send to (indices match AudioEngine return slots)
+    static constexpr int MAX_SENDS = 4;
+    using SendTargets = std::array<juce::AudioBuffer<float>*, MAX_SENDS>;
+
     Track(const juce::String& name = "Track");
     virtual ~Track() = default;
 
@@ -46,10 +54,46 @@ public:
     //==========================================================================
     // Audio processing
     virtual void prepareToPlay(double sampleRate, int samplesPerBlock);
+    // sendTargets: return bus inputs to add sends into (nullptr entries are skipped)
     virtual void processBlock(juce::AudioBuffer<float>& buffer, int numSamples,
-                              double positionInBeats, double bpm);
+                              double positionInBeats, double bpm,
+                              const SendTargets* sendTargets = nullptr);
     virtual void releaseResources();
 
+    // processBlock() in two stages, so the first can run ahead of the
+    // playhead (see TrackPrerenderer) while the fader stays live:
+    // renderInserts() plays the clips and instrument through the inserts and
+    // delay compensation (returns false if that was silence it skipped);
+    // mixBlock() then sends, pans, applies volume and meters.
+    bool renderInserts(juce::AudioBuffer<float>& buffer, int numSamples,
+                       double positionInBeats, double bpm);
+    void mixBlock(juce::AudioBuffer<float>& buffer, int numSamples,
+                  double positionInBeats, const SendTargets* sendTargets = nullptr);
+
+    // Changes whenever something renderInserts() depends on is edited: clips
+    // and their notes, the instrument and its parameters, automation lanes,
+    // the inserts and their parameters. Call from the thread rendering.
+    // Plugin parameters aren't tracked.
+    juce::uint64 getRenderVersion();
+
+    // Offline rendering (export) - selects the high-quality resampling tier
+    void setNonRealtime(bool isNonRealtime);
+    bool isNonRealtime() const { return nonRealtime.load(); }
+
+    // Tempo map warped audio clips follow (see AudioClipRenderer)
+    void setTempoTrack(const TempoTrack* tempoTrack);
+
+    // Become a copy of other to render it elsewhere (see AudioEngine::copyProjectFrom):
+    // identity, mix and sends, instrument, inserts, clips and automation - not
+    // arming or inputs. Plugins are recreated from their state; the names of
+    // any that can't be are added to missingPlugins. Message thread, before
+    // this track plays.
+    void copyStateFrom(const Track& other, juce::AudioPluginFormatManager& pluginFormats,
+                       juce::StringArray& missingPlugins);
+
+    // True while the instrument or a built-in insert is still loading
+    bool isLoading() const;
+
     //==========================================================================
     // Track properties
     const juce::String& getName() const { return name; }
@@ -75,6 +119,25 @@ public:
     void setArmed(bool armed) { this->armed.store(armed); }
     bool isArmed() const { return armed.load(); }
 
+    // Device inputs recorded while armed (see AudioInputRecorder): the first
+    // input and how many from there (1 or 2), or -1 for none
+    void setInputChannels(int firstChannel, int numChannels)
+    {
+        numInputChannels.store(juce::jlimit(1, 2, numChannels));
+        firstInputChannel.store(juce::jmax(-1, firstChannel));
+    }
+    int getFirstInputChannel() const { return firstInputChannel.load(); }
+    int getNumInputChannels() const { return numInputChannels.load(); }
+    bool hasAudioInput() const { return firstInputChannel.load() >= 0; }
+
+    // Hear the input while armed, dry and ahead of delay compensation
+    void setInputMonitoring(bool shouldMonitor) { inputMonitoring.store(shouldMonitor); }
+    bool isInputMonitoring() const { return inputMonitoring.load(); }
+
+    // Group bus slot this track feeds, or -1 for the master (set via AudioEngine)
+    int getOutputGroup() const { return outputGroup.load(); }
+    void setOutputGroup(int groupSlot) { outputGroup.store(groupSlot); }
+
     //==========================================================================
     // Metering
     float getMeterLevel() const { return meterLevel.load(); }
@@ -109,9 +172,33 @@ public:
     int getNumPluginEffects() const;
     const juce::PluginDescription* getPluginEffectDescription(int slot) const;
 
+    // Built-in insert effects (run after the plugin effects, before the fader)
+    EffectChain& getEffectChain() { return effectChain; }
+    const EffectChain& getEffectChain() const { return effectChain; }
+
+    //==========================================================================
+    // Delay compensation (message thread)
+
+    /** Samples the plugin and built-in inserts delay the track by */
+    int getLatencySamples() const;
+
+    // Extra delay after the inserts that lines the track up with slower ones.
+    // Set by AudioEngine while it isn't processing; sends see the aligned signal.
+    void setLatencyCompensation(int samples) { latencyCompensation.setDelay(samples); }
+    int getLatencyCompensation() const { return latencyCompensation.getDelay(); }
+
+    //==========================================================================
+    // Sends to return buses (atomic for thread-safe access from UI)
+    void setSendLevel(int bus, float level);
+    float getSendLevel(int bus) const;
+
+    // Pre-fader sends tap the signal before volume and pan
+    void setSendPreFader(int bus, bool preFader);
+    bool isSendPreFader(int bus) const;
+
     //==========================================================================
     // Automation
-    void setAutomationMode(AutomationMode mode) { automationMode = mode; }
+    void setAutomationMode(AutomationMode mode) { automationMode = mode; ++editVersion; }
     AutomationMode getAutomationMode() const { return automationMode; }
 
     // Lane management
@@ -194,6 +281,12 @@ public:
     // Sort audio clips by start position
     void sortAudioClips();
 
+    // Move a finished import's audio into its placeholder clip; false if the clip is gone
+    bool fillAudioClip(const juce::String& clipId, const AudioClip& loaded);
+
+    // Have streamed clips sounding at beat load from there (-1 beat clears the cue)
+    void cueAudioClips(AudioFileStream::Cue cue, double beat, double bpm);
+
 protected:
     // Track identity
     juce::Uuid id;
@@ -207,6 +300,7 @@ protected:
     // Audio Clips
     std::vector<std::unique_ptr<AudioClip>> audioClips;
     juce::CriticalSection audioClipLock;
+    AudioClipRenderer audioClipRenderer;    // Guarded by audioClipLock
 
     // Automation
     std::vector<std::unique_ptr<AutomationLane>> automationLanes;
@@ -227,12 +321,30 @@ protected:
     std::array<std::unique_ptr<juce::AudioPluginInstance>, MAX_PLUGIN_EFFECTS> pluginEffects;
     std::array<std::unique_ptr<juce::PluginDescription>, MAX_PLUGIN_EFFECTS> pluginEffectDescs;
 
+    // Built-in insert effects
+    EffectChain effectChain;
+    CompensationDelay latencyCompensation;
+
+    // Sends
+    struct Send
+    {
+        std::atomic<float> level{0.0f};
+        std::atomic<bool> preFader{false};
+    };
+    std::array<Send, MAX_SENDS> sends;
+
     // Mixing (atomic for thread-safe UI access)
     std::atomic<float> volume{1.0f};
     std::atomic<float> pan{0.0f};
     std::atomic<bool> muted{false};
     std::atomic<bool> soloed{false};
     std::atomic<bool> armed{false};
+    std::atomic<int> outputGroup{-1};
+
+    // Audio input
+    std::atomic<int> firstInputChannel{-1};
+    std::atomic<int> numInputChannels{1};
+    std::atomic<bool> inputMonitoring{false};
 
     // Metering
     std::atomic<float> meterLevel{0.0f};
@@ -240,15 +352,30 @@ protected:
     // Audio settings
     double sampleRate = 44100.0;
     int samplesPerBlock = 512;
+    std::atomic<bool> nonRealtime{false};
+
+    // Edit tracking for getRenderVersion()
+    std::atomic<juce::uint32> editVersion{0};
+    juce::uint32 automationEdits = 0;   // Synth parameter changes made by automation
 
     // Apply volume and pan to buffer
     void applyGainAndPan(juce::AudioBuffer<float>& buffer);
 
+    // Add this track's pre- or post-fader sends into the return bus inputs
+    void processSends(const juce::AudioBuffer<float>& buffer, int numSamples,
+                      const SendTargets& sendTargets, bool preFader);
+
     // Update meter level
     void updateMeter(const juce::AudioBuffer<float>& buffer);
 
-    // Apply automation at given position
-    void applyAutomation(double positionInBeats);
+    // Apply automation at given position: volume and pan, or synth parameters
+    void applyMixAutomation(double positionInBeats);
+    void applyInstrumentAutomation(double positionInBeats);
+
+    // The mix stage shared by processBlock() and mixBlock(); a block that
+    // isn't sounding only zeroes the meter
+    void mix(juce::AudioBuffer<float>& buffer, int numSamples, double positionInBeats,
+             const SendTargets* sendTargets, bool sounding);
 
     // Process audio clips into buffer
     void processAudioClips(juce::AudioBuffer<float>& buffer, int numSamples,
@@ -0,0 +1,429 @@
+#include "TrackPrerenderer.h"
+#include <cmath>
+
+//==============================================================================
+// Worker thread - renders whichever stream is furthest from full
+//==============================================================================
+
+class TrackPrerenderer::Worker : public juce::Thread
+{
+public:
+    Worker(TrackPrerenderer& ownerToUse, int index)
+        : juce::Thread("Prerender Worker " + juce::String(index)), owner(ownerToUse)
+    {
+        // Below the mixer workers: these are ahead of time by design
+        startThread(juce::Thread::Priority::high);
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        owner.wake.signal();
+        stopThread(2000);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            // The audio callback wakes us every block; the timeout covers the
+            // settle period running out in between
+            if (!owner.renderSomething())
+                owner.wake.wait(5);
+        }
+    }
+
+private:
+    TrackPrerenderer& owner;
+};
+
+//==============================================================================
+
+TrackPrerenderer::TrackPrerenderer(const TempoTrack& tempoTrackToUse, const TimeSignatureTrack& timeSignatureTrack)
+    : tempoTrack(tempoTrackToUse), timeSignatures(timeSignatureTrack)
+{
+    lookaheadSamples = juce::roundToInt(LOOKAHEAD_SECONDS * sampleRate);
+}
+
+TrackPrerenderer::~TrackPrerenderer()
+{
+    workers.clear();
+}
+
+//==============================================================================
+// Setup
+
+void TrackPrerenderer::prepare(double newSampleRate)
+{
+    const ScopedPause pause(*this);
+
+    sampleRate = newSampleRate;
+    lookaheadSamples = juce::roundToInt(LOOKAHEAD_SECONDS * sampleRate);
+
+    for (auto& stream : streams)
+        allocate(*stream);
+}
+
+void TrackPrerenderer::setTracks(const std::vector<Track*>& tracks)
+{
+    const ScopedPause pause(*this);
+
+    std::vector<std::unique_ptr<Stream>> updated;
+    updated.reserve(tracks.size());
+
+    for (auto* track : tracks)
+    {
+        auto existing = std::find_if(streams.begin(), streams.end(),
+                                     [track](const auto& s) { return s != nullptr && &s->track == track; });
+
+        if (existing != streams.end())
+        {
+            updated.push_back(std::move(*existing));
+        }
+        else
+        {
+            updated.push_back(std::make_unique<Stream>(*track, timeSignatures));
+            allocate(*updated.back());
+        }
+    }
+
+    streams = std::move(updated);
+}
+
+void TrackPrerenderer::setNumThreads(int numThreads)
+{
+    // Not paused: a worker blocked on the structure lock couldn't exit
+    numThreads = juce::jlimit(0, 16, numThreads);
+
+    workers.resize(static_cast<size_t>(juce::jmin(numThreads, getNumThreads())));
+    while (getNumThreads() < numThreads)
+        workers.push_back(std::make_unique<Worker>(*this, getNumThreads() + 1));
+}
+
+void TrackPrerenderer::allocate(Stream& stream)
+{
+    // Room for the lookahead plus the chunk being written
+    const int length = juce::nextPowerOfTwo(lookaheadSamples + CHUNK_SIZE);
+    stream.ring.setSize(2, length);
+    stream.ring.clear();
+    stream.mask = length - 1;
+    stream.chunk.setSize(2, CHUNK_SIZE);
+
+    // Restarted at the playhead by the next syncTrack()
+    stream.written.store(0);
+    stream.consumed.store(0);
+    stream.markersWritten.store(0);
+    stream.currentMarker.store(0);
+    stream.renderingAhead.store(false);
+    stream.invalidated.store(false);
+    stream.droppedOut.store(false);
+    stream.firstBlockPending.store(false);
+}
+
+//==============================================================================
+// Audio thread
+
+void TrackPrerenderer::beginBlock(bool isLoopEnabled, double loopStartBeat, double loopEndBeat)
+{
+    loopEnabled.store(isLoopEnabled);
+    loopStart.store(loopStartBeat);
+    loopEnd.store(loopEndBeat);
+
+    wake.signal();
+}
+
+void TrackPrerenderer::syncTrack(int index, bool renderAhead, double blockStartBeat, double bpm)
+{
+    if (index < 0 || index >= static_cast<int>(streams.size()))
+        return;
+
+    auto& stream = *streams[static_cast<size_t>(index)];
+
+    // None of these wait for a worker; a hand-over it holds up is tried again next block
+    if (!renderAhead)
+    {
+        if (stream.renderingAhead.load())
+        {
+            const juce::ScopedTryLock sl(stream.lock);
+            if (sl.isLocked())
+                stopLocked(stream);
+        }
+        return;
+    }
+
+    if (!stream.renderingAhead.load())
+    {
+        const juce::ScopedTryLock sl(stream.lock);
+        if (sl.isLocked())
+        {
+            restartLocked(stream, blockStartBeat);
+            stream.renderingAhead.store(true);
+        }
+        return;
+    }
+
+    // The usual case: the stream is ahead and still on the playhead's timeline
+    const double tolerance = SYNC_TOLERANCE_SECONDS * bpm / 60.0;
+    if (!stream.invalidated.load() && !stream.droppedOut.load()
+        && stream.written.load(std::memory_order_acquire) > stream.consumed.load()
+        && std::abs(beatAtConsumed(stream) - blockStartBeat) <= tolerance)
+        return;
+
+    const juce::ScopedTryLock sl(stream.lock);
+    if (!sl.isLocked())
+    {
+        // Can't tell it's still on the playhead, so read() plays silence
+        stream.droppedOut.store(true);
+        return;
+    }
+
+    const double beat = stream.written.load() > stream.consumed.load() ? beatAtConsumed(stream) : stream.nextBeat;
+
+    if (stream.invalidated.load() || stream.droppedOut.load() || std::abs(beat - blockStartBeat) > tolerance)
+        restartLocked(stream, blockStartBeat);
+}
+
+bool TrackPrerenderer::isRenderingAhead(int index) const
+{
+    return index >= 0 && index < static_cast<int>(streams.size())
+        && streams[static_cast<size_t>(index)]->renderingAhead.load();
+}
+
+void TrackPrerenderer::read(int index, juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    auto& stream = *streams[static_cast<size_t>(index)];
+    const int numChannels = juce::jmin(buffer.getNumChannels(), stream.ring.getNumChannels());
+
+    if (stream.droppedOut.load())
+    {
+        buffer.clear(0, numSamples);
+        underruns.fetch_add(1);
+        return;
+    }
+
+    auto copyFromRing = [&](int startSample, int count)
+    {
+        const auto consumed = stream.consumed.load();
+        const int available = static_cast<int>(juce::jmin<juce::int64>(count, stream.written.load(std::memory_order_acquire) - consumed));
+        if (available <= 0)
+            return 0;
+
+        const int position = static_cast<int>(consumed & stream.mask);
+        const int first = juce::jmin(available, stream.mask + 1 - position);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            buffer.copyFrom(ch, startSample, stream.ring, ch, position, first);
+            if (available > first)
+                buffer.copyFrom(ch, startSample + first, stream.ring, ch, 0, available - first);
+        }
+
+        stream.consumed.store(consumed + available, std::memory_order_release);
+        return available;
+    };
+
+    int done = copyFromRing(0, numSamples);
+    if (done == numSamples)
+        return;
+
+    // Underrun: render the rest here, unless a worker is partway through a
+    // chunk - waiting for that could take longer than the block lasts
+    const juce::ScopedTryLock sl(stream.lock);
+    if (!sl.isLocked())
+    {
+        buffer.clear(done, numSamples - done);
+        stream.droppedOut.store(true);
+        underruns.fetch_add(1);
+        return;
+    }
+
+    done += copyFromRing(done, numSamples - done);
+
+    // Everything rendered so far has been played, markers included
+    stream.currentMarker.store(stream.markersWritten.load());
+
+    while (done < numSamples)
+    {
+        const int rendered = renderLocked(stream, buffer, done, numSamples - done);
+        stream.written.store(stream.written.load() + rendered);
+        stream.consumed.store(stream.written.load());
+        done += rendered;
+    }
+
+    stream.currentMarker.store(stream.markersWritten.load());
+    stream.firstBlockPending.store(false);
+}
+
+//==============================================================================
+// Any thread
+
+void TrackPrerenderer::invalidate(int index)
+{
+    for (size_t i = 0; i < streams.size(); ++i)
+    {
+        if (index < 0 || static_cast<int>(i) == index)
+            streams[i]->invalidated.store(true);
+    }
+}
+
+//==============================================================================
+// Workers
+
+bool TrackPrerenderer::renderSomething()
+{
+    const juce::ScopedReadLock sl(structureLock);
+
+    const auto numStreams = static_cast<unsigned int>(streams.size());
+    if (numStreams == 0)
+        return false;
+
+    // Start somewhere different each time so every stream gets a turn
+    const auto first = static_cast<unsigned int>(nextStream.fetch_add(1)) % numStreams;
+
+    for (unsigned int i = 0; i < numStreams; ++i)
+    {
+        if (renderAhead(*streams[(first + i) % numStreams]))
+        {
+            // Pass the wake-up on, there may be more to do
+            wake.signal();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TrackPrerenderer::renderAhead(Stream& stream)
+{
+    if (!stream.renderingAhead.load() || stream.invalidated.load() || stream.droppedOut.load()
+        || stream.firstBlockPending.load())
+        return false;
+
+    const juce::ScopedTryLock sl(stream.lock);
+    if (!sl.isLocked() || !stream.renderingAhead.load() || stream.firstBlockPending.load())
+        return false;
+
+    // Edited: what's ahead is stale, and the track plays at the playhead
+    // until the edits stop
+    const auto now = juce::Time::getMillisecondCounter();
+    const auto version = stream.track.getRenderVersion();
+    if (version != stream.version)
+    {
+        stream.version = version;
+        stream.settlesAt.store(now + static_cast<juce::uint32>(SETTLE_SECONDS * 1000.0));
+        if (stream.written.load() > stream.consumed.load())
+            stream.invalidated.store(true);
+        return false;
+    }
+
+    if (static_cast<juce::int32>(now - stream.settlesAt.load()) < 0)
+        return false;
+
+    const auto written = stream.written.load();
+    const auto buffered = written - stream.consumed.load(std::memory_order_acquire);
+    if (buffered >= lookaheadSamples || buffered + CHUNK_SIZE > stream.mask + 1
+        || stream.markersWritten.load() - stream.currentMarker.load() >= MAX_MARKERS - 1)
+        return false;
+
+    const int rendered = renderLocked(stream, stream.chunk, 0, CHUNK_SIZE);
+
+    const int position = static_cast<int>(written & stream.mask);
+    const int first = juce::jmin(rendered, stream.mask + 1 - position);
+    for (int ch = 0; ch < stream.ring.getNumChannels(); ++ch)
+    {
+        stream.ring.copyFrom(ch, position, stream.chunk, ch, 0, first);
+        if (rendered > first)
+            stream.ring.copyFrom(ch, 0, stream.chunk, ch, first, rendered - first);
+    }
+
+    stream.written.store(written + rendered, std::memory_order_release);
+    return true;
+}
+
+//==============================================================================
+// With the stream's lock held
+
+void TrackPrerenderer::restartLocked(Stream& stream, double beat)
+{
+    // Voices started ahead of the playhead are released, and the notes that
+    // should be sounding at it start again
+    stream.track.synthAllNotesOff();
+    stream.scheduler.clear();
+
+    stream.written.store(0);
+    stream.consumed.store(0);
+    stream.markersWritten.store(0);
+    stream.currentMarker.store(0);
+    stream.invalidated.store(false);
+    stream.droppedOut.store(false);
+    stream.firstBlockPending.store(true);
+
+    stream.nextBeat = beat;
+    stream.version = stream.track.getRenderVersion();
+    stream.scheduler.chaseNotes(stream.track, beat);
+}
+
+void TrackPrerenderer::stopLocked(Stream& stream)
+{
+    stream.track.synthAllNotesOff();
+    stream.scheduler.clear();
+
+    stream.written.store(0);
+    stream.consumed.store(0);
+    stream.markersWritten.store(0);
+    stream.currentMarker.store(0);
+    stream.invalidated.store(false);
+    stream.droppedOut.store(false);
+    stream.firstBlockPending.store(false);
+    stream.renderingAhead.store(false);
+}
+
+int TrackPrerenderer::renderLocked(Stream& stream, juce::AudioBuffer<float>& dest, int startSample, int maxSamples)
+{
+    // One tempo per run, cut at the loop end so the wrap is sample-accurate
+    const double beat = stream.nextBeat;
+    const double bpm = tempoTrack.getTempoAtBeat(beat);
+    const double beatsPerSample = (bpm / 60.0) / sampleRate;
+
+    const double start = loopStart.load();
+    const double end = loopEnd.load();
+    const bool looping = loopEnabled.load() && end > start;
+
+    int numSamples = maxSamples;
+    if (looping && beat < end)
+        numSamples = juce::jlimit(1, maxSamples, static_cast<int>(std::ceil((end - beat) / beatsPerSample)));
+
+    const double endBeat = beat + numSamples * beatsPerSample;
+
+    const auto marker = stream.markersWritten.load();
+    stream.markers[static_cast<size_t>(marker % MAX_MARKERS)] = { stream.written.load(), beat, beatsPerSample };
+    stream.markersWritten.store(marker + 1, std::memory_order_release);
+
+    juce::AudioBuffer<float> block(dest.getArrayOfWritePointers(), dest.getNumChannels(), startSample, numSamples);
+    block.clear();
+
+    stream.scheduler.processNoteOffs(beat, endBeat, numSamples);
+    stream.scheduler.scheduleTrack(stream.track, beat, endBeat, numSamples);
+    stream.track.renderInserts(block, numSamples, beat, bpm);
+
+    stream.nextBeat = endBeat;
+    if (looping && endBeat >= end)
+        stream.nextBeat = start + std::fmod(endBeat - start, end - start);
+
+    return numSamples;
+}
+
+double TrackPrerenderer::beatAtConsumed(Stream& stream)
+{
+    // Only while something is buffered, so a marker covers `consumed`
+    const auto consumed = stream.consumed.load();
+    const auto numMarkers = stream.markersWritten.load(std::memory_order_acquire);
+    auto current = stream.currentMarker.load();
+
+    while (current + 1 < numMarkers && stream.markers[static_cast<size_t>((current + 1) % MAX_MARKERS)].start <= consumed)
+        ++current;
+
+    stream.currentMarker.store(current);
+
+    const auto& marker = stream.markers[static_cast<size_t>(current % MAX_MARKERS)];
+    return marker.beat + static_cast<double>(consumed - marker.start) * marker.beatsPerSample;
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Track.h"
+#include "ClipMidiScheduler.h"
+#include "TempoTrack.h"
+#include "TimeSignatureTrack.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * TrackPrerenderer - Renders tracks ahead of the playhead on worker threads
+ *
+ * Playback of a track nobody is playing live (not armed, not taking keyboard
+ * input, not keyed by a sidechain) is fully determined by its clips, so
+ * workers render its instrument and inserts up to LOOKAHEAD_SECONDS ahead,
+ * in CHUNK_SIZE blocks, into a single-producer ring per track. The audio
+ * callback then only copies a track's block out of its ring and runs the
+ * mix stage (Track::mixBlock), which stays live: fader, pan, sends and
+ * meters answer at once.
+ *
+ * Each stream keeps its own clock, following the tempo map and loop the way
+ * the transport does, and schedules its own clip MIDI. It is re-synced to
+ * the playhead - notes released, the ring emptied, notes sounding at the
+ * playhead restarted - when the two drift apart (seeks, loop and tempo
+ * changes) and when the track is edited (see Track::getRenderVersion()).
+ * An edited track then plays at the playhead until it has been left alone
+ * for SETTLE_SECONDS, so dragging a knob is heard as it moves.
+ *
+ * When a worker falls behind, the audio thread renders the missing part
+ * itself - unless a worker is rendering that track right now. The audio
+ * thread never waits for one: the rest of the block is silent, counted by
+ * getUnderrunCount(), and the stream re-syncs to the playhead next block.
+ * The first block after a re-sync is always left to the audio thread, so a
+ * seek doesn't race the workers for it.
+ *
+ * Threading: setup runs with the owner's track lock held and pauses the
+ * workers; syncTrack() and read() are called from the audio thread (read()
+ * also from mixer workers), once per track per block.
+ */
+class TrackPrerenderer
+{
+public:
+    static constexpr double LOOKAHEAD_SECONDS = 0.3;
+    static constexpr int CHUNK_SIZE = 1024;
+    static constexpr double SETTLE_SECONDS = 0.5;
+    static constexpr double SYNC_TOLERANCE_SECONDS = 0.005;
+
+    TrackPrerenderer(const TempoTrack& tempoTrack, const TimeSignatureTrack& timeSignatureTrack);
+    ~TrackPrerenderer();
+
+    //==========================================================================
+    // Setup (message thread, track lock held)
+
+    /** Keeps the workers away from every track while in scope */
+    class ScopedPause
+    {
+    public:
+        explicit ScopedPause(TrackPrerenderer& owner) : lock(owner.structureLock) {}
+
+    private:
+        const juce::ScopedWriteLock lock;
+    };
+
+    void prepare(double sampleRate);
+
+    /** One stream per track, in order; streams of tracks already known carry on */
+    void setTracks(const std::vector<Track*>& tracks);
+
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return static_cast<int>(workers.size()); }
+
+    //==========================================================================
+    // Audio thread
+
+    /** Transport state for this block, before the tracks are synced */
+    void beginBlock(bool loopEnabled, double loopStartBeat, double loopEndBeat);
+
+    /**
+     * Hand a track to the workers (renderAhead) or back to the caller, and
+     * re-sync its stream if it no longer lines up with blockStartBeat
+     */
+    void syncTrack(int index, bool renderAhead, double blockStartBeat, double bpm);
+
+    /** True if read() plays the track this block, MIDI included */
+    bool isRenderingAhead(int index) const;
+
+    /** Replace buffer with the track's next numSamples of Track::renderInserts() output */
+    void read(int index, juce::AudioBuffer<float>& buffer, int numSamples);
+
+    /** Blocks read() played partly or wholly silent because a worker held the track */
+    int getUnderrunCount() const { return underruns.load(); }
+    void resetUnderrunCount() { underruns.store(0); }
+
+    //==========================================================================
+    // Any thread
+
+    /** Throw away what is rendered ahead for a track (-1 for all) */
+    void invalidate(int index);
+
+private:
+    // Where a run of rendered samples sits on the timeline
+    struct Marker
+    {
+        juce::int64 start = 0;          // Stream sample
+        double beat = 0.0;
+        double beatsPerSample = 0.0;
+    };
+
+    static constexpr int MAX_MARKERS = 256;
+
+    struct Stream
+    {
+        Stream(Track& trackToRender, const TimeSignatureTrack& timeSignatures)
+            : track(trackToRender), scheduler(timeSignatures) {}
+
+        Track& track;
+        juce::CriticalSection lock;                     // Held while rendering
+
+        // Ring (written under the lock, read by the audio thread)
+        juce::AudioBuffer<float> ring;
+        int mask = 0;
+        std::atomic<juce::int64> written{0};
+        std::atomic<juce::int64> consumed{0};
+
+        std::array<Marker, MAX_MARKERS> markers;
+        std::atomic<juce::int64> markersWritten{0};
+        std::atomic<juce::int64> currentMarker{0};      // Covers `consumed`
+
+        // Renderer state (under the lock)
+        ClipMidiScheduler scheduler;
+        double nextBeat = 0.0;                          // Beat of the sample at `written`
+        juce::uint64 version = 0;
+        juce::AudioBuffer<float> chunk;
+
+        std::atomic<bool> renderingAhead{false};        // Owned by the audio thread
+        std::atomic<bool> invalidated{false};
+        std::atomic<bool> droppedOut{false};            // Off the playhead until re-synced
+        std::atomic<bool> firstBlockPending{false};     // Re-synced, not yet read
+        std::atomic<juce::uint32> settlesAt{0};         // Millisecond counter
+    };
+
+    class Worker;
+
+    const TempoTrack& tempoTrack;
+    const TimeSignatureTrack& timeSignatures;
+
+    juce::ReadWriteLock structureLock;                  // Workers read, setup writes
+    std::vector<std::unique_ptr<Stream>> streams;
+    std::vector<std::unique_ptr<Worker>> workers;
+    juce::WaitableEvent wake;
+    std::atomic<int> nextStream{0};
+    std::atomic<int> underruns{0};
+
+    double sampleRate = 44100.0;
+    int lookaheadSamples = 0;
+
+    std::atomic<bool> loopEnabled{false};
+    std::atomic<double> loopStart{0.0};
+    std::atomic<double> loopEnd{0.0};
+
+    void allocate(Stream& stream);
+    bool renderSomething();
+    bool renderAhead(Stream& stream);
+
+    // With the stream's lock held
+    void restartLocked(Stream& stream, double beat);
+    void stopLocked(Stream& stream);
+    // Renders up to maxSamples into dest at startSample, stopping at the
+    // loop end; returns how many
+    int renderLocked(Stream& stream, juce::AudioBuffer<float>& dest, int startSample, int maxSamples);
+    double beatAtConsumed(Stream& stream);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackPrerenderer)
+};
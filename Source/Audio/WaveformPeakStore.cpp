@@ -0,0 +1,182 @@
+#include "WaveformPeakStore.h"
+#include "AudioFileLoader.h"
+#include "SamplePool.h"
+
+namespace
+{
+    constexpr int SCAN_CHUNK_SIZE = 1 << 16;
+}
+
+WaveformPeakStore::WaveformPeakStore() = default;
+
+WaveformPeakStore::~WaveformPeakStore()
+{
+    pool.removeAllJobs(true, 10000);
+}
+
+//==============================================================================
+// Lookup
+
+WaveformPeakStore::PeaksPtr WaveformPeakStore::getPeaks(const AudioClip& clip)
+{
+    if (const auto& stream = clip.getStream())
+    {
+        const auto file = stream->getFile();
+        return getOrBuild(stream, [file] { return getSamplePool().getFilePeaks(file, [&file] { return scanFile(file); }); });
+    }
+
+    if (const auto& compact = clip.getCompactAudio())
+    {
+        const SamplePool::CompactPtr::weak_type weakCompact = compact;
+        return getOrBuild(compact, [weakCompact]() -> PeaksPtr
+        {
+            if (auto locked = weakCompact.lock())
+                return getSamplePool().getPeaks(locked);
+            return nullptr;
+        });
+    }
+
+    if (const auto& buffer = clip.getSharedBuffer(); buffer != nullptr && buffer->getNumSamples() > 0)
+    {
+        const SamplePool::BufferPtr::weak_type weakBuffer = buffer;
+        return getOrBuild(buffer, [weakBuffer]() -> PeaksPtr
+        {
+            // The clip may have let go of it while this was queued
+            if (auto locked = weakBuffer.lock())
+                return getSamplePool().getPeaks(locked);
+            return nullptr;
+        });
+    }
+
+    return nullptr;
+}
+
+WaveformPeakStore::PeaksPtr WaveformPeakStore::getOrBuild(const std::shared_ptr<const void>& source,
+                                                          std::function<PeaksPtr()> build)
+{
+    Key key = source;
+    {
+        const juce::ScopedLock sl(lock);
+
+        auto& entry = entries[key];
+        if (entry.built || entry.building)
+            return entry.peaks;
+
+        removeExpiredLocked();
+        entry.building = true;
+        ++numBuilding;
+    }
+
+    pool.addJob([this, key, build = std::move(build)]
+    {
+        auto peaks = build();
+
+        {
+            const juce::ScopedLock sl(lock);
+            if (auto it = entries.find(key); it != entries.end())
+            {
+                it->second.building = false;
+                it->second.built = true;
+                if (it->second.peaks == nullptr)
+                    it->second.peaks = std::move(peaks);
+            }
+            --numBuilding;
+        }
+
+        buildDone.signal();
+        sendChangeMessage();
+    });
+
+    return nullptr;
+}
+
+void WaveformPeakStore::update(const std::shared_ptr<const void>& source, PeaksPtr peaks)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        auto& entry = entries[Key(source)];
+        entry.peaks = std::move(peaks);
+        entry.built = true;
+    }
+
+    sendChangeMessage();
+}
+
+void WaveformPeakStore::removeExpiredLocked()
+{
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->first.expired() && !it->second.building)
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+}
+
+//==============================================================================
+// Building
+
+WaveformPeakStore::PeaksPtr WaveformPeakStore::scanFile(const juce::File& file)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(getAudioFileLoader().getFormatManager().createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+    WaveformPeaks::Builder builder(numChannels);
+    juce::AudioBuffer<float> chunk(numChannels, SCAN_CHUNK_SIZE);
+
+    for (juce::int64 done = 0; done < reader->lengthInSamples;)
+    {
+        const int n = static_cast<int>(juce::jmin<juce::int64>(SCAN_CHUNK_SIZE, reader->lengthInSamples - done));
+        reader->read(&chunk, 0, n, done, true, true);
+        builder.append(chunk.getArrayOfReadPointers(), n);
+        done += n;
+    }
+
+    return builder.getSnapshot();
+}
+
+//==============================================================================
+
+bool WaveformPeakStore::waitForBuilds(int timeoutMs)
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+
+    for (;;)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            if (numBuilding == 0)
+                return true;
+        }
+
+        const auto now = juce::Time::getMillisecondCounter();
+        if (now >= deadline)
+            return false;
+
+        buildDone.wait(static_cast<int>(deadline - now));
+    }
+}
+
+int WaveformPeakStore::getNumSources() const
+{
+    const juce::ScopedLock sl(lock);
+    return static_cast<int>(entries.size());
+}
+
+//==============================================================================
+// Global instance
+
+static std::unique_ptr<WaveformPeakStore> globalWaveformPeakStore;
+static juce::SpinLock globalPeakStoreLock;
+
+WaveformPeakStore& getWaveformPeakStore()
+{
+    juce::SpinLock::ScopedLockType lock(globalPeakStoreLock);
+
+    if (globalWaveformPeakStore == nullptr)
+        globalWaveformPeakStore = std::make_unique<WaveformPeakStore>();
+
+    return *globalWaveformPeakStore;
+}
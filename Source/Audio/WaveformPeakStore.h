@@ -0,0 +1,74 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include "AudioClip.h"
+#include "WaveformPeaks.h"
+#include <map>
+#include <memory>
+
+/**
+ * WaveformPeakStore - One WaveformPeaks pyramid per audio source, shared by every view
+ *
+ * A source is a clip's pooled buffer, compact audio or stream, so duplicated
+ * and split clips (and every view of them) draw from the same pyramid.
+ * Pyramids are built on a background thread: pooled audio through
+ * SamplePool::getPeaks(), streamed files by reading the file in chunks, both
+ * cached on disk by the pool. Listeners are told on the message thread when one is ready.
+ *
+ * Sources that are still growing, such as a recording, publish snapshots
+ * from a WaveformPeaks::Builder with update().
+ */
+class WaveformPeakStore : public juce::ChangeBroadcaster
+{
+public:
+    using PeaksPtr = std::shared_ptr<const WaveformPeaks>;
+
+    WaveformPeakStore();
+    ~WaveformPeakStore() override;
+
+    /**
+     * The pyramid for a clip's audio (message thread)
+     * @return nullptr while it is first being built, which starts on the first call
+     */
+    PeaksPtr getPeaks(const AudioClip& clip);
+
+    /** Replace a source's pyramid, e.g. with a newer snapshot of a recording */
+    void update(const std::shared_ptr<const void>& source, PeaksPtr peaks);
+
+    /** Wait until no pyramid is being built; false on timeout */
+    bool waitForBuilds(int timeoutMs);
+
+    /** Sources with a pyramid or a build under way */
+    int getNumSources() const;
+
+private:
+    struct Entry
+    {
+        PeaksPtr peaks;
+        bool building = false;
+        bool built = false;     // Even if it failed, so unreadable sources aren't retried on every paint
+    };
+
+    using Key = std::weak_ptr<const void>;
+
+    juce::ThreadPool pool { juce::ThreadPoolOptions{}.withThreadName("Waveform Peaks")
+                                                     .withNumberOfThreads(1) };
+
+    mutable juce::CriticalSection lock;
+    std::map<Key, Entry, std::owner_less<Key>> entries;
+    int numBuilding = 0;
+    juce::WaitableEvent buildDone;
+
+    PeaksPtr getOrBuild(const std::shared_ptr<const void>& source, std::function<PeaksPtr()> build);
+    void removeExpiredLocked();
+
+    static PeaksPtr scanFile(const juce::File& file);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPeakStore)
+};
+
+/**
+ * Global WaveformPeakStore for shared use
+ */
+WaveformPeakStore& getWaveformPeakStore();
@@ -0,0 +1,236 @@
+#include "WaveformPeaks.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr int PEAKS_MAGIC = 0x50574650; // "PFWP"
+    constexpr int PEAKS_VERSION = 1;
+
+    WaveformPeaks::Point merge(const WaveformPeaks::Point& a, const WaveformPeaks::Point& b)
+    {
+        return { std::min(a.min, b.min), std::max(a.max, b.max),
+                 std::sqrt(0.5f * (a.rms * a.rms + b.rms * b.rms)) };
+    }
+}
+
+//==============================================================================
+// Building
+
+std::shared_ptr<const WaveformPeaks> WaveformPeaks::build(const juce::AudioBuffer<float>& buffer)
+{
+    Builder builder(buffer.getNumChannels());
+    builder.append(buffer.getArrayOfReadPointers(), buffer.getNumSamples());
+    return builder.getSnapshot();
+}
+
+WaveformPeaks::Builder::Builder(int channels)
+    : numChannels(juce::jmax(0, channels)),
+      base(static_cast<size_t>(numChannels)),
+      partial(static_cast<size_t>(numChannels))
+{
+}
+
+void WaveformPeaks::Builder::append(const float* const* channels, int numFrames)
+{
+    for (int done = 0; done < numFrames;)
+    {
+        const int n = std::min(BASE_REDUCTION - partialFrames, numFrames - done);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* data = channels[ch] + done;
+            auto& acc = partial[static_cast<size_t>(ch)];
+
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data, n);
+
+            float sumOfSquares = 0.0f;
+            for (int i = 0; i < n; ++i)
+                sumOfSquares += data[i] * data[i];
+
+            acc.min = partialFrames == 0 ? range.getStart() : std::min(acc.min, range.getStart());
+            acc.max = partialFrames == 0 ? range.getEnd() : std::max(acc.max, range.getEnd());
+            acc.sumOfSquares = (partialFrames == 0 ? 0.0f : acc.sumOfSquares) + sumOfSquares;
+        }
+
+        partialFrames += n;
+        lengthInFrames += n;
+        done += n;
+
+        if (partialFrames == BASE_REDUCTION)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto& acc = partial[static_cast<size_t>(ch)];
+                base[static_cast<size_t>(ch)].push_back({ acc.min, acc.max,
+                                                          std::sqrt(acc.sumOfSquares / BASE_REDUCTION) });
+            }
+            partialFrames = 0;
+        }
+    }
+}
+
+std::shared_ptr<const WaveformPeaks> WaveformPeaks::Builder::getSnapshot() const
+{
+    auto peaks = std::make_shared<WaveformPeaks>();
+    peaks->numChannels = numChannels;
+    peaks->lengthInFrames = lengthInFrames;
+
+    const int complete = numChannels > 0 ? static_cast<int>(base[0].size()) : 0;
+    const int numPoints = complete + (partialFrames > 0 ? 1 : 0);
+
+    auto& level = peaks->levels.emplace_back();
+    level.reserve(static_cast<size_t>(numChannels * numPoints));
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto& points = base[static_cast<size_t>(ch)];
+        level.insert(level.end(), points.begin(), points.end());
+
+        if (partialFrames > 0)
+        {
+            const auto& acc = partial[static_cast<size_t>(ch)];
+            level.push_back({ acc.min, acc.max,
+                              std::sqrt(acc.sumOfSquares / static_cast<float>(partialFrames)) });
+        }
+    }
+
+    peaks->buildLevelsAbove();
+    return peaks;
+}
+
+void WaveformPeaks::buildLevelsAbove()
+{
+    while (getNumPoints(getNumLevels() - 1) > 1)
+    {
+        const int below = getNumPoints(getNumLevels() - 1);
+        const int numPoints = (below + 1) / 2;
+
+        std::vector<Point> level(static_cast<size_t>(numChannels * numPoints));
+        const auto& source = levels.back();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const Point* in = source.data() + ch * below;
+            Point* out = level.data() + ch * numPoints;
+
+            for (int p = 0; p < numPoints; ++p)
+                out[p] = 2 * p + 1 < below ? merge(in[2 * p], in[2 * p + 1]) : in[2 * p];
+        }
+
+        levels.push_back(std::move(level));
+    }
+}
+
+//==============================================================================
+// Access
+
+int WaveformPeaks::getNumPoints(int level) const
+{
+    if (level < 0 || level >= getNumLevels() || numChannels == 0)
+        return 0;
+
+    return static_cast<int>(levels[static_cast<size_t>(level)].size()) / numChannels;
+}
+
+const WaveformPeaks::Point* WaveformPeaks::getPoints(int level, int channel) const
+{
+    if (level < 0 || level >= getNumLevels() || channel < 0 || channel >= numChannels)
+        return nullptr;
+
+    return levels[static_cast<size_t>(level)].data() + channel * getNumPoints(level);
+}
+
+int WaveformPeaks::getLevelFor(double framesPerPixel) const
+{
+    int level = 0;
+    while (level + 1 < getNumLevels() && static_cast<double>(getReduction(level + 1)) <= framesPerPixel)
+        ++level;
+    return level;
+}
+
+WaveformPeaks::Point WaveformPeaks::getRange(int level, int channel, juce::int64 startFrame, juce::int64 endFrame) const
+{
+    const Point* points = getPoints(level, channel);
+    const int numPoints = getNumPoints(level);
+    if (points == nullptr || numPoints == 0)
+        return {};
+
+    const auto reduction = getReduction(level);
+    const auto first = juce::jlimit<juce::int64>(0, numPoints - 1, startFrame / reduction);
+    const auto last = juce::jlimit<juce::int64>(first + 1, numPoints, (endFrame + reduction - 1) / reduction);
+
+    Point result { points[first].min, points[first].max, 0.0f };
+    float sumOfSquares = 0.0f;
+
+    for (auto p = first; p < last; ++p)
+    {
+        result.min = std::min(result.min, points[p].min);
+        result.max = std::max(result.max, points[p].max);
+        sumOfSquares += points[p].rms * points[p].rms;
+    }
+
+    result.rms = std::sqrt(sumOfSquares / static_cast<float>(last - first));
+    return result;
+}
+
+juce::int64 WaveformPeaks::getBytes() const
+{
+    juce::int64 bytes = 0;
+    for (const auto& level : levels)
+        bytes += static_cast<juce::int64>(level.size() * sizeof(Point));
+    return bytes;
+}
+
+//==============================================================================
+// Persistence
+
+bool WaveformPeaks::writeTo(juce::OutputStream& out) const
+{
+    out.writeInt(PEAKS_MAGIC);
+    out.writeInt(PEAKS_VERSION);
+    out.writeInt(numChannels);
+    out.writeInt64(lengthInFrames);
+    out.writeInt(getNumLevels());
+
+    for (const auto& level : levels)
+    {
+        out.writeInt(static_cast<int>(level.size()));
+        if (!out.write(level.data(), level.size() * sizeof(Point)))
+            return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const WaveformPeaks> WaveformPeaks::readFrom(juce::InputStream& in)
+{
+    if (in.readInt() != PEAKS_MAGIC || in.readInt() != PEAKS_VERSION)
+        return nullptr;
+
+    auto peaks = std::make_shared<WaveformPeaks>();
+    peaks->numChannels = in.readInt();
+    peaks->lengthInFrames = in.readInt64();
+    const int numLevels = in.readInt();
+
+    if (peaks->numChannels <= 0 || peaks->lengthInFrames <= 0 || numLevels <= 0 || numLevels > 64)
+        return nullptr;
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        const int size = in.readInt();
+        if (size <= 0 || size % peaks->numChannels != 0)
+            return nullptr;
+
+        auto& level = peaks->levels.emplace_back(static_cast<size_t>(size));
+        const auto bytes = static_cast<int>(level.size() * sizeof(Point));
+        if (in.read(level.data(), bytes) != bytes)
+            return nullptr;
+    }
+
+    // The base level has to cover the whole length
+    if (peaks->getNumPoints(0) != (peaks->lengthInFrames + BASE_REDUCTION - 1) / BASE_REDUCTION)
+        return nullptr;
+
+    return peaks;
+}
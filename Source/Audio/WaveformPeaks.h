@@ -0,0 +1,97 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+/**
+ * WaveformPeaks - Multi-resolution min/max/RMS summary of a block of audio
+ *
+ * Level 0 holds one point per BASE_REDUCTION frames; each level above halves
+ * the resolution of the one below, down to a single point. Drawing picks the
+ * coarsest level that still has a point per pixel, so its cost depends on the
+ * width drawn rather than the length of the audio.
+ *
+ * Built once per decoded buffer and kept by the SamplePool (in RAM and beside
+ * the decoded data in the disk cache), and shared between views through the
+ * WaveformPeakStore. Immutable once built; audio that is still arriving (a
+ * streamed file being scanned, a recording) goes through a Builder, which
+ * hands out snapshots.
+ */
+class WaveformPeaks
+{
+public:
+    static constexpr int BASE_REDUCTION = 256;
+
+    struct Point
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+    };
+
+    /** Summarise every channel of buffer */
+    static std::shared_ptr<const WaveformPeaks> build(const juce::AudioBuffer<float>& buffer);
+
+    /**
+     * Builds peaks from audio appended a block at a time. Each frame is looked
+     * at once; a snapshot only copies the base level and merges the levels above.
+     */
+    class Builder
+    {
+    public:
+        explicit Builder(int numChannels);
+
+        void append(const float* const* channels, int numFrames);
+        juce::int64 getLengthInFrames() const { return lengthInFrames; }
+
+        /** Everything appended so far, including a partly filled last point */
+        std::shared_ptr<const WaveformPeaks> getSnapshot() const;
+
+    private:
+        struct Accumulator
+        {
+            float min = 0.0f, max = 0.0f, sumOfSquares = 0.0f;
+        };
+
+        int numChannels;
+        juce::int64 lengthInFrames = 0;
+        int partialFrames = 0;                  // Frames in the point being filled
+        std::vector<std::vector<Point>> base;   // Complete level 0 points, per channel
+        std::vector<Accumulator> partial;       // Per channel
+    };
+
+    int getNumChannels() const { return numChannels; }
+    juce::int64 getLengthInFrames() const { return lengthInFrames; }
+    int getNumLevels() const { return static_cast<int>(levels.size()); }
+
+    /** Frames summarised by each point of a level */
+    static juce::int64 getReduction(int level) { return static_cast<juce::int64>(BASE_REDUCTION) << level; }
+
+    /** Coarsest level with at least one point per framesPerPixel frames */
+    int getLevelFor(double framesPerPixel) const;
+
+    int getNumPoints(int level) const;
+    const Point* getPoints(int level, int channel) const;
+
+    /** Merge of the points covering frames [startFrame, endFrame) of a channel at a level */
+    Point getRange(int level, int channel, juce::int64 startFrame, juce::int64 endFrame) const;
+
+    //==========================================================================
+    // Persistence (the SamplePool disk cache)
+    bool writeTo(juce::OutputStream& out) const;
+    static std::shared_ptr<const WaveformPeaks> readFrom(juce::InputStream& in);
+
+    /** Approximate heap use */
+    juce::int64 getBytes() const;
+
+private:
+    int numChannels = 0;
+    juce::int64 lengthInFrames = 0;
+
+    // levels[level][channel * numPoints(level) + point]
+    std::vector<std::vector<Point>> levels;
+
+    void buildLevelsAbove();
+};
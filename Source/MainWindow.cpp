@@ -16,15 +16,17 @@ MainContentComponent::MainContentComponent()
     ThemeManager::getInstance().addListener(this);
 
     // Initialize audio device manager
-    auto result = deviceManager.initialiseWithDefaultDevices(0, 2); // 0 inputs, 2 outputs (stereo)
+    auto result = deviceManager.initialiseWithDefaultDevices(2, 2); // Stereo in (for recording) and out
     if (result.isNotEmpty())
     {
         // Audio device initialization failed
         juce::ignoreUnused(result);
     }
 
-    // Set up audio playback
+    // Set up audio playback. The input recorder goes first, so the engine's
+    // block sees the inputs of the same callback.
     audioSourcePlayer.setSource(&audioEngine);
+    deviceManager.addAudioCallback(&audioEngine.getInputRecorder());
     deviceManager.addAudioCallback(&audioSourcePlayer);
 
     // Create project manager
@@ -163,6 +165,7 @@ MainContentComponent::~MainContentComponent()
         projectManager->removeListener(this);
     removeKeyListener(this);
     deviceManager.removeAudioCallback(&audioSourcePlayer);
+    deviceManager.removeAudioCallback(&audioEngine.getInputRecorder());
     audioSourcePlayer.setSource(nullptr);
     setLookAndFeel(nullptr);
 }
@@ -21,35 +21,36 @@ void AudioExporter::exportAsync(const juce::File& outputFile,
         return;
     }
 
+    // The project is copied here, on the message thread; only the copy is rendered
+    auto renderer = std::make_shared<OfflineRenderer>(audioEngine, settings.sampleRate, settings.blockSize);
+    if (!renderer->getMissingPlugins().isEmpty())
+    {
+        if (onComplete)
+            onComplete(false, "Couldn't load plugins for export: "
+                                  + renderer->getMissingPlugins().joinIntoString(", "));
+        return;
+    }
+
     exporting.store(true);
     shouldCancel.store(false);
 
     // Run export on background thread
-    juce::Thread::launch([this, outputFile, format, settings, onProgress, onComplete]()
+    juce::Thread::launch([this, renderer, outputFile, format, settings, onProgress, onComplete]() mutable
     {
-        bool success = false;
+        bool success = exportRendered(*renderer, outputFile, format, settings, onProgress);
         juce::String errorMessage;
 
-        if (format == Format::WAV)
-        {
-            success = exportToWav(outputFile, settings, onProgress);
-            if (!success && !shouldCancel.load())
-                errorMessage = "Failed to write WAV file";
-        }
-        else if (format == Format::MP3)
-        {
-            success = exportToMp3(outputFile, settings, onProgress);
-            if (!success && !shouldCancel.load())
-                errorMessage = "Failed to write MP3 file";
-        }
+        if (!success && !shouldCancel.load())
+            errorMessage = format == Format::WAV ? "Failed to write WAV file" : "Failed to write MP3 file";
 
         if (shouldCancel.load())
             errorMessage = "Export cancelled";
 
         exporting.store(false);
 
-        // Call completion on message thread
-        juce::MessageManager::callAsync([onComplete, success, errorMessage]()
+        // Call completion on message thread, which also gets to delete the
+        // copy (plugins expect to be destroyed there)
+        juce::MessageManager::callAsync([onComplete, success, errorMessage, renderer = std::move(renderer)]()
         {
             if (onComplete)
                 onComplete(success && errorMessage.isEmpty(), errorMessage);
@@ -69,29 +70,35 @@ bool AudioExporter::exportToWav(const juce::File& outputFile,
                                  const ExportSettings& settings,
                                  ProgressCallback onProgress)
 {
-    // Render audio to buffer
-    juce::AudioBuffer<float> buffer;
-    if (!renderToBuffer(buffer, settings, onProgress))
-        return false;
-
-    if (shouldCancel.load())
+    OfflineRenderer renderer(audioEngine, settings.sampleRate, settings.blockSize);
+    if (!renderer.getMissingPlugins().isEmpty())
         return false;
 
-    // Normalize if requested
-    if (settings.normalizeOutput)
-        normalizeBuffer(buffer);
-
-    // Write to file
-    return writeWavFile(outputFile, buffer, settings.sampleRate, settings.bitDepth);
+    shouldCancel.store(false);
+    return exportRendered(renderer, outputFile, Format::WAV, settings, onProgress);
 }
 
 bool AudioExporter::exportToMp3(const juce::File& outputFile,
                                  const ExportSettings& settings,
                                  ProgressCallback onProgress)
+{
+    OfflineRenderer renderer(audioEngine, settings.sampleRate, settings.blockSize);
+    if (!renderer.getMissingPlugins().isEmpty())
+        return false;
+
+    shouldCancel.store(false);
+    return exportRendered(renderer, outputFile, Format::MP3, settings, onProgress);
+}
+
+bool AudioExporter::exportRendered(OfflineRenderer& renderer,
+                                   const juce::File& outputFile,
+                                   Format format,
+                                   const ExportSettings& settings,
+                                   ProgressCallback onProgress)
 {
     // Render audio to buffer
     juce::AudioBuffer<float> buffer;
-    if (!renderToBuffer(buffer, settings, onProgress))
+    if (!renderToBuffer(renderer, buffer, settings, onProgress))
         return false;
 
     if (shouldCancel.load())
@@ -102,84 +109,36 @@ bool AudioExporter::exportToMp3(const juce::File& outputFile,
         normalizeBuffer(buffer);
 
     // Write to file
-    return writeMp3File(outputFile, buffer, settings.sampleRate, settings.mp3Bitrate);
+    if (format == Format::MP3)
+        return writeMp3File(outputFile, buffer, settings.sampleRate, settings.mp3Bitrate);
+
+    return writeWavFile(outputFile, buffer, settings.sampleRate, settings.bitDepth);
 }
 
 //==============================================================================
 // Offline rendering
 
-bool AudioExporter::renderToBuffer(juce::AudioBuffer<float>& buffer,
+bool AudioExporter::renderToBuffer(OfflineRenderer& renderer,
+                                    juce::AudioBuffer<float>& buffer,
                                     const ExportSettings& settings,
                                     ProgressCallback onProgress)
 {
-    const double sampleRate = static_cast<double>(settings.sampleRate);
-    const int blockSize = 512;
-
-    // Calculate total samples
+    // Bars as clips count them (4 beats); the tempo map sets how long they last
     const double startBeats = settings.startBar * 4.0;
     const double endBeats = settings.endBar * 4.0;
-    const double totalBeats = endBeats - startBeats;
-
-    // Convert beats to samples using BPM
-    const double bpm = audioEngine.getBpm();
-    const double secondsPerBeat = 60.0 / bpm;
-    const double totalSeconds = totalBeats * secondsPerBeat;
-    const int totalSamples = static_cast<int>(std::ceil(totalSeconds * sampleRate));
-
-    // Allocate buffer
-    buffer.setSize(2, totalSamples);
-    buffer.clear();
-
-    // Prepare audio engine for offline rendering
-    // Note: We need to save and restore the engine state
-    const bool wasPlaying = audioEngine.isPlaying();
-    const double originalPosition = audioEngine.getPositionInBeats();
-
-    audioEngine.stop();
-    audioEngine.setPositionInBeats(startBeats);
-
-    // Process audio in blocks
-    int samplesProcessed = 0;
-    juce::AudioBuffer<float> blockBuffer(2, blockSize);
-    juce::AudioSourceChannelInfo channelInfo(&blockBuffer, 0, blockSize);
-
-    while (samplesProcessed < totalSamples && !shouldCancel.load())
-    {
-        const int samplesThisBlock = std::min(blockSize, totalSamples - samplesProcessed);
-        channelInfo.numSamples = samplesThisBlock;
-
-        blockBuffer.clear();
-
-        // Simulate playback
-        audioEngine.setPlaying(true);
-        audioEngine.getNextAudioBlock(channelInfo);
-        audioEngine.setPlaying(false);
 
-        // Copy to output buffer
-        for (int ch = 0; ch < 2; ++ch)
+    return renderer.render(buffer, startBeats, endBeats,
+        [this] { return shouldCancel.load(); },
+        [onProgress](float progress)
         {
-            buffer.copyFrom(ch, samplesProcessed, blockBuffer, ch, 0, samplesThisBlock);
-        }
-
-        samplesProcessed += samplesThisBlock;
-
-        // Report progress
-        if (onProgress)
-        {
-            float progress = static_cast<float>(samplesProcessed) / static_cast<float>(totalSamples);
-            juce::MessageManager::callAsync([onProgress, progress]()
+            if (onProgress)
             {
-                onProgress(progress * 0.9f); // Reserve 10% for file writing
-            });
-        }
-    }
-
-    // Restore engine state
-    audioEngine.setPositionInBeats(originalPosition);
-    if (wasPlaying)
-        audioEngine.play();
-
-    return !shouldCancel.load();
+                juce::MessageManager::callAsync([onProgress, progress]()
+                {
+                    onProgress(progress * 0.9f); // Reserve 10% for file writing
+                });
+            }
+        });
 }
 
 //==============================================================================
@@ -318,6 +277,13 @@ double AudioExporter::calculateProjectLengthBars(AudioEngine& engine)
             {
                 maxEndBar = std::max(maxEndBar, clip->getEndBar());
             }
+
+            // Audio clips that aren't warped last as long in seconds whatever the tempo
+            for (const auto& clip : track->getAudioClips())
+            {
+                const double bpm = engine.getTempoTrack().getTempoAtBeat(clip->getStartBeat());
+                maxEndBar = std::max(maxEndBar, (clip->getStartBeat() + clip->getDurationInBeats(bpm)) / 4.0);
+            }
         }
     }
 
@@ -3,15 +3,19 @@
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_core/juce_core.h>
 #include "../Audio/AudioEngine.h"
+#include "../Audio/OfflineRenderer.h"
 #include <functional>
 
 /**
  * AudioExporter - Handles offline rendering and audio file export
  *
  * Supports:
- * - WAV export (44.1kHz, 16/24/32-bit)
+ * - WAV export (any rate, 16/24/32-bit)
  * - MP3 export (via LAME encoder, if available)
  *
+ * Exports render a copy of the project (see OfflineRenderer), made when the
+ * export starts; playback carries on undisturbed meanwhile.
+ *
  * Usage:
  *   AudioExporter exporter(audioEngine);
  *   exporter.exportToWav(outputFile, 0.0, 16.0, [](float) {}, [](bool) {});
@@ -29,6 +33,7 @@ public:
         int sampleRate = 44100;
         int bitDepth = 16;        // 16, 24, or 32
         int mp3Bitrate = 192;     // kbps (128, 192, 256, 320)
+        int blockSize = 1024;     // Render block size (samples)
         double startBar = 0.0;
         double endBar = 16.0;     // Project length in bars
         bool normalizeOutput = false;
@@ -50,7 +55,7 @@ public:
     using CompletionCallback = std::function<void(bool success, const juce::String& errorMessage)>;
 
     //==========================================================================
-    // Export methods (async, runs on background thread)
+    // Export methods (call on the message thread; renders on a background thread)
     void exportAsync(const juce::File& outputFile,
                      Format format,
                      const ExportSettings& settings,
@@ -62,7 +67,7 @@ public:
     bool isExporting() const { return exporting.load(); }
 
     //==========================================================================
-    // Synchronous export (blocks until complete)
+    // Synchronous export (message thread, blocks until complete)
     bool exportToWav(const juce::File& outputFile,
                      const ExportSettings& settings,
                      ProgressCallback onProgress = nullptr);
@@ -82,8 +87,16 @@ private:
     std::atomic<bool> exporting{false};
     std::atomic<bool> shouldCancel{false};
 
+    // Render the export range of renderer's copy and write it out (any thread)
+    bool exportRendered(OfflineRenderer& renderer,
+                        const juce::File& outputFile,
+                        Format format,
+                        const ExportSettings& settings,
+                        ProgressCallback onProgress);
+
     // Perform offline render to buffer
-    bool renderToBuffer(juce::AudioBuffer<float>& buffer,
+    bool renderToBuffer(OfflineRenderer& renderer,
+                        juce::AudioBuffer<float>& buffer,
                         const ExportSettings& settings,
                         ProgressCallback onProgress);
 
@@ -1,5 +1,7 @@
 #include "PreferencesManager.h"
 #include "../UI/LookAndFeel.h"
+#include "../Audio/AudioFileLoader.h"
+#include "../Audio/SamplePool.h"
 
 PreferencesManager::PreferencesManager()
 {
@@ -17,6 +19,10 @@ PreferencesManager::PreferencesManager()
     ThemeManager::getInstance().setTheme(
         savedTheme == Theme::Dark ? ThemeManager::Theme::Dark : ThemeManager::Theme::Light
     );
+
+    getSamplePool().setMemoryBudget((juce::int64)getSamplePoolBudgetMB() * 1024 * 1024);
+    getSamplePool().setDiskCacheBudget((juce::int64)getSampleCacheDiskBudgetMB() * 1024 * 1024);
+    applyClipStorage(getClipStorage());
 }
 
 PreferencesManager::~PreferencesManager()
@@ -71,6 +77,53 @@ void PreferencesManager::setBufferSize(int size)
     notifyAudioSettingsChanged();
 }
 
+int PreferencesManager::getSamplePoolBudgetMB() const
+{
+    return getProps()->getIntValue(KEY_SAMPLE_POOL_BUDGET, DEFAULT_SAMPLE_POOL_BUDGET_MB);
+}
+
+void PreferencesManager::setSamplePoolBudgetMB(int megabytes)
+{
+    megabytes = juce::jlimit(64, 65536, megabytes);
+    getProps()->setValue(KEY_SAMPLE_POOL_BUDGET, megabytes);
+    getSamplePool().setMemoryBudget((juce::int64)megabytes * 1024 * 1024);
+    notifyAudioSettingsChanged();
+}
+
+int PreferencesManager::getSampleCacheDiskBudgetMB() const
+{
+    return getProps()->getIntValue(KEY_SAMPLE_CACHE_DISK_BUDGET, DEFAULT_SAMPLE_CACHE_DISK_BUDGET_MB);
+}
+
+void PreferencesManager::setSampleCacheDiskBudgetMB(int megabytes)
+{
+    megabytes = juce::jlimit(0, 1024 * 1024, megabytes);
+    getProps()->setValue(KEY_SAMPLE_CACHE_DISK_BUDGET, megabytes);
+    getSamplePool().setDiskCacheBudget((juce::int64)megabytes * 1024 * 1024);
+    notifyAudioSettingsChanged();
+}
+
+PreferencesManager::ClipStorage PreferencesManager::getClipStorage() const
+{
+    return static_cast<ClipStorage>(juce::jlimit(0, 2, getProps()->getIntValue(KEY_CLIP_STORAGE,
+                                                                                static_cast<int>(ClipStorage::Float))));
+}
+
+void PreferencesManager::setClipStorage(ClipStorage storage)
+{
+    getProps()->setValue(KEY_CLIP_STORAGE, static_cast<int>(storage));
+    applyClipStorage(storage);
+    notifyAudioSettingsChanged();
+}
+
+void PreferencesManager::applyClipStorage(ClipStorage storage)
+{
+    using Storage = AudioFileLoader::ClipStorage;
+    getAudioFileLoader().setClipStorage(storage == ClipStorage::Packed   ? Storage::Packed
+                                      : storage == ClipStorage::Lossless ? Storage::Lossless
+                                                                         : Storage::Float);
+}
+
 //==============================================================================
 // Project Settings
 
@@ -300,6 +353,12 @@ void PreferencesManager::resetToDefaults()
     // Set defaults explicitly
     props->setValue(KEY_SAMPLE_RATE, DEFAULT_SAMPLE_RATE);
     props->setValue(KEY_BUFFER_SIZE, DEFAULT_BUFFER_SIZE);
+    props->setValue(KEY_SAMPLE_POOL_BUDGET, DEFAULT_SAMPLE_POOL_BUDGET_MB);
+    getSamplePool().setMemoryBudget((juce::int64)DEFAULT_SAMPLE_POOL_BUDGET_MB * 1024 * 1024);
+    props->setValue(KEY_SAMPLE_CACHE_DISK_BUDGET, DEFAULT_SAMPLE_CACHE_DISK_BUDGET_MB);
+    getSamplePool().setDiskCacheBudget((juce::int64)DEFAULT_SAMPLE_CACHE_DISK_BUDGET_MB * 1024 * 1024);
+    props->setValue(KEY_CLIP_STORAGE, static_cast<int>(ClipStorage::Float));
+    applyClipStorage(ClipStorage::Float);
     props->setValue(KEY_DEFAULT_BPM, DEFAULT_BPM);
     props->setValue(KEY_DEFAULT_TIME_SIG_NUM, DEFAULT_TIME_SIG_NUM);
     props->setValue(KEY_DEFAULT_TIME_SIG_DENOM, DEFAULT_TIME_SIG_DENOM);
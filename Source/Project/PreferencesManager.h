@@ -33,6 +33,19 @@ public:
     int getBufferSize() const;
     void setBufferSize(int size);
 
+    // RAM budget for decoded samples shared via the SamplePool
+    int getSamplePoolBudgetMB() const;
+    void setSamplePoolBudgetMB(int megabytes);
+
+    // Disk space for decoded audio and waveform peaks kept between sessions
+    int getSampleCacheDiskBudgetMB() const;
+    void setSampleCacheDiskBudgetMB(int megabytes);
+
+    // How imported clips hold their audio in RAM (applies to clips loaded afterwards)
+    enum class ClipStorage { Float, Packed, Lossless };
+    ClipStorage getClipStorage() const;
+    void setClipStorage(ClipStorage storage);
+
     //==========================================================================
     // Project Settings
 
@@ -120,6 +133,9 @@ private:
     static constexpr const char* KEY_AUDIO_DEVICE = "audioDevice";
     static constexpr const char* KEY_SAMPLE_RATE = "sampleRate";
     static constexpr const char* KEY_BUFFER_SIZE = "bufferSize";
+    static constexpr const char* KEY_SAMPLE_POOL_BUDGET = "samplePoolBudgetMB";
+    static constexpr const char* KEY_SAMPLE_CACHE_DISK_BUDGET = "sampleCacheDiskBudgetMB";
+    static constexpr const char* KEY_CLIP_STORAGE = "clipStorage";
 
     static constexpr const char* KEY_DEFAULT_BPM = "defaultBpm";
     static constexpr const char* KEY_DEFAULT_TIME_SIG_NUM = "defaultTimeSigNum";
@@ -145,12 +161,16 @@ private:
     // Defaults
     static constexpr double DEFAULT_SAMPLE_RATE = 44100.0;
     static constexpr int DEFAULT_BUFFER_SIZE = 512;
+    static constexpr int DEFAULT_SAMPLE_POOL_BUDGET_MB = 2048;
+    static constexpr int DEFAULT_SAMPLE_CACHE_DISK_BUDGET_MB = 8192;
     static constexpr double DEFAULT_BPM = 120.0;
     static constexpr int DEFAULT_TIME_SIG_NUM = 4;
     static constexpr int DEFAULT_TIME_SIG_DENOM = 4;
     static constexpr int DEFAULT_AUTOSAVE_INTERVAL = 2;
     static constexpr int DEFAULT_METER_REFRESH_RATE = 30;
 
+    static void applyClipStorage(ClipStorage storage);
+
     void notifyPreferencesChanged();
     void notifyAudioSettingsChanged();
     void notifyMidiSettingsChanged();
@@ -1,5 +1,51 @@
 #include "ProjectSerializer.h"
 #include "../Audio/AutomationLane.h"
+#include "../Audio/Effects/EffectFactory.h"
+#include "../Audio/Effects/ConvolutionReverbEffect.h"
+#include "../Audio/Effects/CabinetEffect.h"
+#include "../Audio/Effects/SidechainCompressorEffect.h"
+
+namespace
+{
+    // Buses go back into the slots they were saved from, since sends and
+    // routing refer to them by slot. The engine's slots are all free here and
+    // fill in order, so gaps below a saved bus are held by placeholders until
+    // every bus is in place.
+    template <typename AddBus, typename LoadBus, typename RemoveBus>
+    void restoreBusSlots(const juce::Array<juce::var>& buses, int maxSlots,
+                         AddBus addBus, LoadBus loadBus, RemoveBus removeBus)
+    {
+        std::vector<juce::var> saved(static_cast<size_t>(maxSlots));
+        int highestSlot = -1;
+
+        for (const auto& busVar : buses)
+        {
+            const int slot = static_cast<int>(busVar.getProperty("slot", -1));
+            if (slot >= 0 && slot < maxSlots)
+            {
+                saved[static_cast<size_t>(slot)] = busVar;
+                highestSlot = juce::jmax(highestSlot, slot);
+            }
+        }
+
+        std::vector<int> placeholders;
+        for (int slot = 0; slot <= highestSlot; ++slot)
+        {
+            const auto& busVar = saved[static_cast<size_t>(slot)];
+            const int added = addBus(busVar.getProperty("name", juce::String()).toString());
+            if (added < 0)
+                break;
+
+            if (busVar.isObject())
+                loadBus(busVar, added);
+            else
+                placeholders.push_back(added);
+        }
+
+        for (int slot : placeholders)
+            removeBus(slot);
+    }
+}
 
 //==============================================================================
 // Serialize project to JSON string
@@ -20,6 +66,8 @@ juce::String ProjectSerializer::serialize(const ProjectData& project)
 
     obj->setProperty("tracks", project.tracks);
     obj->setProperty("markers", project.markers);
+    obj->setProperty("returnBuses", project.returnBuses);
+    obj->setProperty("groupBuses", project.groupBuses);
 
     juce::var projectVar(obj);
     return juce::JSON::toString(projectVar, true); // Pretty print
@@ -47,6 +95,24 @@ juce::String ProjectSerializer::serializeFromEngine(AudioEngine& engine,
         }
     }
 
+    // Return buses (by slot, which track sends refer to)
+    for (int slot = 0; slot < AudioEngine::MAX_RETURN_BUSES; ++slot)
+    {
+        if (auto* bus = engine.getReturnBus(slot))
+        {
+            project.returnBuses.add(serializeReturnBus(*bus, slot));
+        }
+    }
+
+    // Group buses (by slot, which track and group outputs refer to)
+    for (int slot = 0; slot < AudioEngine::MAX_GROUP_BUSES; ++slot)
+    {
+        if (auto* group = engine.getGroupBus(slot))
+        {
+            project.groupBuses.add(serializeGroupBus(*group, slot));
+        }
+    }
+
     return serialize(project);
 }
 
@@ -108,6 +174,34 @@ bool ProjectSerializer::deserialize(const juce::String& jsonString, ProjectData&
         }
     }
 
+    // Return buses
+    outProject.returnBuses.clear();
+    if (parsed.hasProperty("returnBuses") && parsed["returnBuses"].isArray())
+    {
+        const auto* busesArray = parsed["returnBuses"].getArray();
+        if (busesArray)
+        {
+            for (const auto& busVar : *busesArray)
+            {
+                outProject.returnBuses.add(busVar);
+            }
+        }
+    }
+
+    // Group buses
+    outProject.groupBuses.clear();
+    if (parsed.hasProperty("groupBuses") && parsed["groupBuses"].isArray())
+    {
+        const auto* groupsArray = parsed["groupBuses"].getArray();
+        if (groupsArray)
+        {
+            for (const auto& groupVar : *groupsArray)
+            {
+                outProject.groupBuses.add(groupVar);
+            }
+        }
+    }
+
     return true;
 }
 
@@ -129,13 +223,55 @@ bool ProjectSerializer::deserializeToEngine(const juce::String& jsonString,
         engine.removeTrack(0);
     }
 
-    // Load tracks
+    // Clear existing return and group buses
+    for (int slot = 0; slot < AudioEngine::MAX_RETURN_BUSES; ++slot)
+    {
+        engine.removeReturnBus(slot);
+    }
+
+    for (int slot = 0; slot < AudioEngine::MAX_GROUP_BUSES; ++slot)
+    {
+        engine.removeGroupBus(slot);
+    }
+
+    // Load tracks, remembering where each one was routed
+    std::vector<int> trackOutputs;
     for (const auto& trackVar : project.tracks)
     {
         auto track = deserializeTrack(trackVar);
         if (track)
         {
             engine.addTrack(std::move(track));
+            trackOutputs.push_back(static_cast<int>(trackVar.getProperty("outputGroup", -1)));
+        }
+    }
+
+    // Load return buses
+    restoreBusSlots(project.returnBuses, AudioEngine::MAX_RETURN_BUSES,
+        [&engine](const juce::String& name) { return engine.addReturnBus(name); },
+        [&engine](const juce::var& busVar, int slot) { deserializeReturnBus(busVar, *engine.getReturnBus(slot)); },
+        [&engine](int slot) { engine.removeReturnBus(slot); });
+
+    // Load group buses, then route once every group exists
+    restoreBusSlots(project.groupBuses, AudioEngine::MAX_GROUP_BUSES,
+        [&engine](const juce::String& name) { return engine.addGroupBus(name); },
+        [&engine](const juce::var& groupVar, int slot) { deserializeGroupBus(groupVar, *engine.getGroupBus(slot)); },
+        [&engine](int slot) { engine.removeGroupBus(slot); });
+
+    for (const auto& groupVar : project.groupBuses)
+    {
+        const int destination = static_cast<int>(groupVar.getProperty("outputGroup", -1));
+        if (destination >= 0)
+        {
+            engine.setGroupOutput(static_cast<int>(groupVar.getProperty("slot", -1)), destination);
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(trackOutputs.size()); ++i)
+    {
+        if (trackOutputs[static_cast<size_t>(i)] >= 0)
+        {
+            engine.setTrackOutput(i, trackOutputs[static_cast<size_t>(i)]);
         }
     }
 
@@ -159,6 +295,14 @@ juce::var ProjectSerializer::serializeTrack(const Track& track)
     obj->setProperty("muted", track.isMuted());
     obj->setProperty("soloed", track.isSoloed());
 
+    // Audio input
+    obj->setProperty("inputChannel", track.getFirstInputChannel());
+    obj->setProperty("inputChannels", track.getNumInputChannels());
+    obj->setProperty("inputMonitoring", track.isInputMonitoring());
+
+    // Group bus slot this track feeds (-1 = master)
+    obj->setProperty("outputGroup", track.getOutputGroup());
+
     // Synth type
     obj->setProperty("synthType", SynthFactory::getSynthName(track.getSynthType()));
 
@@ -210,6 +354,20 @@ juce::var ProjectSerializer::serializeTrack(const Track& track)
     }
     obj->setProperty("pluginEffects", pluginEffectsArray);
 
+    // Built-in inserts
+    obj->setProperty("effectChain", serializeEffectChain(track.getEffectChain()));
+
+    // Sends (one per return bus slot)
+    juce::Array<juce::var> sendsArray;
+    for (int i = 0; i < Track::MAX_SENDS; ++i)
+    {
+        auto* sendObj = new juce::DynamicObject();
+        sendObj->setProperty("level", static_cast<double>(track.getSendLevel(i)));
+        sendObj->setProperty("preFader", track.isSendPreFader(i));
+        sendsArray.add(juce::var(sendObj));
+    }
+    obj->setProperty("sends", sendsArray);
+
     // Automation
     auto autoMode = track.getAutomationMode();
     juce::String modeStr;
@@ -253,6 +411,11 @@ std::unique_ptr<Track> ProjectSerializer::deserializeTrack(const juce::var& data
     track->setMuted(static_cast<bool>(data.getProperty("muted", false)));
     track->setSoloed(static_cast<bool>(data.getProperty("soloed", false)));
 
+    // Audio input
+    track->setInputChannels(static_cast<int>(data.getProperty("inputChannel", -1)),
+                            static_cast<int>(data.getProperty("inputChannels", 1)));
+    track->setInputMonitoring(static_cast<bool>(data.getProperty("inputMonitoring", false)));
+
     // Synth type
     if (data.hasProperty("synthType"))
     {
@@ -310,6 +473,27 @@ std::unique_ptr<Track> ProjectSerializer::deserializeTrack(const juce::var& data
     // Note: Plugin loading requires PluginHost integration
     // Will be handled by ProjectManager after plugin scanning
 
+    // Built-in inserts
+    if (data.hasProperty("effectChain"))
+    {
+        deserializeEffectChain(data["effectChain"], track->getEffectChain());
+    }
+
+    // Sends
+    if (data.hasProperty("sends") && data["sends"].isArray())
+    {
+        const auto* sendsArray = data["sends"].getArray();
+        if (sendsArray)
+        {
+            for (int i = 0; i < juce::jmin(sendsArray->size(), Track::MAX_SENDS); ++i)
+            {
+                const auto& sendVar = (*sendsArray)[i];
+                track->setSendLevel(i, static_cast<float>(sendVar.getProperty("level", 0.0)));
+                track->setSendPreFader(i, static_cast<bool>(sendVar.getProperty("preFader", false)));
+            }
+        }
+    }
+
     // Automation mode
     if (data.hasProperty("automationMode"))
     {
@@ -346,6 +530,193 @@ std::unique_ptr<Track> ProjectSerializer::deserializeTrack(const juce::var& data
     return track;
 }
 
+//==============================================================================
+// Effect serialization (built-in effects, recreated by EffectFactory name)
+
+juce::var ProjectSerializer::serializeEffect(const EffectBase& effect)
+{
+    auto* obj = new juce::DynamicObject();
+
+    obj->setProperty("type", effect.getName());
+    obj->setProperty("wetDry", static_cast<double>(effect.getWetDry()));
+    obj->setProperty("bypassed", effect.isBypassed());
+
+    auto* paramsObj = new juce::DynamicObject();
+    for (const auto& name : effect.getParameterNames())
+    {
+        paramsObj->setProperty(name, static_cast<double>(effect.getParameter(name)));
+    }
+    obj->setProperty("params", juce::var(paramsObj));
+
+    // State kept outside the parameters
+    if (effect.getSidechainSource() >= 0)
+    {
+        obj->setProperty("sidechainSource", effect.getSidechainSource());
+    }
+
+    juce::File impulseResponse;
+    if (auto* convolution = dynamic_cast<const ConvolutionReverbEffect*>(&effect))
+        impulseResponse = convolution->getImpulseResponseFile();
+    else if (auto* cabinet = dynamic_cast<const CabinetEffect*>(&effect))
+        impulseResponse = cabinet->getImpulseResponseFile();
+
+    if (impulseResponse != juce::File())
+    {
+        obj->setProperty("impulseResponse", impulseResponse.getFullPathName());
+    }
+
+    return juce::var(obj);
+}
+
+std::unique_ptr<EffectBase> ProjectSerializer::deserializeEffect(const juce::var& data)
+{
+    if (!data.isObject())
+        return nullptr;
+
+    auto effect = EffectFactory::createEffect(data.getProperty("type", "").toString());
+    if (!effect)
+        return nullptr;
+
+    if (auto* params = data["params"].getDynamicObject())
+    {
+        for (const auto& prop : params->getProperties())
+        {
+            effect->setParameter(prop.name.toString(), static_cast<float>(prop.value));
+        }
+    }
+
+    effect->setWetDry(static_cast<float>(data.getProperty("wetDry", 1.0)));
+    effect->setBypass(static_cast<bool>(data.getProperty("bypassed", false)));
+
+    if (auto* sidechain = dynamic_cast<SidechainCompressorEffect*>(effect.get()))
+    {
+        sidechain->setSidechainSource(static_cast<int>(data.getProperty("sidechainSource", -1)));
+    }
+
+    // Missing impulse responses leave the effect on its built-in one
+    const juce::String irPath = data.getProperty("impulseResponse", "").toString();
+    if (irPath.isNotEmpty() && juce::File::isAbsolutePath(irPath) && juce::File(irPath).existsAsFile())
+    {
+        if (auto* convolution = dynamic_cast<ConvolutionReverbEffect*>(effect.get()))
+            convolution->loadImpulseResponse(juce::File(irPath));
+        else if (auto* cabinet = dynamic_cast<CabinetEffect*>(effect.get()))
+            cabinet->loadImpulseResponse(juce::File(irPath));
+    }
+
+    return effect;
+}
+
+juce::var ProjectSerializer::serializeEffectChain(const EffectChain& chain)
+{
+    auto* obj = new juce::DynamicObject();
+
+    obj->setProperty("bypassed", chain.isBypassed());
+
+    // Effects in slot order (the chain keeps them packed from slot 0)
+    juce::Array<juce::var> effectsArray;
+    for (int slot = 0; slot < EffectChain::MAX_EFFECTS; ++slot)
+    {
+        if (const auto* effect = chain.getEffect(slot))
+        {
+            auto effectVar = serializeEffect(*effect);
+            effectVar.getDynamicObject()->setProperty("slotBypassed", chain.isSlotBypassed(slot));
+            effectsArray.add(effectVar);
+        }
+    }
+    obj->setProperty("effects", effectsArray);
+
+    return juce::var(obj);
+}
+
+void ProjectSerializer::deserializeEffectChain(const juce::var& data, EffectChain& chain)
+{
+    if (!data.isObject())
+        return;
+
+    chain.clearAll();
+    chain.setBypass(static_cast<bool>(data.getProperty("bypassed", false)));
+
+    if (data.hasProperty("effects") && data["effects"].isArray())
+    {
+        const auto* effectsArray = data["effects"].getArray();
+        if (effectsArray)
+        {
+            for (const auto& effectVar : *effectsArray)
+            {
+                // Unknown effect types are skipped
+                if (auto effect = deserializeEffect(effectVar))
+                {
+                    const int slot = chain.addEffect(std::move(effect));
+                    if (slot >= 0)
+                    {
+                        chain.setSlotBypass(slot, static_cast<bool>(effectVar.getProperty("slotBypassed", false)));
+                    }
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+// Return bus serialization
+
+juce::var ProjectSerializer::serializeReturnBus(ReturnBus& bus, int slot)
+{
+    auto* obj = new juce::DynamicObject();
+
+    obj->setProperty("slot", slot);
+    obj->setProperty("name", bus.getName());
+    obj->setProperty("returnLevel", static_cast<double>(bus.getReturnLevel()));
+    obj->setProperty("muted", bus.isMuted());
+    obj->setProperty("effectChain", serializeEffectChain(bus.getEffectChain()));
+
+    return juce::var(obj);
+}
+
+void ProjectSerializer::deserializeReturnBus(const juce::var& data, ReturnBus& bus)
+{
+    bus.setName(data.getProperty("name", "Return").toString());
+    bus.setReturnLevel(static_cast<float>(data.getProperty("returnLevel", 1.0)));
+    bus.setMuted(static_cast<bool>(data.getProperty("muted", false)));
+
+    if (data.hasProperty("effectChain"))
+    {
+        deserializeEffectChain(data["effectChain"], bus.getEffectChain());
+    }
+}
+
+//==============================================================================
+// Group bus serialization
+
+juce::var ProjectSerializer::serializeGroupBus(GroupBus& group, int slot)
+{
+    auto* obj = new juce::DynamicObject();
+
+    obj->setProperty("slot", slot);
+    obj->setProperty("name", group.getName());
+    obj->setProperty("volume", static_cast<double>(group.getVolume()));
+    obj->setProperty("pan", static_cast<double>(group.getPan()));
+    obj->setProperty("muted", group.isMuted());
+    obj->setProperty("outputGroup", group.getOutputGroup());
+    obj->setProperty("effectChain", serializeEffectChain(group.getEffectChain()));
+
+    return juce::var(obj);
+}
+
+void ProjectSerializer::deserializeGroupBus(const juce::var& data, GroupBus& group)
+{
+    // The output is routed by deserializeToEngine once every group exists
+    group.setName(data.getProperty("name", "Group").toString());
+    group.setVolume(static_cast<float>(data.getProperty("volume", 1.0)));
+    group.setPan(static_cast<float>(data.getProperty("pan", 0.0)));
+    group.setMuted(static_cast<bool>(data.getProperty("muted", false)));
+
+    if (data.hasProperty("effectChain"))
+    {
+        deserializeEffectChain(data["effectChain"], group.getEffectChain());
+    }
+}
+
 //==============================================================================
 // Note serialization (individual notes, for compatibility)
 
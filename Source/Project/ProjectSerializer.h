@@ -14,7 +14,9 @@
  * - Tracks with clips and notes
  * - Synth parameters
  * - Plugin state (base64-encoded)
- * - Effect chain configuration
+ * - Effect chain configuration (track inserts, return buses)
+ * - Sends and return buses
+ * - Group buses and track/group output routing
  *
  * File format is compatible with Electron ProgFlow (.progflow files)
  * Version 1 = Electron format
@@ -37,6 +39,8 @@ public:
         int timeSignatureDen = 4;
         juce::Array<juce::var> tracks;
         juce::Array<juce::var> markers;
+        juce::Array<juce::var> returnBuses;
+        juce::Array<juce::var> groupBuses;
     };
 
     //==========================================================================
@@ -67,12 +71,20 @@ public:
     static juce::var serializeNote(const Note& note);
     static juce::var serializePlugin(juce::AudioPluginInstance* plugin,
                                      const juce::PluginDescription* desc);
+    static juce::var serializeEffect(const EffectBase& effect);
+    static juce::var serializeEffectChain(const EffectChain& chain);
+    static juce::var serializeReturnBus(ReturnBus& bus, int slot);
+    static juce::var serializeGroupBus(GroupBus& group, int slot);
 
     //==========================================================================
     // Individual deserialization methods
     static std::unique_ptr<Track> deserializeTrack(const juce::var& data);
     static std::unique_ptr<MidiClip> deserializeClip(const juce::var& data);
     static Note deserializeNote(const juce::var& data);
+    static std::unique_ptr<EffectBase> deserializeEffect(const juce::var& data);
+    static void deserializeEffectChain(const juce::var& data, EffectChain& chain);
+    static void deserializeReturnBus(const juce::var& data, ReturnBus& bus);
+    static void deserializeGroupBus(const juce::var& data, GroupBus& group);
 
     //==========================================================================
     // Base64 encoding/decoding for plugin state
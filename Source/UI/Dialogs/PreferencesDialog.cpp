@@ -228,7 +228,7 @@ PreferencesDialog::PreferencesDialog(juce::AudioDeviceManager& dm)
     // Audio tab - use JUCE's built-in audio device selector
     audioDeviceSelector = std::make_unique<juce::AudioDeviceSelectorComponent>(
         deviceManager,
-        0, 2,   // min/max input channels
+        0, 64,  // min/max input channels
         0, 2,   // min/max output channels
         false,  // show MIDI inputs
         false,  // show MIDI outputs
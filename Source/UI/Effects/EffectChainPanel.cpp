@@ -70,6 +70,7 @@ void EffectChainPanel::populateEffectSelector()
     addEffectSelector.addSectionHeading("Time-Based");
     addEffectSelector.addItem("Reverb", 30);
     addEffectSelector.addItem("Delay", 31);
+    addEffectSelector.addItem("Convolution Reverb", 32);
 
     // Distortion
     addEffectSelector.addSectionHeading("Distortion");
@@ -79,6 +80,7 @@ void EffectChainPanel::populateEffectSelector()
     // EQ & Filter
     addEffectSelector.addSectionHeading("EQ & Filter");
     addEffectSelector.addItem("EQ", 50);
+    addEffectSelector.addItem("Parametric EQ", 52);
     addEffectSelector.addItem("Filter", 51);
 
     // Amp Simulation
@@ -89,35 +91,13 @@ void EffectChainPanel::populateEffectSelector()
     addEffectSelector.setSelectedId(1, juce::dontSendNotification);
 }
 
-std::unique_ptr<EffectBase> EffectChainPanel::createEffect(const juce::String& name)
-{
-    if (name == "Reverb") return std::make_unique<ReverbEffect>();
-    if (name == "Delay") return std::make_unique<DelayEffect>();
-    if (name == "Chorus") return std::make_unique<ChorusEffect>();
-    if (name == "Phaser") return std::make_unique<PhaserEffect>();
-    if (name == "Flanger") return std::make_unique<FlangerEffect>();
-    if (name == "Tremolo") return std::make_unique<TremoloEffect>();
-    if (name == "Distortion") return std::make_unique<DistortionEffect>();
-    if (name == "Bitcrusher") return std::make_unique<BitcrusherEffect>();
-    if (name == "Compressor") return std::make_unique<CompressorEffect>();
-    if (name == "Sidechain Compressor") return std::make_unique<SidechainCompressorEffect>();
-    if (name == "Limiter") return std::make_unique<LimiterEffect>();
-    if (name == "Gate") return std::make_unique<GateEffect>();
-    if (name == "EQ") return std::make_unique<EQEffect>();
-    if (name == "Filter") return std::make_unique<FilterEffect>();
-    if (name == "Amp Simulator") return std::make_unique<AmpSimulatorEffect>();
-    if (name == "Cabinet") return std::make_unique<CabinetEffect>();
-
-    return nullptr;
-}
-
 void EffectChainPanel::onAddEffectSelected()
 {
     auto selectedText = addEffectSelector.getText();
     if (selectedText == "Add Effect..." || selectedText.isEmpty())
         return;
 
-    auto effect = createEffect(selectedText);
+    auto effect = EffectFactory::createEffect(selectedText);
     if (effect)
     {
         effectChain.addEffect(std::move(effect));
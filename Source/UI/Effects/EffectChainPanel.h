@@ -3,22 +3,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "EffectSlot.h"
 #include "../../Audio/Effects/EffectChain.h"
-#include "../../Audio/Effects/ReverbEffect.h"
-#include "../../Audio/Effects/DelayEffect.h"
-#include "../../Audio/Effects/ChorusEffect.h"
-#include "../../Audio/Effects/DistortionEffect.h"
-#include "../../Audio/Effects/CompressorEffect.h"
-#include "../../Audio/Effects/EQEffect.h"
-#include "../../Audio/Effects/PhaserEffect.h"
-#include "../../Audio/Effects/FlangerEffect.h"
-#include "../../Audio/Effects/TremoloEffect.h"
-#include "../../Audio/Effects/BitcrusherEffect.h"
-#include "../../Audio/Effects/LimiterEffect.h"
-#include "../../Audio/Effects/GateEffect.h"
-#include "../../Audio/Effects/FilterEffect.h"
-#include "../../Audio/Effects/AmpSimulatorEffect.h"
-#include "../../Audio/Effects/CabinetEffect.h"
-#include "../../Audio/Effects/SidechainCompressorEffect.h"
+#include "../../Audio/Effects/EffectFactory.h"
 #include "../LookAndFeel.h"
 
 /**
@@ -68,7 +53,5 @@ private:
     void onEffectDropped(int fromSlot, int toSlot);
     void populateEffectSelector();
 
-    std::unique_ptr<EffectBase> createEffect(const juce::String& name);
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectChainPanel)
 };
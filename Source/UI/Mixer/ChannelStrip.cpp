@@ -1,8 +1,8 @@
 #include "ChannelStrip.h"
 
 // Track channel strip constructor
-ChannelStrip::ChannelStrip(Track& track)
-    : track(&track), isMaster(false)
+ChannelStrip::ChannelStrip(Track& track, AudioEngine& engine)
+    : track(&track), audioEngine(&engine), isMaster(false)
 {
     setupComponents();
 
@@ -38,8 +38,17 @@ ChannelStrip::ChannelStrip(Track& track)
         }
     };
 
+    fxButton.onClick = [this]() {
+        if (this->track)
+            showEffectChain(this->track->getEffectChain());
+    };
+
+    sendsButton.onClick = [this]() { showSends(); };
+    outputButton.onClick = [this]() { showOutputMenu(); };
+
     updateMuteButtonAppearance();
     updateSoloButtonAppearance();
+    updateOutputButton();
 
     startTimerHz(30);
 }
@@ -53,10 +62,13 @@ ChannelStrip::ChannelStrip(AudioEngine& engine)
     nameLabel.setText("MASTER", juce::dontSendNotification);
     nameLabel.setFont(juce::Font(10.0f, juce::Font::bold));
 
-    // Master doesn't have pan, mute, solo - hide them
+    // Master doesn't have pan, mute, solo or FX/sends here - hide them
     panKnob.setVisible(false);
     muteButton.setVisible(false);
     soloButton.setVisible(false);
+    fxButton.setVisible(false);
+    sendsButton.setVisible(false);
+    outputButton.setVisible(false);
 
     // Master volume control
     volumeFader.setValue(engine.getMasterVolume(), juce::dontSendNotification);
@@ -68,6 +80,86 @@ ChannelStrip::ChannelStrip(AudioEngine& engine)
     startTimerHz(30);
 }
 
+// Return bus strip constructor
+ChannelStrip::ChannelStrip(AudioEngine& engine, int slot)
+    : audioEngine(&engine), returnBus(engine.getReturnBus(slot)), returnSlot(slot)
+{
+    setupComponents();
+
+    nameLabel.setText(returnBus ? returnBus->getName() : juce::String("Return"), juce::dontSendNotification);
+    nameLabel.setInterceptsMouseClicks(false, false);  // Right-click the name to remove the return
+
+    // Returns have no pan, solo, sends, routing or meter of their own
+    panKnob.setVisible(false);
+    soloButton.setVisible(false);
+    sendsButton.setVisible(false);
+    outputButton.setVisible(false);
+    meterL.setVisible(false);
+    meterR.setVisible(false);
+
+    volumeFader.setValue(returnBus ? returnBus->getReturnLevel() : 1.0f, juce::dontSendNotification);
+    volumeFader.setTooltip("Return level");
+    volumeFader.onValueChange = [this] {
+        if (returnBus)
+            returnBus->setReturnLevel(static_cast<float>(volumeFader.getValue()));
+    };
+
+    muteButton.setTooltip("Mute return");
+    muteButton.onClick = [this]() {
+        if (returnBus)
+        {
+            returnBus->setMuted(!returnBus->isMuted());
+            updateMuteButtonAppearance();
+        }
+    };
+
+    fxButton.onClick = [this]() {
+        if (returnBus)
+            showEffectChain(returnBus->getEffectChain());
+    };
+
+    updateMuteButtonAppearance();
+}
+
+// Group bus strip constructor
+ChannelStrip::ChannelStrip(GroupBus& group, int slot, AudioEngine& engine)
+    : audioEngine(&engine), groupBus(&group), groupSlot(slot)
+{
+    setupComponents();
+
+    nameLabel.setText(group.getName(), juce::dontSendNotification);
+    nameLabel.setInterceptsMouseClicks(false, false);  // Right-click the name to remove the group
+
+    // Groups have no solo or sends of their own
+    soloButton.setVisible(false);
+    sendsButton.setVisible(false);
+
+    panKnob.setValue(group.getPan(), juce::dontSendNotification);
+    panKnob.onValueChange = [this](float value) {
+        groupBus->setPan(value);
+    };
+
+    volumeFader.setValue(group.getVolume(), juce::dontSendNotification);
+    volumeFader.setTooltip("Group volume");
+    volumeFader.onValueChange = [this] {
+        groupBus->setVolume(static_cast<float>(volumeFader.getValue()));
+    };
+
+    muteButton.setTooltip("Mute group");
+    muteButton.onClick = [this]() {
+        groupBus->setMuted(!groupBus->isMuted());
+        updateMuteButtonAppearance();
+    };
+
+    fxButton.onClick = [this]() { showEffectChain(groupBus->getEffectChain()); };
+    outputButton.onClick = [this]() { showOutputMenu(); };
+
+    updateMuteButtonAppearance();
+    updateOutputButton();
+
+    startTimerHz(30);
+}
+
 void ChannelStrip::setupComponents()
 {
     // Name label (Saturn: centered, bold)
@@ -95,6 +187,17 @@ void ChannelStrip::setupComponents()
     soloButton.setTooltip("Solo track");
     addAndMakeVisible(soloButton);
 
+    // FX and Sends buttons open their panels in a callout, Output a menu
+    for (auto* button : { &fxButton, &sendsButton, &outputButton })
+    {
+        button->setColour(juce::TextButton::buttonColourId, ProgFlowColours::surfaceBg());
+        button->setColour(juce::TextButton::textColourOffId, ProgFlowColours::textSecondary());
+        addAndMakeVisible(*button);
+    }
+    fxButton.setTooltip("Insert effects");
+    sendsButton.setTooltip("Send levels to the return buses");
+    outputButton.setTooltip("Output - the master or a group bus");
+
     // Volume fader (vertical slider, Saturn style)
     volumeFader.setSliderStyle(juce::Slider::LinearVertical);
     volumeFader.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 16);
@@ -120,6 +223,9 @@ void ChannelStrip::setupComponents()
 ChannelStrip::~ChannelStrip()
 {
     stopTimer();
+
+    // An open FX or Sends panel refers to this strip's track or bus
+    delete callOut.getComponent();
 }
 
 void ChannelStrip::timerCallback()
@@ -129,8 +235,16 @@ void ChannelStrip::timerCallback()
         float level = track->getMeterLevel();
         meterL.setLevel(level);
         meterR.setLevel(level);  // Mono for now
+        updateOutputButton();
     }
-    else if (audioEngine)
+    else if (groupBus)
+    {
+        float level = groupBus->getMeterLevel();
+        meterL.setLevel(level);
+        meterR.setLevel(level);
+        updateOutputButton();
+    }
+    else if (isMaster && audioEngine)
     {
         meterL.setLevel(audioEngine->getMasterLevelL());
         meterR.setLevel(audioEngine->getMasterLevelR());
@@ -162,6 +276,19 @@ void ChannelStrip::paint(juce::Graphics& g)
         g.fillRoundedRectangle(bounds.getX() + 6.0f, bounds.getY() + 6.0f,
                                bounds.getWidth() - 12.0f, 4.0f, 2.0f);
     }
+    else if (groupBus)
+    {
+        g.setColour(ProgFlowColours::accentOrange().withAlpha(0.6f));
+        g.fillRoundedRectangle(bounds.getX() + 6.0f, bounds.getY() + 6.0f,
+                               bounds.getWidth() - 12.0f, 4.0f, 2.0f);
+    }
+    else if (returnBus)
+    {
+        // Returns use a muted accent so they stand apart from tracks
+        g.setColour(ProgFlowColours::accentGreen().withAlpha(0.6f));
+        g.fillRoundedRectangle(bounds.getX() + 6.0f, bounds.getY() + 6.0f,
+                               bounds.getWidth() - 12.0f, 4.0f, 2.0f);
+    }
     else if (isMaster)
     {
         // Master uses accent color
@@ -216,11 +343,31 @@ void ChannelStrip::resized()
         buttonRow.removeFromLeft(4);
         muteButton.setBounds(buttonRow);
         bounds.removeFromTop(4);
+
+        // FX/Sends buttons (22px row)
+        auto fxRow = bounds.removeFromTop(22);
+        fxRow.reduce(4, 0);
+        if (sendsButton.isVisible())
+        {
+            int fxWidth = (fxRow.getWidth() - 4) / 2;
+            fxButton.setBounds(fxRow.removeFromLeft(fxWidth));
+            fxRow.removeFromLeft(4);
+            sendsButton.setBounds(fxRow);
+        }
+        else
+        {
+            fxButton.setBounds(fxRow);
+        }
+        bounds.removeFromTop(4);
+
+        // Output (20px row, kept on returns so the faders line up)
+        outputButton.setBounds(bounds.removeFromTop(20).reduced(4, 0));
+        bounds.removeFromTop(4);
     }
     else
     {
-        // Extra space for master (no pan/mute/solo)
-        bounds.removeFromTop(66);
+        // Extra space for master (no pan/mute/solo/FX/output)
+        bounds.removeFromTop(116);
     }
 
     // Volume fader fills the rest
@@ -236,11 +383,121 @@ void ChannelStrip::setSelected(bool isSelected)
     }
 }
 
+void ChannelStrip::mouseDown(const juce::MouseEvent& e)
+{
+    if ((!returnBus && !groupBus) || !e.mods.isPopupMenu())
+        return;
+
+    juce::PopupMenu menu;
+    menu.addItem(1, returnBus ? "Remove Return" : "Remove Group");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this),
+        [safeThis = juce::Component::SafePointer<ChannelStrip>(this)](int result)
+        {
+            if (result != 1 || safeThis == nullptr || !safeThis->onRemoveBus)
+                return;
+
+            // Removing the bus deletes this strip, so don't run the callback from it
+            auto callback = safeThis->onRemoveBus;
+            callback();
+        });
+}
+
+void ChannelStrip::showEffectChain(EffectChain& chain)
+{
+    auto panel = std::make_unique<EffectChainPanel>(chain);
+    panel->setSize(640, 216);
+    callOut = &juce::CallOutBox::launchAsynchronously(std::move(panel), fxButton.getScreenBounds(), nullptr);
+}
+
+void ChannelStrip::showSends()
+{
+    if (!track || !audioEngine)
+        return;
+
+    callOut = &juce::CallOutBox::launchAsynchronously(std::make_unique<SendsPanel>(*track, *audioEngine),
+                                                      sendsButton.getScreenBounds(), nullptr);
+}
+
+void ChannelStrip::showOutputMenu()
+{
+    if (!audioEngine || (!track && !groupBus))
+        return;
+
+    const int current = track ? track->getOutputGroup() : groupBus->getOutputGroup();
+
+    juce::PopupMenu menu;
+    menu.addItem(1, "Master", true, current < 0);
+
+    for (int slot = 0; slot < AudioEngine::MAX_GROUP_BUSES; ++slot)
+    {
+        auto* group = audioEngine->getGroupBus(slot);
+        if (!group)
+            continue;
+
+        // A group can't feed itself or any group that already feeds it
+        bool feedsThisGroup = false;
+        for (int next = slot, hops = 0; next >= 0 && groupBus && hops <= AudioEngine::MAX_GROUP_BUSES; ++hops)
+        {
+            if (next == groupSlot)
+            {
+                feedsThisGroup = true;
+                break;
+            }
+            auto* nextGroup = audioEngine->getGroupBus(next);
+            next = nextGroup ? nextGroup->getOutputGroup() : -1;
+        }
+
+        if (!feedsThisGroup)
+            menu.addItem(slot + 2, group->getName(), true, current == slot);
+    }
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&outputButton),
+        [safeThis = juce::Component::SafePointer<ChannelStrip>(this)](int result)
+        {
+            if (result > 0 && safeThis != nullptr)
+                safeThis->setOutput(result - 2);
+        });
+}
+
+void ChannelStrip::setOutput(int destinationSlot)
+{
+    if (track)
+    {
+        // Tracks are routed by index
+        for (int i = 0; i < audioEngine->getNumTracks(); ++i)
+        {
+            if (audioEngine->getTrack(i) == track)
+            {
+                audioEngine->setTrackOutput(i, destinationSlot);
+                break;
+            }
+        }
+    }
+    else if (groupBus)
+    {
+        audioEngine->setGroupOutput(groupSlot, destinationSlot);
+    }
+
+    updateOutputButton();
+}
+
+void ChannelStrip::updateOutputButton()
+{
+    const int destination = track ? track->getOutputGroup()
+                          : groupBus ? groupBus->getOutputGroup() : -1;
+    auto* group = (destination >= 0 && audioEngine) ? audioEngine->getGroupBus(destination) : nullptr;
+
+    const juce::String text = group ? group->getName() : juce::String("Master");
+    if (outputButton.getButtonText() != text)
+        outputButton.setButtonText(text);
+}
+
 void ChannelStrip::updateMuteButtonAppearance()
 {
-    if (!track) return;
+    if (!track && !returnBus && !groupBus) return;
 
-    if (track->isMuted())
+    if (track ? track->isMuted() : returnBus ? returnBus->isMuted() : groupBus->isMuted())
     {
         // Saturn design: Mute = gold (warning)
         muteButton.setColour(juce::TextButton::buttonColourId, ProgFlowColours::accentOrange());
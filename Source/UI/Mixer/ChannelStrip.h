@@ -6,6 +6,8 @@
 #include "../LookAndFeel.h"
 #include "../Common/RotaryKnob.h"
 #include "../Common/VerticalMeter.h"
+#include "../Effects/EffectChainPanel.h"
+#include "SendsPanel.h"
 
 /**
  * ChannelStrip - A vertical mixer channel strip
@@ -14,19 +16,30 @@
  * - Track name
  * - Pan knob
  * - Mute/Solo buttons
+ * - FX (insert chain) and Sends buttons
+ * - Output (master or a group bus)
  * - Volume fader
  * - Meter
+ *
+ * Group bus strips have no solo or sends; return bus strips have mute, FX
+ * and a return level fader only.
  */
 class ChannelStrip : public juce::Component,
                       public juce::Timer
 {
 public:
     /** Constructor for track channel strip */
-    ChannelStrip(Track& track);
+    ChannelStrip(Track& track, AudioEngine& engine);
 
     /** Constructor for master channel strip */
     ChannelStrip(AudioEngine& engine);
 
+    /** Constructor for a return bus strip */
+    ChannelStrip(AudioEngine& engine, int returnSlot);
+
+    /** Constructor for a group bus strip */
+    ChannelStrip(GroupBus& group, int groupSlot, AudioEngine& engine);
+
     ~ChannelStrip() override;
 
     void paint(juce::Graphics& g) override;
@@ -37,11 +50,18 @@ public:
     void setSelected(bool selected);
     bool isSelected() const { return selected; }
 
-    // Get associated track (nullptr for master)
+    // Get associated track (nullptr for master and buses)
     Track* getTrack() { return track; }
 
+    // Bus slots (-1 unless this is a return / group strip)
+    int getReturnSlot() const { return returnSlot; }
+    int getGroupSlot() const { return groupSlot; }
+
+    void mouseDown(const juce::MouseEvent& e) override;
+
     // Callbacks
     std::function<void(Track*)> onTrackSelected;
+    std::function<void()> onRemoveBus;    // Return and group strips
 
     // Dimensions
     static constexpr int defaultWidth = 80;
@@ -49,6 +69,10 @@ public:
 private:
     Track* track = nullptr;
     AudioEngine* audioEngine = nullptr;
+    ReturnBus* returnBus = nullptr;
+    int returnSlot = -1;
+    GroupBus* groupBus = nullptr;
+    int groupSlot = -1;
     bool isMaster = false;
     bool selected = false;
 
@@ -57,11 +81,22 @@ private:
     RotaryKnob panKnob;
     juce::TextButton muteButton{"M"};
     juce::TextButton soloButton{"S"};
+    juce::TextButton fxButton{"FX"};
+    juce::TextButton sendsButton{"Sends"};
+    juce::TextButton outputButton{"Master"};
     juce::Slider volumeFader;
     VerticalMeter meterL;
     VerticalMeter meterR;
 
+    // Open FX or Sends panel (refers to this strip's track or bus)
+    juce::Component::SafePointer<juce::CallOutBox> callOut;
+
     void setupComponents();
+    void showEffectChain(EffectChain& chain);
+    void showSends();
+    void showOutputMenu();
+    void setOutput(int destinationSlot);
+    void updateOutputButton();
     void updateMuteButtonAppearance();
     void updateSoloButtonAppearance();
 
@@ -15,6 +15,19 @@ MixerPanel::MixerPanel(AudioEngine& audioEngine)
     masterStrip = std::make_unique<ChannelStrip>(audioEngine);
     addAndMakeVisible(*masterStrip);
 
+    // Toolbar
+    addGroupButton.setColour(juce::TextButton::buttonColourId, ProgFlowColours::surfaceBg());
+    addGroupButton.setColour(juce::TextButton::textColourOffId, ProgFlowColours::textSecondary());
+    addGroupButton.setTooltip("Add a group bus to submix tracks into");
+    addGroupButton.onClick = [this]() { addGroupBus(); };
+    addAndMakeVisible(addGroupButton);
+
+    addReturnButton.setColour(juce::TextButton::buttonColourId, ProgFlowColours::surfaceBg());
+    addReturnButton.setColour(juce::TextButton::textColourOffId, ProgFlowColours::textSecondary());
+    addReturnButton.setTooltip("Add a return bus for shared send effects");
+    addReturnButton.onClick = [this]() { addReturnBus(); };
+    addAndMakeVisible(addReturnButton);
+
     // Initial channel strip creation
     refreshTracks();
 
@@ -29,18 +42,27 @@ MixerPanel::~MixerPanel()
 
 void MixerPanel::timerCallback()
 {
-    // Check if track count changed
+    // Check if track or bus count changed (e.g. a project was loaded)
     int numTracks = audioEngine.getNumTracks();
-    if (static_cast<int>(channelStrips.size()) != numTracks)
+    int numGroups = audioEngine.getNumGroupBuses();
+    int numReturns = audioEngine.getNumReturnBuses();
+    if (static_cast<int>(channelStrips.size()) != numTracks
+        || static_cast<int>(groupStrips.size()) != numGroups
+        || static_cast<int>(returnStrips.size()) != numReturns)
     {
         refreshTracks();
     }
+
+    // Pick up inserts whose latency changed (plugins, linear phase EQ...)
+    audioEngine.updateLatencyCompensation();
 }
 
 void MixerPanel::refreshTracks()
 {
     // Clear existing strips
     channelStrips.clear();
+    groupStrips.clear();
+    returnStrips.clear();
 
     // Create strips for each track
     int numTracks = audioEngine.getNumTracks();
@@ -49,7 +71,7 @@ void MixerPanel::refreshTracks()
         Track* track = audioEngine.getTrack(i);
         if (track)
         {
-            auto strip = std::make_unique<ChannelStrip>(*track);
+            auto strip = std::make_unique<ChannelStrip>(*track, audioEngine);
             strip->onTrackSelected = [this](Track* t) {
                 selectTrack(t);
             };
@@ -62,10 +84,38 @@ void MixerPanel::refreshTracks()
         }
     }
 
-    // Update container size
-    int totalWidth = numTracks * (ChannelStrip::defaultWidth + stripSpacing);
-    stripContainer->setSize(std::max(totalWidth, viewport.getWidth()),
-                            viewport.getHeight());
+    // Group strips follow the tracks
+    for (int slot = 0; slot < AudioEngine::MAX_GROUP_BUSES; ++slot)
+    {
+        if (auto* group = audioEngine.getGroupBus(slot))
+        {
+            auto strip = std::make_unique<ChannelStrip>(*group, slot, audioEngine);
+            strip->onRemoveBus = [this, slot]() {
+                removeGroupBus(slot);
+            };
+
+            stripContainer->addAndMakeVisible(*strip);
+            groupStrips.push_back(std::move(strip));
+        }
+    }
+
+    // Then the return buses
+    for (int slot = 0; slot < AudioEngine::MAX_RETURN_BUSES; ++slot)
+    {
+        if (audioEngine.getReturnBus(slot))
+        {
+            auto strip = std::make_unique<ChannelStrip>(audioEngine, slot);
+            strip->onRemoveBus = [this, slot]() {
+                removeReturnBus(slot);
+            };
+
+            stripContainer->addAndMakeVisible(*strip);
+            returnStrips.push_back(std::move(strip));
+        }
+    }
+
+    addGroupButton.setEnabled(static_cast<int>(groupStrips.size()) < AudioEngine::MAX_GROUP_BUSES);
+    addReturnButton.setEnabled(static_cast<int>(returnStrips.size()) < AudioEngine::MAX_RETURN_BUSES);
 
     resized();
 }
@@ -87,6 +137,13 @@ void MixerPanel::resized()
     auto bounds = getLocalBounds();
     bounds.reduce(4, 4);
 
+    // Toolbar across the top
+    auto toolbar = bounds.removeFromTop(toolbarHeight);
+    addGroupButton.setBounds(toolbar.removeFromLeft(80));
+    toolbar.removeFromLeft(4);
+    addReturnButton.setBounds(toolbar.removeFromLeft(80));
+    bounds.removeFromTop(4);
+
     // Master strip on right
     auto masterBounds = bounds.removeFromRight(masterStripWidth);
     bounds.removeFromRight(8);  // Separator gap
@@ -97,8 +154,10 @@ void MixerPanel::resized()
 
     // Update container and position strips
     int containerHeight = viewport.getHeight();
-    int numStrips = static_cast<int>(channelStrips.size());
-    int totalWidth = numStrips * (ChannelStrip::defaultWidth + stripSpacing);
+    int numStrips = static_cast<int>(channelStrips.size() + groupStrips.size() + returnStrips.size());
+    int totalWidth = numStrips * (ChannelStrip::defaultWidth + stripSpacing)
+                   + (groupStrips.empty() ? 0 : sectionGap)
+                   + (returnStrips.empty() ? 0 : sectionGap);
     stripContainer->setSize(std::max(totalWidth, viewport.getWidth()), containerHeight);
 
     int x = 0;
@@ -107,6 +166,19 @@ void MixerPanel::resized()
         strip->setBounds(x, 0, ChannelStrip::defaultWidth, containerHeight);
         x += ChannelStrip::defaultWidth + stripSpacing;
     }
+
+    for (auto* section : { &groupStrips, &returnStrips })
+    {
+        if (section->empty())
+            continue;
+
+        x += sectionGap;
+        for (auto& strip : *section)
+        {
+            strip->setBounds(x, 0, ChannelStrip::defaultWidth, containerHeight);
+            x += ChannelStrip::defaultWidth + stripSpacing;
+        }
+    }
 }
 
 void MixerPanel::selectTrack(Track* track)
@@ -122,3 +194,31 @@ void MixerPanel::selectTrack(Track* track)
     if (onTrackSelected)
         onTrackSelected(track);
 }
+
+void MixerPanel::addGroupBus()
+{
+    const int slot = audioEngine.addGroupBus("Group " + juce::String(audioEngine.getNumGroupBuses() + 1));
+    if (slot >= 0)
+        refreshTracks();
+}
+
+void MixerPanel::removeGroupBus(int slot)
+{
+    // Whatever fed the group goes straight to the master
+    audioEngine.removeGroupBus(slot);
+    refreshTracks();
+}
+
+void MixerPanel::addReturnBus()
+{
+    const int slot = audioEngine.addReturnBus("Return " + juce::String(audioEngine.getNumReturnBuses() + 1));
+    if (slot >= 0)
+        refreshTracks();
+}
+
+void MixerPanel::removeReturnBus(int slot)
+{
+    // Sends to the slot stay on the tracks and are ignored until it's reused
+    audioEngine.removeReturnBus(slot);
+    refreshTracks();
+}
@@ -9,7 +9,8 @@
  * MixerPanel - Full mixer view with channel strips
  *
  * Layout:
- * - Track channel strips (horizontally scrollable)
+ * - Toolbar (add group / return bus)
+ * - Track, group and return bus strips (horizontally scrollable)
  * - Master channel strip on the right
  */
 class MixerPanel : public juce::Component,
@@ -23,7 +24,7 @@ public:
     void resized() override;
     void timerCallback() override;
 
-    // Rebuild channel strips from AudioEngine
+    // Rebuild channel strips (tracks, groups and return buses) from AudioEngine
     void refreshTracks();
 
     // Selection callback
@@ -37,14 +38,26 @@ private:
     juce::Viewport viewport;
     std::unique_ptr<juce::Component> stripContainer;
     std::vector<std::unique_ptr<ChannelStrip>> channelStrips;
+    std::vector<std::unique_ptr<ChannelStrip>> groupStrips;
+    std::vector<std::unique_ptr<ChannelStrip>> returnStrips;
+
+    // Toolbar
+    juce::TextButton addGroupButton{"+ Group"};
+    juce::TextButton addReturnButton{"+ Return"};
 
     // Master channel strip (always visible on right)
     std::unique_ptr<ChannelStrip> masterStrip;
 
     void selectTrack(Track* track);
+    void addGroupBus();
+    void removeGroupBus(int slot);
+    void addReturnBus();
+    void removeReturnBus(int slot);
 
     static constexpr int masterStripWidth = 90;
     static constexpr int stripSpacing = 4;
+    static constexpr int toolbarHeight = 24;
+    static constexpr int sectionGap = 12;  // Between tracks, groups and returns
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerPanel)
 };
@@ -0,0 +1,84 @@
+#include "SendsPanel.h"
+
+SendsPanel::SendsPanel(Track& t, AudioEngine& engine)
+    : track(t)
+{
+    titleLabel.setText("SENDS", juce::dontSendNotification);
+    titleLabel.setFont(juce::Font(12.0f, juce::Font::bold));
+    titleLabel.setColour(juce::Label::textColourId, ProgFlowColours::textPrimary());
+    addAndMakeVisible(titleLabel);
+
+    // One row per return bus that exists
+    for (int slot = 0; slot < AudioEngine::MAX_RETURN_BUSES; ++slot)
+    {
+        auto* bus = engine.getReturnBus(slot);
+        if (!bus)
+            continue;
+
+        auto row = std::make_unique<SendRow>();
+        row->slot = slot;
+
+        row->nameLabel.setText(bus->getName(), juce::dontSendNotification);
+        row->nameLabel.setColour(juce::Label::textColourId, ProgFlowColours::textSecondary());
+        addAndMakeVisible(row->nameLabel);
+
+        row->levelSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+        row->levelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+        row->levelSlider.setRange(0.0, 1.0, 0.01);
+        row->levelSlider.setValue(track.getSendLevel(slot), juce::dontSendNotification);
+        row->levelSlider.setDoubleClickReturnValue(true, 0.0);
+        row->levelSlider.setColour(juce::Slider::trackColourId, ProgFlowColours::accentBlue());
+        row->levelSlider.setTooltip("Send level");
+        row->levelSlider.onValueChange = [this, r = row.get()] {
+            track.setSendLevel(r->slot, static_cast<float>(r->levelSlider.getValue()));
+        };
+        addAndMakeVisible(row->levelSlider);
+
+        row->preFaderButton.setToggleState(track.isSendPreFader(slot), juce::dontSendNotification);
+        row->preFaderButton.setTooltip("Send before the track fader");
+        row->preFaderButton.onClick = [this, r = row.get()] {
+            track.setSendPreFader(r->slot, r->preFaderButton.getToggleState());
+        };
+        addAndMakeVisible(row->preFaderButton);
+
+        rows.push_back(std::move(row));
+    }
+
+    emptyLabel.setText("No return buses - add one with + Return", juce::dontSendNotification);
+    emptyLabel.setColour(juce::Label::textColourId, ProgFlowColours::textMuted());
+    addChildComponent(emptyLabel);
+    emptyLabel.setVisible(rows.empty());
+
+    setSize(300, getIdealHeight());
+}
+
+int SendsPanel::getIdealHeight() const
+{
+    return titleHeight + juce::jmax(1, static_cast<int>(rows.size())) * rowHeight + 8;
+}
+
+void SendsPanel::paint(juce::Graphics& g)
+{
+    g.fillAll(ProgFlowColours::bgSecondary());
+}
+
+void SendsPanel::resized()
+{
+    auto bounds = getLocalBounds().reduced(8, 4);
+
+    titleLabel.setBounds(bounds.removeFromTop(titleHeight));
+
+    if (rows.empty())
+    {
+        emptyLabel.setBounds(bounds.removeFromTop(rowHeight));
+        return;
+    }
+
+    for (auto& row : rows)
+    {
+        auto rowBounds = bounds.removeFromTop(rowHeight);
+        row->nameLabel.setBounds(rowBounds.removeFromLeft(80));
+        row->preFaderButton.setBounds(rowBounds.removeFromRight(50));
+        row->levelSlider.setBounds(rowBounds.reduced(4, 0));
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../../Audio/Track.h"
+#include "../../Audio/AudioEngine.h"
+#include "../LookAndFeel.h"
+
+/**
+ * SendsPanel - Send levels from one track to the return buses
+ *
+ * Layout (one row per return bus):
+ * ┌──────────────────────────────────────────┐
+ * │ SENDS                                    │
+ * │ Reverb   [━━━━━━━━━●━━━━━━━━━━]  [Pre]   │
+ * │ Delay    [━━━●━━━━━━━━━━━━━━━━]  [Pre]   │
+ * └──────────────────────────────────────────┘
+ */
+class SendsPanel : public juce::Component
+{
+public:
+    SendsPanel(Track& track, AudioEngine& engine);
+    ~SendsPanel() override = default;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    // Height that fits every row
+    int getIdealHeight() const;
+
+private:
+    struct SendRow
+    {
+        int slot = 0;
+        juce::Label nameLabel;
+        juce::Slider levelSlider;
+        juce::ToggleButton preFaderButton{"Pre"};
+    };
+
+    Track& track;
+
+    juce::Label titleLabel;
+    juce::Label emptyLabel;
+    std::vector<std::unique_ptr<SendRow>> rows;
+
+    static constexpr int titleHeight = 28;
+    static constexpr int rowHeight = 28;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SendsPanel)
+};
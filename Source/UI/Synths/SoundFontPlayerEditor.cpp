@@ -155,7 +155,12 @@ void SoundFontPlayerEditor::populateInstruments(int categoryIndex)
 
 void SoundFontPlayerEditor::updateSoundFontInfo()
 {
-    if (synth.isSoundFontLoaded())
+    if (synth.isSoundFontLoading())
+    {
+        soundFontPath.setText("Loading SoundFont...", juce::dontSendNotification);
+        startTimer(250);
+    }
+    else if (synth.isSoundFontLoaded())
     {
         juce::String path = synth.getCurrentSoundFontPath();
         if (path.length() > 40)
@@ -176,6 +181,15 @@ void SoundFontPlayerEditor::updateSoundFontInfo()
     }
 }
 
+void SoundFontPlayerEditor::timerCallback()
+{
+    if (synth.isSoundFontLoading())
+        return;
+
+    stopTimer();
+    updateSoundFontInfo();
+}
+
 void SoundFontPlayerEditor::comboBoxChanged(juce::ComboBox* box)
 {
     if (box == &categorySelector)
@@ -16,7 +16,8 @@
  * - Adjust volume, pan, envelope overrides
  */
 class SoundFontPlayerEditor : public SynthEditorBase,
-                               public juce::Button::Listener
+                               public juce::Button::Listener,
+                               private juce::Timer
 {
 public:
     SoundFontPlayerEditor(SoundFontPlayer& synth);
@@ -31,6 +32,9 @@ protected:
 private:
     SoundFontPlayer& synth;
 
+    // Polls while the SoundFont is loading in the background
+    void timerCallback() override;
+
     //==========================================================================
     // Card Panels (Saturn design)
     CardPanel controlsCard{"CONTROLS"};
@@ -102,6 +102,18 @@ void AudioClipComponent::paint(juce::Graphics& g)
     g.drawText(clip.getName(), headerBounds.reduced(4, 0),
                juce::Justification::centredLeft, true);
 
+    // Still importing: a progress bar where the waveform will be
+    if (clip.isPlaceholder())
+    {
+        const float progress = juce::jmax(0.0f, getAudioImportService().getProgress(clip.getId()));
+        auto bar = bounds.reduced(6, 0).withSizeKeepingCentre(bounds.getWidth() - 12, 4);
+
+        g.setColour(juce::Colours::black.withAlpha(0.3f));
+        g.fillRect(bar);
+        g.setColour(juce::Colours::white.withAlpha(0.8f));
+        g.fillRect(bar.withWidth(juce::roundToInt(static_cast<float>(bar.getWidth()) * progress)));
+    }
+
     // Draw fade overlays
     drawFadeOverlays(g);
 
@@ -236,7 +248,7 @@ void AudioClipComponent::mouseDrag(const juce::MouseEvent& e)
         double beatOffset = offset.x * beatsPerPixel;
         juce::int64 sampleOffset = static_cast<juce::int64>(beatOffset * samplesPerBeat);
 
-        juce::int64 maxSamples = clip.getAudioBuffer().getNumSamples();
+        juce::int64 maxSamples = clip.getDurationInSamples();
         juce::int64 newTrimEnd = juce::jlimit(
             dragStartTrimStart + 100,
             maxSamples,
@@ -2,6 +2,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../../Audio/AudioClip.h"
+#include "../../Audio/AudioImportService.h"
 #include "WaveformComponent.h"
 #include <functional>
 
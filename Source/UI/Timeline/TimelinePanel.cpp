@@ -39,6 +39,11 @@ TimelinePanel::TimelinePanel(AudioEngine& engine)
     playhead = std::make_unique<PlayheadComponent>();
     addAndMakeVisible(*playhead);
 
+    // Dropped audio files decode in the background and fill in their placeholders
+    getAudioImportService().onImportFinished = [this](AudioImportService::Result& result) {
+        handleAudioImportFinished(result);
+    };
+
     // Build initial track lanes
     updateTracks();
 
@@ -55,6 +60,7 @@ TimelinePanel::TimelinePanel(AudioEngine& engine)
 
 TimelinePanel::~TimelinePanel()
 {
+    getAudioImportService().onImportFinished = nullptr;
     stopTimer();
     removeKeyListener(this);
 }
@@ -878,7 +884,7 @@ int TimelinePanel::getBarWidth() const
 
 void TimelinePanel::updatePlayheadPosition()
 {
-    double positionInBars = audioEngine.getPositionInBeats() / 4.0;
+    double positionInBars = audioEngine.getAudiblePositionInBeats() / 4.0;
     int xPos = static_cast<int>((positionInBars - scrollPosition) * getBarWidth());
 
     playhead->setPosition(xPos);
@@ -926,9 +932,8 @@ void TimelinePanel::handleAudioFileDropped(Track* track, const juce::File& file,
 {
     if (!track) return;
 
-    // Load the audio file
-    auto& loader = getAudioFileLoader();
-    auto clip = loader.loadFile(file);
+    // Place a placeholder now; the audio fills in when the import finishes
+    auto clip = getAudioImportService().import(file);
 
     if (!clip)
     {
@@ -936,16 +941,34 @@ void TimelinePanel::handleAudioFileDropped(Track* track, const juce::File& file,
         return;
     }
 
-    // Set the clip position
     clip->setStartBeat(beatPosition);
-
-    // Add to track
     track->addAudioClip(std::move(clip));
 
-    // Refresh the UI
     updateTracks();
+}
+
+void TimelinePanel::handleAudioImportFinished(AudioImportService::Result& result)
+{
+    // The placeholder may have been moved to another track, or deleted
+    for (int i = 0; i < audioEngine.getNumTracks(); ++i)
+    {
+        Track* track = audioEngine.getTrack(i);
+        if (!track || !track->getAudioClip(result.clipId))
+            continue;
 
-    DBG("Loaded audio file: " + file.getFileName() + " at beat " + juce::String(beatPosition));
+        if (result.clip && track->fillAudioClip(result.clipId, *result.clip))
+        {
+            DBG("Loaded audio file: " + result.file.getFileName());
+        }
+        else
+        {
+            DBG("Failed to load audio file: " + result.file.getFullPathName());
+            track->removeAudioClip(result.clipId);
+        }
+
+        updateTracks();
+        return;
+    }
 }
 
 void TimelinePanel::onViewportScrolled()
@@ -3,6 +3,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../../Audio/AudioEngine.h"
 #include "../../Audio/MidiClip.h"
+#include "../../Audio/AudioImportService.h"
 #include "TimeRuler.h"
 #include "TrackLane.h"
 #include "PlayheadComponent.h"
@@ -167,6 +168,7 @@ private:
     void handleClipDoubleClicked(MidiClip* clip);
     void handleCreateClip(Track* track, double barPosition);
     void handleAudioFileDropped(Track* track, const juce::File& file, double beatPosition);
+    void handleAudioImportFinished(AudioImportService::Result& result);
     std::set<MidiClip*> getClipsInRect(const juce::Rectangle<int>& rect) const;
     void drawMarqueeSelection(juce::Graphics& g);
 
@@ -2,20 +2,12 @@
 
 WaveformComponent::WaveformComponent()
 {
-    // Create thumbnail with format manager from global loader
-    thumbnail = std::make_unique<juce::AudioThumbnail>(
-        512,  // Samples per thumbnail point
-        getAudioFileLoader().getFormatManager(),
-        thumbnailCache
-    );
-
-    thumbnail->addChangeListener(this);
+    getWaveformPeakStore().addChangeListener(this);
 }
 
 WaveformComponent::~WaveformComponent()
 {
-    if (thumbnail)
-        thumbnail->removeChangeListener(this);
+    getWaveformPeakStore().removeChangeListener(this);
 }
 
 void WaveformComponent::setAudioClip(AudioClip* clip)
@@ -24,7 +16,6 @@ void WaveformComponent::setAudioClip(AudioClip* clip)
         return;
 
     audioClip = clip;
-    updateThumbnail();
     repaint();
 }
 
@@ -66,75 +57,8 @@ void WaveformComponent::paint(juce::Graphics& g)
         g.fillRect(bounds);
     }
 
-    // Draw waveform
-    if (thumbnail && thumbnail->getTotalLength() > 0.0)
-    {
-        g.setColour(waveformColour);
-
-        // Calculate visible time range
-        double durationSeconds = thumbnail->getTotalLength();
-
-        // Draw the waveform thumbnail
-        thumbnail->drawChannels(g,
-                                bounds,
-                                0.0,        // Start time
-                                durationSeconds,  // End time
-                                1.0f);      // Vertical zoom
-    }
-    else if (audioClip && audioClip->hasAudio())
-    {
-        // Fallback: draw simple waveform from buffer
-        g.setColour(waveformColour);
-
-        const auto& buffer = audioClip->getAudioBuffer();
-        int numSamples = buffer.getNumSamples();
-        int numChannels = buffer.getNumChannels();
-
-        if (numSamples > 0 && numChannels > 0)
-        {
-            float centerY = bounds.getCentreY();
-            float halfHeight = bounds.getHeight() * 0.4f;
-
-            // Calculate samples per pixel
-            int samplesPerPixel = std::max(1, numSamples / bounds.getWidth());
-
-            juce::Path waveformPath;
-            bool pathStarted = false;
-
-            for (int x = 0; x < bounds.getWidth(); ++x)
-            {
-                int startSample = x * samplesPerPixel;
-                int endSample = std::min(startSample + samplesPerPixel, numSamples);
-
-                // Find min/max in this pixel range
-                float minVal = 0.0f, maxVal = 0.0f;
-
-                for (int s = startSample; s < endSample; ++s)
-                {
-                    for (int ch = 0; ch < numChannels; ++ch)
-                    {
-                        float sample = buffer.getSample(ch, s);
-                        minVal = std::min(minVal, sample);
-                        maxVal = std::max(maxVal, sample);
-                    }
-                }
-
-                float y1 = centerY - maxVal * halfHeight;
-                float y2 = centerY - minVal * halfHeight;
-
-                if (!pathStarted)
-                {
-                    waveformPath.startNewSubPath(static_cast<float>(x), y1);
-                    pathStarted = true;
-                }
-
-                waveformPath.lineTo(static_cast<float>(x), y1);
-                waveformPath.lineTo(static_cast<float>(x), y2);
-            }
-
-            g.strokePath(waveformPath, juce::PathStrokeType(1.0f));
-        }
-    }
+    if (audioClip && audioClip->hasAudio())
+        drawWaveform(g, bounds);
 
     // Draw clip name
     if (showName && audioClip)
@@ -154,31 +78,87 @@ void WaveformComponent::resized()
     // No child components to layout
 }
 
-void WaveformComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
+void WaveformComponent::changeListenerCallback(juce::ChangeBroadcaster*)
 {
-    if (source == thumbnail.get())
-    {
+    if (audioClip && audioClip->hasAudio())
         repaint();
-    }
 }
 
-void WaveformComponent::updateThumbnail()
+void WaveformComponent::drawWaveform(juce::Graphics& g, juce::Rectangle<int> bounds)
 {
-    if (!thumbnail)
+    const auto startFrame = audioClip->getTrimStartSample();
+    const auto endFrame = audioClip->getTrimEndSample();
+    if (endFrame <= startFrame || bounds.isEmpty())
         return;
 
-    thumbnail->clear();
+    // Points only exist once the background build is done; in-memory clips can
+    // still be drawn from their samples when zoomed in far enough
+    const auto peaks = getWaveformPeakStore().getPeaks(*audioClip);
+    const auto& buffer = audioClip->getAudioBuffer();
+    const auto* compact = audioClip->getCompactAudio().get();
+    const bool inMemory = !audioClip->isStreamed();
+    const auto length = compact != nullptr ? compact->getLengthInFrames() : static_cast<juce::int64>(buffer.getNumSamples());
+
+    const double framesPerPixel = static_cast<double>(endFrame - startFrame) / bounds.getWidth();
+    const bool fromSamples = inMemory && framesPerPixel < WaveformPeaks::BASE_REDUCTION;
+    if (!fromSamples && peaks == nullptr)
+        return;
 
-    if (audioClip && audioClip->hasAudio())
+    const int level = peaks != nullptr ? peaks->getLevelFor(framesPerPixel) : 0;
+    const int numChannels = juce::jmax(1, audioClip->getNumChannels());
+    const float laneHeight = static_cast<float>(bounds.getHeight()) / numChannels;
+
+    // Only the columns being repainted
+    const auto visible = g.getClipBounds().getIntersection(bounds);
+    const auto outline = waveformColour.withMultipliedAlpha(0.6f);
+
+    for (int ch = 0; ch < numChannels; ++ch)
     {
-        const auto& buffer = audioClip->getAudioBuffer();
-        double sampleRate = audioClip->getSampleRate();
+        const float centreY = bounds.getY() + laneHeight * (ch + 0.5f);
+        const float halfHeight = laneHeight * 0.45f;
 
-        if (buffer.getNumSamples() > 0 && sampleRate > 0)
+        for (int x = visible.getX(); x < visible.getRight(); ++x)
         {
-            // Set the thumbnail from the audio buffer
-            thumbnail->reset(buffer.getNumChannels(), sampleRate, buffer.getNumSamples());
-            thumbnail->addBlock(0, buffer, 0, buffer.getNumSamples());
+            const auto from = startFrame + static_cast<juce::int64>((x - bounds.getX()) * framesPerPixel);
+            const auto to = juce::jmax(from + 1, startFrame + static_cast<juce::int64>((x - bounds.getX() + 1) * framesPerPixel));
+
+            WaveformPeaks::Point point;
+            if (fromSamples)
+            {
+                const auto first = juce::jmin(from, length - 1);
+                const int n = static_cast<int>(juce::jmin(to, length, first + WaveformPeaks::BASE_REDUCTION) - first);
+                if (first < 0 || n <= 0)
+                    continue;
+
+                // Compact clips decode just the pixel's frames
+                float decoded[WaveformPeaks::BASE_REDUCTION];
+                const float* data = decoded;
+                if (compact != nullptr)
+                    compact->readChannel(juce::jmin(ch, compact->getNumChannels() - 1), decoded, first, n);
+                else
+                    data = buffer.getReadPointer(juce::jmin(ch, buffer.getNumChannels() - 1), static_cast<int>(first));
+
+                const auto range = juce::FloatVectorOperations::findMinAndMax(data, n);
+                float sumOfSquares = 0.0f;
+                for (int i = 0; i < n; ++i)
+                    sumOfSquares += data[i] * data[i];
+
+                point = { range.getStart(), range.getEnd(), std::sqrt(sumOfSquares / static_cast<float>(n)) };
+            }
+            else
+            {
+                point = peaks->getRange(level, juce::jmin(ch, peaks->getNumChannels() - 1), from, to);
+            }
+
+            const float top = centreY - juce::jlimit(-1.0f, 1.0f, point.max) * halfHeight;
+            const float bottom = centreY - juce::jlimit(-1.0f, 1.0f, point.min) * halfHeight;
+            const float rms = juce::jmin(1.0f, point.rms) * halfHeight;
+
+            g.setColour(outline);
+            g.drawVerticalLine(x, top, juce::jmax(bottom, top + 1.0f));
+
+            g.setColour(waveformColour);
+            g.drawVerticalLine(x, juce::jmax(top, centreY - rms), juce::jmin(bottom, centreY + rms) + 1.0f);
         }
     }
 }
@@ -1,19 +1,19 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
-#include <juce_audio_utils/juce_audio_utils.h>
 #include "../../Audio/AudioClip.h"
-#include "../../Audio/AudioFileLoader.h"
+#include "../../Audio/WaveformPeakStore.h"
 
 /**
  * WaveformComponent - Displays audio waveform visualization
  *
  * Features:
- * - Renders waveform from AudioClip data
- * - Supports zoom levels
+ * - Renders the clip's trimmed audio, one lane per channel, as min/max with RMS
+ * - Draws from the source's peak pyramid in the WaveformPeakStore (shared with
+ *   every other view of the same audio), so a repaint costs O(visible pixels)
+ *   at any zoom; closer in than one pyramid point per pixel, in-memory clips
+ *   are drawn from the samples themselves
  * - Shows clip name overlay
- * - Handles resizing efficiently
- * - Caches waveform for performance
  */
 class WaveformComponent : public juce::Component,
                           private juce::ChangeListener
@@ -72,10 +72,6 @@ private:
     // Audio clip reference
     AudioClip* audioClip = nullptr;
 
-    // Thumbnail for efficient waveform rendering
-    juce::AudioThumbnailCache thumbnailCache{5};
-    std::unique_ptr<juce::AudioThumbnail> thumbnail;
-
     // Display colors
     juce::Colour waveformColour{0xff3b82f6};  // Blue
     juce::Colour backgroundColour{juce::Colours::transparentBlack};
@@ -84,11 +80,10 @@ private:
     bool showName = true;
     double pixelsPerSecond = 100.0;
 
-    // ChangeListener for thumbnail updates
+    // Repaints when the store has built a pyramid
     void changeListenerCallback(juce::ChangeBroadcaster* source) override;
 
-    // Update thumbnail from clip data
-    void updateThumbnail();
+    void drawWaveform(juce::Graphics& g, juce::Rectangle<int> bounds);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformComponent)
 };
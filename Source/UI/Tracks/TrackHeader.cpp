@@ -56,7 +56,7 @@ TrackHeader::TrackHeader(Track& track)
     // Arm button (Record enable)
     armButton.setColour(juce::TextButton::buttonColourId, ProgFlowColours::surfaceBg());
     armButton.setColour(juce::TextButton::textColourOffId, ProgFlowColours::textSecondary());
-    armButton.setTooltip("Arm track for recording");
+    armButton.setTooltip("Arm track for recording (right-click the track for its audio input)");
     armButton.onClick = [this]() {
         this->track.setArmed(!this->track.isArmed());
         updateArmButtonAppearance();
@@ -142,12 +142,60 @@ void TrackHeader::timerCallback()
     meter.setLevel(track.getMeterLevel());
 }
 
-void TrackHeader::mouseDown(const juce::MouseEvent& /*event*/)
+void TrackHeader::mouseDown(const juce::MouseEvent& event)
 {
+    if (event.mods.isPopupMenu())
+    {
+        showInputMenu();
+        return;
+    }
+
     if (onTrackSelected)
         onTrackSelected(track);
 }
 
+void TrackHeader::showInputMenu()
+{
+    // Inputs the device doesn't have record silence, so all of them are offered
+    constexpr int maxInputs = 64;
+    enum MenuItems { NoInput = 1, MonitorInput, FirstMono = 100, FirstStereo = 200 };
+
+    const int firstChannel = track.getFirstInputChannel();
+    const bool stereo = track.getNumInputChannels() > 1;
+
+    juce::PopupMenu monoMenu, stereoMenu;
+    for (int ch = 0; ch < maxInputs; ++ch)
+        monoMenu.addItem(FirstMono + ch, "Input " + juce::String(ch + 1), true, !stereo && firstChannel == ch);
+    for (int ch = 0; ch + 1 < maxInputs; ch += 2)
+        stereoMenu.addItem(FirstStereo + ch, "Inputs " + juce::String(ch + 1) + "/" + juce::String(ch + 2),
+                           true, stereo && firstChannel == ch);
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader("Audio Input");
+    menu.addItem(NoInput, "None", true, firstChannel < 0);
+    menu.addSubMenu("Mono", monoMenu, true, juce::Image(), !stereo && firstChannel >= 0);
+    menu.addSubMenu("Stereo", stereoMenu, true, juce::Image(), stereo && firstChannel >= 0);
+    menu.addSeparator();
+    menu.addItem(MonitorInput, "Monitor Input While Armed", track.hasAudioInput(), track.isInputMonitoring());
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&armButton),
+        [safeThis = juce::Component::SafePointer<TrackHeader>(this)](int result)
+        {
+            if (safeThis == nullptr || result == 0)
+                return;
+
+            auto& track = safeThis->track;
+            if (result == NoInput)
+                track.setInputChannels(-1, 1);
+            else if (result == MonitorInput)
+                track.setInputMonitoring(!track.isInputMonitoring());
+            else if (result >= FirstStereo)
+                track.setInputChannels(result - FirstStereo, 2);
+            else if (result >= FirstMono)
+                track.setInputChannels(result - FirstMono, 1);
+        });
+}
+
 void TrackHeader::paint(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().reduced(2);
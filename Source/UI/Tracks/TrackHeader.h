@@ -73,5 +73,8 @@ private:
     void updateArmButtonAppearance();
     void updateAutoButtonAppearance();
 
+    // Right-click: which device inputs the track records, and monitoring
+    void showInputMenu();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackHeader)
 };
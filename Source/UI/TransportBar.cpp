@@ -138,6 +138,12 @@ TransportBar::TransportBar(AudioEngine& engine)
     cpuLabel.setFont(juce::Font(10.0f));
     addAndMakeVisible(cpuLabel);
 
+    // Memory label (same style as the CPU meter)
+    memoryLabel.setColour(juce::Label::textColourId, ProgFlowColours::textMuted());
+    memoryLabel.setJustificationType(juce::Justification::centredRight);
+    memoryLabel.setFont(juce::Font(10.0f));
+    addAndMakeVisible(memoryLabel);
+
     // Home button (back to project selection)
     homeButton.setButtonText(juce::String::fromUTF8("⌂"));
     homeButton.setColour(juce::TextButton::buttonColourId, ProgFlowColours::surfaceBg());
@@ -351,6 +357,7 @@ void TransportBar::resized()
 
     // CPU label
     cpuLabel.setBounds(bounds.removeFromRight(60));
+    memoryLabel.setBounds(bounds.removeFromRight(70));
 }
 
 void TransportBar::timerCallback()
@@ -407,6 +414,12 @@ void TransportBar::timerCallback()
         cpuLabel.setColour(juce::Label::textColourId, cpuColour);
     }
 
+    if (--memoryRefreshCountdown <= 0)
+    {
+        memoryRefreshCountdown = MEMORY_REFRESH_FRAMES;
+        updateMemoryDisplay();
+    }
+
     // Update play button state to sync with engine
     bool isPlaying = audioEngine.isPlaying();
     if (playButton.getToggleState() != isPlaying)
@@ -417,6 +430,27 @@ void TransportBar::timerCallback()
     repaint();
 }
 
+void TransportBar::updateMemoryDisplay()
+{
+    const auto usage = audioEngine.getAudioMemoryUsage();
+    constexpr double megabyte = 1024.0 * 1024.0;
+
+    memoryLabel.setText("RAM " + juce::String(juce::roundToInt(usage.clipBytes / megabyte)) + " MB",
+                        juce::dontSendNotification);
+
+    juce::String tooltip;
+    tooltip << "Project audio: " << juce::String(usage.clipBytes / megabyte, 1) << " MB in "
+            << usage.numSources << " sources";
+    if (usage.numCompactSources > 0)
+        tooltip << " (" << juce::String(usage.floatBytes / megabyte, 1) << " MB as floats; "
+                << usage.numCompactSources << " held compactly)";
+    if (usage.numStreamedSources > 0)
+        tooltip << "\n" << usage.numStreamedSources << " streamed from disk";
+    if (usage.warpRenderBytes > 0)
+        tooltip << "\nWarp renders: " << juce::String(usage.warpRenderBytes / megabyte, 1) << " MB";
+    memoryLabel.setTooltip(tooltip);
+}
+
 void TransportBar::playClicked()
 {
     if (audioEngine.isPlaying())
@@ -485,7 +519,7 @@ void TransportBar::tapTempoClicked()
 
 void TransportBar::updatePositionDisplay()
 {
-    double positionInBeats = audioEngine.getPositionInBeats();
+    double positionInBeats = audioEngine.getAudiblePositionInBeats();
 
     auto timeSig = audioEngine.getCurrentTimeSignature();
     int beatsPerBar = timeSig.numerator;
@@ -15,6 +15,7 @@
  * - Metronome toggle
  * - Loop toggle
  * - CPU meter
+ * - Memory held by the project's audio
  */
 class TransportBar : public juce::Component,
                      private juce::Timer
@@ -102,6 +103,12 @@ private:
     float cpuUsage = 0.0f;
     juce::Label cpuLabel{"cpuLabel", "CPU: 0%"};
 
+    // Project audio memory (walks every clip, so refreshed about once a second)
+    juce::Label memoryLabel{"memoryLabel", "RAM 0 MB"};
+    int memoryRefreshCountdown = 0;
+    static constexpr int MEMORY_REFRESH_FRAMES = 60;
+    void updateMemoryDisplay();
+
     // Home button (back to project selection)
     juce::TextButton homeButton;
 
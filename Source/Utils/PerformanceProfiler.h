@@ -17,6 +17,10 @@
  *   // ... code ...
  *   PerformanceProfiler::getInstance().endSection("ProcessSynth");
  *
+ * Work measured by its own threads (e.g. several import workers at once)
+ * reports through recordTime() and recordThroughput() instead, which don't
+ * share a start time per section.
+ *
  * Statistics are thread-safe and can be read from UI thread.
  */
 
@@ -40,6 +44,7 @@ class PerformanceProfiler
 public:
     static constexpr int MAX_SECTIONS = 32;
     static constexpr int HISTORY_SIZE = 256;  // Keep last N measurements
+    static constexpr int MAX_THROUGHPUTS = 16;
 
     struct SectionStats
     {
@@ -97,6 +102,43 @@ public:
         }
     }
 
+    //==========================================================================
+    // Measured by the caller (safe from several threads at once)
+
+    /** Add one elapsed time to a section */
+    void recordTime(const char* name, double elapsedUs)
+    {
+        int idx = getSectionIndex(name);
+        if (idx >= 0)
+            recordMeasurement(idx, elapsedUs);
+    }
+
+    /** Add amount of work (frames, bytes...) done over elapsedSeconds of wall time */
+    void recordThroughput(const char* name, double amount, double elapsedSeconds)
+    {
+        int idx = getThroughputIndex(name);
+        if (idx >= 0 && elapsedSeconds > 0.0)
+        {
+            auto& t = throughputs[idx];
+            juce::SpinLock::ScopedLockType lock(sectionLock);
+            t.amount.store(t.amount.load() + amount);
+            t.seconds.store(t.seconds.load() + elapsedSeconds);
+            t.lastRate.store(amount / elapsedSeconds);
+        }
+    }
+
+    /** Overall amount per second recorded for name (0 if none) */
+    double getThroughput(const char* name) const
+    {
+        for (int i = 0; i < numThroughputs.load(); ++i)
+        {
+            const auto& t = throughputs[i];
+            if (t.name == name)
+                return t.seconds.load() > 0.0 ? t.amount.load() / t.seconds.load() : 0.0;
+        }
+        return 0.0;
+    }
+
     //==========================================================================
     // Statistics access (thread-safe, call from UI thread)
 
@@ -113,6 +155,8 @@ public:
     {
         for (int i = 0; i < numSections.load(); ++i)
             sections[i].reset();
+        for (int i = 0; i < numThroughputs.load(); ++i)
+            throughputs[i].reset();
     }
 
     //==========================================================================
@@ -138,6 +182,20 @@ public:
             }
         }
 
+        for (int i = 0; i < numThroughputs.load(); ++i)
+        {
+            const auto& t = throughputs[i];
+            if (t.seconds.load() > 0.0)
+            {
+                report += juce::String::formatted(
+                    "%-30s  avg: %12.0f /s  last: %12.0f /s\n",
+                    t.name.c_str(),
+                    t.amount.load() / t.seconds.load(),
+                    t.lastRate.load()
+                );
+            }
+        }
+
         return report;
     }
 
@@ -164,7 +222,24 @@ public:
 private:
     PerformanceProfiler() = default;
 
+    struct ThroughputStats
+    {
+        std::string name;
+        std::atomic<double> amount{0.0};
+        std::atomic<double> seconds{0.0};
+        std::atomic<double> lastRate{0.0};
+
+        void reset()
+        {
+            amount.store(0.0);
+            seconds.store(0.0);
+            lastRate.store(0.0);
+        }
+    };
+
     std::array<SectionStats, MAX_SECTIONS> sections;
+    std::array<ThroughputStats, MAX_THROUGHPUTS> throughputs;
+    std::atomic<int> numThroughputs{0};
     std::array<juce::int64, MAX_SECTIONS> sectionStartTimes{};
     std::atomic<int> numSections{0};
     juce::SpinLock sectionLock;
@@ -201,6 +276,34 @@ private:
         return -1;  // Too many sections
     }
 
+    int getThroughputIndex(const char* name)
+    {
+        for (int i = 0; i < numThroughputs.load(); ++i)
+        {
+            if (throughputs[i].name == name)
+                return i;
+        }
+
+        juce::SpinLock::ScopedLockType lock(sectionLock);
+
+        for (int i = 0; i < numThroughputs.load(); ++i)
+        {
+            if (throughputs[i].name == name)
+                return i;
+        }
+
+        int newIdx = numThroughputs.load();
+        if (newIdx < MAX_THROUGHPUTS)
+        {
+            throughputs[newIdx].name = name;
+            throughputs[newIdx].reset();
+            numThroughputs.store(newIdx + 1);
+            return newIdx;
+        }
+
+        return -1;
+    }
+
     void recordMeasurement(int idx, double timeUs)
     {
         auto& s = sections[idx];
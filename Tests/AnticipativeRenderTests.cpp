@@ -0,0 +1,395 @@
+/**
+ * Anticipative Render Unit Tests - Rendering tracks ahead of the playhead
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/TrackPrerenderer.h"
+#include "../Source/Audio/AudioEngine.h"
+#include "../Source/Audio/Effects/ChorusEffect.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+/** Passes audio through, but holds whoever is rendering while stall is set */
+class StallEffect : public EffectBase
+{
+public:
+    StallEffect(std::atomic<bool>& stallToWatch, std::atomic<bool>& stalledFlag)
+        : stall(stallToWatch), stalled(stalledFlag) {}
+
+    juce::String getName() const override { return "Stall"; }
+
+protected:
+    void processEffect(juce::AudioBuffer<float>&) override
+    {
+        while (stall.load())
+        {
+            stalled.store(true);
+            juce::Thread::sleep(1);
+        }
+    }
+
+private:
+    std::atomic<bool>& stall;
+    std::atomic<bool>& stalled;
+};
+
+class AnticipativeRenderTests : public juce::UnitTest
+{
+public:
+    AnticipativeRenderTests() : UnitTest("Anticipative Rendering") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+        constexpr double beatsPerBlock = blockSize * 2.0 / sampleRate;  // At 120 BPM
+
+        TempoTrack tempoTrack;
+        tempoTrack.setInitialTempo(120.0);
+        TimeSignatureTrack timeSignatureTrack;
+
+        //======================================================================
+        beginTest("Rendered-ahead audio matches rendering at the playhead");
+        {
+            for (int numThreads : { 0, 2 })
+            {
+                auto live = makeRampTrack(sampleRate);
+                auto ahead = makeRampTrack(sampleRate);
+
+                TrackPrerenderer prerenderer(tempoTrack, timeSignatureTrack);
+                prerenderer.setNumThreads(numThreads);
+                prerenderer.prepare(sampleRate);
+                prerenderer.setTracks({ ahead.get() });
+
+                juce::AudioBuffer<float> expected(2, blockSize), actual(2, blockSize);
+                float largestError = 0.0f;
+
+                for (int block = 0; block < 100; ++block)
+                {
+                    const double beat = block * beatsPerBlock;
+
+                    expected.clear();
+                    live->renderInserts(expected, blockSize, beat, 120.0);
+
+                    const int underruns = prerenderer.getUnderrunCount();
+                    prerenderer.beginBlock(false, 0.0, 0.0);
+                    prerenderer.syncTrack(0, true, beat, 120.0);
+                    expect(prerenderer.isRenderingAhead(0));
+                    prerenderer.read(0, actual, blockSize);
+
+                    // A block a busy worker made silent is counted, and isn't the audio we're after
+                    if (prerenderer.getUnderrunCount() == underruns)
+                        largestError = std::max(largestError, maxDifference(expected, actual, blockSize));
+
+                    // Give the workers time to get ahead
+                    if (numThreads > 0 && block % 10 == 0)
+                        juce::Thread::sleep(20);
+                }
+
+                // Chunk and block boundaries may round a clip's start a sample apart
+                expectLessThan(largestError, 1.0e-3f);
+            }
+        }
+
+        beginTest("Seeking re-syncs the stream to the playhead");
+        {
+            auto live = makeRampTrack(sampleRate);
+            auto ahead = makeRampTrack(sampleRate);
+
+            TrackPrerenderer prerenderer(tempoTrack, timeSignatureTrack);
+            prerenderer.setNumThreads(1);
+            prerenderer.prepare(sampleRate);
+            prerenderer.setTracks({ ahead.get() });
+
+            juce::AudioBuffer<float> expected(2, blockSize), actual(2, blockSize);
+            for (int block = 0; block < 5; ++block)
+            {
+                prerenderer.beginBlock(false, 0.0, 0.0);
+                prerenderer.syncTrack(0, true, block * beatsPerBlock, 120.0);
+                prerenderer.read(0, actual, blockSize);
+            }
+            juce::Thread::sleep(50);
+
+            // Jump back into the clip: what was rendered ahead no longer applies
+            prerenderer.beginBlock(false, 0.0, 0.0);
+            prerenderer.syncTrack(0, true, 0.5, 120.0);
+            prerenderer.read(0, actual, blockSize);
+
+            expected.clear();
+            live->renderInserts(expected, blockSize, 0.5, 120.0);
+            expectLessThan(maxDifference(expected, actual, blockSize), 1.0e-3f);
+        }
+
+        beginTest("Streams follow the loop");
+        {
+            auto live = makeRampTrack(sampleRate);
+            auto ahead = makeRampTrack(sampleRate);
+
+            TrackPrerenderer prerenderer(tempoTrack, timeSignatureTrack);
+            prerenderer.setNumThreads(1);
+            prerenderer.prepare(sampleRate);
+            prerenderer.setTracks({ ahead.get() });
+
+            // A loop of 10.5 blocks, so the wrap falls inside one
+            const double loopEnd = 10.5 * beatsPerBlock;
+            juce::AudioBuffer<float> expected(2, blockSize), actual(2, blockSize);
+            double beat = 0.0;
+            float largestError = 0.0f;
+
+            for (int block = 0; block < 40; ++block)
+            {
+                const int underruns = prerenderer.getUnderrunCount();
+                prerenderer.beginBlock(true, 0.0, loopEnd);
+                prerenderer.syncTrack(0, true, beat, 120.0);
+                prerenderer.read(0, actual, blockSize);
+
+                // The playhead plays the wrap in two parts
+                expected.clear();
+                const int beforeWrap = std::min(blockSize, static_cast<int>(std::ceil((loopEnd - beat) / (beatsPerBlock / blockSize))));
+                juce::AudioBuffer<float> first(expected.getArrayOfWritePointers(), 2, 0, beforeWrap);
+                live->renderInserts(first, beforeWrap, beat, 120.0);
+                if (beforeWrap < blockSize)
+                {
+                    juce::AudioBuffer<float> second(expected.getArrayOfWritePointers(), 2, beforeWrap, blockSize - beforeWrap);
+                    live->renderInserts(second, blockSize - beforeWrap, 0.0, 120.0);
+                }
+
+                if (prerenderer.getUnderrunCount() == underruns)
+                    largestError = std::max(largestError, maxDifference(expected, actual, blockSize));
+
+                beat += beatsPerBlock;
+                if (beat >= loopEnd)
+                    beat = std::fmod(beat, loopEnd);
+
+                if (block % 8 == 0)
+                    juce::Thread::sleep(10);
+            }
+
+            expectLessThan(largestError, 1.0e-3f);
+        }
+
+        beginTest("Invalidating picks up an edit at once");
+        {
+            auto ahead = makeRampTrack(sampleRate);
+
+            TrackPrerenderer prerenderer(tempoTrack, timeSignatureTrack);
+            prerenderer.setNumThreads(1);
+            prerenderer.prepare(sampleRate);
+            prerenderer.setTracks({ ahead.get() });
+
+            juce::AudioBuffer<float> actual(2, blockSize);
+            prerenderer.beginBlock(false, 0.0, 0.0);
+            prerenderer.syncTrack(0, true, 0.0, 120.0);
+            prerenderer.read(0, actual, blockSize);
+            juce::Thread::sleep(50);
+
+            ahead->getAudioClips()[0]->setGain(0.0f);
+            prerenderer.invalidate(0);
+
+            prerenderer.beginBlock(false, 0.0, 0.0);
+            prerenderer.syncTrack(0, true, beatsPerBlock, 120.0);
+            prerenderer.read(0, actual, blockSize);
+            expectEquals(actual.getMagnitude(0, blockSize), 0.0f);
+        }
+
+        beginTest("An underrun doesn't wait for the worker holding the track");
+        {
+            auto live = makeRampTrack(sampleRate);
+            auto ahead = makeRampTrack(sampleRate);
+            std::atomic<bool> stall{false}, stalled{false};
+            ahead->getEffectChain().addEffect(std::make_unique<StallEffect>(stall, stalled));
+
+            TrackPrerenderer prerenderer(tempoTrack, timeSignatureTrack);
+            prerenderer.setNumThreads(1);
+            prerenderer.prepare(sampleRate);
+            prerenderer.setTracks({ ahead.get() });
+
+            // The block after a re-sync is the audio thread's
+            juce::AudioBuffer<float> expected(2, blockSize), actual(2, blockSize);
+            prerenderer.beginBlock(false, 0.0, 0.0);
+            prerenderer.syncTrack(0, true, 0.0, 120.0);
+            prerenderer.read(0, actual, blockSize);
+
+            // Then the worker takes the track and holds it
+            stall.store(true);
+            prerenderer.beginBlock(false, 0.0, 0.0);
+            for (int waited = 0; !stalled.load() && waited < 1000; ++waited)
+                juce::Thread::sleep(1);
+            expect(stalled.load());
+
+            std::thread release([&stall] { juce::Thread::sleep(200); stall.store(false); });
+
+            const auto started = juce::Time::getMillisecondCounterHiRes();
+            prerenderer.syncTrack(0, true, beatsPerBlock, 120.0);
+            prerenderer.read(0, actual, blockSize);
+            const auto elapsed = juce::Time::getMillisecondCounterHiRes() - started;
+            release.join();
+
+            expectLessThan(elapsed, 100.0);
+            expectEquals(prerenderer.getUnderrunCount(), 1);
+            expectEquals(actual.getMagnitude(0, blockSize), 0.0f);
+
+            // Once the worker lets go, the stream is back on the playhead
+            juce::Thread::sleep(50);
+            prerenderer.beginBlock(false, 0.0, 0.0);
+            prerenderer.syncTrack(0, true, 2.0 * beatsPerBlock, 120.0);
+            prerenderer.read(0, actual, blockSize);
+
+            expected.clear();
+            live->renderInserts(expected, blockSize, 2.0 * beatsPerBlock, 120.0);
+            expectLessThan(maxDifference(expected, actual, blockSize), 1.0e-3f);
+            expectEquals(prerenderer.getUnderrunCount(), 1);
+        }
+
+        //======================================================================
+        beginTest("Render version follows edits but not the mix");
+        {
+            Track track("Versioned");
+            track.prepareToPlay(sampleRate, blockSize);
+            auto* clip = track.addClip(0.0, 1.0);
+            track.getEffectChain().addEffect(std::make_unique<ChorusEffect>());
+
+            auto version = track.getRenderVersion();
+            track.setVolume(0.5f);
+            track.setPan(-0.5f);
+            expectEquals(track.getRenderVersion(), version);
+
+            clip->addNote(60, 0.0, 1.0, 0.8f);
+            expect(track.getRenderVersion() != version);
+
+            version = track.getRenderVersion();
+            track.getEffectChain().getEffect(0)->setParameter("rate", 2.0f);
+            expect(track.getRenderVersion() != version);
+
+            version = track.getRenderVersion();
+            track.getSynth()->setParameter("filter_cutoff", 800.0f);
+            expect(track.getRenderVersion() != version);
+        }
+
+        beginTest("Render version changes when an edited clip is removed");
+        {
+            Track track("Removals");
+            track.prepareToPlay(sampleRate, blockSize);
+            track.addClip(0.0, 1.0)->addNote(60, 0.0, 1.0, 0.8f);
+            auto* removed = track.addClip(1.0, 1.0);
+            removed->addNote(64, 0.0, 1.0, 0.8f);
+
+            // The removal bumps the track by one and takes the clip's edit
+            // with it - a sum of the counters would come out the same
+            auto version = track.getRenderVersion();
+            track.removeClip(removed->getId());
+            expect(track.getRenderVersion() != version);
+
+            version = track.getRenderVersion();
+            track.getEffectChain().addEffect(std::make_unique<ChorusEffect>());
+            track.getEffectChain().getEffect(0)->setParameter("rate", 2.0f);
+            const auto edited = track.getRenderVersion();
+            expect(edited != version);
+
+            track.getEffectChain().removeEffect(0);
+            expect(track.getRenderVersion() != edited);
+        }
+
+        //======================================================================
+        beginTest("Engine renders ahead only the tracks nobody plays live");
+        {
+            AudioEngine engine;
+            engine.prepareToPlay(blockSize, sampleRate);
+            engine.addTrack(std::make_unique<Track>("Keyboard"));
+            engine.addTrack(std::make_unique<Track>("Armed"));
+            engine.addTrack(std::make_unique<Track>("Clips"));
+            engine.addTrack(std::make_unique<Track>("Muted"));
+            engine.getTrack(1)->setArmed(true);
+            engine.getTrack(3)->setMuted(true);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::AudioSourceChannelInfo info(&buffer, 0, blockSize);
+
+            engine.getNextAudioBlock(info);
+            expect(!engine.isTrackRenderedAhead(2));  // Stopped
+
+            engine.play();
+            engine.getNextAudioBlock(info);
+            expect(!engine.isTrackRenderedAhead(0));
+            expect(!engine.isTrackRenderedAhead(1));
+            expect(engine.isTrackRenderedAhead(2));
+            expect(!engine.isTrackRenderedAhead(3));
+
+            engine.setKeyboardTrackIndex(2);
+            engine.getNextAudioBlock(info);
+            expect(engine.isTrackRenderedAhead(0));
+            expect(!engine.isTrackRenderedAhead(2));
+
+            engine.setAnticipativeRendering(false);
+            engine.getNextAudioBlock(info);
+            expect(!engine.isTrackRenderedAhead(0));
+            engine.stop();
+        }
+
+        beginTest("Engine output is the same with and without rendering ahead");
+        {
+            AudioEngine live, ahead;
+            live.setAnticipativeRendering(false);
+
+            for (auto* engine : { &live, &ahead })
+            {
+                engine->prepareToPlay(blockSize, sampleRate);
+                engine->addTrack(std::make_unique<Track>("Keyboard"));
+                engine->addTrack(makeRampTrack(sampleRate));
+                engine->play();
+            }
+
+            juce::AudioBuffer<float> expected(2, blockSize), actual(2, blockSize);
+            float largestError = 0.0f;
+
+            for (int block = 0; block < 60; ++block)
+            {
+                juce::AudioSourceChannelInfo liveInfo(&expected, 0, blockSize);
+                juce::AudioSourceChannelInfo aheadInfo(&actual, 0, blockSize);
+                const int underruns = ahead.getPrerenderUnderrunCount();
+                live.getNextAudioBlock(liveInfo);
+                ahead.getNextAudioBlock(aheadInfo);
+
+                if (ahead.getPrerenderUnderrunCount() == underruns)
+                    largestError = std::max(largestError, maxDifference(expected, actual, blockSize));
+            }
+
+            expect(ahead.isTrackRenderedAhead(1));
+            expectLessThan(largestError, 1.0e-3f);
+        }
+    }
+
+private:
+    // A track playing a one-second ramp, so any misplaced sample shows
+    static std::unique_ptr<Track> makeRampTrack(double sampleRate)
+    {
+        auto track = std::make_unique<Track>("Ramp");
+        track->prepareToPlay(sampleRate, TrackPrerenderer::CHUNK_SIZE);
+
+        const int length = static_cast<int>(sampleRate);
+        juce::AudioBuffer<float> ramp(2, length);
+        for (int i = 0; i < length; ++i)
+        {
+            ramp.setSample(0, i, static_cast<float>(i) / length);
+            ramp.setSample(1, i, -static_cast<float>(i) / length);
+        }
+
+        track->addAudioClip(0.0)->setAudioBuffer(std::move(ramp), sampleRate);
+        return track;
+    }
+
+    static float maxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b, int numSamples)
+    {
+        float largest = 0.0f;
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                largest = std::max(largest, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+        return largest;
+    }
+};
+
+// Register the test
+static AnticipativeRenderTests anticipativeRenderTests;
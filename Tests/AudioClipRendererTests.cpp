@@ -0,0 +1,174 @@
+/**
+ * AudioClipRenderer Unit Tests - Block rendering of a track's audio clips
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/AudioClipRenderer.h"
+#include "TestHelpers.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class AudioClipRendererTests : public juce::UnitTest
+{
+public:
+    AudioClipRendererTests() : UnitTest("AudioClipRenderer") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr double bpm = 120.0;
+        constexpr double samplesPerBeat = sampleRate * 60.0 / bpm;
+        constexpr int blockSize = 512;
+
+        //======================================================================
+        beginTest("Unity-rate clip plays its samples, gained and sample-aligned");
+        {
+            std::vector<std::unique_ptr<AudioClip>> clips;
+            auto* clip = addClip(clips, makeCounter(2, 4000), sampleRate, 0.5);
+            clip->setGain(0.5f);
+            clip->setTrimStartSample(100);
+
+            auto output = TestHelpers::renderBlocks(clips, sampleRate, 20000, bpm, false, Resampler::Quality::Hermite, blockSize);
+
+            // The clip starts at sample 11025 with source frame 100
+            const int start = static_cast<int>(0.5 * samplesPerBeat);
+            expectEquals(output.getMagnitude(0, start), 0.0f);
+            for (int i = 0; i < 3900; i += 37)
+            {
+                expectEquals(output.getSample(0, start + i), 0.5f * (100 + i));
+                expectEquals(output.getSample(1, start + i), -0.5f * (100 + i));
+            }
+            expectEquals(output.getMagnitude(start + 3900, 20000 - start - 3900), 0.0f);
+        }
+
+        beginTest("Fades ramp the gain at the trimmed edges");
+        {
+            std::vector<std::unique_ptr<AudioClip>> clips;
+            juce::AudioBuffer<float> ones(1, 10000);
+            juce::FloatVectorOperations::fill(ones.getWritePointer(0), 1.0f, 10000);
+
+            auto* clip = addClip(clips, std::move(ones), sampleRate, 0.0);
+            clip->setTrimEndSample(8000);
+            clip->setFadeInSamples(1000);
+            clip->setFadeOutSamples(2000);
+
+            auto output = TestHelpers::renderBlocks(clips, sampleRate, 10000, bpm, false, Resampler::Quality::Hermite, blockSize);
+
+            expectEquals(output.getSample(0, 0), 0.0f);
+            expectWithinAbsoluteError(output.getSample(0, 500), 0.5f, 1.0e-6f);
+            expectEquals(output.getSample(0, 3000), 1.0f);
+            expectWithinAbsoluteError(output.getSample(0, 7000), 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError(output.getSample(0, 7999), 1.0f / 2000.0f, 1.0e-6f);
+            expectEquals(output.getSample(0, 8000), 0.0f);
+
+            // Mono clips play on both channels
+            expectEquals(output.getSample(1, 500), output.getSample(0, 500));
+        }
+
+        beginTest("Resampled clips play continuously across blocks");
+        {
+            for (double playbackRate : { 0.5, 1.3, 2.0 })
+            {
+                std::vector<std::unique_ptr<AudioClip>> clips;
+                juce::AudioBuffer<float> sine(1, 40000);
+                for (int i = 0; i < 40000; ++i)
+                    sine.setSample(0, i, static_cast<float>(std::sin(0.01 * i)));
+
+                auto* clip = addClip(clips, std::move(sine), 48000.0, 0.25);
+                clip->setPlaybackRate(playbackRate);
+
+                // Small blocks and one big one must agree on every sample
+                auto blocks = TestHelpers::renderBlocks(clips, sampleRate, 30000, bpm, false, Resampler::Quality::Hermite, 256);
+                auto whole = TestHelpers::renderBlocks(clips, sampleRate, 30000, bpm, false, Resampler::Quality::Hermite, 30000);
+
+                float largestError = 0.0f;
+                for (int i = 0; i < 30000; ++i)
+                    largestError = std::max(largestError, std::abs(blocks.getSample(0, i) - whole.getSample(0, i)));
+                expectLessThan(largestError, 1.0e-4f);
+
+                // Still the source's tone, played at the clip's rate
+                const int start = static_cast<int>(std::ceil(0.25 * samplesPerBeat));
+                const double increment = 48000.0 / sampleRate * playbackRate;
+                expectWithinAbsoluteError(blocks.getSample(0, start + 1000),
+                                          static_cast<float>(std::sin(0.01 * (1000 + start - 0.25 * samplesPerBeat) * increment)),
+                                          1.0e-2f);
+            }
+        }
+
+        //======================================================================
+        beginTest("Only the clips a block overlaps play, and edits are picked up");
+        {
+            std::vector<std::unique_ptr<AudioClip>> clips;
+
+            // 500 clips of 1000 samples holding their own index, every half beat
+            for (int c = 0; c < 500; ++c)
+            {
+                juce::AudioBuffer<float> constant(1, 1000);
+                juce::FloatVectorOperations::fill(constant.getWritePointer(0), static_cast<float>(c + 1), 1000);
+                addClip(clips, std::move(constant), sampleRate, c * 0.5);
+            }
+
+            AudioClipRenderer renderer;
+            renderer.prepare(sampleRate, blockSize);
+            juce::AudioBuffer<float> block(2, blockSize);
+
+            const int clipStart = static_cast<int>(300 * 0.5 * samplesPerBeat);
+            auto renderAt = [&](int sample)
+            {
+                block.clear();
+                renderer.render(clips, block, blockSize, sample / samplesPerBeat, bpm, Resampler::Quality::Hermite);
+            };
+
+            renderAt(clipStart);
+            expectEquals(block.getSample(0, 0), 301.0f);
+            expectEquals(block.getSample(0, 999 % blockSize), 301.0f);
+
+            // A long clip from the start reaches every later block
+            clips[0]->setStartBeat(0.0);
+            juce::AudioBuffer<float> longAudio(1, clipStart + blockSize);
+            juce::FloatVectorOperations::fill(longAudio.getWritePointer(0), 1000.0f, clipStart + blockSize);
+            clips[0]->setAudioBuffer(std::move(longAudio), sampleRate);
+
+            renderAt(clipStart);
+            expectEquals(block.getSample(0, 0), 1301.0f);
+
+            // Moving a clip away silences it
+            clips[300]->setStartBeat(1000.0);
+            renderAt(clipStart);
+            expectEquals(block.getSample(0, 0), 1000.0f);
+
+            clips.erase(clips.begin());
+            renderAt(clipStart);
+            expectEquals(block.getMagnitude(0, blockSize), 0.0f);
+        }
+    }
+
+private:
+    static AudioClip* addClip(std::vector<std::unique_ptr<AudioClip>>& clips, juce::AudioBuffer<float>&& audio,
+                              double sampleRate, double startBeat)
+    {
+        auto clip = std::make_unique<AudioClip>();
+        clip->setAudioBuffer(std::move(audio), sampleRate);
+        clip->setStartBeat(startBeat);
+        clips.push_back(std::move(clip));
+        return clips.back().get();
+    }
+
+    // Frame i holds i (left) and -i (right)
+    static juce::AudioBuffer<float> makeCounter(int numChannels, int length)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, length);
+        for (int i = 0; i < length; ++i)
+        {
+            buffer.setSample(0, i, static_cast<float>(i));
+            if (numChannels > 1)
+                buffer.setSample(1, i, -static_cast<float>(i));
+        }
+        return buffer;
+    }
+};
+
+// Register the test
+static AudioClipRendererTests audioClipRendererTests;
@@ -0,0 +1,152 @@
+/**
+ * AudioFileLoader Unit Tests - Sample rate conversion on import
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/AudioFileLoader.h"
+#include "TestHelpers.h"
+#include <algorithm>
+#include <cmath>
+
+class AudioFileLoaderTests : public juce::UnitTest
+{
+public:
+    AudioFileLoaderTests() : UnitTest("AudioFileLoader") {}
+
+    void runTest() override
+    {
+        constexpr double sourceRate = 44100.0;
+        constexpr double sessionRate = 48000.0;
+
+        auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                           .getChildFile("ProgFlowAudioFileLoaderTests");
+        tempDir.deleteRecursively();
+        tempDir.createDirectory();
+
+        // Ten seconds, so conversion runs across several decode chunks. A high
+        // tone on the left is where interpolation errors show most.
+        const int length = static_cast<int>(10 * sourceRate);
+        juce::AudioBuffer<float> audio(2, length);
+        for (int i = 0; i < length; ++i)
+        {
+            audio.setSample(0, i, tone(15000.0, i, sourceRate));
+            audio.setSample(1, i, tone(1000.0, i, sourceRate));
+        }
+
+        const auto file = tempDir.getChildFile("tones.wav");
+        expect(TestHelpers::writeAudioFile(file, audio, sourceRate));
+
+        const auto expectedLength = static_cast<juce::int64>(10 * sessionRate);
+
+        // Converted files persist in the pool's disk cache, which would answer
+        // every load after the first
+        auto& pool = getSamplePool();
+        const auto userCacheDirectory = pool.getDiskCacheDirectory();
+        pool.setDiskCacheDirectory(tempDir.getChildFile("cache"));
+
+        auto forgetDecodedData = [&pool]
+        {
+            pool.clear();
+            pool.clearDiskCache();
+        };
+
+        //======================================================================
+        beginTest("44.1 kHz files convert cleanly to 48 kHz");
+        {
+            forgetDecodedData();
+
+            AudioFileLoader loader;
+            loader.setNumResampleJobs(1);
+            expect(loader.getResampleQuality() == Resampler::Quality::Sinc);
+
+            auto clip = loader.loadFile(file, sessionRate);
+            expect(clip != nullptr);
+            expectEquals(clip->getSampleRate(), sessionRate);
+            expectEquals(clip->getDurationInSamples(), expectedLength);
+
+            expectLessThan(largestError(*clip, 0, 15000.0, sessionRate), 1.0e-3f);
+            expectLessThan(largestError(*clip, 1, 1000.0, sessionRate), 1.0e-3f);
+        }
+
+        beginTest("Lower qualities can be chosen and are audibly worse");
+        {
+            forgetDecodedData();
+
+            AudioFileLoader loader;
+            loader.setResampleQuality(Resampler::Quality::Linear);
+
+            auto clip = loader.loadFile(file, sessionRate);
+            expect(clip != nullptr);
+            expect(largestError(*clip, 0, 15000.0, sessionRate) > 0.05f);
+        }
+
+        beginTest("Converter threads give the same result as one thread");
+        {
+            forgetDecodedData();
+            AudioFileLoader single;
+            single.setNumResampleJobs(1);
+            auto expected = single.loadFile(file, sessionRate);
+
+            forgetDecodedData();
+            AudioFileLoader threaded;
+            threaded.setNumResampleJobs(6);
+
+            double lastProgress = 0.0;
+            bool progressIncreased = true;
+            auto actual = std::make_unique<AudioClip>();
+            expect(threaded.loadIntoClip(file, *actual, sessionRate, [&](double progress)
+            {
+                progressIncreased = progressIncreased && progress > lastProgress;
+                lastProgress = progress;
+                return true;
+            }));
+
+            expect(progressIncreased);
+            expectEquals(lastProgress, 1.0);
+            expectEquals(actual->getDurationInSamples(), expected->getDurationInSamples());
+
+            float difference = 0.0f;
+            for (int ch = 0; ch < 2; ++ch)
+                for (juce::int64 i = 0; i < expectedLength; ++i)
+                    difference = std::max(difference, std::abs(actual->getSample(ch, i) - expected->getSample(ch, i)));
+            expectLessThan(difference, 1.0e-5f);
+        }
+
+        beginTest("Conversion stops when the import is cancelled");
+        {
+            forgetDecodedData();
+
+            AudioFileLoader loader;
+            AudioClip clip;
+            int calls = 0;
+            expect(!loader.loadIntoClip(file, clip, sessionRate, [&](double) { return ++calls < 2; }));
+            expectEquals(calls, 2);
+            expect(!clip.hasAudio());
+        }
+
+        forgetDecodedData();
+        pool.setDiskCacheDirectory(userCacheDirectory);
+        tempDir.deleteRecursively();
+    }
+
+private:
+    static float tone(double frequency, juce::int64 frame, double sampleRate)
+    {
+        return 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency
+                                                  * static_cast<double>(frame) / sampleRate));
+    }
+
+    // Against the ideal tone, away from the ends where the file starts and stops abruptly
+    static float largestError(const AudioClip& clip, int channel, double frequency, double sampleRate)
+    {
+        float error = 0.0f;
+        for (juce::int64 i = 64; i < clip.getDurationInSamples() - 64; ++i)
+            error = std::max(error, std::abs(clip.getSample(channel, i) - tone(frequency, i, sampleRate)));
+        return error;
+    }
+};
+
+// Register the test
+static AudioFileLoaderTests audioFileLoaderTests;
@@ -0,0 +1,181 @@
+/**
+ * AudioFileStream Unit Tests - Memory-mapped and block-cached clip streaming
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/AudioFileStream.h"
+#include "../Source/Audio/AudioFileLoader.h"
+#include "../Source/Audio/AudioClipRenderer.h"
+#include "TestHelpers.h"
+#include <algorithm>
+#include <cmath>
+
+class AudioFileStreamTests : public juce::UnitTest
+{
+public:
+    AudioFileStreamTests() : UnitTest("AudioFileStream") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+
+        auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                           .getChildFile("ProgFlowAudioFileStreamTests");
+        tempDir.deleteRecursively();
+        tempDir.createDirectory();
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        // Ten seconds of a slow stereo sine, so any misplaced frame shows
+        const int length = static_cast<int>(10 * sampleRate);
+        juce::AudioBuffer<float> audio(2, length);
+        for (int i = 0; i < length; ++i)
+        {
+            audio.setSample(0, i, 0.5f * static_cast<float>(std::sin(0.001 * i)));
+            audio.setSample(1, i, 0.5f * static_cast<float>(std::cos(0.001 * i)));
+        }
+
+        const auto wavFile = tempDir.getChildFile("long.wav");
+        const auto flacFile = tempDir.getChildFile("long.flac");
+        TestHelpers::writeAudioFile<juce::WavAudioFormat>(wavFile, audio, sampleRate, 32);
+        TestHelpers::writeAudioFile<juce::FlacAudioFormat>(flacFile, audio, sampleRate, 16);
+
+        //======================================================================
+        beginTest("WAV files read straight from a memory map");
+        {
+            auto stream = AudioFileStream::open(wavFile, formats);
+            expect(stream != nullptr);
+            expect(stream->isMemoryMapped());
+            expectEquals(stream->getLengthInSamples(), static_cast<juce::int64>(length));
+            expectEquals(stream->getNumChannels(), 2);
+            expectEquals(stream->getNumResidentBlocks(), 0);
+
+            // Across the start and the end, which read as silence
+            juce::AudioBuffer<float> out(2, 1000);
+            for (juce::int64 start : { static_cast<juce::int64>(-300), static_cast<juce::int64>(200000),
+                                       static_cast<juce::int64>(length - 700) })
+            {
+                expect(stream->read(out.getArrayOfWritePointers(), 2, start, 1000));
+                for (int i = 0; i < 1000; ++i)
+                {
+                    const auto frame = start + i;
+                    const bool inside = frame >= 0 && frame < length;
+                    expectEquals(out.getSample(0, i), inside ? audio.getSample(0, static_cast<int>(frame)) : 0.0f);
+                    expectEquals(out.getSample(1, i), inside ? audio.getSample(1, static_cast<int>(frame)) : 0.0f);
+                }
+            }
+        }
+
+        beginTest("Compressed files decode around cues and the reader");
+        {
+            auto stream = AudioFileStream::open(flacFile, formats);
+            expect(stream != nullptr);
+            expect(!stream->isMemoryMapped());
+
+            // A seek cue is loaded in the background
+            const juce::int64 seekFrame = 3 * AudioFileStream::BLOCK_SIZE + 100;
+            stream->setCue(AudioFileStream::Cue::Seek, seekFrame);
+            expect(waitUntil([&] { return stream->isResident(seekFrame, 4096); }));
+
+            juce::AudioBuffer<float> streamed(2, 4096), decoded(2, 4096);
+            expect(stream->read(streamed.getArrayOfWritePointers(), 2, seekFrame, 4096));
+            expect(stream->readBlocking(decoded.getArrayOfWritePointers(), 2, seekFrame, 4096));
+            for (int i = 0; i < 4096; i += 17)
+                expectEquals(streamed.getSample(1, i), decoded.getSample(1, i));
+
+            // 16-bit, so close to the source rather than equal
+            expectWithinAbsoluteError(streamed.getSample(0, 0), audio.getSample(0, static_cast<int>(seekFrame)), 1.0e-4f);
+
+            // Jumping somewhere nobody cued plays silence until it catches up
+            const juce::int64 farFrame = 12 * AudioFileStream::BLOCK_SIZE;
+            stream->resetUnderrunCount();
+            expect(!stream->read(streamed.getArrayOfWritePointers(), 2, farFrame, 512));
+            expectEquals(streamed.getMagnitude(0, 512), 0.0f);
+            expectEquals(stream->getUnderrunCount(), 1);
+
+            expect(waitUntil([&] { return stream->isResident(farFrame, 512); }));
+            expect(stream->read(streamed.getArrayOfWritePointers(), 2, farFrame, 512));
+            expect(streamed.getMagnitude(0, 512) > 0.0f);
+
+            // Only the read-ahead and the cue stay resident
+            const int readAheadBlocks = static_cast<int>(AudioFileStream::READ_AHEAD_SECONDS * sampleRate)
+                                      / AudioFileStream::BLOCK_SIZE + 2;
+            expect(waitUntil([&] { return stream->getNumResidentBlocks() <= readAheadBlocks + 2; }));
+            expect(stream->isResident(seekFrame, 4096));
+        }
+
+        //======================================================================
+        beginTest("Loader streams files above the threshold");
+        {
+            AudioFileLoader loader;
+            auto decoded = loader.loadFile(wavFile);
+            expect(decoded != nullptr);
+            expect(!decoded->isStreamed());
+
+            loader.setStreamingThreshold(0);
+            auto streamed = loader.loadFile(flacFile, 48000.0);
+            expect(streamed != nullptr);
+            expect(streamed->isStreamed());
+            expectEquals(streamed->getDurationInSamples(), static_cast<juce::int64>(length));
+            expectEquals(streamed->getSampleRate(), sampleRate);  // Resampled on playback instead
+            expectEquals(streamed->getTrimEndSample(), static_cast<juce::int64>(length));
+            expectWithinAbsoluteError(streamed->getSample(1, 1234), audio.getSample(1, 1234), 1.0e-4f);
+        }
+
+        beginTest("Streamed clips render like decoded ones");
+        {
+            AudioFileLoader loader;
+            loader.setStreamingThreshold(0);
+
+            for (double playbackRate : { 1.0, 1.3 })
+            {
+                std::vector<std::unique_ptr<AudioClip>> decodedClips, streamedClips;
+                decodedClips.push_back(std::make_unique<AudioClip>());
+                decodedClips.back()->setAudioBuffer(audio, sampleRate);
+                streamedClips.push_back(loader.loadFile(wavFile));
+                expect(streamedClips.back()->isStreamed());
+
+                for (auto* clips : { &decodedClips, &streamedClips })
+                {
+                    auto& clip = *clips->front();
+                    clip.setStartBeat(0.5);
+                    clip.setTrimStartSample(5000);
+                    clip.setFadeInSamples(2000);
+                    clip.setPlaybackRate(playbackRate);
+                }
+
+                auto expected = TestHelpers::renderBlocks(decodedClips, sampleRate, 100000, 120.0, true);
+                auto actual = TestHelpers::renderBlocks(streamedClips, sampleRate, 100000, 120.0, true);
+
+                float largestError = 0.0f;
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < 100000; ++i)
+                        largestError = std::max(largestError, std::abs(expected.getSample(ch, i) - actual.getSample(ch, i)));
+
+                expectLessThan(largestError, 1.0e-5f);
+                expect(actual.getMagnitude(0, 100000) > 0.1f);
+            }
+        }
+
+        tempDir.deleteRecursively();
+    }
+
+private:
+    template <typename Condition>
+    static bool waitUntil(Condition condition)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            if (condition())
+                return true;
+            juce::Thread::sleep(10);
+        }
+        return condition();
+    }
+};
+
+// Register the test
+static AudioFileStreamTests audioFileStreamTests;
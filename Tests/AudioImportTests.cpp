@@ -0,0 +1,167 @@
+/**
+ * Audio Import Unit Tests - Placeholders, parallel decoding and cancellation
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/AudioImportService.h"
+#include "../Source/Audio/Track.h"
+#include "../Source/Utils/PerformanceProfiler.h"
+#include "TestHelpers.h"
+#include <vector>
+
+class AudioImportTests : public juce::UnitTest
+{
+public:
+    AudioImportTests() : UnitTest("Audio Import") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+
+        auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                           .getChildFile("ProgFlowAudioImportTests");
+        tempDir.deleteRecursively();
+        tempDir.createDirectory();
+
+        // Stems of different lengths, each holding its own constant value
+        std::vector<juce::File> stems;
+        for (int i = 0; i < 8; ++i)
+        {
+            stems.push_back(tempDir.getChildFile("stem" + juce::String(i) + ".wav"));
+            writeConstant(stems.back(), 0.1f * static_cast<float>(i + 1), 20000 + 5000 * i, sampleRate);
+        }
+
+        //======================================================================
+        beginTest("Imports return placeholders that fill in when decoded");
+        {
+            AudioFileLoader loader;
+            AudioImportService service(loader, 2);
+
+            std::vector<AudioImportService::Result> results;
+            service.onImportFinished = [&](AudioImportService::Result& result) { results.push_back(std::move(result)); };
+
+            Track track("Stems");
+            auto placeholder = service.import(stems[2], 0.0);
+            expect(placeholder != nullptr);
+            expect(placeholder->isPlaceholder());
+            expect(!placeholder->hasAudio());
+            expectEquals(placeholder->getTrimmedDurationInSamples(), static_cast<juce::int64>(30000));
+            expectEquals(placeholder->getName(), juce::String("stem2"));
+
+            placeholder->setStartBeat(8.0);
+            const auto clipId = placeholder->getId();
+            track.addAudioClip(std::move(placeholder));
+
+            expect(service.waitForAll(10000));
+            expectEquals(service.getNumPending(), 0);
+            expectEquals(service.getProgress(clipId), 1.0f);
+
+            service.deliverFinished();
+            expectEquals(static_cast<int>(results.size()), 1);
+            expectEquals(results[0].clipId, clipId);
+            expect(results[0].clip != nullptr);
+            expectEquals(service.getProgress(clipId), -1.0f);
+
+            expect(track.fillAudioClip(clipId, *results[0].clip));
+            const auto* filled = track.getAudioClip(clipId);
+            expect(!filled->isPlaceholder());
+            expectEquals(filled->getDurationInSamples(), static_cast<juce::int64>(30000));
+            expectEquals(filled->getStartBeat(), 8.0);
+            expectWithinAbsoluteError(filled->getSample(0, 1000), 0.3f, 1.0e-6f);
+        }
+
+        beginTest("Many files decode at once and report throughput");
+        {
+            AudioFileLoader loader;
+            AudioImportService service(loader, 4);
+            expectEquals(service.getNumThreads(), 4);
+
+            std::vector<AudioImportService::Result> results;
+            service.onImportFinished = [&](AudioImportService::Result& result) { results.push_back(std::move(result)); };
+
+            juce::StringArray ids;
+            for (const auto& stem : stems)
+                ids.add(service.import(stem)->getId());
+
+            for (const auto& id : ids)
+            {
+                const float progress = service.getProgress(id);
+                expect(progress >= 0.0f && progress <= 1.0f);
+            }
+
+            expect(service.waitForAll(10000));
+            service.deliverFinished();
+            expectEquals(static_cast<int>(results.size()), static_cast<int>(stems.size()));
+
+            for (const auto& result : results)
+            {
+                expect(result.clip != nullptr);
+                expect(!result.cancelled);
+                const int index = ids.indexOf(result.clipId);
+                expect(index >= 0);
+                expectEquals(result.clip->getDurationInSamples(), static_cast<juce::int64>(20000 + 5000 * index));
+            }
+
+            expect(PerformanceProfiler::getInstance().getThroughput("AudioImport::DecodedFrames") > 0.0);
+        }
+
+        beginTest("Cancelled imports deliver no clip");
+        {
+            AudioFileLoader loader;
+            AudioImportService service(loader, 1);
+
+            std::vector<AudioImportService::Result> results;
+            service.onImportFinished = [&](AudioImportService::Result& result) { results.push_back(std::move(result)); };
+
+            // With one worker the second file is still queued when cancelled
+            auto first = service.import(stems[7]);
+            auto second = service.import(stems[6]);
+            service.cancel(second->getId());
+
+            expect(service.waitForAll(10000));
+            service.deliverFinished();
+            expectEquals(static_cast<int>(results.size()), 2);
+
+            for (const auto& result : results)
+            {
+                if (result.clipId == second->getId())
+                {
+                    expect(result.cancelled);
+                    expect(result.clip == nullptr);
+                }
+                else
+                {
+                    expect(result.clip != nullptr);
+                }
+            }
+        }
+
+        beginTest("Unreadable files get no placeholder");
+        {
+            AudioFileLoader loader;
+            AudioImportService service(loader, 1);
+
+            expect(service.import(tempDir.getChildFile("missing.wav")) == nullptr);
+
+            auto notAudio = tempDir.getChildFile("notes.wav");
+            notAudio.replaceWithText("not audio");
+            expect(service.import(notAudio) == nullptr);
+            expectEquals(service.getNumPending(), 0);
+        }
+
+        tempDir.deleteRecursively();
+    }
+
+private:
+    static void writeConstant(const juce::File& file, float value, int length, double sampleRate)
+    {
+        juce::AudioBuffer<float> audio(1, length);
+        juce::FloatVectorOperations::fill(audio.getWritePointer(0), value, length);
+        TestHelpers::writeAudioFile(file, audio, sampleRate);
+    }
+};
+
+// Register the test
+static AudioImportTests audioImportTests;
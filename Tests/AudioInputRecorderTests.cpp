@@ -0,0 +1,379 @@
+/**
+ * AudioInputRecorder Unit Tests - Recording many inputs from a simulated device
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/AudioEngine.h"
+#include "../Source/Audio/AudioInputRecorder.h"
+#include <cmath>
+#include <utility>
+
+class AudioInputRecorderTests : public juce::UnitTest
+{
+public:
+    AudioInputRecorderTests() : UnitTest("AudioInputRecorder") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 256;
+        constexpr int numInputs = 32;
+        constexpr int deviceLatency = 64;   // Each way
+
+        auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                           .getChildFile("ProgFlowAudioInputRecorderTests");
+        tempDir.deleteRecursively();
+        tempDir.createDirectory();
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        //======================================================================
+        beginTest("Every input reaches disk without a dropped block");
+        {
+            // A mono track per input, and a stereo one on the first pair
+            AudioEngine engine;
+            engine.getInputRecorder().setRecordingDirectory(tempDir.getChildFile("many"));
+
+            for (int i = 0; i < numInputs; ++i)
+                addInputTrack(engine, "In " + juce::String(i + 1), i, 1);
+            addInputTrack(engine, "Pair", 0, 2);
+
+            SimulatedDevice device(numInputs, sampleRate, blockSize, deviceLatency);
+            juce::AudioSourcePlayer player;
+            player.setSource(&engine);
+            DeviceCallbacks callbacks({ &engine.getInputRecorder(), &player });
+
+            // The device runs in real time on its own thread throughout, as hardware does
+            device.start(&callbacks);
+            juce::Thread::sleep(100);
+
+            engine.play();
+            juce::Thread::sleep(1500);
+            engine.stop();
+
+            device.stop();
+            player.setSource(nullptr);
+
+            expectEquals(engine.getInputRecorder().getDroppedBlockCount(), 0);
+            expect(!engine.getInputRecorder().isRecording());
+
+            const int offset = 2 * deviceLatency + engine.getLatencySamples();
+            for (int t = 0; t <= numInputs; ++t)
+            {
+                auto* track = engine.getTrack(t);
+                expectEquals(static_cast<int>(track->getNumAudioClips()), 1);
+                if (track->getNumAudioClips() != 1)
+                    continue;
+
+                const auto& clip = *track->getAudioClips().front();
+                expect(clip.isStreamed());
+                expectEquals(clip.getStartBeat(), 0.0);
+                expectEquals(clip.getTrimStartSample(), static_cast<juce::int64>(offset));
+
+                // Gapless: each channel carries its input's frame count on from the first frame
+                auto audio = readFile(formats, juce::File(clip.getFilePath()));
+                expect(audio.getNumSamples() > static_cast<int>(sampleRate));
+
+                const int numChannels = t < numInputs ? 1 : 2;
+                expectEquals(audio.getNumChannels(), numChannels);
+
+                const int firstInput = t < numInputs ? t : 0;
+                const auto firstFrame = findFrame(firstInput, audio.getSample(0, 0));
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    expectEquals(countMismatches(audio, ch, firstInput + ch, firstFrame), 0,
+                                 "track " + juce::String(t) + " channel " + juce::String(ch));
+                }
+            }
+        }
+
+        //======================================================================
+        beginTest("Takes start where the player heard the tracks");
+        {
+            AudioEngine engine;
+            engine.getInputRecorder().setRecordingDirectory(tempDir.getChildFile("placed"));
+            engine.setBpm(120.0);
+            auto* track = addInputTrack(engine, "Vocal", 3, 1);
+
+            SimulatedDevice device(4, sampleRate, blockSize, deviceLatency);
+            juce::AudioSourcePlayer player;
+            player.setSource(&engine);
+            DeviceCallbacks callbacks({ &engine.getInputRecorder(), &player });
+            callbacks.audioDeviceAboutToStart(&device);
+
+            // Nothing captured, nothing kept
+            engine.play();
+            engine.stop();
+            expectEquals(static_cast<int>(track->getNumAudioClips()), 0);
+            expectEquals(tempDir.getChildFile("placed").getNumberOfChildFiles(juce::File::findFiles), 0);
+
+            device.process(callbacks, 10);
+            engine.setPositionInBeats(8.0);
+            engine.play();
+
+            const auto playedFrom = device.getFramesDelivered();
+            device.process(callbacks, 200);
+            engine.stop();
+            callbacks.audioDeviceStopped();
+            player.setSource(nullptr);
+
+            expectEquals(static_cast<int>(track->getNumAudioClips()), 1);
+            const auto& clip = *track->getAudioClips().front();
+
+            const int offset = 2 * deviceLatency + engine.getLatencySamples();
+            expectWithinAbsoluteError(clip.getStartBeat(), 8.0 - offset / sampleRate * 2.0, 1.0e-9);
+            expectEquals(clip.getTrimStartSample(), static_cast<juce::int64>(0));
+            expectEquals(clip.getDurationInSamples(), static_cast<juce::int64>(200 * blockSize));
+
+            // The first frame on disk is the first one captured after play()
+            auto audio = readFile(formats, juce::File(clip.getFilePath()));
+            expectEquals(countMismatches(audio, 0, 3, playedFrom), 0);
+
+            // Its peaks came with it
+            auto peaks = getWaveformPeakStore().getPeaks(clip);
+            expect(peaks != nullptr);
+            if (peaks != nullptr)
+                expectEquals(peaks->getLengthInFrames(), clip.getDurationInSamples());
+        }
+
+        //======================================================================
+        beginTest("Monitored inputs are heard in the block they arrive");
+        {
+            AudioEngine engine;
+            engine.getInputRecorder().setRecordingDirectory(tempDir.getChildFile("monitored"));
+            auto* track = addInputTrack(engine, "Guitar", 1, 1);
+
+            SimulatedDevice device(2, sampleRate, blockSize, deviceLatency);
+            juce::AudioSourcePlayer player;
+            player.setSource(&engine);
+            DeviceCallbacks callbacks({ &engine.getInputRecorder(), &player });
+            callbacks.audioDeviceAboutToStart(&device);
+
+            device.process(callbacks, 20);
+            expectLessThan(device.getOutputMagnitude(), 1.0e-4f);
+
+            track->setInputMonitoring(true);
+            device.process(callbacks, 1);
+            expectGreaterThan(device.getOutputMagnitude(), 0.05f);
+
+            // Disarmed, it goes quiet again
+            track->setArmed(false);
+            device.process(callbacks, 20);
+            expectLessThan(device.getOutputMagnitude(), 1.0e-4f);
+
+            callbacks.audioDeviceStopped();
+            player.setSource(nullptr);
+        }
+
+        tempDir.deleteRecursively();
+    }
+
+private:
+    // A ramp per input, offset by channel, in 1/4096 steps that survive 24-bit WAV
+    static constexpr int RAMP_LENGTH = 4096;
+
+    static float rampSample(int channel, juce::int64 frame)
+    {
+        const auto step = (frame + 131 * channel) % RAMP_LENGTH;
+        return static_cast<float>(step - RAMP_LENGTH / 2) / static_cast<float>(RAMP_LENGTH);
+    }
+
+    // A device frame the channel had this value at (the ramp repeats, so any will do)
+    static juce::int64 findFrame(int channel, float value)
+    {
+        const auto step = juce::roundToInt(value * RAMP_LENGTH) + RAMP_LENGTH / 2;
+        return (step - 131 * channel + 64 * RAMP_LENGTH) % RAMP_LENGTH;
+    }
+
+    static int countMismatches(const juce::AudioBuffer<float>& audio, int channel, int input, juce::int64 firstFrame)
+    {
+        int mismatches = 0;
+        for (int i = 0; i < audio.getNumSamples(); ++i)
+        {
+            if (std::abs(audio.getSample(channel, i) - rampSample(input, firstFrame + i)) > 1.0e-6f)
+                ++mismatches;
+        }
+        return mismatches;
+    }
+
+    static Track* addInputTrack(AudioEngine& engine, const juce::String& name, int firstChannel, int numChannels)
+    {
+        engine.addTrack(std::make_unique<Track>(name));
+        auto* track = engine.getTrack(engine.getNumTracks() - 1);
+        track->setInputChannels(firstChannel, numChannels);
+        track->setArmed(true);
+        return track;
+    }
+
+    static juce::AudioBuffer<float> readFile(juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        juce::AudioBuffer<float> audio;
+        if (std::unique_ptr<juce::AudioFormatReader> reader { formats.createReaderFor(file) })
+        {
+            audio.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+            reader->read(&audio, 0, audio.getNumSamples(), 0, true, true);
+        }
+        return audio;
+    }
+
+    // Calls its callbacks in turn and adds up their output, as AudioDeviceManager does
+    class DeviceCallbacks : public juce::AudioIODeviceCallback
+    {
+    public:
+        explicit DeviceCallbacks(std::vector<juce::AudioIODeviceCallback*> callbacksToUse)
+            : callbacks(std::move(callbacksToUse)) {}
+
+        void audioDeviceIOCallbackWithContext(const float* const* inputs, int numInputs,
+                                              float* const* outputs, int numOutputs, int numSamples,
+                                              const juce::AudioIODeviceCallbackContext& context) override
+        {
+            callbacks.front()->audioDeviceIOCallbackWithContext(inputs, numInputs, outputs, numOutputs,
+                                                                numSamples, context);
+
+            for (size_t i = 1; i < callbacks.size(); ++i)
+            {
+                callbacks[i]->audioDeviceIOCallbackWithContext(inputs, numInputs, scratch.getArrayOfWritePointers(),
+                                                               numOutputs, numSamples, context);
+                for (int ch = 0; ch < numOutputs; ++ch)
+                    juce::FloatVectorOperations::add(outputs[ch], scratch.getReadPointer(ch), numSamples);
+            }
+        }
+
+        void audioDeviceAboutToStart(juce::AudioIODevice* device) override
+        {
+            scratch.setSize(device->getActiveOutputChannels().countNumberOfSetBits(),
+                            device->getCurrentBufferSizeSamples());
+            for (auto* callback : callbacks)
+                callback->audioDeviceAboutToStart(device);
+        }
+
+        void audioDeviceStopped() override
+        {
+            for (auto* callback : callbacks)
+                callback->audioDeviceStopped();
+        }
+
+    private:
+        std::vector<juce::AudioIODeviceCallback*> callbacks;
+        juce::AudioBuffer<float> scratch;
+    };
+
+    // Stereo out, numInputs ramps in; blocks come from process(), or from its
+    // own thread at the pace of real hardware once started
+    class SimulatedDevice : public juce::AudioIODevice,
+                            private juce::Thread
+    {
+    public:
+        SimulatedDevice(int numInputsToUse, double rate, int blockSizeToUse, int latency)
+            : juce::AudioIODevice("Simulated", "Simulated"), juce::Thread("Simulated Device"),
+              numInputs(numInputsToUse), sampleRate(rate), blockSize(blockSizeToUse), latencySamples(latency),
+              inputs(numInputsToUse, blockSizeToUse), outputs(2, blockSizeToUse)
+        {
+        }
+
+        ~SimulatedDevice() override { stop(); }
+
+        void process(juce::AudioIODeviceCallback& target, int numBlocks)
+        {
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int ch = 0; ch < numInputs; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        inputs.setSample(ch, i, rampSample(ch, framesDelivered + i));
+
+                target.audioDeviceIOCallbackWithContext(inputs.getArrayOfReadPointers(), numInputs,
+                                                        outputs.getArrayOfWritePointers(), 2, blockSize, {});
+                framesDelivered += blockSize;
+            }
+        }
+
+        juce::int64 getFramesDelivered() const { return framesDelivered; }
+        float getOutputMagnitude() const { return outputs.getMagnitude(0, blockSize); }
+
+        juce::StringArray getOutputChannelNames() override { return { "Out 1", "Out 2" }; }
+        juce::StringArray getInputChannelNames() override
+        {
+            juce::StringArray names;
+            for (int ch = 0; ch < numInputs; ++ch)
+                names.add("In " + juce::String(ch + 1));
+            return names;
+        }
+
+        juce::Array<double> getAvailableSampleRates() override { return { sampleRate }; }
+        juce::Array<int> getAvailableBufferSizes() override { return { blockSize }; }
+        int getDefaultBufferSize() override { return blockSize; }
+
+        juce::String open(const juce::BigInteger&, const juce::BigInteger&, double, int) override { return {}; }
+        void close() override { stop(); }
+        bool isOpen() override { return true; }
+
+        void start(juce::AudioIODeviceCallback* newCallback) override
+        {
+            callback = newCallback;
+            callback->audioDeviceAboutToStart(this);
+            startThread(juce::Thread::Priority::highest);
+        }
+
+        void stop() override
+        {
+            stopThread(2000);
+            if (auto* stopped = std::exchange(callback, nullptr))
+                stopped->audioDeviceStopped();
+        }
+
+        bool isPlaying() override { return isThreadRunning(); }
+        juce::String getLastError() override { return {}; }
+        int getCurrentBufferSizeSamples() override { return blockSize; }
+        double getCurrentSampleRate() override { return sampleRate; }
+        int getCurrentBitDepth() override { return 32; }
+
+        juce::BigInteger getActiveOutputChannels() const override
+        {
+            juce::BigInteger channels;
+            channels.setRange(0, 2, true);
+            return channels;
+        }
+
+        juce::BigInteger getActiveInputChannels() const override
+        {
+            juce::BigInteger channels;
+            channels.setRange(0, numInputs, true);
+            return channels;
+        }
+
+        int getOutputLatencyInSamples() override { return latencySamples; }
+        int getInputLatencyInSamples() override { return latencySamples; }
+
+    private:
+        const int numInputs;
+        const double sampleRate;
+        const int blockSize;
+        const int latencySamples;
+        juce::AudioBuffer<float> inputs, outputs;
+        juce::int64 framesDelivered = 0;
+        juce::AudioIODeviceCallback* callback = nullptr;
+
+        void run() override
+        {
+            const double blockMs = 1000.0 * blockSize / sampleRate;
+            double due = juce::Time::getMillisecondCounterHiRes();
+
+            while (!threadShouldExit())
+            {
+                process(*callback, 1);
+
+                due += blockMs;
+                const double wait = due - juce::Time::getMillisecondCounterHiRes();
+                if (wait > 1.0)
+                    juce::Thread::sleep(static_cast<int>(wait));
+            }
+        }
+    };
+};
+
+// Register the test
+static AudioInputRecorderTests audioInputRecorderTests;
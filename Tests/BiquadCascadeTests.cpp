@@ -0,0 +1,238 @@
+/**
+ * Biquad Cascade Unit Tests - Lane-parallel filtering, ramps and the 8-band EQ
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/Audio/Effects/BiquadCascade.h"
+#include "../Source/Audio/Effects/ParametricEQEffect.h"
+#include "../Source/Audio/Effects/EQEffect.h"
+#include <cmath>
+
+class BiquadCascadeTests : public juce::UnitTest
+{
+public:
+    BiquadCascadeTests() : UnitTest("Biquad Cascade") {}
+
+    void runTest() override
+    {
+        const double sampleRate = 44100.0;
+
+        //======================================================================
+        beginTest("Cascade matches per-channel JUCE IIR filters");
+        {
+            auto lowShelf = juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, 120.0f, 0.707f, 2.0f);
+            auto peak = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 1000.0f, 2.0f, 0.5f);
+            auto lowPass = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 6000.0f, 0.707f);
+
+            BiquadCascade cascade;
+            cascade.setStage(0, BiquadCascade::Coefficients::fromJuce(*lowShelf));
+            cascade.setStage(1, BiquadCascade::Coefficients::fromJuce(*peak));
+            cascade.setStage(5, BiquadCascade::Coefficients::fromJuce(*lowPass));
+            cascade.prepare(2);
+
+            juce::dsp::IIR::Filter<float> reference[2][3];
+            for (auto& channel : reference)
+            {
+                channel[0].coefficients = lowShelf;
+                channel[1].coefficients = peak;
+                channel[2].coefficients = lowPass;
+            }
+
+            auto input = makeNoise(2, 4096, 1);
+            juce::AudioBuffer<float> output(input);
+
+            // Odd block sizes
+            for (int position = 0; position < 4096; position += 333)
+            {
+                const int n = std::min(333, 4096 - position);
+                juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, position, n);
+                cascade.process(block, n);
+            }
+
+            float maxError = 0.0f;
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < 4096; ++i)
+                {
+                    float expected = input.getSample(ch, i);
+                    for (auto& filter : reference[ch])
+                        expected = filter.processSample(expected);
+                    maxError = std::max(maxError, std::abs(expected - output.getSample(ch, i)));
+                }
+            }
+            expectLessThan(maxError, 1.0e-4f);
+        }
+
+        beginTest("Channels can have their own coefficients");
+        {
+            BiquadCascade cascade;
+            cascade.setStage(0, { 0.5f, 0.0f, 0.0f, 0.0f, 0.0f }, 1); // Right channel only
+            cascade.prepare(4);
+
+            juce::AudioBuffer<float> buffer(4, 64);
+            for (int ch = 0; ch < 4; ++ch)
+                juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), 1.0f, 64);
+
+            cascade.process(buffer, 64);
+            expectEquals(buffer.getSample(0, 10), 1.0f);
+            expectEquals(buffer.getSample(1, 10), 0.5f);
+            expectEquals(buffer.getSample(2, 10), 1.0f);
+            expectEquals(buffer.getSample(3, 10), 1.0f);
+        }
+
+        beginTest("Coefficient changes ramp instead of jumping");
+        {
+            BiquadCascade cascade;
+            cascade.setRampLength(100);
+            cascade.prepare(1);
+
+            juce::AudioBuffer<float> buffer(1, 512);
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(0), 1.0f, 512);
+            cascade.process(buffer, 512);
+            expectEquals(buffer.getSample(0, 511), 1.0f);
+
+            // Pure gain stage of 0.5: the output glides from 1 to 0.5
+            cascade.setStage(0, { 0.5f, 0.0f, 0.0f, 0.0f, 0.0f });
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(0), 1.0f, 512);
+            cascade.process(buffer, 512);
+
+            expectWithinAbsoluteError(buffer.getSample(0, 0), 1.0f, 0.01f);
+            expectWithinAbsoluteError(buffer.getSample(0, 50), 0.75f, 0.01f);
+            expectEquals(buffer.getSample(0, 200), 0.5f);
+
+            float largestStep = 0.0f;
+            for (int i = 1; i < 512; ++i)
+                largestStep = std::max(largestStep, std::abs(buffer.getSample(0, i) - buffer.getSample(0, i - 1)));
+            expectLessThan(largestStep, 0.01f);
+
+            // Back to identity: passes through exactly once the ramp is over
+            cascade.setStage(0, BiquadCascade::Coefficients::identity());
+            auto noise = makeNoise(1, 512, 2);
+            buffer.makeCopyOf(noise);
+            cascade.process(buffer, 512);
+            expectEquals(buffer.getSample(0, 300), noise.getSample(0, 300));
+        }
+
+        //======================================================================
+        beginTest("Parametric EQ bands shape the response");
+        {
+            ParametricEQEffect eq;
+            eq.prepareToPlay(sampleRate, 512);
+
+            // Flat by default
+            expectWithinAbsoluteError(measureGainDb(eq, 1000.0f), 0.0f, 0.05f);
+
+            eq.setParameter(ParametricEQEffect::bandParameter(5, "Freq"), 1000.0f);
+            eq.setParameter(ParametricEQEffect::bandParameter(5, "Gain"), 9.0f);
+            expectWithinAbsoluteError(measureGainDb(eq, 1000.0f), 9.0f, 0.5f);
+            expectLessThan(measureGainDb(eq, 100.0f), 1.0f);
+
+            // Low cut removes the lows
+            eq.setParameter(ParametricEQEffect::bandParameter(1, "On"), 1.0f);
+            eq.setParameter(ParametricEQEffect::bandParameter(1, "Freq"), 500.0f);
+            expectLessThan(measureGainDb(eq, 60.0f), -20.0f);
+
+            // Turning a band off restores it
+            eq.setParameter(ParametricEQEffect::bandParameter(5, "On"), 0.0f);
+            expectWithinAbsoluteError(measureGainDb(eq, 1000.0f), 0.0f, 1.0f);
+        }
+
+        beginTest("3-band EQ still boosts its mid band");
+        {
+            EQEffect eq;
+            eq.setParameter("midFreq", 2000.0f);
+            eq.setParameter("midGain", 6.0f);
+            eq.prepareToPlay(sampleRate, 512);
+            expectWithinAbsoluteError(measureGainDb(eq, 2000.0f), 6.0f, 0.5f);
+        }
+
+        //======================================================================
+        beginTest("Cascade is cheaper than separate per-channel filters");
+        {
+            const int length = static_cast<int>(sampleRate * 10.0);
+            auto input = makeNoise(2, length, 3);
+
+            juce::dsp::IIR::Filter<float> reference[2][8];
+            BiquadCascade cascade;
+            for (int stage = 0; stage < 8; ++stage)
+            {
+                auto coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
+                    sampleRate, 60.0f * std::pow(2.0f, static_cast<float>(stage)), 1.0f, 1.5f);
+                cascade.setStage(stage, BiquadCascade::Coefficients::fromJuce(*coefficients));
+                for (auto& channel : reference)
+                    channel[stage].coefficients = coefficients;
+            }
+            cascade.prepare(2);
+
+            juce::AudioBuffer<float> buffer(input);
+            auto start = juce::Time::getMillisecondCounterHiRes();
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                for (int i = 0; i < length; ++i)
+                    for (auto& filter : reference[ch])
+                        data[i] = filter.processSample(data[i]);
+            }
+            const double scalarMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+            buffer.makeCopyOf(input);
+            start = juce::Time::getMillisecondCounterHiRes();
+            for (int position = 0; position < length; position += 512)
+            {
+                const int n = std::min(512, length - position);
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, position, n);
+                cascade.process(block, n);
+            }
+            const double cascadeMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+            logMessage("8 bands, stereo, 10 s: per-channel IIR " + juce::String(scalarMs, 1)
+                       + " ms, cascade " + juce::String(cascadeMs, 1) + " ms");
+
+            expect(cascadeMs < 1000.0, "Cascade took " + juce::String(cascadeMs) + "ms for 10 s of audio");
+        }
+    }
+
+private:
+    static juce::AudioBuffer<float> makeNoise(int numChannels, int numSamples, int seed)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+        juce::Random random(seed);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+        return buffer;
+    }
+
+    /** Steady-state gain of an effect for a sine, in dB */
+    static float measureGainDb(EffectBase& effect, float frequency)
+    {
+        const int blockSize = 512;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        double phase = 0.0;
+        const double increment = juce::MathConstants<double>::twoPi * frequency / 44100.0;
+        float peak = 0.0f;
+
+        effect.reset();
+        for (int block = 0; block < 40; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float sample = 0.25f * static_cast<float>(std::sin(phase));
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+                phase += increment;
+            }
+
+            effect.processBlock(buffer);
+            if (block >= 30)
+                peak = std::max(peak, buffer.getMagnitude(0, 0, blockSize));
+        }
+
+        return juce::Decibels::gainToDecibels(peak / 0.25f);
+    }
+};
+
+// Register the test
+static BiquadCascadeTests biquadCascadeTests;
@@ -0,0 +1,163 @@
+/**
+ * Clip Warp Unit Tests - Tempo curves, cached stretch renders and the real-time fallback
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/AudioClip.h"
+#include "../Source/Audio/AudioClipRenderer.h"
+#include "../Source/Audio/ClipWarpCache.h"
+#include "../Source/Audio/TempoTrack.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class ClipWarpTests : public juce::UnitTest
+{
+public:
+    ClipWarpTests() : UnitTest("Clip Warp") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+
+        //======================================================================
+        beginTest("Tempo curves follow the tempo track relative to the clip");
+        {
+            TempoTrack tempoTrack;
+            const auto version = tempoTrack.getEditVersion();
+
+            ClipWarpCache::TempoCurve curve;
+            expect(ClipWarpCache::TempoCurve::fromTempoTrack(tempoTrack, 4.0, 16.0, curve));
+            expect(curve.isConstant());
+            expect(curve == ClipWarpCache::TempoCurve::constant(120.0));
+
+            // Ramp from 120 at beat 8 up to 140 at beat 16
+            tempoTrack.addEvent({ 8.0, 120.0, TempoRampType::Linear });
+            tempoTrack.addEvent({ 16.0, 140.0, TempoRampType::Instant });
+            expect(tempoTrack.getEditVersion() != version);
+
+            expect(ClipWarpCache::TempoCurve::fromTempoTrack(tempoTrack, 4.0, 16.0, curve));
+            expectEquals(curve.numPoints, 3);
+            expectEquals(curve.getTempoAt(2.0), 120.0);
+            expectWithinAbsoluteError(curve.getTempoAt(8.0), 130.0, 1.0e-9);
+            expectEquals(curve.getTempoAt(14.0), 140.0);
+
+            // Ending inside the ramp stops at the tempo reached there
+            expect(ClipWarpCache::TempoCurve::fromTempoTrack(tempoTrack, 10.0, 2.0, curve));
+            expectEquals(curve.numPoints, 2);
+            expectWithinAbsoluteError(curve.getTempoAt(0.0), 125.0, 1.0e-9);
+            expectWithinAbsoluteError(curve.getTempoAt(2.0), 130.0, 1.0e-9);
+        }
+
+        beginTest("Warped clips keep their length in beats");
+        {
+            AudioClip clip;
+            clip.setAudioBuffer(makeTone(static_cast<int>(2.0 * sampleRate), sampleRate), sampleRate);
+            expectWithinAbsoluteError(clip.getDurationInBeats(90.0), 3.0, 1.0e-9);
+
+            clip.setWarpEnabled(true);
+            clip.setSourceBpm(120.0);
+            clip.setPitchSemitones(3.0);
+            expectWithinAbsoluteError(clip.getDurationInBeats(90.0), 4.0, 1.0e-9);
+            expectWithinAbsoluteError(clip.getDurationInBeats(150.0), 4.0, 1.0e-9);
+
+            auto restored = AudioClip::fromVar(clip.toVar());
+            expect(restored->isWarpEnabled());
+            expectEquals(restored->getSourceBpm(), 120.0);
+            expectEquals(restored->getPitchSemitones(), 3.0);
+        }
+
+        //======================================================================
+        beginTest("Offline renders follow the tempo at the clip's own pitch");
+        {
+            auto& cache = getClipWarpCache();
+            cache.clear();
+
+            std::vector<std::unique_ptr<AudioClip>> clips;
+            clips.push_back(makeWarpedClip(sampleRate));
+
+            // Four beats at 100 bpm instead of 120
+            const auto output = TestHelpers::renderBlocks(clips, sampleRate, static_cast<int>(3.0 * sampleRate), 100.0, true);
+            const int end = static_cast<int>(4.0 * 60.0 / 100.0 * sampleRate);
+
+            expectWithinAbsoluteError(measureFrequency(output, 4410, end - 4410, sampleRate), 440.0, 440.0 * 0.02);
+            expect(output.getMagnitude(0, end - 4410, 2205) > 0.1f);
+            expectLessThan(output.getMagnitude(0, end + 1024, output.getNumSamples() - end - 1024), 0.01f);
+            expectEquals(cache.getNumRenders(), 1);
+        }
+
+        beginTest("Playback stretches in real time, on the beat, until the render is made");
+        {
+            auto& cache = getClipWarpCache();
+            cache.clear();
+
+            std::vector<std::unique_ptr<AudioClip>> clips;
+            clips.push_back(makeWarpedClip(sampleRate));
+            clips.back()->setStartBeat(1.0);
+
+            // The render is asked for, but the first blocks can't wait for it
+            constexpr double bpm = 90.0;
+            const auto stretched = TestHelpers::renderBlocks(clips, sampleRate, static_cast<int>(1.5 * sampleRate), bpm);
+            const int clipStart = static_cast<int>(60.0 / bpm * sampleRate);
+
+            int onset = 0;
+            while (onset < stretched.getNumSamples() && std::abs(stretched.getSample(0, onset)) < 0.05f)
+                ++onset;
+
+            expectWithinAbsoluteError(onset, clipStart, static_cast<int>(0.02 * sampleRate));
+            expectWithinAbsoluteError(measureFrequency(stretched, clipStart + 4410, stretched.getNumSamples(), sampleRate),
+                                      440.0, 440.0 * 0.02);
+
+            expect(cache.waitForRenders(30000));
+            expectEquals(cache.getNumRenders(), 1);
+
+            TempoTrack tempoTrack;
+            tempoTrack.setInitialTempo(bpm);
+            ClipWarpCache::TempoCurve curve;
+            expect(ClipWarpCache::TempoCurve::fromTempoTrack(tempoTrack, 1.0, 4.0, curve));
+            const auto render = cache.find(ClipWarpCache::Source::fromClip(*clips.front(), curve));
+            expect(render != nullptr);
+            expectWithinAbsoluteError(render->getAudio().getNumSamples(),
+                                      static_cast<int>(4.0 * 60.0 / bpm * sampleRate), 1);
+            expectWithinAbsoluteError(render->getFrameAt(2.0), 2.0 * 60.0 / bpm * sampleRate, 1.0e-6);
+
+            // Played from the render once it is there
+            const auto rendered = TestHelpers::renderBlocks(clips, sampleRate, static_cast<int>(1.5 * sampleRate), bpm);
+            expectWithinAbsoluteError(measureFrequency(rendered, clipStart + 4410, rendered.getNumSamples(), sampleRate),
+                                      440.0, 440.0 * 0.02);
+
+            cache.clear();
+        }
+    }
+
+private:
+    static juce::AudioBuffer<float> makeTone(int length, double sampleRate)
+    {
+        juce::AudioBuffer<float> audio(1, length);
+        for (int i = 0; i < length; ++i)
+            audio.setSample(0, i, 0.5f * static_cast<float>(std::sin(2.0 * juce::MathConstants<double>::pi * 440.0 * i / sampleRate)));
+        return audio;
+    }
+
+    // Four beats of 440 Hz at 120 bpm
+    static std::unique_ptr<AudioClip> makeWarpedClip(double sampleRate)
+    {
+        auto clip = std::make_unique<AudioClip>();
+        clip->setAudioBuffer(makeTone(static_cast<int>(2.0 * sampleRate), sampleRate), sampleRate);
+        clip->setWarpEnabled(true);
+        clip->setSourceBpm(120.0);
+        return clip;
+    }
+
+    static double measureFrequency(const juce::AudioBuffer<float>& audio, int start, int end, double sampleRate)
+    {
+        int crossings = 0;
+        for (int i = start + 1; i < end; ++i)
+            if (audio.getSample(0, i - 1) < 0.0f && audio.getSample(0, i) >= 0.0f)
+                ++crossings;
+        return crossings * sampleRate / (end - start);
+    }
+};
+
+// Register the test
+static ClipWarpTests clipWarpTests;
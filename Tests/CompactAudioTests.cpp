@@ -0,0 +1,244 @@
+/**
+ * CompactAudio Unit Tests - Packed and lossless round trips, pooled compact clips and playback
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/AudioClipRenderer.h"
+#include "../Source/Audio/AudioEngine.h"
+#include "../Source/Audio/CompactAudio.h"
+#include "../Source/Audio/SamplePool.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class CompactAudioTests : public juce::UnitTest
+{
+public:
+    CompactAudioTests() : UnitTest("CompactAudio") {}
+
+    void runTest() override
+    {
+        constexpr int length = 50000;
+        const auto audio16 = makeMusic(length, true);
+        const auto audio24 = makeMusic(length, false);
+
+        //======================================================================
+        beginTest("16-bit audio packs to half the size, exactly");
+        {
+            auto packed = CompactAudio::fromBuffer(audio16, CompactAudio::Format::Packed);
+            expect(packed != nullptr);
+            expectEquals(packed->getBitDepth(), 16);
+            expectEquals(packed->getNumChannels(), 2);
+            expectEquals(packed->getLengthInFrames(), static_cast<juce::int64>(length));
+            expectLessThan(packed->getBytes(), packed->getFloatBytes() / 2 + 1024);
+            expectEquals(getMaxDifference(packed->toBuffer(), audio16), 0.0f);
+        }
+
+        beginTest("Other audio packs to 24 bits, far below audibility");
+        {
+            auto packed = CompactAudio::fromBuffer(audio24, CompactAudio::Format::Packed);
+            expectEquals(packed->getBitDepth(), 24);
+            expectLessThan(packed->getBytes(), packed->getFloatBytes() * 3 / 4 + 1024);
+            expectLessOrEqual(getMaxDifference(packed->toBuffer(), audio24), 0.5f / 8388608.0f);
+
+            // Beyond full scale is kept, not clipped
+            juce::AudioBuffer<float> loud(audio24);
+            loud.applyGain(3.0f);
+            auto loudPacked = CompactAudio::fromBuffer(loud, CompactAudio::Format::Packed);
+            expectLessOrEqual(getMaxDifference(loudPacked->toBuffer(), loud), 2.0f / 8388608.0f);
+
+            juce::AudioBuffer<float> broken(audio24);
+            broken.setSample(1, 100, std::numeric_limits<float>::quiet_NaN());
+            expect(CompactAudio::fromBuffer(broken, CompactAudio::Format::Packed) == nullptr);
+        }
+
+        beginTest("Lossless blocks decode to exactly the packed samples, and smaller");
+        {
+            for (const auto* source : { &audio16, &audio24 })
+            {
+                auto packed = CompactAudio::fromBuffer(*source, CompactAudio::Format::Packed);
+                auto lossless = CompactAudio::fromBuffer(*source, CompactAudio::Format::Lossless);
+
+                expectEquals(lossless->getBitDepth(), packed->getBitDepth());
+                expectEquals(getMaxDifference(lossless->toBuffer(), packed->toBuffer()), 0.0f);
+                expectLessThan(lossless->getBytes(), packed->getBytes() * 3 / 4);
+            }
+        }
+
+        beginTest("Reads start anywhere, across blocks and past either end");
+        {
+            auto lossless = CompactAudio::fromBuffer(audio24, CompactAudio::Format::Lossless);
+            const auto whole = lossless->toBuffer();
+
+            juce::AudioBuffer<float> piece(2, 3000);
+            for (const juce::int64 start : { (juce::int64)0, (juce::int64)1000, (juce::int64)1023,
+                                             (juce::int64)4097, (juce::int64)(length - 2000), (juce::int64)-500 })
+            {
+                lossless->read(piece.getArrayOfWritePointers(), 2, start, piece.getNumSamples());
+
+                float difference = 0.0f;
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    for (int i = 0; i < piece.getNumSamples(); ++i)
+                    {
+                        const auto frame = start + i;
+                        const float expected = frame >= 0 && frame < length ? whole.getSample(ch, static_cast<int>(frame)) : 0.0f;
+                        difference = juce::jmax(difference, std::abs(piece.getSample(ch, i) - expected));
+                    }
+                }
+                expectEquals(difference, 0.0f);
+            }
+
+            // Channels it doesn't have are silent
+            float extra[16] = { 1.0f };
+            lossless->readChannel(2, extra, 0, 16);
+            expectEquals(juce::FloatVectorOperations::findMaximum(extra, 16), 0.0f);
+        }
+
+        //======================================================================
+        beginTest("The pool shares compact copies and lets go of the floats");
+        {
+            auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                               .getChildFile("ProgFlowCompactAudioTests");
+            tempDir.deleteRecursively();
+            tempDir.createDirectory();
+
+            auto file = tempDir.getChildFile("music.raw");
+            file.replaceWithText("stands in for an audio file");
+
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache"));
+
+            int decodes = 0;
+            auto decoder = [&](juce::AudioBuffer<float>& dest, double& sampleRate)
+            {
+                ++decodes;
+                dest = audio16;
+                sampleRate = 48000.0;
+                return true;
+            };
+
+            double rate = 0.0;
+            auto first = pool.getOrLoadCompact(file, 0.0, CompactAudio::Format::Lossless, decoder, rate);
+            auto second = pool.getOrLoadCompact(file, 0.0, CompactAudio::Format::Lossless, decoder, rate);
+
+            expect(first != nullptr);
+            expect(first == second);
+            expectEquals(decodes, 1);
+            expectEquals(rate, 48000.0);
+            expectEquals(pool.getResidentBytes(), (juce::int64)0);
+            expectEquals(pool.getCompactBytes(), first->getBytes());
+
+            // Peaks come from the compact copy
+            auto peaks = pool.getPeaks(first);
+            expect(peaks != nullptr);
+            expectEquals(peaks->getLengthInFrames(), static_cast<juce::int64>(length));
+            expect(pool.getPeaks(first) == peaks);
+
+            // Once no clip holds it, the next load makes a new one
+            first.reset();
+            second.reset();
+            expectEquals(pool.getCompactBytes(), (juce::int64)0);
+
+            auto again = pool.getOrLoadCompact(file, 0.0, CompactAudio::Format::Packed, decoder, rate);
+            expect(again != nullptr);
+            expect(again->getFormat() == CompactAudio::Format::Packed);
+
+            tempDir.deleteRecursively();
+        }
+
+        //======================================================================
+        beginTest("Compact clips play like float clips");
+        {
+            for (const double sampleRate : { 48000.0, 44100.0 })
+            {
+                AudioClip floatClip;
+                floatClip.setAudioBuffer(audio16, 48000.0);
+                floatClip.setFadeInSamples(2000);
+                floatClip.setTrimStartSample(300);
+
+                AudioClip compactClip;
+                compactClip.setCompactAudio(CompactAudio::fromBuffer(audio16, CompactAudio::Format::Lossless), 48000.0);
+                compactClip.setFadeInSamples(2000);
+                compactClip.setTrimStartSample(300);
+
+                expect(compactClip.isCompact());
+                expectEquals(compactClip.getDurationInSamples(), floatClip.getDurationInSamples());
+                expectEquals(compactClip.getSample(1, 12345), floatClip.getSample(1, 12345));
+
+                const auto fromFloats = renderClip(floatClip, sampleRate);
+                const auto fromCompact = renderClip(compactClip, sampleRate);
+                expect(fromFloats.getMagnitude(0, fromFloats.getNumSamples()) > 0.1f);
+                expectLessThan(getMaxDifference(fromCompact, fromFloats), 1.0e-5f);
+            }
+        }
+
+        beginTest("The project's memory counts each source once");
+        {
+            AudioEngine engine;
+            engine.addTrack(std::make_unique<Track>("Audio"));
+            auto* track = engine.getTrack(0);
+
+            auto compact = CompactAudio::fromBuffer(audio16, CompactAudio::Format::Packed);
+            for (int i = 0; i < 3; ++i)
+                track->addAudioClip(static_cast<double>(i))->setCompactAudio(compact, 48000.0);
+            track->addAudioClip(8.0)->setAudioBuffer(audio24, 48000.0);
+
+            const auto usage = engine.getAudioMemoryUsage();
+            const juce::int64 floatBytes = 2 * length * static_cast<juce::int64>(sizeof(float));
+
+            expectEquals(usage.numSources, 2);
+            expectEquals(usage.numCompactSources, 1);
+            expectEquals(usage.clipBytes, compact->getBytes() + floatBytes);
+            expectEquals(usage.floatBytes, 2 * floatBytes);
+        }
+    }
+
+private:
+    // Two detuned tones, one an octave up, with a little noise; quantised to 16 bits if asked
+    static juce::AudioBuffer<float> makeMusic(int length, bool sixteenBit)
+    {
+        juce::AudioBuffer<float> audio(2, length);
+        juce::Random random(42);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                const double t = i / 48000.0;
+                float value = 0.3f * static_cast<float>(std::sin(2.0 * juce::MathConstants<double>::pi * (220.0 + ch) * t))
+                            + 0.2f * static_cast<float>(std::sin(2.0 * juce::MathConstants<double>::pi * 441.0 * t))
+                            + 0.001f * (random.nextFloat() - 0.5f);
+                if (sixteenBit)
+                    value = std::round(value * 32768.0f) / 32768.0f;
+                audio.setSample(ch, i, value);
+            }
+        }
+
+        return audio;
+    }
+
+    static float getMaxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        float difference = 0.0f;
+        for (int ch = 0; ch < juce::jmin(a.getNumChannels(), b.getNumChannels()); ++ch)
+            for (int i = 0; i < juce::jmin(a.getNumSamples(), b.getNumSamples()); ++i)
+                difference = juce::jmax(difference, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+        return difference;
+    }
+
+    static juce::AudioBuffer<float> renderClip(const AudioClip& clip, double sampleRate)
+    {
+        std::vector<std::unique_ptr<AudioClip>> clips;
+        clips.push_back(std::make_unique<AudioClip>());
+        clips.back()->takeAudioFrom(clip);
+        clips.back()->setTrimStartSample(clip.getTrimStartSample());
+        clips.back()->setFadeInSamples(clip.getFadeInSamples());
+        clips.back()->setStartBeat(0.1);
+
+        return TestHelpers::renderBlocks(clips, sampleRate, 20 * 512);
+    }
+};
+
+// Register the test
+static CompactAudioTests compactAudioTests;
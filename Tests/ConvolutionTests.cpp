@@ -0,0 +1,282 @@
+/**
+ * Convolution Unit Tests - Partitioned engine accuracy, IR loading and the IR effects
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/Effects/ConvolutionEngine.h"
+#include "../Source/Audio/Effects/ConvolutionReverbEffect.h"
+#include "../Source/Audio/Effects/CabinetEffect.h"
+#include "TestHelpers.h"
+#include <cmath>
+#include <vector>
+
+class ConvolutionTests : public juce::UnitTest
+{
+public:
+    ConvolutionTests() : UnitTest("Convolution") {}
+
+    void runTest() override
+    {
+        auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                           .getChildFile("ProgFlowConvolutionTests");
+        tempDir.deleteRecursively();
+        tempDir.createDirectory();
+
+        //======================================================================
+        beginTest("Partitioned convolution matches direct convolution with no latency");
+        {
+            // Sparse taps spread over the direct part and every stage size,
+            // including the worker stages
+            const std::vector<std::pair<int, float>> taps {
+                { 0, 0.9f }, { 5, -0.4f }, { 63, 0.3f }, { 64, 0.25f }, { 200, -0.2f },
+                { 700, 0.15f }, { 2047, -0.1f }, { 2048, 0.12f }, { 5000, 0.08f },
+                { 9000, -0.06f }, { 20000, 0.05f }, { 33000, -0.04f }, { 39999, 0.03f }
+            };
+
+            juce::AudioBuffer<float> ir(1, 40000);
+            ir.clear();
+            for (const auto& [position, value] : taps)
+                ir.setSample(0, position, value);
+
+            ConvolutionEngine engine;
+            engine.setKernel(ConvolutionEngine::createKernel(ir));
+            expectEquals(engine.getImpulseResponseLength(), 40000);
+
+            const int length = 60000;
+            juce::AudioBuffer<float> input(2, length);
+            juce::Random random(42);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < length; ++i)
+                    input.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+            // Awkward block sizes so stage boundaries land mid-block
+            juce::AudioBuffer<float> output(input);
+            const int blockSizes[] = { 37, 512, 1000, 64, 4096, 1 };
+            int position = 0;
+            for (int b = 0; position < length; ++b)
+            {
+                const int blockSize = std::min(blockSizes[b % 6], length - position);
+                juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, position, blockSize);
+                engine.process(block, blockSize);
+                position += blockSize;
+            }
+
+            // Mono IR is applied to both channels
+            float maxError = 0.0f;
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < length; i += 7)
+                {
+                    float expected = 0.0f;
+                    for (const auto& [tap, value] : taps)
+                        if (i >= tap)
+                            expected += value * input.getSample(ch, i - tap);
+
+                    maxError = std::max(maxError, std::abs(output.getSample(ch, i) - expected));
+                }
+            }
+            expectLessThan(maxError, 1.0e-3f);
+        }
+
+        beginTest("Short impulse responses use only the direct part");
+        {
+            juce::AudioBuffer<float> ir(1, 3);
+            ir.setSample(0, 0, 0.5f);
+            ir.setSample(0, 1, 0.25f);
+            ir.setSample(0, 2, 0.125f);
+
+            ConvolutionEngine engine;
+            engine.setKernel(ConvolutionEngine::createKernel(ir));
+
+            juce::AudioBuffer<float> buffer(1, 8);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            engine.process(buffer, 8);
+
+            expectWithinAbsoluteError(buffer.getSample(0, 0), 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError(buffer.getSample(0, 1), 0.25f, 1.0e-6f);
+            expectWithinAbsoluteError(buffer.getSample(0, 2), 0.125f, 1.0e-6f);
+            expectWithinAbsoluteError(buffer.getSample(0, 3), 0.0f, 1.0e-6f);
+        }
+
+        beginTest("Clearing the IR passes audio through");
+        {
+            juce::AudioBuffer<float> ir(1, 1);
+            ir.setSample(0, 0, 0.5f);
+
+            ConvolutionEngine engine;
+            engine.setKernel(ConvolutionEngine::createKernel(ir));
+            engine.clearImpulseResponse();
+            expect(!engine.hasImpulseResponse());
+
+            juce::AudioBuffer<float> buffer(1, 4);
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(0), 1.0f, 4);
+            engine.process(buffer, 4);
+            expectEquals(buffer.getSample(0, 3), 1.0f);
+        }
+
+        //======================================================================
+        beginTest("IR files load in the background and share kernels");
+        {
+            juce::AudioBuffer<float> ir(2, 3000);
+            ir.clear();
+            ir.setSample(0, 0, 0.5f);
+            ir.setSample(0, 2999, 0.25f);
+            ir.setSample(1, 100, -0.5f);
+
+            auto file = tempDir.getChildFile("cab.wav");
+            expect(TestHelpers::writeAudioFile(file, ir, 44100.0));
+
+            const int kernelsBefore = ConvolutionEngine::getNumCachedKernels();
+
+            ConvolutionEngine first, second;
+            first.loadImpulseResponse(file, 44100.0, false);
+            second.loadImpulseResponse(file, 44100.0, false);
+            expect(waitForLoad(first) && waitForLoad(second));
+
+            expectEquals(first.getImpulseResponseLength(), 3000);
+            expectEquals(ConvolutionEngine::getNumCachedKernels(), kernelsBefore + 1);
+
+            juce::AudioBuffer<float> buffer(2, 4096);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            buffer.setSample(1, 0, 1.0f);
+            first.process(buffer, 4096);
+
+            expectWithinAbsoluteError(buffer.getSample(0, 0), 0.5f, 1.0e-4f);
+            expectWithinAbsoluteError(buffer.getSample(0, 2999), 0.25f, 1.0e-4f);
+            expectWithinAbsoluteError(buffer.getSample(1, 100), -0.5f, 1.0e-4f);
+            expectWithinAbsoluteError(buffer.getSample(1, 0), 0.0f, 1.0e-4f);
+        }
+
+        beginTest("IRs are resampled to the processing rate");
+        {
+            juce::AudioBuffer<float> ir(1, 48000);
+            for (int i = 0; i < 48000; ++i)
+                ir.setSample(0, i, 0.5f * std::exp(-static_cast<float>(i) / 4800.0f));
+
+            auto file = tempDir.getChildFile("hall48k.wav");
+            expect(TestHelpers::writeAudioFile(file, ir, 48000.0));
+
+            ConvolutionEngine engine;
+            engine.loadImpulseResponse(file, 96000.0, false);
+            expect(waitForLoad(engine));
+
+            // Trimmed at -100 dB, so a little under the full doubled length
+            expectGreaterThan(engine.getImpulseResponseLength(), 80000);
+            expectLessOrEqual(engine.getImpulseResponseLength(), 96001);
+        }
+
+        beginTest("Missing files keep the previous IR");
+        {
+            juce::AudioBuffer<float> ir(1, 1);
+            ir.setSample(0, 0, 0.5f);
+
+            ConvolutionEngine engine;
+            engine.setKernel(ConvolutionEngine::createKernel(ir));
+            engine.loadImpulseResponse(tempDir.getChildFile("missing.wav"), 44100.0);
+            expect(waitForLoad(engine));
+            expectEquals(engine.getImpulseResponseLength(), 1);
+        }
+
+        //======================================================================
+        beginTest("Convolution reverb produces a long tail");
+        {
+            ConvolutionReverbEffect reverb;
+            reverb.setParameter("decay", 1.0f);
+            reverb.setParameter("predelay", 0.0f);
+            reverb.prepareToPlay(44100.0, 512);
+            expect(waitForLoad(reverb));
+            expectGreaterThan(reverb.getImpulseResponseLength(), 44100);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            buffer.setSample(1, 0, 1.0f);
+
+            float lateEnergy = 0.0f;
+            for (int block = 0; block < 100; ++block)
+            {
+                reverb.processBlock(buffer);
+                expectNoNaNOrInf(buffer);
+                if (block > 40)
+                    lateEnergy += buffer.getMagnitude(0, 512);
+                buffer.clear();
+            }
+
+            expectGreaterThan(lateEnergy, 0.0f);
+        }
+
+        beginTest("Cabinet IR mode convolves and falls back without an IR");
+        {
+            CabinetEffect cabinet;
+            cabinet.setParameter("mode", 1.0f);
+            cabinet.setParameter("lowCut", 30.0f);
+            cabinet.setParameter("highCut", 12000.0f);
+            cabinet.prepareToPlay(44100.0, 512);
+
+            // No IR yet - the model still makes sound
+            juce::AudioBuffer<float> buffer(2, 512);
+            fillSine(buffer, 440.0f);
+            cabinet.processBlock(buffer);
+            expectGreaterThan(buffer.getMagnitude(0, 512), 0.0f);
+
+            // An IR that silences the left channel
+            juce::AudioBuffer<float> ir(2, 512);
+            ir.clear();
+            ir.setSample(1, 0, 1.0f);
+            auto file = tempDir.getChildFile("right_only.wav");
+            expect(TestHelpers::writeAudioFile(file, ir, 44100.0));
+
+            cabinet.loadImpulseResponse(file);
+            for (int i = 0; i < 500 && (cabinet.isImpulseResponseLoading() || !cabinet.isImpulseResponseLoaded()); ++i)
+                juce::Thread::sleep(10);
+            expect(cabinet.isImpulseResponseLoaded());
+
+            for (int block = 0; block < 4; ++block)
+            {
+                fillSine(buffer, 440.0f);
+                cabinet.processBlock(buffer);
+            }
+            expectLessThan(buffer.getMagnitude(0, 0, 512), 1.0e-3f);
+            expectGreaterThan(buffer.getMagnitude(1, 0, 512), 0.1f);
+        }
+
+        tempDir.deleteRecursively();
+    }
+
+private:
+    template <typename Loader>
+    static bool waitForLoad(const Loader& loader)
+    {
+        for (int i = 0; i < 500 && loader.isLoading(); ++i)
+            juce::Thread::sleep(10);
+        return !loader.isLoading();
+    }
+
+    static bool waitForLoad(const ConvolutionReverbEffect& reverb)
+    {
+        for (int i = 0; i < 500 && (reverb.isImpulseResponseLoading() || reverb.getImpulseResponseLength() == 0); ++i)
+            juce::Thread::sleep(10);
+        return reverb.getImpulseResponseLength() > 0;
+    }
+
+    static void fillSine(juce::AudioBuffer<float>& buffer, float frequency)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, 0.5f * std::sin(juce::MathConstants<float>::twoPi * frequency * i / 44100.0f));
+    }
+
+    void expectNoNaNOrInf(const juce::AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                expect(std::isfinite(buffer.getSample(ch, i)), "Sample should be finite");
+    }
+};
+
+// Register the test
+static ConvolutionTests convolutionTests;
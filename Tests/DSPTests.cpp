@@ -16,6 +16,38 @@
 #include "../Source/Audio/Effects/FilterEffect.h"
 #include "../Source/Audio/Effects/LimiterEffect.h"
 #include "../Source/Audio/Effects/GateEffect.h"
+#include <atomic>
+#include <thread>
+
+/** Scales the signal and reports where it was destroyed */
+class GainEffect : public EffectBase
+{
+public:
+    GainEffect(float gainToUse, std::atomic<bool>* destroyedFlag = nullptr,
+               std::atomic<bool>* destroyedOnThreadFlag = nullptr,
+               juce::Thread::ThreadID threadToWatch = nullptr)
+        : gain(gainToUse), destroyed(destroyedFlag),
+          destroyedOnThread(destroyedOnThreadFlag), watchedThread(threadToWatch) {}
+
+    ~GainEffect() override
+    {
+        if (destroyedOnThread != nullptr)
+            destroyedOnThread->store(juce::Thread::getCurrentThreadId() == watchedThread);
+        if (destroyed != nullptr)
+            destroyed->store(true);
+    }
+
+    juce::String getName() const override { return "Gain"; }
+
+protected:
+    void processEffect(juce::AudioBuffer<float>& buffer) override { buffer.applyGain(gain); }
+
+private:
+    float gain;
+    std::atomic<bool>* destroyed;
+    std::atomic<bool>* destroyedOnThread;
+    juce::Thread::ThreadID watchedThread;
+};
 
 class DSPTests : public juce::UnitTest
 {
@@ -68,6 +100,95 @@ public:
             }
         }
 
+        beginTest("EffectChain edits take effect at the next block");
+        {
+            EffectChain chain;
+            chain.prepareToPlay(44100.0, 512);
+            chain.addEffect(std::make_unique<GainEffect>(0.5f));
+            chain.addEffect(std::make_unique<GainEffect>(0.25f));
+
+            juce::AudioBuffer<float> buffer(2, 64);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            chain.processBlock(buffer);
+            expectWithinAbsoluteError(buffer.getSample(0, 0), 0.125f, 1.0e-6f);
+
+            chain.setSlotBypass(1, true);
+            expect(chain.isSlotBypassed(1));
+
+            buffer.setSample(0, 0, 1.0f);
+            chain.processBlock(buffer);
+            expectWithinAbsoluteError(buffer.getSample(0, 0), 0.5f, 1.0e-6f);
+        }
+
+        beginTest("EffectChain releases removed effects on the release thread");
+        {
+            std::atomic<bool> destroyed{false};
+            std::atomic<bool> destroyedOnCaller{false};
+            const auto callerThread = juce::Thread::getCurrentThreadId();
+
+            EffectChain chain;
+            chain.prepareToPlay(44100.0, 512);
+            chain.addEffect(std::make_unique<GainEffect>(1.0f, &destroyed, &destroyedOnCaller, callerThread));
+
+            juce::AudioBuffer<float> buffer(2, 64);
+            buffer.clear();
+            chain.processBlock(buffer);    // Audio thread now uses the effect
+
+            expect(chain.removeEffect(0));
+            expectEquals(chain.getNumEffects(), 0);
+            expect(!destroyed.load(), "Effect must outlive the topology still using it");
+
+            chain.processBlock(buffer);    // Swaps in the empty topology
+
+            for (int i = 0; i < 100 && !destroyed.load(); ++i)
+                juce::Thread::sleep(20);
+
+            expect(destroyed.load());
+            expect(!destroyedOnCaller.load(), "Effect should be destroyed off the editing thread");
+        }
+
+        beginTest("EffectChain survives reordering during processing");
+        {
+            EffectChain chain;
+            chain.prepareToPlay(44100.0, 256);
+            chain.addEffect(std::make_unique<ReverbEffect>());
+            chain.addEffect(std::make_unique<DelayEffect>());
+            chain.addEffect(std::make_unique<FilterEffect>());
+
+            std::atomic<bool> done{false};
+            std::thread audioThread([&]
+            {
+                juce::AudioBuffer<float> block(2, 256);
+                while (!done.load())
+                {
+                    for (int i = 0; i < block.getNumSamples(); ++i)
+                    {
+                        block.setSample(0, i, (i % 32) == 0 ? 0.5f : 0.0f);
+                        block.setSample(1, i, (i % 32) == 0 ? 0.5f : 0.0f);
+                    }
+                    chain.processBlock(block);
+                }
+            });
+
+            for (int i = 0; i < 500; ++i)
+            {
+                chain.moveEffect(i % 3, (i + 1) % 3);
+                chain.setSlotBypass(i % 3, (i % 2) == 0);
+
+                if (i % 50 == 0)
+                {
+                    chain.removeEffect(2);
+                    chain.insertEffect(0, std::make_unique<ChorusEffect>());
+                }
+            }
+
+            done.store(true);
+            audioThread.join();
+
+            expectEquals(chain.getNumEffects(), 3);
+        }
+
         //======================================================================
         // Individual Effect Tests
         //======================================================================
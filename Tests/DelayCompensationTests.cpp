@@ -0,0 +1,249 @@
+/**
+ * Delay Compensation Unit Tests - Compensation delays, graph alignment and engine latency
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/CompensationDelay.h"
+#include "../Source/Audio/MixerGraph.h"
+#include "../Source/Audio/AudioEngine.h"
+#include "../Source/Audio/Effects/ParametricEQEffect.h"
+#include "../Source/Audio/Effects/LinearPhaseEQ.h"
+#include <array>
+#include <cmath>
+
+class DelayCompensationTests : public juce::UnitTest
+{
+public:
+    DelayCompensationTests() : UnitTest("Delay Compensation") {}
+
+    void runTest() override
+    {
+        using Node = MixerGraph::NodeInfo;
+        constexpr int M = MixerGraph::MASTER;
+
+        //======================================================================
+        beginTest("Compensation delay is a pure delay");
+        {
+            CompensationDelay delay;
+            delay.setDelay(700);
+
+            juce::AudioBuffer<float> buffer(2, 1024);
+            buffer.clear();
+            buffer.setSample(0, 3, 1.0f);
+            buffer.setSample(1, 3, -1.0f);
+
+            // Odd block sizes across the ring's wrap
+            for (int position = 0; position < 1024; position += 100)
+            {
+                const int n = std::min(100, 1024 - position);
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, position, n);
+                delay.process(block, n);
+            }
+
+            expectEquals(buffer.getSample(0, 703), 1.0f);
+            expectEquals(buffer.getSample(1, 703), -1.0f);
+            buffer.setSample(0, 703, 0.0f);
+            buffer.setSample(1, 703, 0.0f);
+            expectEquals(buffer.getMagnitude(0, 1024), 0.0f);
+        }
+
+        beginTest("Changing the delay while audio passes crossfades");
+        {
+            CompensationDelay delay;
+
+            const int length = 44100;
+            juce::AudioBuffer<float> buffer(1, length);
+            for (int i = 0; i < length; ++i)
+                buffer.setSample(0, i, 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 220.0 * i / 44100.0)));
+
+            for (int position = 0; position < length; position += 256)
+            {
+                // An odd number of half periods, the worst case for a cut
+                if (position == 256 * 20)
+                    delay.setDelay(201);
+
+                // Further back than anything stored: fades out and back in
+                if (position == 256 * 60)
+                {
+                    expect(delay.isHoldingAudio());
+                    delay.setDelay(201 + 2706);
+                }
+
+                const int n = std::min(256, length - position);
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 1, position, n);
+                delay.process(block, n);
+            }
+
+            float largestStep = 0.0f;
+            for (int i = 1; i < length; ++i)
+                largestStep = std::max(largestStep, std::abs(buffer.getSample(0, i) - buffer.getSample(0, i - 1)));
+
+            // A 220 Hz sine at 0.5 moves at most ~0.016 per sample
+            expectLessThan(largestStep, 0.03f);
+        }
+
+        beginTest("Changing the delay over silence takes effect at once");
+        {
+            CompensationDelay delay;
+            delay.setDelay(50);
+
+            juce::AudioBuffer<float> buffer(2, 256);
+            buffer.clear();
+            delay.process(buffer, 256);
+            expect(!delay.isHoldingAudio());
+
+            delay.setDelay(10);
+            buffer.setSample(0, 0, 1.0f);
+            delay.process(buffer, 256);
+            expectEquals(buffer.getSample(0, 10), 1.0f);
+            expectEquals(buffer.getMagnitude(0, 0, 10), 0.0f);
+        }
+
+        //======================================================================
+        beginTest("Graph delays the shorter paths to the slowest one");
+        {
+            // 0 (100) -> master; 1 (0) and 2 (300) -> group 3 (50) -> master
+            std::vector<Node> nodes { { M, {}, 100 }, { 3, {}, 0 }, { 3, {}, 300 }, { M, {}, 50 } };
+
+            MixerGraph graph;
+            expect(graph.compile(nodes, 2, 128));
+
+            expectEquals(graph.getNodeCompensation(0), 250);
+            expectEquals(graph.getNodeCompensation(1), 300);
+            expectEquals(graph.getNodeCompensation(2), 0);
+            expectEquals(graph.getNodeCompensation(3), 0);
+            expectEquals(graph.getLatencySamples(), 350);
+
+            LatentProcessor processor(nodes);
+            juce::AudioBuffer<float> output(2, 1024);
+            output.clear();
+            for (int position = 0; position < 1024; position += 128)
+            {
+                juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, position, 128);
+                graph.process(block, 128, processor);
+            }
+
+            // Every track's impulse lands on the same sample
+            expectWithinAbsoluteError(output.getSample(0, 350), 3.0f, 1.0e-6f);
+            output.setSample(0, 350, 0.0f);
+            expectEquals(output.getMagnitude(0, 0, 1024), 0.0f);
+        }
+
+        beginTest("Graph latency can be raised for audio outside it");
+        {
+            std::vector<Node> nodes { { M, {}, 10 }, { M, {}, 0 } };
+
+            MixerGraph graph;
+            graph.compile(nodes, 2, 128, 64);
+            expectEquals(graph.getLatencySamples(), 64);
+            expectEquals(graph.getNodeCompensation(0), 54);
+            expectEquals(graph.getNodeCompensation(1), 64);
+        }
+
+        //======================================================================
+        beginTest("Engine compensates tracks and return buses");
+        {
+            AudioEngine engine;
+            engine.prepareToPlay(512, 44100.0);
+            const int eqLatency = LinearPhaseEQ::BLOCK_SIZE + LinearPhaseEQ::kernelLengthFor(44100.0) / 2;
+
+            engine.addTrack(std::make_unique<Track>("Linear EQ"));
+            engine.addTrack(std::make_unique<Track>("Plain"));
+            expectEquals(engine.getLatencySamples(), 0);
+
+            engine.getTrack(0)->getEffectChain().addEffect(makeLinearPhaseEQ());
+            engine.updateLatencyCompensation();
+
+            expectEquals(engine.getLatencySamples(), eqLatency);
+            expectEquals(engine.getTrack(0)->getLatencyCompensation(), 0);
+            expectEquals(engine.getTrack(1)->getLatencyCompensation(), eqLatency);
+
+            // A return with latency of its own: tracks stay aligned for the
+            // sends, and go to the master late enough to meet the return
+            const int slot = engine.addReturnBus("Linear Return");
+            engine.getReturnBus(slot)->getEffectChain().addEffect(makeLinearPhaseEQ());
+            engine.updateLatencyCompensation();
+
+            expectEquals(engine.getLatencySamples(), 2 * eqLatency);
+            expectEquals(engine.getTrack(1)->getLatencyCompensation(), eqLatency);
+            expectEquals(engine.getMixerGraph().getNodeCompensation(0), eqLatency);
+            expectEquals(engine.getReturnBus(slot)->getLatencyCompensation(), 0);
+
+            // Unchanged latencies don't recompile; bypassing the EQ does
+            engine.updateLatencyCompensation();
+            engine.getReturnBus(slot)->getEffectChain().setSlotBypass(0, true);
+            engine.updateLatencyCompensation();
+            expectEquals(engine.getLatencySamples(), eqLatency);
+            expectEquals(engine.getMixerGraph().getNodeCompensation(0), 0);
+            expectEquals(engine.getReturnBus(slot)->getLatencyCompensation(), 0);
+        }
+
+        beginTest("Audible position trails the playhead by the latency");
+        {
+            AudioEngine engine;
+            engine.prepareToPlay(512, 44100.0);
+            engine.addTrack(std::make_unique<Track>("Linear EQ"));
+            engine.getTrack(0)->getEffectChain().addEffect(makeLinearPhaseEQ());
+            engine.updateLatencyCompensation();
+
+            engine.setPositionInBeats(8.0);
+            expectEquals(engine.getAudiblePositionInBeats(), 8.0);
+
+            engine.setBpm(120.0);
+            engine.play();
+            const double latencyBeats = engine.getLatencySamples() * 2.0 / 44100.0;
+            expectWithinAbsoluteError(engine.getAudiblePositionInBeats(), engine.getPositionInBeats() - latencyBeats, 1.0e-9);
+            engine.stop();
+        }
+    }
+
+private:
+    static std::unique_ptr<EffectBase> makeLinearPhaseEQ()
+    {
+        auto eq = std::make_unique<ParametricEQEffect>();
+        eq->setParameter("phase", 1.0f);
+        return eq;
+    }
+
+    /**
+     * Tracks emit an impulse their latency into the first block; groups
+     * delay their input by their latency
+     */
+    struct LatentProcessor : MixerGraph::NodeProcessor
+    {
+        explicit LatentProcessor(const std::vector<MixerGraph::NodeInfo>& nodes)
+            : delays(nodes.size())
+        {
+            for (size_t n = 0; n < nodes.size(); ++n)
+            {
+                latencies.push_back(nodes[n].latency);
+                delays[n].setDelay(nodes[n].latency);
+            }
+        }
+
+        void provideSidechain(int, int, const juce::AudioBuffer<float>&) override {}
+
+        void processNode(int node, juce::AudioBuffer<float>& buffer, int numSamples, int) override
+        {
+            const auto n = static_cast<size_t>(node);
+            if (node <= 2)
+            {
+                if (position[n] <= latencies[n] && latencies[n] < position[n] + numSamples)
+                    buffer.setSample(0, latencies[n] - position[n], 1.0f);
+                position[n] += numSamples;
+            }
+            else
+            {
+                delays[n].process(buffer, numSamples);
+            }
+        }
+
+        std::vector<int> latencies;
+        std::vector<CompensationDelay> delays;
+        std::array<int, 4> position {};
+    };
+};
+
+// Register the test
+static DelayCompensationTests delayCompensationTests;
@@ -254,6 +254,96 @@ public:
             expect(rms > 0.01f);
         }
 
+        beginTest("Output scales exactly with velocity");
+        {
+            DrumSynth loud, soft;
+            loud.prepareToPlay(44100.0, 512);
+            soft.prepareToPlay(44100.0, 512);
+
+            loud.noteOn(38, 1.0f);
+            soft.noteOn(38, 0.5f);
+
+            juce::AudioBuffer<float> loudBuffer(2, 512), softBuffer(2, 512);
+            juce::MidiBuffer midi;
+            loud.processBlock(loudBuffer, midi);
+            soft.processBlock(softBuffer, midi);
+
+            // Both synths play the same cached render
+            for (int i = 0; i < 512; ++i)
+                expectWithinAbsoluteError(softBuffer.getSample(0, i), loudBuffer.getSample(0, i) * 0.5f, 1.0e-6f);
+        }
+
+        beginTest("Note starts at its MIDI sample position");
+        {
+            DrumSynth drums;
+            drums.prepareToPlay(44100.0, 512);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::noteOn(10, 36, 1.0f), 256);
+            drums.processBlock(buffer, midi);
+
+            expect(buffer.getRMSLevel(0, 0, 256) == 0.0f);
+            expect(buffer.getRMSLevel(0, 256, 256) > 0.01f);
+        }
+
+        beginTest("Changing pad sound re-renders the one-shot");
+        {
+            DrumSynth drums;
+            drums.prepareToPlay(44100.0, 512);
+
+            juce::AudioBuffer<float> before(2, 512), after(2, 512);
+            juce::MidiBuffer midi;
+
+            drums.noteOn(36, 1.0f);
+            drums.processBlock(before, midi);
+
+            drums.setPadParameter(0, "pitch", 2.0f);
+            drums.noteOn(36, 1.0f);
+            drums.processBlock(after, midi);
+
+            float difference = 0.0f;
+            for (int i = 0; i < 512; ++i)
+                difference += std::abs(after.getSample(0, i) - before.getSample(0, i));
+
+            expect(difference > 0.1f, "Pitch change should alter the kick");
+        }
+
+        beginTest("Synths with the same kit share rendered one-shots");
+        {
+            juce::SharedResourcePointer<DrumOneShotCache> cache;
+
+            DrumSynth first;
+            first.prepareToPlay(44100.0, 512);
+            const int cached = cache->getNumCached();
+
+            DrumSynth second;
+            second.prepareToPlay(44100.0, 512);
+            expectEquals(cache->getNumCached(), cached);
+        }
+
+        beginTest("Choked pad fades out instead of cutting");
+        {
+            DrumSynth drums;
+            drums.prepareToPlay(44100.0, 512);
+            drums.setPadParameter(2, "level", 0.0f); // Silence the closed hat
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::MidiBuffer midi;
+
+            drums.noteOn(46, 1.0f); // Open HH
+            drums.processBlock(buffer, midi);
+
+            drums.noteOn(42, 1.0f); // Closed HH chokes open
+            expect(!drums.isNoteActive(46));
+
+            drums.processBlock(buffer, midi);
+
+            // Tail of the open hat is still audible at the start, gone after ~3 ms
+            expect(buffer.getMagnitude(0, 0, 32) > 0.0f);
+            expectEquals(buffer.getMagnitude(0, 200, 312), 0.0f);
+        }
+
         //======================================================================
         // Presets
         //======================================================================
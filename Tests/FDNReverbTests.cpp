@@ -0,0 +1,267 @@
+/**
+ * FDN Reverb Unit Tests - Decay, stereo, quality presets and cost against Freeverb
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/Effects/FDNReverb.h"
+#include "../Source/Audio/Effects/ReverbEffect.h"
+#include <cmath>
+#include <vector>
+
+class FDNReverbTests : public juce::UnitTest
+{
+public:
+    FDNReverbTests() : UnitTest("FDN Reverb") {}
+
+    void runTest() override
+    {
+        const double sampleRate = 44100.0;
+
+        //======================================================================
+        beginTest("Tail decays at the rate set by the room size");
+        {
+            auto small = renderImpulse(0.3f, 0.0f, FDNReverb::Quality::Standard, 2.0);
+            auto large = renderImpulse(0.9f, 0.0f, FDNReverb::Quality::Standard, 2.0);
+
+            // Drop from the early tail to one second later
+            const float smallDrop = levelDb(small, 4410, 8820) - levelDb(small, 44100, 48510);
+            const float largeDrop = levelDb(large, 4410, 8820) - levelDb(large, 44100, 48510);
+
+            // RT60 of ~0.9 s vs ~6.7 s
+            expectGreaterThan(smallDrop, 45.0f);
+            expectLessThan(largeDrop, 25.0f);
+        }
+
+        beginTest("Pre-delay holds back the tail");
+        {
+            auto direct = renderImpulse(0.3f, 0.0f, FDNReverb::Quality::Standard, 0.2);
+            auto delayed = renderImpulse(0.3f, 50.0f, FDNReverb::Quality::Standard, 0.2);
+
+            const int fiftyMs = static_cast<int>(sampleRate * 0.05);
+            expectGreaterThan(direct.getMagnitude(0, 0, fiftyMs), 0.0f);
+            expectEquals(delayed.getMagnitude(0, 0, fiftyMs), 0.0f);
+            expectGreaterThan(delayed.getMagnitude(0, fiftyMs, delayed.getNumSamples() - fiftyMs), 0.0f);
+        }
+
+        beginTest("Width controls the stereo spread");
+        {
+            FDNReverb reverb;
+            FDNReverb::Parameters params;
+            params.width = 0.0f;
+            reverb.setParameters(params);
+            reverb.prepare(sampleRate);
+
+            juce::AudioBuffer<float> buffer(2, 8192);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            reverb.process(buffer.getWritePointer(0), buffer.getWritePointer(1), 8192);
+
+            float difference = 0.0f;
+            for (int i = 0; i < 8192; ++i)
+                difference = std::max(difference, std::abs(buffer.getSample(0, i) - buffer.getSample(1, i)));
+            expectLessThan(difference, 1.0e-6f);
+
+            auto wide = renderImpulse(0.5f, 0.0f, FDNReverb::Quality::Standard, 0.5);
+            expectLessThan(correlation(wide), 0.5f);
+        }
+
+        beginTest("Every quality stays stable, including while switching");
+        {
+            FDNReverb reverb;
+            FDNReverb::Parameters params;
+            params.roomSize = 1.0f;
+            params.damping = 0.0f;
+            reverb.setParameters(params);
+            reverb.prepare(sampleRate);
+
+            juce::Random random(7);
+            juce::AudioBuffer<float> buffer(2, 512);
+            float peak = 0.0f;
+
+            for (int block = 0; block < 600; ++block)
+            {
+                if (block % 100 == 0)
+                    reverb.setQuality(static_cast<FDNReverb::Quality>((block / 100) % 3));
+
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < 512; ++i)
+                        buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+                reverb.process(buffer.getWritePointer(0), buffer.getWritePointer(1), 512);
+                expectNoNaNOrInf(buffer);
+                peak = std::max(peak, buffer.getMagnitude(0, 512));
+            }
+
+            // Longest decay with full-scale noise stays at a sane level
+            expectLessThan(peak, 8.0f);
+        }
+
+        beginTest("ReverbEffect keeps its parameters and adds quality");
+        {
+            ReverbEffect reverb;
+            reverb.setParameter("quality", 2.0f);
+            reverb.setParameter("predelay", 20.0f);
+            reverb.prepareToPlay(sampleRate, 512);
+            expectEquals(reverb.getParameter("quality"), 2.0f);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            buffer.setSample(1, 0, 1.0f);
+
+            float tail = 0.0f;
+            for (int block = 0; block < 20; ++block)
+            {
+                reverb.processBlock(buffer);
+                expectNoNaNOrInf(buffer);
+                tail += buffer.getMagnitude(0, 512);
+                buffer.clear();
+            }
+            expectGreaterThan(tail, 0.0f);
+        }
+
+        //======================================================================
+        // Benchmark against the Freeverb engine the effect used to wrap
+        //======================================================================
+        beginTest("FDN is dense and cheap compared with Freeverb");
+        {
+            const int length = static_cast<int>(sampleRate * 10.0);
+            juce::AudioBuffer<float> noise(2, length);
+            juce::Random random(3);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < length; ++i)
+                    noise.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+            // Freeverb (the engine inside juce::dsp::Reverb)
+            juce::Reverb freeverb;
+            juce::Reverb::Parameters freeverbParams;
+            freeverbParams.roomSize = 0.8f;
+            freeverbParams.wetLevel = 1.0f;
+            freeverbParams.dryLevel = 0.0f;
+            freeverb.setParameters(freeverbParams);
+            freeverb.setSampleRate(sampleRate);
+
+            juce::AudioBuffer<float> buffer(noise);
+            auto start = juce::Time::getMillisecondCounterHiRes();
+            for (int position = 0; position < length; position += 512)
+            {
+                const int n = std::min(512, length - position);
+                freeverb.processStereo(buffer.getWritePointer(0, position), buffer.getWritePointer(1, position), n);
+            }
+            const double freeverbMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+            juce::AudioBuffer<float> freeverbImpulse(2, 8820);
+            freeverbImpulse.clear();
+            freeverbImpulse.setSample(0, 0, 1.0f);
+            freeverbImpulse.setSample(1, 0, 1.0f);
+            freeverb.reset();
+            freeverb.processStereo(freeverbImpulse.getWritePointer(0), freeverbImpulse.getWritePointer(1), 8820);
+            const float freeverbDensity = echoDensity(freeverbImpulse, 4410, 6615);
+
+            logMessage("Freeverb: " + juce::String(freeverbMs, 1) + " ms per 10 s, echo density "
+                       + juce::String(freeverbDensity, 2));
+
+            for (auto quality : { FDNReverb::Quality::Eco, FDNReverb::Quality::Standard, FDNReverb::Quality::High })
+            {
+                FDNReverb reverb;
+                FDNReverb::Parameters params;
+                params.roomSize = 0.8f;
+                reverb.setParameters(params);
+                reverb.setQuality(quality);
+                reverb.prepare(sampleRate);
+
+                buffer.makeCopyOf(noise);
+                start = juce::Time::getMillisecondCounterHiRes();
+                for (int position = 0; position < length; position += 512)
+                {
+                    const int n = std::min(512, length - position);
+                    reverb.process(buffer.getWritePointer(0, position), buffer.getWritePointer(1, position), n);
+                }
+                const double fdnMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+                auto impulse = renderImpulse(0.8f, 0.0f, quality, 0.2);
+                const float density = echoDensity(impulse, 4410, 6615);
+
+                logMessage("FDN " + juce::String(FDNReverb::getNumLines(quality)) + " lines (quality "
+                           + juce::String(static_cast<int>(quality)) + "): " + juce::String(fdnMs, 1)
+                           + " ms per 10 s, echo density " + juce::String(density, 2));
+
+                // Faster than real time with a wide margin, and a Gaussian-like
+                // tail 100 ms in (normalised echo density near 1)
+                expect(fdnMs < 2000.0, "FDN took " + juce::String(fdnMs) + "ms for 10 s of audio");
+                expectGreaterThan(density, 0.6f);
+            }
+        }
+    }
+
+private:
+    juce::AudioBuffer<float> renderImpulse(float roomSize, float predelayMs,
+                                           FDNReverb::Quality quality, double seconds)
+    {
+        FDNReverb reverb;
+        FDNReverb::Parameters params;
+        params.roomSize = roomSize;
+        params.damping = 0.0f;
+        params.predelayMs = predelayMs;
+        reverb.setParameters(params);
+        reverb.setQuality(quality);
+        reverb.prepare(44100.0);
+
+        const int length = static_cast<int>(44100.0 * seconds);
+        juce::AudioBuffer<float> buffer(2, length);
+        buffer.clear();
+        buffer.setSample(0, 0, 1.0f);
+        buffer.setSample(1, 0, 1.0f);
+
+        for (int position = 0; position < length; position += 512)
+        {
+            const int n = std::min(512, length - position);
+            reverb.process(buffer.getWritePointer(0, position), buffer.getWritePointer(1, position), n);
+        }
+
+        return buffer;
+    }
+
+    static float levelDb(const juce::AudioBuffer<float>& buffer, int start, int end)
+    {
+        return juce::Decibels::gainToDecibels(buffer.getRMSLevel(0, start, end - start), -200.0f);
+    }
+
+    static float correlation(const juce::AudioBuffer<float>& buffer)
+    {
+        double lr = 0.0, ll = 0.0, rr = 0.0;
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const double l = buffer.getSample(0, i);
+            const double r = buffer.getSample(1, i);
+            lr += l * r;
+            ll += l * l;
+            rr += r * r;
+        }
+        return static_cast<float>(lr / std::sqrt(ll * rr + 1.0e-30));
+    }
+
+    /** Normalised echo density: share of samples beyond one standard deviation,
+        relative to Gaussian noise (1 = fully dense) */
+    static float echoDensity(const juce::AudioBuffer<float>& buffer, int start, int end)
+    {
+        const float deviation = buffer.getRMSLevel(0, start, end - start);
+        int outside = 0;
+        for (int i = start; i < end; ++i)
+            if (std::abs(buffer.getSample(0, i)) > deviation)
+                ++outside;
+
+        return static_cast<float>(outside) / static_cast<float>(end - start) / 0.3173f;
+    }
+
+    void expectNoNaNOrInf(const juce::AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                expect(std::isfinite(buffer.getSample(ch, i)), "Sample should be finite");
+    }
+};
+
+// Register the test
+static FDNReverbTests fdnReverbTests;
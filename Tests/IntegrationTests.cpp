@@ -9,6 +9,7 @@
 #include "../Source/Audio/MidiClip.h"
 #include "../Source/Audio/Effects/ReverbEffect.h"
 #include "../Source/Audio/Effects/DelayEffect.h"
+#include "../Source/Project/ProjectSerializer.h"
 
 class IntegrationTests : public juce::UnitTest
 {
@@ -178,6 +179,277 @@ public:
             expectNoNaNOrInf(buffer);
         }
 
+        //======================================================================
+        // Track Inserts and Send/Return Buses
+        //======================================================================
+        beginTest("Track has its own insert chain");
+        {
+            Track track("Inserts");
+            track.prepareToPlay(44100.0, 512);
+            track.getEffectChain().addEffect(std::make_unique<DelayEffect>());
+            expectEquals(track.getEffectChain().getNumEffects(), 1);
+
+            track.synthNoteOn(60, 1.0f);
+            juce::AudioBuffer<float> buffer(2, 512);
+            buffer.clear();
+            track.processBlock(buffer, 512, 0.0, 120.0);
+
+            expectNoNaNOrInf(buffer);
+        }
+
+        beginTest("Pre-fader send ignores the track fader");
+        {
+            Track track("Pre");
+            track.prepareToPlay(44100.0, 512);
+            track.setVolume(0.0f);
+            track.setSendLevel(0, 1.0f);
+            track.setSendPreFader(0, true);
+
+            juce::AudioBuffer<float> busInput(2, 512);
+            busInput.clear();
+            Track::SendTargets targets{};
+            targets[0] = &busInput;
+
+            track.synthNoteOn(60, 1.0f);
+            juce::AudioBuffer<float> buffer(2, 512);
+            buffer.clear();
+            track.processBlock(buffer, 512, 0.0, 120.0, &targets);
+
+            expectEquals(buffer.getMagnitude(0, 0, 512), 0.0f);
+            expect(busInput.getMagnitude(0, 0, 512) > 0.0f, "Send should carry the unfaded signal");
+        }
+
+        beginTest("Post-fader send follows the track fader");
+        {
+            Track track("Post");
+            track.prepareToPlay(44100.0, 512);
+            track.setVolume(0.0f);
+            track.setSendLevel(0, 1.0f);
+
+            juce::AudioBuffer<float> busInput(2, 512);
+            busInput.clear();
+            Track::SendTargets targets{};
+            targets[0] = &busInput;
+
+            track.synthNoteOn(60, 1.0f);
+            juce::AudioBuffer<float> buffer(2, 512);
+            buffer.clear();
+            track.processBlock(buffer, 512, 0.0, 120.0, &targets);
+
+            expectEquals(busInput.getMagnitude(0, 0, 512), 0.0f);
+        }
+
+        beginTest("Return bus is shared by all sending tracks");
+        {
+            AudioEngine engine;
+            engine.prepareToPlay(512, 44100.0);
+            engine.getEffectChain().clearAll();
+
+            const int slot = engine.addReturnBus("Reverb");
+            expectEquals(slot, 0);
+            engine.getReturnBus(slot)->getEffectChain().addEffect(std::make_unique<ReverbEffect>());
+
+            for (int i = 0; i < 5; ++i)
+            {
+                auto track = std::make_unique<Track>("Track " + juce::String(i + 1));
+                track->setVolume(0.0f);
+                track->setSendLevel(slot, 0.5f);
+                track->setSendPreFader(slot, true);
+                track->synthNoteOn(60 + i, 1.0f);
+                engine.addTrack(std::move(track));
+            }
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::AudioSourceChannelInfo info(&buffer, 0, 512);
+
+            // Run past the reverb's comb delays
+            float peak = 0.0f;
+            for (int block = 0; block < 8; ++block)
+            {
+                engine.getNextAudioBlock(info);
+                expectNoNaNOrInf(buffer);
+                peak = juce::jmax(peak, buffer.getMagnitude(0, 0, 512));
+            }
+
+            // Faders are down, so everything heard came through the one reverb
+            expect(peak > 0.0f);
+
+            engine.removeReturnBus(slot);
+            expectEquals(engine.getNumReturnBuses(), 0);
+            engine.getNextAudioBlock(info);
+            expectNoNaNOrInf(buffer);
+        }
+
+        beginTest("Inserts, sends and return buses survive a save and load");
+        {
+            AudioEngine engine;
+            engine.prepareToPlay(512, 44100.0);
+
+            // Leave a free slot below the bus, which sends still refer to
+            engine.addReturnBus("Spare");
+            const int slot = engine.addReturnBus("Reverb");
+            engine.removeReturnBus(0);
+
+            auto* bus = engine.getReturnBus(slot);
+            bus->setReturnLevel(0.6f);
+            bus->setMuted(true);
+            bus->getEffectChain().addEffect(std::make_unique<ReverbEffect>());
+
+            auto track = std::make_unique<Track>("Vocals");
+            auto delay = std::make_unique<DelayEffect>();
+            delay->setParameter("feedback", 0.3f);
+            delay->setWetDry(0.25f);
+            track->getEffectChain().addEffect(std::move(delay));
+            track->getEffectChain().addEffect(std::make_unique<ReverbEffect>());
+            track->getEffectChain().setSlotBypass(1, true);
+            track->setSendLevel(slot, 0.4f);
+            track->setSendPreFader(slot, true);
+            engine.addTrack(std::move(track));
+
+            const auto json = ProjectSerializer::serializeFromEngine(engine, "Mix", 120.0);
+
+            // Buses already in the engine are replaced
+            AudioEngine loaded;
+            loaded.prepareToPlay(512, 44100.0);
+            loaded.addReturnBus("Stale");
+
+            juce::String projectName;
+            double bpm = 0.0;
+            expect(ProjectSerializer::deserializeToEngine(json, loaded, projectName, bpm));
+
+            expectEquals(loaded.getNumReturnBuses(), 1);
+            expect(loaded.getReturnBus(0) == nullptr);
+
+            auto* loadedBus = loaded.getReturnBus(slot);
+            expect(loadedBus != nullptr);
+            if (loadedBus != nullptr)
+            {
+                expectEquals(loadedBus->getName(), juce::String("Reverb"));
+                expectWithinAbsoluteError(loadedBus->getReturnLevel(), 0.6f, 1.0e-6f);
+                expect(loadedBus->isMuted());
+                expectEquals(loadedBus->getEffectChain().getNumEffects(), 1);
+            }
+
+            auto* loadedTrack = loaded.getTrack(0);
+            expect(loadedTrack != nullptr);
+            if (loadedTrack != nullptr)
+            {
+                auto& chain = loadedTrack->getEffectChain();
+                expectEquals(chain.getNumEffects(), 2);
+                expectEquals(chain.getEffect(0)->getName(), juce::String("Delay"));
+                expectWithinAbsoluteError(chain.getEffect(0)->getParameter("feedback"), 0.3f, 1.0e-6f);
+                expectWithinAbsoluteError(chain.getEffect(0)->getWetDry(), 0.25f, 1.0e-6f);
+                expect(!chain.isSlotBypassed(0));
+                expect(chain.isSlotBypassed(1));
+
+                expectWithinAbsoluteError(loadedTrack->getSendLevel(slot), 0.4f, 1.0e-6f);
+                expect(loadedTrack->isSendPreFader(slot));
+                expectEquals(loadedTrack->getSendLevel(0), 0.0f);
+                expect(!loadedTrack->isSendPreFader(0));
+            }
+        }
+
+        beginTest("Tracks routed to a group follow the group fader");
+        {
+            AudioEngine engine;
+            engine.prepareToPlay(512, 44100.0);
+            engine.getEffectChain().clearAll();
+            engine.setNumMixerThreads(2);
+
+            const int drums = engine.addGroupBus("Drums");
+            const int music = engine.addGroupBus("Music");
+            expect(drums >= 0 && music >= 0);
+
+            for (int i = 0; i < 4; ++i)
+            {
+                auto track = std::make_unique<Track>("Track " + juce::String(i + 1));
+                track->synthNoteOn(60 + i, 1.0f);
+                engine.addTrack(std::move(track));
+                expect(engine.setTrackOutput(i, drums));
+            }
+
+            // Loops are refused
+            expect(engine.setGroupOutput(drums, music));
+            expect(!engine.setGroupOutput(music, drums));
+            expect(!engine.setGroupOutput(drums, drums));
+            expectEquals(engine.getMixerGraph().getNumLevels(), 3);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::AudioSourceChannelInfo info(&buffer, 0, 512);
+
+            engine.getNextAudioBlock(info);
+            expectNoNaNOrInf(buffer);
+            expect(buffer.getMagnitude(0, 512) > 0.0f);
+
+            engine.getGroupBus(music)->setMuted(true);
+            engine.getNextAudioBlock(info);
+            expectEquals(buffer.getMagnitude(0, 512), 0.0f);
+
+            // Removing the group sends its inputs straight to the master
+            engine.removeGroupBus(music);
+            expectEquals(engine.getGroupBus(drums)->getOutputGroup(), -1);
+            engine.getNextAudioBlock(info);
+            expect(buffer.getMagnitude(0, 512) > 0.0f);
+        }
+
+        beginTest("Group buses and output routing survive a save and load");
+        {
+            AudioEngine engine;
+            engine.prepareToPlay(512, 44100.0);
+
+            const int spare = engine.addGroupBus("Spare");
+            const int drums = engine.addGroupBus("Drums");
+            const int music = engine.addGroupBus("Music");
+            engine.removeGroupBus(spare);
+
+            auto* drumsGroup = engine.getGroupBus(drums);
+            drumsGroup->setVolume(0.5f);
+            drumsGroup->setPan(-0.25f);
+            drumsGroup->getEffectChain().addEffect(std::make_unique<DelayEffect>());
+            engine.getGroupBus(music)->setMuted(true);
+
+            for (int i = 0; i < 3; ++i)
+                engine.addTrack(std::make_unique<Track>("Track " + juce::String(i + 1)));
+
+            expect(engine.setTrackOutput(0, drums));
+            expect(engine.setTrackOutput(2, music));
+            expect(engine.setGroupOutput(drums, music));
+
+            const auto json = ProjectSerializer::serializeFromEngine(engine, "Groups", 120.0);
+
+            AudioEngine loaded;
+            loaded.prepareToPlay(512, 44100.0);
+            loaded.addGroupBus("Stale");
+
+            juce::String projectName;
+            double bpm = 0.0;
+            expect(ProjectSerializer::deserializeToEngine(json, loaded, projectName, bpm));
+
+            expectEquals(loaded.getNumGroupBuses(), 2);
+            expect(loaded.getGroupBus(spare) == nullptr);
+
+            auto* loadedDrums = loaded.getGroupBus(drums);
+            auto* loadedMusic = loaded.getGroupBus(music);
+            expect(loadedDrums != nullptr && loadedMusic != nullptr);
+            if (loadedDrums != nullptr && loadedMusic != nullptr)
+            {
+                expectEquals(loadedDrums->getName(), juce::String("Drums"));
+                expectWithinAbsoluteError(loadedDrums->getVolume(), 0.5f, 1.0e-6f);
+                expectWithinAbsoluteError(loadedDrums->getPan(), -0.25f, 1.0e-6f);
+                expectEquals(loadedDrums->getEffectChain().getNumEffects(), 1);
+                expectEquals(loadedDrums->getOutputGroup(), music);
+
+                expect(loadedMusic->isMuted());
+                expectEquals(loadedMusic->getOutputGroup(), -1);
+            }
+
+            expectEquals(loaded.getNumTracks(), 3);
+            expectEquals(loaded.getTrack(0)->getOutputGroup(), drums);
+            expectEquals(loaded.getTrack(1)->getOutputGroup(), -1);
+            expectEquals(loaded.getTrack(2)->getOutputGroup(), music);
+            expectEquals(loaded.getMixerGraph().getNumLevels(), engine.getMixerGraph().getNumLevels());
+        }
+
         //======================================================================
         // Playback Integration
         //======================================================================
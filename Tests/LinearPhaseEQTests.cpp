@@ -0,0 +1,287 @@
+/**
+ * Linear Phase EQ Unit Tests - FIR design, latency and glitch-free redesigns
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/Audio/Effects/LinearPhaseEQ.h"
+#include "../Source/Audio/Effects/ParametricEQEffect.h"
+#include "../Source/Audio/Effects/EffectChain.h"
+#include <cmath>
+#include <complex>
+
+class LinearPhaseEQTests : public juce::UnitTest
+{
+public:
+    LinearPhaseEQTests() : UnitTest("Linear Phase EQ") {}
+
+    void runTest() override
+    {
+        const double sampleRate = 44100.0;
+
+        //======================================================================
+        beginTest("Kernel length follows the sample rate");
+        {
+            expectEquals(LinearPhaseEQ::kernelLengthFor(44100.0), 8192);
+            expectEquals(LinearPhaseEQ::kernelLengthFor(48000.0), 8192);
+            expectEquals(LinearPhaseEQ::kernelLengthFor(96000.0), 16384);
+            expectEquals(LinearPhaseEQ::kernelLengthFor(192000.0), 32768);
+        }
+
+        beginTest("Flat response is a pure delay of the reported latency");
+        {
+            LinearPhaseEQ eq;
+            eq.prepare(sampleRate, 2);
+            const int latency = eq.getLatencySamples();
+            expectEquals(latency, LinearPhaseEQ::BLOCK_SIZE + 4096);
+
+            juce::AudioBuffer<float> buffer(2, latency + 2000);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            buffer.setSample(1, 0, 1.0f);
+            processInBlocks(eq, buffer, 333);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                expectWithinAbsoluteError(buffer.getSample(ch, latency), 1.0f, 1.0e-4f);
+                buffer.setSample(ch, latency, 0.0f);
+                expectLessThan(buffer.getMagnitude(ch, 0, buffer.getNumSamples()), 1.0e-4f);
+            }
+        }
+
+        //======================================================================
+        beginTest("Designed kernel is symmetric and matches the band magnitudes");
+        {
+            auto bell = BiquadCascade::Coefficients::peak(sampleRate, 1000.0f, 2.0f, 9.0f);
+            auto lowCut = BiquadCascade::Coefficients::highPass(sampleRate, 60.0f, 0.707f);
+            const int length = LinearPhaseEQ::kernelLengthFor(sampleRate);
+            auto taps = LinearPhaseEQ::designKernel({ bell, lowCut }, length);
+
+            float asymmetry = 0.0f;
+            for (int i = 1; i < length / 2; ++i)
+                asymmetry = std::max(asymmetry, std::abs(taps[size_t(length / 2 + i)] - taps[size_t(length / 2 - i)]));
+            expectLessThan(asymmetry, 1.0e-6f);
+
+            for (double frequency : { 60.0, 100.0, 500.0, 1000.0, 1100.0, 3000.0, 10000.0 })
+            {
+                std::complex<double> response = 0.0;
+                for (int n = 0; n < length; ++n)
+                    response += static_cast<double>(taps[size_t(n)]) * std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate * n);
+
+                const double expected = magnitudeDb(bell, frequency, sampleRate) + magnitudeDb(lowCut, frequency, sampleRate);
+                expectWithinAbsoluteError(20.0 * std::log10(std::abs(response)), expected, 0.2);
+            }
+        }
+
+        //======================================================================
+        beginTest("Designs are made on the background thread, not in process()");
+        {
+            LinearPhaseEQ eq;
+            eq.prepare(sampleRate, 1);
+            const int latency = eq.getLatencySamples();
+
+            // Thousands of small bells: a design that takes far longer than
+            // the few blocks processed while it is running
+            std::vector<BiquadCascade::Coefficients> bands(4000, BiquadCascade::Coefficients::peak(sampleRate, 1000.0f, 1.0f, 0.003f));
+            eq.setBands(bands);
+            expect(eq.isDesigning());
+
+            // An impulse comes out as the flat kernel's pure delay
+            juce::AudioBuffer<float> buffer(1, latency + 512);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            processInBlocks(eq, buffer, 512);
+
+            if (eq.isDesigning())
+            {
+                expectWithinAbsoluteError(buffer.getSample(0, latency), 1.0f, 1.0e-4f);
+                buffer.setSample(0, latency, 0.0f);
+                expectLessThan(buffer.getMagnitude(0, 0, buffer.getNumSamples()), 1.0e-4f);
+            }
+            else
+            {
+                logMessage("The design finished before the flat blocks were checked");
+            }
+
+            for (int wait = 0; eq.isDesigning() && wait < 30000; ++wait)
+                juce::Thread::sleep(1);
+            expect(!eq.isDesigning());
+
+            // Once published, the next blocks pick the design up
+            juce::AudioBuffer<float> tone(1, latency + 8192);
+            for (int i = 0; i < tone.getNumSamples(); ++i)
+                tone.setSample(0, i, 0.25f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 1000.0 * i / sampleRate)));
+            processInBlocks(eq, tone, 512);
+
+            const float gainDb = juce::Decibels::gainToDecibels(tone.getMagnitude(0, tone.getNumSamples() - 2048, 2048) / 0.25f);
+            expectWithinAbsoluteError(gainDb, 12.0f, 0.5f);
+        }
+
+        beginTest("Adopted designs fade in over one partition");
+        {
+            LinearPhaseEQ eq;
+            eq.prepare(sampleRate, 1);
+            const int latency = eq.getLatencySamples();
+
+            // A steady 1 kHz tone through the flat kernel until it has settled
+            juce::AudioBuffer<float> tone(1, latency + 16 * LinearPhaseEQ::BLOCK_SIZE);
+            int phaseIndex = 0;
+            auto fillTone = [&](juce::AudioBuffer<float>& buffer)
+            {
+                for (int i = 0; i < buffer.getNumSamples(); ++i, ++phaseIndex)
+                    buffer.setSample(0, i, 0.25f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 1000.0 * phaseIndex / sampleRate)));
+            };
+            fillTone(tone);
+            processInBlocks(eq, tone, LinearPhaseEQ::BLOCK_SIZE);
+
+            eq.setBands({ BiquadCascade::Coefficients::peak(sampleRate, 1000.0f, 1.0f, 12.0f) });
+            for (int wait = 0; eq.isDesigning() && wait < 2000; ++wait)
+                juce::Thread::sleep(1);
+
+            // The first partition after the design lands runs both kernels on
+            // the same history: the old output fades into the new one
+            std::vector<float> envelope;
+            juce::AudioBuffer<float> block(1, LinearPhaseEQ::BLOCK_SIZE);
+            for (int b = 0; b < 8; ++b)
+            {
+                fillTone(block);
+                eq.process(block, LinearPhaseEQ::BLOCK_SIZE);
+                for (int quarter = 0; quarter < 4; ++quarter)
+                    envelope.push_back(block.getMagnitude(0, quarter * LinearPhaseEQ::BLOCK_SIZE / 4, LinearPhaseEQ::BLOCK_SIZE / 4));
+            }
+
+            const float flat = 0.25f, boosted = 0.25f * juce::Decibels::decibelsToGain(12.0f);
+            expectWithinAbsoluteError(envelope.front(), flat, 0.02f);
+            expectWithinAbsoluteError(envelope.back(), boosted, 0.05f);
+
+            // Nothing jumps straight from one level to the other, and some
+            // quarter block sits clearly between them
+            bool passedBetween = false;
+            for (size_t i = 1; i < envelope.size(); ++i)
+            {
+                expectLessThan(envelope[i] - envelope[i - 1], 0.6f * (boosted - flat));
+                passedBetween = passedBetween || (envelope[i] > flat + 0.15f && envelope[i] < boosted - 0.15f);
+            }
+            expect(passedBetween);
+        }
+
+        beginTest("Redesigns crossfade instead of clicking");
+        {
+            LinearPhaseEQ eq;
+            eq.prepare(sampleRate, 2);
+
+            const int length = static_cast<int>(sampleRate * 4.0);
+            juce::AudioBuffer<float> buffer(2, length);
+            for (int i = 0; i < length; ++i)
+            {
+                const float sample = 0.25f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 1000.0 * i / sampleRate));
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+            }
+
+            const auto boost = BiquadCascade::Coefficients::peak(sampleRate, 1000.0f, 1.0f, 12.0f);
+            int swaps = 0;
+
+            for (int position = 0; position < length; position += 512)
+            {
+                // Flip between flat and +12 dB, waiting for each design to land
+                if (position % (512 * 20) == 0)
+                {
+                    eq.setBands({ (swaps++ % 2) == 0 ? boost : BiquadCascade::Coefficients::identity() });
+                    for (int wait = 0; eq.isDesigning() && wait < 2000; ++wait)
+                        juce::Thread::sleep(1);
+                }
+
+                const int n = std::min(512, length - position);
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, position, n);
+                eq.process(block, n);
+            }
+
+            // A sine up to ~1.0 moves at most ~0.14 per sample; a hard switch
+            // between 0.25 and 1.0 amplitude would jump much further
+            float largestStep = 0.0f;
+            for (int i = 1; i < length; ++i)
+                largestStep = std::max(largestStep, std::abs(buffer.getSample(0, i) - buffer.getSample(0, i - 1)));
+
+            expectGreaterThan(swaps, 10);
+            expectLessThan(largestStep, 0.16f);
+        }
+
+        //======================================================================
+        beginTest("Parametric EQ reports latency only in linear phase mode");
+        {
+            ParametricEQEffect eq;
+            eq.prepareToPlay(sampleRate, 512);
+            expectEquals(eq.getLatencySamples(), 0);
+
+            eq.setParameter("phase", 1.0f);
+            expectEquals(eq.getLatencySamples(), LinearPhaseEQ::BLOCK_SIZE + 4096);
+
+            EffectChain chain;
+            chain.prepareToPlay(sampleRate, 512);
+            auto effect = std::make_unique<ParametricEQEffect>();
+            effect->setParameter("phase", 1.0f);
+            const int slot = chain.addEffect(std::move(effect));
+            expectEquals(chain.getLatencySamples(), LinearPhaseEQ::BLOCK_SIZE + 4096);
+
+            chain.setSlotBypass(slot, true);
+            expectEquals(chain.getLatencySamples(), 0);
+        }
+
+        beginTest("Parametric EQ boosts a band in linear phase mode");
+        {
+            ParametricEQEffect eq;
+            eq.setParameter("phase", 1.0f);
+            eq.setParameter(ParametricEQEffect::bandParameter(5, "Freq"), 1000.0f);
+            eq.setParameter(ParametricEQEffect::bandParameter(5, "Gain"), 9.0f);
+            eq.prepareToPlay(sampleRate, 512);
+
+            for (int wait = 0; eq.isUpdatingLinearPhase() && wait < 2000; ++wait)
+                juce::Thread::sleep(1);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            double phase = 0.0;
+            float peak = 0.0f;
+            for (int block = 0; block < 60; ++block)
+            {
+                for (int i = 0; i < 512; ++i)
+                {
+                    const float sample = 0.25f * static_cast<float>(std::sin(phase));
+                    buffer.setSample(0, i, sample);
+                    buffer.setSample(1, i, sample);
+                    phase += juce::MathConstants<double>::twoPi * 1000.0 / sampleRate;
+                }
+
+                eq.processBlock(buffer);
+                if (block >= 40)
+                    peak = std::max(peak, buffer.getMagnitude(0, 0, 512));
+            }
+
+            expectWithinAbsoluteError(juce::Decibels::gainToDecibels(peak / 0.25f), 9.0f, 0.3f);
+        }
+    }
+
+private:
+    static void processInBlocks(LinearPhaseEQ& eq, juce::AudioBuffer<float>& buffer, int blockSize)
+    {
+        for (int position = 0; position < buffer.getNumSamples(); position += blockSize)
+        {
+            const int n = std::min(blockSize, buffer.getNumSamples() - position);
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), position, n);
+            eq.process(block, n);
+        }
+    }
+
+    static double magnitudeDb(const BiquadCascade::Coefficients& c, double frequency, double sampleRate)
+    {
+        const auto z1 = std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate);
+        const auto z2 = z1 * z1;
+        const auto h = (static_cast<double>(c.b0) + static_cast<double>(c.b1) * z1 + static_cast<double>(c.b2) * z2)
+                     / (1.0 + static_cast<double>(c.a1) * z1 + static_cast<double>(c.a2) * z2);
+        return 20.0 * std::log10(std::abs(h));
+    }
+};
+
+// Register the test
+static LinearPhaseEQTests linearPhaseEQTests;
@@ -0,0 +1,246 @@
+/**
+ * MixerGraph Unit Tests - Scheduling, buffer reuse, cycle breaking and parallel mixing
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/MixerGraph.h"
+#include <atomic>
+#include <mutex>
+
+class MixerGraphTests : public juce::UnitTest
+{
+public:
+    MixerGraphTests() : UnitTest("MixerGraph") {}
+
+    void runTest() override
+    {
+        using Node = MixerGraph::NodeInfo;
+        constexpr int M = MixerGraph::MASTER;
+
+        //======================================================================
+        beginTest("Nodes run after their inputs and keys");
+        {
+            // 0,1 -> group 3; 2 -> master keyed by 0; group 3 -> group 4 -> master
+            std::vector<Node> nodes { { 3, {} }, { 3, {} }, { M, { 0 } }, { 4, {} }, { M, {} } };
+
+            MixerGraph graph;
+            expect(graph.compile(nodes, 2, 64));
+
+            expectEquals(graph.getNumLevels(), 3);
+            expectEquals(graph.getNodeLevel(0), 0);
+            expectEquals(graph.getNodeLevel(1), 0);
+            expectEquals(graph.getNodeLevel(2), 1);
+            expectEquals(graph.getNodeLevel(3), 1);
+            expectEquals(graph.getNodeLevel(4), 2);
+        }
+
+        beginTest("Plain tracks share scratch buffers instead of one each");
+        {
+            std::vector<Node> nodes(64, Node{ M, {} });
+
+            MixerGraph graph;
+            expect(graph.compile(nodes, 2, 64));
+
+            expectEquals(graph.getNumLevels(), 1);
+            expectEquals(graph.getNumBuffers(), 1); // Just the audio thread's scratch
+
+            TestProcessor processor;
+            juce::AudioBuffer<float> output(2, 64);
+            output.clear();
+            graph.process(output, 64, processor);
+
+            expectWithinAbsoluteError(output.getSample(0, 10), expectedTrackSum(64), 1.0e-4f);
+        }
+
+        beginTest("Group slots are reused once their readers have run");
+        {
+            // Track -> A -> B -> C -> master. A's slot is free again once B
+            // has read it, so C can take it.
+            std::vector<Node> nodes { { 1, {} }, { 2, {} }, { 3, {} }, { M, {} } };
+
+            MixerGraph graph;
+            expect(graph.compile(nodes, 2, 64));
+
+            // Three groups but only two live at once (+ scratch)
+            expectEquals(graph.getNumBuffers(), 3);
+
+            TestProcessor processor;
+            juce::AudioBuffer<float> output(2, 64);
+            output.clear();
+            graph.process(output, 64, processor);
+            expectWithinAbsoluteError(output.getSample(1, 0), trackValue(0) * 0.125f, 1.0e-6f);
+        }
+
+        beginTest("Cycles are broken and reported");
+        {
+            // 0 -> 1 -> 0, and 2 keyed by 3 while 3 is keyed by 2
+            std::vector<Node> nodes { { 1, {} }, { 0, {} }, { M, { 3 } }, { M, { 2 } } };
+
+            MixerGraph graph;
+            expect(!graph.compile(nodes, 2, 64));
+
+            for (int n = 0; n < 4; ++n)
+                expect(graph.getNodeLevel(n) >= 0);
+
+            TestProcessor processor;
+            juce::AudioBuffer<float> output(2, 64);
+            output.clear();
+            graph.process(output, 64, processor);
+            expect(output.getMagnitude(0, 64) > 0.0f, "Broken graph should still produce output");
+        }
+
+        beginTest("Invalid edges are ignored");
+        {
+            std::vector<Node> nodes { { 7, { -3, 9, 0 } }, { 1, {} } };
+
+            MixerGraph graph;
+            expect(graph.compile(nodes, 2, 64));
+            expectEquals(graph.getNumLevels(), 1);
+        }
+
+        beginTest("Sidechain keys see the source's processed output");
+        {
+            std::vector<Node> nodes { { M, {} }, { M, { 0 } } };
+
+            MixerGraph graph;
+            graph.compile(nodes, 2, 64);
+
+            TestProcessor processor;
+            juce::AudioBuffer<float> output(2, 64);
+            output.clear();
+            graph.process(output, 64, processor);
+
+            expectEquals(processor.keysSeen, 1);
+            expectWithinAbsoluteError(processor.lastKeyValue, trackValue(0), 1.0e-6f);
+        }
+
+        beginTest("Parallel processing matches serial");
+        {
+            // 32 tracks spread over 4 groups, groups to master, a few keys
+            std::vector<Node> nodes;
+            for (int i = 0; i < 32; ++i)
+                nodes.push_back({ 32 + (i % 4), {} });
+            for (int g = 0; g < 4; ++g)
+                nodes.push_back({ M, {} });
+            nodes[5].keySources = { 1 };
+            nodes[33].keySources = { 2 };
+
+            auto render = [&](int numWorkers)
+            {
+                MixerGraph graph;
+                graph.setNumWorkers(numWorkers);
+                graph.compile(nodes, 2, 128);
+
+                TestProcessor processor;
+                juce::AudioBuffer<float> output(2, 128);
+                output.clear();
+
+                // Several blocks, the last one shorter than announced
+                for (int block = 0; block < 8; ++block)
+                {
+                    output.clear();
+                    graph.process(output, block == 7 ? 100 : 128, processor);
+                }
+                return output;
+            };
+
+            auto serial = render(0);
+            auto parallel = render(3);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 100; ++i)
+                    expectWithinAbsoluteError(parallel.getSample(ch, i), serial.getSample(ch, i), 1.0e-5f);
+
+            expect(serial.getMagnitude(0, 100) > 0.0f);
+        }
+
+        beginTest("Slow workers leave their share to the audio thread");
+        {
+            std::vector<Node> nodes(32, Node{ M, {} });
+
+            MixerGraph graph;
+            graph.setNumWorkers(3);
+            graph.compile(nodes, 2, 128);
+
+            // Workers take 5 ms a node, as if they'd been descheduled
+            SlowWorkerProcessor processor;
+            juce::AudioBuffer<float> output(2, 128);
+            output.clear();
+            graph.process(output, 128, processor);
+
+            expectEquals(processor.onAudioThread.load() + processor.onWorkers.load(), 32);
+
+            // Dealt out evenly the audio thread would have run 8
+            expectGreaterThan(processor.onAudioThread.load(), 16);
+            expectWithinAbsoluteError(output.getSample(0, 0), expectedTrackSum(32), 1.0e-5f);
+        }
+    }
+
+private:
+    static float trackValue(int node) { return 0.001f * static_cast<float>(node + 1); }
+
+    static float expectedTrackSum(int numTracks)
+    {
+        float sum = 0.0f;
+        for (int n = 0; n < numTracks; ++n)
+            sum += trackValue(n);
+        return sum;
+    }
+
+    /** Tracks write their constant, slowly on the worker threads */
+    struct SlowWorkerProcessor : MixerGraph::NodeProcessor
+    {
+        std::atomic<int> onAudioThread{0};
+        std::atomic<int> onWorkers{0};
+
+        void provideSidechain(int, int, const juce::AudioBuffer<float>&) override {}
+
+        void processNode(int node, juce::AudioBuffer<float>& buffer, int numSamples, int workerIndex) override
+        {
+            if (workerIndex > 0)
+            {
+                juce::Thread::sleep(5);
+                ++onWorkers;
+            }
+            else
+            {
+                ++onAudioThread;
+            }
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), trackValue(node), numSamples);
+        }
+    };
+
+    /** Tracks (nodes with no input) write a constant; groups halve their input */
+    struct TestProcessor : MixerGraph::NodeProcessor
+    {
+        std::mutex keyMutex;
+        int keysSeen = 0;
+        float lastKeyValue = 0.0f;
+
+        void provideSidechain(int, int, const juce::AudioBuffer<float>& key) override
+        {
+            const std::lock_guard<std::mutex> lock(keyMutex);
+            ++keysSeen;
+            lastKeyValue = key.getSample(0, 0);
+        }
+
+        void processNode(int node, juce::AudioBuffer<float>& buffer, int numSamples, int) override
+        {
+            if (buffer.getMagnitude(0, numSamples) == 0.0f)
+            {
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), trackValue(node), numSamples);
+            }
+            else
+            {
+                buffer.applyGain(0, numSamples, 0.5f);
+            }
+        }
+    };
+};
+
+// Register the test
+static MixerGraphTests mixerGraphTests;
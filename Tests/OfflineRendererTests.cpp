@@ -0,0 +1,155 @@
+/**
+ * Offline Renderer Unit Tests - Rendering a copy of the project for export
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/OfflineRenderer.h"
+#include "../Source/Audio/Effects/ParametricEQEffect.h"
+#include <cmath>
+
+class OfflineRendererTests : public juce::UnitTest
+{
+public:
+    OfflineRendererTests() : UnitTest("Offline Renderer") {}
+
+    void runTest() override
+    {
+        constexpr double liveRate = 44100.0;
+        constexpr double renderRate = 48000.0;
+
+        //======================================================================
+        beginTest("Rendering leaves the live engine alone");
+        {
+            AudioEngine live;
+            live.prepareToPlay(512, liveRate);
+            live.addTrack(makeSineTrack(liveRate));
+            live.setPositionInBeats(3.0);
+
+            OfflineRenderer renderer(live, renderRate, 256);
+            expect(renderer.getMissingPlugins().isEmpty());
+
+            juce::AudioBuffer<float> output;
+            expect(renderer.render(output, 0.0, 4.0));
+
+            expectEquals(live.getPositionInBeats(), 3.0);
+            expect(!live.isPlaying());
+            expectEquals(live.getNumTracks(), 1);
+
+            // Two seconds at 120 BPM, at the rate asked for
+            expectEquals(output.getNumSamples(), static_cast<int>(2.0 * renderRate));
+        }
+
+        beginTest("Clips play at their pitch at the render rate");
+        {
+            AudioEngine live;
+            live.prepareToPlay(512, liveRate);
+            live.addTrack(makeSineTrack(liveRate));
+
+            OfflineRenderer renderer(live, renderRate, 512);
+            juce::AudioBuffer<float> output;
+            expect(renderer.render(output, 0.0, 4.0));
+
+            // Half a second of a 441 Hz sine, well inside the one-second clip
+            int crossings = 0;
+            const int from = static_cast<int>(0.1 * renderRate);
+            const int to = from + static_cast<int>(0.5 * renderRate);
+            for (int i = from; i < to; ++i)
+            {
+                if (output.getSample(0, i - 1) < 0.0f && output.getSample(0, i) >= 0.0f)
+                    ++crossings;
+            }
+
+            expectWithinAbsoluteError(crossings, 220, 2);
+        }
+
+        beginTest("Length follows the tempo map");
+        {
+            AudioEngine live;
+            live.prepareToPlay(512, liveRate);
+            live.addTrack(makeSineTrack(liveRate));
+            live.getTempoTrack().setInitialTempo(120.0);
+            live.getTempoTrack().addEvent({ 4.0, 60.0, TempoRampType::Instant });
+
+            // A block size that doesn't divide the change point
+            OfflineRenderer renderer(live, renderRate, 700);
+            juce::AudioBuffer<float> output;
+            expect(renderer.render(output, 0.0, 8.0));
+
+            // Four beats at 120 BPM, then four at 60
+            expectWithinAbsoluteError(output.getNumSamples(), static_cast<int>(6.0 * renderRate), 1);
+
+            // The live engine's map is the project's, untouched by the copy
+            expectEquals(live.getTempoTrack().getNumEvents(), static_cast<size_t>(2));
+        }
+
+        beginTest("Delay compensation is taken out of the output");
+        {
+            AudioEngine live;
+            live.prepareToPlay(512, renderRate);
+
+            // A click half a second in, through a linear phase EQ (thousands of samples of latency)
+            auto track = std::make_unique<Track>("Click");
+            juce::AudioBuffer<float> click(2, static_cast<int>(renderRate));
+            click.clear();
+            click.setSample(0, 0, 0.5f);
+            click.setSample(1, 0, 0.5f);
+            track->addAudioClip(1.0)->setAudioBuffer(std::move(click), renderRate);
+
+            auto eq = std::make_unique<ParametricEQEffect>();
+            eq->setParameter("phase", 1.0f);
+            track->getEffectChain().addEffect(std::move(eq));
+            live.addTrack(std::move(track));
+
+            OfflineRenderer renderer(live, renderRate, 512);
+            juce::AudioBuffer<float> output;
+            expect(renderer.render(output, 0.0, 4.0));
+
+            expectGreaterThan(live.getLatencySamples(), 0);
+            expectEquals(output.getNumSamples(), static_cast<int>(2.0 * renderRate));
+
+            int peak = 0;
+            for (int i = 1; i < output.getNumSamples(); ++i)
+            {
+                if (std::abs(output.getSample(0, i)) > std::abs(output.getSample(0, peak)))
+                    peak = i;
+            }
+            expectWithinAbsoluteError(peak, static_cast<int>(0.5 * renderRate), 2);
+        }
+
+        beginTest("Cancelling stops the render");
+        {
+            AudioEngine live;
+            live.prepareToPlay(512, liveRate);
+            live.addTrack(makeSineTrack(liveRate));
+
+            OfflineRenderer renderer(live, renderRate, 512);
+            juce::AudioBuffer<float> output;
+            int polls = 0;
+            expect(!renderer.render(output, 0.0, 64.0, [&polls] { return ++polls > 10; }));
+            expectEquals(output.getNumSamples(), 0);
+        }
+    }
+
+private:
+    // A track playing a one-second 441 Hz sine from the start
+    static std::unique_ptr<Track> makeSineTrack(double sampleRate)
+    {
+        auto track = std::make_unique<Track>("Sine");
+
+        const int length = static_cast<int>(sampleRate);
+        juce::AudioBuffer<float> sine(2, length);
+        for (int i = 0; i < length; ++i)
+        {
+            const auto value = static_cast<float>(0.25 * std::sin(2.0 * juce::MathConstants<double>::pi * 441.0 * i / sampleRate));
+            sine.setSample(0, i, value);
+            sine.setSample(1, i, value);
+        }
+
+        track->addAudioClip(0.0)->setAudioBuffer(std::move(sine), sampleRate);
+        return track;
+    }
+};
+
+// Register the test
+static OfflineRendererTests offlineRendererTests;
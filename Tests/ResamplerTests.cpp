@@ -0,0 +1,215 @@
+/**
+ * Resampler Unit Tests - Interpolation kernel accuracy and cost
+ */
+
+#include <juce_core/juce_core.h>
+#include "../Source/Audio/Resampler.h"
+#include <cmath>
+#include <vector>
+
+class ResamplerTests : public juce::UnitTest
+{
+public:
+    ResamplerTests() : UnitTest("Resampler") {}
+
+    void runTest() override
+    {
+        const Resampler::Quality allQualities[] = {
+            Resampler::Quality::Linear, Resampler::Quality::Hermite, Resampler::Quality::Sinc
+        };
+
+        //======================================================================
+        // Accuracy
+        //======================================================================
+        beginTest("All tiers pass integer positions through unchanged");
+        {
+            auto source = makeSine(1024, 0.05);
+
+            for (auto quality : allQualities)
+            {
+                for (int i = 32; i < 64; ++i)
+                {
+                    float value = Resampler::interpolateAt(quality, source.data(), 1024, static_cast<double>(i));
+                    expectWithinAbsoluteError(value, source[static_cast<size_t>(i)], 1.0e-5f);
+                }
+            }
+        }
+
+        beginTest("All tiers have unity DC gain");
+        {
+            std::vector<float> source(256, 0.5f);
+
+            for (auto quality : allQualities)
+            {
+                float value = Resampler::interpolateAt(quality, source.data(), 256, 100.37);
+                expectWithinAbsoluteError(value, 0.5f, 1.0e-4f);
+            }
+        }
+
+        beginTest("Higher tiers reconstruct a band-limited tone more accurately");
+        {
+            auto source = makeSine(4096, 0.3);
+
+            double linearError = measureError(Resampler::Quality::Linear, source, 0.3, 0.73);
+            double hermiteError = measureError(Resampler::Quality::Hermite, source, 0.3, 0.73);
+            double sincError = measureError(Resampler::Quality::Sinc, source, 0.3, 0.73);
+
+            expect(hermiteError < linearError, "Hermite should beat linear");
+            expect(sincError < hermiteError, "Sinc should beat Hermite");
+        }
+
+        beginTest("Sinc tier suppresses aliasing when reading faster than 1:1");
+        {
+            // Near-Nyquist tone read an octave up would alias to a low frequency
+            auto source = makeSine(8192, juce::MathConstants<double>::pi * 0.9);
+
+            std::vector<float> linear(2048), sinc(2048);
+            Resampler::process(Resampler::Quality::Linear, source.data(), 8192, 64.0, 2.0, linear.data(), 2048);
+            Resampler::process(Resampler::Quality::Sinc, source.data(), 8192, 64.0, 2.0, sinc.data(), 2048);
+
+            expect(rms(sinc) < rms(linear) * 0.25, "Sinc output should contain far less aliased energy");
+        }
+
+        beginTest("Sinc tier filters reads more than 4x faster than 1:1");
+        {
+            // 192 kHz read into 44.1 kHz, and further: a tone above the output's
+            // Nyquist must not fold back, one well below it must come through
+            for (double increment : { 192000.0 / 44100.0, 6.0, 11.3 })
+            {
+                expectGreaterThan(Resampler::getNumTaps(Resampler::Quality::Sinc, increment), Resampler::SINC_TAPS);
+
+                const double aboveNyquist = juce::MathConstants<double>::pi * 1.4 / increment;
+                const double belowNyquist = juce::MathConstants<double>::pi * 0.2 / increment;
+                auto high = makeSine(32768, aboveNyquist);
+                auto low = makeSine(32768, belowNyquist);
+
+                std::vector<float> highOut(1024), lowOut(1024);
+                Resampler::process(Resampler::Quality::Sinc, high.data(), 32768, 2000.0, increment, highOut.data(), 1024);
+                Resampler::process(Resampler::Quality::Sinc, low.data(), 32768, 2000.0, increment, lowOut.data(), 1024);
+
+                expectLessThan(rms(highOut), 0.02, "Aliased energy at increment " + juce::String(increment));
+                expectLessThan(measureError(Resampler::Quality::Sinc, low, belowNyquist, increment, 2000.0), 0.01);
+
+                // The widened window is gathered the same way one sample at a time
+                for (int i = 0; i < 1024; i += 101)
+                {
+                    const float single = Resampler::interpolateAt(Resampler::Quality::Sinc, high.data(), 32768,
+                                                                  2000.0 + i * increment, increment);
+                    expectWithinAbsoluteError(highOut[static_cast<size_t>(i)], single, 1.0e-6f);
+                }
+            }
+
+            std::vector<float> dc(4096, 0.5f);
+            expectWithinAbsoluteError(Resampler::interpolateAt(Resampler::Quality::Sinc, dc.data(), 4096, 2000.37, 7.5),
+                                      0.5f, 1.0e-4f);
+        }
+
+        beginTest("Reads outside the source are silent");
+        {
+            auto source = makeSine(64, 0.1);
+
+            for (auto quality : allQualities)
+            {
+                expectEquals(Resampler::interpolateAt(quality, source.data(), 64, -100.0), 0.0f);
+                expectEquals(Resampler::interpolateAt(quality, source.data(), 64, 500.0), 0.0f);
+            }
+        }
+
+        beginTest("Block processing matches single-sample interpolation");
+        {
+            auto source = makeSine(2048, 0.07);
+
+            for (auto quality : allQualities)
+            {
+                std::vector<float> block(256);
+                double end = Resampler::process(quality, source.data(), 2048, 10.25, 1.5, block.data(), 256);
+                expectWithinAbsoluteError(end, 10.25 + 256 * 1.5, 1.0e-9);
+
+                for (int i = 0; i < 256; i += 17)
+                {
+                    float single = Resampler::interpolateAt(quality, source.data(), 2048, 10.25 + i * 1.5, 1.5);
+                    expectWithinAbsoluteError(block[static_cast<size_t>(i)], single, 1.0e-6f);
+                }
+
+                // Across both ends of the source, in and out of the edge handling
+                std::vector<float> across(1500);
+                Resampler::process(quality, source.data(), 2048, -20.5, 1.4, across.data(), 1500);
+
+                for (int i = 0; i < 1500; ++i)
+                {
+                    float single = Resampler::interpolateAt(quality, source.data(), 2048, -20.5 + i * 1.4, 1.4);
+                    expectWithinAbsoluteError(across[static_cast<size_t>(i)], single, 1.0e-5f);
+                }
+            }
+        }
+
+        //======================================================================
+        // Cost
+        //======================================================================
+        beginTest("Benchmark: per-sample cost of each tier");
+        {
+            auto source = makeSine(1 << 16, 0.05);
+            std::vector<float> output(512);
+            const int numBlocks = 2000;
+
+            for (auto quality : allQualities)
+            {
+                auto start = juce::Time::getHighResolutionTicks();
+
+                double position = 8.0;
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    position = Resampler::process(quality, source.data(), 1 << 16, position, 1.0595,
+                                                  output.data(), 512);
+                    if (position > 60000.0)
+                        position = 8.0;
+                }
+
+                double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                double nsPerSample = seconds * 1.0e9 / (numBlocks * 512.0);
+
+                logMessage("  " + Resampler::getQualityNames()[static_cast<int>(quality)]
+                           + ": " + juce::String(nsPerSample, 2) + " ns/sample");
+
+                // Generous bound - catches accidental O(n^2) or table rebuilds, not machine speed
+                expect(nsPerSample < 500.0);
+            }
+        }
+    }
+
+private:
+    static std::vector<float> makeSine(int length, double radiansPerSample)
+    {
+        std::vector<float> data(static_cast<size_t>(length));
+        for (int i = 0; i < length; ++i)
+            data[static_cast<size_t>(i)] = static_cast<float>(std::sin(radiansPerSample * i));
+        return data;
+    }
+
+    static double measureError(Resampler::Quality quality, const std::vector<float>& source,
+                               double radiansPerSample, double increment, double start = 100.0)
+    {
+        std::vector<float> output(1024);
+        Resampler::process(quality, source.data(), static_cast<juce::int64>(source.size()),
+                           start, increment, output.data(), 1024);
+
+        double maxError = 0.0;
+        for (int i = 0; i < 1024; ++i)
+        {
+            double expected = std::sin(radiansPerSample * (start + i * increment));
+            maxError = std::max(maxError, std::abs(output[static_cast<size_t>(i)] - expected));
+        }
+        return maxError;
+    }
+
+    static double rms(const std::vector<float>& data)
+    {
+        double sum = 0.0;
+        for (float v : data)
+            sum += static_cast<double>(v) * v;
+        return std::sqrt(sum / static_cast<double>(data.size()));
+    }
+};
+
+// Register the test
+static ResamplerTests resamplerTests;
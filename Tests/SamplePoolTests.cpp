@@ -0,0 +1,413 @@
+/**
+ * SamplePool Unit Tests - Sharing, budget enforcement, disk cache round trips and persistence
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/SamplePool.h"
+#include "../Source/Audio/AudioClip.h"
+
+class SamplePoolTests : public juce::UnitTest
+{
+public:
+    SamplePoolTests() : UnitTest("SamplePool") {}
+
+    void runTest() override
+    {
+        auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                           .getChildFile("ProgFlowSamplePoolTests");
+        tempDir.deleteRecursively();
+        tempDir.createDirectory();
+
+        auto fileA = makeSourceFile(tempDir, "a.raw", "first sample contents");
+        auto fileB = makeSourceFile(tempDir, "b.raw", "second sample contents");
+        auto fileACopy = makeSourceFile(tempDir, "a_copy.raw", "first sample contents");
+
+        //======================================================================
+        beginTest("Same file is decoded once and shared");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache1"));
+
+            int decodes = 0;
+            double rate = 0.0;
+            auto first = pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate);
+            auto second = pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate);
+
+            expect(first != nullptr);
+            expect(first == second, "Both callers should receive the same buffer");
+            expectEquals(decodes, 1);
+            expectEquals(rate, 48000.0);
+            expectEquals(pool.getResidentBytes(), (juce::int64)(2 * 1000 * sizeof(float)));
+        }
+
+        beginTest("Identical content at a different path is shared");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache2"));
+
+            int decodes = 0;
+            double rate = 0.0;
+            auto original = pool.getOrLoad(fileA, 0.0, makeDecoder(100, 0.5f, decodes), rate);
+            auto copy = pool.getOrLoad(fileACopy, 0.0, makeDecoder(100, 0.5f, decodes), rate);
+            auto other = pool.getOrLoad(fileB, 0.0, makeDecoder(100, 0.5f, decodes), rate);
+
+            expect(original == copy);
+            expect(original != other);
+            expectEquals(decodes, 2);
+        }
+
+        beginTest("Files that differ only in the middle are separate entries");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache2b"));
+
+            // Same length, header and silent head and tail, like stems bounced together
+            juce::MemoryBlock silence(512 * 1024, true);
+            auto stemA = tempDir.getChildFile("stem_a.raw");
+            auto stemB = tempDir.getChildFile("stem_b.raw");
+            stemA.replaceWithData(silence.getData(), silence.getSize());
+            silence[silence.getSize() / 2] = 1;
+            stemB.replaceWithData(silence.getData(), silence.getSize());
+
+            int decodes = 0;
+            double rate = 0.0;
+            auto first = pool.getOrLoad(stemA, 0.0, makeDecoder(100, 0.25f, decodes), rate, true);
+            auto second = pool.getOrLoad(stemB, 0.0, makeDecoder(100, 0.5f, decodes), rate, true);
+
+            expect(first != second);
+            expectEquals(decodes, 2);
+            expectEquals(second->getSample(0, 0), 0.5f);
+            expectEquals(tempDir.getChildFile("cache2b").getNumberOfChildFiles(juce::File::findFiles, "*.pfcache"), 2);
+        }
+
+        beginTest("Different target sample rates are separate entries");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache3"));
+
+            int decodes = 0;
+            double rate = 0.0;
+            auto native = pool.getOrLoad(fileA, 0.0, makeDecoder(100, 0.5f, decodes), rate);
+            auto resampled = pool.getOrLoad(fileA, 44100.0, makeDecoder(92, 0.5f, decodes), rate);
+
+            expect(native != resampled);
+            expectEquals(pool.getNumEntries(), 2);
+        }
+
+        //======================================================================
+        beginTest("Referenced buffers are never evicted");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache4"));
+            pool.setMemoryBudget(0);
+
+            int decodes = 0;
+            double rate = 0.0;
+            auto held = pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate);
+
+            expect(held != nullptr);
+            expectEquals(pool.getNumResidentEntries(), 1);
+            expectEquals(pool.getStats().evictions, 0);
+        }
+
+        beginTest("Unreferenced LRU data spills to disk and reloads without decoding");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache5"));
+
+            int decodes = 0;
+            double rate = 0.0;
+            {
+                auto buffer = pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate);
+            }
+
+            pool.setMemoryBudget(0);
+            expectEquals(pool.getNumResidentEntries(), 0);
+            expectEquals(pool.getResidentBytes(), (juce::int64)0);
+            expectEquals(pool.getStats().evictions, 1);
+            expect(tempDir.getChildFile("cache5").getNumberOfChildFiles(juce::File::findFiles, "*.pfcache") == 1);
+
+            pool.setMemoryBudget(SamplePool::DEFAULT_BUDGET_BYTES);
+            auto restored = pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate);
+
+            expect(restored != nullptr);
+            expectEquals(decodes, 1);
+            expectEquals(pool.getStats().diskCacheHits, 1);
+            expectEquals(restored->getNumChannels(), 2);
+            expectEquals(restored->getNumSamples(), 1000);
+            expectEquals(restored->getSample(1, 999), 0.25f);
+            expectEquals(rate, 48000.0);
+        }
+
+        beginTest("Least recently used entry is evicted first");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache6"));
+
+            int decodes = 0;
+            double rate = 0.0;
+            const auto entryBytes = (juce::int64)(2 * 1000 * sizeof(float));
+
+            pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.1f, decodes), rate);
+            pool.getOrLoad(fileB, 0.0, makeDecoder(1000, 0.2f, decodes), rate);
+            pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.1f, decodes), rate);  // Touch A
+
+            pool.setMemoryBudget(entryBytes);
+            expectEquals(pool.getNumResidentEntries(), 1);
+
+            // A was used last, so it must still be in RAM
+            pool.resetStats();
+            pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.1f, decodes), rate);
+            expectEquals(pool.getStats().hits, 1);
+        }
+
+        beginTest("Pinned entries stay resident");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache7"));
+
+            int decodes = 0;
+            double rate = 0.0;
+            pool.setPinned(pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.1f, decodes), rate), true);
+
+            pool.trim();
+            expectEquals(pool.getNumResidentEntries(), 1);
+
+            pool.setPinned(pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.1f, decodes), rate), false);
+            pool.trim();
+            expectEquals(pool.getNumResidentEntries(), 0);
+        }
+
+        //======================================================================
+        beginTest("Persisted entries open in a later session without decoding");
+        {
+            const auto cacheDir = tempDir.getChildFile("cache8");
+            int decodes = 0;
+            double rate = 0.0;
+            {
+                SamplePool session;
+                session.setDiskCacheDirectory(cacheDir);
+                session.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate, true);
+                expectEquals(cacheDir.getNumberOfChildFiles(juce::File::findFiles, "*.pfcache"), 1);
+            }
+
+            SamplePool reopened;
+            reopened.setDiskCacheDirectory(cacheDir);
+            auto buffer = reopened.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate, true);
+
+            expect(buffer != nullptr);
+            expectEquals(decodes, 1);
+            expectEquals(reopened.getStats().diskCacheHits, 1);
+            expectEquals(buffer->getNumSamples(), 1000);
+            expectEquals(buffer->getSample(1, 999), 0.25f);
+            expectEquals(rate, 48000.0);
+        }
+
+        beginTest("Cached data is ignored once the source file changes");
+        {
+            const auto cacheDir = tempDir.getChildFile("cache9");
+            int decodes = 0;
+            double rate = 0.0;
+            {
+                SamplePool session;
+                session.setDiskCacheDirectory(cacheDir);
+                session.getOrLoad(fileB, 0.0, makeDecoder(1000, 0.25f, decodes), rate, true);
+            }
+
+            fileB.replaceWithText("second sample contents, edited");
+
+            SamplePool reopened;
+            reopened.setDiskCacheDirectory(cacheDir);
+            auto buffer = reopened.getOrLoad(fileB, 0.0, makeDecoder(1000, 0.5f, decodes), rate, true);
+
+            expectEquals(decodes, 2);
+            expectEquals(reopened.getStats().diskCacheHits, 0);
+            expectEquals(buffer->getSample(0, 0), 0.5f);
+        }
+
+        beginTest("Later sessions only hash files that are new or changed");
+        {
+            const auto cacheDir = tempDir.getChildFile("cache9a");
+            const auto source = makeSourceFile(tempDir, "indexed.raw", "indexed sample contents");
+            int decodes = 0;
+            double rate = 0.0;
+            {
+                SamplePool session;
+                session.setDiskCacheDirectory(cacheDir);
+                session.getOrLoad(source, 0.0, makeDecoder(1000, 0.25f, decodes), rate, true);
+                expectEquals(session.getStats().fingerprints, 1);
+            }
+
+            {
+                SamplePool reopened;
+                reopened.setDiskCacheDirectory(cacheDir);
+                reopened.getOrLoad(source, 0.0, makeDecoder(1000, 0.25f, decodes), rate, true);
+                expectEquals(reopened.getStats().fingerprints, 0);
+                expectEquals(reopened.getStats().diskCacheHits, 1);
+            }
+
+            source.replaceWithText("indexed sample contents, edited");
+
+            for (int session = 0; session < 2; ++session)
+            {
+                SamplePool reopened;
+                reopened.setDiskCacheDirectory(cacheDir);
+                reopened.getOrLoad(source, 0.0, makeDecoder(1000, 0.5f, decodes), rate, true);
+                expectEquals(reopened.getStats().fingerprints, session == 0 ? 1 : 0);
+            }
+
+            // The stale line for the old contents is dropped when the index is read
+            juce::StringArray lines;
+            cacheDir.getChildFile("paths.pfindex").readLines(lines);
+            lines.removeEmptyStrings();
+            expectEquals(lines.size(), 1);
+            expectEquals(decodes, 2);
+        }
+
+        beginTest("Copies with different modification times share one cache file");
+        {
+            const auto cacheDir = tempDir.getChildFile("cache9b");
+            fileACopy.setLastModificationTime(fileA.getLastModificationTime() - juce::RelativeTime::hours(1.0));
+
+            int decodes = 0;
+            double rate = 0.0;
+            {
+                SamplePool session;
+                session.setDiskCacheDirectory(cacheDir);
+                session.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.25f, decodes), rate, true);
+            }
+
+            const auto cacheFile = cacheDir.findChildFiles(juce::File::findFiles, false, "*.pfcache")[0];
+            const auto written = cacheFile.getLastModificationTime();
+
+            // Each copy in turn, in sessions of their own; neither invalidates the other
+            for (const auto& source : { fileACopy, fileA })
+            {
+                SamplePool reopened;
+                reopened.setDiskCacheDirectory(cacheDir);
+                auto buffer = reopened.getOrLoad(source, 0.0, makeDecoder(1000, 0.5f, decodes), rate, true);
+
+                expectEquals(reopened.getStats().diskCacheHits, 1);
+                expectEquals(buffer->getSample(0, 0), 0.25f);
+            }
+
+            expectEquals(decodes, 1);
+            expectEquals(cacheDir.getNumberOfChildFiles(juce::File::findFiles, "*.pfcache"), 1);
+            expect(cacheFile.getLastModificationTime() == written);
+        }
+
+        beginTest("Disk cache is kept under its budget");
+        {
+            SamplePool pool;
+            pool.setDiskCacheDirectory(tempDir.getChildFile("cache10"));
+
+            int decodes = 0;
+            double rate = 0.0;
+            pool.getOrLoad(fileA, 0.0, makeDecoder(1000, 0.1f, decodes), rate, true);
+            const auto oneFile = pool.getDiskCacheBytes();
+            expect(oneFile > (juce::int64)(2 * 1000 * sizeof(float)));
+
+            pool.setDiskCacheBudget(oneFile);
+            pool.getOrLoad(fileB, 0.0, makeDecoder(1000, 0.2f, decodes), rate, true);
+
+            expectEquals(pool.getDiskCacheBytes(), oneFile);
+        }
+
+        beginTest("Waveform peaks are cached with the entry and on disk");
+        {
+            const auto cacheDir = tempDir.getChildFile("cache11");
+            int decodes = 0;
+            double rate = 0.0;
+
+            // A ramp, so every point's range is known
+            auto rampDecoder = [&decodes](juce::AudioBuffer<float>& dest, double& sampleRate)
+            {
+                ++decodes;
+                dest.setSize(1, 10000);
+                for (int i = 0; i < 10000; ++i)
+                    dest.setSample(0, i, static_cast<float>(i) / 10000.0f);
+                sampleRate = 44100.0;
+                return true;
+            };
+
+            {
+                SamplePool session;
+                session.setDiskCacheDirectory(cacheDir);
+                auto buffer = session.getOrLoad(fileA, 0.0, rampDecoder, rate, true);
+
+                auto peaks = session.getPeaks(buffer);
+                expect(peaks != nullptr);
+                expect(peaks == session.getPeaks(buffer));
+                expectEquals(peaks->getLengthInFrames(), (juce::int64)10000);
+                expectEquals(peaks->getNumPoints(0), (10000 + WaveformPeaks::BASE_REDUCTION - 1) / WaveformPeaks::BASE_REDUCTION);
+                expectEquals(peaks->getNumPoints(peaks->getNumLevels() - 1), 1);
+                expectEquals(cacheDir.getNumberOfChildFiles(juce::File::findFiles, "*.pfpeaks"), 1);
+
+                const auto point = peaks->getRange(0, 0, 512, 1024);
+                expectEquals(point.min, 512.0f / 10000.0f);
+                expectEquals(point.max, 1023.0f / 10000.0f);
+                expectEquals(peaks->getLevelFor(1.0), 0);
+                expectEquals(peaks->getLevelFor(2.0 * WaveformPeaks::BASE_REDUCTION), 1);
+
+                const auto whole = peaks->getPoints(peaks->getNumLevels() - 1, 0)[0];
+                expectEquals(whole.min, 0.0f);
+                expectEquals(whole.max, 9999.0f / 10000.0f);
+            }
+
+            SamplePool reopened;
+            reopened.setDiskCacheDirectory(cacheDir);
+            auto buffer = reopened.getOrLoad(fileA, 0.0, rampDecoder, rate, true);
+            auto peaks = reopened.getPeaks(buffer);
+
+            expectEquals(decodes, 1);
+            expect(peaks != nullptr);
+            expectEquals(peaks->getNumLevels(), WaveformPeaks::build(*buffer)->getNumLevels());
+            expectEquals(peaks->getRange(0, 0, 0, 10000).max, 9999.0f / 10000.0f);
+        }
+
+        //======================================================================
+        beginTest("Clips share pooled buffers and still own copied ones");
+        {
+            auto shared = std::make_shared<const juce::AudioBuffer<float>>(2, 500);
+
+            AudioClip clipA, clipB;
+            clipA.setSharedBuffer(shared, 44100.0);
+            clipB.setSharedBuffer(shared, 44100.0);
+
+            expect(&clipA.getAudioBuffer() == &clipB.getAudioBuffer());
+            expectEquals(clipA.getTrimEndSample(), (juce::int64)500);
+
+            AudioClip empty;
+            expect(!empty.hasAudio());
+            expectEquals(empty.getSample(0, 0), 0.0f);
+        }
+
+        tempDir.deleteRecursively();
+    }
+
+private:
+    static juce::File makeSourceFile(const juce::File& dir, const juce::String& name,
+                                     const juce::String& contents)
+    {
+        auto file = dir.getChildFile(name);
+        file.replaceWithText(contents);
+        return file;
+    }
+
+    static SamplePool::Decoder makeDecoder(int numSamples, float value, int& decodeCount)
+    {
+        return [numSamples, value, &decodeCount](juce::AudioBuffer<float>& dest, double& sampleRate)
+        {
+            ++decodeCount;
+            dest.setSize(2, numSamples);
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::fill(dest.getWritePointer(ch), value, numSamples);
+            sampleRate = 48000.0;
+            return true;
+        };
+    }
+};
+
+// Register the test
+static SamplePoolTests samplePoolTests;
@@ -0,0 +1,186 @@
+/**
+ * SampleStreamer Unit Tests - Disk read-ahead for streamed Sampler zones
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/Synths/Sampler.h"
+#include "../Source/Audio/Synths/SampleStreamer.h"
+#include "TestHelpers.h"
+#include <algorithm>
+#include <cmath>
+
+class SampleStreamerTests : public juce::UnitTest
+{
+public:
+    SampleStreamerTests() : UnitTest("SampleStreamer") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr double preloadMs = 200.0;   // Idle disk threads look for new requests every 20ms
+
+        auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                           .getChildFile("ProgFlowSampleStreamerTests");
+        tempDir.deleteRecursively();
+        tempDir.createDirectory();
+
+        // Three seconds - longer than the preload and than one trip round the ring
+        const int length = static_cast<int>(3 * sampleRate);
+        juce::AudioBuffer<float> audio(1, length);
+        for (int i = 0; i < length; ++i)
+            audio.setSample(0, i, 0.4f * static_cast<float>(std::sin(0.01 * i) + 0.3 * std::sin(0.0537 * i)));
+
+        const auto wavFile = tempDir.getChildFile("long.wav");
+        expect(TestHelpers::writeAudioFile(wavFile, audio, sampleRate));
+
+        //======================================================================
+        beginTest("Virtual frames map straight through without a loop");
+        {
+            expectEquals(SampleStream::virtualToSource(0, false, 100, 200), static_cast<juce::int64>(0));
+            expectEquals(SampleStream::virtualToSource(250, false, 100, 200), static_cast<juce::int64>(250));
+
+            // Degenerate loops are ignored
+            expectEquals(SampleStream::virtualToSource(250, true, 200, 200), static_cast<juce::int64>(250));
+            expectEquals(SampleStream::virtualToSource(250, true, 200, 100), static_cast<juce::int64>(250));
+        }
+
+        beginTest("Virtual frames wrap inside the loop");
+        {
+            // Untouched before the loop end
+            expectEquals(SampleStream::virtualToSource(50, true, 100, 200), static_cast<juce::int64>(50));
+            expectEquals(SampleStream::virtualToSource(199, true, 100, 200), static_cast<juce::int64>(199));
+
+            // Wrapped once and many times
+            expectEquals(SampleStream::virtualToSource(200, true, 100, 200), static_cast<juce::int64>(100));
+            expectEquals(SampleStream::virtualToSource(299, true, 100, 200), static_cast<juce::int64>(199));
+            expectEquals(SampleStream::virtualToSource(300, true, 100, 200), static_cast<juce::int64>(100));
+            expectEquals(SampleStream::virtualToSource(100 + 100 * 1000 + 37, true, 100, 200),
+                         static_cast<juce::int64>(137));
+
+            // Loops larger than the ring
+            const juce::int64 loopEnd = 3 * SampleStream::RING_SIZE;
+            expectEquals(SampleStream::virtualToSource(loopEnd + 5, true, 0, loopEnd), static_cast<juce::int64>(5));
+
+            // Loops in files past 2^31 frames
+            const juce::int64 farStart = (juce::int64)3 << 31, farEnd = farStart + 1000;
+            expectEquals(SampleStream::virtualToSource(farEnd + 7, true, farStart, farEnd), farStart + 7);
+        }
+
+        //======================================================================
+        beginTest("Streamed zones only keep the preload resident");
+        {
+            Sampler resident;
+            expect(resident.loadSample(wavFile, 60));
+
+            Sampler streaming;
+            streaming.setDiskStreamingEnabled(true);
+            streaming.setPreloadMilliseconds(preloadMs);
+            expect(streaming.loadSample(wavFile, 60));
+
+            const auto preloadFrames = static_cast<juce::int64>(preloadMs * 0.001 * sampleRate);
+            expectEquals(streaming.getResidentSampleBytes(), preloadFrames * static_cast<juce::int64>(sizeof(float)));
+            expect(resident.getResidentSampleBytes() > 10 * streaming.getResidentSampleBytes());
+
+            auto zones = streaming.getZones();
+            expectEquals(static_cast<int>(zones.size()), 1);
+            expect(zones.front()->streamed);
+            expectEquals(zones.front()->getLength(), static_cast<juce::int64>(length));
+            expectEquals(zones.front()->loopEnd, static_cast<juce::int64>(length));
+        }
+
+        beginTest("Streams crossing the preload boundary match the fully loaded render");
+        {
+            // Root pitch reads whole frames, a semitone up reads between them
+            for (int note : { 60, 61 })
+            {
+                Sampler resident;
+                expect(resident.loadSample(wavFile, 60));
+
+                Sampler streaming;
+                streaming.setDiskStreamingEnabled(true);
+                streaming.setPreloadMilliseconds(preloadMs);
+                expect(streaming.loadSample(wavFile, 60));
+
+                const int renderLength = static_cast<int>(2.5 * sampleRate);
+                auto expected = renderNote(resident, note, sampleRate, renderLength);
+                auto actual = renderNote(streaming, note, sampleRate, renderLength);
+
+                // The comparison only means something if the reader kept up
+                expectEquals(streaming.getStreamUnderrunCount(), 0);
+
+                float largestError = 0.0f;
+                for (int i = 0; i < renderLength; ++i)
+                    largestError = std::max(largestError, std::abs(expected.getSample(0, i) - actual.getSample(0, i)));
+
+                expectLessThan(largestError, 1.0e-5f);
+                expect(actual.getMagnitude(0, static_cast<int>(sampleRate), 4096) > 0.1f);
+            }
+        }
+
+        //======================================================================
+        beginTest("Starved streams count underruns");
+        {
+            const auto missingFile = tempDir.getChildFile("missing.wav");
+            expect(wavFile.copyFileTo(missingFile));
+
+            Sampler streaming;
+            streaming.setDiskStreamingEnabled(true);
+            streaming.setPreloadMilliseconds(preloadMs);
+            expect(streaming.loadSample(missingFile, 60));
+
+            // The writer has nothing to read once the preload runs out
+            expect(missingFile.deleteFile());
+            expectEquals(streaming.getStreamUnderrunCount(), 0);
+
+            auto output = renderNote(streaming, 60, sampleRate, static_cast<int>(0.5 * sampleRate));
+            expect(streaming.getStreamUnderrunCount() > 0);
+
+            // The preloaded head still played
+            expect(output.getMagnitude(0, 0, 1024) > 0.05f);
+
+            streaming.resetStreamUnderrunCount();
+            expectEquals(streaming.getStreamUnderrunCount(), 0);
+        }
+
+        tempDir.deleteRecursively();
+    }
+
+private:
+    // Holds one note for the whole render, at roughly twice real time so
+    // the disk threads get scheduled as they would during playback
+    static juce::AudioBuffer<float> renderNote(Sampler& sampler, int note, double sampleRate, int length)
+    {
+        constexpr int blockSize = 512;
+
+        sampler.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> output(2, length);
+        output.clear();
+
+        juce::AudioBuffer<float> block(2, blockSize);
+        for (int start = 0; start < length; start += blockSize)
+        {
+            const int numSamples = std::min(blockSize, length - start);
+            block.clear();
+
+            juce::MidiBuffer midi;
+            if (start == 0)
+                midi.addEvent(juce::MidiMessage::noteOn(1, note, 0.8f), 0);
+
+            juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), 2, numSamples);
+            sampler.processBlock(view, midi);
+
+            for (int ch = 0; ch < 2; ++ch)
+                output.copyFrom(ch, start, block, ch, 0, numSamples);
+
+            juce::Thread::sleep(5);
+        }
+
+        return output;
+    }
+};
+
+// Register the test
+static SampleStreamerTests sampleStreamerTests;
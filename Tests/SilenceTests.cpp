@@ -0,0 +1,244 @@
+/**
+ * Silence Unit Tests - Tail-aware sleeping for effects, synths and tracks
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/Audio/Effects/DelayEffect.h"
+#include "../Source/Audio/Effects/ReverbEffect.h"
+#include "../Source/Audio/Effects/ChorusEffect.h"
+#include "../Source/Audio/Effects/EffectChain.h"
+#include "../Source/Audio/Synths/AnalogSynth.h"
+#include "../Source/Audio/Synths/DrumSynth.h"
+#include "../Source/Audio/Track.h"
+
+class SilenceTests : public juce::UnitTest
+{
+public:
+    SilenceTests() : UnitTest("Silence") {}
+
+    void runTest() override
+    {
+        const double sampleRate = 44100.0;
+        const int blockSize = 512;
+
+        //======================================================================
+        beginTest("Delay keeps repeating until its tail has passed, then sleeps");
+        {
+            DelayEffect delay;
+            delay.setParameter("delayTime", 100.0f);
+            delay.setParameter("feedback", 0.5f);
+            delay.prepareToPlay(sampleRate, blockSize);
+
+            const int tail = delay.getTailSamples();
+            expectGreaterThan(tail, static_cast<int>(sampleRate * 0.1));
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            buffer.setSample(1, 0, 1.0f);
+            delay.processBlock(buffer);
+
+            // The first echoes still come out although the input has gone quiet
+            float echo = 0.0f;
+            int processed = blockSize;
+            for (; processed < static_cast<int>(sampleRate * 0.5); processed += blockSize)
+            {
+                buffer.clear();
+                delay.processBlock(buffer);
+                echo = std::max(echo, buffer.getMagnitude(0, 0, blockSize));
+                expect(!delay.isSleeping());
+            }
+            expectGreaterThan(echo, 0.1f);
+
+            while (!delay.isSleeping() && processed < tail * 4)
+            {
+                buffer.clear();
+                delay.processBlock(buffer);
+                processed += blockSize;
+            }
+            expect(delay.isSleeping());
+            expectGreaterOrEqual(processed, tail);
+
+            // Wakes on the first block with input, and that input gets echoed
+            buffer.clear();
+            buffer.setSample(0, 10, 1.0f);
+            buffer.setSample(1, 10, 1.0f);
+            delay.processBlock(buffer);
+            expect(!delay.isSleeping());
+
+            float wokenEcho = 0.0f;
+            for (int i = 0; i < 20; ++i)
+            {
+                buffer.clear();
+                delay.processBlock(buffer);
+                wokenEcho = std::max(wokenEcho, buffer.getMagnitude(0, 0, blockSize));
+            }
+            expectGreaterThan(wokenEcho, 0.1f);
+        }
+
+        beginTest("Reverb sleeps once its decay is over");
+        {
+            ReverbEffect reverb;
+            reverb.setParameter("roomSize", 0.3f);
+            reverb.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            buffer.setSample(1, 0, 1.0f);
+            reverb.processBlock(buffer);
+
+            int processed = blockSize;
+            while (!reverb.isSleeping() && processed < static_cast<int>(sampleRate * 30.0))
+            {
+                buffer.clear();
+                reverb.processBlock(buffer);
+                processed += blockSize;
+            }
+
+            expect(reverb.isSleeping());
+            expectGreaterOrEqual(processed, reverb.getTailSamples());
+            expect(EffectBase::isSilent(buffer, blockSize));
+        }
+
+        beginTest("Reset puts an effect back to awake");
+        {
+            ChorusEffect chorus;
+            chorus.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            buffer.clear();
+            for (int i = 0; i < 10; ++i)
+                chorus.processBlock(buffer);
+            expect(chorus.isSleeping());
+
+            chorus.reset();
+            expect(!chorus.isSleeping());
+        }
+
+        //======================================================================
+        beginTest("Synths report silence once their voices have released");
+        {
+            AnalogSynth synth;
+            synth.prepareToPlay(sampleRate, blockSize);
+            expect(synth.isSilent());
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            synth.noteOn(60, 0.8f);
+            synth.processBlock(buffer, midi);
+            expect(!synth.isSilent());
+
+            synth.noteOff(60);
+            for (int block = 0; block < 500 && !synth.isSilent(); ++block)
+                synth.processBlock(buffer, midi);
+            expect(synth.isSilent());
+
+            DrumSynth drums;
+            drums.prepareToPlay(sampleRate, blockSize);
+            expect(drums.isSilent());
+            drums.noteOn(36, 1.0f);
+            expect(!drums.isSilent());
+            for (int block = 0; block < 500 && !drums.isSilent(); ++block)
+                drums.processBlock(buffer, midi);
+            expect(drums.isSilent());
+        }
+
+        //======================================================================
+        beginTest("Chain is asleep only when every active insert is");
+        {
+            EffectChain chain;
+            chain.prepareToPlay(sampleRate, blockSize);
+            chain.addEffect(std::make_unique<ChorusEffect>());
+            const int delaySlot = chain.addEffect(std::make_unique<DelayEffect>());
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            buffer.clear();
+            for (int i = 0; i < 10; ++i)
+                chain.processBlock(buffer);
+            expect(!chain.isAsleep());  // The delay's tail is seconds long
+
+            chain.setSlotBypass(delaySlot, true);
+            expect(chain.isAsleep());
+        }
+
+        //======================================================================
+        beginTest("Idle track stays silent and wakes on the next note");
+        {
+            Track track("Idle");
+            track.prepareToPlay(sampleRate, blockSize);
+            track.getEffectChain().addEffect(std::make_unique<ChorusEffect>());
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            for (int i = 0; i < 10; ++i)
+            {
+                buffer.clear();
+                track.processBlock(buffer, blockSize, 0.0, 120.0);
+            }
+            expect(track.getEffectChain().getEffect(0)->isSleeping());
+            expect(EffectBase::isSilent(buffer, blockSize));
+            expectEquals(track.getMeterLevel(), 0.0f);
+
+            track.synthNoteOn(60, 0.8f);
+            buffer.clear();
+            track.processBlock(buffer, blockSize, 0.0, 120.0);
+            expectGreaterThan(buffer.getMagnitude(0, blockSize), 0.0f);
+            expect(!track.getEffectChain().getEffect(0)->isSleeping());
+        }
+
+        //======================================================================
+        beginTest("Idle tracks cost a fraction of sounding ones");
+        {
+            const int numTracks = 64;
+            const int numBlocks = 50;
+            std::vector<std::unique_ptr<Track>> tracks;
+            for (int i = 0; i < numTracks; ++i)
+            {
+                auto track = std::make_unique<Track>("Track " + juce::String(i));
+                track->prepareToPlay(sampleRate, blockSize);
+                track->getEffectChain().addEffect(std::make_unique<ReverbEffect>());
+                tracks.push_back(std::move(track));
+            }
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            auto runBlocks = [&]
+            {
+                const auto start = juce::Time::getMillisecondCounterHiRes();
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    for (auto& track : tracks)
+                    {
+                        buffer.clear();
+                        track->processBlock(buffer, blockSize, 0.0, 120.0);
+                    }
+                }
+                return juce::Time::getMillisecondCounterHiRes() - start;
+            };
+
+            for (auto& track : tracks)
+                track->synthNoteOn(60, 0.8f);
+            const double soundingMs = runBlocks();
+
+            for (auto& track : tracks)
+            {
+                track->synthNoteOff(60);
+                for (int block = 0; block < 5000 && !track->getEffectChain().isAsleep(); ++block)
+                {
+                    buffer.clear();
+                    track->processBlock(buffer, blockSize, 0.0, 120.0);
+                }
+                expect(track->getEffectChain().isAsleep());
+            }
+            const double idleMs = runBlocks();
+
+            logMessage(juce::String(numTracks) + " tracks x " + juce::String(numBlocks) + " blocks: sounding "
+                       + juce::String(soundingMs, 1) + " ms, idle " + juce::String(idleMs, 1) + " ms");
+
+            expect(idleMs * 4.0 < soundingMs, "Idle tracks took " + juce::String(idleMs) + " ms");
+        }
+    }
+};
+
+// Register the test
+static SilenceTests silenceTests;
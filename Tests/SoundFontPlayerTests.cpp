@@ -8,6 +8,8 @@
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "../Source/Audio/Synths/SoundFontPlayer.h"
+#include <cmath>
+#include <thread>
 
 class SoundFontPlayerTests : public juce::UnitTest
 {
@@ -331,6 +333,137 @@ public:
             player.setParameter("releaseOverride", 0.3f);
             expectEquals(player.getParameter("releaseOverride"), 0.3f);
         }
+
+        //======================================================================
+        // Shared Bank Cache
+        //======================================================================
+        beginTest("Cache rejects missing files without caching them");
+        {
+            SoundFontCache cache;
+            auto missing = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                               .getChildFile("progflow_missing_bank.sf2");
+
+            expect(!cache.loadBank(missing.getFullPathName()));
+            expect(!cache.isBankLoaded(missing.getFullPathName()));
+            expect(cache.createInstance(missing.getFullPathName()) == nullptr);
+            expectEquals(cache.getNumBanks(), 0);
+        }
+
+        beginTest("Cache clients are told without the cache lock held");
+        {
+            // Another thread must be able to use the cache while a client is being told
+            struct LockProbe : SoundFontCache::Client
+            {
+                SoundFontCache* cache = nullptr;
+                std::thread other;
+                juce::WaitableEvent probed, told;
+                std::atomic<bool> cacheUsable{false};
+
+                void soundFontBankReady(const juce::String&, bool) override
+                {
+                    // Joined by the test, so a held lock fails the test rather than hanging it
+                    other = std::thread([this] { cache->getNumBanks(); probed.signal(); });
+                    cacheUsable.store(probed.wait(5000));
+                    told.signal();
+                }
+            };
+
+            SoundFontCache cache;
+            LockProbe probe;
+            probe.cache = &cache;
+
+            auto missing = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                               .getChildFile("progflow_missing_async_bank.sf2");
+            cache.loadBankAsync(missing.getFullPathName(), &probe);
+
+            expect(probe.told.wait(10000));
+            cache.cancelRequests(&probe);   // Returns once the callback has
+            if (probe.other.joinable())
+                probe.other.join();
+            expect(probe.cacheUsable.load());
+        }
+
+        beginTest("Players sharing a SoundFont parse it once");
+        {
+            SoundFontPlayer first;
+            waitForLoad(first);
+
+            if (first.isSoundFontLoaded())
+            {
+                const auto path = first.getCurrentSoundFontPath();
+
+                SoundFontPlayer second;
+                waitForLoad(second);
+
+                juce::SharedResourcePointer<SoundFontCache> cache;
+                expectEquals(cache->getNumBanks(), 1);
+                expectEquals(cache->getNumInstances(path), 2);
+                expect(second.isSoundFontLoaded());
+            }
+            else
+            {
+                // No bundled SoundFont in this environment
+                expect(!first.isSoundFontLoading());
+            }
+        }
+
+        //======================================================================
+        // Multitimbral Mode
+        //======================================================================
+        beginTest("Multitimbral mode is off by default and can be enabled");
+        {
+            SoundFontPlayer player;
+            expect(!player.isMultitimbral());
+
+            player.setMultitimbral(true);
+            expect(player.isMultitimbral());
+        }
+
+        beginTest("Channel programs are stored per MIDI channel");
+        {
+            SoundFontPlayer player;
+            player.setChannelProgram(1, 40);
+            player.setChannelProgram(16, 73);
+            player.setChannelProgram(17, 10); // Out of range - ignored
+
+            expectEquals(player.getChannelProgram(1), 40);
+            expectEquals(player.getChannelProgram(16), 73);
+            expectEquals(player.getChannelProgram(2), 0);
+        }
+
+        beginTest("Multitimbral processing handles all channels without crashing");
+        {
+            SoundFontPlayer player;
+            waitForLoad(player);
+            player.setMultitimbral(true);
+            player.prepareToPlay(44100.0, 512);
+
+            juce::MidiBuffer midi;
+            for (int channel = 1; channel <= 16; ++channel)
+            {
+                midi.addEvent(juce::MidiMessage::programChange(channel, channel * 3), 0);
+                midi.addEvent(juce::MidiMessage::noteOn(channel, 60, (juce::uint8)100), channel);
+            }
+            midi.addEvent(juce::MidiMessage::pitchWheel(1, 10000), 100);
+            midi.addEvent(juce::MidiMessage::controllerEvent(2, 7, 64), 200);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            buffer.clear();
+            player.processBlock(buffer, midi);
+
+            expectEquals(player.getChannelProgram(4), 12);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 512; ++i)
+                    expect(std::isfinite(buffer.getSample(ch, i)));
+        }
+    }
+
+private:
+    static void waitForLoad(SoundFontPlayer& player)
+    {
+        for (int i = 0; i < 500 && player.isSoundFontLoading(); ++i)
+            juce::Thread::sleep(10);
     }
 };
 
@@ -0,0 +1,66 @@
+#pragma once
+
+/**
+ * Test helpers shared by the unit tests - audio fixture files and block-by-block clip renders
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/AudioClip.h"
+#include "../Source/Audio/AudioClipRenderer.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace TestHelpers
+{
+    /** Write audio to file in Format (replacing it); true if it was all written */
+    template <typename Format = juce::WavAudioFormat>
+    inline bool writeAudioFile(const juce::File& file, const juce::AudioBuffer<float>& audio,
+                               double sampleRate, int bitsPerSample = 32)
+    {
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+        if (stream == nullptr)
+            return false;
+
+        Format format;
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            format.createWriterFor(stream.get(), sampleRate,
+                                   static_cast<unsigned int>(audio.getNumChannels()), bitsPerSample, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // Owned by the writer now
+        return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+    }
+
+    /**
+     * Render clips through a fresh AudioClipRenderer in blockSize blocks, as
+     * a track would, into a stereo buffer of length samples starting at beat 0
+     * @param blockingReads Wait for streamed audio and warp renders (offline)
+     */
+    inline juce::AudioBuffer<float> renderBlocks(const std::vector<std::unique_ptr<AudioClip>>& clips,
+                                                 double sampleRate, int length, double bpm = 120.0,
+                                                 bool blockingReads = false,
+                                                 Resampler::Quality quality = Resampler::Quality::Sinc,
+                                                 int blockSize = 512)
+    {
+        AudioClipRenderer renderer;
+        renderer.prepare(sampleRate, blockSize);
+        renderer.setBlockingReads(blockingReads);
+
+        juce::AudioBuffer<float> output(2, length);
+        output.clear();
+
+        const double beatsPerSample = (bpm / 60.0) / sampleRate;
+        for (int position = 0; position < length; position += blockSize)
+        {
+            const int n = std::min(blockSize, length - position);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, position, n);
+            renderer.render(clips, block, n, position * beatsPerSample, bpm, quality);
+        }
+        return output;
+    }
+}
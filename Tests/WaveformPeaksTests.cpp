@@ -0,0 +1,172 @@
+/**
+ * WaveformPeaks Unit Tests - Peak pyramid building, lookup and the shared store
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/Audio/WaveformPeaks.h"
+#include "../Source/Audio/WaveformPeakStore.h"
+#include "../Source/Audio/AudioFileLoader.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class WaveformPeaksTests : public juce::UnitTest
+{
+public:
+    WaveformPeaksTests() : UnitTest("WaveformPeaks") {}
+
+    void runTest() override
+    {
+        // Two channels of a decaying tone, with a length that isn't a whole number of points
+        const int length = 100000 + 77;
+        juce::AudioBuffer<float> audio(2, length);
+        for (int i = 0; i < length; ++i)
+        {
+            const float envelope = 1.0f - static_cast<float>(i) / length;
+            audio.setSample(0, i, envelope * static_cast<float>(std::sin(0.05 * i)));
+            audio.setSample(1, i, -0.5f * envelope * static_cast<float>(std::sin(0.011 * i)));
+        }
+
+        //======================================================================
+        beginTest("Every level summarises the audio below it");
+        {
+            auto peaks = WaveformPeaks::build(audio);
+            expectEquals(peaks->getNumChannels(), 2);
+            expectEquals(peaks->getLengthInFrames(), static_cast<juce::int64>(length));
+            expectEquals(peaks->getNumPoints(peaks->getNumLevels() - 1), 1);
+
+            // Any range at any level matches the samples it covers
+            for (int level = 0; level < peaks->getNumLevels(); level += 3)
+            {
+                const auto reduction = WaveformPeaks::getReduction(level);
+                const auto from = reduction * 3;
+                const auto to = juce::jmin<juce::int64>(length, reduction * 5);
+                if (from >= to)
+                    continue;
+
+                const auto point = peaks->getRange(level, 1, from, to);
+                const auto range = juce::FloatVectorOperations::findMinAndMax(
+                    audio.getReadPointer(1, static_cast<int>(from)), static_cast<int>(to - from));
+                expectEquals(point.min, range.getStart());
+                expectEquals(point.max, range.getEnd());
+                expect(point.rms > 0.0f && point.rms <= juce::jmax(-range.getStart(), range.getEnd()));
+            }
+
+            // A pixel never covers more than two points of the level picked for it
+            for (double framesPerPixel : { 300.0, 1000.0, 40000.0 })
+            {
+                const int level = peaks->getLevelFor(framesPerPixel);
+                expect(static_cast<double>(WaveformPeaks::getReduction(level)) <= framesPerPixel);
+                expect(level == peaks->getNumLevels() - 1
+                       || static_cast<double>(WaveformPeaks::getReduction(level + 1)) > framesPerPixel);
+            }
+        }
+
+        beginTest("Appending block by block builds the same pyramid");
+        {
+            auto whole = WaveformPeaks::build(audio);
+
+            WaveformPeaks::Builder builder(2);
+            juce::Random random(7);
+            for (int done = 0; done < length;)
+            {
+                const int n = juce::jmin(length - done, 1 + random.nextInt(700));
+                const float* channels[] = { audio.getReadPointer(0, done), audio.getReadPointer(1, done) };
+                builder.append(channels, n);
+                done += n;
+
+                // Snapshots along the way cover what has arrived
+                if (done < length && random.nextInt(20) == 0)
+                    expectEquals(builder.getSnapshot()->getLengthInFrames(), static_cast<juce::int64>(done));
+            }
+
+            auto appended = builder.getSnapshot();
+            expectEquals(appended->getNumLevels(), whole->getNumLevels());
+
+            for (int level = 0; level < whole->getNumLevels(); ++level)
+            {
+                expectEquals(appended->getNumPoints(level), whole->getNumPoints(level));
+                for (int p = 0; p < whole->getNumPoints(level); p += 11)
+                {
+                    expectEquals(appended->getPoints(level, 0)[p].max, whole->getPoints(level, 0)[p].max);
+                    expectEquals(appended->getPoints(level, 1)[p].min, whole->getPoints(level, 1)[p].min);
+                    expectWithinAbsoluteError(appended->getPoints(level, 0)[p].rms,
+                                              whole->getPoints(level, 0)[p].rms, 1.0e-5f);
+                }
+            }
+        }
+
+        beginTest("Peaks survive a round trip through a stream");
+        {
+            auto peaks = WaveformPeaks::build(audio);
+
+            juce::MemoryOutputStream out;
+            expect(peaks->writeTo(out));
+
+            juce::MemoryInputStream in(out.getData(), out.getDataSize(), false);
+            auto restored = WaveformPeaks::readFrom(in);
+            expect(restored != nullptr);
+            expectEquals(restored->getNumLevels(), peaks->getNumLevels());
+            expectEquals(restored->getRange(2, 0, 0, length).max, peaks->getRange(2, 0, 0, length).max);
+
+            juce::MemoryInputStream truncated(out.getData(), out.getDataSize() / 2, false);
+            expect(WaveformPeaks::readFrom(truncated) == nullptr);
+        }
+
+        //======================================================================
+        beginTest("Clips on the same audio share one pyramid, built in the background");
+        {
+            auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                               .getChildFile("ProgFlowWaveformPeaksTests");
+            tempDir.deleteRecursively();
+            tempDir.createDirectory();
+
+            auto& samplePool = getSamplePool();
+            const auto userCacheDirectory = samplePool.getDiskCacheDirectory();
+            samplePool.setDiskCacheDirectory(tempDir.getChildFile("cache"));
+
+            WaveformPeakStore store;
+
+            AudioClip original, duplicate;
+            original.setAudioBuffer(audio, 44100.0);
+            duplicate.setSharedBuffer(original.getSharedBuffer(), 44100.0);
+
+            expect(store.getPeaks(original) == nullptr);
+            expect(store.waitForBuilds(10000));
+
+            auto peaks = store.getPeaks(original);
+            expect(peaks != nullptr);
+            expect(store.getPeaks(duplicate) == peaks);
+            expectEquals(store.getNumSources(), 1);
+
+            // Streamed clips are scanned from their file
+            const auto file = tempDir.getChildFile("tone.wav");
+            expect(TestHelpers::writeAudioFile(file, audio, 44100.0));
+
+            AudioFileLoader loader;
+            loader.setStreamingThreshold(0);
+            auto streamed = loader.loadFile(file);
+            expect(streamed != nullptr && streamed->isStreamed());
+
+            store.getPeaks(*streamed);
+            expect(store.waitForBuilds(10000));
+            auto streamedPeaks = store.getPeaks(*streamed);
+            expect(streamedPeaks != nullptr);
+            expectEquals(streamedPeaks->getRange(4, 0, 0, length).max, peaks->getRange(4, 0, 0, length).max);
+
+            // A growing source publishes its own snapshots
+            WaveformPeaks::Builder builder(2);
+            builder.append(audio.getArrayOfReadPointers(), 1000);
+            store.update(original.getSharedBuffer(), builder.getSnapshot());
+            expectEquals(store.getPeaks(duplicate)->getLengthInFrames(), static_cast<juce::int64>(1000));
+
+            streamed.reset();
+            samplePool.setDiskCacheDirectory(userCacheDirectory);
+            tempDir.deleteRecursively();
+        }
+    }
+};
+
+// Register the test
+static WaveformPeaksTests waveformPeaksTests;